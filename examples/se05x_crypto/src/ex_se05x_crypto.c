@@ -721,11 +721,10 @@ exit:
 int ex_set_certificate(pSe05xSession_t session_ctx)
 {
     smStatus_t status;
-    uint32_t keyID   = TEST_ID_BASE + __LINE__;
-    size_t file_size = sizeof(certificate);
-    size_t offset    = 0;
-    size_t blk_size  = SET_CERT_BLK_SIZE;
-    size_t i         = 0;
+    uint32_t keyID                = TEST_ID_BASE + __LINE__;
+    size_t blk_size               = SET_CERT_BLK_SIZE;
+    size_t i                      = 0;
+    Se05xWriteProgress_t progress = {0};
     SE05x_Result_t result;
 
     certificate_len     = sizeof(certificate);
@@ -739,22 +738,19 @@ int ex_set_certificate(pSe05xSession_t session_ctx)
     }
 
     if (result == kSE05x_Result_SUCCESS) {
-        /* If binary file already exsists, Set file size = 0 */
-        file_size = 0;
+        /* If binary file already exsists, only write its content */
+        progress.isCreated = 1;
     }
 
     for (i = 0; i < certificate_len; i++) {
         certificate[i] = i;
     }
 
-    /* Set certificate with chunks of blk_size(128) */
-    for (offset = 0; offset < certificate_len; offset = offset + blk_size) {
-        status = Se05x_API_WriteBinary(session_ctx, NULL, keyID, offset, file_size, certificate + offset, blk_size);
-        if (status != SM_OK) {
-            SMLOG_E("Error in Se05x_API_WriteBinary \n");
-            goto exit;
-        }
-        file_size = 0;
+    /* Set certificate, chunked to the APDU buffer */
+    status = Se05x_API_WriteBinaryChunked(session_ctx, NULL, keyID, certificate, certificate_len, &progress);
+    if (status != SM_OK) {
+        SMLOG_E("Error in Se05x_API_WriteBinaryChunked \n");
+        goto exit;
     }
 
     /* Retrive certificate from offset 200 */
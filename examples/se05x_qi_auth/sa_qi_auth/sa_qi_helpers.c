@@ -15,5 +15,5 @@ void getPublicKeyFromSlot(uint8_t slot_id, uint8_t *pPublicKey, size_t *pPublicK
 {
     pSe05xSession_t session_ctx = pgSe05xSessionctx;
     uint32_t keyId              = QI_SLOT_ID_TO_KEY_ID(slot_id);
-    readObjectWithChunking(session_ctx, keyId, 0, 0, pPublicKey, pPublicKeyLen);
+    Se05x_API_ReadObjectChunked(session_ctx, keyId, 0, 0, pPublicKey, pPublicKeyLen);
 }
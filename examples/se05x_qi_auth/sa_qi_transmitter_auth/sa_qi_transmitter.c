@@ -17,6 +17,9 @@
 
 extern pSe05xSession_t pgSe05xSessionctx;
 
+/* Sign command per slot, encoded once per session */
+static Se05xPreparedCmd_t gSlotSignCmd[4 /* Slots 0 to 3 */];
+
 void powerTransmitterSendCommand(
     const uint8_t *pCmdBuffer, const size_t cmdBufferLen, uint8_t *pResponseBuffer, size_t *pResponseBufferLen)
 {
@@ -213,7 +216,6 @@ void ReadCertificates(const uint8_t *pGetCertificateRequest,
     pSe05xSession_t session_ctx = pgSe05xSessionctx;
     uint32_t certChainId        = 0;
     size_t readSize             = 0;
-    uint8_t *pData              = NULL;
 
     qi_error_code_t errorCode   = kQiErrorUnspecified;
     uint8_t authMsgHeader       = 0;
@@ -305,33 +307,22 @@ void ReadCertificates(const uint8_t *pGetCertificateRequest,
         goto error;
     }
 
-    readSize = bytesToRead;
-    pData    = (uint8_t *)SSS_MALLOC(bytesToRead * sizeof(uint8_t));
-    if (!pData) {
-        errorCode = kQiErrorUnspecified;
-        goto error;
-    }
-
     if (*pCertificateResponseLen < (size_t)(bytesToRead + 1)) {
         LOG_E("Insufficient buffer");
         errorCode = kQiErrorUnspecified;
         goto error;
     }
 
-    /* Read certificate chain */
-    retStatus = readCertificateChain(session_ctx, certChainId, offset, bytesToRead, pData, &readSize);
+    /* Read certificate chain directly into the response buffer */
+    readSize  = bytesToRead;
+    retStatus = Se05x_API_ReadObjectChunked(
+        session_ctx, certChainId, offset, bytesToRead, &pCertificateResponse[1], &readSize);
     if (retStatus != SM_OK) {
         errorCode = kQiErrorUnspecified;
-        LOG_E("Se05x_API_ReadObject failed");
+        LOG_E("Se05x_API_ReadObjectChunked failed");
         goto error;
     }
-    LOG_MAU8_D("ReadCertificate object", pData, readSize);
-
-    /* Copy the data read out to response buffer */
-    memcpy(&pCertificateResponse[1], pData, readSize);
-    if (pData) {
-        SSS_FREE(pData);
-    }
+    LOG_MAU8_D("ReadCertificate object", &pCertificateResponse[1], readSize);
 
     pCertificateResponse[0]  = (uint8_t)(authMsgHeader & 0xF0) + (uint8_t)(kQiResponseCertificate);
     *pCertificateResponseLen = (bytesToRead) + 1;
@@ -339,9 +330,6 @@ void ReadCertificates(const uint8_t *pGetCertificateRequest,
     return;
 
 error:
-    if (pData) {
-        SSS_FREE(pData);
-    }
     if (pCertificateResponse) {
         pCertificateResponse[0]  = (uint8_t)(authMsgHeader & 0xF0) + (uint8_t)(kQiResponseError);
         pCertificateResponse[1]  = (uint8_t)(errorCode);
@@ -376,6 +364,7 @@ void Authenticate(const uint8_t *pChallengeRequest,
     qi_error_code_t errorCode            = kQiErrorUnspecified;
     uint32_t certChainId                 = 0;
     uint32_t keyId                       = 0;
+    Se05xPreparedCmd_t *pSignCmd         = NULL;
 
     if (NULL == pChallengeRequest || NULL == pChallengeAuthResponse) {
         LOG_E("Null buffer");
@@ -464,8 +453,17 @@ void Authenticate(const uint8_t *pChallengeRequest,
     }
 
     /* Calculate signature */
-    retStatus =
-        Se05x_API_ECDSASign(session_ctx, keyId, kSE05x_ECSignatureAlgo_SHA_256, hash, hashLen, &signature[0], &sigLen);
+    pSignCmd = &gSlotSignCmd[requestedSlot];
+    if (pSignCmd->session_ctx != session_ctx) {
+        retStatus = Se05x_API_PrepareECDSASign(session_ctx, keyId, kSE05x_ECSignatureAlgo_SHA_256, pSignCmd);
+        if (retStatus != SM_OK) {
+            LOG_E("Se05x_API_PrepareECDSASign failed");
+            pSignCmd->session_ctx = NULL;
+            errorCode             = kQiErrorUnspecified;
+            goto error;
+        }
+    }
+    retStatus = Se05x_API_PreparedECDSASign(pSignCmd, hash, hashLen, &signature[0], &sigLen);
     if (retStatus != SM_OK) {
         LOG_E(" sss_asymmetric_sign_digest Failed...");
         errorCode = kQiErrorUnspecified;
@@ -155,37 +155,6 @@ exit:
     return sm_status;
 }
 
-smStatus_t readObjectWithChunking(pSe05xSession_t session_ctx,
-    uint32_t certChainId,
-    uint16_t offset,
-    uint16_t bytesToRead,
-    uint8_t *pData,
-    size_t *pdataLen)
-{
-    smStatus_t retStatus       = SM_NOT_OK;
-    size_t outputSizeRemaining = *pdataLen;
-    size_t readSize            = *pdataLen;
-    uint16_t chunk             = 0;
-    uint16_t chunkOffset       = 0;
-
-    do {
-        chunk = (bytesToRead > BINARY_WRITE_MAX_LEN) ? BINARY_WRITE_MAX_LEN : bytesToRead;
-        retStatus =
-            Se05x_API_ReadObject(session_ctx, certChainId, offset + chunkOffset, chunk, pData + chunkOffset, &readSize);
-        if (retStatus != SM_OK) {
-            break;
-        }
-        chunkOffset += chunk;
-        bytesToRead -= chunk;
-        outputSizeRemaining = outputSizeRemaining - readSize;
-        readSize            = outputSizeRemaining;
-    } while (0 != bytesToRead);
-
-    *pdataLen = *pdataLen - outputSizeRemaining;
-
-    return retStatus;
-}
-
 smStatus_t getManufacturerCertificateLength(pSe05xSession_t session_ctx, uint32_t certChainId, uint16_t *N_MC)
 {
     smStatus_t retStatus        = SM_NOT_OK;
@@ -501,36 +501,39 @@ exit:
 }
 
 /**************** Data transmit functions *****************/
-smStatus_t Se05x_API_ECKeyAuth_Encrypt(pSe05xSession_t session_ctx,
+smStatus_t Se05x_API_ECKeyAuth_EncryptInPlace(pSe05xSession_t session_ctx,
     const tlvHeader_t *inhdr,
     uint8_t *cmdBuf,
     size_t cmdBufLen,
+    size_t headroom,
     uint8_t length_extended,
     tlvHeader_t *outhdr,
-    uint8_t *encCmdBuf,
+    uint8_t **ppEncCmdBuf,
     size_t *encCmdBufLen)
 {
-    smStatus_t apduStatus                      = SM_NOT_OK;
-    uint8_t iv[16]                             = {0};
-    int ret                                    = 0;
-    size_t i                                   = 0;
-    uint8_t macData[16]                        = {0};
-    size_t macDataLen                          = 16;
-    uint8_t se05x_eckey_mcv_tmp[SCP_CMAC_SIZE] = {0};
-    uint8_t *dataToMac                         = NULL;
-    size_t dataToMac_len                       = 0;
-    size_t se05xCmdLC                          = 0;
-    size_t se05xCmdLCW                         = 0;
-    size_t wsSe05x_tag1Len                     = 0;
-    size_t wsSe05x_tag1W                       = 0;
+    smStatus_t apduStatus  = SM_NOT_OK;
+    uint8_t iv[16]         = {0};
+    int ret                = 0;
+    size_t i               = 0;
+    uint8_t macData[16]    = {0};
+    size_t macDataLen      = 16;
+    uint8_t *pApdu         = NULL;
+    uint8_t *dataToMac     = NULL;
+    size_t dataToMac_len   = 0;
+    size_t se05xCmdLC      = 0;
+    size_t se05xCmdLCW     = 0;
+    size_t wsSe05x_tag1Len = 0;
+    size_t wsSe05x_tag1W   = 0;
+    size_t sessionCmdLC    = 0;
+    size_t sessionCmdLCW   = 0;
+    size_t hdrLen          = 0;
 
     ENSURE_OR_RETURN_ON_ERROR(inhdr != NULL, SM_NOT_OK);
     ENSURE_OR_RETURN_ON_ERROR(cmdBuf != NULL, SM_NOT_OK);
-    ENSURE_OR_RETURN_ON_ERROR(encCmdBuf != NULL, SM_NOT_OK);
+    ENSURE_OR_RETURN_ON_ERROR(outhdr != NULL, SM_NOT_OK);
+    ENSURE_OR_RETURN_ON_ERROR(ppEncCmdBuf != NULL, SM_NOT_OK);
     ENSURE_OR_RETURN_ON_ERROR(encCmdBufLen != NULL, SM_NOT_OK);
 
-    memcpy(se05x_eckey_mcv_tmp, session_ctx->eckey_mcv, SCP_CMAC_SIZE);
-
     if (cmdBufLen != 0) {
         ENSURE_OR_RETURN_ON_ERROR((Se05x_API_Auth_PadCommandAPDU(cmdBuf, &cmdBufLen) == SM_OK), SM_NOT_OK);
         ENSURE_OR_RETURN_ON_ERROR(
@@ -548,39 +551,62 @@ smStatus_t Se05x_API_ECKeyAuth_Encrypt(pSe05xSession_t session_ctx,
     outhdr->hdr[2] = 0x00;
     outhdr->hdr[3] = 0x00;
 
-    /* Add session header */
-    memcpy(&g_cmdBuf[i], outhdr->hdr, sizeof(outhdr->hdr));
-    i = +sizeof(outhdr->hdr);
-
-    g_cmdBuf[i++] = 0; /* Length. To be updated later */
-    g_cmdBuf[i++] = kSE05x_TAG_SESSION_ID;
-    g_cmdBuf[i++] = sizeof(session_ctx->eckey_applet_session_value);
-    memcpy(&g_cmdBuf[i], session_ctx->eckey_applet_session_value, sizeof(session_ctx->eckey_applet_session_value));
-    i += sizeof(session_ctx->eckey_applet_session_value);
-
-    g_cmdBuf[i++] = kSE05x_TAG_1;
-
+    /* All lengths are known up front, so the headers can be written in front of the encrypted data */
     se05xCmdLC      = cmdBufLen + 8 /*MAC*/;
     se05xCmdLCW     = (se05xCmdLC == 0) ? 0 : (((se05xCmdLC < 0xFF) && !(length_extended)) ? 1 : 3);
     wsSe05x_tag1Len = 4 /*hrd*/ + se05xCmdLCW + se05xCmdLC;
     wsSe05x_tag1W   = ((wsSe05x_tag1Len <= 0x7F) ? 1 : (wsSe05x_tag1Len <= 0xFF) ? 2 : 3);
+    sessionCmdLC    = 2 + sizeof(session_ctx->eckey_applet_session_value) + 1 + wsSe05x_tag1W + wsSe05x_tag1Len;
+    sessionCmdLCW   = ((sessionCmdLC < 0xFF) && !length_extended) ? 1 : 3;
+    hdrLen          = sizeof(outhdr->hdr) + sessionCmdLCW + (sessionCmdLC - wsSe05x_tag1Len) + 4 + se05xCmdLCW;
+    ENSURE_OR_RETURN_ON_ERROR((sessionCmdLC <= (MAX_APDU_BUFFER - sizeof(outhdr->hdr) - sessionCmdLCW)), SM_NOT_OK);
+
+    /* Without headroom the encrypted data is moved up */
+    if (headroom >= hdrLen) {
+        pApdu = cmdBuf - hdrLen;
+    }
+    else {
+        pApdu = cmdBuf;
+        if (cmdBufLen > 0) {
+            memmove(cmdBuf + hdrLen, cmdBuf, cmdBufLen);
+        }
+    }
+
+    /* Add session header */
+    memcpy(&pApdu[i], outhdr->hdr, sizeof(outhdr->hdr));
+    i += sizeof(outhdr->hdr);
+
+    if (sessionCmdLCW == 1) {
+        pApdu[i++] = (uint8_t)sessionCmdLC;
+    }
+    else {
+        pApdu[i++] = 0x00;
+        pApdu[i++] = 0xFFu & (sessionCmdLC >> 8);
+        pApdu[i++] = 0xFFu & (sessionCmdLC);
+    }
+    pApdu[i++] = kSE05x_TAG_SESSION_ID;
+    pApdu[i++] = sizeof(session_ctx->eckey_applet_session_value);
+    memcpy(&pApdu[i], session_ctx->eckey_applet_session_value, sizeof(session_ctx->eckey_applet_session_value));
+    i += sizeof(session_ctx->eckey_applet_session_value);
+
+    pApdu[i++] = kSE05x_TAG_1;
 
     if (wsSe05x_tag1W == 1) {
-        g_cmdBuf[i++] = wsSe05x_tag1Len;
+        pApdu[i++] = wsSe05x_tag1Len;
     }
     else if (wsSe05x_tag1W == 2) {
-        g_cmdBuf[i++] = (uint8_t)(0x80 /* Extended */ | 0x01 /* Additional Length */);
-        g_cmdBuf[i++] = (uint8_t)((wsSe05x_tag1Len >> 0 * 8) & 0xFF);
+        pApdu[i++] = (uint8_t)(0x80 /* Extended */ | 0x01 /* Additional Length */);
+        pApdu[i++] = (uint8_t)((wsSe05x_tag1Len >> 0 * 8) & 0xFF);
     }
     else {
-        g_cmdBuf[i++] = (uint8_t)(0x80 /* Extended */ | 0x02 /* Additional Length */);
-        g_cmdBuf[i++] = (uint8_t)((wsSe05x_tag1Len >> 8) & 0xFF);
-        g_cmdBuf[i++] = (uint8_t)((wsSe05x_tag1Len) & 0xFF);
+        pApdu[i++] = (uint8_t)(0x80 /* Extended */ | 0x02 /* Additional Length */);
+        pApdu[i++] = (uint8_t)((wsSe05x_tag1Len >> 8) & 0xFF);
+        pApdu[i++] = (uint8_t)((wsSe05x_tag1Len) & 0xFF);
     }
 
-    dataToMac = &g_cmdBuf[i];
-    memcpy(&g_cmdBuf[i], inhdr, 4);
-    g_cmdBuf[i] |= 0x4;
+    dataToMac = &pApdu[i];
+    memcpy(&pApdu[i], inhdr, 4);
+    pApdu[i] |= 0x4;
     i = i + 4;
     dataToMac_len += 4;
 
@@ -590,22 +616,19 @@ smStatus_t Se05x_API_ECKeyAuth_Encrypt(pSe05xSession_t session_ctx,
         // encode 0x100 as 0x00 in the Lc field, nobody who is sane in his mind
         // would actually do that).
         if (se05xCmdLCW == 1) {
-            g_cmdBuf[i++] = (uint8_t)se05xCmdLC;
+            pApdu[i++] = (uint8_t)se05xCmdLC;
             dataToMac_len += 1;
         }
         else {
-            g_cmdBuf[i++] = 0x00;
-            g_cmdBuf[i++] = 0xFFu & (se05xCmdLC >> 8);
-            g_cmdBuf[i++] = 0xFFu & (se05xCmdLC);
+            pApdu[i++] = 0x00;
+            pApdu[i++] = 0xFFu & (se05xCmdLC >> 8);
+            pApdu[i++] = 0xFFu & (se05xCmdLC);
             dataToMac_len += 3;
         }
     }
 
-    ENSURE_OR_RETURN_ON_ERROR((i < MAX_APDU_BUFFER), SM_NOT_OK);
-    memcpy(&g_cmdBuf[i], cmdBuf, cmdBufLen);
-    ENSURE_OR_RETURN_ON_ERROR((i <= (SIZE_MAX - cmdBufLen)), SM_NOT_OK);
+    /* The encrypted data follows the headers already */
     i = i + cmdBufLen;
-    ENSURE_OR_RETURN_ON_ERROR(((SIZE_MAX - dataToMac_len) >= cmdBufLen), SM_NOT_OK);
     dataToMac_len += cmdBufLen;
 
     ret = Se05x_API_Auth_CalculateMacCmdApdu(&(session_ctx->eckey_session_mac_Key[0]),
@@ -616,30 +639,38 @@ smStatus_t Se05x_API_ECKeyAuth_Encrypt(pSe05xSession_t session_ctx,
         &macDataLen);
     ENSURE_OR_RETURN_ON_ERROR((ret == SM_OK), SM_NOT_OK);
 
-    ENSURE_OR_RETURN_ON_ERROR((i < MAX_APDU_BUFFER), SM_NOT_OK);
-    memcpy(&g_cmdBuf[i], macData, 8);
+    memcpy(&pApdu[i], macData, 8);
     i = i + 8;
 
-    if (((i - 5) < 0xFF) && !length_extended) {
-        g_cmdBuf[4] = (uint8_t)(i - 5);
-    }
-    else {
-        ENSURE_OR_RETURN_ON_ERROR(((i - 5) <= MAX_APDU_BUFFER - 7), SM_NOT_OK);
-        memmove(g_cmdBuf + 7, g_cmdBuf + 5, i - 5);
-        g_cmdBuf[4] = 0x00;
-        g_cmdBuf[5] = 0xFFu & ((i - 5) >> 8);
-        g_cmdBuf[6] = 0xFFu & ((i - 5));
-        i           = i + 2;
-    }
-
+    *ppEncCmdBuf  = pApdu;
     *encCmdBufLen = i;
-    ENSURE_OR_RETURN_ON_ERROR((*encCmdBufLen <= MAX_APDU_BUFFER), SM_NOT_OK);
-    memcpy(encCmdBuf, g_cmdBuf, *encCmdBufLen);
-    SMLOG_MAU8_D("ECKey: Encrypted Data ==>", encCmdBuf, *encCmdBufLen);
+    SMLOG_MAU8_D("ECKey: Encrypted Data ==>", pApdu, *encCmdBufLen);
     apduStatus = SM_OK;
     return apduStatus;
 }
 
+smStatus_t Se05x_API_ECKeyAuth_Encrypt(pSe05xSession_t session_ctx,
+    const tlvHeader_t *inhdr,
+    uint8_t *cmdBuf,
+    size_t cmdBufLen,
+    uint8_t length_extended,
+    tlvHeader_t *outhdr,
+    uint8_t *encCmdBuf,
+    size_t *encCmdBufLen)
+{
+    smStatus_t apduStatus = SM_NOT_OK;
+    uint8_t *pApdu        = NULL;
+
+    ENSURE_OR_RETURN_ON_ERROR(encCmdBuf != NULL, SM_NOT_OK);
+
+    apduStatus = Se05x_API_ECKeyAuth_EncryptInPlace(
+        session_ctx, inhdr, cmdBuf, cmdBufLen, 0, length_extended, outhdr, &pApdu, encCmdBufLen);
+    if ((apduStatus == SM_OK) && (encCmdBuf != pApdu)) {
+        memmove(encCmdBuf, pApdu, *encCmdBufLen);
+    }
+    return apduStatus;
+}
+
 smStatus_t Se05x_API_ECKeyAuth_Decrypt(
     pSe05xSession_t session_ctx, uint8_t *encBuf, size_t encBufLen, uint8_t *decCmdBuf, size_t *decCmdBufLen)
 {
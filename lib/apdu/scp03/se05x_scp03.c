@@ -582,12 +582,13 @@ smStatus_t Se05x_API_SCP03_CreateSession(pSe05xSession_t session_ctx)
 
 /**************** Data transmit functions *****************/
 
-smStatus_t Se05x_API_SCP03_Encrypt(pSe05xSession_t session_ctx,
+smStatus_t Se05x_API_SCP03_EncryptInPlace(pSe05xSession_t session_ctx,
     const tlvHeader_t *inhdr,
     uint8_t *cmdBuf,
     size_t cmdBufLen,
+    size_t headroom,
     uint8_t length_extended,
-    uint8_t *encCmdBuf,
+    uint8_t **ppEncCmdBuf,
     size_t *encCmdBufLen)
 {
     smStatus_t apduStatus = SM_NOT_OK;
@@ -600,13 +601,16 @@ smStatus_t Se05x_API_SCP03_Encrypt(pSe05xSession_t session_ctx,
     size_t macDataLen                    = 16;
     size_t se05xCmdLC                    = 0;
     size_t se05xCmdLCW                   = 0;
+    size_t hdrLen                        = 0;
+    uint8_t *pApdu                       = NULL;
     uint8_t se05x_mcv_tmp[SCP_CMAC_SIZE] = {
         0,
     };
 
     ENSURE_OR_RETURN_ON_ERROR(inhdr != NULL, SM_NOT_OK);
     ENSURE_OR_RETURN_ON_ERROR(cmdBuf != NULL, SM_NOT_OK);
-    ENSURE_OR_RETURN_ON_ERROR(encCmdBuf != NULL, SM_NOT_OK);
+    ENSURE_OR_RETURN_ON_ERROR(ppEncCmdBuf != NULL, SM_NOT_OK);
+    ENSURE_OR_RETURN_ON_ERROR(encCmdBufLen != NULL, SM_NOT_OK);
 
     memcpy(se05x_mcv_tmp, session_ctx->scp03_mcv, SCP_CMAC_SIZE);
 
@@ -623,38 +627,39 @@ smStatus_t Se05x_API_SCP03_Encrypt(pSe05xSession_t session_ctx,
 
     se05xCmdLC  = cmdBufLen + SCP_GP_IU_CARD_CRYPTOGRAM_LEN;
     se05xCmdLCW = (se05xCmdLC == 0) ? 0 : (((se05xCmdLC < 0xFF) && !(length_extended)) ? 1 : 3);
+    hdrLen      = sizeof(*inhdr) + se05xCmdLCW;
+    ENSURE_OR_RETURN_ON_ERROR(cmdBufLen < (MAX_APDU_BUFFER - hdrLen), SM_NOT_OK);
 
-    if (se05xCmdLCW > 0) {
-        if (se05xCmdLCW == 1) {
-            ENSURE_OR_RETURN_ON_ERROR(cmdBufLen < (MAX_APDU_BUFFER - sizeof(*inhdr) - 1), SM_NOT_OK);
-            if (cmdBufLen > 0) {
-                memmove(cmdBuf + sizeof(*inhdr) + 1, cmdBuf, cmdBufLen);
-            }
-            memcpy(cmdBuf, inhdr, sizeof(*inhdr));
-            i += sizeof(*inhdr);
-            cmdBuf[i++] = (uint8_t)se05xCmdLC;
-        }
-        else {
-            ENSURE_OR_RETURN_ON_ERROR((cmdBufLen < (MAX_APDU_BUFFER - sizeof(*inhdr) - 3)), SM_NOT_OK);
-            if (cmdBufLen > 0) {
-                memmove(cmdBuf + sizeof(*inhdr) + 3, cmdBuf, cmdBufLen);
-            }
-            memcpy(cmdBuf, inhdr, sizeof(*inhdr));
-            i += sizeof(*inhdr);
-            cmdBuf[i++] = 0x00;
-            cmdBuf[i++] = 0xFFu & (se05xCmdLC >> 8);
-            cmdBuf[i++] = 0xFFu & (se05xCmdLC);
+    /* The header goes in front of the encrypted data, without headroom the data is moved up */
+    if (headroom >= hdrLen) {
+        pApdu = cmdBuf - hdrLen;
+    }
+    else {
+        pApdu = cmdBuf;
+        if (cmdBufLen > 0) {
+            memmove(cmdBuf + hdrLen, cmdBuf, cmdBufLen);
         }
     }
 
-    cmdBuf[0] |= 0x4;
+    memcpy(pApdu, inhdr, sizeof(*inhdr));
+    i += sizeof(*inhdr);
+    if (se05xCmdLCW == 1) {
+        pApdu[i++] = (uint8_t)se05xCmdLC;
+    }
+    else if (se05xCmdLCW == 3) {
+        pApdu[i++] = 0x00;
+        pApdu[i++] = 0xFFu & (se05xCmdLC >> 8);
+        pApdu[i++] = 0xFFu & (se05xCmdLC);
+    }
+
+    pApdu[0] |= 0x4;
 
     if (cmdBufLen > 0) {
         i += cmdBufLen;
     }
 
     ret = Se05x_API_Auth_CalculateMacCmdApdu(
-        &(session_ctx->scp03_session_mac_Key[0]), &session_ctx->scp03_mcv[0], cmdBuf, i, macData, &macDataLen);
+        &(session_ctx->scp03_session_mac_Key[0]), &session_ctx->scp03_mcv[0], pApdu, i, macData, &macDataLen);
     ENSURE_OR_RETURN_ON_ERROR((ret == SM_OK), SM_NOT_OK);
 
     if (i + SCP_GP_IU_CARD_CRYPTOGRAM_LEN > MAX_APDU_BUFFER) {
@@ -663,7 +668,7 @@ smStatus_t Se05x_API_SCP03_Encrypt(pSe05xSession_t session_ctx,
         return SM_NOT_OK;
     }
 
-    memcpy(&cmdBuf[i], macData, SCP_GP_IU_CARD_CRYPTOGRAM_LEN);
+    memcpy(&pApdu[i], macData, SCP_GP_IU_CARD_CRYPTOGRAM_LEN);
     i += SCP_GP_IU_CARD_CRYPTOGRAM_LEN;
 
     if (length_extended) {
@@ -672,17 +677,38 @@ smStatus_t Se05x_API_SCP03_Encrypt(pSe05xSession_t session_ctx,
             memcpy(session_ctx->scp03_mcv, se05x_mcv_tmp, SCP_CMAC_SIZE);
             return SM_NOT_OK;
         }
-        cmdBuf[i++] = 0x00;
-        cmdBuf[i++] = 0x00;
+        pApdu[i++] = 0x00;
+        pApdu[i++] = 0x00;
     }
 
+    *ppEncCmdBuf  = pApdu;
     *encCmdBufLen = i;
-    memcpy(encCmdBuf, cmdBuf, *encCmdBufLen);
-    SMLOG_MAU8_D("SCP03: Encrypted Data ==>", encCmdBuf, *encCmdBufLen);
+    SMLOG_MAU8_D("SCP03: Encrypted Data ==>", pApdu, *encCmdBufLen);
     apduStatus = SM_OK;
     return apduStatus;
 }
 
+smStatus_t Se05x_API_SCP03_Encrypt(pSe05xSession_t session_ctx,
+    const tlvHeader_t *inhdr,
+    uint8_t *cmdBuf,
+    size_t cmdBufLen,
+    uint8_t length_extended,
+    uint8_t *encCmdBuf,
+    size_t *encCmdBufLen)
+{
+    smStatus_t apduStatus = SM_NOT_OK;
+    uint8_t *pApdu        = NULL;
+
+    ENSURE_OR_RETURN_ON_ERROR(encCmdBuf != NULL, SM_NOT_OK);
+
+    apduStatus = Se05x_API_SCP03_EncryptInPlace(
+        session_ctx, inhdr, cmdBuf, cmdBufLen, 0, length_extended, &pApdu, encCmdBufLen);
+    if ((apduStatus == SM_OK) && (encCmdBuf != pApdu)) {
+        memmove(encCmdBuf, pApdu, *encCmdBufLen);
+    }
+    return apduStatus;
+}
+
 smStatus_t Se05x_API_SCP03_Decrypt(pSe05xSession_t session_ctx,
     size_t cmdBufLen,
     uint8_t *encBuf,
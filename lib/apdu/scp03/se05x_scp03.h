@@ -27,6 +27,23 @@ smStatus_t Se05x_API_SCP03_Encrypt(pSe05xSession_t session_ctx,
     uint8_t *encCmdBuf,
     size_t *encCmdBufLen);
 
+/** Se05x_API_SCP03_EncryptInPlace
+ *
+ * SCP03 Encryption of commands without a copy. The header is written into the
+ * headroom bytes available in front of cmdBuf, with less headroom the data is
+ * moved up. ppEncCmdBuf returns the start of the encrypted command.
+ *
+ * @return     The sm status.
+ */
+smStatus_t Se05x_API_SCP03_EncryptInPlace(pSe05xSession_t session_ctx,
+    const tlvHeader_t *inhdr,
+    uint8_t *cmdBuf,
+    size_t cmdBufLen,
+    size_t headroom,
+    uint8_t hasle,
+    uint8_t **ppEncCmdBuf,
+    size_t *encCmdBufLen);
+
 /** Se05x_API_SCP03_Decrypt
  *
  * SCP03 Decryption of commands.
@@ -55,6 +72,23 @@ smStatus_t Se05x_API_ECKeyAuth_Encrypt(pSe05xSession_t session_ctx,
     uint8_t *encCmdBuf,
     size_t *encCmdBufLen);
 
+/** Se05x_API_ECKeyAuth_EncryptInPlace
+ *
+ * EcKey Auth Encryption of commands without a copy, see
+ * Se05x_API_SCP03_EncryptInPlace.
+ *
+ * @return     The sm status.
+ */
+smStatus_t Se05x_API_ECKeyAuth_EncryptInPlace(pSe05xSession_t session_ctx,
+    const tlvHeader_t *inhdr,
+    uint8_t *cmdBuf,
+    size_t cmdBufLen,
+    size_t headroom,
+    uint8_t hasle,
+    tlvHeader_t *outhdr,
+    uint8_t **ppEncCmdBuf,
+    size_t *encCmdBufLen);
+
 /** Se05x_API_ECKeyAuth_Decrypt
  *
  * EcKey Auth Decryption of commands.
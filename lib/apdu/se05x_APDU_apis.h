@@ -12,10 +12,18 @@
 #include "se05x_types.h"
 #include "se05x_tlv.h"
 
+/* ********************** Data types ********************** */
+
+/** Called by Se05x_API_ReadObjectStream for each chunk read. pChunk points into
+ * the APDU buffer of the session, it is valid until the callback returns.
+ * Return SM_OK to continue, any other value stops the read and is returned. */
+typedef smStatus_t (*Se05xReadChunkCb_t)(void *pCbCtx, uint16_t offset, const uint8_t *pChunk, size_t chunkLen);
+
 /** Se05x_API_SessionOpen
  *
  * Open session to SE05x.
  * Multiple sessions are not supported.
+ * Same as Se05x_API_LinkOpen followed by Se05x_API_AppletSessionOpen.
  *
  * @param[in]  session_ctx  The session context
  *
@@ -26,6 +34,7 @@ smStatus_t Se05x_API_SessionOpen(pSe05xSession_t session_ctx);
 /** Se05x_API_SessionClose
  *
  * Close session to SE05x.
+ * Same as Se05x_API_AppletSessionClose followed by Se05x_API_LinkClose.
  *
  * @param[in]  session_ctx  The session context
  *
@@ -33,6 +42,68 @@ smStatus_t Se05x_API_SessionOpen(pSe05xSession_t session_ctx);
  */
 smStatus_t Se05x_API_SessionClose(pSe05xSession_t session_ctx);
 
+/** Se05x_API_LinkOpen
+ *
+ * Open the connection to SE05x without selecting the applet: the transport
+ * selected by pConnString is opened and the T=1oI2C link is initialised
+ * (interface reset, ATR). Applet sessions are then opened and closed on the
+ * link with Se05x_API_AppletSessionOpen / Se05x_API_AppletSessionClose.
+ *
+ * @param[in]  session_ctx  The session context
+ *
+ * @return     The sm status.
+ */
+smStatus_t Se05x_API_LinkOpen(pSe05xSession_t session_ctx);
+
+/** Se05x_API_LinkClose
+ *
+ * Close the connection to SE05x opened with Se05x_API_LinkOpen.
+ * The session context is cleared.
+ *
+ * @param[in]  session_ctx  The session context
+ *
+ * @return     The sm status.
+ */
+smStatus_t Se05x_API_LinkClose(pSe05xSession_t session_ctx);
+
+/** Se05x_API_AppletSessionOpen
+ *
+ * Select the applet and set up the secure channel of the build on an open link.
+ * Can be called again, e.g. after an error, to replace the applet session.
+ *
+ * @param[in]  session_ctx  The session context, with an open link
+ *
+ * @return     The sm status.
+ */
+smStatus_t Se05x_API_AppletSessionOpen(pSe05xSession_t session_ctx);
+
+/** Se05x_API_AppletSessionClose
+ *
+ * Close the applet session and forget the secure channel keys. The link
+ * stays open for the next Se05x_API_AppletSessionOpen.
+ *
+ * @param[in]  session_ctx  The session context
+ *
+ * @return     The sm status.
+ */
+smStatus_t Se05x_API_AppletSessionClose(pSe05xSession_t session_ctx);
+
+struct phNxpEse_Stats;
+
+/** Se05x_API_GetLinkStats
+ *
+ * Get the T=1oI2C protocol counters of the session connection: frames,
+ * retransmissions, R-NACKs, CRC errors, S(WTX) requests, resynchronisations
+ * and resets, and the time spent sending, waiting and in error recovery.
+ * The counters only grow from the session open.
+ *
+ * @param[in]  session_ctx  The session context
+ * @param[out] pStats       Counters (phNxpEse_Stats_t, see phNxpEse_Api.h)
+ *
+ * @return     The sm status.
+ */
+smStatus_t Se05x_API_GetLinkStats(pSe05xSession_t session_ctx, struct phNxpEse_Stats *pStats);
+
 /** Se05x_API_WriteECKey
  *
  * Write or update an EC key object.
@@ -199,6 +270,71 @@ smStatus_t Se05x_API_WriteECKey(pSe05xSession_t session_ctx,
 smStatus_t Se05x_API_ReadObject(
     pSe05xSession_t session_ctx, uint32_t objectID, uint16_t offset, uint16_t length, uint8_t *data, size_t *pdataLen);
 
+/** Se05x_API_ReadObjectView
+ *
+ * Same as Se05x_API_ReadObject, but the data is not copied. *ppdata points
+ * into the APDU buffer of the session and is valid until the next command
+ * is sent on session_ctx.
+ *
+ * @param[in] session_ctx Session Context [0:kSE05x_pSession]
+ * @param[in] objectID object id [1:kSE05x_TAG_1]
+ * @param[in] offset offset [2:kSE05x_TAG_2]
+ * @param[in] length length [3:kSE05x_TAG_3]
+ * @param[out] ppdata Data read [0:kSE05x_TAG_1]
+ * @param[out] pdataLen Length of data
+ */
+smStatus_t Se05x_API_ReadObjectView(pSe05xSession_t session_ctx,
+    uint32_t objectID,
+    uint16_t offset,
+    uint16_t length,
+    const uint8_t **ppdata,
+    size_t *pdataLen);
+
+/** Se05x_API_ReadObjectStream
+ *
+ * Reads length bytes of a binary object from offset in as few ReadObject
+ * commands as possible and passes each chunk to pChunkCb, without copying.
+ *
+ * The chunk size follows from the APDU buffer, the secure messaging of the
+ * session and the IFSD of the link, so that each response fills whole T=1
+ * frames. With length 0 the object is read up to its end, its size is
+ * queried once with ReadSize. An object that fits one response and is read
+ * from offset 0 is read without offset and length, so keys can be read too.
+ *
+ * @param[in] session_ctx Session Context [0:kSE05x_pSession]
+ * @param[in] objectID object id
+ * @param[in] offset Offset of the first byte
+ * @param[in] length Number of bytes, 0 for up to the end of the object
+ * @param[in] pChunkCb Called for each chunk, in order
+ * @param[in] pCbCtx Passed to pChunkCb
+ *
+ * @return     The sm status.
+ */
+smStatus_t Se05x_API_ReadObjectStream(pSe05xSession_t session_ctx,
+    uint32_t objectID,
+    uint16_t offset,
+    uint16_t length,
+    Se05xReadChunkCb_t pChunkCb,
+    void *pCbCtx);
+
+/** Se05x_API_ReadObjectChunked
+ *
+ * Same as Se05x_API_ReadObject for objects of any size, see
+ * Se05x_API_ReadObjectStream. On error *pdataLen holds the number of
+ * bytes read so far.
+ *
+ * @param[in] session_ctx Session Context [0:kSE05x_pSession]
+ * @param[in] objectID object id
+ * @param[in] offset Offset of the first byte
+ * @param[in] length Number of bytes, 0 for up to the end of the object
+ * @param[out] data Data read
+ * @param[in,out] pdataLen Size of data, number of bytes read
+ *
+ * @return     The sm status.
+ */
+smStatus_t Se05x_API_ReadObjectChunked(
+    pSe05xSession_t session_ctx, uint32_t objectID, uint16_t offset, uint16_t length, uint8_t *data, size_t *pdataLen);
+
 /** Se05x_API_GetVersion
  *
  * Gets the applet version information.
@@ -346,6 +482,28 @@ smStatus_t Se05x_API_ECDSASign(pSe05xSession_t session_ctx,
     uint8_t *signature,
     size_t *psignatureLen);
 
+/** Se05x_API_ECDSASignView
+ *
+ * Same as Se05x_API_ECDSASign, but the signature is not copied. *ppsignature
+ * points into the APDU buffer of the session and is valid until the next
+ * command is sent on session_ctx.
+ *
+ * @param[in] session_ctx Session Context [0:kSE05x_pSession]
+ * @param[in] objectID objectID [1:kSE05x_TAG_1]
+ * @param[in] ecSignAlgo ecSignAlgo [2:kSE05x_TAG_2]
+ * @param[in] inputData inputData [3:kSE05x_TAG_3]
+ * @param[in] inputDataLen Length of inputData
+ * @param[out] ppsignature ASN.1 signature [0:kSE05x_TAG_1]
+ * @param[out] psignatureLen Length of signature
+ */
+smStatus_t Se05x_API_ECDSASignView(pSe05xSession_t session_ctx,
+    uint32_t objectID,
+    SE05x_ECSignatureAlgo_t ecSignAlgo,
+    const uint8_t *inputData,
+    size_t inputDataLen,
+    const uint8_t **ppsignature,
+    size_t *psignatureLen);
+
 /** Se05x_API_ECDSAVerify
  *
  * The ECDSAVerify command verifies whether the signature is correct for a given
@@ -541,6 +699,41 @@ smStatus_t Se05x_API_WriteBinary(pSe05xSession_t session_ctx,
     const uint8_t *inputData,
     size_t inputDataLen);
 
+/** Se05x_API_WriteBinaryChunked
+ *
+ * Writes a binary object of any size. The first WriteBinary command creates
+ * the object with policy, the total length and the first chunk, the rest is
+ * written with offset writes. The chunks are as large as the APDU buffer,
+ * the secure messaging of the session and the IFSC of the link allow.
+ *
+ * pProgress records what has been written. Zero it for a new object. After
+ * an error, call again with the same pProgress to resume from the last
+ * completed chunk. To overwrite an existing object of the same length, set
+ * isCreated to 1.
+ *
+ * When the create is rejected because the object exists, as after a create
+ * whose response was lost, an existing binary object of inputDataLen is taken
+ * over: isCreated is set and the whole content is rewritten with offset
+ * writes. Only use object ids owned by the caller, an unrelated object of the
+ * same length would be overwritten. Any other existing object fails with
+ * SM_ERR_CONDITIONS_OF_USE_NOT_SATISFIED.
+ *
+ * @param[in] session_ctx Session Context [0:kSE05x_pSession]
+ * @param[in] policy policy, used when the object is created
+ * @param[in] objectID object id
+ * @param[in] inputData Content of the object
+ * @param[in] inputDataLen Length of inputData, the object length
+ * @param[in,out] pProgress Progress of the write
+ *
+ * @return     The sm status.
+ */
+smStatus_t Se05x_API_WriteBinaryChunked(pSe05xSession_t session_ctx,
+    pSe05xPolicy_t policy,
+    uint32_t objectID,
+    const uint8_t *inputData,
+    size_t inputDataLen,
+    Se05xWriteProgress_t *pProgress);
+
 /** Se05x_API_ECDHGenerateSharedSecret
  *
  * The ECDHGenerateSharedSecret command generates a shared secret ECC point on
@@ -614,6 +807,26 @@ smStatus_t Se05x_API_ECDHGenerateSharedSecret(pSe05xSession_t session_ctx,
     uint8_t *sharedSecret,
     size_t *psharedSecretLen);
 
+/** Se05x_API_ECDHGenerateSharedSecretView
+ *
+ * Same as Se05x_API_ECDHGenerateSharedSecret, but the shared secret is not
+ * copied. *ppsharedSecret points into the APDU buffer of the session and is
+ * valid until the next command is sent on session_ctx.
+ *
+ * @param[in] session_ctx Session Context [0:kSE05x_pSession]
+ * @param[in] objectID objectID [1:kSE05x_TAG_1]
+ * @param[in] pubKey pubKey [2:kSE05x_TAG_2]
+ * @param[in] pubKeyLen Length of pubKey
+ * @param[out] ppsharedSecret Shared secret [0:kSE05x_TAG_1]
+ * @param[out] psharedSecretLen Length of shared secret
+ */
+smStatus_t Se05x_API_ECDHGenerateSharedSecretView(pSe05xSession_t session_ctx,
+    uint32_t objectID,
+    const uint8_t *pubKey,
+    size_t pubKeyLen,
+    const uint8_t **ppsharedSecret,
+    size_t *psharedSecretLen);
+
 /**
  * @brief      Se05x_API_CipherOneShot
  *
@@ -698,6 +911,150 @@ smStatus_t Se05x_API_CipherOneShot(pSe05xSession_t session_ctx,
     size_t *poutputDataLen,
     const SE05x_Cipher_Oper_OneShot_t operation);
 
+/**
+ * @brief      Se05x_API_CipherOneShotView
+ *
+ * Same as Se05x_API_CipherOneShot, but the output data is not copied.
+ * *ppoutputData points into the APDU buffer of the session and is valid
+ * until the next command is sent on session_ctx.
+ *
+ * @param[in]     session_ctx     The session context
+ * @param[in]     objectID        The object id (AES key object with key length = 128 or 192 or 256 bits)
+ * @param[in]     cipherMode      The cipher mode
+ * @param[in]     inputData       The input data (16 Bytes aligned data. Max - 112 Bytes)
+ * @param[in]     inputDataLen    The input data length
+ * @param[in]     IV              Initial vector (16 Bytes)
+ * @param[in]     IVLen           The iv length
+ * @param[in]     operation       The operation
+ * @param[out]    ppoutputData    The output data
+ * @param[out]    poutputDataLen  The output data length
+ *
+ * @return     The sm status.
+ */
+smStatus_t Se05x_API_CipherOneShotView(pSe05xSession_t session_ctx,
+    uint32_t objectID,
+    SE05x_CipherMode_t cipherMode,
+    const uint8_t *inputData,
+    size_t inputDataLen,
+    uint8_t *IV,
+    size_t IVLen,
+    const SE05x_Cipher_Oper_OneShot_t operation,
+    const uint8_t **ppoutputData,
+    size_t *poutputDataLen);
+
+/** Se05x_API_PrepareECDSASign
+ *
+ * Encodes the invariant part of an ECDSASign command (object id and
+ * algorithm) once into pCmd, for repeated signatures with the same key
+ * through Se05x_API_PreparedECDSASign. Nothing is sent to the SE.
+ *
+ * pCmd stays bound to session_ctx and remains valid as long as the session
+ * context does, also across a close and reopen of the session.
+ *
+ * @param[in] session_ctx Session Context [0:kSE05x_pSession]
+ * @param[in] objectID objectID [1:kSE05x_TAG_1]
+ * @param[in] ecSignAlgo ecSignAlgo [2:kSE05x_TAG_2]
+ * @param[out] pCmd Prepared command
+ */
+smStatus_t Se05x_API_PrepareECDSASign(pSe05xSession_t session_ctx,
+    uint32_t objectID,
+    SE05x_ECSignatureAlgo_t ecSignAlgo,
+    Se05xPreparedCmd_t *pCmd);
+
+/** Se05x_API_PreparedECDSASign
+ *
+ * Same as Se05x_API_ECDSASign with the key and algorithm of pCmd, see
+ * Se05x_API_PrepareECDSASign. Only inputData is encoded per call.
+ *
+ * @param[in] pCmd Command prepared by Se05x_API_PrepareECDSASign
+ * @param[in] inputData inputData [3:kSE05x_TAG_3]
+ * @param[in] inputDataLen Length of inputData
+ * @param[out] signature  [0:kSE05x_TAG_1]
+ * @param[in,out] psignatureLen Length for signature
+ */
+smStatus_t Se05x_API_PreparedECDSASign(const Se05xPreparedCmd_t *pCmd,
+    const uint8_t *inputData,
+    size_t inputDataLen,
+    uint8_t *signature,
+    size_t *psignatureLen);
+
+/** Se05x_API_PreparedECDSASignView
+ *
+ * Same as Se05x_API_PreparedECDSASign, but the signature is not copied, see
+ * Se05x_API_ECDSASignView.
+ *
+ * @param[in] pCmd Command prepared by Se05x_API_PrepareECDSASign
+ * @param[in] inputData inputData [3:kSE05x_TAG_3]
+ * @param[in] inputDataLen Length of inputData
+ * @param[out] ppsignature ASN.1 signature [0:kSE05x_TAG_1]
+ * @param[out] psignatureLen Length of signature
+ */
+smStatus_t Se05x_API_PreparedECDSASignView(const Se05xPreparedCmd_t *pCmd,
+    const uint8_t *inputData,
+    size_t inputDataLen,
+    const uint8_t **ppsignature,
+    size_t *psignatureLen);
+
+/** Se05x_API_PrepareCipherOneShot
+ *
+ * Encodes the invariant part of a CipherOneShot command (object id, cipher
+ * mode and operation) once into pCmd, for repeated use through
+ * Se05x_API_PreparedCipherOneShot. Nothing is sent to the SE.
+ *
+ * @param[in] session_ctx Session Context [0:kSE05x_pSession]
+ * @param[in] objectID objectID [1:kSE05x_TAG_1]
+ * @param[in] cipherMode cipherMode [2:kSE05x_TAG_2]
+ * @param[in] operation The operation
+ * @param[out] pCmd Prepared command
+ */
+smStatus_t Se05x_API_PrepareCipherOneShot(pSe05xSession_t session_ctx,
+    uint32_t objectID,
+    SE05x_CipherMode_t cipherMode,
+    const SE05x_Cipher_Oper_OneShot_t operation,
+    Se05xPreparedCmd_t *pCmd);
+
+/** Se05x_API_PreparedCipherOneShot
+ *
+ * Same as Se05x_API_CipherOneShot with the key, mode and operation of pCmd,
+ * see Se05x_API_PrepareCipherOneShot. Only inputData and IV are encoded per call.
+ *
+ * @param[in] pCmd Command prepared by Se05x_API_PrepareCipherOneShot
+ * @param[in] inputData inputData [3:kSE05x_TAG_3]
+ * @param[in] inputDataLen Length of inputData
+ * @param[in] IV IV [4:kSE05x_TAG_4]
+ * @param[in] IVLen Length of IV
+ * @param[out] outputData  [0:kSE05x_TAG_1]
+ * @param[in,out] poutputDataLen Length for outputData
+ */
+smStatus_t Se05x_API_PreparedCipherOneShot(const Se05xPreparedCmd_t *pCmd,
+    const uint8_t *inputData,
+    size_t inputDataLen,
+    const uint8_t *IV,
+    size_t IVLen,
+    uint8_t *outputData,
+    size_t *poutputDataLen);
+
+/** Se05x_API_PreparedCipherOneShotView
+ *
+ * Same as Se05x_API_PreparedCipherOneShot, but the output data is not
+ * copied, see Se05x_API_CipherOneShotView.
+ *
+ * @param[in] pCmd Command prepared by Se05x_API_PrepareCipherOneShot
+ * @param[in] inputData inputData [3:kSE05x_TAG_3]
+ * @param[in] inputDataLen Length of inputData
+ * @param[in] IV IV [4:kSE05x_TAG_4]
+ * @param[in] IVLen Length of IV
+ * @param[out] ppoutputData Output data [0:kSE05x_TAG_1]
+ * @param[out] poutputDataLen Length of output data
+ */
+smStatus_t Se05x_API_PreparedCipherOneShotView(const Se05xPreparedCmd_t *pCmd,
+    const uint8_t *inputData,
+    size_t inputDataLen,
+    const uint8_t *IV,
+    size_t IVLen,
+    const uint8_t **ppoutputData,
+    size_t *poutputDataLen);
+
 /** Se05x_API_WriteSymmKey
  *
  * Creates or writes an AES key, DES key or HMAC key, indicated by P1:
@@ -9,6 +9,7 @@
 #include "smCom.h"
 #include "sm_port.h"
 #include "se05x_types.h"
+#include "se05x_APDU_apis.h"
 #include "phNxpEse_Api.h"
 #include <limits.h>
 
@@ -17,11 +18,32 @@
 #define CLA_ISO7816 (0x00)   //!< ISO7816-4 defined CLA byte
 #define INS_GP_SELECT (0xA4) //!< Global platform defined instruction
 
+/* ReadObject response overhead: TLV header of the data and SW */
+#define SE05X_READ_RSP_OVERHEAD (1 + 3 + 2)
+/* ReadObject response overhead per secure messaging layer: padding, MAC and SW */
+#define SE05X_READ_SM_OVERHEAD (16 + 8 + 2)
+/* WriteBinary command overhead: APDU header, object id, offset and data TLVs */
+#define SE05X_WRITE_CMD_OVERHEAD (4 + 3 + 6 + 4 + 4)
+/* WriteBinary command overhead per secure messaging layer: wrapping, padding and MAC */
+#define SE05X_WRITE_SM_OVERHEAD (28 + 16 + 8)
+/* Length TLV of the WriteBinary command creating the object */
+#define SE05X_WRITE_LENGTH_TLV 4
+
 /* clang-format off */
 #define APPLET_NAME { 0xa0, 0x00, 0x00, 0x03, 0x96, 0x54, 0x53, 0x00, 0x00, 0x00, 0x01, 0x03, 0x00, 0x00, 0x00, 0x00 }
 #define SSD_NAME {0xD2, 0x76, 0x00, 0x00, 0x85, 0x30, 0x4A, 0x43, 0x4F, 0x90, 0x03}
 /* clang-format on */
 
+/* ********************** Data types ********************** */
+
+/* Destination of Se05x_API_ReadObjectChunked */
+typedef struct
+{
+    uint8_t *pData;
+    size_t dataLen;
+    size_t dataSize;
+} se05x_ReadBuffer_t;
+
 /* ********************** Function Prototypes ********************** */
 #if defined(WITH_PLATFORM_SCP03) || defined(WITH_ECKEY_SCP03_SESSION)
 smStatus_t Se05x_API_SCP03_CreateSession(pSe05xSession_t session_ctx);
@@ -34,6 +56,42 @@ smStatus_t Se05x_API_ECKey_CloseSession(pSe05xSession_t session_ctx);
 
 /* ********************** Functions ********************** */
 
+/**
+* Gets the value of tag from the response, the status word follows the TLVs.
+* The value is not copied, it points into the response buffer.
+*/
+static smStatus_t se05x_GetRspView(
+    const uint8_t *pRspbuf, size_t rspbufLen, SE05x_TAG_t tag, const uint8_t **ppdata, size_t *pdataLen)
+{
+    tlvViews_t views;
+    const tlvView_t *pView = NULL;
+
+    ENSURE_OR_RETURN_ON_ERROR(rspbufLen >= 2, SM_NOT_OK);
+    ENSURE_OR_RETURN_ON_ERROR(tlvGet_Views(pRspbuf, rspbufLen - 2, &views) == 0, SM_NOT_OK);
+    pView = tlvGet_FindView(&views, tag);
+    ENSURE_OR_RETURN_ON_ERROR(pView != NULL, SM_NOT_OK);
+
+    *ppdata   = pView->pValue;
+    *pdataLen = pView->valueLen;
+    return (smStatus_t)((pRspbuf[rspbufLen - 2] << 8) | (pRspbuf[rspbufLen - 1]));
+}
+
+/**
+* Copies the value returned by a *View API to the buffer of the caller
+*/
+static smStatus_t se05x_CopyView(const uint8_t *pView, size_t viewLen, uint8_t *data, size_t *pdataLen)
+{
+    if ((data == NULL) || (pdataLen == NULL) || (viewLen > *pdataLen)) {
+        if (pdataLen != NULL) {
+            *pdataLen = 0;
+        }
+        return SM_NOT_OK;
+    }
+    memmove(data, pView, viewLen);
+    *pdataLen = viewLen;
+    return SM_OK;
+}
+
 bool Se05x_IsInValidRangeOfUID(uint32_t uid)
 {
     // Block required keyids
@@ -41,17 +99,24 @@ bool Se05x_IsInValidRangeOfUID(uint32_t uid)
     return FALSE;
 }
 
-smStatus_t Se05x_API_SessionOpen(pSe05xSession_t session_ctx)
+/* Forgets the keys and state of the secure channel, the SE drops its side on the next SELECT */
+static void Se05x_API_ClearSecureChannel(pSe05xSession_t session_ctx)
 {
-    size_t buff_len            = 0;
-    size_t tx_len              = 0;
-    smStatus_t ret             = SM_NOT_OK;
-    unsigned char appletName[] = APPLET_NAME;
-#if defined(WITH_PLATFORM_SCP03)
-    unsigned char ssdName[] = SSD_NAME;
+#if defined(WITH_ECKEY_SESSION) || defined(WITH_ECKEY_SCP03_SESSION)
+    Se05x_API_ECKey_CloseSession(session_ctx);
 #endif
-    unsigned char *appSsdName = NULL;
-    size_t appSsdNameLen      = 0;
+    memset(session_ctx->scp03_session_enc_Key, 0, sizeof(session_ctx->scp03_session_enc_Key));
+    memset(session_ctx->scp03_session_mac_Key, 0, sizeof(session_ctx->scp03_session_mac_Key));
+    memset(session_ctx->scp03_session_rmac_Key, 0, sizeof(session_ctx->scp03_session_rmac_Key));
+    memset(session_ctx->scp03_counter, 0, sizeof(session_ctx->scp03_counter));
+    memset(session_ctx->scp03_mcv, 0, sizeof(session_ctx->scp03_mcv));
+    session_ctx->scp03_session = 0;
+}
+
+smStatus_t Se05x_API_LinkOpen(pSe05xSession_t session_ctx)
+{
+    size_t buff_len = 0;
+    smStatus_t ret  = SM_NOT_OK;
 
     SMLOG_I("Plug and Trust nano package - version: %d.%d.%d \n", VERSION_MAJOR, VERSION_MINOR, VERSION_DEV);
 
@@ -59,7 +124,7 @@ smStatus_t Se05x_API_SessionOpen(pSe05xSession_t session_ctx)
 
     buff_len = sizeof(session_ctx->apdu_buffer);
 
-    ret = smComT1oI2C_Init(&session_ctx->conn_context, NULL);
+    ret = smComT1oI2C_InitEx(&session_ctx->conn_context, session_ctx->pConnString, session_ctx->pIoConfig);
     ENSURE_OR_GO_CLEANUP(SM_OK == ret);
 
     if (session_ctx->session_resume == 1) {
@@ -68,11 +133,53 @@ smStatus_t Se05x_API_SessionOpen(pSe05xSession_t session_ctx)
     else {
         ret = smComT1oI2C_Open(session_ctx->conn_context, ESE_MODE_NORMAL, 0x00, session_ctx->apdu_buffer, &buff_len);
     }
-    ENSURE_OR_GO_CLEANUP(SM_OK == ret);
+    if (ret != SM_OK) {
+        smComT1oI2C_Close(session_ctx->conn_context, 0);
+        session_ctx->conn_context = NULL;
+    }
+
+cleanup:
+    return ret;
+}
+
+smStatus_t Se05x_API_LinkClose(pSe05xSession_t session_ctx)
+{
+    smStatus_t retStatus = SM_NOT_OK;
+
+    ENSURE_OR_GO_CLEANUP(session_ctx != NULL);
+
+    retStatus = smComT1oI2C_Close(session_ctx->conn_context, 0);
+    ENSURE_OR_GO_CLEANUP(retStatus == SM_OK);
+
+    memset(session_ctx, 0, sizeof(Se05xSession_t));
+
+cleanup:
+    return retStatus;
+}
+
+smStatus_t Se05x_API_AppletSessionOpen(pSe05xSession_t session_ctx)
+{
+    size_t buff_len            = 0;
+    size_t tx_len              = 0;
+    smStatus_t ret             = SM_NOT_OK;
+    unsigned char appletName[] = APPLET_NAME;
+#if defined(WITH_PLATFORM_SCP03)
+    unsigned char ssdName[] = SSD_NAME;
+#endif
+    unsigned char *appSsdName = NULL;
+    size_t appSsdNameLen      = 0;
+
+    ENSURE_OR_GO_CLEANUP(session_ctx != NULL);
+    ENSURE_OR_GO_CLEANUP(session_ctx->conn_context != NULL);
+
+    /* A previous applet session on this link is replaced, a resumed one keeps its keys */
+    if (!session_ctx->session_resume) {
+        Se05x_API_ClearSecureChannel(session_ctx);
+    }
 
     if (session_ctx->skip_applet_select == 1) {
 #if !defined(WITH_PLATFORM_SCP03)
-        return ret;
+        return SM_OK;
 #else
         appSsdName    = &ssdName[0];
         appSsdNameLen = sizeof(ssdName);
@@ -101,7 +208,7 @@ smStatus_t Se05x_API_SessionOpen(pSe05xSession_t session_ctx)
         ret      = smComT1oI2C_TransceiveRaw(
             session_ctx->conn_context, session_ctx->apdu_buffer, tx_len, session_ctx->apdu_buffer, &buff_len);
         if (ret != SM_OK) {
-            SMLOG_E("Se05x_API_SessionOpen failed");
+            SMLOG_E("Se05x_API_AppletSessionOpen failed");
             goto cleanup;
         }
         session_ctx->applet_version = (session_ctx->apdu_buffer[0] << 24) | (session_ctx->apdu_buffer[1] << 16) |
@@ -158,15 +265,13 @@ smStatus_t Se05x_API_SessionOpen(pSe05xSession_t session_ctx)
 #endif
 
 cleanup:
-    if (ret != SM_OK) {
-        if (session_ctx != NULL) {
-            memset(session_ctx, 0, sizeof(Se05xSession_t));
-        }
+    if ((ret != SM_OK) && (session_ctx != NULL)) {
+        Se05x_API_ClearSecureChannel(session_ctx);
     }
     return ret;
 }
 
-smStatus_t Se05x_API_SessionClose(pSe05xSession_t session_ctx)
+smStatus_t Se05x_API_AppletSessionClose(pSe05xSession_t session_ctx)
 {
     smStatus_t retStatus = SM_NOT_OK;
 #if defined(WITH_ECKEY_SESSION) || defined(WITH_ECKEY_SCP03_SESSION)
@@ -175,32 +280,68 @@ smStatus_t Se05x_API_SessionClose(pSe05xSession_t session_ctx)
 
     ENSURE_OR_GO_CLEANUP(session_ctx != NULL);
 
-    SMLOG_D("APDU - Se05x_API_SessionClose [] \n");
-
 #if defined(WITH_ECKEY_SESSION) || defined(WITH_ECKEY_SCP03_SESSION)
     if (session_ctx->ecKey_session == 1) {
-        retStatus = DoAPDUTx(session_ctx, &hdr, session_ctx->apdu_buffer, 0, 0);
+        retStatus = DoAPDUTx(session_ctx, &hdr, SE05X_APDU_CMD_BUF(session_ctx), 0, 0);
         ENSURE_OR_GO_CLEANUP(retStatus == SM_OK);
     }
-
-    Se05x_API_ECKey_CloseSession(session_ctx);
 #endif
 
-#if defined(WITH_PLATFORM_SCP03) || defined(WITH_ECKEY_SCP03_SESSION)
-    //Se05x_API_SCP03_CloseSession(session_ctx);
-#endif
+    Se05x_API_ClearSecureChannel(session_ctx);
+    retStatus = SM_OK;
 
-    retStatus = smComT1oI2C_Close(session_ctx->conn_context, 0);
-    ENSURE_OR_GO_CLEANUP(retStatus == SM_OK);
+cleanup:
+    return retStatus;
+}
+
+smStatus_t Se05x_API_SessionOpen(pSe05xSession_t session_ctx)
+{
+    smStatus_t ret = SM_NOT_OK;
+
+    ENSURE_OR_GO_CLEANUP(session_ctx != NULL);
+
+    ret = Se05x_API_LinkOpen(session_ctx);
+    ENSURE_OR_GO_CLEANUP(SM_OK == ret);
+
+    ret = Se05x_API_AppletSessionOpen(session_ctx);
+    if (ret != SM_OK) {
+        smComT1oI2C_Close(session_ctx->conn_context, 0);
+    }
 
-    if (session_ctx != NULL) {
-        memset(session_ctx, 0, sizeof(Se05xSession_t));
+cleanup:
+    if (ret != SM_OK) {
+        if (session_ctx != NULL) {
+            memset(session_ctx, 0, sizeof(Se05xSession_t));
+        }
     }
+    return ret;
+}
+
+smStatus_t Se05x_API_SessionClose(pSe05xSession_t session_ctx)
+{
+    smStatus_t retStatus = SM_NOT_OK;
+
+    ENSURE_OR_GO_CLEANUP(session_ctx != NULL);
+
+    SMLOG_D("APDU - Se05x_API_SessionClose [] \n");
+
+    retStatus = Se05x_API_AppletSessionClose(session_ctx);
+    ENSURE_OR_GO_CLEANUP(retStatus == SM_OK);
+
+    retStatus = Se05x_API_LinkClose(session_ctx);
 
 cleanup:
     return retStatus;
 }
 
+smStatus_t Se05x_API_GetLinkStats(pSe05xSession_t session_ctx, struct phNxpEse_Stats *pStats)
+{
+    ENSURE_OR_RETURN_ON_ERROR(session_ctx != NULL, SM_NOT_OK);
+    ENSURE_OR_RETURN_ON_ERROR(pStats != NULL, SM_NOT_OK);
+
+    return smComT1oI2C_GetLinkStats(session_ctx->conn_context, pStats);
+}
+
 smStatus_t Se05x_API_WriteECKey(pSe05xSession_t session_ctx,
     pSe05xPolicy_t policy,
     SE05x_MaxAttemps_t maxAttempt,
@@ -221,7 +362,7 @@ smStatus_t Se05x_API_WriteECKey(pSe05xSession_t session_ctx,
 
     ENSURE_OR_GO_CLEANUP(session_ctx != NULL);
 
-    pCmdbuf = &session_ctx->apdu_buffer[0];
+    pCmdbuf = SE05X_APDU_CMD_BUF(session_ctx);
 
     if (Se05x_IsInValidRangeOfUID(objectID)) {
         return SM_NOT_OK;
@@ -254,14 +395,18 @@ smStatus_t Se05x_API_WriteECKey(pSe05xSession_t session_ctx,
         goto cleanup;
     }
 
-    retStatus = DoAPDUTx(session_ctx, &hdr, session_ctx->apdu_buffer, cmdbufLen, 0);
+    retStatus = DoAPDUTx(session_ctx, &hdr, SE05X_APDU_CMD_BUF(session_ctx), cmdbufLen, 0);
 
 cleanup:
     return retStatus;
 }
 
-smStatus_t Se05x_API_ReadObject(
-    pSe05xSession_t session_ctx, uint32_t objectID, uint16_t offset, uint16_t length, uint8_t *data, size_t *pdataLen)
+smStatus_t Se05x_API_ReadObjectView(pSe05xSession_t session_ctx,
+    uint32_t objectID,
+    uint16_t offset,
+    uint16_t length,
+    const uint8_t **ppdata,
+    size_t *pdataLen)
 {
     smStatus_t retStatus = SM_NOT_OK;
     tlvHeader_t hdr      = {{kSE05x_CLA, kSE05x_INS_READ, kSE05x_P1_DEFAULT, kSE05x_P2_DEFAULT}};
@@ -272,8 +417,10 @@ smStatus_t Se05x_API_ReadObject(
     size_t rspbufLen     = 0;
 
     ENSURE_OR_GO_CLEANUP(session_ctx != NULL);
+    ENSURE_OR_GO_CLEANUP(ppdata != NULL);
+    ENSURE_OR_GO_CLEANUP(pdataLen != NULL);
 
-    pCmdbuf   = &session_ctx->apdu_buffer[0];
+    pCmdbuf   = SE05X_APDU_CMD_BUF(session_ctx);
     pRspbuf   = &session_ctx->apdu_buffer[0];
     rspbufLen = sizeof(session_ctx->apdu_buffer);
 
@@ -291,27 +438,158 @@ smStatus_t Se05x_API_ReadObject(
     if (0 != tlvRet) {
         goto cleanup;
     }
-    retStatus = DoAPDUTxRx(session_ctx, &hdr, session_ctx->apdu_buffer, cmdbufLen, pRspbuf, &rspbufLen, 1);
+    retStatus = DoAPDUTxRx(session_ctx, &hdr, SE05X_APDU_CMD_BUF(session_ctx), cmdbufLen, pRspbuf, &rspbufLen, 1);
     if (retStatus == SM_OK) {
-        retStatus       = SM_NOT_OK;
-        size_t rspIndex = 0;
-        tlvRet          = tlvGet_u8buf(pRspbuf, &rspIndex, rspbufLen, kSE05x_TAG_1, data, pdataLen); /*  */
-        if (0 != tlvRet) {
+        retStatus = se05x_GetRspView(pRspbuf, rspbufLen, kSE05x_TAG_1, ppdata, pdataLen);
+    }
+
+    if (retStatus == SM_ERR_ACCESS_DENIED_BASED_ON_POLICY) {
+        SMLOG_I("Denied to read object %08X bases on policy.", objectID);
+    }
+
+cleanup:
+    return retStatus;
+}
+
+smStatus_t Se05x_API_ReadObject(
+    pSe05xSession_t session_ctx, uint32_t objectID, uint16_t offset, uint16_t length, uint8_t *data, size_t *pdataLen)
+{
+    smStatus_t retStatus = SM_NOT_OK;
+    const uint8_t *pView = NULL;
+    size_t viewLen       = 0;
+
+    retStatus = Se05x_API_ReadObjectView(session_ctx, objectID, offset, length, &pView, &viewLen);
+    if (retStatus == SM_OK) {
+        retStatus = se05x_CopyView(pView, viewLen, data, pdataLen);
+    }
+    return retStatus;
+}
+
+/**
+* Largest data chunk of a command or response that fits the APDU buffer with the overhead
+* and the secure messaging layers of the session. The APDU is kept to whole T=1 frames.
+*/
+static size_t se05x_ChunkSize(pSe05xSession_t session_ctx, size_t overhead, size_t smOverhead, uint8_t isCommand)
+{
+    size_t apduMax = MAX_APDU_BUFFER;
+    size_t frameSize;
+    uint16_t ifsc = 0;
+    uint16_t ifsd = 0;
+
+    if (session_ctx->scp03_session) {
+        overhead += smOverhead;
+    }
+    if (session_ctx->ecKey_session) {
+        overhead += smOverhead;
+    }
+    if (smComT1oI2C_GetIfs(session_ctx->conn_context, &ifsc, &ifsd) == SM_OK) {
+        frameSize = (isCommand) ? ifsc : ifsd;
+        if ((frameSize > 0) && ((apduMax - (apduMax % frameSize)) > overhead)) {
+            apduMax -= apduMax % frameSize;
+        }
+    }
+    if (apduMax <= overhead) {
+        return 0;
+    }
+    return ((apduMax - overhead) > UINT16_MAX) ? UINT16_MAX : (apduMax - overhead);
+}
+
+smStatus_t Se05x_API_ReadObjectStream(pSe05xSession_t session_ctx,
+    uint32_t objectID,
+    uint16_t offset,
+    uint16_t length,
+    Se05xReadChunkCb_t pChunkCb,
+    void *pCbCtx)
+{
+    smStatus_t retStatus = SM_NOT_OK;
+    size_t chunkMax      = 0;
+    uint16_t objectSize  = 0;
+    uint16_t chunk       = 0;
+    const uint8_t *pData = NULL;
+    size_t dataLen       = 0;
+
+    ENSURE_OR_GO_CLEANUP(session_ctx != NULL);
+    ENSURE_OR_GO_CLEANUP(pChunkCb != NULL);
+
+    chunkMax = se05x_ChunkSize(session_ctx, SE05X_READ_RSP_OVERHEAD, SE05X_READ_SM_OVERHEAD, 0);
+    ENSURE_OR_GO_CLEANUP(chunkMax > 0);
+
+    SMLOG_D("APDU - ReadObjectStream [] \n");
+
+    if (length == 0) {
+        retStatus = Se05x_API_ReadSize(session_ctx, objectID, &objectSize);
+        if (retStatus != SM_OK) {
             goto cleanup;
         }
-        if ((rspIndex + 2) == rspbufLen) {
-            retStatus = (pRspbuf[rspIndex] << 8) | (pRspbuf[rspIndex + 1]);
+        if ((offset == 0) && (objectSize <= chunkMax)) {
+            /* One response, also for objects that are not read by offset, e.g. keys */
+            retStatus = Se05x_API_ReadObjectView(session_ctx, objectID, 0, 0, &pData, &dataLen);
+            if (retStatus == SM_OK) {
+                retStatus = pChunkCb(pCbCtx, 0, pData, dataLen);
+            }
+            goto cleanup;
         }
+        retStatus = SM_NOT_OK;
+        ENSURE_OR_GO_CLEANUP(offset <= objectSize);
+        length = objectSize - offset;
     }
+    ENSURE_OR_GO_CLEANUP(((size_t)offset + length) <= ((size_t)UINT16_MAX + 1));
 
-    if (retStatus == SM_ERR_ACCESS_DENIED_BASED_ON_POLICY) {
-        SMLOG_I("Denied to read object %08X bases on policy.", objectID);
+    retStatus = SM_OK;
+    while (length > 0) {
+        chunk     = (length > chunkMax) ? (uint16_t)chunkMax : length;
+        retStatus = Se05x_API_ReadObjectView(session_ctx, objectID, offset, chunk, &pData, &dataLen);
+        if (retStatus != SM_OK) {
+            goto cleanup;
+        }
+        if (dataLen != chunk) {
+            retStatus = SM_NOT_OK;
+            goto cleanup;
+        }
+        retStatus = pChunkCb(pCbCtx, offset, pData, dataLen);
+        if (retStatus != SM_OK) {
+            goto cleanup;
+        }
+        offset += chunk;
+        length -= chunk;
     }
 
 cleanup:
     return retStatus;
 }
 
+/**
+* Appends a chunk of Se05x_API_ReadObjectChunked to the buffer of the caller
+*/
+static smStatus_t se05x_ReadToBuffer(void *pCbCtx, uint16_t offset, const uint8_t *pChunk, size_t chunkLen)
+{
+    se05x_ReadBuffer_t *pBuffer = (se05x_ReadBuffer_t *)pCbCtx;
+
+    (void)offset;
+    ENSURE_OR_RETURN_ON_ERROR(chunkLen <= (pBuffer->dataSize - pBuffer->dataLen), SM_NOT_OK);
+    memcpy(&pBuffer->pData[pBuffer->dataLen], pChunk, chunkLen);
+    pBuffer->dataLen += chunkLen;
+    return SM_OK;
+}
+
+smStatus_t Se05x_API_ReadObjectChunked(
+    pSe05xSession_t session_ctx, uint32_t objectID, uint16_t offset, uint16_t length, uint8_t *data, size_t *pdataLen)
+{
+    smStatus_t retStatus      = SM_NOT_OK;
+    se05x_ReadBuffer_t buffer = {0};
+
+    ENSURE_OR_GO_CLEANUP(data != NULL);
+    ENSURE_OR_GO_CLEANUP(pdataLen != NULL);
+
+    buffer.pData    = data;
+    buffer.dataSize = *pdataLen;
+    retStatus       = Se05x_API_ReadObjectStream(session_ctx, objectID, offset, length, &se05x_ReadToBuffer, &buffer);
+    *pdataLen       = buffer.dataLen;
+
+cleanup:
+    return retStatus;
+}
+
 smStatus_t Se05x_API_GetVersion(pSe05xSession_t session_ctx, uint8_t *pappletVersion, size_t *appletVersionLen)
 {
     smStatus_t retStatus = SM_NOT_OK;
@@ -327,7 +605,7 @@ smStatus_t Se05x_API_GetVersion(pSe05xSession_t session_ctx, uint8_t *pappletVer
 
     SMLOG_D("APDU - GetVersion [] \n");
 
-    retStatus = DoAPDUTxRx(session_ctx, &hdr, session_ctx->apdu_buffer, 0, pRspbuf, &rspbufLen, 0);
+    retStatus = DoAPDUTxRx(session_ctx, &hdr, SE05X_APDU_CMD_BUF(session_ctx), 0, pRspbuf, &rspbufLen, 0);
     if (retStatus == SM_OK) {
         retStatus       = SM_NOT_OK;
         size_t rspIndex = 0;
@@ -344,12 +622,12 @@ cleanup:
     return retStatus;
 }
 
-smStatus_t Se05x_API_ECDSASign(pSe05xSession_t session_ctx,
+smStatus_t Se05x_API_ECDSASignView(pSe05xSession_t session_ctx,
     uint32_t objectID,
     SE05x_ECSignatureAlgo_t ecSignAlgo,
     const uint8_t *inputData,
     size_t inputDataLen,
-    uint8_t *signature,
+    const uint8_t **ppsignature,
     size_t *psignatureLen)
 {
     smStatus_t retStatus = SM_NOT_OK;
@@ -361,8 +639,10 @@ smStatus_t Se05x_API_ECDSASign(pSe05xSession_t session_ctx,
     size_t rspbufLen     = 0;
 
     ENSURE_OR_GO_CLEANUP(session_ctx != NULL);
+    ENSURE_OR_GO_CLEANUP(ppsignature != NULL);
+    ENSURE_OR_GO_CLEANUP(psignatureLen != NULL);
 
-    pCmdbuf   = &session_ctx->apdu_buffer[0];
+    pCmdbuf   = SE05X_APDU_CMD_BUF(session_ctx);
     pRspbuf   = &session_ctx->apdu_buffer[0];
     rspbufLen = sizeof(session_ctx->apdu_buffer);
 
@@ -380,23 +660,34 @@ smStatus_t Se05x_API_ECDSASign(pSe05xSession_t session_ctx,
     if (0 != tlvRet) {
         goto cleanup;
     }
-    retStatus = DoAPDUTxRx(session_ctx, &hdr, session_ctx->apdu_buffer, cmdbufLen, pRspbuf, &rspbufLen, 0);
+    retStatus = DoAPDUTxRx(session_ctx, &hdr, SE05X_APDU_CMD_BUF(session_ctx), cmdbufLen, pRspbuf, &rspbufLen, 0);
     if (retStatus == SM_OK) {
-        retStatus       = SM_NOT_OK;
-        size_t rspIndex = 0;
-        tlvRet          = tlvGet_u8buf(pRspbuf, &rspIndex, rspbufLen, kSE05x_TAG_1, signature, psignatureLen); /*  */
-        if (0 != tlvRet) {
-            goto cleanup;
-        }
-        if ((rspIndex + 2) == rspbufLen) {
-            retStatus = (pRspbuf[rspIndex] << 8) | (pRspbuf[rspIndex + 1]);
-        }
+        retStatus = se05x_GetRspView(pRspbuf, rspbufLen, kSE05x_TAG_1, ppsignature, psignatureLen);
     }
 
 cleanup:
     return retStatus;
 }
 
+smStatus_t Se05x_API_ECDSASign(pSe05xSession_t session_ctx,
+    uint32_t objectID,
+    SE05x_ECSignatureAlgo_t ecSignAlgo,
+    const uint8_t *inputData,
+    size_t inputDataLen,
+    uint8_t *signature,
+    size_t *psignatureLen)
+{
+    smStatus_t retStatus = SM_NOT_OK;
+    const uint8_t *pView = NULL;
+    size_t viewLen       = 0;
+
+    retStatus = Se05x_API_ECDSASignView(session_ctx, objectID, ecSignAlgo, inputData, inputDataLen, &pView, &viewLen);
+    if (retStatus == SM_OK) {
+        retStatus = se05x_CopyView(pView, viewLen, signature, psignatureLen);
+    }
+    return retStatus;
+}
+
 smStatus_t Se05x_API_ECDSAVerify(pSe05xSession_t session_ctx,
     uint32_t objectID,
     SE05x_ECSignatureAlgo_t ecSignAlgo,
@@ -416,7 +707,7 @@ smStatus_t Se05x_API_ECDSAVerify(pSe05xSession_t session_ctx,
 
     ENSURE_OR_GO_CLEANUP(session_ctx != NULL);
 
-    pCmdbuf   = &session_ctx->apdu_buffer[0];
+    pCmdbuf   = SE05X_APDU_CMD_BUF(session_ctx);
     pRspbuf   = &session_ctx->apdu_buffer[0];
     rspbufLen = sizeof(session_ctx->apdu_buffer);
 
@@ -438,7 +729,7 @@ smStatus_t Se05x_API_ECDSAVerify(pSe05xSession_t session_ctx,
     if (0 != tlvRet) {
         goto cleanup;
     }
-    retStatus = DoAPDUTxRx(session_ctx, &hdr, session_ctx->apdu_buffer, cmdbufLen, pRspbuf, &rspbufLen, 0);
+    retStatus = DoAPDUTxRx(session_ctx, &hdr, SE05X_APDU_CMD_BUF(session_ctx), cmdbufLen, pRspbuf, &rspbufLen, 0);
     if (retStatus == SM_OK) {
         retStatus       = SM_NOT_OK;
         size_t rspIndex = 0;
@@ -467,7 +758,7 @@ smStatus_t Se05x_API_CheckObjectExists(pSe05xSession_t session_ctx, uint32_t obj
 
     ENSURE_OR_GO_CLEANUP(session_ctx != NULL);
 
-    pCmdbuf   = &session_ctx->apdu_buffer[0];
+    pCmdbuf   = SE05X_APDU_CMD_BUF(session_ctx);
     pRspbuf   = &session_ctx->apdu_buffer[0];
     rspbufLen = sizeof(session_ctx->apdu_buffer);
 
@@ -477,7 +768,7 @@ smStatus_t Se05x_API_CheckObjectExists(pSe05xSession_t session_ctx, uint32_t obj
     if (0 != tlvRet) {
         goto cleanup;
     }
-    retStatus = DoAPDUTxRx(session_ctx, &hdr, session_ctx->apdu_buffer, cmdbufLen, pRspbuf, &rspbufLen, 0);
+    retStatus = DoAPDUTxRx(session_ctx, &hdr, SE05X_APDU_CMD_BUF(session_ctx), cmdbufLen, pRspbuf, &rspbufLen, 0);
     if (retStatus == SM_OK) {
         retStatus       = SM_NOT_OK;
         size_t rspIndex = 0;
@@ -510,7 +801,7 @@ smStatus_t Se05x_API_WriteBinary(pSe05xSession_t session_ctx,
 
     ENSURE_OR_GO_CLEANUP(session_ctx != NULL);
 
-    pCmdbuf = &session_ctx->apdu_buffer[0];
+    pCmdbuf = SE05X_APDU_CMD_BUF(session_ctx);
 
     if (Se05x_IsInValidRangeOfUID(objectID)) {
         return SM_NOT_OK;
@@ -538,17 +829,17 @@ smStatus_t Se05x_API_WriteBinary(pSe05xSession_t session_ctx,
     if (0 != tlvRet) {
         goto cleanup;
     }
-    retStatus = DoAPDUTx(session_ctx, &hdr, session_ctx->apdu_buffer, cmdbufLen, 0);
+    retStatus = DoAPDUTx(session_ctx, &hdr, SE05X_APDU_CMD_BUF(session_ctx), cmdbufLen, 0);
 
 cleanup:
     return retStatus;
 }
 
-smStatus_t Se05x_API_ECDHGenerateSharedSecret(pSe05xSession_t session_ctx,
+smStatus_t Se05x_API_ECDHGenerateSharedSecretView(pSe05xSession_t session_ctx,
     uint32_t objectID,
     const uint8_t *pubKey,
     size_t pubKeyLen,
-    uint8_t *sharedSecret,
+    const uint8_t **ppsharedSecret,
     size_t *psharedSecretLen)
 {
     smStatus_t retStatus = SM_NOT_OK;
@@ -560,8 +851,10 @@ smStatus_t Se05x_API_ECDHGenerateSharedSecret(pSe05xSession_t session_ctx,
     size_t rspbufLen     = 0;
 
     ENSURE_OR_GO_CLEANUP(session_ctx != NULL);
+    ENSURE_OR_GO_CLEANUP(ppsharedSecret != NULL);
+    ENSURE_OR_GO_CLEANUP(psharedSecretLen != NULL);
 
-    pCmdbuf   = &session_ctx->apdu_buffer[0];
+    pCmdbuf   = SE05X_APDU_CMD_BUF(session_ctx);
     pRspbuf   = &session_ctx->apdu_buffer[0];
     rspbufLen = sizeof(session_ctx->apdu_buffer);
 
@@ -575,33 +868,43 @@ smStatus_t Se05x_API_ECDHGenerateSharedSecret(pSe05xSession_t session_ctx,
     if (0 != tlvRet) {
         goto cleanup;
     }
-    retStatus = DoAPDUTxRx(session_ctx, &hdr, session_ctx->apdu_buffer, cmdbufLen, pRspbuf, &rspbufLen, 0);
+    retStatus = DoAPDUTxRx(session_ctx, &hdr, SE05X_APDU_CMD_BUF(session_ctx), cmdbufLen, pRspbuf, &rspbufLen, 0);
     if (retStatus == SM_OK) {
-        retStatus       = SM_NOT_OK;
-        size_t rspIndex = 0;
-        tlvRet = tlvGet_u8buf(pRspbuf, &rspIndex, rspbufLen, kSE05x_TAG_1, sharedSecret, psharedSecretLen); /*  */
-        if (0 != tlvRet) {
-            goto cleanup;
-        }
-        if ((rspIndex + 2) == rspbufLen) {
-            retStatus = (pRspbuf[rspIndex] << 8) | (pRspbuf[rspIndex + 1]);
-        }
+        retStatus = se05x_GetRspView(pRspbuf, rspbufLen, kSE05x_TAG_1, ppsharedSecret, psharedSecretLen);
     }
 
 cleanup:
     return retStatus;
 }
 
-smStatus_t Se05x_API_CipherOneShot(pSe05xSession_t session_ctx,
+smStatus_t Se05x_API_ECDHGenerateSharedSecret(pSe05xSession_t session_ctx,
+    uint32_t objectID,
+    const uint8_t *pubKey,
+    size_t pubKeyLen,
+    uint8_t *sharedSecret,
+    size_t *psharedSecretLen)
+{
+    smStatus_t retStatus = SM_NOT_OK;
+    const uint8_t *pView = NULL;
+    size_t viewLen       = 0;
+
+    retStatus = Se05x_API_ECDHGenerateSharedSecretView(session_ctx, objectID, pubKey, pubKeyLen, &pView, &viewLen);
+    if (retStatus == SM_OK) {
+        retStatus = se05x_CopyView(pView, viewLen, sharedSecret, psharedSecretLen);
+    }
+    return retStatus;
+}
+
+smStatus_t Se05x_API_CipherOneShotView(pSe05xSession_t session_ctx,
     uint32_t objectID,
     SE05x_CipherMode_t cipherMode,
     const uint8_t *inputData,
     size_t inputDataLen,
     uint8_t *IV,
     size_t IVLen,
-    uint8_t *outputData,
-    size_t *poutputDataLen,
-    const SE05x_Cipher_Oper_OneShot_t operation)
+    const SE05x_Cipher_Oper_OneShot_t operation,
+    const uint8_t **ppoutputData,
+    size_t *poutputDataLen)
 {
     smStatus_t retStatus = SM_NOT_OK;
     tlvHeader_t hdr      = {{kSE05x_CLA, kSE05x_INS_CRYPTO, kSE05x_P1_CIPHER, operation}};
@@ -612,8 +915,10 @@ smStatus_t Se05x_API_CipherOneShot(pSe05xSession_t session_ctx,
     size_t rspbufLen     = 0;
 
     ENSURE_OR_GO_CLEANUP(session_ctx != NULL);
+    ENSURE_OR_GO_CLEANUP(ppoutputData != NULL);
+    ENSURE_OR_GO_CLEANUP(poutputDataLen != NULL);
 
-    pCmdbuf   = &session_ctx->apdu_buffer[0];
+    pCmdbuf   = SE05X_APDU_CMD_BUF(session_ctx);
     pRspbuf   = &session_ctx->apdu_buffer[0];
     rspbufLen = sizeof(session_ctx->apdu_buffer);
 
@@ -636,17 +941,304 @@ smStatus_t Se05x_API_CipherOneShot(pSe05xSession_t session_ctx,
         goto cleanup;
     }
 
-    retStatus = DoAPDUTxRx(session_ctx, &hdr, session_ctx->apdu_buffer, cmdbufLen, pRspbuf, &rspbufLen, 0);
+    retStatus = DoAPDUTxRx(session_ctx, &hdr, SE05X_APDU_CMD_BUF(session_ctx), cmdbufLen, pRspbuf, &rspbufLen, 0);
     if (retStatus == SM_OK) {
-        retStatus       = SM_NOT_OK;
-        size_t rspIndex = 0;
-        tlvRet          = tlvGet_u8buf(pRspbuf, &rspIndex, rspbufLen, kSE05x_TAG_1, outputData, poutputDataLen); /*  */
-        if (0 != tlvRet) {
+        retStatus = se05x_GetRspView(pRspbuf, rspbufLen, kSE05x_TAG_1, ppoutputData, poutputDataLen);
+    }
+
+cleanup:
+    return retStatus;
+}
+
+smStatus_t Se05x_API_CipherOneShot(pSe05xSession_t session_ctx,
+    uint32_t objectID,
+    SE05x_CipherMode_t cipherMode,
+    const uint8_t *inputData,
+    size_t inputDataLen,
+    uint8_t *IV,
+    size_t IVLen,
+    uint8_t *outputData,
+    size_t *poutputDataLen,
+    const SE05x_Cipher_Oper_OneShot_t operation)
+{
+    smStatus_t retStatus = SM_NOT_OK;
+    const uint8_t *pView = NULL;
+    size_t viewLen       = 0;
+
+    retStatus = Se05x_API_CipherOneShotView(
+        session_ctx, objectID, cipherMode, inputData, inputDataLen, IV, IVLen, operation, &pView, &viewLen);
+    if (retStatus == SM_OK) {
+        retStatus = se05x_CopyView(pView, viewLen, outputData, poutputDataLen);
+    }
+    return retStatus;
+}
+
+/**
+* Sends a prepared command with the variable TLVs and returns the TAG_1 value of the response
+*/
+static smStatus_t se05x_PreparedCmdView(const Se05xPreparedCmd_t *pCmd,
+    uint8_t p1,
+    const uint8_t *inputData,
+    size_t inputDataLen,
+    const uint8_t *IV,
+    size_t IVLen,
+    const uint8_t **ppoutputData,
+    size_t *poutputDataLen)
+{
+    smStatus_t retStatus        = SM_NOT_OK;
+    pSe05xSession_t session_ctx = NULL;
+    size_t cmdbufLen            = 0;
+    uint8_t *pCmdbuf            = NULL;
+    int tlvRet                  = 0;
+    uint8_t *pRspbuf            = NULL;
+    size_t rspbufLen            = 0;
+
+    ENSURE_OR_GO_CLEANUP(pCmd != NULL);
+    ENSURE_OR_GO_CLEANUP(pCmd->session_ctx != NULL);
+    ENSURE_OR_GO_CLEANUP(pCmd->hdr.hdr[2] == p1);
+    ENSURE_OR_GO_CLEANUP(pCmd->prefixLen <= sizeof(pCmd->prefix));
+    ENSURE_OR_GO_CLEANUP(ppoutputData != NULL);
+    ENSURE_OR_GO_CLEANUP(poutputDataLen != NULL);
+
+    session_ctx = pCmd->session_ctx;
+    pCmdbuf     = SE05X_APDU_CMD_BUF(session_ctx);
+    pRspbuf     = &session_ctx->apdu_buffer[0];
+    rspbufLen   = sizeof(session_ctx->apdu_buffer);
+
+    memcpy(pCmdbuf, pCmd->prefix, pCmd->prefixLen);
+    pCmdbuf += pCmd->prefixLen;
+    cmdbufLen = pCmd->prefixLen;
+
+    tlvRet = tlvSet_u8bufOptional(&pCmdbuf, &cmdbufLen, kSE05x_TAG_3, inputData, inputDataLen);
+    if (0 != tlvRet) {
+        goto cleanup;
+    }
+    tlvRet = tlvSet_u8bufOptional(&pCmdbuf, &cmdbufLen, kSE05x_TAG_4, IV, IVLen);
+    if (0 != tlvRet) {
+        goto cleanup;
+    }
+
+    retStatus = DoAPDUTxRx(session_ctx, &pCmd->hdr, SE05X_APDU_CMD_BUF(session_ctx), cmdbufLen, pRspbuf, &rspbufLen, 0);
+    if (retStatus == SM_OK) {
+        retStatus = se05x_GetRspView(pRspbuf, rspbufLen, kSE05x_TAG_1, ppoutputData, poutputDataLen);
+    }
+
+cleanup:
+    return retStatus;
+}
+
+smStatus_t Se05x_API_PrepareECDSASign(pSe05xSession_t session_ctx,
+    uint32_t objectID,
+    SE05x_ECSignatureAlgo_t ecSignAlgo,
+    Se05xPreparedCmd_t *pCmd)
+{
+    smStatus_t retStatus = SM_NOT_OK;
+    tlvHeader_t hdr      = {{kSE05x_CLA, kSE05x_INS_CRYPTO, kSE05x_P1_SIGNATURE, kSE05x_P2_SIGN}};
+    uint8_t *pPrefix     = NULL;
+    int tlvRet           = 0;
+
+    ENSURE_OR_GO_CLEANUP(session_ctx != NULL);
+    ENSURE_OR_GO_CLEANUP(pCmd != NULL);
+
+    SMLOG_D("APDU - PrepareECDSASign [] \n");
+
+    memset(pCmd, 0, sizeof(*pCmd));
+    pCmd->session_ctx = session_ctx;
+    pCmd->hdr         = hdr;
+    pPrefix           = pCmd->prefix;
+
+    tlvRet = TLVSET_U32("objectID", &pPrefix, &pCmd->prefixLen, kSE05x_TAG_1, objectID);
+    if (0 != tlvRet) {
+        goto cleanup;
+    }
+    tlvRet = TLVSET_ECSignatureAlgo("ecSignAlgo", &pPrefix, &pCmd->prefixLen, kSE05x_TAG_2, ecSignAlgo);
+    if (0 != tlvRet) {
+        goto cleanup;
+    }
+    retStatus = SM_OK;
+
+cleanup:
+    return retStatus;
+}
+
+smStatus_t Se05x_API_PreparedECDSASignView(const Se05xPreparedCmd_t *pCmd,
+    const uint8_t *inputData,
+    size_t inputDataLen,
+    const uint8_t **ppsignature,
+    size_t *psignatureLen)
+{
+    return se05x_PreparedCmdView(
+        pCmd, kSE05x_P1_SIGNATURE, inputData, inputDataLen, NULL, 0, ppsignature, psignatureLen);
+}
+
+smStatus_t Se05x_API_PreparedECDSASign(const Se05xPreparedCmd_t *pCmd,
+    const uint8_t *inputData,
+    size_t inputDataLen,
+    uint8_t *signature,
+    size_t *psignatureLen)
+{
+    smStatus_t retStatus = SM_NOT_OK;
+    const uint8_t *pView = NULL;
+    size_t viewLen       = 0;
+
+    retStatus = Se05x_API_PreparedECDSASignView(pCmd, inputData, inputDataLen, &pView, &viewLen);
+    if (retStatus == SM_OK) {
+        retStatus = se05x_CopyView(pView, viewLen, signature, psignatureLen);
+    }
+    return retStatus;
+}
+
+smStatus_t Se05x_API_PrepareCipherOneShot(pSe05xSession_t session_ctx,
+    uint32_t objectID,
+    SE05x_CipherMode_t cipherMode,
+    const SE05x_Cipher_Oper_OneShot_t operation,
+    Se05xPreparedCmd_t *pCmd)
+{
+    smStatus_t retStatus = SM_NOT_OK;
+    tlvHeader_t hdr      = {{kSE05x_CLA, kSE05x_INS_CRYPTO, kSE05x_P1_CIPHER, operation}};
+    uint8_t *pPrefix     = NULL;
+    int tlvRet           = 0;
+
+    ENSURE_OR_GO_CLEANUP(session_ctx != NULL);
+    ENSURE_OR_GO_CLEANUP(pCmd != NULL);
+
+    SMLOG_D("APDU - PrepareCipherOneShot [] \n");
+
+    memset(pCmd, 0, sizeof(*pCmd));
+    pCmd->session_ctx = session_ctx;
+    pCmd->hdr         = hdr;
+    pPrefix           = pCmd->prefix;
+
+    tlvRet = TLVSET_U32("objectID", &pPrefix, &pCmd->prefixLen, kSE05x_TAG_1, objectID);
+    if (0 != tlvRet) {
+        goto cleanup;
+    }
+    tlvRet = TLVSET_CipherMode("cipherMode", &pPrefix, &pCmd->prefixLen, kSE05x_TAG_2, cipherMode);
+    if (0 != tlvRet) {
+        goto cleanup;
+    }
+    retStatus = SM_OK;
+
+cleanup:
+    return retStatus;
+}
+
+smStatus_t Se05x_API_PreparedCipherOneShotView(const Se05xPreparedCmd_t *pCmd,
+    const uint8_t *inputData,
+    size_t inputDataLen,
+    const uint8_t *IV,
+    size_t IVLen,
+    const uint8_t **ppoutputData,
+    size_t *poutputDataLen)
+{
+    return se05x_PreparedCmdView(
+        pCmd, kSE05x_P1_CIPHER, inputData, inputDataLen, IV, IVLen, ppoutputData, poutputDataLen);
+}
+
+smStatus_t Se05x_API_PreparedCipherOneShot(const Se05xPreparedCmd_t *pCmd,
+    const uint8_t *inputData,
+    size_t inputDataLen,
+    const uint8_t *IV,
+    size_t IVLen,
+    uint8_t *outputData,
+    size_t *poutputDataLen)
+{
+    smStatus_t retStatus = SM_NOT_OK;
+    const uint8_t *pView = NULL;
+    size_t viewLen       = 0;
+
+    retStatus = Se05x_API_PreparedCipherOneShotView(pCmd, inputData, inputDataLen, IV, IVLen, &pView, &viewLen);
+    if (retStatus == SM_OK) {
+        retStatus = se05x_CopyView(pView, viewLen, outputData, poutputDataLen);
+    }
+    return retStatus;
+}
+
+/**
+* SM_OK when a binary object of objectLen exists, after its create was rejected
+*/
+static smStatus_t se05x_WriteBinaryCreated(pSe05xSession_t session_ctx, uint32_t objectID, size_t objectLen)
+{
+    smStatus_t retStatus  = SM_NOT_OK;
+    SE05x_Result_t exists = kSE05x_Result_NA;
+    uint16_t size         = 0;
+
+    retStatus = Se05x_API_CheckObjectExists(session_ctx, objectID, &exists);
+    ENSURE_OR_RETURN_ON_ERROR(retStatus == SM_OK, retStatus);
+    ENSURE_OR_RETURN_ON_ERROR(exists == kSE05x_Result_SUCCESS, SM_ERR_CONDITIONS_OF_USE_NOT_SATISFIED);
+    retStatus = Se05x_API_ReadSize(session_ctx, objectID, &size);
+    ENSURE_OR_RETURN_ON_ERROR(retStatus == SM_OK, retStatus);
+    ENSURE_OR_RETURN_ON_ERROR(size == objectLen, SM_ERR_CONDITIONS_OF_USE_NOT_SATISFIED);
+    return SM_OK;
+}
+
+smStatus_t Se05x_API_WriteBinaryChunked(pSe05xSession_t session_ctx,
+    pSe05xPolicy_t policy,
+    uint32_t objectID,
+    const uint8_t *inputData,
+    size_t inputDataLen,
+    Se05xWriteProgress_t *pProgress)
+{
+    smStatus_t retStatus = SM_NOT_OK;
+    size_t overhead      = SE05X_WRITE_CMD_OVERHEAD + SE05X_WRITE_LENGTH_TLV;
+    size_t chunkMax      = 0;
+    size_t chunk         = 0;
+
+    ENSURE_OR_GO_CLEANUP(session_ctx != NULL);
+    ENSURE_OR_GO_CLEANUP(inputData != NULL);
+    ENSURE_OR_GO_CLEANUP(pProgress != NULL);
+    ENSURE_OR_GO_CLEANUP((inputDataLen > 0) && (inputDataLen <= UINT16_MAX));
+    ENSURE_OR_GO_CLEANUP(pProgress->written <= inputDataLen);
+
+    SMLOG_D("APDU - WriteBinaryChunked [] \n");
+
+    if (!pProgress->isCreated) {
+        /* The first chunk creates the object with policy and length */
+        if ((policy != NULL) && (policy->value != NULL)) {
+            overhead += 4 + policy->value_len;
+        }
+        chunkMax = se05x_ChunkSize(session_ctx, overhead, SE05X_WRITE_SM_OVERHEAD, 1);
+        ENSURE_OR_GO_CLEANUP(chunkMax > 0);
+        chunk     = (inputDataLen > chunkMax) ? chunkMax : inputDataLen;
+        retStatus = Se05x_API_WriteBinary(session_ctx, policy, objectID, 0, (uint16_t)inputDataLen, inputData, chunk);
+        if (retStatus == SM_ERR_CONDITIONS_OF_USE_NOT_SATISFIED) {
+            /* The create may have reached the SE with its response lost. An
+             * object of this length is taken as ours and rewritten from 0. */
+            retStatus = se05x_WriteBinaryCreated(session_ctx, objectID, inputDataLen);
+            if (retStatus != SM_OK) {
+                goto cleanup;
+            }
+            pProgress->isCreated = 1;
+            pProgress->written   = 0;
+        }
+        else if (retStatus != SM_OK) {
             goto cleanup;
         }
-        if ((rspIndex + 2) == rspbufLen) {
-            retStatus = (pRspbuf[rspIndex] << 8) | (pRspbuf[rspIndex + 1]);
+        else {
+            pProgress->isCreated = 1;
+            pProgress->written   = chunk;
+        }
+    }
+
+    retStatus = SM_NOT_OK;
+    chunkMax  = se05x_ChunkSize(session_ctx, SE05X_WRITE_CMD_OVERHEAD, SE05X_WRITE_SM_OVERHEAD, 1);
+    ENSURE_OR_GO_CLEANUP(chunkMax > 0);
+
+    retStatus = SM_OK;
+    while (pProgress->written < inputDataLen) {
+        chunk     = inputDataLen - pProgress->written;
+        chunk     = (chunk > chunkMax) ? chunkMax : chunk;
+        retStatus = Se05x_API_WriteBinary(session_ctx,
+            NULL,
+            objectID,
+            (uint16_t)pProgress->written,
+            0,
+            &inputData[pProgress->written],
+            chunk);
+        if (retStatus != SM_OK) {
+            goto cleanup;
         }
+        pProgress->written += chunk;
     }
 
 cleanup:
@@ -671,7 +1263,7 @@ smStatus_t Se05x_API_WriteSymmKey(pSe05xSession_t session_ctx,
 
     ENSURE_OR_GO_CLEANUP(session_ctx != NULL);
 
-    pCmdbuf = &session_ctx->apdu_buffer[0];
+    pCmdbuf = SE05X_APDU_CMD_BUF(session_ctx);
 
     if (Se05x_IsInValidRangeOfUID(objectID)) {
         return SM_NOT_OK;
@@ -699,7 +1291,7 @@ smStatus_t Se05x_API_WriteSymmKey(pSe05xSession_t session_ctx,
     if (0 != tlvRet) {
         goto cleanup;
     }
-    retStatus = DoAPDUTx(session_ctx, &hdr, session_ctx->apdu_buffer, cmdbufLen, 0);
+    retStatus = DoAPDUTx(session_ctx, &hdr, SE05X_APDU_CMD_BUF(session_ctx), cmdbufLen, 0);
 
 cleanup:
     return retStatus;
@@ -717,13 +1309,13 @@ smStatus_t Se05x_API_DeleteSecureObject(pSe05xSession_t session_ctx, uint32_t ob
 
     SMLOG_D("APDU - Se05x_API_DeleteSecureObject [] \n");
 
-    pCmdbuf = &session_ctx->apdu_buffer[0];
+    pCmdbuf = SE05X_APDU_CMD_BUF(session_ctx);
 
     tlvRet = TLVSET_U32("object id", &pCmdbuf, &cmdbufLen, kSE05x_TAG_1, objectID);
     if (0 != tlvRet) {
         goto cleanup;
     }
-    retStatus = DoAPDUTx(session_ctx, &hdr, session_ctx->apdu_buffer, cmdbufLen, 0);
+    retStatus = DoAPDUTx(session_ctx, &hdr, SE05X_APDU_CMD_BUF(session_ctx), cmdbufLen, 0);
 
 cleanup:
     return retStatus;
@@ -742,7 +1334,7 @@ smStatus_t Se05x_API_CreateSession(
 
     ENSURE_OR_GO_CLEANUP(session_ctx != NULL);
 
-    pCmdbuf   = &session_ctx->apdu_buffer[0];
+    pCmdbuf   = SE05X_APDU_CMD_BUF(session_ctx);
     pRspbuf   = &session_ctx->apdu_buffer[0];
     rspbufLen = sizeof(session_ctx->apdu_buffer);
 
@@ -752,7 +1344,7 @@ smStatus_t Se05x_API_CreateSession(
     if (0 != tlvRet) {
         goto cleanup;
     }
-    retStatus = DoAPDUTxRx(session_ctx, &hdr, &session_ctx->apdu_buffer[0], cmdbufLen, pRspbuf, &rspbufLen, 0);
+    retStatus = DoAPDUTxRx(session_ctx, &hdr, SE05X_APDU_CMD_BUF(session_ctx), cmdbufLen, pRspbuf, &rspbufLen, 0);
     if (retStatus == SM_OK) {
         retStatus       = SM_NOT_OK;
         size_t rspIndex = 0;
@@ -779,7 +1371,7 @@ smStatus_t Se05x_API_ReadIDList(pSe05xSession_t session_ctx,
     smStatus_t retStatus = SM_NOT_OK;
     tlvHeader_t hdr      = {{kSE05x_CLA, kSE05x_INS_READ, kSE05x_P1_DEFAULT, kSE05x_P2_LIST}};
     size_t cmdbufLen     = 0;
-    uint8_t *pCmdbuf     = &session_ctx->apdu_buffer[0];
+    uint8_t *pCmdbuf     = SE05X_APDU_CMD_BUF(session_ctx);
     int tlvRet           = 0;
     uint8_t *pRspbuf     = NULL;
     size_t rspIndex      = 0;
@@ -789,7 +1381,7 @@ smStatus_t Se05x_API_ReadIDList(pSe05xSession_t session_ctx,
 
     SMLOG_D("APDU - Se05x_API_ReadIDList [] \n");
 
-    pCmdbuf   = &session_ctx->apdu_buffer[0];
+    pCmdbuf   = SE05X_APDU_CMD_BUF(session_ctx);
     pRspbuf   = &session_ctx->apdu_buffer[0];
     rspbufLen = sizeof(session_ctx->apdu_buffer);
 
@@ -801,7 +1393,7 @@ smStatus_t Se05x_API_ReadIDList(pSe05xSession_t session_ctx,
     if (0 != tlvRet) {
         goto cleanup;
     }
-    retStatus = DoAPDUTxRx(session_ctx, &hdr, &session_ctx->apdu_buffer[0], cmdbufLen, pRspbuf, &rspbufLen, 0);
+    retStatus = DoAPDUTxRx(session_ctx, &hdr, SE05X_APDU_CMD_BUF(session_ctx), cmdbufLen, pRspbuf, &rspbufLen, 0);
     if (retStatus == SM_OK) {
         retStatus = SM_NOT_OK;
         tlvRet    = tlvGet_U8(pRspbuf, &rspIndex, rspbufLen, kSE05x_TAG_1, pmore); /* - */
@@ -831,7 +1423,7 @@ smStatus_t Se05x_API_ReadSize(pSe05xSession_t session_ctx, uint32_t objectID, ui
     smStatus_t retStatus = SM_NOT_OK;
     tlvHeader_t hdr      = {{kSE05x_CLA, kSE05x_INS_READ, kSE05x_P1_DEFAULT, kSE05x_P2_SIZE}};
     size_t cmdbufLen     = 0;
-    uint8_t *pCmdbuf     = &session_ctx->apdu_buffer[0];
+    uint8_t *pCmdbuf     = SE05X_APDU_CMD_BUF(session_ctx);
     int tlvRet           = 0;
     uint8_t *pRspbuf     = NULL;
     size_t rspIndex      = 0;
@@ -839,7 +1431,7 @@ smStatus_t Se05x_API_ReadSize(pSe05xSession_t session_ctx, uint32_t objectID, ui
 
     SMLOG_D("APDU - Se05x_API_ReadSize [] \n");
 
-    pCmdbuf   = &session_ctx->apdu_buffer[0];
+    pCmdbuf   = SE05X_APDU_CMD_BUF(session_ctx);
     pRspbuf   = &session_ctx->apdu_buffer[0];
     rspbufLen = sizeof(session_ctx->apdu_buffer);
 
@@ -847,7 +1439,7 @@ smStatus_t Se05x_API_ReadSize(pSe05xSession_t session_ctx, uint32_t objectID, ui
     if (0 != tlvRet) {
         goto cleanup;
     }
-    retStatus = DoAPDUTxRx(session_ctx, &hdr, &session_ctx->apdu_buffer[0], cmdbufLen, pRspbuf, &rspbufLen, 0);
+    retStatus = DoAPDUTxRx(session_ctx, &hdr, SE05X_APDU_CMD_BUF(session_ctx), cmdbufLen, pRspbuf, &rspbufLen, 0);
     if (retStatus == SM_OK) {
         retStatus = SM_NOT_OK;
         tlvRet    = tlvGet_U16(pRspbuf, &rspIndex, rspbufLen, kSE05x_TAG_1, psize); /* - */
@@ -873,7 +1465,7 @@ smStatus_t Se05x_API_ReadType(pSe05xSession_t session_ctx,
     tlvHeader_t hdr  = {{kSE05x_CLA, (uint8_t)kSE05x_INS_READ | attestation_type, kSE05x_P1_DEFAULT, kSE05x_P2_TYPE}};
     uint8_t uType    = 0;
     size_t cmdbufLen = 0;
-    uint8_t *pCmdbuf = &session_ctx->apdu_buffer[0];
+    uint8_t *pCmdbuf = SE05X_APDU_CMD_BUF(session_ctx);
     int tlvRet       = 0;
     uint8_t *pRspbuf = NULL;
     size_t rspIndex  = 0;
@@ -881,7 +1473,7 @@ smStatus_t Se05x_API_ReadType(pSe05xSession_t session_ctx,
 
     SMLOG_D("APDU - Se05x_API_ReadType [] \n");
 
-    pCmdbuf   = &session_ctx->apdu_buffer[0];
+    pCmdbuf   = SE05X_APDU_CMD_BUF(session_ctx);
     pRspbuf   = &session_ctx->apdu_buffer[0];
     rspbufLen = sizeof(session_ctx->apdu_buffer);
 
@@ -889,7 +1481,7 @@ smStatus_t Se05x_API_ReadType(pSe05xSession_t session_ctx,
     if (0 != tlvRet) {
         goto cleanup;
     }
-    retStatus = DoAPDUTxRx(session_ctx, &hdr, &session_ctx->apdu_buffer[0], cmdbufLen, pRspbuf, &rspbufLen, 0);
+    retStatus = DoAPDUTxRx(session_ctx, &hdr, SE05X_APDU_CMD_BUF(session_ctx), cmdbufLen, pRspbuf, &rspbufLen, 0);
     if (retStatus == SM_OK) {
         retStatus = SM_NOT_OK;
         if (ptype != NULL) {
@@ -924,13 +1516,13 @@ smStatus_t Se05x_API_CreateECCurve(pSe05xSession_t session_ctx, SE05x_ECCurve_t
 
     SMLOG_D("APDU - Se05x_API_CreateECCurve [] \n");
 
-    pCmdbuf = &session_ctx->apdu_buffer[0];
+    pCmdbuf = SE05X_APDU_CMD_BUF(session_ctx);
 
     tlvRet = TLVSET_ECCurve("curve id", &pCmdbuf, &cmdbufLen, kSE05x_TAG_1, curveID);
     if (0 != tlvRet) {
         goto cleanup;
     }
-    retStatus = DoAPDUTx(session_ctx, &hdr, session_ctx->apdu_buffer, cmdbufLen, 0);
+    retStatus = DoAPDUTx(session_ctx, &hdr, SE05X_APDU_CMD_BUF(session_ctx), cmdbufLen, 0);
 
 cleanup:
     return retStatus;
@@ -948,13 +1540,13 @@ smStatus_t Se05x_API_DeleteECCurve(pSe05xSession_t session_ctx, SE05x_ECCurve_t
 
     SMLOG_D("APDU - Se05x_API_DeleteECCurve [] \n");
 
-    pCmdbuf = &session_ctx->apdu_buffer[0];
+    pCmdbuf = SE05X_APDU_CMD_BUF(session_ctx);
 
     tlvRet = TLVSET_ECCurve("curve id", &pCmdbuf, &cmdbufLen, kSE05x_TAG_1, curveID);
     if (0 != tlvRet) {
         goto cleanup;
     }
-    retStatus = DoAPDUTx(session_ctx, &hdr, session_ctx->apdu_buffer, cmdbufLen, 0);
+    retStatus = DoAPDUTx(session_ctx, &hdr, SE05X_APDU_CMD_BUF(session_ctx), cmdbufLen, 0);
 
 cleanup:
     return retStatus;
@@ -975,7 +1567,7 @@ smStatus_t Se05x_API_SetECCurveParam(pSe05xSession_t session_ctx,
 
     SMLOG_D("APDU - Se05x_API_SetECCurveParam [] \n");
 
-    pCmdbuf = &session_ctx->apdu_buffer[0];
+    pCmdbuf = SE05X_APDU_CMD_BUF(session_ctx);
 
     tlvRet = TLVSET_ECCurve("curve id", &pCmdbuf, &cmdbufLen, kSE05x_TAG_1, curveID);
     if (0 != tlvRet) {
@@ -989,7 +1581,7 @@ smStatus_t Se05x_API_SetECCurveParam(pSe05xSession_t session_ctx,
     if (0 != tlvRet) {
         goto cleanup;
     }
-    retStatus = DoAPDUTx(session_ctx, &hdr, session_ctx->apdu_buffer, cmdbufLen, 0);
+    retStatus = DoAPDUTx(session_ctx, &hdr, SE05X_APDU_CMD_BUF(session_ctx), cmdbufLen, 0);
 
 cleanup:
     return retStatus;
@@ -1011,7 +1603,7 @@ smStatus_t Se05x_API_ReadECCurveList(pSe05xSession_t session_ctx, uint8_t *curve
 
     SMLOG_D("APDU - Se05x_API_ReadECCurveList [] \n");
 
-    retStatus = DoAPDUTxRx(session_ctx, &hdr, session_ctx->apdu_buffer, cmdbufLen, pRspbuf, &rspbufLen, 0);
+    retStatus = DoAPDUTxRx(session_ctx, &hdr, SE05X_APDU_CMD_BUF(session_ctx), cmdbufLen, pRspbuf, &rspbufLen, 0);
     if (retStatus == SM_OK) {
         retStatus       = SM_NOT_OK;
         size_t rspIndex = 0;
@@ -11,6 +11,7 @@
 #include "sm_port.h"
 #include "se05x_types.h"
 #include "se05x_scp03.h"
+#include "sm_timer.h"
 #include <limits.h>
 
 /* ********************** Function ********************** */
@@ -295,61 +296,83 @@ cleanup:
     return retVal;
 }
 
-int tlvGet_u8buf(uint8_t *buf, size_t *pBufIndex, const size_t bufLen, SE05x_TAG_t tag, uint8_t *rsp, size_t *pRspLen)
+int tlvGet_u8bufView(
+    uint8_t *buf, size_t *pBufIndex, const size_t bufLen, SE05x_TAG_t tag, size_t *pValueOffset, size_t *pValueLen)
 {
     int retVal      = 1;
-    uint8_t *pBuf   = buf + (*pBufIndex);
-    uint8_t got_tag = *pBuf++;
+    size_t index    = 0;
+    uint8_t got_tag = 0;
     size_t extendedLen;
     size_t rspLen;
-    //size_t len;
 
-    if (rsp == NULL) {
+    if ((buf == NULL) || (pBufIndex == NULL) || (pValueOffset == NULL) || (pValueLen == NULL)) {
         goto cleanup;
     }
 
-    if (pRspLen == NULL) {
-        goto cleanup;
-    }
-
-    if ((*pBufIndex) > bufLen) {
+    index = *pBufIndex;
+    if ((index >= bufLen) || ((bufLen - index) < 2)) {
         goto cleanup;
     }
 
+    got_tag = buf[index++];
     if (got_tag != tag) {
         goto cleanup;
     }
-    rspLen = *pBuf++;
+    rspLen = buf[index++];
 
     if (rspLen <= 0x7FU) {
         extendedLen = rspLen;
-        *pBufIndex += (1 + 1);
     }
-    else if (rspLen == 0x81) {
-        extendedLen = *pBuf++;
-        *pBufIndex += (1 + 1 + 1);
+    else if ((rspLen == 0x81) && (index < bufLen)) {
+        extendedLen = buf[index++];
     }
-    else if (rspLen == 0x82) {
-        extendedLen = *pBuf++;
-        extendedLen = (extendedLen << 8) | *pBuf++;
-        *pBufIndex += (1 + 1 + 2);
+    else if ((rspLen == 0x82) && ((bufLen - index) >= 2)) {
+        extendedLen = buf[index++];
+        extendedLen = (extendedLen << 8) | buf[index++];
     }
     else {
         goto cleanup;
     }
 
-    if (extendedLen > *pRspLen) {
+    if (extendedLen > (bufLen - index)) {
         goto cleanup;
     }
-    if (extendedLen > bufLen) {
+
+    *pValueOffset = index;
+    *pValueLen    = extendedLen;
+    *pBufIndex    = index + extendedLen;
+    retVal        = 0;
+cleanup:
+    return retVal;
+}
+
+int tlvGet_u8buf(uint8_t *buf, size_t *pBufIndex, const size_t bufLen, SE05x_TAG_t tag, uint8_t *rsp, size_t *pRspLen)
+{
+    int retVal         = 1;
+    size_t valueOffset = 0;
+    size_t valueLen    = 0;
+    size_t index       = 0;
+
+    if (rsp == NULL) {
         goto cleanup;
     }
 
-    *pRspLen = extendedLen;
-    *pBufIndex += extendedLen;
-    while (extendedLen-- > 0) {
-        *rsp++ = *pBuf++;
+    if ((pRspLen == NULL) || (pBufIndex == NULL)) {
+        goto cleanup;
+    }
+
+    index = *pBufIndex;
+    if (0 != tlvGet_u8bufView(buf, &index, bufLen, tag, &valueOffset, &valueLen)) {
+        goto cleanup;
     }
+
+    if (valueLen > *pRspLen) {
+        goto cleanup;
+    }
+
+    *pRspLen   = valueLen;
+    *pBufIndex = index;
+    memmove(rsp, &buf[valueOffset], valueLen);
     retVal = 0;
 cleanup:
     if (retVal != 0) {
@@ -360,6 +383,74 @@ cleanup:
     return retVal;
 }
 
+/**
+* Parses all TLVs of buf in one pass, without copying the values.
+* Fails if buf does not consist of complete TLVs or holds more than TLV_VIEWS_MAX.
+*/
+int tlvGet_Views(const uint8_t *buf, const size_t bufLen, tlvViews_t *pViews)
+{
+    int retVal   = 1;
+    size_t index = 0;
+    size_t valueLen;
+
+    if ((buf == NULL) || (pViews == NULL)) {
+        goto cleanup;
+    }
+    pViews->count = 0;
+
+    while (index < bufLen) {
+        if (((bufLen - index) < 2) || (pViews->count >= TLV_VIEWS_MAX)) {
+            goto cleanup;
+        }
+        pViews->view[pViews->count].tag = buf[index++];
+        valueLen                        = buf[index++];
+        if (valueLen == 0x81) {
+            if (index >= bufLen) {
+                goto cleanup;
+            }
+            valueLen = buf[index++];
+        }
+        else if (valueLen == 0x82) {
+            if ((bufLen - index) < 2) {
+                goto cleanup;
+            }
+            valueLen = ((size_t)buf[index] << 8) | buf[index + 1];
+            index += 2;
+        }
+        else if (valueLen > 0x7FU) {
+            goto cleanup;
+        }
+        if (valueLen > (bufLen - index)) {
+            goto cleanup;
+        }
+        pViews->view[pViews->count].pValue   = &buf[index];
+        pViews->view[pViews->count].valueLen = valueLen;
+        pViews->count++;
+        index += valueLen;
+    }
+    retVal = 0;
+cleanup:
+    if ((retVal != 0) && (pViews != NULL)) {
+        pViews->count = 0;
+    }
+    return retVal;
+}
+
+const tlvView_t *tlvGet_FindView(const tlvViews_t *pViews, SE05x_TAG_t tag)
+{
+    size_t i = 0;
+
+    if (pViews == NULL) {
+        return NULL;
+    }
+    for (i = 0; i < pViews->count; i++) {
+        if (pViews->view[i].tag == tag) {
+            return &pViews->view[i];
+        }
+    }
+    return NULL;
+}
+
 int tlvGet_Result(uint8_t *buf, size_t *pBufIndex, size_t bufLen, SE05x_TAG_t tag, SE05x_Result_t *presult)
 {
     uint8_t uType   = 0;
@@ -369,7 +460,128 @@ int tlvGet_Result(uint8_t *buf, size_t *pBufIndex, size_t bufLen, SE05x_TAG_t ta
     return retVal;
 }
 
-smStatus_t DoAPDUTx(
+/* Sends the (wrapped) APDU of the command hdr, the command identifies the request towards smCom.
+ * timeoutUs bounds the request, 0 for none. */
+static smStatus_t se05x_TransceiveRaw(pSe05xSession_t session_ctx,
+    const tlvHeader_t *hdr,
+    uint8_t *pTx,
+    size_t txLen,
+    uint8_t *pRx,
+    size_t *pRxLen,
+    uint32_t timeoutUs)
+{
+    smComTxInfo_t txInfo;
+    uintptr_t bufStart = (uintptr_t)&session_ctx->apdu_buffer[0];
+    uintptr_t bufEnd   = bufStart + sizeof(session_ctx->apdu_buffer);
+    uintptr_t txStart  = (uintptr_t)pTx;
+
+    txInfo.priority  = smComT1oI2C_GetPriority(hdr->hdr[1]);
+    txInfo.cmdKey    = PH_NXP_ESE_CMD_KEY(hdr->hdr[1], hdr->hdr[2], hdr->hdr[3]);
+    txInfo.headroom  = 0;
+    txInfo.tailroom  = 0;
+    txInfo.timeoutUs = timeoutUs;
+    /* The rest of the session APDU buffer is lent to the transport to frame the APDU in place */
+    if ((txStart >= bufStart) && (txStart <= bufEnd) && (txLen <= (bufEnd - txStart))) {
+        txInfo.headroom = txStart - bufStart;
+        txInfo.tailroom = bufEnd - (txStart + txLen);
+    }
+    return smComT1oI2C_TransceiveRawEx(session_ctx->conn_context, &txInfo, pTx, txLen, pRx, pRxLen);
+}
+
+/* Bytes of the session APDU buffer in front of pBuf, 0 when pBuf is not in the buffer */
+static size_t se05x_Headroom(pSe05xSession_t session_ctx, const uint8_t *pBuf)
+{
+    uintptr_t bufStart = (uintptr_t)&session_ctx->apdu_buffer[0];
+    uintptr_t bufEnd   = bufStart + sizeof(session_ctx->apdu_buffer);
+
+    if (((uintptr_t)pBuf < bufStart) || ((uintptr_t)pBuf > bufEnd)) {
+        return 0;
+    }
+    return (uintptr_t)pBuf - bufStart;
+}
+
+/* Adds the ISO 7816 header, Lc and Le to the command data of a plain APDU. The header is written into
+ * the headroom bytes in front of cmdBuf (see SE05X_APDU_CMD_BUF). Without headroom the data is moved up,
+ * PH_NXP_ESE_TX_HEADROOM bytes further when it fits, so that the transport can frame it without a copy. */
+static smStatus_t se05x_BuildPlainApdu(const tlvHeader_t *hdr,
+    uint8_t *cmdBuf,
+    size_t cmdBufLen,
+    size_t headroom,
+    uint8_t length_extended,
+    uint8_t **ppApdu,
+    size_t *pApduLen)
+{
+    size_t hdrLen  = 4;
+    size_t apduLen = 0;
+    uint8_t *pApdu = NULL;
+
+    if (cmdBufLen > 0) {
+        hdrLen = ((cmdBufLen < 0xFF) && !length_extended) ? 5 : 7;
+    }
+    ENSURE_OR_RETURN_ON_ERROR((MAX_APDU_BUFFER - hdrLen) >= cmdBufLen, SM_NOT_OK);
+    apduLen = cmdBufLen + hdrLen + (length_extended ? 2 : 0);
+    ENSURE_OR_RETURN_ON_ERROR(MAX_APDU_BUFFER >= apduLen, SM_NOT_OK);
+
+    if (headroom >= hdrLen) {
+        pApdu = cmdBuf - hdrLen;
+    }
+    else {
+        pApdu = cmdBuf;
+        if ((MAX_APDU_BUFFER - PH_NXP_ESE_TX_HEADROOM - PH_NXP_ESE_TX_TAILROOM) >= apduLen) {
+            pApdu += PH_NXP_ESE_TX_HEADROOM;
+        }
+        if (cmdBufLen > 0) {
+            memmove((pApdu + hdrLen), cmdBuf, cmdBufLen);
+        }
+    }
+    memcpy(pApdu, hdr, 4);
+    if (hdrLen == 5) {
+        pApdu[4] = (uint8_t)cmdBufLen;
+    }
+    else if (hdrLen == 7) {
+        pApdu[4] = 0x00;
+        pApdu[5] = 0xFFu & (cmdBufLen >> 8);
+        pApdu[6] = 0xFFu & (cmdBufLen);
+    }
+    if (length_extended) {
+        pApdu[hdrLen + cmdBufLen]     = 0x00;
+        pApdu[hdrLen + cmdBufLen + 1] = 0x00;
+    }
+
+    *ppApdu   = pApdu;
+    *pApduLen = apduLen;
+    return SM_OK;
+}
+
+/**
+* Passes one completed exchange to the APDU trace of the session
+*/
+static void se05x_TraceApdu(pSe05xSession_t session_ctx,
+    const tlvHeader_t *hdr,
+    size_t cmdBufLen,
+    size_t rspBufLen,
+    smStatus_t apduStatus,
+    uint8_t flags,
+    uint32_t timeoutUs,
+    uint64_t startNs)
+{
+    Se05xApduTraceRecord_t record = {0};
+    uint64_t endNs                = sm_get_time_ns();
+
+    if (hdr != NULL) {
+        record.hdr = *hdr;
+    }
+    record.flags      = flags;
+    record.status     = (uint16_t)apduStatus;
+    record.cmdLen     = cmdBufLen;
+    record.rspLen     = rspBufLen;
+    record.timeoutUs  = timeoutUs;
+    record.startNs    = startNs;
+    record.durationNs = (endNs >= startNs) ? (endNs - startNs) : 0;
+    session_ctx->pApduTrace->record(session_ctx->pApduTrace->pTraceCtx, &record);
+}
+
+static smStatus_t se05x_DoAPDUTx(
     pSe05xSession_t session_ctx, const tlvHeader_t *hdr, uint8_t *cmdBuf, size_t cmdBufLen, uint8_t length_extended)
 {
     smStatus_t apduStatus = SM_NOT_OK;
@@ -380,6 +592,7 @@ smStatus_t DoAPDUTx(
 #endif
     size_t rxBufLen = MAX_APDU_BUFFER;
     uint8_t *rspBuf = &session_ctx->apdu_buffer[0];
+    uint8_t *pApdu  = NULL;
 #if (defined(WITH_ECKEY_SCP03_SESSION) || defined(WITH_PLATFORM_SCP03))
     size_t org_cmd_len = cmdBufLen;
 #endif
@@ -390,10 +603,17 @@ smStatus_t DoAPDUTx(
 
 #if defined(WITH_PLATFORM_SCP03)
     if (session_ctx->scp03_session) {
-        apduStatus = Se05x_API_SCP03_Encrypt(session_ctx, hdr, cmdBuf, cmdBufLen, length_extended, cmdBuf, &cmdBufLen);
+        apduStatus = Se05x_API_SCP03_EncryptInPlace(session_ctx,
+            hdr,
+            cmdBuf,
+            cmdBufLen,
+            se05x_Headroom(session_ctx, cmdBuf),
+            length_extended,
+            &pApdu,
+            &cmdBufLen);
         ENSURE_OR_GO_EXIT(apduStatus == SM_OK);
 
-        apduStatus = smComT1oI2C_TransceiveRaw(session_ctx->conn_context, cmdBuf, cmdBufLen, cmdBuf, &rxBufLen);
+        apduStatus = se05x_TransceiveRaw(session_ctx, hdr, pApdu, cmdBufLen, cmdBuf, &rxBufLen, 0);
         ENSURE_OR_GO_EXIT(apduStatus == SM_OK);
         ENSURE_OR_RETURN_ON_ERROR((rxBufLen >= SCP_GP_SW_LEN), SM_NOT_OK);
 
@@ -405,10 +625,17 @@ smStatus_t DoAPDUTx(
 
 #if defined(WITH_ECKEY_SCP03_SESSION)
         if (session_ctx->ecKey_session == 0 && session_ctx->scp03_session == 1) {
-        apduStatus = Se05x_API_SCP03_Encrypt(session_ctx, hdr, cmdBuf, cmdBufLen, length_extended, cmdBuf, &cmdBufLen);
+        apduStatus = Se05x_API_SCP03_EncryptInPlace(session_ctx,
+            hdr,
+            cmdBuf,
+            cmdBufLen,
+            se05x_Headroom(session_ctx, cmdBuf),
+            length_extended,
+            &pApdu,
+            &cmdBufLen);
         ENSURE_OR_GO_EXIT(apduStatus == SM_OK);
 
-        apduStatus = smComT1oI2C_TransceiveRaw(session_ctx->conn_context, cmdBuf, cmdBufLen, cmdBuf, &rxBufLen);
+        apduStatus = se05x_TransceiveRaw(session_ctx, hdr, pApdu, cmdBufLen, cmdBuf, &rxBufLen, 0);
         ENSURE_OR_GO_EXIT(apduStatus == SM_OK);
         ENSURE_OR_RETURN_ON_ERROR((rxBufLen >= SCP_GP_SW_LEN), SM_NOT_OK);
 
@@ -418,17 +645,31 @@ smStatus_t DoAPDUTx(
     else if (session_ctx->ecKey_session == 1 && session_ctx->scp03_session == 1) {
         size_t cmd_index = 0;
 
-        apduStatus = Se05x_API_ECKeyAuth_Encrypt(
-            session_ctx, hdr, cmdBuf, cmdBufLen, length_extended, &outHdr, cmdBuf, &cmdBufLen);
+        apduStatus = Se05x_API_ECKeyAuth_EncryptInPlace(session_ctx,
+            hdr,
+            cmdBuf,
+            cmdBufLen,
+            se05x_Headroom(session_ctx, cmdBuf),
+            length_extended,
+            &outHdr,
+            &pApdu,
+            &cmdBufLen);
         ENSURE_OR_GO_EXIT(apduStatus == SM_OK);
 
-        cmd_index = (cmdBuf[4] == 0) ? (7) : (5);
-
-        apduStatus = Se05x_API_SCP03_Encrypt(
-            session_ctx, &outHdr, &cmdBuf[cmd_index], cmdBufLen - cmd_index, length_extended, cmdBuf, &cmdBufLen);
+        /* The SCP03 header replaces the header of the EC key session command */
+        cmd_index = (pApdu[4] == 0) ? (7) : (5);
+
+        apduStatus = Se05x_API_SCP03_EncryptInPlace(session_ctx,
+            &outHdr,
+            &pApdu[cmd_index],
+            cmdBufLen - cmd_index,
+            se05x_Headroom(session_ctx, &pApdu[cmd_index]),
+            length_extended,
+            &pApdu,
+            &cmdBufLen);
         ENSURE_OR_GO_EXIT(apduStatus == SM_OK);
 
-        apduStatus = smComT1oI2C_TransceiveRaw(session_ctx->conn_context, cmdBuf, cmdBufLen, cmdBuf, &rxBufLen);
+        apduStatus = se05x_TransceiveRaw(session_ctx, hdr, pApdu, cmdBufLen, cmdBuf, &rxBufLen, 0);
         ENSURE_OR_GO_EXIT(apduStatus == SM_OK);
         ENSURE_OR_RETURN_ON_ERROR((rxBufLen >= SCP_GP_SW_LEN), SM_NOT_OK);
 
@@ -446,11 +687,18 @@ smStatus_t DoAPDUTx(
 
 #if defined(WITH_ECKEY_SESSION)
         if (session_ctx->ecKey_session == 1) {
-        apduStatus = Se05x_API_ECKeyAuth_Encrypt(
-            session_ctx, hdr, cmdBuf, cmdBufLen, length_extended, &outHdr, cmdBuf, &cmdBufLen);
+        apduStatus = Se05x_API_ECKeyAuth_EncryptInPlace(session_ctx,
+            hdr,
+            cmdBuf,
+            cmdBufLen,
+            se05x_Headroom(session_ctx, cmdBuf),
+            length_extended,
+            &outHdr,
+            &pApdu,
+            &cmdBufLen);
         ENSURE_OR_GO_EXIT(apduStatus == SM_OK);
 
-        apduStatus = smComT1oI2C_TransceiveRaw(session_ctx->conn_context, cmdBuf, cmdBufLen, cmdBuf, &rxBufLen);
+        apduStatus = se05x_TransceiveRaw(session_ctx, hdr, pApdu, cmdBufLen, cmdBuf, &rxBufLen, 0);
         ENSURE_OR_GO_EXIT(apduStatus == SM_OK);
         ENSURE_OR_RETURN_ON_ERROR((rxBufLen >= SCP_GP_SW_LEN), SM_NOT_OK);
 
@@ -460,40 +708,10 @@ smStatus_t DoAPDUTx(
     else
 #endif //#if defined(WITH_ECKEY_SESSION)
     {
-        (void)length_extended;
-        if (cmdBufLen > 0) {
-            if ((cmdBufLen < 0xFF) && !length_extended) {
-                ENSURE_OR_GO_EXIT((MAX_APDU_BUFFER - 5) >= cmdBufLen);
-                memmove((cmdBuf + 5), cmdBuf, cmdBufLen);
-                memcpy(cmdBuf, hdr, 4);
-                cmdBuf[4] = cmdBufLen;
-                ENSURE_OR_GO_EXIT((UINT_MAX - 5) >= cmdBufLen);
-                cmdBufLen += 5;
-            }
-            else {
-                ENSURE_OR_GO_EXIT((MAX_APDU_BUFFER - 7) >= cmdBufLen);
-                memmove((cmdBuf + 7), cmdBuf, cmdBufLen);
-                memcpy(cmdBuf, hdr, 4);
-
-                cmdBuf[4] = 0x00;
-                cmdBuf[5] = 0xFFu & (cmdBufLen >> 8);
-                cmdBuf[6] = 0xFFu & (cmdBufLen);
-
-                ENSURE_OR_GO_EXIT((UINT_MAX - 7) >= cmdBufLen);
-                cmdBufLen += 7;
-            }
-        }
-        else {
-            memcpy(cmdBuf, hdr, 4);
-            cmdBufLen = 4;
-        }
-        if (length_extended) {
-            ENSURE_OR_GO_EXIT((MAX_APDU_BUFFER - 2) >= cmdBufLen);
-            ENSURE_OR_GO_EXIT((UINT_MAX - 2) >= cmdBufLen);
-            cmdBuf[cmdBufLen++] = 0x00;
-            cmdBuf[cmdBufLen++] = 0x00;
-        }
-        apduStatus = smComT1oI2C_TransceiveRaw(session_ctx->conn_context, cmdBuf, cmdBufLen, rspBuf, &rxBufLen);
+        apduStatus = se05x_BuildPlainApdu(
+            hdr, cmdBuf, cmdBufLen, se05x_Headroom(session_ctx, cmdBuf), length_extended, &pApdu, &cmdBufLen);
+        ENSURE_OR_GO_EXIT(apduStatus == SM_OK);
+        apduStatus = se05x_TransceiveRaw(session_ctx, hdr, pApdu, cmdBufLen, rspBuf, &rxBufLen, 0);
         if (rxBufLen >= 2) {
             apduStatus = rspBuf[(rxBufLen)-2] << 8 | rspBuf[(rxBufLen)-1];
         }
@@ -503,6 +721,29 @@ exit:
     return apduStatus;
 }
 
+smStatus_t DoAPDUTx(
+    pSe05xSession_t session_ctx, const tlvHeader_t *hdr, uint8_t *cmdBuf, size_t cmdBufLen, uint8_t length_extended)
+{
+    smStatus_t apduStatus = SM_NOT_OK;
+    uint64_t startNs      = 0;
+
+    if ((session_ctx == NULL) || (session_ctx->pApduTrace == NULL)) {
+        return se05x_DoAPDUTx(session_ctx, hdr, cmdBuf, cmdBufLen, length_extended);
+    }
+
+    startNs    = sm_get_time_ns();
+    apduStatus = se05x_DoAPDUTx(session_ctx, hdr, cmdBuf, cmdBufLen, length_extended);
+    se05x_TraceApdu(session_ctx,
+        hdr,
+        cmdBufLen,
+        0,
+        apduStatus,
+        length_extended ? SE05X_APDU_TRACE_FLAG_EXTENDED : 0,
+        0,
+        startNs);
+    return apduStatus;
+}
+
 smStatus_t DoAPDUTxRx(pSe05xSession_t session_ctx,
     const tlvHeader_t *hdr,
     uint8_t *cmdBuf,
@@ -510,8 +751,21 @@ smStatus_t DoAPDUTxRx(pSe05xSession_t session_ctx,
     uint8_t *rspBuf,
     size_t *pRspBufLen,
     uint8_t length_extended)
+{
+    return DoAPDUTxRxTimeout(session_ctx, hdr, cmdBuf, cmdBufLen, rspBuf, pRspBufLen, length_extended, 0);
+}
+
+static smStatus_t se05x_DoAPDUTxRxTimeout(pSe05xSession_t session_ctx,
+    const tlvHeader_t *hdr,
+    uint8_t *cmdBuf,
+    size_t cmdBufLen,
+    uint8_t *rspBuf,
+    size_t *pRspBufLen,
+    uint8_t length_extended,
+    uint32_t timeoutUs)
 {
     smStatus_t apduStatus = SM_NOT_OK;
+    uint8_t *pApdu        = NULL;
 #if (defined(WITH_ECKEY_SCP03_SESSION) || defined(WITH_ECKEY_SESSION))
     tlvHeader_t outHdr = {
         0,
@@ -534,10 +788,17 @@ smStatus_t DoAPDUTxRx(pSe05xSession_t session_ctx,
 
 #if defined(WITH_PLATFORM_SCP03)
     if (session_ctx->scp03_session) {
-        apduStatus = Se05x_API_SCP03_Encrypt(session_ctx, hdr, cmdBuf, cmdBufLen, length_extended, cmdBuf, &cmdBufLen);
+        apduStatus = Se05x_API_SCP03_EncryptInPlace(session_ctx,
+            hdr,
+            cmdBuf,
+            cmdBufLen,
+            se05x_Headroom(session_ctx, cmdBuf),
+            length_extended,
+            &pApdu,
+            &cmdBufLen);
         ENSURE_OR_GO_EXIT(apduStatus == SM_OK);
 
-        apduStatus = smComT1oI2C_TransceiveRaw(session_ctx->conn_context, cmdBuf, cmdBufLen, cmdBuf, &rxBufLen);
+        apduStatus = se05x_TransceiveRaw(session_ctx, hdr, pApdu, cmdBufLen, cmdBuf, &rxBufLen, timeoutUs);
         ENSURE_OR_GO_EXIT(apduStatus == SM_OK);
         ENSURE_OR_RETURN_ON_ERROR((rxBufLen >= SCP_GP_SW_LEN), SM_NOT_OK);
 
@@ -550,11 +811,17 @@ smStatus_t DoAPDUTxRx(pSe05xSession_t session_ctx,
 #if defined(WITH_ECKEY_SCP03_SESSION)
         /*Only PlatformSCP session is opened*/
         if (session_ctx->ecKey_session == 0 && session_ctx->scp03_session == 1) {
-            apduStatus =
-                Se05x_API_SCP03_Encrypt(session_ctx, hdr, cmdBuf, cmdBufLen, length_extended, cmdBuf, &cmdBufLen);
+            apduStatus = Se05x_API_SCP03_EncryptInPlace(session_ctx,
+                hdr,
+                cmdBuf,
+                cmdBufLen,
+                se05x_Headroom(session_ctx, cmdBuf),
+                length_extended,
+                &pApdu,
+                &cmdBufLen);
             ENSURE_OR_GO_EXIT(apduStatus == SM_OK);
 
-            apduStatus = smComT1oI2C_TransceiveRaw(session_ctx->conn_context, cmdBuf, cmdBufLen, cmdBuf, &rxBufLen);
+            apduStatus = se05x_TransceiveRaw(session_ctx, hdr, pApdu, cmdBufLen, cmdBuf, &rxBufLen, timeoutUs);
             ENSURE_OR_GO_EXIT(apduStatus == SM_OK);
             ENSURE_OR_RETURN_ON_ERROR((rxBufLen >= SCP_GP_SW_LEN), SM_NOT_OK);
 
@@ -565,16 +832,31 @@ smStatus_t DoAPDUTxRx(pSe05xSession_t session_ctx,
         else if (session_ctx->ecKey_session == 1 && session_ctx->scp03_session == 1) {
             size_t cmd_index = 0;
 
-            apduStatus = Se05x_API_ECKeyAuth_Encrypt(
-                session_ctx, hdr, cmdBuf, cmdBufLen, length_extended, &outHdr, cmdBuf, &cmdBufLen);
+            apduStatus = Se05x_API_ECKeyAuth_EncryptInPlace(session_ctx,
+                hdr,
+                cmdBuf,
+                cmdBufLen,
+                se05x_Headroom(session_ctx, cmdBuf),
+                length_extended,
+                &outHdr,
+                &pApdu,
+                &cmdBufLen);
             ENSURE_OR_GO_EXIT(apduStatus == SM_OK);
 
-            cmd_index = (cmdBuf[4] == 0) ? (7) : (5);
-
-            apduStatus = Se05x_API_SCP03_Encrypt(
-                session_ctx, &outHdr, &cmdBuf[cmd_index], cmdBufLen - cmd_index, length_extended, cmdBuf, &cmdBufLen);
+            /* The SCP03 header replaces the header of the EC key session command */
+            cmd_index = (pApdu[4] == 0) ? (7) : (5);
+
+            apduStatus = Se05x_API_SCP03_EncryptInPlace(session_ctx,
+                &outHdr,
+                &pApdu[cmd_index],
+                cmdBufLen - cmd_index,
+                se05x_Headroom(session_ctx, &pApdu[cmd_index]),
+                length_extended,
+                &pApdu,
+                &cmdBufLen);
+            ENSURE_OR_GO_EXIT(apduStatus == SM_OK);
 
-            apduStatus = smComT1oI2C_TransceiveRaw(session_ctx->conn_context, cmdBuf, cmdBufLen, cmdBuf, &rxBufLen);
+            apduStatus = se05x_TransceiveRaw(session_ctx, hdr, pApdu, cmdBufLen, cmdBuf, &rxBufLen, timeoutUs);
             ENSURE_OR_RETURN_ON_ERROR((apduStatus == SM_OK), apduStatus);
             ENSURE_OR_RETURN_ON_ERROR((rxBufLen >= SCP_GP_SW_LEN), SM_NOT_OK);
 
@@ -592,11 +874,18 @@ smStatus_t DoAPDUTxRx(pSe05xSession_t session_ctx,
 
 #if defined(WITH_ECKEY_SESSION)
             if (session_ctx->ecKey_session == 1) {
-            apduStatus = Se05x_API_ECKeyAuth_Encrypt(
-                session_ctx, hdr, cmdBuf, cmdBufLen, length_extended, &outHdr, cmdBuf, &cmdBufLen);
+            apduStatus = Se05x_API_ECKeyAuth_EncryptInPlace(session_ctx,
+                hdr,
+                cmdBuf,
+                cmdBufLen,
+                se05x_Headroom(session_ctx, cmdBuf),
+                length_extended,
+                &outHdr,
+                &pApdu,
+                &cmdBufLen);
             ENSURE_OR_GO_EXIT(apduStatus == SM_OK);
 
-            apduStatus = smComT1oI2C_TransceiveRaw(session_ctx->conn_context, cmdBuf, cmdBufLen, cmdBuf, &rxBufLen);
+            apduStatus = se05x_TransceiveRaw(session_ctx, hdr, pApdu, cmdBufLen, cmdBuf, &rxBufLen, timeoutUs);
             ENSURE_OR_GO_EXIT(apduStatus == SM_OK);
             ENSURE_OR_RETURN_ON_ERROR((rxBufLen >= SCP_GP_SW_LEN), SM_NOT_OK);
 
@@ -607,40 +896,11 @@ smStatus_t DoAPDUTxRx(pSe05xSession_t session_ctx,
 #endif //#if defined(WITH_ECKEY_SESSION)
 
         {
-            if (cmdBufLen > 0) {
-                if ((cmdBufLen < 0xFF) && !length_extended) {
-                    ENSURE_OR_GO_EXIT((MAX_APDU_BUFFER - 5) >= cmdBufLen);
-                    memmove((cmdBuf + 5), cmdBuf, cmdBufLen);
-                    memcpy(cmdBuf, hdr, 4);
-                    cmdBuf[4] = cmdBufLen;
-                    ENSURE_OR_GO_EXIT((UINT_MAX - 5) >= cmdBufLen);
-                    cmdBufLen += 5;
-                }
-                else {
-                    ENSURE_OR_GO_EXIT((MAX_APDU_BUFFER - 7) >= cmdBufLen);
-                    memmove((cmdBuf + 7), cmdBuf, cmdBufLen);
-                    memcpy(cmdBuf, hdr, 4);
-
-                    cmdBuf[4] = 0x00;
-                    cmdBuf[5] = 0xFFu & (cmdBufLen >> 8);
-                    cmdBuf[6] = 0xFFu & (cmdBufLen);
-
-                    ENSURE_OR_GO_EXIT((UINT_MAX - 7) >= cmdBufLen);
-                    cmdBufLen += 7;
-                }
-            }
-            else {
-                memcpy(cmdBuf, hdr, 4);
-                cmdBufLen = 4;
-            }
-            if (length_extended) {
-                ENSURE_OR_GO_EXIT((MAX_APDU_BUFFER - 2) >= cmdBufLen);
-                ENSURE_OR_GO_EXIT((UINT_MAX - 2) >= cmdBufLen);
-                cmdBuf[cmdBufLen++] = 0x00;
-                cmdBuf[cmdBufLen++] = 0x00;
-            }
-            apduStatus = smComT1oI2C_TransceiveRaw(session_ctx->conn_context, cmdBuf, cmdBufLen, rspBuf, pRspBufLen);
-            if (*pRspBufLen >= 2) {
+            apduStatus = se05x_BuildPlainApdu(
+                hdr, cmdBuf, cmdBufLen, se05x_Headroom(session_ctx, cmdBuf), length_extended, &pApdu, &cmdBufLen);
+            ENSURE_OR_GO_EXIT(apduStatus == SM_OK);
+            apduStatus = se05x_TransceiveRaw(session_ctx, hdr, pApdu, cmdBufLen, rspBuf, pRspBufLen, timeoutUs);
+            if ((apduStatus == SM_OK) && (*pRspBufLen >= 2)) {
                 apduStatus = rspBuf[(*pRspBufLen) - 2] << 8 | rspBuf[(*pRspBufLen) - 1];
             }
         }
@@ -648,3 +908,40 @@ smStatus_t DoAPDUTxRx(pSe05xSession_t session_ctx,
 exit:
     return apduStatus;
 }
+
+/* As DoAPDUTxRx, the request is given up with SM_ERR_TIMEOUT when no response arrived within timeoutUs
+ * microseconds (0 for no limit). The next request first resynchronises the T=1 link. */
+smStatus_t DoAPDUTxRxTimeout(pSe05xSession_t session_ctx,
+    const tlvHeader_t *hdr,
+    uint8_t *cmdBuf,
+    size_t cmdBufLen,
+    uint8_t *rspBuf,
+    size_t *pRspBufLen,
+    uint8_t length_extended,
+    uint32_t timeoutUs)
+{
+    smStatus_t apduStatus = SM_NOT_OK;
+    uint64_t startNs      = 0;
+    uint8_t flags         = SE05X_APDU_TRACE_FLAG_RSP;
+
+    if ((session_ctx == NULL) || (session_ctx->pApduTrace == NULL)) {
+        return se05x_DoAPDUTxRxTimeout(
+            session_ctx, hdr, cmdBuf, cmdBufLen, rspBuf, pRspBufLen, length_extended, timeoutUs);
+    }
+
+    startNs    = sm_get_time_ns();
+    apduStatus = se05x_DoAPDUTxRxTimeout(
+        session_ctx, hdr, cmdBuf, cmdBufLen, rspBuf, pRspBufLen, length_extended, timeoutUs);
+    if (length_extended) {
+        flags |= SE05X_APDU_TRACE_FLAG_EXTENDED;
+    }
+    se05x_TraceApdu(session_ctx,
+        hdr,
+        cmdBufLen,
+        ((apduStatus == SM_OK) && (pRspBufLen != NULL)) ? *pRspBufLen : 0,
+        apduStatus,
+        flags,
+        timeoutUs,
+        startNs);
+    return apduStatus;
+}
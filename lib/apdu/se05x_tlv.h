@@ -15,12 +15,33 @@
 typedef enum
 {
     SM_NOT_OK                              = 0xFFFF,
+    SM_ERR_TIMEOUT                         = 0xFFFE, /* Time budget of the request exhausted, no response */
     SM_OK                                  = 0x9000,
     SM_ERR_CONDITIONS_OF_USE_NOT_SATISFIED = 0x6985,
     SM_ERR_ACCESS_DENIED_BASED_ON_POLICY   = 0x6986,
     SM_ERR_APDU_THROUGHPUT                 = 0x66A6,
 } smStatus_t;
 
+/* Maximum number of TLVs of a response held by tlvViews_t */
+#define TLV_VIEWS_MAX 4
+
+/* ********************** Data types ********************** */
+
+/* One TLV of a response, the value points into the response buffer */
+typedef struct
+{
+    uint8_t tag;
+    const uint8_t *pValue;
+    size_t valueLen;
+} tlvView_t;
+
+/* The TLVs of a response in the order received */
+typedef struct
+{
+    tlvView_t view[TLV_VIEWS_MAX];
+    size_t count;
+} tlvViews_t;
+
 /* ********************** Function Prototypes ********************** */
 
 int tlvSet_U8(uint8_t **buf, size_t *bufLen, SE05x_TAG_t tag, uint8_t value);
@@ -37,6 +58,10 @@ int tlvSet_header(uint8_t **buf, size_t *bufLen, tlvHeader_t *hdr);
 int tlvGet_U8(uint8_t *buf, size_t *pBufIndex, const size_t bufLen, SE05x_TAG_t tag, uint8_t *pRsp);
 int tlvGet_U16(uint8_t *buf, size_t *pBufIndex, const size_t bufLen, SE05x_TAG_t tag, uint16_t *pRsp);
 int tlvGet_u8buf(uint8_t *buf, size_t *pBufIndex, const size_t bufLen, SE05x_TAG_t tag, uint8_t *rsp, size_t *pRspLen);
+int tlvGet_u8bufView(
+    uint8_t *buf, size_t *pBufIndex, const size_t bufLen, SE05x_TAG_t tag, size_t *pValueOffset, size_t *pValueLen);
+int tlvGet_Views(const uint8_t *buf, const size_t bufLen, tlvViews_t *pViews);
+const tlvView_t *tlvGet_FindView(const tlvViews_t *pViews, SE05x_TAG_t tag);
 int tlvGet_Result(uint8_t *buf, size_t *pBufIndex, size_t bufLen, SE05x_TAG_t tag, SE05x_Result_t *presult);
 smStatus_t DoAPDUTx(
     pSe05xSession_t session_ctx, const tlvHeader_t *hdr, uint8_t *cmdBuf, size_t cmdBufLen, uint8_t hasle);
@@ -47,6 +72,14 @@ smStatus_t DoAPDUTxRx(pSe05xSession_t session_ctx,
     uint8_t *rspBuf,
     size_t *pRspBufLen,
     uint8_t hasle);
+smStatus_t DoAPDUTxRxTimeout(pSe05xSession_t session_ctx,
+    const tlvHeader_t *hdr,
+    uint8_t *cmdBuf,
+    size_t cmdBufLen,
+    uint8_t *rspBuf,
+    size_t *pRspBufLen,
+    uint8_t hasle,
+    uint32_t timeoutUs);
 
 /* ********************** Defines ********************** */
 
@@ -31,6 +31,18 @@
 #define MAX_APDU_BUFFER 512
 #endif
 
+/**
+* Bytes reserved in front of the command data in the APDU buffer.
+* The APDU header, the secure messaging wrapping and the T=1 frame header are
+* written there in front of the command data, so that no data has to be moved.
+* Worst case is the EC key session wrapping (28) with the SCP03 Lc growing by
+* 2 on top of it and the T=1 header (4).
+*/
+#define SE05X_APDU_HEADROOM (28 + 2 + 4)
+
+/** Start of the command data in the APDU buffer of the session */
+#define SE05X_APDU_CMD_BUF(SESSION_CTX) (&(SESSION_CTX)->apdu_buffer[SE05X_APDU_HEADROOM])
+
 /** NXP reserved object id */
 #define SE05X_OBJID_SE05X_APPLET_RES_START 0x7FFF0000u
 #define SE05X_OBJID_SE05X_APPLET_RES_MASK(X) (0xFFFF0000u & (X))
@@ -102,6 +114,62 @@ typedef struct
     ];
 } tlvHeader_t;
 
+/** Flags of an APDU trace record */
+/** DoAPDUTxRx, the response data is returned to the caller */
+#define SE05X_APDU_TRACE_FLAG_RSP 0x01
+/** Command sent with extended length */
+#define SE05X_APDU_TRACE_FLAG_EXTENDED 0x02
+
+/** APDU exchanged with DoAPDUTx / DoAPDUTxRx, passed to the APDU trace */
+typedef struct
+{
+    /** ISO 7816 APDU header, as given by the caller */
+    tlvHeader_t hdr;
+    /** SE05X_APDU_TRACE_FLAG_* */
+    uint8_t flags;
+    /** Returned status (smStatus_t) */
+    uint16_t status;
+    /** Length of the plain command data, before secure messaging */
+    size_t cmdLen;
+    /** Length of the plain response incl. status word. 0 for DoAPDUTx and failed exchanges */
+    size_t rspLen;
+    /** Response timeout in microseconds, 0 for no limit */
+    uint32_t timeoutUs;
+    /** Start of the exchange, sm_get_time_ns */
+    uint64_t startNs;
+    /** Duration of the exchange incl. secure messaging in ns */
+    uint64_t durationNs;
+} Se05xApduTraceRecord_t;
+
+/** APDU trace, records every exchange of a session (e.g. sm_apdu_trace_open on Linux) */
+typedef struct
+{
+    /** Called after each exchange in the context of the caller, should not block */
+    void (*record)(void *pTraceCtx, const Se05xApduTraceRecord_t *pRecord);
+    /** Context passed to record */
+    void *pTraceCtx;
+} Se05xApduTrace_t;
+
+/** I/O settings of the connection to the SE, see smComT1oI2C_InitEx
+ *
+ * cpu and fifoPriority apply to the thread opening the session, its previous
+ * affinity and policy are restored when the session is closed from it or the
+ * open fails.
+ *
+ * busyPoll with fifoPriority spins at real-time priority until the SE answers.
+ * If the answering side shares the CPU, e.g. se05x_sim_server on a single CPU
+ * or on the pinned cpu, it never runs and the exchange livelocks until its
+ * timeout. Pin to a CPU the peer does not use, or leave fifoPriority 0 there. */
+typedef struct
+{
+    /** Set 1 to spin instead of sleeping while waiting for the SE. Lowest latency, occupies a CPU */
+    uint8_t busyPoll;
+    /** CPU the thread opening the session is pinned to, -1 to keep its affinity */
+    int cpu;
+    /** SCHED_FIFO priority of the thread opening the session, 0 to keep its policy */
+    int fifoPriority;
+} Se05xIoConfig_t;
+
 /** Se05x session context */
 typedef struct
 {
@@ -111,8 +179,8 @@ typedef struct
     uint8_t skip_applet_select;
     /** Applet Version*/
     uint32_t applet_version;
-    /** Apdu buffer used for Tx/Rx */
-    uint8_t apdu_buffer[MAX_APDU_BUFFER];
+    /** Apdu buffer used for Tx/Rx. Commands are built from SE05X_APDU_CMD_BUF on */
+    uint8_t apdu_buffer[SE05X_APDU_HEADROOM + MAX_APDU_BUFFER];
     /** PlatformSCP03 ENC key. Set to NULL in case of plain session */
     uint8_t *pScp03_enc_key;
     /** PlatformSCP03 ENC key length. Set to 0 in case of plain session */
@@ -151,6 +219,13 @@ typedef struct
     uint8_t eckey_mcv[16];
     uint8_t eckey_applet_session_value[8];
 
+    /** Connection string selecting the transport to the SE, e.g. "/dev/i2c-1:0x48",
+     * "unix:/tmp/se05x.sock" or "loop:". NULL for the default I2C bus */
+    const char *pConnString;
+    /** APDU trace of the session, set before Se05x_API_SessionOpen. NULL for no trace */
+    const Se05xApduTrace_t *pApduTrace;
+    /** I/O settings of the connection, set before Se05x_API_SessionOpen. NULL for the defaults */
+    const Se05xIoConfig_t *pIoConfig;
 } Se05xSession_t;
 
 typedef Se05xSession_t *pSe05xSession_t;
@@ -162,6 +237,33 @@ typedef struct
 } Se05xPolicy_t;
 typedef Se05xPolicy_t *pSe05xPolicy_t;
 
+/** Maximum length of the invariant TLVs of a prepared command */
+#define SE05X_PREPARED_CMD_PREFIX_MAX 16
+
+/** Command encoded once for repeated use with the same key, e.g. Se05x_API_PrepareECDSASign.
+ * Only the variable TLVs (input data, IV) are encoded per call. */
+typedef struct
+{
+    /** Session the command is sent on */
+    pSe05xSession_t session_ctx;
+    /** ISO 7816 APDU header */
+    tlvHeader_t hdr;
+    /** Encoded invariant TLVs (object id, algorithm) */
+    uint8_t prefix[SE05X_PREPARED_CMD_PREFIX_MAX];
+    /** Length of prefix */
+    size_t prefixLen;
+} Se05xPreparedCmd_t;
+
+/** Progress of Se05x_API_WriteBinaryChunked. Zero it for a new object and keep
+ * it to resume an interrupted write. */
+typedef struct
+{
+    /** Bytes written so far, the write resumes from here */
+    size_t written;
+    /** Set 1 once the object exists, the remaining chunks are offset writes */
+    uint8_t isCreated;
+} Se05xWriteProgress_t;
+
 /** Values for P1 in ISO7816 APDU */
 typedef enum
 {
@@ -16,41 +16,234 @@
 #include "phEseStatus.h"
 #include "smCom.h"
 #include "sm_port.h"
+#include "sm_timer.h"
+#if defined(SM_HAVE_THREAD_SCHED)
+#include "sm_thread.h"
+#endif
 #include <limits.h>
+#include <string.h>
+
+/* ********************** Types ********************** */
+
+/* Per connection context of the smCom layer, handed out as conn_ctx */
+typedef struct
+{
+    void *pEseCtx;       /* T=1oI2C connection context */
+    bool isDynamicCtx;   /* Context is heap allocated by smComT1oI2C_Init */
+    bool inUse;          /* Context is claimed by a connection, from open to close */
+    bool busy;           /* An APDU is currently being exchanged */
+    SM_MUTEX_TYPE queueLock;
+    SM_COND_TYPE queueCond;
+    uint32_t nextTicket[kSmCom_Priority_Max]; /* Ticket handed to the next request of a class */
+    uint32_t headTicket[kSmCom_Priority_Max]; /* Ticket of the oldest pending request of a class */
+    smComQueueStats_t stats;
+#if defined(SM_HAVE_THREAD_SCHED)
+    sm_thread_saved_t *pIoThreadSaved; /* Scheduling of the I/O thread before the connection, restored at close */
+#endif
+} smComT1oI2C_Ctx_t;
 
 /* ********************** Global vaiables ********************** */
-SM_MUTEX_DEFINE(g_sm_mutex);
+/* Context of the first connection, further connections are heap allocated */
+static smComT1oI2C_Ctx_t gsmcom_ctx;
+/* Guards the claim and release of gsmcom_ctx */
+SM_MUTEX_DEFINE(gsmcom_ctx_lock);
 
 /* ********************** Functions ********************** */
 
+static void *smComT1oI2C_GetEseCtx(void *conn_ctx)
+{
+    return (conn_ctx == NULL) ? NULL : ((smComT1oI2C_Ctx_t *)conn_ctx)->pEseCtx;
+}
+
+/* Claims gsmcom_ctx if it is free, else allocates a context. The claim is made
+ * before the connection is opened, so concurrent opens never share a context */
+static smStatus_t smComT1oI2C_ClaimCtx(smComT1oI2C_Ctx_t **ppCtx)
+{
+    smComT1oI2C_Ctx_t *pCtx = NULL;
+
+    SM_MUTEX_LOCK(gsmcom_ctx_lock);
+    if (!gsmcom_ctx.inUse) {
+        pCtx = &gsmcom_ctx;
+        memset(pCtx, 0, sizeof(*pCtx));
+        pCtx->inUse = true;
+    }
+    SM_MUTEX_UNLOCK(gsmcom_ctx_lock);
+
+    if (pCtx == NULL) {
+        pCtx = (smComT1oI2C_Ctx_t *)sm_malloc(sizeof(smComT1oI2C_Ctx_t));
+        ENSURE_OR_RETURN_ON_ERROR((pCtx != NULL), SM_NOT_OK);
+        memset(pCtx, 0, sizeof(*pCtx));
+        pCtx->isDynamicCtx = true;
+        pCtx->inUse        = true;
+    }
+    *ppCtx = pCtx;
+    return SM_OK;
+}
+
+static smStatus_t smComT1oI2C_ReleaseCtx(smComT1oI2C_Ctx_t *pCtx)
+{
+#if defined(SM_HAVE_THREAD_SCHED)
+    sm_thread_restore_sched(pCtx->pIoThreadSaved);
+    pCtx->pIoThreadSaved = NULL;
+#endif
+    if (pCtx->isDynamicCtx) {
+        sm_free(pCtx);
+    }
+    else {
+        SM_MUTEX_LOCK(gsmcom_ctx_lock);
+        memset(pCtx, 0, sizeof(*pCtx));
+        SM_MUTEX_UNLOCK(gsmcom_ctx_lock);
+    }
+    return SM_OK;
+}
+
+/* Request information derived from the header of a raw APDU.
+ * The APDU header is not encrypted with SCP03, so this works for secure sessions as well */
+static void smComT1oI2C_GetTxInfo(const uint8_t *pTx, size_t txLen, smComTxInfo_t *pTxInfo)
+{
+    pTxInfo->priority  = kSmCom_Priority_Normal;
+    pTxInfo->cmdKey    = PH_NXP_ESE_CMD_KEY_NONE;
+    pTxInfo->headroom  = 0;
+    pTxInfo->tailroom  = 0;
+    pTxInfo->timeoutUs = 0;
+    if ((pTx == NULL) || (txLen < 4)) {
+        return;
+    }
+    pTxInfo->priority = smComT1oI2C_GetPriority(pTx[1]);
+    pTxInfo->cmdKey   = PH_NXP_ESE_CMD_KEY(pTx[1], pTx[2], pTx[3]);
+}
+
+static bool smComT1oI2C_IsQueueTurn(smComT1oI2C_Ctx_t *pCtx, smComPriority_t priority, uint32_t ticket)
+{
+    int i;
+
+    if (pCtx->busy || (pCtx->headTicket[priority] != ticket)) {
+        return false;
+    }
+    for (i = 0; i < (int)priority; i++) {
+        if (pCtx->nextTicket[i] != pCtx->headTicket[i]) {
+            /* A request of a higher class is pending */
+            return false;
+        }
+    }
+    return true;
+}
+
+static smStatus_t smComT1oI2C_QueueEnter(smComT1oI2C_Ctx_t *pCtx, smComPriority_t priority)
+{
+    uint32_t ticket;
+    uint64_t waitUs;
+    uint64_t startUs = sm_get_time_us();
+
+    SM_MUTEX_LOCK(pCtx->queueLock);
+
+    ticket = pCtx->nextTicket[priority]++;
+    pCtx->stats.depth++;
+    if (pCtx->stats.depth > pCtx->stats.maxDepth) {
+        pCtx->stats.maxDepth = pCtx->stats.depth;
+    }
+
+    while (!smComT1oI2C_IsQueueTurn(pCtx, priority, ticket)) {
+        SM_COND_WAIT(pCtx->queueCond, pCtx->queueLock);
+    }
+    pCtx->headTicket[priority]++;
+    pCtx->busy = true;
+
+    waitUs = sm_get_time_us() - startUs;
+    pCtx->stats.requests[priority]++;
+    pCtx->stats.totalWaitUs[priority] += waitUs;
+    if (waitUs > pCtx->stats.maxWaitUs[priority]) {
+        pCtx->stats.maxWaitUs[priority] = waitUs;
+    }
+
+    SM_MUTEX_UNLOCK(pCtx->queueLock);
+    return SM_OK;
+}
+
+static smStatus_t smComT1oI2C_QueueLeave(smComT1oI2C_Ctx_t *pCtx)
+{
+    SM_MUTEX_LOCK(pCtx->queueLock);
+    pCtx->busy = false;
+    pCtx->stats.depth--;
+    SM_COND_BROADCAST(pCtx->queueCond);
+    SM_MUTEX_UNLOCK(pCtx->queueLock);
+    return SM_OK;
+}
+
 smStatus_t smComT1oI2C_Close(void *conn_ctx, uint8_t mode)
 {
     ESESTATUS status;
+    smComT1oI2C_Ctx_t *pCtx = (smComT1oI2C_Ctx_t *)conn_ctx;
     (void)mode;
 
-    ENSURE_OR_RETURN_ON_ERROR((conn_ctx != NULL), SM_NOT_OK);
+    ENSURE_OR_RETURN_ON_ERROR((pCtx != NULL), SM_NOT_OK);
 
-    status = phNxpEse_EndOfApdu(conn_ctx);
+    status = phNxpEse_EndOfApdu(pCtx->pEseCtx);
     ENSURE_OR_RETURN_ON_ERROR((status == ESESTATUS_SUCCESS), SM_NOT_OK);
 
-    status = phNxpEse_close(conn_ctx);
+    status = phNxpEse_close(pCtx->pEseCtx);
     ENSURE_OR_RETURN_ON_ERROR((status == ESESTATUS_SUCCESS), SM_NOT_OK);
 
-    SM_MUTEX_DEINIT(g_sm_mutex);
+    SM_COND_DEINIT(pCtx->queueCond);
+    SM_MUTEX_DEINIT(pCtx->queueLock);
 
-    return SM_OK;
+    return smComT1oI2C_ReleaseCtx(pCtx);
 }
 
 smStatus_t smComT1oI2C_Init(void **conn_ctx, const char *pConnString)
+{
+    return smComT1oI2C_InitEx(conn_ctx, pConnString, NULL);
+}
+
+/* Applies the scheduling of pIoConfig to the calling thread, which does the I/O
+ * of the connection: the exchanges run in the thread calling the smCom APIs.
+ * The previous scheduling is kept in pCtx and restored when it is released */
+static smStatus_t smComT1oI2C_SetIoThread(smComT1oI2C_Ctx_t *pCtx, const Se05xIoConfig_t *pIoConfig)
+{
+    if ((pIoConfig->cpu < 0) && (pIoConfig->fifoPriority == 0)) {
+        return SM_OK;
+    }
+#if defined(SM_HAVE_THREAD_SCHED)
+    ENSURE_OR_RETURN_ON_ERROR(
+        sm_thread_set_sched(pIoConfig->cpu, pIoConfig->fifoPriority, &pCtx->pIoThreadSaved) == 0, SM_NOT_OK);
+    return SM_OK;
+#else
+    (void)pCtx;
+    SMLOG_E("CPU affinity and SCHED_FIFO are not supported on this platform \n");
+    return SM_NOT_OK;
+#endif
+}
+
+smStatus_t smComT1oI2C_InitEx(void **conn_ctx, const char *pConnString, const Se05xIoConfig_t *pIoConfig)
 {
     ESESTATUS status;
+    smComT1oI2C_Ctx_t *pCtx = NULL;
     phNxpEse_initParams initParams;
+
+    memset(&initParams, 0, sizeof(initParams));
     initParams.initMode = ESE_MODE_NORMAL;
+    initParams.pollMode = ESE_POLL_SLEEP;
 
-    status = phNxpEse_open(conn_ctx, initParams, pConnString);
-    ENSURE_OR_RETURN_ON_ERROR((status == ESESTATUS_SUCCESS), SM_NOT_OK);
+    ENSURE_OR_RETURN_ON_ERROR((conn_ctx != NULL), SM_NOT_OK);
+    ENSURE_OR_RETURN_ON_ERROR((smComT1oI2C_ClaimCtx(&pCtx) == SM_OK), SM_NOT_OK);
 
-    SM_MUTEX_INIT(g_sm_mutex);
+    if (pIoConfig != NULL) {
+        if (smComT1oI2C_SetIoThread(pCtx, pIoConfig) != SM_OK) {
+            smComT1oI2C_ReleaseCtx(pCtx);
+            return SM_NOT_OK;
+        }
+        initParams.pollMode = (pIoConfig->busyPoll) ? ESE_POLL_BUSY : ESE_POLL_SLEEP;
+    }
+
+    status = phNxpEse_open(&pCtx->pEseCtx, initParams, pConnString);
+    if (status != ESESTATUS_SUCCESS) {
+        smComT1oI2C_ReleaseCtx(pCtx);
+        return SM_NOT_OK;
+    }
+
+    SM_MUTEX_INIT(pCtx->queueLock);
+    SM_COND_INIT(pCtx->queueCond);
+    *conn_ctx = pCtx;
 
     return SM_OK;
 }
@@ -60,6 +253,7 @@ smStatus_t smComT1oI2C_Open(void *conn_ctx, uint8_t mode, uint8_t seqCnt, uint8_
     ESESTATUS status;
     phNxpEse_data AtrRsp;
     phNxpEse_initParams initParams;
+    memset(&initParams, 0, sizeof(initParams));
     initParams.initMode = mode;
     AtrRsp.len          = *T1oI2CatrLen;
     AtrRsp.p_data       = T1oI2Catr;
@@ -69,7 +263,7 @@ smStatus_t smComT1oI2C_Open(void *conn_ctx, uint8_t mode, uint8_t seqCnt, uint8_
 
     ENSURE_OR_RETURN_ON_ERROR((conn_ctx != NULL), SM_NOT_OK);
 
-    status = phNxpEse_init(conn_ctx, initParams, &AtrRsp);
+    status = phNxpEse_init(smComT1oI2C_GetEseCtx(conn_ctx), initParams, &AtrRsp);
     ENSURE_OR_RETURN_ON_ERROR((status == ESESTATUS_SUCCESS), SM_NOT_OK);
 
     *T1oI2CatrLen = AtrRsp.len; /*Retrive INF FIELD*/
@@ -78,10 +272,39 @@ smStatus_t smComT1oI2C_Open(void *conn_ctx, uint8_t mode, uint8_t seqCnt, uint8_
 }
 
 smStatus_t smComT1oI2C_TransceiveRaw(void *conn_ctx, uint8_t *pTx, size_t txLen, uint8_t *pRx, size_t *pRxLen)
+{
+    smComTxInfo_t txInfo;
+    smComT1oI2C_GetTxInfo(pTx, txLen, &txInfo);
+    return smComT1oI2C_TransceiveRawEx(conn_ctx, &txInfo, pTx, txLen, pRx, pRxLen);
+}
+
+smStatus_t smComT1oI2C_TransceiveRawPriority(
+    void *conn_ctx, smComPriority_t priority, uint8_t *pTx, size_t txLen, uint8_t *pRx, size_t *pRxLen)
+{
+    smComTxInfo_t txInfo;
+    smComT1oI2C_GetTxInfo(pTx, txLen, &txInfo);
+    txInfo.priority = priority;
+    return smComT1oI2C_TransceiveRawEx(conn_ctx, &txInfo, pTx, txLen, pRx, pRxLen);
+}
+
+smStatus_t smComT1oI2C_TransceiveRawTimeout(
+    void *conn_ctx, uint32_t timeoutUs, uint8_t *pTx, size_t txLen, uint8_t *pRx, size_t *pRxLen)
+{
+    smComTxInfo_t txInfo;
+    smComT1oI2C_GetTxInfo(pTx, txLen, &txInfo);
+    txInfo.timeoutUs = timeoutUs;
+    return smComT1oI2C_TransceiveRawEx(conn_ctx, &txInfo, pTx, txLen, pRx, pRxLen);
+}
+
+smStatus_t smComT1oI2C_TransceiveRawEx(
+    void *conn_ctx, const smComTxInfo_t *pTxInfo, uint8_t *pTx, size_t txLen, uint8_t *pRx, size_t *pRxLen)
 {
     phNxpEse_data pCmdTrans;
     phNxpEse_data pRspTrans = {0};
     ESESTATUS status;
+    smStatus_t retStatus    = SM_NOT_OK;
+    smComT1oI2C_Ctx_t *pCtx = (smComT1oI2C_Ctx_t *)conn_ctx;
+    uint64_t deadlineUs     = 0;
 
     ENSURE_OR_RETURN_ON_ERROR((txLen <= UINT32_MAX), SM_NOT_OK);
     pCmdTrans.len    = txLen;
@@ -91,17 +314,41 @@ smStatus_t smComT1oI2C_TransceiveRaw(void *conn_ctx, uint8_t *pTx, size_t txLen,
     pRspTrans.len    = *pRxLen;
     pRspTrans.p_data = pRx;
 
-    ENSURE_OR_RETURN_ON_ERROR((conn_ctx != NULL), SM_NOT_OK);
+    ENSURE_OR_RETURN_ON_ERROR((pCtx != NULL), SM_NOT_OK);
     ENSURE_OR_RETURN_ON_ERROR((pTx != NULL), SM_NOT_OK);
     ENSURE_OR_RETURN_ON_ERROR((pRx != NULL), SM_NOT_OK);
     ENSURE_OR_RETURN_ON_ERROR((pRxLen != NULL), SM_NOT_OK);
+    ENSURE_OR_RETURN_ON_ERROR((pTxInfo != NULL), SM_NOT_OK);
+    ENSURE_OR_RETURN_ON_ERROR((pTxInfo->priority < kSmCom_Priority_Max), SM_NOT_OK);
 
     SMLOG_MAU8_D("APDU Tx>", pTx, txLen);
 
-    SM_MUTEX_LOCK(g_sm_mutex);
-    status = phNxpEse_Transceive(conn_ctx, &pCmdTrans, &pRspTrans);
-    SM_MUTEX_UNLOCK(g_sm_mutex);
+    /* The time budget starts before queueing */
+    if (pTxInfo->timeoutUs != 0) {
+        deadlineUs = sm_get_time_us() + pTxInfo->timeoutUs;
+    }
+    retStatus = smComT1oI2C_QueueEnter(pCtx, pTxInfo->priority);
+    ENSURE_OR_RETURN_ON_ERROR((retStatus == SM_OK), SM_NOT_OK);
+    if ((deadlineUs != 0) && (sm_get_time_us() >= deadlineUs)) {
+        /* Budget used up in the queue, nothing was sent */
+        status = ESESTATUS_RESPONSE_TIMEOUT;
+    }
+    else {
+        status = phNxpEse_setCmdKey(pCtx->pEseCtx, pTxInfo->cmdKey);
+    }
+    if (status == ESESTATUS_SUCCESS) {
+        status = phNxpEse_setTxRoom(pCtx->pEseCtx, (uint32_t)pTxInfo->headroom, (uint32_t)pTxInfo->tailroom);
+    }
+    if (status == ESESTATUS_SUCCESS) {
+        status = phNxpEse_setDeadline(pCtx->pEseCtx, deadlineUs);
+    }
+    if (status == ESESTATUS_SUCCESS) {
+        status = phNxpEse_Transceive(pCtx->pEseCtx, &pCmdTrans, &pRspTrans);
+    }
+    retStatus = smComT1oI2C_QueueLeave(pCtx);
+    ENSURE_OR_RETURN_ON_ERROR((status != ESESTATUS_RESPONSE_TIMEOUT), SM_ERR_TIMEOUT);
     ENSURE_OR_RETURN_ON_ERROR((status == ESESTATUS_SUCCESS), SM_NOT_OK);
+    ENSURE_OR_RETURN_ON_ERROR((retStatus == SM_OK), SM_NOT_OK);
 
     *pRxLen = pRspTrans.len;
     SMLOG_MAU8_D("APDU Rx<", pRx, pRspTrans.len);
@@ -109,13 +356,129 @@ smStatus_t smComT1oI2C_TransceiveRaw(void *conn_ctx, uint8_t *pTx, size_t txLen,
     return SM_OK;
 }
 
+smComPriority_t smComT1oI2C_GetPriority(uint8_t ins)
+{
+    ins = ins & kSE05x_INS_MASK_INSTRUCTION;
+    if (ins == kSE05x_INS_CRYPTO) {
+        return kSmCom_Priority_High;
+    }
+    else if ((ins == kSE05x_INS_READ) || (ins == kSE05x_INS_WRITE)) {
+        return kSmCom_Priority_Bulk;
+    }
+    return kSmCom_Priority_Normal;
+}
+
 smStatus_t smComT1oI2C_ComReset(void *conn_ctx)
 {
-    ESESTATUS status = ESESTATUS_SUCCESS;
-    status           = phNxpEse_deInit(conn_ctx);
+    ESESTATUS status        = ESESTATUS_SUCCESS;
+    smComT1oI2C_Ctx_t *pCtx = (conn_ctx == NULL) ? &gsmcom_ctx : (smComT1oI2C_Ctx_t *)conn_ctx;
+
+    status = phNxpEse_deInit(smComT1oI2C_GetEseCtx(conn_ctx));
     if (status != ESESTATUS_SUCCESS) {
         SMLOG_E("Failed to Reset 7816 protocol instance ");
         return SM_NOT_OK;
     }
+    /* The T=1oI2C context has been released, the default connection (NULL) maps to the first context */
+    if (pCtx->inUse) {
+        SM_COND_DEINIT(pCtx->queueCond);
+        SM_MUTEX_DEINIT(pCtx->queueLock);
+    }
+    return smComT1oI2C_ReleaseCtx(pCtx);
+}
+
+smStatus_t smComT1oI2C_GetQueueStats(void *conn_ctx, smComQueueStats_t *pStats)
+{
+    smComT1oI2C_Ctx_t *pCtx = (smComT1oI2C_Ctx_t *)conn_ctx;
+
+    ENSURE_OR_RETURN_ON_ERROR((pCtx != NULL), SM_NOT_OK);
+    ENSURE_OR_RETURN_ON_ERROR((pStats != NULL), SM_NOT_OK);
+
+    SM_MUTEX_LOCK(pCtx->queueLock);
+    memcpy(pStats, &pCtx->stats, sizeof(*pStats));
+    SM_MUTEX_UNLOCK(pCtx->queueLock);
+    return SM_OK;
+}
+
+smStatus_t smComT1oI2C_SetReadyNotifier(void *conn_ctx, const phPalEse_ReadyNotifier_t *pNotifier)
+{
+    ESESTATUS status;
+
+    ENSURE_OR_RETURN_ON_ERROR((conn_ctx != NULL), SM_NOT_OK);
+
+    status = phNxpEse_setReadyNotifier(smComT1oI2C_GetEseCtx(conn_ctx), pNotifier);
+    ENSURE_OR_RETURN_ON_ERROR((status == ESESTATUS_SUCCESS), SM_NOT_OK);
+
+    return SM_OK;
+}
+
+smStatus_t smComT1oI2C_SetFrameTap(void *conn_ctx, const phPalEse_FrameTap_t *pTap)
+{
+    ESESTATUS status;
+
+    ENSURE_OR_RETURN_ON_ERROR((conn_ctx != NULL), SM_NOT_OK);
+
+    status = phNxpEse_setFrameTap(smComT1oI2C_GetEseCtx(conn_ctx), pTap);
+    ENSURE_OR_RETURN_ON_ERROR((status == ESESTATUS_SUCCESS), SM_NOT_OK);
+
+    return SM_OK;
+}
+
+smStatus_t smComT1oI2C_GetLatencyModel(void *conn_ctx, phNxpEse_LatencyEntry_t *pEntries, size_t *pNumEntries)
+{
+    ESESTATUS status;
+
+    ENSURE_OR_RETURN_ON_ERROR((conn_ctx != NULL), SM_NOT_OK);
+
+    status = phNxpEse_getLatencyModel(smComT1oI2C_GetEseCtx(conn_ctx), pEntries, pNumEntries);
+    ENSURE_OR_RETURN_ON_ERROR((status == ESESTATUS_SUCCESS), SM_NOT_OK);
+
+    return SM_OK;
+}
+
+smStatus_t smComT1oI2C_ResetLatencyModel(void *conn_ctx)
+{
+    ESESTATUS status;
+
+    ENSURE_OR_RETURN_ON_ERROR((conn_ctx != NULL), SM_NOT_OK);
+
+    status = phNxpEse_resetLatencyModel(smComT1oI2C_GetEseCtx(conn_ctx));
+    ENSURE_OR_RETURN_ON_ERROR((status == ESESTATUS_SUCCESS), SM_NOT_OK);
+
+    return SM_OK;
+}
+
+smStatus_t smComT1oI2C_GetWtxInfo(void *conn_ctx, phNxpEse_WtxInfo_t *pWtxInfo)
+{
+    ESESTATUS status;
+
+    ENSURE_OR_RETURN_ON_ERROR((conn_ctx != NULL), SM_NOT_OK);
+
+    status = phNxpEse_getWtxInfo(smComT1oI2C_GetEseCtx(conn_ctx), pWtxInfo);
+    ENSURE_OR_RETURN_ON_ERROR((status == ESESTATUS_SUCCESS), SM_NOT_OK);
+
+    return SM_OK;
+}
+
+smStatus_t smComT1oI2C_GetLinkStats(void *conn_ctx, phNxpEse_Stats_t *pStats)
+{
+    ESESTATUS status;
+
+    ENSURE_OR_RETURN_ON_ERROR((conn_ctx != NULL), SM_NOT_OK);
+
+    status = phNxpEse_getStats(smComT1oI2C_GetEseCtx(conn_ctx), pStats);
+    ENSURE_OR_RETURN_ON_ERROR((status == ESESTATUS_SUCCESS), SM_NOT_OK);
+
+    return SM_OK;
+}
+
+smStatus_t smComT1oI2C_GetIfs(void *conn_ctx, uint16_t *pIfsc, uint16_t *pIfsd)
+{
+    ESESTATUS status;
+
+    ENSURE_OR_RETURN_ON_ERROR((conn_ctx != NULL), SM_NOT_OK);
+
+    status = phNxpEse_getIfs(smComT1oI2C_GetEseCtx(conn_ctx), pIfsc, pIfsd);
+    ENSURE_OR_RETURN_ON_ERROR((status == ESESTATUS_SUCCESS), SM_NOT_OK);
+
     return SM_OK;
 }
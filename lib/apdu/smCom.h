@@ -1,7 +1,7 @@
 /** @file smCom.h
  *  @brief SmCom APIs.
  *
- * Copyright 2021,2022 NXP
+ * Copyright 2021,2022,2024 NXP
  * SPDX-License-Identifier: Apache-2.0
  */
 
@@ -15,6 +15,55 @@
 
 /* ********************** Include files ********************** */
 #include "se05x_tlv.h"
+#include "phNxpEse_Api.h"
+
+/* ********************** Types ********************** */
+
+/** Scheduling class of an APDU on a connection.
+ *
+ * Pending requests of a higher class (lower value) are sent before requests
+ * of a lower class. Requests of the same class are sent in FIFO order. */
+typedef enum
+{
+    /** Latency critical operations (sign, ECDH, cipher) */
+    kSmCom_Priority_High = 0,
+    /** Management and other commands */
+    kSmCom_Priority_Normal,
+    /** Bulk object transfers (read object, write binary) */
+    kSmCom_Priority_Bulk,
+    kSmCom_Priority_Max,
+} smComPriority_t;
+
+/** Per request information passed with an APDU */
+typedef struct
+{
+    /** Scheduling class of the request */
+    smComPriority_t priority;
+    /** Command identification (PH_NXP_ESE_CMD_KEY of INS, P1, P2) for the latency model,
+     * PH_NXP_ESE_CMD_KEY_NONE if unknown */
+    uint32_t cmdKey;
+    /** Writable bytes before pTx, PH_NXP_ESE_TX_HEADROOM or more lets the frames be built in place */
+    size_t headroom;
+    /** Writable bytes after pTx + txLen, PH_NXP_ESE_TX_TAILROOM or more lets the frames be built in place */
+    size_t tailroom;
+    /** Time budget of the request in microseconds, queueing and error recovery included, 0 for none */
+    uint32_t timeoutUs;
+} smComTxInfo_t;
+
+/** Request queue statistics of a connection */
+typedef struct
+{
+    /** Requests currently waiting or in progress */
+    uint32_t depth;
+    /** Highest depth observed */
+    uint32_t maxDepth;
+    /** Requests served, per class */
+    uint32_t requests[kSmCom_Priority_Max];
+    /** Accumulated time spent waiting in the queue (us), per class */
+    uint64_t totalWaitUs[kSmCom_Priority_Max];
+    /** Longest time spent waiting in the queue (us), per class */
+    uint64_t maxWaitUs[kSmCom_Priority_Max];
+} smComQueueStats_t;
 
 /* ********************** Function Prototypes ********************** */
 #ifdef __cplusplus
@@ -23,9 +72,25 @@ extern "C" {
 
 smStatus_t smComT1oI2C_Close(void *conn_ctx, uint8_t mode);
 smStatus_t smComT1oI2C_Init(void **conn_ctx, const char *pConnString);
+smStatus_t smComT1oI2C_InitEx(void **conn_ctx, const char *pConnString, const Se05xIoConfig_t *pIoConfig);
 smStatus_t smComT1oI2C_Open(void *conn_ctx, uint8_t mode, uint8_t seqCnt, uint8_t *T1oI2Catr, size_t *T1oI2CatrLen);
 smStatus_t smComT1oI2C_TransceiveRaw(void *conn_ctx, uint8_t *pTx, size_t txLen, uint8_t *pRx, size_t *pRxLen);
 smStatus_t smComT1oI2C_ComReset(void *conn_ctx);
+smStatus_t smComT1oI2C_TransceiveRawPriority(
+    void *conn_ctx, smComPriority_t priority, uint8_t *pTx, size_t txLen, uint8_t *pRx, size_t *pRxLen);
+smStatus_t smComT1oI2C_TransceiveRawTimeout(
+    void *conn_ctx, uint32_t timeoutUs, uint8_t *pTx, size_t txLen, uint8_t *pRx, size_t *pRxLen);
+smStatus_t smComT1oI2C_TransceiveRawEx(
+    void *conn_ctx, const smComTxInfo_t *pTxInfo, uint8_t *pTx, size_t txLen, uint8_t *pRx, size_t *pRxLen);
+smComPriority_t smComT1oI2C_GetPriority(uint8_t ins);
+smStatus_t smComT1oI2C_GetQueueStats(void *conn_ctx, smComQueueStats_t *pStats);
+smStatus_t smComT1oI2C_SetReadyNotifier(void *conn_ctx, const phPalEse_ReadyNotifier_t *pNotifier);
+smStatus_t smComT1oI2C_SetFrameTap(void *conn_ctx, const phPalEse_FrameTap_t *pTap);
+smStatus_t smComT1oI2C_GetLatencyModel(void *conn_ctx, phNxpEse_LatencyEntry_t *pEntries, size_t *pNumEntries);
+smStatus_t smComT1oI2C_ResetLatencyModel(void *conn_ctx);
+smStatus_t smComT1oI2C_GetWtxInfo(void *conn_ctx, phNxpEse_WtxInfo_t *pWtxInfo);
+smStatus_t smComT1oI2C_GetLinkStats(void *conn_ctx, phNxpEse_Stats_t *pStats);
+smStatus_t smComT1oI2C_GetIfs(void *conn_ctx, uint16_t *pIfsc, uint16_t *pIfsd);
 
 #ifdef __cplusplus
 }
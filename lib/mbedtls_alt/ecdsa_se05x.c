@@ -43,6 +43,9 @@ extern int mbedtls_ecdsa_sign_o(mbedtls_ecp_group *grp,
     int (*f_rng)(void *, unsigned char *, size_t),
     void *p_rng);
 
+/* Sign command of the last used key, encoded once */
+static Se05xPreparedCmd_t gSignCmd;
+static uint32_t gSignKeyID;
 
 int mbedtls_ecdsa_sign(mbedtls_ecp_group *grp,
     mbedtls_mpi *r,
@@ -104,10 +107,19 @@ int mbedtls_ecdsa_sign(mbedtls_ecp_group *grp,
     }
 
     SMLOG_I("Using SE05x for ecdsa sign");
-    status = Se05x_API_ECDSASign(
-        &pSession, keyID, kSE05x_ECSignatureAlgo_SHA_256, (uint8_t *)buf, blen, signature, &signature_len);
+    if ((gSignCmd.session_ctx != &pSession) || (gSignKeyID != keyID)) {
+        status = Se05x_API_PrepareECDSASign(&pSession, keyID, kSE05x_ECSignatureAlgo_SHA_256, &gSignCmd);
+        if (status != SM_OK) {
+            SMLOG_E("Error in Se05x_API_PrepareECDSASign \n");
+            gSignCmd.session_ctx = NULL;
+            ret                  = -1;
+            goto exit;
+        }
+        gSignKeyID = keyID;
+    }
+    status = Se05x_API_PreparedECDSASign(&gSignCmd, buf, blen, signature, &signature_len);
     if (status != SM_OK) {
-        SMLOG_E("Error in Se05x_API_ECDSASign \n");
+        SMLOG_E("Error in Se05x_API_PreparedECDSASign \n");
         ret = -1;
         goto exit;
     }
@@ -38,6 +38,22 @@ void sm_usleep(uint32_t microsec)
     }
 }
 
+/**
+ * Return a monotonic time stamp in microseconds (1ms SysTick resolution)
+ */
+uint64_t sm_get_time_us(void)
+{
+    return (uint64_t)gtimer_kinetis_msticks * 1000u;
+}
+
+/**
+ * Return a monotonic time stamp in nanoseconds (1ms SysTick resolution)
+ */
+uint64_t sm_get_time_ns(void)
+{
+    return (uint64_t)gtimer_kinetis_msticks * 1000000u;
+}
+
 #if !defined(SDK_OS_FREE_RTOS) && !defined(SDK_OS_FREE_RTOS)
 
 extern volatile uint32_t gtimer_kinetis_msticks; // counter for 1ms SysTicks
@@ -0,0 +1,278 @@
+/** @file sm_apdu_trace.c
+ *  @brief APDU trace writing the exchanges of a session to a compact binary file.
+ *
+ * Copyright 2024 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* ********************** Include files ********************** */
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "sm_apdu_trace.h"
+#include "sm_timer.h"
+#include "sm_port.h"
+
+/* ********************** Defines ********************** */
+/* Buffer of the trace file, records are written to the file in bulk */
+#define SM_APDU_TRACE_FILE_BUFFER (64 * 1024)
+
+/* ********************** Data types ********************** */
+
+/* Per session trace context */
+typedef struct
+{
+    FILE *pFile;     /* Trace file */
+    int isFailed;    /* Writing failed, further records are dropped */
+    char *pFileBuff; /* Buffer of the trace file */
+    uint64_t baseNs; /* sm_get_time_ns of record time 0 */
+} sm_apdu_trace_ctx_t;
+
+/* ********************** Functions ********************** */
+
+static void sm_apdu_trace_put_be16(uint8_t *pBuf, size_t value)
+{
+    uint16_t val16 = (value > UINT16_MAX) ? UINT16_MAX : (uint16_t)value;
+
+    pBuf[0] = (uint8_t)(val16 >> 8);
+    pBuf[1] = (uint8_t)(val16);
+}
+
+/**
+* Stores a 32 bit value big endian, saturated
+*/
+static void sm_apdu_trace_put_be32(uint8_t *pBuf, uint64_t value)
+{
+    uint32_t val32 = (value > UINT32_MAX) ? UINT32_MAX : (uint32_t)value;
+
+    pBuf[0] = (uint8_t)(val32 >> 24);
+    pBuf[1] = (uint8_t)(val32 >> 16);
+    pBuf[2] = (uint8_t)(val32 >> 8);
+    pBuf[3] = (uint8_t)(val32);
+}
+
+static void sm_apdu_trace_put_be64(uint8_t *pBuf, uint64_t value)
+{
+    sm_apdu_trace_put_be32(&pBuf[0], value >> 32);
+    sm_apdu_trace_put_be32(&pBuf[4], value & UINT32_MAX);
+}
+
+static uint16_t sm_apdu_trace_get_be16(const uint8_t *pBuf)
+{
+    return (uint16_t)((pBuf[0] << 8) | pBuf[1]);
+}
+
+static uint32_t sm_apdu_trace_get_be32(const uint8_t *pBuf)
+{
+    return ((uint32_t)pBuf[0] << 24) | ((uint32_t)pBuf[1] << 16) | ((uint32_t)pBuf[2] << 8) | (uint32_t)pBuf[3];
+}
+
+static uint64_t sm_apdu_trace_get_be64(const uint8_t *pBuf)
+{
+    return ((uint64_t)sm_apdu_trace_get_be32(&pBuf[0]) << 32) | sm_apdu_trace_get_be32(&pBuf[4]);
+}
+
+/**
+* Writes the file header. Record time 0 is the current time.
+*/
+static int sm_apdu_trace_write_header(sm_apdu_trace_ctx_t *pCtx)
+{
+    uint8_t header[SM_APDU_TRACE_HDR_LEN] = {0};
+    struct timespec wallTime              = {0};
+    uint64_t wallClockNs                  = 0;
+
+    pCtx->baseNs = sm_get_time_ns();
+    if (clock_gettime(CLOCK_REALTIME, &wallTime) == 0) {
+        wallClockNs = ((uint64_t)wallTime.tv_sec * 1000000000u) + (uint64_t)wallTime.tv_nsec;
+    }
+
+    memcpy(&header[0], SM_APDU_TRACE_MAGIC, 4);
+    header[4] = SM_APDU_TRACE_VERSION;
+    header[5] = SM_APDU_TRACE_HDR_LEN;
+    sm_apdu_trace_put_be16(&header[6], SM_APDU_TRACE_RECORD_LEN);
+    sm_apdu_trace_put_be64(&header[8], wallClockNs);
+    if (fwrite(header, 1, sizeof(header), pCtx->pFile) != sizeof(header)) {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+* Writes one record
+*/
+static void sm_apdu_trace_record(void *pTraceCtx, const Se05xApduTraceRecord_t *pRecord)
+{
+    sm_apdu_trace_ctx_t *pCtx                = (sm_apdu_trace_ctx_t *)pTraceCtx;
+    uint8_t record[SM_APDU_TRACE_RECORD_LEN] = {0};
+
+    if ((pCtx == NULL) || (pCtx->isFailed) || (pRecord == NULL)) {
+        return;
+    }
+
+    memcpy(&record[0], pRecord->hdr.hdr, sizeof(pRecord->hdr.hdr));
+    record[4] = pRecord->flags;
+    record[5] = 0;
+    sm_apdu_trace_put_be16(&record[6], pRecord->status);
+    sm_apdu_trace_put_be16(&record[8], pRecord->cmdLen);
+    sm_apdu_trace_put_be16(&record[10], pRecord->rspLen);
+    sm_apdu_trace_put_be32(&record[12], pRecord->timeoutUs);
+    sm_apdu_trace_put_be64(&record[16], (pRecord->startNs >= pCtx->baseNs) ? (pRecord->startNs - pCtx->baseNs) : 0);
+    sm_apdu_trace_put_be32(&record[24], pRecord->durationNs);
+    if (fwrite(record, 1, sizeof(record), pCtx->pFile) != sizeof(record)) {
+        SMLOG_E("APDU trace: Error in writing record, trace stopped \n");
+        pCtx->isFailed = 1;
+    }
+}
+
+/**
+* Flushes and closes the trace file
+*/
+static void sm_apdu_trace_free(sm_apdu_trace_ctx_t *pCtx)
+{
+    if (pCtx == NULL) {
+        return;
+    }
+    if (pCtx->pFile != NULL) {
+        if (fclose(pCtx->pFile) != 0) {
+            SMLOG_E("APDU trace: Error in closing trace file \n");
+        }
+    }
+    if (pCtx->pFileBuff != NULL) {
+        sm_free(pCtx->pFileBuff);
+    }
+    sm_free(pCtx);
+}
+
+/**
+* Creates the trace file and sets up the trace
+*/
+smStatus_t sm_apdu_trace_open(Se05xApduTrace_t *pTrace, const char *pFileName)
+{
+    sm_apdu_trace_ctx_t *pCtx = NULL;
+
+    if ((pTrace == NULL) || (pFileName == NULL)) {
+        return SM_NOT_OK;
+    }
+
+    pCtx = (sm_apdu_trace_ctx_t *)sm_malloc(sizeof(sm_apdu_trace_ctx_t));
+    if (pCtx == NULL) {
+        SMLOG_E("APDU trace: Error in allocating context \n");
+        return SM_NOT_OK;
+    }
+    memset(pCtx, 0, sizeof(*pCtx));
+
+    pCtx->pFile = fopen(pFileName, "wb");
+    if (pCtx->pFile == NULL) {
+        SMLOG_E("APDU trace: Error in creating %s \n", pFileName);
+        goto error;
+    }
+    /* Keep file writes out of the timing of the exchanges */
+    pCtx->pFileBuff = (char *)sm_malloc(SM_APDU_TRACE_FILE_BUFFER);
+    if (pCtx->pFileBuff != NULL) {
+        setvbuf(pCtx->pFile, pCtx->pFileBuff, _IOFBF, SM_APDU_TRACE_FILE_BUFFER);
+    }
+    if (sm_apdu_trace_write_header(pCtx) != 0) {
+        SMLOG_E("APDU trace: Error in writing header of %s \n", pFileName);
+        goto error;
+    }
+
+    pTrace->record    = &sm_apdu_trace_record;
+    pTrace->pTraceCtx = pCtx;
+    return SM_OK;
+
+error:
+    sm_apdu_trace_free(pCtx);
+    return SM_NOT_OK;
+}
+
+void sm_apdu_trace_close(Se05xApduTrace_t *pTrace)
+{
+    if ((pTrace == NULL) || (pTrace->record != &sm_apdu_trace_record)) {
+        return;
+    }
+    sm_apdu_trace_free((sm_apdu_trace_ctx_t *)pTrace->pTraceCtx);
+    pTrace->record    = NULL;
+    pTrace->pTraceCtx = NULL;
+}
+
+/**
+* Opens a trace file and checks its header
+*/
+smStatus_t sm_apdu_trace_reader_open(sm_apdu_trace_reader_t *pReader, const char *pFileName)
+{
+    uint8_t header[SM_APDU_TRACE_HDR_LEN] = {0};
+    size_t headerLen                      = 0;
+
+    if ((pReader == NULL) || (pFileName == NULL)) {
+        return SM_NOT_OK;
+    }
+    memset(pReader, 0, sizeof(*pReader));
+
+    pReader->pFile = fopen(pFileName, "rb");
+    if (pReader->pFile == NULL) {
+        SMLOG_E("APDU trace: Error in opening %s \n", pFileName);
+        return SM_NOT_OK;
+    }
+    if (fread(header, 1, sizeof(header), pReader->pFile) != sizeof(header)) {
+        goto error;
+    }
+    headerLen          = header[5];
+    pReader->recordLen = sm_apdu_trace_get_be16(&header[6]);
+    if ((memcmp(&header[0], SM_APDU_TRACE_MAGIC, 4) != 0) || (header[4] != SM_APDU_TRACE_VERSION) ||
+        (headerLen < SM_APDU_TRACE_HDR_LEN) || (pReader->recordLen < SM_APDU_TRACE_RECORD_LEN)) {
+        goto error;
+    }
+    pReader->wallClockNs = sm_apdu_trace_get_be64(&header[8]);
+    if (fseek(pReader->pFile, (long)headerLen, SEEK_SET) != 0) {
+        goto error;
+    }
+    return SM_OK;
+
+error:
+    SMLOG_E("APDU trace: %s is not a trace file \n", pFileName);
+    sm_apdu_trace_reader_close(pReader);
+    return SM_NOT_OK;
+}
+
+int sm_apdu_trace_read(sm_apdu_trace_reader_t *pReader, Se05xApduTraceRecord_t *pRecord)
+{
+    uint8_t record[SM_APDU_TRACE_RECORD_LEN] = {0};
+    size_t nrRead                            = 0;
+
+    if ((pReader == NULL) || (pReader->pFile == NULL) || (pRecord == NULL)) {
+        return -1;
+    }
+
+    nrRead = fread(record, 1, sizeof(record), pReader->pFile);
+    if (nrRead == 0) {
+        return feof(pReader->pFile) ? 1 : -1;
+    }
+    if (nrRead != sizeof(record)) {
+        return -1;
+    }
+    if ((pReader->recordLen > SM_APDU_TRACE_RECORD_LEN) &&
+        (fseek(pReader->pFile, (long)(pReader->recordLen - SM_APDU_TRACE_RECORD_LEN), SEEK_CUR) != 0)) {
+        return -1;
+    }
+
+    memset(pRecord, 0, sizeof(*pRecord));
+    memcpy(pRecord->hdr.hdr, &record[0], sizeof(pRecord->hdr.hdr));
+    pRecord->flags      = record[4];
+    pRecord->status     = sm_apdu_trace_get_be16(&record[6]);
+    pRecord->cmdLen     = sm_apdu_trace_get_be16(&record[8]);
+    pRecord->rspLen     = sm_apdu_trace_get_be16(&record[10]);
+    pRecord->timeoutUs  = sm_apdu_trace_get_be32(&record[12]);
+    pRecord->startNs    = sm_apdu_trace_get_be64(&record[16]);
+    pRecord->durationNs = sm_apdu_trace_get_be32(&record[24]);
+    return 0;
+}
+
+void sm_apdu_trace_reader_close(sm_apdu_trace_reader_t *pReader)
+{
+    if ((pReader == NULL) || (pReader->pFile == NULL)) {
+        return;
+    }
+    fclose(pReader->pFile);
+    pReader->pFile = NULL;
+}
@@ -0,0 +1,79 @@
+/** @file sm_apdu_trace.h
+ *  @brief APDU trace writing the exchanges of a session to a compact binary file.
+ *
+ * Copyright 2024 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SM_APDU_TRACE_H_INC
+#define SM_APDU_TRACE_H_INC
+
+/* ********************** Include files ********************** */
+#include <stdio.h>
+#include "se05x_tlv.h"
+
+/* ********************** Defines ********************** */
+
+/* The trace file starts with a file header, followed by one record per
+ * exchange. Command and response data are not recorded. All fields are
+ * big endian:
+ *
+ * File header
+ *   Offset  Size  Field
+ *   0       4     Magic, SM_APDU_TRACE_MAGIC
+ *   4       1     Version, SM_APDU_TRACE_VERSION
+ *   5       1     Length of the file header, SM_APDU_TRACE_HDR_LEN
+ *   6       2     Length of a record, SM_APDU_TRACE_RECORD_LEN
+ *   8       8     Wall clock time (CLOCK_REALTIME) of record time 0 in ns
+ *
+ * Record
+ *   Offset  Size  Field
+ *   0       4     APDU header, CLA INS P1 P2
+ *   4       1     Flags, SE05X_APDU_TRACE_FLAG_*
+ *   5       1     Reserved, 0
+ *   6       2     Status (smStatus_t)
+ *   8       2     Length of the plain command data
+ *   10      2     Length of the plain response incl. status word
+ *   12      4     Response timeout in us, 0 for no limit
+ *   16      8     Start of the exchange in ns, relative to the file header time
+ *   24      4     Duration of the exchange in ns
+ *
+ * Record times are CLOCK_MONOTONIC. Durations above 4.29s are saturated.
+ * Readers skip unknown trailing bytes of longer headers and records. */
+#define SM_APDU_TRACE_MAGIC "SEAT"
+#define SM_APDU_TRACE_VERSION 1
+#define SM_APDU_TRACE_HDR_LEN 16
+#define SM_APDU_TRACE_RECORD_LEN 28
+
+/* ********************** Data types ********************** */
+
+/* Reader of a trace file */
+typedef struct
+{
+    FILE *pFile;
+    uint64_t wallClockNs; /* Wall clock time of record time 0 */
+    size_t recordLen;
+} sm_apdu_trace_reader_t;
+
+/* ********************** Function Prototypes ********************** */
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/* Sets up an APDU trace writing to a new file. Records are buffered,
+ * the file is complete once the trace is closed. */
+smStatus_t sm_apdu_trace_open(Se05xApduTrace_t *pTrace, const char *pFileName);
+void sm_apdu_trace_close(Se05xApduTrace_t *pTrace);
+
+/* Reads a trace file record by record. sm_apdu_trace_read returns 0 for a
+ * record, 1 at the end of the trace and -1 for a damaged file. The start time
+ * of the returned records is relative to wallClockNs of the reader. */
+smStatus_t sm_apdu_trace_reader_open(sm_apdu_trace_reader_t *pReader, const char *pFileName);
+int sm_apdu_trace_read(sm_apdu_trace_reader_t *pReader, Se05xApduTraceRecord_t *pRecord);
+void sm_apdu_trace_reader_close(sm_apdu_trace_reader_t *pReader);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif //#ifndef SM_APDU_TRACE_H_INC
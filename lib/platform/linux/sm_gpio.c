@@ -0,0 +1,170 @@
+/** @file sm_gpio.c
+ *  @brief GPIO data ready notifier using the Linux GPIO character device.
+ *
+ * Copyright 2024 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* ********************** Include files ********************** */
+#include <linux/version.h>
+#include "sm_gpio.h"
+#include "sm_port.h"
+
+/* The GPIO v2 character device uAPI (line requests with edge events) came with Linux 5.10 */
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5, 10, 0)
+#define SM_GPIO_HAVE_LINE_V2
+#endif
+
+#if defined(SM_GPIO_HAVE_LINE_V2)
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+
+/* ********************** Defines ********************** */
+#define SM_GPIO_CONSUMER "se05x_ready"
+
+/* ********************** Data types ********************** */
+
+/* Per connection GPIO notifier context */
+typedef struct
+{
+    int lineFd; /* File descriptor of the requested GPIO line */
+} sm_gpio_notifier_ctx_t;
+
+/* ********************** Functions ********************** */
+
+/**
+* Waits for an edge event on the data ready line.
+* One event is consumed per wait, a stale event only results in an early poll of the SE.
+*/
+static ESESTATUS sm_gpio_notifier_wait(void *pNotifierCtx, uint32_t timeoutMs)
+{
+    int ret                         = -1;
+    ssize_t nrRead                  = -1;
+    struct pollfd pfd               = {0};
+    struct gpio_v2_line_event event = {0};
+    sm_gpio_notifier_ctx_t *pCtx    = (sm_gpio_notifier_ctx_t *)pNotifierCtx;
+
+    if (pCtx == NULL) {
+        return ESESTATUS_INVALID_PARAMETER;
+    }
+
+    pfd.fd     = pCtx->lineFd;
+    pfd.events = POLLIN | POLLPRI;
+    ret        = poll(&pfd, 1, (int)timeoutMs);
+    if (ret == 0) {
+        return ESESTATUS_PENDING;
+    }
+    else if (ret < 0) {
+        if (errno == EINTR) {
+            return ESESTATUS_PENDING;
+        }
+        SMLOG_E("GPIO: poll failed (errno=%d) \n", errno);
+        return ESESTATUS_FAILED;
+    }
+
+    nrRead = read(pCtx->lineFd, &event, sizeof(event));
+    if (nrRead != (ssize_t)sizeof(event)) {
+        SMLOG_E("GPIO: Failed reading line event \n");
+        return ESESTATUS_FAILED;
+    }
+    return ESESTATUS_SUCCESS;
+}
+
+/**
+* Releases the GPIO line
+*/
+static void sm_gpio_notifier_release(void *pNotifierCtx)
+{
+    sm_gpio_notifier_ctx_t *pCtx = (sm_gpio_notifier_ctx_t *)pNotifierCtx;
+
+    if (pCtx == NULL) {
+        return;
+    }
+    if (pCtx->lineFd >= 0) {
+        close(pCtx->lineFd);
+    }
+    sm_free(pCtx);
+}
+
+/**
+* Requests the data ready line for edge events and sets up the notifier
+*/
+ESESTATUS sm_gpio_notifier_open(
+    phPalEse_ReadyNotifier_t *pNotifier, const char *pChipName, unsigned int lineOffset, bool activeLow)
+{
+    int chipFd                          = -1;
+    struct gpio_v2_line_request request = {0};
+    sm_gpio_notifier_ctx_t *pCtx        = NULL;
+
+    if ((pNotifier == NULL) || (pChipName == NULL)) {
+        return ESESTATUS_INVALID_PARAMETER;
+    }
+
+    pCtx = (sm_gpio_notifier_ctx_t *)sm_malloc(sizeof(sm_gpio_notifier_ctx_t));
+    if (pCtx == NULL) {
+        SMLOG_E("GPIO: Error in allocating context \n");
+        return ESESTATUS_INSUFFICIENT_RESOURCES;
+    }
+    pCtx->lineFd = -1;
+
+    chipFd = open(pChipName, O_RDONLY);
+    if (chipFd < 0) {
+        SMLOG_E("GPIO: Error in opening %s \n", pChipName);
+        goto error;
+    }
+
+    request.offsets[0]   = lineOffset;
+    request.num_lines    = 1;
+    request.config.flags = GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_EDGE_RISING;
+    if (activeLow) {
+        request.config.flags |= GPIO_V2_LINE_FLAG_ACTIVE_LOW;
+    }
+    strncpy(request.consumer, SM_GPIO_CONSUMER, sizeof(request.consumer) - 1);
+
+    if (ioctl(chipFd, GPIO_V2_GET_LINE_IOCTL, &request) < 0) {
+        SMLOG_E("GPIO: Failed requesting line %u (errno=%d) \n", lineOffset, errno);
+        goto error;
+    }
+    close(chipFd);
+    pCtx->lineFd = request.fd;
+
+    pNotifier->wait         = &sm_gpio_notifier_wait;
+    pNotifier->release      = &sm_gpio_notifier_release;
+    pNotifier->pNotifierCtx = pCtx;
+    return ESESTATUS_SUCCESS;
+
+error:
+    if (chipFd >= 0) {
+        close(chipFd);
+    }
+    sm_free(pCtx);
+    return ESESTATUS_FAILED;
+}
+
+#else /* SM_GPIO_HAVE_LINE_V2 */
+
+/**
+* No GPIO v2 uAPI in the kernel headers, the notifier is not set up and the SE is polled
+*/
+ESESTATUS sm_gpio_notifier_open(
+    phPalEse_ReadyNotifier_t *pNotifier, const char *pChipName, unsigned int lineOffset, bool activeLow)
+{
+    (void)pChipName;
+    (void)lineOffset;
+    (void)activeLow;
+
+    if (pNotifier == NULL) {
+        return ESESTATUS_INVALID_PARAMETER;
+    }
+    SMLOG_W("GPIO: Data ready notifier needs Linux 5.10 or newer kernel headers \n");
+    return ESESTATUS_FEATURE_NOT_SUPPORTED;
+}
+
+#endif /* SM_GPIO_HAVE_LINE_V2 */
@@ -0,0 +1,31 @@
+/** @file sm_gpio.h
+ *  @brief GPIO data ready notifier.
+ *
+ * Copyright 2024 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SM_GPIO_H_INC
+#define SM_GPIO_H_INC
+
+/* ********************** Include files ********************** */
+#include <stdbool.h>
+#include "phNxpEsePal_i2c.h"
+
+/* ********************** Function Prototypes ********************** */
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/* Sets up a data ready notifier on a GPIO line of a GPIO character device (e.g. "/dev/gpiochip0").
+ * The notifier waits for the line to become active (rising edge, falling edge if activeLow is set).
+ * Built against kernel headers older than Linux 5.10 (no GPIO v2 uAPI) it returns
+ * ESESTATUS_FEATURE_NOT_SUPPORTED, pNotifier is left untouched and the SE is polled. */
+ESESTATUS sm_gpio_notifier_open(
+    phPalEse_ReadyNotifier_t *pNotifier, const char *pChipName, unsigned int lineOffset, bool activeLow);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif //#ifndef SM_GPIO_H_INC
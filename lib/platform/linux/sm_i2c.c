@@ -1,12 +1,13 @@
 /** @file sm_i2c.c
  *  @brief I2C Interface functions.
  *
- * Copyright 2021,2022 NXP
+ * Copyright 2021,2022,2024 NXP
  * SPDX-License-Identifier: Apache-2.0
  */
 
 /* ********************** Include files ********************** */
 #include <stdlib.h>
+#include <string.h>
 #include "sm_i2c.h"
 #include "sm_port.h"
 #include <fcntl.h>
@@ -19,61 +20,131 @@
 #include <errno.h>
 #include <time.h>
 
-/* ********************** Global variables ********************** */
-static char *SE05X_I2C_DEV_NAME = "/dev/i2c-1";
-static int SE05x_I2C_DEV        = 0;
-
 /* ********************** Defines ********************** */
+#define SE05X_I2C_DEV_NAME "/dev/i2c-1"
 #define SE05X_I2C_DEV_ADDR 0x48
+#define SE05X_I2C_DEV_NAME_MAX 64
+
+/* ********************** Data types ********************** */
+
+/* Per connection I2C transport context */
+typedef struct
+{
+    int fd;                                /* File descriptor of the opened i2c bus */
+    char devName[SE05X_I2C_DEV_NAME_MAX]; /* i2c bus device node, e.g. /dev/i2c-1 */
+    uint8_t slaveAddr;                     /* 7 bit slave address of SE05x on the bus */
+    bool useRdwr;                          /* Adapter supports combined transfers with I2C_RDWR */
+    bool useNoStart;                       /* Adapter joins I2C_RDWR messages without a start (I2C_M_NOSTART) */
+} sm_i2c_ctx_t;
 
 /* ********************** Functions ********************** */
 
+/**
+* Splits the connection string "<device>[:<slave address>]" into its parts.
+* e.g. "/dev/i2c-1" or "/dev/i2c-1:0x48"
+*/
+static i2c_error_t sm_i2c_parse_conn_string(sm_i2c_ctx_t *pI2cCtx, const char *pDevName)
+{
+    const char *pSeparator = NULL;
+    size_t devNameLen      = 0;
+    unsigned long addr     = SE05X_I2C_DEV_ADDR;
+    char *pEnd             = NULL;
+
+    if (pDevName == NULL) {
+        pDevName = SE05X_I2C_DEV_NAME;
+    }
+
+    pSeparator = strchr(pDevName, ':');
+    if (pSeparator != NULL) {
+        devNameLen = pSeparator - pDevName;
+        addr       = strtoul(pSeparator + 1, &pEnd, 0);
+        if ((pEnd == pSeparator + 1) || (*pEnd != '\0') || (addr > 0x7F)) {
+            SMLOG_E("I2C: Invalid slave address in '%s' \n", pDevName);
+            return I2C_FAILED;
+        }
+    }
+    else {
+        devNameLen = strlen(pDevName);
+    }
+
+    if ((devNameLen == 0) || (devNameLen >= sizeof(pI2cCtx->devName))) {
+        SMLOG_E("I2C: Invalid device name \n");
+        return I2C_FAILED;
+    }
+    memcpy(pI2cCtx->devName, pDevName, devNameLen);
+    pI2cCtx->devName[devNameLen] = '\0';
+    pI2cCtx->slaveAddr           = (uint8_t)addr;
+    return I2C_OK;
+}
+
 /**
 * Opens the communication channel to I2C device
 */
 i2c_error_t axI2CInit(void **conn_ctx, const char *pDevName)
 {
     unsigned long funcs;
-    (void)conn_ctx;
+    sm_i2c_ctx_t *pI2cCtx = NULL;
 
-    if (pDevName != NULL) {
-        SE05x_I2C_DEV = open(pDevName, O_RDWR);
+    if (conn_ctx == NULL) {
+        return I2C_FAILED;
     }
-    else {
-        SE05x_I2C_DEV = open(SE05X_I2C_DEV_NAME, O_RDWR);
+
+    pI2cCtx = (sm_i2c_ctx_t *)sm_malloc(sizeof(sm_i2c_ctx_t));
+    if (pI2cCtx == NULL) {
+        SMLOG_E("I2C: Error in allocating context \n");
+        return I2C_FAILED;
+    }
+    memset(pI2cCtx, 0, sizeof(sm_i2c_ctx_t));
+    pI2cCtx->fd = -1;
+
+    if (sm_i2c_parse_conn_string(pI2cCtx, pDevName) != I2C_OK) {
+        goto error;
     }
-    if (SE05x_I2C_DEV < 0) {
+
+    pI2cCtx->fd = open(pI2cCtx->devName, O_RDWR);
+    if (pI2cCtx->fd < 0) {
         SMLOG_E("I2C: Error in open call \n");
-        return I2C_FAILED;
+        goto error;
     }
 
-    if (ioctl(SE05x_I2C_DEV, I2C_SLAVE, SE05X_I2C_DEV_ADDR) < 0) {
+    if (ioctl(pI2cCtx->fd, I2C_SLAVE, pI2cCtx->slaveAddr) < 0) {
         SMLOG_E("I2C driver failed setting address\n");
     }
 
     // clear PEC flag
-    if (ioctl(SE05x_I2C_DEV, I2C_PEC, 0) < 0) {
+    if (ioctl(pI2cCtx->fd, I2C_PEC, 0) < 0) {
         SMLOG_E("I2C driver: PEC flag clear failed\n");
     }
 
     // Query functional capacity of I2C driver
-    if (ioctl(SE05x_I2C_DEV, I2C_FUNCS, &funcs) < 0) {
+    if (ioctl(pI2cCtx->fd, I2C_FUNCS, &funcs) < 0) {
         SMLOG_E("Cannot get i2c adapter functionality\n");
-        close(SE05x_I2C_DEV);
-        return I2C_FAILED;
+        goto error;
     }
     else {
         if (funcs & I2C_FUNC_I2C) {
             SMLOG_E("I2C driver supports plain i2c-level commands.\n");
+            /* Plain i2c-level commands are issued with I2C_RDWR */
+            pI2cCtx->useRdwr = true;
+            /* Scatter/gather writes need messages joined without a repeated start */
+            pI2cCtx->useNoStart = ((funcs & I2C_FUNC_NOSTART) != 0);
         }
         else {
             SMLOG_E("I2C driver CANNOT support plain i2c-level commands!\n");
-            close(SE05x_I2C_DEV);
-            return I2C_FAILED;
+            goto error;
         }
     }
 
+    *conn_ctx = pI2cCtx;
     return I2C_OK;
+
+error:
+    if (pI2cCtx->fd >= 0) {
+        close(pI2cCtx->fd);
+    }
+    sm_free(pI2cCtx);
+    *conn_ctx = NULL;
+    return I2C_FAILED;
 }
 
 /**
@@ -81,14 +152,19 @@ i2c_error_t axI2CInit(void **conn_ctx, const char *pDevName)
 */
 void axI2CTerm(void *conn_ctx, int mode)
 {
-    (void)conn_ctx;
+    sm_i2c_ctx_t *pI2cCtx = (sm_i2c_ctx_t *)conn_ctx;
     (void)mode;
-    if (close(SE05x_I2C_DEV) != 0) {
-        SMLOG_E("Failed to close i2c device %d.\n", SE05x_I2C_DEV);
+
+    if (pI2cCtx == NULL) {
+        return;
+    }
+    if (close(pI2cCtx->fd) != 0) {
+        SMLOG_E("Failed to close i2c device %d.\n", pI2cCtx->fd);
     }
     else {
-        SMLOG_I("Close i2c device %d.\n", SE05x_I2C_DEV);
+        SMLOG_I("Close i2c device %d.\n", pI2cCtx->fd);
     }
+    sm_free(pI2cCtx);
     return;
 }
 
@@ -96,15 +172,15 @@ i2c_error_t axI2CWrite(void *conn_ctx, unsigned char bus, unsigned char addr, un
 {
     int nrWritten = -1;
     i2c_error_t rv;
-    (void)conn_ctx;
+    sm_i2c_ctx_t *pI2cCtx = (sm_i2c_ctx_t *)conn_ctx;
     (void)bus;
     (void)addr;
 
-    if (pTx == NULL || txLen > MAX_APDU_BUFFER) {
+    if (pI2cCtx == NULL || pTx == NULL || txLen > MAX_APDU_BUFFER) {
         return I2C_FAILED;
     }
 
-    nrWritten = write(SE05x_I2C_DEV, pTx, txLen);
+    nrWritten = write(pI2cCtx->fd, pTx, txLen);
     if (nrWritten < 0) {
         SMLOG_E("Failed writing data (nrWritten=%d).\n", nrWritten);
         rv = I2C_FAILED;
@@ -119,15 +195,15 @@ i2c_error_t axI2CRead(void *conn_ctx, unsigned char bus, unsigned char addr, uns
 {
     int nrRead = -1;
     i2c_error_t rv;
-    (void)conn_ctx;
+    sm_i2c_ctx_t *pI2cCtx = (sm_i2c_ctx_t *)conn_ctx;
     (void)bus;
     (void)addr;
 
-    if (pRx == NULL || rxLen > MAX_APDU_BUFFER) {
+    if (pI2cCtx == NULL || pRx == NULL || rxLen > MAX_APDU_BUFFER) {
         return I2C_FAILED;
     }
 
-    nrRead = read(SE05x_I2C_DEV, pRx, rxLen);
+    nrRead = read(pI2cCtx->fd, pRx, rxLen);
     if (nrRead < 0) {
         rv = I2C_FAILED;
     }
@@ -136,3 +212,108 @@ i2c_error_t axI2CRead(void *conn_ctx, unsigned char bus, unsigned char addr, uns
     }
     return rv;
 }
+
+/**
+* Reads a frame in one combined transfer (I2C_RDWR): header and remainder are read as two messages
+* joined by a repeated start. Splitting the header keeps each message within the max read length of
+* adapters limited to 256 byte messages, and lets the remainder land in a separate buffer.
+* Returns I2C_NOT_SUPPORTED if the adapter does not support combined transfers, axI2CRead has to be used then.
+*/
+i2c_error_t axI2CReadFrame(void *conn_ctx,
+    unsigned char bus,
+    unsigned char addr,
+    unsigned char *pHeader,
+    unsigned short headerLen,
+    unsigned char *pBody,
+    unsigned short bodyLen)
+{
+    struct i2c_msg msgs[2];
+    struct i2c_rdwr_ioctl_data rdwr;
+    sm_i2c_ctx_t *pI2cCtx = (sm_i2c_ctx_t *)conn_ctx;
+    (void)bus;
+    (void)addr;
+
+    if (pI2cCtx == NULL || pHeader == NULL || pBody == NULL || headerLen == 0 || bodyLen == 0 ||
+        (headerLen + bodyLen) > MAX_APDU_BUFFER) {
+        return I2C_FAILED;
+    }
+    if (!pI2cCtx->useRdwr) {
+        return I2C_NOT_SUPPORTED;
+    }
+
+    msgs[0].addr  = pI2cCtx->slaveAddr;
+    msgs[0].flags = I2C_M_RD;
+    msgs[0].len   = headerLen;
+    msgs[0].buf   = pHeader;
+    msgs[1].addr  = pI2cCtx->slaveAddr;
+    msgs[1].flags = I2C_M_RD;
+    msgs[1].len   = bodyLen;
+    msgs[1].buf   = pBody;
+    rdwr.msgs     = msgs;
+    rdwr.nmsgs    = 2;
+
+    if (ioctl(pI2cCtx->fd, I2C_RDWR, &rdwr) < 0) {
+        if ((errno == EOPNOTSUPP) || (errno == EINVAL)) {
+            /* Adapter rejects combined transfers, do not try again on this connection */
+            SMLOG_W("I2C driver does not support combined transfers, using plain reads.\n");
+            pI2cCtx->useRdwr = false;
+            return I2C_NOT_SUPPORTED;
+        }
+        /* SE busy (NACK) or bus error */
+        return I2C_FAILED;
+    }
+    return I2C_OK;
+}
+
+/**
+* Writes a frame held in several pieces as one I2C write: the pieces are sent as I2C_RDWR messages,
+* all but the first flagged I2C_M_NOSTART, so that no start condition or address is sent in between.
+* Returns I2C_NOT_SUPPORTED if the adapter can not join messages, the pieces have to be copied then.
+*/
+i2c_error_t axI2CWriteV(
+    void *conn_ctx, unsigned char bus, unsigned char addr, const sm_i2c_iovec_t *pIov, unsigned char iovCnt)
+{
+    struct i2c_msg msgs[SM_I2C_MAX_IOV];
+    struct i2c_rdwr_ioctl_data rdwr;
+    sm_i2c_ctx_t *pI2cCtx = (sm_i2c_ctx_t *)conn_ctx;
+    size_t totalLen       = 0;
+    unsigned char i       = 0;
+    (void)bus;
+    (void)addr;
+
+    if (pI2cCtx == NULL || pIov == NULL || iovCnt == 0 || iovCnt > SM_I2C_MAX_IOV) {
+        return I2C_FAILED;
+    }
+    if (!pI2cCtx->useRdwr || !pI2cCtx->useNoStart) {
+        return I2C_NOT_SUPPORTED;
+    }
+
+    for (i = 0; i < iovCnt; i++) {
+        if (pIov[i].pData == NULL || pIov[i].len == 0) {
+            return I2C_FAILED;
+        }
+        msgs[i].addr  = pI2cCtx->slaveAddr;
+        msgs[i].flags = (i == 0) ? 0 : I2C_M_NOSTART;
+        msgs[i].len   = pIov[i].len;
+        msgs[i].buf   = (unsigned char *)pIov[i].pData;
+
+        totalLen += pIov[i].len;
+    }
+    if (totalLen > MAX_APDU_BUFFER) {
+        return I2C_FAILED;
+    }
+    rdwr.msgs  = msgs;
+    rdwr.nmsgs = iovCnt;
+
+    if (ioctl(pI2cCtx->fd, I2C_RDWR, &rdwr) < 0) {
+        if ((errno == EOPNOTSUPP) || (errno == EINVAL)) {
+            /* Adapter rejects joined messages, do not try again on this connection */
+            SMLOG_W("I2C driver does not support I2C_M_NOSTART, copying frames.\n");
+            pI2cCtx->useNoStart = false;
+            return I2C_NOT_SUPPORTED;
+        }
+        /* SE busy (NACK) or bus error */
+        return I2C_FAILED;
+    }
+    return I2C_OK;
+}
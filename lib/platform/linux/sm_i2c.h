@@ -1,7 +1,7 @@
 /** @file sm_i2c.h
  *  @brief I2C Interface functions.
  *
- * Copyright 2021,2022 NXP
+ * Copyright 2021,2022,2024 NXP
  * SPDX-License-Identifier: Apache-2.0
  */
 
@@ -26,10 +26,27 @@
 #define I2C_TIME_OUT 11
 #define I2C_OK 12
 #define I2C_FAILED 13
+#define I2C_NOT_SUPPORTED 14
 #define I2C_BUS_0 (0)
 
+/* axI2CReadFrame is available on this platform */
+#define SM_I2C_HAVE_READ_FRAME
+/* axI2CWriteV is available on this platform */
+#define SM_I2C_HAVE_WRITEV
+/* Max number of pieces of one axI2CWriteV */
+#define SM_I2C_MAX_IOV 4
+/* UNIX socket transport (sm_socket.h) is available on this platform */
+#define SM_HAVE_SOCKET_TRANSPORT
+
 typedef unsigned int i2c_error_t;
 
+/* One piece of a scatter/gather write */
+typedef struct
+{
+    const unsigned char *pData;
+    unsigned short len;
+} sm_i2c_iovec_t;
+
 /* ********************** Function Prototypes ********************** */
 #if defined(__cplusplus)
 extern "C" {
@@ -39,6 +56,15 @@ i2c_error_t axI2CInit(void **conn_ctx, const char *pDevName);
 void axI2CTerm(void *conn_ctx, int mode);
 i2c_error_t axI2CWrite(void *conn_ctx, unsigned char bus, unsigned char addr, unsigned char *pTx, unsigned short txLen);
 i2c_error_t axI2CRead(void *conn_ctx, unsigned char bus, unsigned char addr, unsigned char *pRx, unsigned short rxLen);
+i2c_error_t axI2CReadFrame(void *conn_ctx,
+    unsigned char bus,
+    unsigned char addr,
+    unsigned char *pHeader,
+    unsigned short headerLen,
+    unsigned char *pBody,
+    unsigned short bodyLen);
+i2c_error_t axI2CWriteV(
+    void *conn_ctx, unsigned char bus, unsigned char addr, const sm_i2c_iovec_t *pIov, unsigned char iovCnt);
 
 #if defined(__cplusplus)
 }
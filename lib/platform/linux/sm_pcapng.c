@@ -0,0 +1,284 @@
+/** @file sm_pcapng.c
+ *  @brief Frame tap writing T=1oI2C frames to a pcapng capture file.
+ *
+ * Copyright 2024 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* ********************** Include files ********************** */
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "sm_pcapng.h"
+#include "sm_port.h"
+
+/* ********************** Defines ********************** */
+#define SM_PCAPNG_BLOCK_SHB 0x0A0D0D0Au
+#define SM_PCAPNG_BLOCK_IDB 0x00000001u
+#define SM_PCAPNG_BLOCK_EPB 0x00000006u
+#define SM_PCAPNG_BYTE_ORDER_MAGIC 0x1A2B3C4Du
+
+#define SM_PCAPNG_OPT_ENDOFOPT 0
+#define SM_PCAPNG_OPT_IF_NAME 2
+#define SM_PCAPNG_OPT_IF_TSRESOL 9
+#define SM_PCAPNG_OPT_IF_TSOFFSET 14
+#define SM_PCAPNG_OPT_EPB_FLAGS 2
+
+/* epb_flags direction */
+#define SM_PCAPNG_EPB_INBOUND 0x1u
+#define SM_PCAPNG_EPB_OUTBOUND 0x2u
+
+#define SM_PCAPNG_IF_NAME "t1oi2c"
+/* Time stamps in ns (10^-9 s) */
+#define SM_PCAPNG_TSRESOL 9
+/* Buffer of the capture file, frames are written to the file in bulk */
+#define SM_PCAPNG_FILE_BUFFER (64 * 1024)
+
+#define SM_PCAPNG_PAD4(LEN) (((LEN) + 3u) & ~3u)
+
+/* ********************** Data types ********************** */
+
+/* Per connection capture context */
+typedef struct
+{
+    FILE *pFile;     /* Capture file */
+    int isFailed;    /* Writing failed, further frames are dropped */
+    char *pFileBuff; /* Buffer of the capture file */
+} sm_pcapng_tap_ctx_t;
+
+/* ********************** Functions ********************** */
+
+/**
+* Writes zero padding of data of the given length to a multiple of 4 bytes
+*/
+static int sm_pcapng_write_padding(sm_pcapng_tap_ctx_t *pCtx, uint32_t len)
+{
+    static const uint8_t padding[3] = {0};
+    uint32_t padLen                 = SM_PCAPNG_PAD4(len) - len;
+
+    if ((padLen > 0) && (fwrite(padding, 1, padLen, pCtx->pFile) != padLen)) {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+* Writes bytes to the capture file, followed by zero padding to a multiple of 4 bytes
+*/
+static int sm_pcapng_write(sm_pcapng_tap_ctx_t *pCtx, const void *pData, uint32_t len)
+{
+    if ((len > 0) && (fwrite(pData, 1, len, pCtx->pFile) != len)) {
+        return -1;
+    }
+    return sm_pcapng_write_padding(pCtx, len);
+}
+
+/**
+* Writes one block option
+*/
+static int sm_pcapng_write_option(sm_pcapng_tap_ctx_t *pCtx, uint16_t code, const void *pValue, uint16_t len)
+{
+    uint16_t header[2] = {code, len};
+
+    if (sm_pcapng_write(pCtx, header, sizeof(header)) != 0) {
+        return -1;
+    }
+    return sm_pcapng_write(pCtx, pValue, len);
+}
+
+/**
+* Stores a 32 bit value big endian
+*/
+static void sm_pcapng_put_be32(uint8_t *pBuf, uint64_t value)
+{
+    uint32_t val32 = (value > UINT32_MAX) ? UINT32_MAX : (uint32_t)value;
+
+    pBuf[0] = (uint8_t)(val32 >> 24);
+    pBuf[1] = (uint8_t)(val32 >> 16);
+    pBuf[2] = (uint8_t)(val32 >> 8);
+    pBuf[3] = (uint8_t)(val32);
+}
+
+/**
+* Writes the section header and the description of the capture interface
+*/
+static int sm_pcapng_write_header(sm_pcapng_tap_ctx_t *pCtx)
+{
+    uint32_t shbHead[3]      = {SM_PCAPNG_BLOCK_SHB, 28, SM_PCAPNG_BYTE_ORDER_MAGIC};
+    uint16_t shbVersion[2]   = {1, 0};
+    uint64_t sectionLen      = UINT64_MAX;
+    uint32_t idbHead[2]      = {0};
+    uint16_t idbLinkType[2]  = {SM_PCAPNG_LINKTYPE, 0};
+    uint32_t snapLen         = 0;
+    uint32_t blockLen        = 0;
+    uint8_t tsresol          = SM_PCAPNG_TSRESOL;
+    int64_t tsoffset         = 0;
+    struct timespec wallTime = {0};
+    struct timespec monoTime = {0};
+
+    /* Section header block, version 1.0, section length not specified */
+    if ((sm_pcapng_write(pCtx, shbHead, sizeof(shbHead)) != 0) ||
+        (sm_pcapng_write(pCtx, shbVersion, sizeof(shbVersion)) != 0) ||
+        (sm_pcapng_write(pCtx, &sectionLen, sizeof(sectionLen)) != 0) ||
+        (sm_pcapng_write(pCtx, &shbHead[1], sizeof(shbHead[1])) != 0)) {
+        return -1;
+    }
+
+    /* Time stamps are CLOCK_MONOTONIC, the offset maps them to wall clock time */
+    if ((clock_gettime(CLOCK_REALTIME, &wallTime) == 0) && (clock_gettime(CLOCK_MONOTONIC, &monoTime) == 0)) {
+        tsoffset = (int64_t)wallTime.tv_sec - (int64_t)monoTime.tv_sec;
+    }
+
+    /* Interface description block */
+    blockLen = sizeof(idbHead) + sizeof(idbLinkType) + sizeof(snapLen) + 4 +
+               SM_PCAPNG_PAD4(sizeof(SM_PCAPNG_IF_NAME) - 1) + 4 + SM_PCAPNG_PAD4(sizeof(tsresol)) + 4 +
+               sizeof(tsoffset) + 4 + sizeof(blockLen);
+    idbHead[0] = SM_PCAPNG_BLOCK_IDB;
+    idbHead[1] = blockLen;
+    if ((sm_pcapng_write(pCtx, idbHead, sizeof(idbHead)) != 0) ||
+        (sm_pcapng_write(pCtx, idbLinkType, sizeof(idbLinkType)) != 0) ||
+        (sm_pcapng_write(pCtx, &snapLen, sizeof(snapLen)) != 0) ||
+        (sm_pcapng_write_option(
+             pCtx, SM_PCAPNG_OPT_IF_NAME, SM_PCAPNG_IF_NAME, (uint16_t)(sizeof(SM_PCAPNG_IF_NAME) - 1)) != 0) ||
+        (sm_pcapng_write_option(pCtx, SM_PCAPNG_OPT_IF_TSRESOL, &tsresol, sizeof(tsresol)) != 0) ||
+        (sm_pcapng_write_option(pCtx, SM_PCAPNG_OPT_IF_TSOFFSET, &tsoffset, sizeof(tsoffset)) != 0) ||
+        (sm_pcapng_write_option(pCtx, SM_PCAPNG_OPT_ENDOFOPT, NULL, 0) != 0) ||
+        (sm_pcapng_write(pCtx, &blockLen, sizeof(blockLen)) != 0)) {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+* Writes one frame as enhanced packet block
+*/
+static void sm_pcapng_tap_record(
+    void *pTapCtx, const phPalEse_TapInfo_t *pInfo, const phPalEse_IoVec_t *pIov, uint8_t iovCnt)
+{
+    sm_pcapng_tap_ctx_t *pCtx                   = (sm_pcapng_tap_ctx_t *)pTapCtx;
+    uint8_t pseudoHdr[SM_PCAPNG_PSEUDO_HDR_LEN] = {0};
+    uint32_t epb[7]                             = {0};
+    uint32_t frameLen                           = 0;
+    uint32_t packetLen                          = 0;
+    uint32_t blockLen                           = 0;
+    uint32_t flags                              = 0;
+    uint64_t waitNs                             = 0;
+    uint8_t i                                   = 0;
+
+    if ((pCtx == NULL) || (pCtx->isFailed) || (pInfo == NULL) || (pIov == NULL)) {
+        return;
+    }
+    for (i = 0; i < iovCnt; i++) {
+        frameLen += pIov[i].len;
+    }
+    packetLen = SM_PCAPNG_PSEUDO_HDR_LEN + frameLen;
+
+    pseudoHdr[0] = SM_PCAPNG_PSEUDO_HDR_VERSION;
+    pseudoHdr[1] = (pInfo->direction == PH_PAL_ESE_TAP_DIR_RX) ? 1 : 0;
+    pseudoHdr[2] = 0;
+    pseudoHdr[3] = SM_PCAPNG_PSEUDO_HDR_LEN;
+    sm_pcapng_put_be32(&pseudoHdr[4], pInfo->pollCount);
+    sm_pcapng_put_be32(&pseudoHdr[8], (pInfo->endNs >= pInfo->startNs) ? (pInfo->endNs - pInfo->startNs) : 0);
+    if ((pInfo->readStartNs != 0) && (pInfo->startNs >= pInfo->readStartNs)) {
+        waitNs = pInfo->startNs - pInfo->readStartNs;
+    }
+    sm_pcapng_put_be32(&pseudoHdr[12], waitNs);
+
+    /* Enhanced packet block with the direction as epb_flags */
+    blockLen = sizeof(epb) + SM_PCAPNG_PAD4(packetLen) + 4 + sizeof(flags) + 4 + sizeof(blockLen);
+    flags    = (pInfo->direction == PH_PAL_ESE_TAP_DIR_RX) ? SM_PCAPNG_EPB_INBOUND : SM_PCAPNG_EPB_OUTBOUND;
+    epb[0]   = SM_PCAPNG_BLOCK_EPB;
+    epb[1]   = blockLen;
+    epb[2]   = 0; /* Interface */
+    epb[3]   = (uint32_t)(pInfo->startNs >> 32);
+    epb[4]   = (uint32_t)(pInfo->startNs);
+    epb[5]   = packetLen;
+    epb[6]   = packetLen;
+    if (fwrite(epb, 1, sizeof(epb), pCtx->pFile) != sizeof(epb)) {
+        goto error;
+    }
+    if (fwrite(pseudoHdr, 1, sizeof(pseudoHdr), pCtx->pFile) != sizeof(pseudoHdr)) {
+        goto error;
+    }
+    for (i = 0; i < iovCnt; i++) {
+        if ((pIov[i].len > 0) && (fwrite(pIov[i].pData, 1, pIov[i].len, pCtx->pFile) != pIov[i].len)) {
+            goto error;
+        }
+    }
+    if ((sm_pcapng_write_padding(pCtx, packetLen) != 0) ||
+        (sm_pcapng_write_option(pCtx, SM_PCAPNG_OPT_EPB_FLAGS, &flags, sizeof(flags)) != 0) ||
+        (sm_pcapng_write_option(pCtx, SM_PCAPNG_OPT_ENDOFOPT, NULL, 0) != 0) ||
+        (sm_pcapng_write(pCtx, &blockLen, sizeof(blockLen)) != 0)) {
+        goto error;
+    }
+    return;
+
+error:
+    SMLOG_E("PCAPNG: Error in writing frame, capture stopped \n");
+    pCtx->isFailed = 1;
+}
+
+/**
+* Flushes and closes the capture file
+*/
+static void sm_pcapng_tap_release(void *pTapCtx)
+{
+    sm_pcapng_tap_ctx_t *pCtx = (sm_pcapng_tap_ctx_t *)pTapCtx;
+
+    if (pCtx == NULL) {
+        return;
+    }
+    if (pCtx->pFile != NULL) {
+        if (fclose(pCtx->pFile) != 0) {
+            SMLOG_E("PCAPNG: Error in closing capture file \n");
+        }
+    }
+    if (pCtx->pFileBuff != NULL) {
+        sm_free(pCtx->pFileBuff);
+    }
+    sm_free(pCtx);
+}
+
+/**
+* Creates the capture file and sets up the tap
+*/
+ESESTATUS sm_pcapng_tap_open(phPalEse_FrameTap_t *pTap, const char *pFileName)
+{
+    sm_pcapng_tap_ctx_t *pCtx = NULL;
+
+    if ((pTap == NULL) || (pFileName == NULL)) {
+        return ESESTATUS_INVALID_PARAMETER;
+    }
+
+    pCtx = (sm_pcapng_tap_ctx_t *)sm_malloc(sizeof(sm_pcapng_tap_ctx_t));
+    if (pCtx == NULL) {
+        SMLOG_E("PCAPNG: Error in allocating context \n");
+        return ESESTATUS_INSUFFICIENT_RESOURCES;
+    }
+    memset(pCtx, 0, sizeof(*pCtx));
+
+    pCtx->pFile = fopen(pFileName, "wb");
+    if (pCtx->pFile == NULL) {
+        SMLOG_E("PCAPNG: Error in creating %s \n", pFileName);
+        goto error;
+    }
+    /* Keep file writes out of the timing of the frames */
+    pCtx->pFileBuff = (char *)sm_malloc(SM_PCAPNG_FILE_BUFFER);
+    if (pCtx->pFileBuff != NULL) {
+        setvbuf(pCtx->pFile, pCtx->pFileBuff, _IOFBF, SM_PCAPNG_FILE_BUFFER);
+    }
+    if (sm_pcapng_write_header(pCtx) != 0) {
+        SMLOG_E("PCAPNG: Error in writing header of %s \n", pFileName);
+        goto error;
+    }
+
+    pTap->record  = &sm_pcapng_tap_record;
+    pTap->release = &sm_pcapng_tap_release;
+    pTap->pTapCtx = pCtx;
+    return ESESTATUS_SUCCESS;
+
+error:
+    sm_pcapng_tap_release(pCtx);
+    return ESESTATUS_FAILED;
+}
@@ -0,0 +1,52 @@
+/** @file sm_pcapng.h
+ *  @brief Frame tap writing T=1oI2C frames to a pcapng capture file.
+ *
+ * Copyright 2024 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SM_PCAPNG_H_INC
+#define SM_PCAPNG_H_INC
+
+/* ********************** Include files ********************** */
+#include "phNxpEsePal_i2c.h"
+
+/* ********************** Defines ********************** */
+
+/* Link type of the capture interface (LINKTYPE_USER0). Map it to the
+ * "t1oi2c" dissector of sm_pcapng.lua in the DLT_USER table of Wireshark. */
+#define SM_PCAPNG_LINKTYPE 147
+
+/* Every packet starts with a pseudo header, followed by the raw frame
+ * (NAD, PCB, LEN, INF, CRC). All fields are big endian:
+ *
+ *   Offset  Size  Field
+ *   0       1     Version, SM_PCAPNG_PSEUDO_HDR_VERSION
+ *   1       1     Direction, 0: host to SE, 1: SE to host
+ *   2       2     Length of the pseudo header, SM_PCAPNG_PSEUDO_HDR_LEN
+ *   4       4     Polls of the SE until the frame was read, 0 for a written frame
+ *   8       4     Duration of the I2C transfer(s) of the frame in ns
+ *   12      4     Frame read from the SE: time from the start of the read to
+ *                 the start of the successful poll in ns, 0 for a written frame
+ *
+ * The packet time stamp is the start of the I2C transfer(s) of the frame,
+ * CLOCK_MONOTONIC in ns. The interface time offset maps it to wall clock time.
+ * Durations above 4.29s are saturated. */
+#define SM_PCAPNG_PSEUDO_HDR_VERSION 1
+#define SM_PCAPNG_PSEUDO_HDR_LEN 16
+
+/* ********************** Function Prototypes ********************** */
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/* Sets up a frame tap writing the frames of a connection to a new pcapng file.
+ * Frames are buffered, the file is complete once the tap is released
+ * (connection closed or tap replaced). */
+ESESTATUS sm_pcapng_tap_open(phPalEse_FrameTap_t *pTap, const char *pFileName);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif //#ifndef SM_PCAPNG_H_INC
@@ -0,0 +1,90 @@
+-- @file sm_pcapng.lua
+-- @brief Wireshark dissector for T=1oI2C captures written by sm_pcapng.c
+--
+-- Copyright 2024 NXP
+-- SPDX-License-Identifier: Apache-2.0
+--
+-- Usage: wireshark -X lua_script:sm_pcapng.lua capture.pcapng
+-- The dissector registers for LINKTYPE_USER0 (147, DLT_USER 0).
+-- Set the "Protocol variant" preference to GP 1.0 for captures of a
+-- T1oI2C_GP1_0 build (2 byte LEN field).
+
+local t1oi2c = Proto("t1oi2c", "SE05x T=1 over I2C")
+
+local directions = {[0] = "Host to SE", [1] = "SE to host"}
+
+local f_version  = ProtoField.uint8("t1oi2c.version", "Capture version")
+local f_dir      = ProtoField.uint8("t1oi2c.dir", "Direction", base.DEC, directions)
+local f_hdrlen   = ProtoField.uint16("t1oi2c.hdrlen", "Pseudo header length")
+local f_polls    = ProtoField.uint32("t1oi2c.polls", "Polls until read")
+local f_xfer     = ProtoField.uint32("t1oi2c.xfer_ns", "I2C transfer time (ns)")
+local f_wait     = ProtoField.uint32("t1oi2c.wait_ns", "Wait before read (ns)")
+local f_nad      = ProtoField.uint8("t1oi2c.nad", "NAD", base.HEX)
+local f_pcb      = ProtoField.uint8("t1oi2c.pcb", "PCB", base.HEX)
+local f_type     = ProtoField.string("t1oi2c.type", "Block")
+local f_len      = ProtoField.uint16("t1oi2c.len", "LEN")
+local f_inf      = ProtoField.bytes("t1oi2c.inf", "INF")
+local f_crc      = ProtoField.uint16("t1oi2c.crc", "CRC", base.HEX)
+
+t1oi2c.fields = {f_version, f_dir, f_hdrlen, f_polls, f_xfer, f_wait, f_nad, f_pcb, f_type, f_len, f_inf, f_crc}
+
+t1oi2c.prefs.gp = Pref.bool("Protocol variant GP 1.0", false, "2 byte LEN field (T1oI2C_GP1_0)")
+
+local s_blocks = {
+    [0x00] = "RESYNCH", [0x01] = "IFS", [0x02] = "ABORT", [0x03] = "WTX", [0x0F] = "RESET", [0x1F] = "DEEP POWER DOWN",
+}
+local s_blocks_um11225 = {[0x05] = "END OF APDU", [0x06] = "CHIP RESET", [0x07] = "GET ATR"}
+local s_blocks_gp = {[0x04] = "GET CIP", [0x06] = "RELEASE", [0x1E] = "COLD RESET"}
+
+local function block_name(pcb)
+    if bit.band(pcb, 0x80) == 0 then
+        local name = string.format("I(%d)", bit.band(bit.rshift(pcb, 6), 1))
+        if bit.band(pcb, 0x20) ~= 0 then
+            name = name .. " chained"
+        end
+        return name
+    elseif bit.band(pcb, 0xC0) == 0x80 then
+        local errors = {[0] = "ACK", [1] = "NACK CRC", [2] = "NACK other"}
+        return string.format("R(%d) %s", bit.band(bit.rshift(pcb, 4), 1), errors[bit.band(pcb, 0x03)] or "?")
+    end
+    local code = bit.band(pcb, 0x1F)
+    local variant = t1oi2c.prefs.gp and s_blocks_gp or s_blocks_um11225
+    local name = s_blocks[code] or variant[code] or string.format("0x%02X", code)
+    if bit.band(pcb, 0x20) ~= 0 then
+        return "S(" .. name .. " response)"
+    end
+    return "S(" .. name .. " request)"
+end
+
+function t1oi2c.dissector(tvb, pinfo, tree)
+    local hdrLen = tvb(2, 2):uint()
+    local frame  = tvb(hdrLen)
+    local lenLen = t1oi2c.prefs.gp and 2 or 1
+    local subtree = tree:add(t1oi2c, tvb(), "SE05x T=1 over I2C")
+
+    pinfo.cols.protocol = "T=1oI2C"
+    subtree:add(f_version, tvb(0, 1))
+    subtree:add(f_dir, tvb(1, 1))
+    subtree:add(f_hdrlen, tvb(2, 2))
+    subtree:add(f_polls, tvb(4, 4))
+    subtree:add(f_xfer, tvb(8, 4))
+    subtree:add(f_wait, tvb(12, 4))
+
+    if frame:len() < (2 + lenLen + 2) then
+        pinfo.cols.info = directions[tvb(1, 1):uint()] .. " short frame"
+        return
+    end
+    local pcb    = frame(1, 1):uint()
+    local infLen = frame(2, lenLen):uint()
+    subtree:add(f_nad, frame(0, 1))
+    subtree:add(f_pcb, frame(1, 1))
+    subtree:add(f_type, frame(1, 1), block_name(pcb))
+    subtree:add(f_len, frame(2, lenLen))
+    if infLen > 0 and frame:len() >= (2 + lenLen + infLen + 2) then
+        subtree:add(f_inf, frame(2 + lenLen, infLen))
+    end
+    subtree:add_le(f_crc, frame(frame:len() - 2, 2))
+    pinfo.cols.info = string.format("%s %s LEN=%d", directions[tvb(1, 1):uint()], block_name(pcb), infLen)
+end
+
+DissectorTable.get("wtap_encap"):add(wtap.USER0, t1oi2c)
@@ -1,7 +1,7 @@
 /** @file sm_port.h
  *  @brief Platform specific content.
  *
- * Copyright 2021,2022 NXP
+ * Copyright 2021,2022,2024 NXP
  * SPDX-License-Identifier: Apache-2.0
  */
 
@@ -67,12 +67,22 @@
 #define sm_malloc malloc
 #define sm_free free
 
-#define SM_MUTEX_DEFINE(x) pthread_mutex_t x
+#define SM_MUTEX_DEFINE(x) pthread_mutex_t x = PTHREAD_MUTEX_INITIALIZER
 #define SM_MUTEX_INIT(x) ENSURE_OR_RETURN_ON_ERROR(pthread_mutex_init(&x, NULL) == 0, SM_NOT_OK)
 #define SM_MUTEX_DEINIT(x) ENSURE_OR_RETURN_ON_ERROR(pthread_mutex_destroy(&x) == 0, SM_NOT_OK)
 #define SM_MUTEX_LOCK(x) ENSURE_OR_RETURN_ON_ERROR(pthread_mutex_lock(&x) == 0, SM_NOT_OK)
 #define SM_MUTEX_UNLOCK(x) ENSURE_OR_RETURN_ON_ERROR(pthread_mutex_unlock(&x) == 0, SM_NOT_OK)
 
+#define SM_MUTEX_TYPE pthread_mutex_t
+#define SM_COND_TYPE pthread_cond_t
+#define SM_COND_INIT(x) ENSURE_OR_RETURN_ON_ERROR(pthread_cond_init(&x, NULL) == 0, SM_NOT_OK)
+#define SM_COND_DEINIT(x) ENSURE_OR_RETURN_ON_ERROR(pthread_cond_destroy(&x) == 0, SM_NOT_OK)
+#define SM_COND_WAIT(x, m) ENSURE_OR_RETURN_ON_ERROR(pthread_cond_wait(&x, &m) == 0, SM_NOT_OK)
+#define SM_COND_BROADCAST(x) ENSURE_OR_RETURN_ON_ERROR(pthread_cond_broadcast(&x) == 0, SM_NOT_OK)
+
+/* Pinning and SCHED_FIFO of the I/O thread (sm_thread.h) is available on this platform */
+#define SM_HAVE_THREAD_SCHED
+
 #ifndef FALSE
 #define FALSE false
 #endif
@@ -0,0 +1,267 @@
+/** @file sm_socket.c
+ *  @brief UNIX socket transport of T=1oI2C frames.
+ *
+ * Copyright 2024 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* ********************** Include files ********************** */
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include "sm_socket.h"
+#include "sm_port.h"
+
+/* ********************** Defines ********************** */
+/* Max number of pieces of one gathered write */
+#define SM_SOCKET_MAX_IOV 8
+
+/* ********************** Data types ********************** */
+
+/* Per connection socket transport context */
+typedef struct
+{
+    int fd; /* File descriptor of the connected socket */
+} sm_socket_ctx_t;
+
+/* ********************** Functions ********************** */
+
+/**
+* Sends all pieces, without raising SIGPIPE when the peer is gone
+*/
+static ESESTATUS sm_socket_send(sm_socket_ctx_t *pCtx, struct iovec *pIov, int iovCnt)
+{
+    struct msghdr msg = {0};
+    ssize_t nrSent    = 0;
+
+    msg.msg_iov    = pIov;
+    msg.msg_iovlen = iovCnt;
+    while (msg.msg_iovlen > 0) {
+        nrSent = sendmsg(pCtx->fd, &msg, MSG_NOSIGNAL);
+        if (nrSent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            SMLOG_E("SOCKET: send failed (errno=%d) \n", errno);
+            return ESESTATUS_FAILED;
+        }
+        /* Skip what was sent */
+        while ((msg.msg_iovlen > 0) && ((size_t)nrSent >= msg.msg_iov->iov_len)) {
+            nrSent -= (ssize_t)msg.msg_iov->iov_len;
+            msg.msg_iov++;
+            msg.msg_iovlen--;
+        }
+        if (msg.msg_iovlen > 0) {
+            msg.msg_iov->iov_base = (uint8_t *)msg.msg_iov->iov_base + nrSent;
+            msg.msg_iov->iov_len -= (size_t)nrSent;
+        }
+    }
+    return ESESTATUS_SUCCESS;
+}
+
+/**
+* Receives exactly len bytes
+*/
+static ESESTATUS sm_socket_recv(sm_socket_ctx_t *pCtx, uint8_t *pBuffer, uint32_t len)
+{
+    ssize_t nrRead = 0;
+
+    while (len > 0) {
+        nrRead = recv(pCtx->fd, pBuffer, len, 0);
+        if (nrRead < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            SMLOG_E("SOCKET: receive failed (errno=%d) \n", errno);
+            return ESESTATUS_FAILED;
+        }
+        if (nrRead == 0) {
+            SMLOG_E("SOCKET: connection closed by peer \n");
+            return ESESTATUS_FAILED;
+        }
+        pBuffer += nrRead;
+        len -= (uint32_t)nrRead;
+    }
+    return ESESTATUS_SUCCESS;
+}
+
+/**
+* Receives the status of a request
+*/
+static ESESTATUS sm_socket_recv_status(sm_socket_ctx_t *pCtx)
+{
+    uint8_t status = SM_SOCKET_STATUS_FAILED;
+
+    if (sm_socket_recv(pCtx, &status, 1) != ESESTATUS_SUCCESS) {
+        return ESESTATUS_FAILED;
+    }
+    if (status == SM_SOCKET_STATUS_OK) {
+        return ESESTATUS_SUCCESS;
+    }
+    else if (status == SM_SOCKET_STATUS_NACK) {
+        return ESESTATUS_BUSY;
+    }
+    return ESESTATUS_FAILED;
+}
+
+/**
+* Sends a read request and receives the data into one or two buffers
+*/
+static ESESTATUS sm_socket_read_parts(
+    sm_socket_ctx_t *pCtx, uint8_t *pFirst, uint32_t firstLen, uint8_t *pSecond, uint32_t secondLen)
+{
+    ESESTATUS status                         = ESESTATUS_FAILED;
+    uint32_t len                             = firstLen + secondLen;
+    uint8_t header[SM_SOCKET_REQ_HEADER_LEN] = {SM_SOCKET_OP_READ, (uint8_t)(len >> 8), (uint8_t)len};
+    struct iovec iov                         = {header, sizeof(header)};
+
+    if (len > UINT16_MAX) {
+        return ESESTATUS_INVALID_PARAMETER;
+    }
+    status = sm_socket_send(pCtx, &iov, 1);
+    if (status != ESESTATUS_SUCCESS) {
+        return status;
+    }
+    status = sm_socket_recv_status(pCtx);
+    if (status != ESESTATUS_SUCCESS) {
+        return status;
+    }
+    status = sm_socket_recv(pCtx, pFirst, firstLen);
+    if ((status == ESESTATUS_SUCCESS) && (secondLen > 0)) {
+        status = sm_socket_recv(pCtx, pSecond, secondLen);
+    }
+    return status;
+}
+
+/**
+* Connects to the socket given by the connection string
+*/
+static ESESTATUS sm_socket_open(void **ppTransportCtx, const char *pConnString)
+{
+    struct sockaddr_un addr = {0};
+    sm_socket_ctx_t *pCtx   = NULL;
+
+    if ((ppTransportCtx == NULL) || (pConnString == NULL) || (pConnString[0] == '\0') ||
+        (strlen(pConnString) >= sizeof(addr.sun_path))) {
+        SMLOG_E("SOCKET: Invalid socket path \n");
+        return ESESTATUS_INVALID_PARAMETER;
+    }
+
+    pCtx = (sm_socket_ctx_t *)sm_malloc(sizeof(sm_socket_ctx_t));
+    if (pCtx == NULL) {
+        SMLOG_E("SOCKET: Error in allocating context \n");
+        return ESESTATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    pCtx->fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (pCtx->fd < 0) {
+        SMLOG_E("SOCKET: Error in creating socket \n");
+        goto error;
+    }
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, pConnString, sizeof(addr.sun_path) - 1);
+    if (connect(pCtx->fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        SMLOG_E("SOCKET: Error in connecting to %s (errno=%d) \n", pConnString, errno);
+        goto error;
+    }
+
+    *ppTransportCtx = pCtx;
+    return ESESTATUS_SUCCESS;
+
+error:
+    if (pCtx->fd >= 0) {
+        close(pCtx->fd);
+    }
+    sm_free(pCtx);
+    return ESESTATUS_INVALID_DEVICE;
+}
+
+/**
+* Closes the socket
+*/
+static void sm_socket_close(void *pTransportCtx)
+{
+    sm_socket_ctx_t *pCtx = (sm_socket_ctx_t *)pTransportCtx;
+
+    if (pCtx == NULL) {
+        return;
+    }
+    if (pCtx->fd >= 0) {
+        close(pCtx->fd);
+    }
+    sm_free(pCtx);
+}
+
+/**
+* Reads len bytes from the peer
+*/
+static ESESTATUS sm_socket_read(void *pTransportCtx, uint8_t *pBuffer, uint32_t len)
+{
+    return sm_socket_read_parts((sm_socket_ctx_t *)pTransportCtx, pBuffer, len, NULL, 0);
+}
+
+/**
+* Reads header and body of a frame with one request
+*/
+static ESESTATUS sm_socket_read_frame(
+    void *pTransportCtx, uint8_t *pHeader, uint32_t headerLen, uint8_t *pBody, uint32_t bodyLen)
+{
+    return sm_socket_read_parts((sm_socket_ctx_t *)pTransportCtx, pHeader, headerLen, pBody, bodyLen);
+}
+
+/**
+* Writes the pieces of a frame with one request
+*/
+static ESESTATUS sm_socket_writev(void *pTransportCtx, const phPalEse_IoVec_t *pIov, uint8_t iovCnt)
+{
+    ESESTATUS status                         = ESESTATUS_FAILED;
+    sm_socket_ctx_t *pCtx                    = (sm_socket_ctx_t *)pTransportCtx;
+    uint8_t header[SM_SOCKET_REQ_HEADER_LEN] = {SM_SOCKET_OP_WRITE, 0, 0};
+    struct iovec iov[1 + SM_SOCKET_MAX_IOV];
+    uint32_t len = 0;
+    uint8_t i    = 0;
+
+    if (iovCnt > SM_SOCKET_MAX_IOV) {
+        return ESESTATUS_FEATURE_NOT_SUPPORTED;
+    }
+    iov[0].iov_base = header;
+    iov[0].iov_len  = sizeof(header);
+    for (i = 0; i < iovCnt; i++) {
+        iov[1 + i].iov_base = (void *)pIov[i].pData;
+        iov[1 + i].iov_len  = pIov[i].len;
+        len += pIov[i].len;
+    }
+    if (len > UINT16_MAX) {
+        return ESESTATUS_INVALID_PARAMETER;
+    }
+    header[1] = (uint8_t)(len >> 8);
+    header[2] = (uint8_t)len;
+
+    status = sm_socket_send(pCtx, iov, 1 + iovCnt);
+    if (status != ESESTATUS_SUCCESS) {
+        return status;
+    }
+    return sm_socket_recv_status(pCtx);
+}
+
+/**
+* Writes len bytes to the peer
+*/
+static ESESTATUS sm_socket_write(void *pTransportCtx, const uint8_t *pBuffer, uint32_t len)
+{
+    phPalEse_IoVec_t iov = {pBuffer, len};
+    return sm_socket_writev(pTransportCtx, &iov, 1);
+}
+
+const phPalEse_Transport_t sm_socket_transport = {
+    SM_SOCKET_SCHEME,
+    &sm_socket_open,
+    &sm_socket_close,
+    &sm_socket_read,
+    &sm_socket_write,
+    &sm_socket_read_frame,
+    &sm_socket_writev,
+};
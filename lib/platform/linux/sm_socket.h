@@ -0,0 +1,48 @@
+/** @file sm_socket.h
+ *  @brief UNIX socket transport of T=1oI2C frames.
+ *
+ * Copyright 2024 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SM_SOCKET_H_INC
+#define SM_SOCKET_H_INC
+
+/* ********************** Include files ********************** */
+#include "phNxpEsePal_i2c.h"
+
+/* ********************** Defines ********************** */
+
+/* Connection string prefix of the transport, followed by the path of the socket,
+ * e.g. "unix:/tmp/se05x.sock" */
+#define SM_SOCKET_SCHEME "unix:"
+
+/* The transport connects to a SOCK_STREAM socket. Every I2C transfer of the
+ * host is one request, answered by the peer (e.g. a simulated SE) with one response.
+ *
+ *   Request:  Operation (1 byte), Length (2 bytes, big endian), Data (write only)
+ *   Response: Status (1 byte), Data (read with SM_SOCKET_STATUS_OK only)
+ *
+ * Length is the number of bytes written or to be read. */
+#define SM_SOCKET_OP_WRITE 0x57 /* 'W' */
+#define SM_SOCKET_OP_READ 0x52  /* 'R' */
+
+#define SM_SOCKET_STATUS_OK 0x00
+#define SM_SOCKET_STATUS_NACK 0x01 /* SE busy, nothing to read (I2C NACK) */
+#define SM_SOCKET_STATUS_FAILED 0x02
+
+#define SM_SOCKET_REQ_HEADER_LEN 3
+
+/* ********************** Data types ********************** */
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/* Transport selected with SM_SOCKET_SCHEME */
+extern const phPalEse_Transport_t sm_socket_transport;
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif //#ifndef SM_SOCKET_H_INC
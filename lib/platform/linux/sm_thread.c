@@ -0,0 +1,108 @@
+/** @file sm_thread.c
+ *  @brief CPU affinity and real-time scheduling of the I/O thread.
+ *
+ * Copyright 2024 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* ********************** Include files ********************** */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* CPU_SET, pthread_setaffinity_np */
+#endif
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include "sm_thread.h"
+#include "sm_port.h"
+
+/* ********************** Data types ********************** */
+
+struct sm_thread_saved
+{
+    pthread_t thread;
+    cpu_set_t cpuSet;
+    int policy;
+    struct sched_param param;
+};
+
+/* ********************** Functions ********************** */
+
+int sm_thread_set_sched(int cpu, int fifoPriority, sm_thread_saved_t **ppSaved)
+{
+    int ret                   = 0;
+    cpu_set_t cpuSet;
+    struct sched_param param  = {0};
+    sm_thread_saved_t *pSaved = NULL;
+
+    if ((ppSaved == NULL) || ((cpu != SM_THREAD_CPU_ANY) && ((cpu < 0) || (cpu >= CPU_SETSIZE)))) {
+        return EINVAL;
+    }
+    if ((fifoPriority != 0) && ((fifoPriority < sched_get_priority_min(SCHED_FIFO)) ||
+                                   (fifoPriority > sched_get_priority_max(SCHED_FIFO)))) {
+        return EINVAL;
+    }
+
+    pSaved = (sm_thread_saved_t *)sm_malloc(sizeof(*pSaved));
+    if (pSaved == NULL) {
+        return ENOMEM;
+    }
+    pSaved->thread = pthread_self();
+    ret            = pthread_getaffinity_np(pSaved->thread, sizeof(pSaved->cpuSet), &pSaved->cpuSet);
+    if (ret == 0) {
+        ret = pthread_getschedparam(pSaved->thread, &pSaved->policy, &pSaved->param);
+    }
+    if (ret != 0) {
+        SMLOG_E("Error in reading the scheduling of the thread (%s) \n", strerror(ret));
+        sm_free(pSaved);
+        return ret;
+    }
+
+    if (cpu != SM_THREAD_CPU_ANY) {
+        CPU_ZERO(&cpuSet);
+        CPU_SET(cpu, &cpuSet);
+        ret = pthread_setaffinity_np(pSaved->thread, sizeof(cpuSet), &cpuSet);
+        if (ret != 0) {
+            SMLOG_E("Error in pinning the thread to CPU %d (%s) \n", cpu, strerror(ret));
+            sm_free(pSaved);
+            return ret;
+        }
+    }
+
+    if (fifoPriority != 0) {
+        param.sched_priority = fifoPriority;
+        ret                  = pthread_setschedparam(pSaved->thread, SCHED_FIFO, &param);
+        if (ret != 0) {
+            SMLOG_E("Error in setting SCHED_FIFO priority %d (%s) \n", fifoPriority, strerror(ret));
+            pthread_setaffinity_np(pSaved->thread, sizeof(pSaved->cpuSet), &pSaved->cpuSet);
+            sm_free(pSaved);
+            return ret;
+        }
+    }
+    *ppSaved = pSaved;
+    return 0;
+}
+
+void sm_thread_restore_sched(sm_thread_saved_t *pSaved)
+{
+    int ret = 0;
+
+    if (pSaved == NULL) {
+        return;
+    }
+    if (!pthread_equal(pSaved->thread, pthread_self())) {
+        SMLOG_W("Scheduling of the thread not restored, closed from another thread \n");
+        sm_free(pSaved);
+        return;
+    }
+    /* Policy first, the thread leaves SCHED_FIFO before it may share a CPU again */
+    ret = pthread_setschedparam(pSaved->thread, pSaved->policy, &pSaved->param);
+    if (ret != 0) {
+        SMLOG_E("Error in restoring the scheduling policy (%s) \n", strerror(ret));
+    }
+    ret = pthread_setaffinity_np(pSaved->thread, sizeof(pSaved->cpuSet), &pSaved->cpuSet);
+    if (ret != 0) {
+        SMLOG_E("Error in restoring the CPU affinity (%s) \n", strerror(ret));
+    }
+    sm_free(pSaved);
+}
@@ -0,0 +1,43 @@
+/** @file sm_thread.h
+ *  @brief CPU affinity and real-time scheduling of the I/O thread.
+ *
+ * Copyright 2024 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SM_THREAD_H_INC
+#define SM_THREAD_H_INC
+
+/* ********************** Defines ********************** */
+
+/* Keep the CPU affinity of the thread */
+#define SM_THREAD_CPU_ANY (-1)
+
+/* ********************** Data types ********************** */
+
+/* Scheduling of a thread before sm_thread_set_sched, see sm_thread_restore_sched */
+typedef struct sm_thread_saved sm_thread_saved_t;
+
+/* ********************** Function Prototypes ********************** */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Pins the calling thread to cpu and runs it with SCHED_FIFO at fifoPriority.
+ * SM_THREAD_CPU_ANY keeps the affinity, fifoPriority 0 keeps the policy.
+ * SCHED_FIFO needs CAP_SYS_NICE. The previous affinity and policy are returned
+ * in *ppSaved, nothing is changed on error.
+ * Returns 0 on success, an errno value otherwise. */
+int sm_thread_set_sched(int cpu, int fifoPriority, sm_thread_saved_t **ppSaved);
+
+/* Restores the scheduling saved by sm_thread_set_sched and frees pSaved. Only
+ * applied when called from the same thread, the thread may have ended otherwise.
+ * NULL is ignored. */
+void sm_thread_restore_sched(sm_thread_saved_t *pSaved);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //#ifndef SM_THREAD_H_INC
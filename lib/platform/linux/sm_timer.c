@@ -41,3 +41,27 @@ void sm_usleep(uint32_t microsec)
 {
     usleep(microsec);
 }
+
+/**
+ * Return a monotonic time stamp in microseconds
+ */
+uint64_t sm_get_time_us(void)
+{
+    struct timespec ts = {0};
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+        return 0;
+    }
+    return ((uint64_t)ts.tv_sec * 1000000u) + ((uint64_t)ts.tv_nsec / 1000u);
+}
+
+/**
+ * Return a monotonic time stamp in nanoseconds
+ */
+uint64_t sm_get_time_ns(void)
+{
+    struct timespec ts = {0};
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+        return 0;
+    }
+    return ((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec;
+}
@@ -11,6 +11,7 @@
 /* ********************** Include files ********************** */
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <errno.h>
 #include "fsl_debug_console.h"
 
@@ -75,6 +76,13 @@
 #define SM_MUTEX_LOCK(x)
 #define SM_MUTEX_UNLOCK(x)
 
+#define SM_MUTEX_TYPE uint8_t
+#define SM_COND_TYPE uint8_t
+#define SM_COND_INIT(x)
+#define SM_COND_DEINIT(x)
+#define SM_COND_WAIT(x, m)
+#define SM_COND_BROADCAST(x)
+
 #ifndef FALSE
 #define FALSE false
 #endif
@@ -26,6 +26,10 @@ extern "C" {
 uint32_t sm_initSleep(void);
 void sm_sleep(uint32_t msec);
 void sm_usleep(uint32_t microsec);
+/* monotonic time stamp in microseconds, used for measurements */
+uint64_t sm_get_time_us(void);
+/* monotonic time stamp in nanoseconds, used for frame captures */
+uint64_t sm_get_time_ns(void);
 
 #ifdef __cplusplus
 }
@@ -37,6 +37,13 @@ LOG_MODULE_DECLARE(plugandtrust, CONFIG_PLUGANDTRUST_LOG_LEVEL);
 #define SM_MUTEX_LOCK(x) k_mutex_lock(&x, K_FOREVER)
 #define SM_MUTEX_UNLOCK(x) k_mutex_unlock(&x)
 
+#define SM_MUTEX_TYPE struct k_mutex
+#define SM_COND_TYPE struct k_condvar
+#define SM_COND_INIT(x) k_condvar_init(&x)
+#define SM_COND_DEINIT(x)
+#define SM_COND_WAIT(x, m) k_condvar_wait(&x, &m, K_FOREVER)
+#define SM_COND_BROADCAST(x) k_condvar_broadcast(&x)
+
 #ifndef FALSE
 #define FALSE false
 #endif
@@ -41,3 +41,19 @@ void sm_usleep(uint32_t microsec)
 {
     k_msleep(microsec / 1000);
 }
+
+/**
+ * Return a monotonic time stamp in microseconds
+ */
+uint64_t sm_get_time_us(void)
+{
+    return k_ticks_to_us_floor64(k_uptime_ticks());
+}
+
+/**
+ * Return a monotonic time stamp in nanoseconds
+ */
+uint64_t sm_get_time_ns(void)
+{
+    return k_ticks_to_ns_floor64(k_uptime_ticks());
+}
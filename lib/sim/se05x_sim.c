@@ -0,0 +1,611 @@
+/** @file se05x_sim.c
+ *  @brief Software SE05x simulator, T=1oI2C link with latency and error injection.
+ *
+ * Copyright 2024 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* ********************** Include files ********************** */
+#include <string.h>
+#include "se05x_sim_internal.h"
+#include "phNxpEseCrc.h"
+#include "sm_port.h"
+#include "sm_timer.h"
+
+/* ********************** Defines ********************** */
+
+#define SE05X_SIM_PCB_R_BLOCK 0x80
+#define SE05X_SIM_PCB_S_MASK 0xE0
+#define SE05X_SIM_PCB_S_CODE_MASK 0x1F
+#define SE05X_SIM_PCB_I_SEQ(pcb) (((pcb) >> 6) & 0x01)
+#define SE05X_SIM_PCB_R_SEQ(pcb) (((pcb) >> 4) & 0x01)
+#define SE05X_SIM_PCB_R_ERR(pcb) ((pcb)&0x0F)
+#define SE05X_SIM_R_ERR_CRC 0x01
+
+#define SE05X_SIM_IFS_DEFAULT 254
+
+/* ********************** Global variables ********************** */
+
+/* clang-format off */
+#if defined(T1oI2C_UM11225)
+/* ATR of the SE05x (UM11225), IFSC at SE05X_SIM_ATR_IFSC_OFFSET */
+static const uint8_t gSe05xSim_atr[] = {
+    0x00, 0xA0, 0x00, 0x00, 0x03, 0x96, 0x04, 0x03, 0xE8, 0x00, 0xFE, 0x02,
+    0x0B, 0x03, 0xE8, 0x08, 0x01, 0x00, 0x00, 0x00, 0x00, 0x64, 0x00, 0x00,
+    0x0A, 0x4A, 0x43, 0x4F, 0x50, 0x34, 0x20, 0x41, 0x54, 0x50, 0x4F};
+#define SE05X_SIM_ATR_IFSC_OFFSET 9
+#elif defined(T1oI2C_GP1_0)
+/* Communication interface parameters (GP T=1oI2C), IFSC at SE05X_SIM_CIP_IFSC_OFFSET */
+static const uint8_t gSe05xSim_cip[] = {
+    0x01, 0x02, 0xAA, 0xBB, 0x02, 0x01, 0x00, 0x04, 0x03, 0xE8, 0x00, 0xFE, 0x00};
+#define SE05X_SIM_CIP_IFSC_OFFSET 10
+#endif
+
+/* Auth public key of the ECKey examples (tests/src/test_se05x.c) */
+static const uint8_t gSe05xSim_ecKeyAuthPub[65] = {
+    0x04, 0x3C, 0x9E, 0x47, 0xED, 0xF0, 0x51, 0xA3, 0x58, 0x9F, 0x67, 0x30, 0x2D,
+    0x22, 0x56, 0x7C, 0x2E, 0x17, 0x22, 0x9E, 0x88, 0x83, 0x33, 0x8E, 0xC3, 0xB7,
+    0xD5, 0x27, 0xF9, 0xEE, 0x71, 0xD0, 0xA8, 0x1A, 0xAE, 0x7F, 0xE2, 0x1C, 0xAA,
+    0x66, 0x77, 0x78, 0x3A, 0xA8, 0x8D, 0xA6, 0xD6, 0xA8, 0xAD, 0x5E, 0xC5, 0x3B,
+    0x10, 0xBC, 0x0B, 0x11, 0x09, 0x44, 0x82, 0xF0, 0x4D, 0x24, 0xB5, 0xBE, 0xC4};
+/* clang-format on */
+
+/* ********************** Functions ********************** */
+
+/**
+* xorshift64, the source of all injected events
+*/
+static uint32_t se05x_sim_random(se05x_sim_t *pSim)
+{
+    uint64_t x = pSim->prng;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    pSim->prng = x;
+    return (uint32_t)(x >> 32);
+}
+
+/**
+* Decides an event with a per mille rate
+*/
+static int se05x_sim_roll(se05x_sim_t *pSim, uint16_t rate)
+{
+    if (rate == SE05X_SIM_RATE_NEVER) {
+        return 0;
+    }
+    if (rate >= SE05X_SIM_RATE_ALWAYS) {
+        return 1;
+    }
+    return (se05x_sim_random(pSim) % SE05X_SIM_RATE_ALWAYS) < rate;
+}
+
+/**
+* Builds a frame of the SE, returns its length
+*/
+static uint32_t se05x_sim_build_frame(uint8_t *pFrame, uint8_t pcb, const uint8_t *pInf, uint32_t infLen)
+{
+    uint16_t crc = 0;
+
+    pFrame[PH_PROPTO_7816_NAD_OFFSET] = SE05X_SIM_NAD_SE;
+    pFrame[PH_PROPTO_7816_PCB_OFFSET] = pcb;
+#if defined(T1oI2C_UM11225)
+    pFrame[PH_PROPTO_7816_FRAME_LENGTH_OFFSET] = (uint8_t)infLen;
+#elif defined(T1oI2C_GP1_0)
+    pFrame[PH_PROPTO_7816_LEN_UPPER_OFFSET] = (uint8_t)(infLen >> 8);
+    pFrame[PH_PROPTO_7816_LEN_LOWER_OFFSET] = (uint8_t)infLen;
+#endif
+    if (infLen > 0) {
+        memcpy(&pFrame[PH_PROTO_7816_HEADER_LEN], pInf, infLen);
+    }
+    crc = phNxpEseCrc_Compute(pFrame, PH_PROTO_7816_HEADER_LEN + infLen);
+#if defined(T1oI2C_UM11225)
+    pFrame[PH_PROTO_7816_HEADER_LEN + infLen]     = (uint8_t)crc;
+    pFrame[PH_PROTO_7816_HEADER_LEN + infLen + 1] = (uint8_t)(crc >> 8);
+#elif defined(T1oI2C_GP1_0)
+    pFrame[PH_PROTO_7816_HEADER_LEN + infLen]     = (uint8_t)(crc >> 8);
+    pFrame[PH_PROTO_7816_HEADER_LEN + infLen + 1] = (uint8_t)crc;
+#endif
+    return PH_PROTO_7816_HEADER_LEN + infLen + PH_PROTO_7816_CRC_LEN;
+}
+
+/**
+* Checks NAD, length and CRC of a frame of the host, returns the length of its information field or -1
+*/
+static int se05x_sim_check_frame(const uint8_t *pFrame, uint32_t len)
+{
+    uint32_t infLen = 0;
+    uint16_t crc    = 0;
+    uint16_t rxCrc  = 0;
+
+    if ((len < PH_PROTO_7816_HEADER_LEN + PH_PROTO_7816_CRC_LEN) ||
+        (pFrame[PH_PROPTO_7816_NAD_OFFSET] != SE05X_SIM_NAD_HOST)) {
+        return -1;
+    }
+#if defined(T1oI2C_UM11225)
+    infLen = pFrame[PH_PROPTO_7816_FRAME_LENGTH_OFFSET];
+#elif defined(T1oI2C_GP1_0)
+    infLen = ((uint32_t)pFrame[PH_PROPTO_7816_LEN_UPPER_OFFSET] << 8) | pFrame[PH_PROPTO_7816_LEN_LOWER_OFFSET];
+#endif
+    if (len != PH_PROTO_7816_HEADER_LEN + infLen + PH_PROTO_7816_CRC_LEN) {
+        return -1;
+    }
+    crc = phNxpEseCrc_Compute(pFrame, PH_PROTO_7816_HEADER_LEN + infLen);
+#if defined(T1oI2C_UM11225)
+    rxCrc = (uint16_t)(pFrame[len - 2] | (pFrame[len - 1] << 8));
+#elif defined(T1oI2C_GP1_0)
+    rxCrc = (uint16_t)((pFrame[len - 2] << 8) | pFrame[len - 1]);
+#endif
+    if (crc != rxCrc) {
+        return -1;
+    }
+    return (int)infLen;
+}
+
+/**
+* Makes a frame pending for the host
+*/
+static void se05x_sim_queue(se05x_sim_t *pSim, const uint8_t *pFrame, uint32_t len)
+{
+    memcpy(pSim->out, pFrame, len);
+    pSim->outLen = len;
+    pSim->outPos = 0;
+}
+
+/**
+* Sends an S-block, never disturbed
+*/
+static void se05x_sim_send_s_block(se05x_sim_t *pSim, uint8_t pcb, const uint8_t *pInf, uint32_t infLen)
+{
+    pSim->outLen = se05x_sim_build_frame(pSim->out, pcb, pInf, infLen);
+    pSim->outPos = 0;
+}
+
+/**
+* Sends an R-block, kept for a retransmission request of the host
+*/
+static void se05x_sim_send_r_block(se05x_sim_t *pSim, uint8_t seq, uint8_t err)
+{
+    pSim->lastTxLen      = se05x_sim_build_frame(pSim->lastTx, SE05X_SIM_PCB_R_BLOCK | (seq << 4) | err, NULL, 0);
+    pSim->lastTxIsIBlock = 0;
+    se05x_sim_queue(pSim, pSim->lastTx, pSim->lastTxLen);
+}
+
+/**
+* Sends the kept I-block, subject to error injection
+*/
+static void se05x_sim_send_i_block(se05x_sim_t *pSim)
+{
+    uint8_t frame[SE05X_SIM_MAX_FRAME_LEN];
+
+    if (se05x_sim_roll(pSim, pSim->config.dropRate)) {
+        pSim->stats.framesDropped++;
+        return;
+    }
+    memcpy(frame, pSim->lastTx, pSim->lastTxLen);
+    if (se05x_sim_roll(pSim, pSim->config.crcErrorRate)) {
+        frame[pSim->lastTxLen - 1] ^= 0xFF;
+        pSim->stats.crcErrorsInjected++;
+    }
+    se05x_sim_queue(pSim, frame, pSim->lastTxLen);
+}
+
+/**
+* Sends the last I- or R-block again
+*/
+static void se05x_sim_resend(se05x_sim_t *pSim)
+{
+    if (pSim->lastTxLen == 0) {
+        return;
+    }
+    pSim->stats.resends++;
+    if (pSim->lastTxIsIBlock) {
+        se05x_sim_send_i_block(pSim);
+    }
+    else {
+        se05x_sim_queue(pSim, pSim->lastTx, pSim->lastTxLen);
+    }
+}
+
+/**
+* Sends the next chunk of the response as I-block
+*/
+static void se05x_sim_send_chunk(se05x_sim_t *pSim)
+{
+    size_t chunkLen = pSim->rspLen - pSim->rspSent;
+    uint8_t pcb     = 0;
+
+    if (chunkLen > pSim->ifsd) {
+        chunkLen = pSim->ifsd;
+        pcb |= PH_PROTO_7816_CHAINING;
+    }
+    pcb |= (uint8_t)(pSim->seqTx << 6);
+    pSim->lastTxLen      = se05x_sim_build_frame(pSim->lastTx, pcb, &pSim->rsp[pSim->rspSent], (uint32_t)chunkLen);
+    pSim->lastTxIsIBlock = 1;
+    pSim->seqTx ^= 1;
+    pSim->rspSent += chunkLen;
+    if (pSim->rspSent == pSim->rspLen) {
+        pSim->linkState = kSe05xSimLink_Idle;
+    }
+    se05x_sim_send_i_block(pSim);
+}
+
+/**
+* Processes a complete command APDU and schedules the response
+*/
+static void se05x_sim_process_apdu(se05x_sim_t *pSim)
+{
+    uint16_t sw        = SE05X_SIM_SW_WRONG_LENGTH;
+    uint32_t latencyUs = 0;
+    uint64_t totalUs   = 0;
+    uint8_t wtxCount   = 0;
+    size_t cmdLen      = pSim->cmdLen;
+
+    pSim->stats.apdus++;
+    pSim->rspLen     = sizeof(pSim->rsp) - 2;
+    pSim->latencyIns = 0;
+    if (pSim->cmdOverflow) {
+        pSim->rspLen = 0;
+    }
+    else {
+        sw = se05x_sim_scp_process(pSim, pSim->cmd, pSim->cmdLen, pSim->rsp, &pSim->rspLen);
+    }
+    if (sw != SE05X_SIM_SW_OK) {
+        pSim->rspLen = 0;
+    }
+    pSim->rspLen += se05x_sim_put_sw(&pSim->rsp[pSim->rspLen], sizeof(pSim->rsp) - pSim->rspLen, sw);
+    pSim->rspSent     = 0;
+    pSim->cmdLen      = 0;
+    pSim->cmdOverflow = 0;
+
+    latencyUs = pSim->config.latencyUs[pSim->latencyIns];
+    if (latencyUs == SE05X_SIM_LATENCY_DEFAULT) {
+        latencyUs = pSim->config.defaultLatencyUs;
+    }
+    totalUs = latencyUs + ((uint64_t)pSim->config.byteLatencyNs * (cmdLen + pSim->rspLen)) / 1000;
+    if ((pSim->config.wtxCount > 0) && se05x_sim_roll(pSim, pSim->config.wtxRate)) {
+        wtxCount = pSim->config.wtxCount;
+    }
+    pSim->sliceUs    = (uint32_t)(totalUs / (wtxCount + 1));
+    pSim->wtxLeft    = wtxCount;
+    pSim->wtxPending = 0;
+    pSim->readyAtUs  = sm_get_time_us() + pSim->sliceUs;
+    pSim->linkState  = kSe05xSimLink_Processing;
+}
+
+/**
+* Releases a WTX request or the response once the processing time is over
+*/
+static void se05x_sim_advance(se05x_sim_t *pSim)
+{
+    uint8_t multiplier = 1;
+
+    if ((pSim->linkState != kSe05xSimLink_Processing) || pSim->wtxPending ||
+        (sm_get_time_us() < pSim->readyAtUs)) {
+        return;
+    }
+    if (pSim->wtxLeft > 0) {
+        pSim->wtxLeft--;
+        pSim->wtxPending = 1;
+        pSim->stats.wtxSent++;
+        se05x_sim_send_s_block(pSim, PH_PROTO_7816_S_BLOCK_REQ | PH_PROTO_7816_S_WTX, &multiplier, 1);
+        return;
+    }
+    pSim->linkState = kSe05xSimLink_Responding;
+    se05x_sim_send_chunk(pSim);
+}
+
+/**
+* Drops the state of the T=1 protocol
+*/
+static void se05x_sim_protocol_reset(se05x_sim_t *pSim)
+{
+    pSim->linkState   = kSe05xSimLink_Idle;
+    pSim->seqTx       = 0;
+    pSim->seqRx       = 0;
+    pSim->outLen      = 0;
+    pSim->outPos      = 0;
+    pSim->lastTxLen   = 0;
+    pSim->cmdLen      = 0;
+    pSim->cmdOverflow = 0;
+    pSim->rspLen      = 0;
+    pSim->rspSent     = 0;
+    pSim->wtxLeft     = 0;
+    pSim->wtxPending  = 0;
+}
+
+/**
+* Chip / cold reset: link, secure channels and transient objects are lost
+*/
+static void se05x_sim_power_cycle(se05x_sim_t *pSim)
+{
+    se05x_sim_protocol_reset(pSim);
+    se05x_sim_scp_reset(pSim);
+    se05x_sim_applet_deselect(pSim);
+}
+
+/**
+* Answers an S-block request of the host
+*/
+static void se05x_sim_handle_s_block(se05x_sim_t *pSim, uint8_t pcb, const uint8_t *pInf, uint32_t infLen)
+{
+    uint8_t code = pcb & SE05X_SIM_PCB_S_CODE_MASK;
+    uint8_t rsp  = PH_PROTO_7816_S_BLOCK_RSP | code;
+#if defined(T1oI2C_UM11225)
+    uint8_t atr[sizeof(gSe05xSim_atr)];
+    memcpy(atr, gSe05xSim_atr, sizeof(atr));
+    atr[SE05X_SIM_ATR_IFSC_OFFSET]     = (uint8_t)(pSim->config.ifsc >> 8);
+    atr[SE05X_SIM_ATR_IFSC_OFFSET + 1] = (uint8_t)pSim->config.ifsc;
+#elif defined(T1oI2C_GP1_0)
+    uint8_t cip[sizeof(gSe05xSim_cip)];
+    memcpy(cip, gSe05xSim_cip, sizeof(cip));
+    cip[SE05X_SIM_CIP_IFSC_OFFSET]     = (uint8_t)(pSim->config.ifsc >> 8);
+    cip[SE05X_SIM_CIP_IFSC_OFFSET + 1] = (uint8_t)pSim->config.ifsc;
+#endif
+
+    if ((pcb & SE05X_SIM_PCB_S_MASK) == PH_PROTO_7816_S_BLOCK_RSP) {
+        /* Response to S(WTX) */
+        if ((code == PH_PROTO_7816_S_WTX) && pSim->wtxPending) {
+            pSim->wtxPending = 0;
+            pSim->readyAtUs  = sm_get_time_us() + pSim->sliceUs;
+        }
+        return;
+    }
+
+    switch (code) {
+    case PH_PROTO_7816_S_RESYNCH:
+        se05x_sim_protocol_reset(pSim);
+        se05x_sim_send_s_block(pSim, rsp, NULL, 0);
+        break;
+    case PH_PROTO_7816_S_IFS:
+        if ((infLen == 1) || (infLen == 2)) {
+            pSim->ifsd = (infLen == 1) ? pInf[0] : (uint16_t)((pInf[0] << 8) | pInf[1]);
+            if (pSim->ifsd > SE05X_SIM_MAX_INF_LEN) {
+                pSim->ifsd = SE05X_SIM_MAX_INF_LEN;
+            }
+        }
+        se05x_sim_send_s_block(pSim, rsp, pInf, infLen);
+        break;
+#if defined(T1oI2C_UM11225)
+    case PH_PROTO_7816_S_CHIP_RST:
+        se05x_sim_power_cycle(pSim);
+        se05x_sim_send_s_block(pSim, rsp, NULL, 0);
+        break;
+    case PH_PROTO_7816_S_GET_ATR:
+        se05x_sim_send_s_block(pSim, rsp, atr, sizeof(atr));
+        break;
+    case PH_PROTO_7816_S_RESET:
+        se05x_sim_protocol_reset(pSim);
+        pSim->ifsd = SE05X_SIM_IFS_DEFAULT;
+        se05x_sim_send_s_block(pSim, rsp, atr, sizeof(atr));
+        break;
+#elif defined(T1oI2C_GP1_0)
+    case PH_PROTO_7816_S_COLD_RST:
+        se05x_sim_power_cycle(pSim);
+        se05x_sim_send_s_block(pSim, rsp, NULL, 0);
+        break;
+    case PH_PROTO_7816_S_GET_CIP:
+        se05x_sim_send_s_block(pSim, rsp, cip, sizeof(cip));
+        break;
+    case PH_PROTO_7816_S_SWR:
+        se05x_sim_protocol_reset(pSim);
+        pSim->ifsd = SE05X_SIM_IFS_DEFAULT;
+        se05x_sim_send_s_block(pSim, rsp, NULL, 0);
+        break;
+#endif
+    default:
+        /* END OF APDU, DEEP POWER DOWN, ... just acknowledged */
+        se05x_sim_send_s_block(pSim, rsp, NULL, 0);
+        break;
+    }
+}
+
+/**
+* Handles an I-block of the host
+*/
+static void se05x_sim_handle_i_block(se05x_sim_t *pSim, uint8_t pcb, const uint8_t *pInf, uint32_t infLen)
+{
+    if (SE05X_SIM_PCB_I_SEQ(pcb) != pSim->seqRx) {
+        /* Repeated block, our answer got lost */
+        if (pSim->linkState != kSe05xSimLink_Processing) {
+            se05x_sim_resend(pSim);
+        }
+        return;
+    }
+    if (pSim->linkState != kSe05xSimLink_Idle) {
+        /* New command while a response is pending, the host gave up on it */
+        pSim->linkState = kSe05xSimLink_Idle;
+        pSim->cmdLen    = 0;
+    }
+    pSim->seqRx ^= 1;
+    if ((pSim->cmdLen + infLen) > sizeof(pSim->cmd)) {
+        pSim->cmdOverflow = 1;
+    }
+    else {
+        memcpy(&pSim->cmd[pSim->cmdLen], pInf, infLen);
+        pSim->cmdLen += infLen;
+    }
+    if (pcb & PH_PROTO_7816_CHAINING) {
+        se05x_sim_send_r_block(pSim, pSim->seqRx, 0);
+        return;
+    }
+    se05x_sim_process_apdu(pSim);
+}
+
+/**
+* Handles an R-block of the host
+*/
+static void se05x_sim_handle_r_block(se05x_sim_t *pSim, uint8_t pcb)
+{
+    if (pSim->linkState == kSe05xSimLink_Processing) {
+        /* Host polled too long, the response follows when ready */
+        return;
+    }
+    if ((pSim->linkState == kSe05xSimLink_Responding) && (SE05X_SIM_PCB_R_ERR(pcb) == 0) &&
+        (SE05X_SIM_PCB_R_SEQ(pcb) == pSim->seqTx)) {
+        se05x_sim_send_chunk(pSim);
+        return;
+    }
+    se05x_sim_resend(pSim);
+}
+
+void se05x_sim_config_init(se05x_sim_config_t *pConfig)
+{
+    size_t i = 0;
+
+    if (pConfig == NULL) {
+        return;
+    }
+    memset(pConfig, 0, sizeof(*pConfig));
+    for (i = 0; i < SE05X_SIM_INS_COUNT; i++) {
+        pConfig->latencyUs[i] = SE05X_SIM_LATENCY_DEFAULT;
+    }
+    pConfig->seed = 1;
+    pConfig->ifsc = SE05X_SIM_IFS_DEFAULT;
+    for (i = 0; i < sizeof(pConfig->scp03EncKey); i += 2) {
+        pConfig->scp03EncKey[i]     = 0xAB;
+        pConfig->scp03EncKey[i + 1] = 0xCD;
+        pConfig->scp03MacKey[i]     = 0xAB;
+        pConfig->scp03MacKey[i + 1] = 0xCD;
+    }
+    pConfig->scp03EncKey[14] = 0x00;
+    pConfig->scp03EncKey[15] = 0x01;
+    pConfig->scp03MacKey[14] = 0x00;
+    pConfig->scp03MacKey[15] = 0x02;
+    memcpy(pConfig->ecKeyAuthPub, gSe05xSim_ecKeyAuthPub, sizeof(pConfig->ecKeyAuthPub));
+}
+
+se05x_sim_t *se05x_sim_create(const se05x_sim_config_t *pConfig)
+{
+    se05x_sim_t *pSim = NULL;
+
+    ENSURE_OR_RETURN_ON_ERROR(pConfig != NULL, NULL);
+
+    pSim = (se05x_sim_t *)sm_malloc(sizeof(se05x_sim_t));
+    ENSURE_OR_RETURN_ON_ERROR(pSim != NULL, NULL);
+    memset(pSim, 0, sizeof(*pSim));
+
+    memcpy(&pSim->config, pConfig, sizeof(pSim->config));
+    if ((pSim->config.ifsc == 0) || (pSim->config.ifsc > SE05X_SIM_MAX_INF_LEN)) {
+        pSim->config.ifsc = SE05X_SIM_MAX_INF_LEN;
+    }
+    /* xorshift must not start at 0 */
+    pSim->prng = ((uint64_t)pSim->config.seed << 32) | 0x9E3779B9u;
+    pSim->ifsd = SE05X_SIM_IFS_DEFAULT;
+
+    if (se05x_sim_applet_init(pSim) != 0) {
+        SMLOG_E("SIM: Error in creating the applet objects \n");
+        se05x_sim_destroy(pSim);
+        return NULL;
+    }
+    return pSim;
+}
+
+void se05x_sim_destroy(se05x_sim_t *pSim)
+{
+    if (pSim == NULL) {
+        return;
+    }
+    se05x_sim_applet_free(pSim);
+    sm_free(pSim);
+}
+
+void se05x_sim_link_reset(se05x_sim_t *pSim)
+{
+    if (pSim == NULL) {
+        return;
+    }
+    se05x_sim_protocol_reset(pSim);
+    pSim->ifsd = SE05X_SIM_IFS_DEFAULT;
+}
+
+ESESTATUS se05x_sim_receive(se05x_sim_t *pSim, const uint8_t *pData, uint32_t len)
+{
+    int infLen  = 0;
+    uint8_t pcb = 0;
+
+    ENSURE_OR_RETURN_ON_ERROR((pSim != NULL) && (pData != NULL), ESESTATUS_INVALID_PARAMETER);
+
+    pcb = (len > PH_PROPTO_7816_PCB_OFFSET) ? pData[PH_PROPTO_7816_PCB_OFFSET] : 0;
+    if (((pcb & PH_PROTO_7816_S_BLOCK_REQ) != PH_PROTO_7816_S_BLOCK_REQ) &&
+        se05x_sim_roll(pSim, pSim->config.nackRate)) {
+        /* I- and R-blocks only, the host writes the frame again */
+        pSim->stats.nacksInjected++;
+        return ESESTATUS_BUSY;
+    }
+
+    pSim->stats.framesRx++;
+    /* A new frame replaces what the host did not read */
+    pSim->outLen = 0;
+    infLen       = se05x_sim_check_frame(pData, len);
+    if (infLen < 0) {
+        pSim->stats.crcErrorsRx++;
+        se05x_sim_send_r_block(pSim, pSim->seqRx, SE05X_SIM_R_ERR_CRC);
+        return ESESTATUS_SUCCESS;
+    }
+
+    if ((pcb & SE05X_SIM_PCB_R_BLOCK) == 0) {
+        se05x_sim_handle_i_block(pSim, pcb, &pData[PH_PROTO_7816_HEADER_LEN], (uint32_t)infLen);
+    }
+    else if ((pcb & PH_PROTO_7816_S_BLOCK_REQ) == SE05X_SIM_PCB_R_BLOCK) {
+        se05x_sim_handle_r_block(pSim, pcb);
+    }
+    else {
+        se05x_sim_handle_s_block(pSim, pcb, &pData[PH_PROTO_7816_HEADER_LEN], (uint32_t)infLen);
+    }
+    return ESESTATUS_SUCCESS;
+}
+
+ESESTATUS se05x_sim_send(se05x_sim_t *pSim, uint8_t *pBuffer, uint32_t len)
+{
+    uint32_t avail = 0;
+
+    ENSURE_OR_RETURN_ON_ERROR((pSim != NULL) && (pBuffer != NULL), ESESTATUS_INVALID_PARAMETER);
+
+    if (pSim->outLen == 0) {
+        se05x_sim_advance(pSim);
+        if (pSim->outLen == 0) {
+            return ESESTATUS_BUSY;
+        }
+    }
+
+    avail = pSim->outLen - pSim->outPos;
+    if (len < avail) {
+        memcpy(pBuffer, &pSim->out[pSim->outPos], len);
+        pSim->outPos += len;
+        return ESESTATUS_SUCCESS;
+    }
+    memcpy(pBuffer, &pSim->out[pSim->outPos], avail);
+    memset(&pBuffer[avail], 0, len - avail);
+    pSim->outLen = 0;
+    pSim->outPos = 0;
+    pSim->stats.framesTx++;
+    return ESESTATUS_SUCCESS;
+}
+
+void se05x_sim_get_stats(const se05x_sim_t *pSim, se05x_sim_stats_t *pStats)
+{
+    if ((pSim == NULL) || (pStats == NULL)) {
+        return;
+    }
+    memcpy(pStats, &pSim->stats, sizeof(*pStats));
+}
+
+static ESESTATUS se05x_sim_peer_receive(void *pPeerCtx, const uint8_t *pData, uint32_t len)
+{
+    return se05x_sim_receive((se05x_sim_t *)pPeerCtx, pData, len);
+}
+
+static ESESTATUS se05x_sim_peer_send(void *pPeerCtx, uint8_t *pBuffer, uint32_t len)
+{
+    return se05x_sim_send((se05x_sim_t *)pPeerCtx, pBuffer, len);
+}
+
+void se05x_sim_loopback_peer(se05x_sim_t *pSim, phPalEse_LoopbackPeer_t *pPeer)
+{
+    if (pPeer == NULL) {
+        return;
+    }
+    pPeer->receive  = &se05x_sim_peer_receive;
+    pPeer->send     = &se05x_sim_peer_send;
+    pPeer->pPeerCtx = pSim;
+}
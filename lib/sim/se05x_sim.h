@@ -0,0 +1,126 @@
+/** @file se05x_sim.h
+ *  @brief Software SE05x simulator below the T=1oI2C transport.
+ *
+ * Copyright 2024 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SE05X_SIM_H_INC
+#define SE05X_SIM_H_INC
+
+/* ********************** Include files ********************** */
+#include <stdint.h>
+#include "phNxpEsePal_i2c.h"
+
+/* ********************** Constants ********************** */
+
+/* Number of instructions with an own latency (INS & kSE05x_INS_MASK_INSTRUCTION for
+ * the SE05x applet, the full INS byte for GP / ISO7816 commands) */
+#define SE05X_SIM_INS_COUNT 256
+
+/* Latency of an instruction that uses the default latency */
+#define SE05X_SIM_LATENCY_DEFAULT UINT32_MAX
+
+/* Rates of injected events are given per mille */
+#define SE05X_SIM_RATE_NEVER 0
+#define SE05X_SIM_RATE_ALWAYS 1000
+
+/* ********************** Data types ********************** */
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/* The simulator answers the host like an SE05x on the I2C bus: every write of the host
+ * is one T=1oI2C frame, reads return the pending frame of the SE or NACK (ESESTATUS_BUSY)
+ * while it is processing.
+ *
+ * Latency of an APDU is latencyUs[INS] (or defaultLatencyUs) plus byteLatencyNs for every
+ * byte of the command and the response APDU. With WTX injected the latency is split
+ * into wtxCount + 1 slices separated by S(WTX) requests.
+ *
+ * Errors are injected only while an APDU is exchanged, so opening the link stays reliable.
+ * All random decisions come from a PRNG started with seed, so a run can be repeated. */
+typedef struct se05x_sim_config
+{
+    uint32_t defaultLatencyUs;                 /* Processing time of an APDU */
+    uint32_t latencyUs[SE05X_SIM_INS_COUNT];   /* Per instruction, SE05X_SIM_LATENCY_DEFAULT to use the default */
+    uint32_t byteLatencyNs;                    /* Added processing time per APDU byte */
+    uint16_t wtxRate;                          /* APDUs answered after S(WTX) requests, per mille */
+    uint8_t wtxCount;                          /* S(WTX) requests sent before such a response */
+    uint16_t crcErrorRate;                     /* I-frames of the SE sent with a wrong CRC, per mille */
+    uint16_t nackRate;                         /* Frames of the host NACKed on write, per mille */
+    uint16_t dropRate;                         /* I-frames of the SE lost (host times out), per mille */
+    uint32_t seed;                             /* Seed of the injection PRNG */
+    uint16_t ifsc;                             /* Information field size of the SE, reported in ATR / CIP */
+    uint8_t scp03EncKey[16];                   /* Platform SCP03 static ENC key */
+    uint8_t scp03MacKey[16];                   /* Platform SCP03 static MAC key */
+    uint8_t ecKeyAuthPub[65];                  /* Public key (uncompressed NIST P-256) of the ECKey auth object */
+} se05x_sim_config_t;
+
+/* Counters of a simulator instance */
+typedef struct se05x_sim_stats
+{
+    uint32_t framesRx;          /* Frames written by the host */
+    uint32_t framesTx;          /* Frames read by the host */
+    uint32_t apdus;             /* APDUs processed */
+    uint32_t wtxSent;           /* S(WTX) requests sent */
+    uint32_t resends;           /* I-frames sent again on request of the host */
+    uint32_t crcErrorsRx;       /* Frames of the host with a wrong CRC */
+    uint32_t crcErrorsInjected; /* I-frames sent with a wrong CRC */
+    uint32_t nacksInjected;     /* Writes of the host NACKed */
+    uint32_t framesDropped;     /* I-frames not sent */
+} se05x_sim_stats_t;
+
+typedef struct se05x_sim se05x_sim_t;
+
+/* ********************** Function Prototypes ********************** */
+
+/**
+ * \brief Default configuration: no latency, no WTX, no errors, IFSC 254, the default
+ *        SCP03 keys and ECKey auth key of the examples
+ */
+void se05x_sim_config_init(se05x_sim_config_t *pConfig);
+
+/**
+ * \brief Create a simulator with an empty object store (besides the ECKey objects)
+ *
+ * \return NULL on failure
+ */
+se05x_sim_t *se05x_sim_create(const se05x_sim_config_t *pConfig);
+
+void se05x_sim_destroy(se05x_sim_t *pSim);
+
+/**
+ * \brief Reset the link, e.g. on a new connection of the host. Objects persist.
+ */
+void se05x_sim_link_reset(se05x_sim_t *pSim);
+
+/**
+ * \brief Frame written by the host
+ *
+ * \retval ESESTATUS_SUCCESS frame taken
+ * \retval ESESTATUS_BUSY    NACK, the host has to write the frame again
+ */
+ESESTATUS se05x_sim_receive(se05x_sim_t *pSim, const uint8_t *pData, uint32_t len);
+
+/**
+ * \brief Read of the host, len bytes of the pending frame (zero padded)
+ *
+ * \retval ESESTATUS_SUCCESS data read
+ * \retval ESESTATUS_BUSY    NACK, nothing to read
+ */
+ESESTATUS se05x_sim_send(se05x_sim_t *pSim, uint8_t *pBuffer, uint32_t len);
+
+void se05x_sim_get_stats(const se05x_sim_t *pSim, se05x_sim_stats_t *pStats);
+
+/**
+ * \brief Peer of the loopback transport ("loop:") backed by the simulator,
+ *        to be set with phPalEse_loopback_setPeer() before the session is opened
+ */
+void se05x_sim_loopback_peer(se05x_sim_t *pSim, phPalEse_LoopbackPeer_t *pPeer);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif //#ifndef SE05X_SIM_H_INC
@@ -0,0 +1,1168 @@
+/** @file se05x_sim_applet.c
+ *  @brief Software SE05x simulator, object store and applet commands.
+ *
+ * Copyright 2024 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* ********************** Include files ********************** */
+#include <string.h>
+#include <openssl/bn.h>
+#include <openssl/core_names.h>
+#include <openssl/ec.h>
+#include <openssl/evp.h>
+#include <openssl/obj_mac.h>
+#include <openssl/param_build.h>
+#include "se05x_sim_internal.h"
+#include "sm_port.h"
+
+/* ********************** Defines ********************** */
+
+#define SE05X_SIM_EC_PRIV_LEN 32
+#define SE05X_SIM_EC_PUB_LEN 65
+#define SE05X_SIM_EC_SIG_MAX_LEN 72
+#define SE05X_SIM_AES_BLOCK_LEN 16
+#define SE05X_SIM_MAX_SYMM_KEY_LEN 64
+
+/* Filter of ReadIDList matching every object */
+#define SE05X_SIM_FILTER_ALL 0xFF
+
+/* Selected application */
+#define SE05X_SIM_SELECTED_NONE 0
+#define SE05X_SIM_SELECTED_APPLET 1
+#define SE05X_SIM_SELECTED_SSD 2
+
+/* ********************** Global variables ********************** */
+
+/* clang-format off */
+static const uint8_t gSe05xSim_appletAid[] = {
+    0xA0, 0x00, 0x00, 0x03, 0x96, 0x54, 0x53, 0x00, 0x00, 0x00, 0x01, 0x03, 0x00, 0x00, 0x00, 0x00};
+static const uint8_t gSe05xSim_ssdAid[] = {0xD2, 0x76, 0x00, 0x00, 0x85, 0x30, 0x4A, 0x43, 0x4F, 0x90, 0x03};
+/* Applet version 7.2.0, all features, secure box */
+static const uint8_t gSe05xSim_version[] = {0x07, 0x02, 0x00, 0x3F, 0xFF, 0x01, 0x0B};
+/* clang-format on */
+
+/* ********************** Functions ********************** */
+
+int se05x_sim_apdu_parse(uint8_t *pCmd, size_t cmdLen, uint8_t **ppData, size_t *pDataLen)
+{
+    size_t lc = 0;
+
+    *ppData   = NULL;
+    *pDataLen = 0;
+    if (cmdLen < 4) {
+        return 1;
+    }
+    if (cmdLen <= 5) {
+        /* No data, optional Le */
+        return 0;
+    }
+    if (pCmd[4] != 0) {
+        lc = pCmd[4];
+        if ((cmdLen != 5 + lc) && (cmdLen != 5 + lc + 1)) {
+            return 1;
+        }
+        *ppData   = &pCmd[5];
+        *pDataLen = lc;
+        return 0;
+    }
+    if (cmdLen < 7) {
+        return 1;
+    }
+    lc = ((size_t)pCmd[5] << 8) | pCmd[6];
+    if (cmdLen == 7) {
+        /* Extended Le only */
+        return 0;
+    }
+    if ((cmdLen != 7 + lc) && (cmdLen != 7 + lc + 2)) {
+        return 1;
+    }
+    *ppData   = &pCmd[7];
+    *pDataLen = lc;
+    return 0;
+}
+
+int se05x_sim_tlv_put(uint8_t *pBuf, size_t bufSize, size_t *pBufLen, uint8_t tag, const uint8_t *pValue, size_t len)
+{
+    size_t i = *pBufLen;
+
+    if ((len > 0xFFFF) || ((i + 4 + len) > bufSize)) {
+        return 1;
+    }
+    pBuf[i++] = tag;
+    if (len <= 0x7F) {
+        pBuf[i++] = (uint8_t)len;
+    }
+    else if (len <= 0xFF) {
+        pBuf[i++] = 0x81;
+        pBuf[i++] = (uint8_t)len;
+    }
+    else {
+        pBuf[i++] = 0x82;
+        pBuf[i++] = (uint8_t)(len >> 8);
+        pBuf[i++] = (uint8_t)len;
+    }
+    if (len > 0) {
+        memcpy(&pBuf[i], pValue, len);
+    }
+    *pBufLen = i + len;
+    return 0;
+}
+
+size_t se05x_sim_put_sw(uint8_t *pRsp, size_t rspLen, uint16_t sw)
+{
+    if (rspLen < 2) {
+        return 0;
+    }
+    pRsp[0] = (uint8_t)(sw >> 8);
+    pRsp[1] = (uint8_t)sw;
+    return 2;
+}
+
+/**
+* Gets the value of a TLV, 1 if the tag is not next
+*/
+static int se05x_sim_get_buf(
+    uint8_t *pData, size_t dataLen, size_t *pIndex, uint8_t tag, uint8_t **ppValue, size_t *pLen)
+{
+    size_t offset = 0;
+
+    if (tlvGet_u8bufView(pData, pIndex, dataLen, (SE05x_TAG_t)tag, &offset, pLen) != 0) {
+        return 1;
+    }
+    *ppValue = &pData[offset];
+    return 0;
+}
+
+/**
+* Gets a big endian integer of size bytes, 1 if the tag is not next or has another size
+*/
+static int se05x_sim_get_uint(uint8_t *pData, size_t dataLen, size_t *pIndex, uint8_t tag, size_t size, uint32_t *pValue)
+{
+    uint8_t *pValueBuf = NULL;
+    size_t len         = 0;
+    size_t index       = *pIndex;
+    size_t i           = 0;
+
+    if ((se05x_sim_get_buf(pData, dataLen, &index, tag, &pValueBuf, &len) != 0) || (len != size)) {
+        return 1;
+    }
+    *pValue = 0;
+    for (i = 0; i < len; i++) {
+        *pValue = (*pValue << 8) | pValueBuf[i];
+    }
+    *pIndex = index;
+    return 0;
+}
+
+/**
+* Skips policy and max attempts, which are not enforced
+*/
+static void se05x_sim_skip_policy(uint8_t *pData, size_t dataLen, size_t *pIndex)
+{
+    uint8_t *pValue = NULL;
+    size_t len      = 0;
+
+    se05x_sim_get_buf(pData, dataLen, pIndex, kSE05x_TAG_POLICY, &pValue, &len);
+    se05x_sim_get_buf(pData, dataLen, pIndex, kSE05x_TAG_MAX_ATTEMPTS, &pValue, &len);
+}
+
+se05x_sim_object_t *se05x_sim_object_find(se05x_sim_t *pSim, uint32_t id)
+{
+    size_t i = 0;
+
+    if (id == 0) {
+        return NULL;
+    }
+    for (i = 0; i < SE05X_SIM_MAX_OBJECTS; i++) {
+        if (pSim->objects[i].id == id) {
+            return &pSim->objects[i];
+        }
+    }
+    return NULL;
+}
+
+static se05x_sim_object_t *se05x_sim_object_alloc(se05x_sim_t *pSim, uint32_t id, uint8_t type)
+{
+    size_t i = 0;
+
+    for (i = 0; i < SE05X_SIM_MAX_OBJECTS; i++) {
+        if (pSim->objects[i].id == 0) {
+            memset(&pSim->objects[i], 0, sizeof(pSim->objects[i]));
+            pSim->objects[i].id   = id;
+            pSim->objects[i].type = type;
+            return &pSim->objects[i];
+        }
+    }
+    return NULL;
+}
+
+static void se05x_sim_object_free(se05x_sim_object_t *pObject)
+{
+    if (pObject->pEcKey != NULL) {
+        EVP_PKEY_free(pObject->pEcKey);
+    }
+    if (pObject->pData != NULL) {
+        OPENSSL_cleanse(pObject->pData, pObject->dataLen);
+        sm_free(pObject->pData);
+    }
+    memset(pObject, 0, sizeof(*pObject));
+}
+
+/**
+* Invalid id or objects of the applet itself, cannot be changed by the host
+*/
+static int se05x_sim_object_is_reserved(uint32_t id)
+{
+    return (id == 0) || (SE05X_OBJID_SE05X_APPLET_RES_MASK(id) == SE05X_OBJID_SE05X_APPLET_RES_START) ||
+           (id == SE05X_SIM_OBJID_ECKEY_AUTH);
+}
+
+/**
+* Sets the data of a symmetric key or binary file
+*/
+static int se05x_sim_object_set_data(se05x_sim_object_t *pObject, const uint8_t *pData, size_t dataLen)
+{
+    uint8_t *pNew = (uint8_t *)sm_malloc(dataLen > 0 ? dataLen : 1);
+
+    if (pNew == NULL) {
+        return 1;
+    }
+    if (pData != NULL) {
+        memcpy(pNew, pData, dataLen);
+    }
+    else {
+        memset(pNew, 0, dataLen);
+    }
+    if (pObject->pData != NULL) {
+        OPENSSL_cleanse(pObject->pData, pObject->dataLen);
+        sm_free(pObject->pData);
+    }
+    pObject->pData   = pNew;
+    pObject->dataLen = dataLen;
+    return 0;
+}
+
+int se05x_sim_ec_public_key(const EVP_PKEY *pEcKey, uint8_t *pKey, size_t *pKeyLen)
+{
+    size_t len = 0;
+
+    if ((pEcKey == NULL) ||
+        (EVP_PKEY_get_octet_string_param(pEcKey, OSSL_PKEY_PARAM_PUB_KEY, pKey, *pKeyLen, &len) != 1)) {
+        return 1;
+    }
+    *pKeyLen = len;
+    return 0;
+}
+
+/**
+* Uncompressed public point of a NIST P-256 private key
+*/
+static int se05x_sim_ec_public_point(const uint8_t *pPriv, size_t privLen, uint8_t *pPub, size_t pubLen)
+{
+    int ret          = 1;
+    EC_GROUP *pGroup = NULL;
+    EC_POINT *pPoint = NULL;
+    BIGNUM *pBnPriv  = NULL;
+
+    pGroup = EC_GROUP_new_by_curve_name(NID_X9_62_prime256v1);
+    ENSURE_OR_GO_EXIT(pGroup != NULL);
+    pPoint = EC_POINT_new(pGroup);
+    ENSURE_OR_GO_EXIT(pPoint != NULL);
+    pBnPriv = BN_bin2bn(pPriv, (int)privLen, NULL);
+    ENSURE_OR_GO_EXIT(pBnPriv != NULL);
+    ENSURE_OR_GO_EXIT(EC_POINT_mul(pGroup, pPoint, pBnPriv, NULL, NULL, NULL) == 1);
+    ENSURE_OR_GO_EXIT(
+        EC_POINT_point2oct(pGroup, pPoint, POINT_CONVERSION_UNCOMPRESSED, pPub, pubLen, NULL) == pubLen);
+    ret = 0;
+exit:
+    BN_clear_free(pBnPriv);
+    EC_POINT_free(pPoint);
+    EC_GROUP_free(pGroup);
+    return ret;
+}
+
+/**
+* NIST P-256 key from private and / or public key, generated when both are missing
+*/
+EVP_PKEY *se05x_sim_ec_key_new(const uint8_t *pPriv, size_t privLen, const uint8_t *pPub, size_t pubLen)
+{
+    EVP_PKEY *pEcKey     = NULL;
+    EVP_PKEY_CTX *pCtx   = NULL;
+    OSSL_PARAM_BLD *pBld = NULL;
+    OSSL_PARAM *pParams  = NULL;
+    BIGNUM *pBnPriv      = NULL;
+    uint8_t pub[SE05X_SIM_EC_PUB_LEN];
+    int selection = EVP_PKEY_PUBLIC_KEY;
+
+    if ((pPriv == NULL) && (pPub == NULL)) {
+        return EVP_EC_gen(SN_X9_62_prime256v1);
+    }
+
+    if (pPriv != NULL) {
+        if (pPub == NULL) {
+            /* Public key of a private key only object, to answer ReadObject */
+            ENSURE_OR_GO_EXIT(se05x_sim_ec_public_point(pPriv, privLen, pub, sizeof(pub)) == 0);
+            pPub   = pub;
+            pubLen = sizeof(pub);
+        }
+        pBnPriv = BN_bin2bn(pPriv, (int)privLen, NULL);
+        ENSURE_OR_GO_EXIT(pBnPriv != NULL);
+        selection = EVP_PKEY_KEYPAIR;
+    }
+
+    pBld = OSSL_PARAM_BLD_new();
+    ENSURE_OR_GO_EXIT(pBld != NULL);
+    ENSURE_OR_GO_EXIT(
+        OSSL_PARAM_BLD_push_utf8_string(pBld, OSSL_PKEY_PARAM_GROUP_NAME, SN_X9_62_prime256v1, 0) == 1);
+    ENSURE_OR_GO_EXIT(OSSL_PARAM_BLD_push_octet_string(pBld, OSSL_PKEY_PARAM_PUB_KEY, pPub, pubLen) == 1);
+    if (pBnPriv != NULL) {
+        ENSURE_OR_GO_EXIT(OSSL_PARAM_BLD_push_BN(pBld, OSSL_PKEY_PARAM_PRIV_KEY, pBnPriv) == 1);
+    }
+    pParams = OSSL_PARAM_BLD_to_param(pBld);
+    ENSURE_OR_GO_EXIT(pParams != NULL);
+
+    pCtx = EVP_PKEY_CTX_new_from_name(NULL, "EC", NULL);
+    ENSURE_OR_GO_EXIT(pCtx != NULL);
+    ENSURE_OR_GO_EXIT(EVP_PKEY_fromdata_init(pCtx) == 1);
+    if (EVP_PKEY_fromdata(pCtx, &pEcKey, selection, pParams) != 1) {
+        pEcKey = NULL;
+    }
+exit:
+    EVP_PKEY_CTX_free(pCtx);
+    OSSL_PARAM_free(pParams);
+    OSSL_PARAM_BLD_free(pBld);
+    BN_clear_free(pBnPriv);
+    return pEcKey;
+}
+
+/**
+* ECDSA signature in DER over a hash
+*/
+int se05x_sim_ec_sign(EVP_PKEY *pEcKey, const uint8_t *pHash, size_t hashLen, uint8_t *pSig, size_t *pSigLen)
+{
+    int ret            = 1;
+    EVP_PKEY_CTX *pCtx = EVP_PKEY_CTX_new(pEcKey, NULL);
+
+    /* No digest set, the input is signed as the hash */
+    ENSURE_OR_GO_EXIT(pCtx != NULL);
+    ENSURE_OR_GO_EXIT(EVP_PKEY_sign_init(pCtx) == 1);
+    ENSURE_OR_GO_EXIT(EVP_PKEY_sign(pCtx, pSig, pSigLen, pHash, hashLen) == 1);
+    ret = 0;
+exit:
+    EVP_PKEY_CTX_free(pCtx);
+    return ret;
+}
+
+/**
+* Verifies a DER ECDSA signature over a hash, 0 if valid
+*/
+int se05x_sim_ec_verify(EVP_PKEY *pEcKey, const uint8_t *pHash, size_t hashLen, const uint8_t *pSig, size_t sigLen)
+{
+    int ret            = 1;
+    EVP_PKEY_CTX *pCtx = EVP_PKEY_CTX_new(pEcKey, NULL);
+
+    ENSURE_OR_GO_EXIT(pCtx != NULL);
+    ENSURE_OR_GO_EXIT(EVP_PKEY_verify_init(pCtx) == 1);
+    ENSURE_OR_GO_EXIT(EVP_PKEY_verify(pCtx, pSig, sigLen, pHash, hashLen) == 1);
+    ret = 0;
+exit:
+    EVP_PKEY_CTX_free(pCtx);
+    return ret;
+}
+
+/**
+* ECDH with an uncompressed peer point, the secret is the x-coordinate
+*/
+int se05x_sim_ec_derive(EVP_PKEY *pEcKey, const uint8_t *pPub, size_t pubLen, uint8_t *pSecret, size_t secretLen)
+{
+    int ret            = 1;
+    size_t outLen      = secretLen;
+    EVP_PKEY *pPeer    = NULL;
+    EVP_PKEY_CTX *pCtx = NULL;
+
+    pPeer = se05x_sim_ec_key_new(NULL, 0, pPub, pubLen);
+    ENSURE_OR_GO_EXIT(pPeer != NULL);
+    pCtx = EVP_PKEY_CTX_new(pEcKey, NULL);
+    ENSURE_OR_GO_EXIT(pCtx != NULL);
+    ENSURE_OR_GO_EXIT(EVP_PKEY_derive_init(pCtx) == 1);
+    ENSURE_OR_GO_EXIT(EVP_PKEY_derive_set_peer(pCtx, pPeer) == 1);
+    ENSURE_OR_GO_EXIT(EVP_PKEY_derive(pCtx, pSecret, &outLen) == 1);
+    ENSURE_OR_GO_EXIT(outLen == secretLen);
+    ret = 0;
+exit:
+    EVP_PKEY_CTX_free(pCtx);
+    EVP_PKEY_free(pPeer);
+    return ret;
+}
+
+static int se05x_sim_is_ec_key(const se05x_sim_object_t *pObject)
+{
+    return (pObject != NULL) &&
+           ((pObject->type == kSE05x_SecObjTyp_EC_KEY_PAIR) || (pObject->type == kSE05x_SecObjTyp_EC_PRIV_KEY) ||
+               (pObject->type == kSE05x_SecObjTyp_EC_PUB_KEY));
+}
+
+static int se05x_sim_has_private_key(const se05x_sim_object_t *pObject)
+{
+    return (pObject != NULL) &&
+           ((pObject->type == kSE05x_SecObjTyp_EC_KEY_PAIR) || (pObject->type == kSE05x_SecObjTyp_EC_PRIV_KEY));
+}
+
+/**
+* WriteECKey
+*/
+static uint16_t se05x_sim_write_ec_key(
+    se05x_sim_t *pSim, uint8_t ins, uint8_t p1, uint8_t *pData, size_t dataLen)
+{
+    size_t index              = 0;
+    uint32_t id               = 0;
+    uint32_t curve            = kSE05x_ECCurve_NA;
+    uint8_t *pPriv            = NULL;
+    size_t privLen            = 0;
+    uint8_t *pPub             = NULL;
+    size_t pubLen             = 0;
+    uint8_t keyPart           = p1 & kSE05x_P1_MASK_KEY_TYPE;
+    uint8_t type              = 0;
+    EVP_PKEY *pEcKey          = NULL;
+    se05x_sim_object_t *pObj  = NULL;
+
+    se05x_sim_skip_policy(pData, dataLen, &index);
+    if (se05x_sim_get_uint(pData, dataLen, &index, kSE05x_TAG_1, 4, &id) != 0) {
+        return SE05X_SIM_SW_CONDITIONS_NOT_SATISFIED;
+    }
+    se05x_sim_get_uint(pData, dataLen, &index, kSE05x_TAG_2, 1, &curve);
+    se05x_sim_get_buf(pData, dataLen, &index, kSE05x_TAG_3, &pPriv, &privLen);
+    se05x_sim_get_buf(pData, dataLen, &index, kSE05x_TAG_4, &pPub, &pubLen);
+    if (index != dataLen) {
+        return SE05X_SIM_SW_WRONG_DATA;
+    }
+
+    switch (keyPart) {
+    case kSE05x_P1_KEY_PAIR:
+        type = kSE05x_SecObjTyp_EC_KEY_PAIR;
+        /* Both parts, or none to generate the key */
+        if ((pPriv == NULL) != (pPub == NULL)) {
+            return SE05X_SIM_SW_CONDITIONS_NOT_SATISFIED;
+        }
+        break;
+    case kSE05x_P1_PRIVATE:
+        type = kSE05x_SecObjTyp_EC_PRIV_KEY;
+        if ((pPriv == NULL) || (pPub != NULL)) {
+            return SE05X_SIM_SW_CONDITIONS_NOT_SATISFIED;
+        }
+        break;
+    case kSE05x_P1_PUBLIC:
+        type = kSE05x_SecObjTyp_EC_PUB_KEY;
+        if ((pPub == NULL) || (pPriv != NULL)) {
+            return SE05X_SIM_SW_CONDITIONS_NOT_SATISFIED;
+        }
+        break;
+    default:
+        return SE05X_SIM_SW_WRONG_P1P2;
+    }
+    if (((pPriv != NULL) && (privLen != SE05X_SIM_EC_PRIV_LEN)) ||
+        ((pPub != NULL) && (pubLen != SE05X_SIM_EC_PUB_LEN))) {
+        return SE05X_SIM_SW_CONDITIONS_NOT_SATISFIED;
+    }
+    if (se05x_sim_object_is_reserved(id)) {
+        return SE05X_SIM_SW_CONDITIONS_NOT_SATISFIED;
+    }
+
+    pObj = se05x_sim_object_find(pSim, id);
+    if (pObj != NULL) {
+        /* Existing keys keep their type and curve */
+        if ((pObj->type != type) || ((curve != kSE05x_ECCurve_NA) && (curve != pObj->curve))) {
+            return SE05X_SIM_SW_CONDITIONS_NOT_SATISFIED;
+        }
+    }
+    else if (curve != kSE05x_ECCurve_NIST_P256) {
+        /* Only NIST P-256 is simulated */
+        return SE05X_SIM_SW_CONDITIONS_NOT_SATISFIED;
+    }
+
+    pEcKey = se05x_sim_ec_key_new(pPriv, privLen, pPub, pubLen);
+    if (pEcKey == NULL) {
+        return SE05X_SIM_SW_WRONG_DATA;
+    }
+    if (pObj == NULL) {
+        pObj = se05x_sim_object_alloc(pSim, id, type);
+        if (pObj == NULL) {
+            EVP_PKEY_free(pEcKey);
+            return SE05X_SIM_SW_FILE_FULL;
+        }
+        pObj->curve     = kSE05x_ECCurve_NIST_P256;
+        pObj->transient = (ins & kSE05x_INS_TRANSIENT) ? 1 : 0;
+    }
+    if (pObj->pEcKey != NULL) {
+        EVP_PKEY_free(pObj->pEcKey);
+    }
+    pObj->pEcKey = pEcKey;
+    return SE05X_SIM_SW_OK;
+}
+
+/**
+* WriteSymmKey
+*/
+static uint16_t se05x_sim_write_symm_key(
+    se05x_sim_t *pSim, uint8_t ins, uint8_t p1, uint8_t *pData, size_t dataLen)
+{
+    size_t index             = 0;
+    uint32_t id              = 0;
+    uint32_t kekId           = 0;
+    uint8_t *pKey            = NULL;
+    size_t keyLen            = 0;
+    uint8_t type             = 0;
+    int validLen             = 0;
+    se05x_sim_object_t *pObj = NULL;
+
+    se05x_sim_skip_policy(pData, dataLen, &index);
+    if (se05x_sim_get_uint(pData, dataLen, &index, kSE05x_TAG_1, 4, &id) != 0) {
+        return SE05X_SIM_SW_CONDITIONS_NOT_SATISFIED;
+    }
+    se05x_sim_get_uint(pData, dataLen, &index, kSE05x_TAG_2, 4, &kekId);
+    if ((se05x_sim_get_buf(pData, dataLen, &index, kSE05x_TAG_3, &pKey, &keyLen) != 0) || (index != dataLen)) {
+        return SE05X_SIM_SW_WRONG_DATA;
+    }
+    if (kekId != 0) {
+        /* Wrapped keys are not simulated */
+        return SE05X_SIM_SW_CONDITIONS_NOT_SATISFIED;
+    }
+
+    switch (p1 & kSE05x_P1_MASK_CRED_TYPE) {
+    case kSE05x_P1_AES:
+        type     = kSE05x_SecObjTyp_AES_KEY;
+        validLen = (keyLen == 16) || (keyLen == 24) || (keyLen == 32);
+        break;
+    case kSE05x_P1_DES:
+        type     = kSE05x_SecObjTyp_DES_KEY;
+        validLen = (keyLen == 8) || (keyLen == 16) || (keyLen == 24);
+        break;
+    case kSE05x_P1_HMAC:
+        type     = kSE05x_SecObjTyp_HMAC_KEY;
+        validLen = (keyLen > 0) && (keyLen <= SE05X_SIM_MAX_SYMM_KEY_LEN);
+        break;
+    default:
+        return SE05X_SIM_SW_WRONG_P1P2;
+    }
+    if (!validLen) {
+        return SE05X_SIM_SW_WRONG_DATA;
+    }
+    if (se05x_sim_object_is_reserved(id)) {
+        return SE05X_SIM_SW_CONDITIONS_NOT_SATISFIED;
+    }
+
+    pObj = se05x_sim_object_find(pSim, id);
+    if (pObj == NULL) {
+        pObj = se05x_sim_object_alloc(pSim, id, type);
+        if (pObj == NULL) {
+            return SE05X_SIM_SW_FILE_FULL;
+        }
+        pObj->transient = (ins & kSE05x_INS_TRANSIENT) ? 1 : 0;
+    }
+    else if ((pObj->type != type) || (pObj->dataLen != keyLen)) {
+        return SE05X_SIM_SW_CONDITIONS_NOT_SATISFIED;
+    }
+    if (se05x_sim_object_set_data(pObj, pKey, keyLen) != 0) {
+        se05x_sim_object_free(pObj);
+        return SE05X_SIM_SW_FILE_FULL;
+    }
+    return SE05X_SIM_SW_OK;
+}
+
+/**
+* WriteBinary, creates the file when the file length is given
+*/
+static uint16_t se05x_sim_write_binary(se05x_sim_t *pSim, uint8_t ins, uint8_t *pData, size_t dataLen)
+{
+    size_t index             = 0;
+    uint32_t id              = 0;
+    uint32_t offset          = 0;
+    uint32_t fileLen         = 0;
+    uint8_t *pValue          = NULL;
+    size_t valueLen          = 0;
+    se05x_sim_object_t *pObj = NULL;
+    uint8_t isCreated        = 0;
+
+    se05x_sim_skip_policy(pData, dataLen, &index);
+    if (se05x_sim_get_uint(pData, dataLen, &index, kSE05x_TAG_1, 4, &id) != 0) {
+        return SE05X_SIM_SW_CONDITIONS_NOT_SATISFIED;
+    }
+    se05x_sim_get_uint(pData, dataLen, &index, kSE05x_TAG_2, 2, &offset);
+    se05x_sim_get_uint(pData, dataLen, &index, kSE05x_TAG_3, 2, &fileLen);
+    se05x_sim_get_buf(pData, dataLen, &index, kSE05x_TAG_4, &pValue, &valueLen);
+    if (index != dataLen) {
+        return SE05X_SIM_SW_WRONG_DATA;
+    }
+    if (se05x_sim_object_is_reserved(id)) {
+        return SE05X_SIM_SW_CONDITIONS_NOT_SATISFIED;
+    }
+
+    pObj = se05x_sim_object_find(pSim, id);
+    if (pObj == NULL) {
+        if (fileLen == 0) {
+            return SE05X_SIM_SW_CONDITIONS_NOT_SATISFIED;
+        }
+        pObj = se05x_sim_object_alloc(pSim, id, kSE05x_SecObjTyp_BINARY_FILE);
+        if ((pObj == NULL) || (se05x_sim_object_set_data(pObj, NULL, fileLen) != 0)) {
+            if (pObj != NULL) {
+                se05x_sim_object_free(pObj);
+            }
+            return SE05X_SIM_SW_FILE_FULL;
+        }
+        pObj->transient = (ins & kSE05x_INS_TRANSIENT) ? 1 : 0;
+        isCreated       = 1;
+    }
+    else if ((pObj->type != kSE05x_SecObjTyp_BINARY_FILE) || (fileLen != 0)) {
+        return SE05X_SIM_SW_CONDITIONS_NOT_SATISFIED;
+    }
+    if ((offset + valueLen) > pObj->dataLen) {
+        /* A rejected create leaves no object behind */
+        if (isCreated) {
+            se05x_sim_object_free(pObj);
+        }
+        return SE05X_SIM_SW_WRONG_DATA;
+    }
+    if (valueLen > 0) {
+        memcpy(&pObj->pData[offset], pValue, valueLen);
+    }
+    return SE05X_SIM_SW_OK;
+}
+
+/**
+* ReadObject: public key of EC keys, contents of binary files
+*/
+static uint16_t se05x_sim_read_object(
+    se05x_sim_t *pSim, uint8_t *pData, size_t dataLen, uint8_t *pRsp, size_t rspSize, size_t *pRspLen)
+{
+    size_t index             = 0;
+    uint32_t id              = 0;
+    uint32_t offset          = 0;
+    uint32_t length          = 0;
+    uint8_t pub[SE05X_SIM_EC_PUB_LEN];
+    size_t pubLen            = sizeof(pub);
+    se05x_sim_object_t *pObj = NULL;
+
+    if (se05x_sim_get_uint(pData, dataLen, &index, kSE05x_TAG_1, 4, &id) != 0) {
+        return SE05X_SIM_SW_WRONG_DATA;
+    }
+    se05x_sim_get_uint(pData, dataLen, &index, kSE05x_TAG_2, 2, &offset);
+    se05x_sim_get_uint(pData, dataLen, &index, kSE05x_TAG_3, 2, &length);
+    if (index != dataLen) {
+        return SE05X_SIM_SW_WRONG_DATA;
+    }
+    pObj = se05x_sim_object_find(pSim, id);
+    if (pObj == NULL) {
+        return SE05X_SIM_SW_NOT_FOUND;
+    }
+
+    if (pObj->type == kSE05x_SecObjTyp_BINARY_FILE) {
+        if (length == 0) {
+            length = (offset < pObj->dataLen) ? (uint32_t)(pObj->dataLen - offset) : 0;
+        }
+        if ((offset + length) > pObj->dataLen) {
+            return SE05X_SIM_SW_WRONG_DATA;
+        }
+        if (se05x_sim_tlv_put(pRsp, rspSize, pRspLen, kSE05x_TAG_1, &pObj->pData[offset], length) != 0) {
+            return SE05X_SIM_SW_WRONG_LENGTH;
+        }
+        return SE05X_SIM_SW_OK;
+    }
+    if (se05x_sim_is_ec_key(pObj) && (pObj->type != kSE05x_SecObjTyp_EC_PRIV_KEY) && (offset == 0) &&
+        (length == 0)) {
+        if (se05x_sim_ec_public_key(pObj->pEcKey, pub, &pubLen) != 0) {
+            return SE05X_SIM_SW_CONDITIONS_NOT_SATISFIED;
+        }
+        if (se05x_sim_tlv_put(pRsp, rspSize, pRspLen, kSE05x_TAG_1, pub, pubLen) != 0) {
+            return SE05X_SIM_SW_WRONG_LENGTH;
+        }
+        return SE05X_SIM_SW_OK;
+    }
+    /* Secret keys cannot be read */
+    return SE05X_SIM_SW_CONDITIONS_NOT_SATISFIED;
+}
+
+/**
+* Maps the hash length of a signature algorithm, 0 if not supported
+*/
+static size_t se05x_sim_sign_input_len(uint32_t algo)
+{
+    switch (algo) {
+    case kSE05x_ECSignatureAlgo_SHA:
+        return 20;
+    case kSE05x_ECSignatureAlgo_SHA_224:
+        return 28;
+    case kSE05x_ECSignatureAlgo_SHA_256:
+        return 32;
+    case kSE05x_ECSignatureAlgo_SHA_384:
+        return 48;
+    case kSE05x_ECSignatureAlgo_SHA_512:
+        return 64;
+    default:
+        return 0;
+    }
+}
+
+/**
+* ECDSASign / ECDSAVerify
+*/
+static uint16_t se05x_sim_ecdsa(se05x_sim_t *pSim,
+    uint8_t p2,
+    uint8_t *pData,
+    size_t dataLen,
+    uint8_t *pRsp,
+    size_t rspSize,
+    size_t *pRspLen)
+{
+    size_t index             = 0;
+    uint32_t id              = 0;
+    uint32_t algo            = 0;
+    uint8_t *pInput          = NULL;
+    size_t inputLen          = 0;
+    uint8_t *pSig            = NULL;
+    size_t sigLen            = 0;
+    uint8_t sig[SE05X_SIM_EC_SIG_MAX_LEN];
+    size_t outLen            = sizeof(sig);
+    uint8_t result           = kSE05x_Result_FAILURE;
+    se05x_sim_object_t *pObj = NULL;
+
+    if ((se05x_sim_get_uint(pData, dataLen, &index, kSE05x_TAG_1, 4, &id) != 0) ||
+        (se05x_sim_get_uint(pData, dataLen, &index, kSE05x_TAG_2, 1, &algo) != 0) ||
+        (se05x_sim_get_buf(pData, dataLen, &index, kSE05x_TAG_3, &pInput, &inputLen) != 0)) {
+        return SE05X_SIM_SW_WRONG_DATA;
+    }
+    if (p2 == kSE05x_P2_VERIFY) {
+        if (se05x_sim_get_buf(pData, dataLen, &index, kSE05x_TAG_5, &pSig, &sigLen) != 0) {
+            return SE05X_SIM_SW_WRONG_DATA;
+        }
+    }
+    if (index != dataLen) {
+        return SE05X_SIM_SW_WRONG_DATA;
+    }
+
+    pObj = se05x_sim_object_find(pSim, id);
+    if (!se05x_sim_is_ec_key(pObj) || (inputLen != se05x_sim_sign_input_len(algo))) {
+        return SE05X_SIM_SW_CONDITIONS_NOT_SATISFIED;
+    }
+
+    if (p2 == kSE05x_P2_SIGN) {
+        if (!se05x_sim_has_private_key(pObj) ||
+            (se05x_sim_ec_sign(pObj->pEcKey, pInput, inputLen, sig, &outLen) != 0)) {
+            return SE05X_SIM_SW_CONDITIONS_NOT_SATISFIED;
+        }
+        if (se05x_sim_tlv_put(pRsp, rspSize, pRspLen, kSE05x_TAG_1, sig, outLen) != 0) {
+            return SE05X_SIM_SW_WRONG_LENGTH;
+        }
+        return SE05X_SIM_SW_OK;
+    }
+
+    if (se05x_sim_ec_verify(pObj->pEcKey, pInput, inputLen, pSig, sigLen) == 0) {
+        result = kSE05x_Result_SUCCESS;
+    }
+    if (se05x_sim_tlv_put(pRsp, rspSize, pRspLen, kSE05x_TAG_1, &result, 1) != 0) {
+        return SE05X_SIM_SW_WRONG_LENGTH;
+    }
+    return SE05X_SIM_SW_OK;
+}
+
+/**
+* ECDHGenerateSharedSecret, returns the x-coordinate of the shared point
+*/
+static uint16_t se05x_sim_ecdh(
+    se05x_sim_t *pSim, uint8_t *pData, size_t dataLen, uint8_t *pRsp, size_t rspSize, size_t *pRspLen)
+{
+    size_t index             = 0;
+    uint32_t id              = 0;
+    uint8_t *pPub            = NULL;
+    size_t pubLen            = 0;
+    uint8_t secret[SE05X_SIM_EC_PRIV_LEN];
+    se05x_sim_object_t *pObj = NULL;
+    uint16_t sw              = SE05X_SIM_SW_WRONG_DATA;
+
+    if ((se05x_sim_get_uint(pData, dataLen, &index, kSE05x_TAG_1, 4, &id) != 0) ||
+        (se05x_sim_get_buf(pData, dataLen, &index, kSE05x_TAG_2, &pPub, &pubLen) != 0) || (index != dataLen)) {
+        return SE05X_SIM_SW_WRONG_DATA;
+    }
+    pObj = se05x_sim_object_find(pSim, id);
+    if (!se05x_sim_has_private_key(pObj)) {
+        return SE05X_SIM_SW_CONDITIONS_NOT_SATISFIED;
+    }
+
+    ENSURE_OR_GO_CLEANUP(se05x_sim_ec_derive(pObj->pEcKey, pPub, pubLen, secret, sizeof(secret)) == 0);
+
+    sw = SE05X_SIM_SW_WRONG_LENGTH;
+    ENSURE_OR_GO_CLEANUP(se05x_sim_tlv_put(pRsp, rspSize, pRspLen, kSE05x_TAG_1, secret, sizeof(secret)) == 0);
+    sw = SE05X_SIM_SW_OK;
+cleanup:
+    OPENSSL_cleanse(secret, sizeof(secret));
+    return sw;
+}
+
+/**
+* Cipher of an AES mode and key length
+*/
+static const EVP_CIPHER *se05x_sim_aes_cipher(uint32_t mode, size_t keyLen)
+{
+    switch (mode) {
+    case kSE05x_CipherMode_AES_ECB_NOPAD:
+        return (keyLen == 16) ? EVP_aes_128_ecb() : (keyLen == 24) ? EVP_aes_192_ecb() : EVP_aes_256_ecb();
+    case kSE05x_CipherMode_AES_CBC_NOPAD:
+        return (keyLen == 16) ? EVP_aes_128_cbc() : (keyLen == 24) ? EVP_aes_192_cbc() : EVP_aes_256_cbc();
+    case kSE05x_CipherMode_AES_CTR:
+        return (keyLen == 16) ? EVP_aes_128_ctr() : (keyLen == 24) ? EVP_aes_192_ctr() : EVP_aes_256_ctr();
+    default:
+        return NULL;
+    }
+}
+
+/**
+* CipherOneShot with AES keys
+*/
+static uint16_t se05x_sim_cipher_one_shot(se05x_sim_t *pSim,
+    uint8_t p2,
+    uint8_t *pData,
+    size_t dataLen,
+    uint8_t *pRsp,
+    size_t rspSize,
+    size_t *pRspLen)
+{
+    size_t index                         = 0;
+    uint32_t id                          = 0;
+    uint32_t mode                        = 0;
+    uint8_t *pInput                      = NULL;
+    size_t inputLen                      = 0;
+    uint8_t *pIv                         = NULL;
+    size_t ivLen                         = 0;
+    uint8_t iv[SE05X_SIM_AES_BLOCK_LEN]  = {0};
+    uint8_t out[SE05X_SIM_MAX_APDU_LEN];
+    int outLen                           = 0;
+    int finalLen                         = 0;
+    const EVP_CIPHER *pCipher            = NULL;
+    EVP_CIPHER_CTX *pCtx                 = NULL;
+    se05x_sim_object_t *pObj             = NULL;
+    uint16_t sw                          = SE05X_SIM_SW_WRONG_DATA;
+
+    if ((se05x_sim_get_uint(pData, dataLen, &index, kSE05x_TAG_1, 4, &id) != 0) ||
+        (se05x_sim_get_uint(pData, dataLen, &index, kSE05x_TAG_2, 1, &mode) != 0) ||
+        (se05x_sim_get_buf(pData, dataLen, &index, kSE05x_TAG_3, &pInput, &inputLen) != 0)) {
+        return SE05X_SIM_SW_WRONG_DATA;
+    }
+    se05x_sim_get_buf(pData, dataLen, &index, kSE05x_TAG_4, &pIv, &ivLen);
+    if ((index != dataLen) || (inputLen > sizeof(out))) {
+        return SE05X_SIM_SW_WRONG_DATA;
+    }
+    pObj = se05x_sim_object_find(pSim, id);
+    if ((pObj == NULL) || (pObj->type != kSE05x_SecObjTyp_AES_KEY)) {
+        return SE05X_SIM_SW_CONDITIONS_NOT_SATISFIED;
+    }
+    pCipher = se05x_sim_aes_cipher(mode, pObj->dataLen);
+    if (pCipher == NULL) {
+        return SE05X_SIM_SW_WRONG_DATA;
+    }
+    if ((mode != kSE05x_CipherMode_AES_CTR) && ((inputLen % SE05X_SIM_AES_BLOCK_LEN) != 0)) {
+        return SE05X_SIM_SW_WRONG_LENGTH;
+    }
+    if (pIv != NULL) {
+        if (ivLen != SE05X_SIM_AES_BLOCK_LEN) {
+            return SE05X_SIM_SW_WRONG_DATA;
+        }
+        memcpy(iv, pIv, ivLen);
+    }
+
+    pCtx = EVP_CIPHER_CTX_new();
+    ENSURE_OR_GO_CLEANUP(pCtx != NULL);
+    ENSURE_OR_GO_CLEANUP(
+        EVP_CipherInit_ex(pCtx, pCipher, NULL, pObj->pData, iv, (p2 == kSE05x_P2_ENCRYPT_ONESHOT) ? 1 : 0) == 1);
+    EVP_CIPHER_CTX_set_padding(pCtx, 0);
+    ENSURE_OR_GO_CLEANUP(EVP_CipherUpdate(pCtx, out, &outLen, pInput, (int)inputLen) == 1);
+    ENSURE_OR_GO_CLEANUP(EVP_CipherFinal_ex(pCtx, &out[outLen], &finalLen) == 1);
+
+    sw = SE05X_SIM_SW_WRONG_LENGTH;
+    ENSURE_OR_GO_CLEANUP(
+        se05x_sim_tlv_put(pRsp, rspSize, pRspLen, kSE05x_TAG_1, out, (size_t)(outLen + finalLen)) == 0);
+    sw = SE05X_SIM_SW_OK;
+cleanup:
+    if (pCtx != NULL) {
+        EVP_CIPHER_CTX_free(pCtx);
+    }
+    return sw;
+}
+
+/**
+* ReadIDList, all identifiers fit into one response
+*/
+static uint16_t se05x_sim_read_id_list(
+    se05x_sim_t *pSim, uint8_t *pData, size_t dataLen, uint8_t *pRsp, size_t rspSize, size_t *pRspLen)
+{
+    size_t index                          = 0;
+    uint32_t offset                       = 0;
+    uint32_t filter                       = 0;
+    uint8_t list[4 * SE05X_SIM_MAX_OBJECTS];
+    size_t listLen                        = 0;
+    uint8_t more                          = 1; /* No more identifiers */
+    size_t i                              = 0;
+    uint32_t skipped                      = 0;
+
+    if ((se05x_sim_get_uint(pData, dataLen, &index, kSE05x_TAG_1, 2, &offset) != 0) ||
+        (se05x_sim_get_uint(pData, dataLen, &index, kSE05x_TAG_2, 1, &filter) != 0) || (index != dataLen)) {
+        return SE05X_SIM_SW_WRONG_DATA;
+    }
+    for (i = 0; i < SE05X_SIM_MAX_OBJECTS; i++) {
+        const se05x_sim_object_t *pObj = &pSim->objects[i];
+        if ((pObj->id == 0) || ((filter != SE05X_SIM_FILTER_ALL) && (filter != pObj->type))) {
+            continue;
+        }
+        if (skipped++ < offset) {
+            continue;
+        }
+        list[listLen++] = (uint8_t)(pObj->id >> 24);
+        list[listLen++] = (uint8_t)(pObj->id >> 16);
+        list[listLen++] = (uint8_t)(pObj->id >> 8);
+        list[listLen++] = (uint8_t)pObj->id;
+    }
+    if ((se05x_sim_tlv_put(pRsp, rspSize, pRspLen, kSE05x_TAG_1, &more, 1) != 0) ||
+        (se05x_sim_tlv_put(pRsp, rspSize, pRspLen, kSE05x_TAG_2, list, listLen) != 0)) {
+        return SE05X_SIM_SW_WRONG_LENGTH;
+    }
+    return SE05X_SIM_SW_OK;
+}
+
+/**
+* ReadSize / ReadType / CheckObjectExists / DeleteSecureObject, all addressed by identifier
+*/
+static uint16_t se05x_sim_object_command(se05x_sim_t *pSim,
+    uint8_t ins,
+    uint8_t p2,
+    uint8_t *pData,
+    size_t dataLen,
+    uint8_t *pRsp,
+    size_t rspSize,
+    size_t *pRspLen)
+{
+    size_t index             = 0;
+    uint32_t id              = 0;
+    uint8_t value[2]         = {0};
+    size_t size              = 0;
+    se05x_sim_object_t *pObj = NULL;
+
+    if ((se05x_sim_get_uint(pData, dataLen, &index, kSE05x_TAG_1, 4, &id) != 0) || (index != dataLen)) {
+        return SE05X_SIM_SW_WRONG_DATA;
+    }
+    pObj = se05x_sim_object_find(pSim, id);
+
+    if ((ins == kSE05x_INS_MGMT) && (p2 == kSE05x_P2_EXIST)) {
+        value[0] = (pObj != NULL) ? kSE05x_Result_SUCCESS : kSE05x_Result_FAILURE;
+        return se05x_sim_tlv_put(pRsp, rspSize, pRspLen, kSE05x_TAG_1, value, 1) ? SE05X_SIM_SW_WRONG_LENGTH :
+                                                                                  SE05X_SIM_SW_OK;
+    }
+    if (pObj == NULL) {
+        return SE05X_SIM_SW_NOT_FOUND;
+    }
+    if (ins == kSE05x_INS_MGMT) {
+        /* kSE05x_P2_DELETE_OBJECT */
+        if (se05x_sim_object_is_reserved(id)) {
+            return SE05X_SIM_SW_CONDITIONS_NOT_SATISFIED;
+        }
+        se05x_sim_object_free(pObj);
+        return SE05X_SIM_SW_OK;
+    }
+    if (p2 == kSE05x_P2_TYPE) {
+        value[0] = pObj->type;
+        value[1] = pObj->transient;
+        if ((se05x_sim_tlv_put(pRsp, rspSize, pRspLen, kSE05x_TAG_1, &value[0], 1) != 0) ||
+            (se05x_sim_tlv_put(pRsp, rspSize, pRspLen, kSE05x_TAG_2, &value[1], 1) != 0)) {
+            return SE05X_SIM_SW_WRONG_LENGTH;
+        }
+        return SE05X_SIM_SW_OK;
+    }
+    /* kSE05x_P2_SIZE, in bytes of the key or file */
+    size     = se05x_sim_is_ec_key(pObj) ? SE05X_SIM_EC_PRIV_LEN : pObj->dataLen;
+    value[0] = (uint8_t)(size >> 8);
+    value[1] = (uint8_t)size;
+    return se05x_sim_tlv_put(pRsp, rspSize, pRspLen, kSE05x_TAG_1, value, 2) ? SE05X_SIM_SW_WRONG_LENGTH :
+                                                                              SE05X_SIM_SW_OK;
+}
+
+/**
+* ISO7816 SELECT of the applet or the security domain
+*/
+static uint16_t se05x_sim_select(
+    se05x_sim_t *pSim, uint8_t *pData, size_t dataLen, uint8_t *pRsp, size_t rspSize, size_t *pRspLen)
+{
+    se05x_sim_scp_reset(pSim);
+    if ((dataLen == sizeof(gSe05xSim_appletAid)) && (memcmp(pData, gSe05xSim_appletAid, dataLen) == 0)) {
+        pSim->selected = SE05X_SIM_SELECTED_APPLET;
+        if (rspSize < sizeof(gSe05xSim_version)) {
+            return SE05X_SIM_SW_WRONG_LENGTH;
+        }
+        memcpy(pRsp, gSe05xSim_version, sizeof(gSe05xSim_version));
+        *pRspLen = sizeof(gSe05xSim_version);
+        return SE05X_SIM_SW_OK;
+    }
+    if ((dataLen == sizeof(gSe05xSim_ssdAid)) && (memcmp(pData, gSe05xSim_ssdAid, dataLen) == 0)) {
+        pSim->selected = SE05X_SIM_SELECTED_SSD;
+        return SE05X_SIM_SW_OK;
+    }
+    pSim->selected = SE05X_SIM_SELECTED_NONE;
+    return SE05X_SIM_SW_NOT_FOUND;
+}
+
+int se05x_sim_applet_init(se05x_sim_t *pSim)
+{
+    se05x_sim_object_t *pObj = NULL;
+
+    /* Key agreement key of ECKey sessions, fresh per simulator */
+    pObj = se05x_sim_object_alloc(pSim, SE05X_SIM_OBJID_ECKEY_SESSION, kSE05x_SecObjTyp_EC_KEY_PAIR);
+    ENSURE_OR_RETURN_ON_ERROR(pObj != NULL, 1);
+    pObj->curve  = kSE05x_ECCurve_NIST_P256;
+    pObj->pEcKey = se05x_sim_ec_key_new(NULL, 0, NULL, 0);
+    ENSURE_OR_RETURN_ON_ERROR(pObj->pEcKey != NULL, 1);
+
+    /* Provisioned auth key of ECKey sessions */
+    pObj = se05x_sim_object_alloc(pSim, SE05X_SIM_OBJID_ECKEY_AUTH, kSE05x_SecObjTyp_EC_PUB_KEY);
+    ENSURE_OR_RETURN_ON_ERROR(pObj != NULL, 1);
+    pObj->curve  = kSE05x_ECCurve_NIST_P256;
+    pObj->pEcKey = se05x_sim_ec_key_new(NULL, 0, pSim->config.ecKeyAuthPub, sizeof(pSim->config.ecKeyAuthPub));
+    ENSURE_OR_RETURN_ON_ERROR(pObj->pEcKey != NULL, 1);
+    return 0;
+}
+
+void se05x_sim_applet_free(se05x_sim_t *pSim)
+{
+    size_t i = 0;
+
+    for (i = 0; i < SE05X_SIM_MAX_OBJECTS; i++) {
+        se05x_sim_object_free(&pSim->objects[i]);
+    }
+}
+
+void se05x_sim_applet_deselect(se05x_sim_t *pSim)
+{
+    size_t i = 0;
+
+    pSim->selected = SE05X_SIM_SELECTED_NONE;
+    /* Transient objects are lost with the power */
+    for (i = 0; i < SE05X_SIM_MAX_OBJECTS; i++) {
+        if ((pSim->objects[i].id != 0) && pSim->objects[i].transient) {
+            se05x_sim_object_free(&pSim->objects[i]);
+        }
+    }
+}
+
+uint16_t se05x_sim_applet_process(se05x_sim_t *pSim, uint8_t *pCmd, size_t cmdLen, uint8_t *pRsp, size_t *pRspLen)
+{
+    uint8_t *pData  = NULL;
+    size_t dataLen  = 0;
+    size_t rspSize  = *pRspLen;
+    uint8_t cla     = 0;
+    uint8_t ins     = 0;
+    uint8_t p1      = 0;
+    uint8_t p2      = 0;
+    uint8_t curves[kSE05x_ECCurve_NIST_P256];
+
+    *pRspLen = 0;
+    if (se05x_sim_apdu_parse(pCmd, cmdLen, &pData, &dataLen) != 0) {
+        return SE05X_SIM_SW_WRONG_LENGTH;
+    }
+    cla = pCmd[0];
+    ins = pCmd[1];
+    p1  = pCmd[2];
+    p2  = pCmd[3];
+
+    if ((cla == SE05X_SIM_CLA_ISO7816) && (ins == SE05X_SIM_INS_SELECT)) {
+        pSim->latencyIns = ins;
+        return se05x_sim_select(pSim, pData, dataLen, pRsp, rspSize, pRspLen);
+    }
+    if (cla != SE05X_SIM_CLA_APPLET) {
+        return SE05X_SIM_SW_CLA_NOT_SUPPORTED;
+    }
+    pSim->latencyIns = ins & kSE05x_INS_MASK_INSTRUCTION;
+    if (pSim->selected != SE05X_SIM_SELECTED_APPLET) {
+        return SE05X_SIM_SW_INS_NOT_SUPPORTED;
+    }
+
+    switch (ins & kSE05x_INS_MASK_INSTRUCTION) {
+    case kSE05x_INS_WRITE:
+        switch (p1 & kSE05x_P1_MASK_CRED_TYPE) {
+        case kSE05x_P1_EC:
+            return se05x_sim_write_ec_key(pSim, ins, p1, pData, dataLen);
+        case kSE05x_P1_AES:
+        case kSE05x_P1_DES:
+        case kSE05x_P1_HMAC:
+            return se05x_sim_write_symm_key(pSim, ins, p1, pData, dataLen);
+        case kSE05x_P1_BINARY:
+            return se05x_sim_write_binary(pSim, ins, pData, dataLen);
+        case kSE05x_P1_CURVE:
+            /* Only NIST P-256, which is built in */
+            return SE05X_SIM_SW_OK;
+        default:
+            return SE05X_SIM_SW_WRONG_P1P2;
+        }
+    case kSE05x_INS_READ:
+        if ((p1 == kSE05x_P1_CURVE) && (p2 == kSE05x_P2_LIST)) {
+            memset(curves, kSE05x_Result_FAILURE, sizeof(curves));
+            curves[kSE05x_ECCurve_NIST_P256 - 1] = kSE05x_Result_SUCCESS;
+            return se05x_sim_tlv_put(pRsp, rspSize, pRspLen, kSE05x_TAG_1, curves, sizeof(curves)) ?
+                       SE05X_SIM_SW_WRONG_LENGTH :
+                       SE05X_SIM_SW_OK;
+        }
+        switch (p2) {
+        case kSE05x_P2_DEFAULT:
+            return se05x_sim_read_object(pSim, pData, dataLen, pRsp, rspSize, pRspLen);
+        case kSE05x_P2_LIST:
+            return se05x_sim_read_id_list(pSim, pData, dataLen, pRsp, rspSize, pRspLen);
+        case kSE05x_P2_SIZE:
+        case kSE05x_P2_TYPE:
+            return se05x_sim_object_command(pSim, kSE05x_INS_READ, p2, pData, dataLen, pRsp, rspSize, pRspLen);
+        default:
+            return SE05X_SIM_SW_WRONG_P1P2;
+        }
+    case kSE05x_INS_CRYPTO:
+        if ((p1 == kSE05x_P1_SIGNATURE) && ((p2 == kSE05x_P2_SIGN) || (p2 == kSE05x_P2_VERIFY))) {
+            return se05x_sim_ecdsa(pSim, p2, pData, dataLen, pRsp, rspSize, pRspLen);
+        }
+        if ((p1 == kSE05x_P1_EC) && (p2 == kSE05x_P2_DH)) {
+            return se05x_sim_ecdh(pSim, pData, dataLen, pRsp, rspSize, pRspLen);
+        }
+        if ((p1 == kSE05x_P1_CIPHER) && ((p2 == kSE05x_P2_ENCRYPT_ONESHOT) || (p2 == kSE05x_P2_DECRYPT_ONESHOT))) {
+            return se05x_sim_cipher_one_shot(pSim, p2, pData, dataLen, pRsp, rspSize, pRspLen);
+        }
+        return SE05X_SIM_SW_WRONG_P1P2;
+    case kSE05x_INS_MGMT:
+        switch (p2) {
+        case kSE05x_P2_VERSION:
+            return se05x_sim_tlv_put(pRsp, rspSize, pRspLen, kSE05x_TAG_1, gSe05xSim_version, sizeof(gSe05xSim_version)) ?
+                       SE05X_SIM_SW_WRONG_LENGTH :
+                       SE05X_SIM_SW_OK;
+        case kSE05x_P2_EXIST:
+            return se05x_sim_object_command(pSim, kSE05x_INS_MGMT, p2, pData, dataLen, pRsp, rspSize, pRspLen);
+        case kSE05x_P2_DELETE_OBJECT:
+            if (p1 == kSE05x_P1_CURVE) {
+                return SE05X_SIM_SW_OK;
+            }
+            return se05x_sim_object_command(pSim, kSE05x_INS_MGMT, p2, pData, dataLen, pRsp, rspSize, pRspLen);
+        case kSE05x_P2_SESSION_CREATE: {
+            size_t index = 0;
+            uint32_t id  = 0;
+            uint8_t sessionId[SE05X_SIM_SESSION_ID_LEN];
+            uint16_t sw  = SE05X_SIM_SW_OK;
+            if ((se05x_sim_get_uint(pData, dataLen, &index, kSE05x_TAG_1, 4, &id) != 0) || (index != dataLen)) {
+                return SE05X_SIM_SW_WRONG_DATA;
+            }
+            sw = se05x_sim_scp_create_session(pSim, id, sessionId);
+            if (sw != SE05X_SIM_SW_OK) {
+                return sw;
+            }
+            return se05x_sim_tlv_put(pRsp, rspSize, pRspLen, kSE05x_TAG_1, sessionId, sizeof(sessionId)) ?
+                       SE05X_SIM_SW_WRONG_LENGTH :
+                       SE05X_SIM_SW_OK;
+        }
+        case kSE05x_P2_SESSION_CLOSE:
+            return se05x_sim_scp_close_session(pSim);
+        default:
+            return SE05X_SIM_SW_WRONG_P1P2;
+        }
+    default:
+        return SE05X_SIM_SW_INS_NOT_SUPPORTED;
+    }
+}
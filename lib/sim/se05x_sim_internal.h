@@ -0,0 +1,163 @@
+/** @file se05x_sim_internal.h
+ *  @brief Internal state of the software SE05x simulator.
+ *
+ * Copyright 2024 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SE05X_SIM_INTERNAL_H_INC
+#define SE05X_SIM_INTERNAL_H_INC
+
+/* ********************** Include files ********************** */
+#include <openssl/evp.h>
+#include "se05x_sim.h"
+#include "se05x_tlv.h"
+#include "phNxpEseProto7816_3.h"
+
+/* ********************** Constants ********************** */
+
+/* Largest command / response APDU handled */
+#define SE05X_SIM_MAX_APDU_LEN 2048
+/* Largest information field sent or accepted in one frame */
+#define SE05X_SIM_MAX_INF_LEN 1024
+#define SE05X_SIM_MAX_FRAME_LEN (PH_PROTO_7816_HEADER_LEN + SE05X_SIM_MAX_INF_LEN + PH_PROTO_7816_CRC_LEN)
+/* Number of secure objects in the store */
+#define SE05X_SIM_MAX_OBJECTS 64
+
+/* Node addresses of the frames */
+#define SE05X_SIM_NAD_HOST 0x5A
+#define SE05X_SIM_NAD_SE 0xA5
+
+/* Reserved objects used by the ECKey session */
+#define SE05X_SIM_OBJID_ECKEY_AUTH 0x7DA00003u
+#define SE05X_SIM_OBJID_ECKEY_SESSION 0x7FFF0201u
+
+/* CLA of the SE05x applet commands */
+#define SE05X_SIM_CLA_APPLET 0x80
+
+/* ISO7816 SELECT */
+#define SE05X_SIM_CLA_ISO7816 0x00
+#define SE05X_SIM_INS_SELECT 0xA4
+
+#define SE05X_SIM_SESSION_ID_LEN 8
+#define SE05X_SIM_SCP_KEY_LEN 16
+#define SE05X_SIM_SCP_MAC_LEN 8
+
+/* Status words of the simulated applet */
+#define SE05X_SIM_SW_OK 0x9000
+#define SE05X_SIM_SW_WRONG_LENGTH 0x6700
+#define SE05X_SIM_SW_SECURITY_STATUS 0x6982
+#define SE05X_SIM_SW_CONDITIONS_NOT_SATISFIED 0x6985
+#define SE05X_SIM_SW_WRONG_DATA 0x6A80
+#define SE05X_SIM_SW_FILE_FULL 0x6A84
+#define SE05X_SIM_SW_NOT_FOUND 0x6A82
+#define SE05X_SIM_SW_WRONG_P1P2 0x6A86
+#define SE05X_SIM_SW_INS_NOT_SUPPORTED 0x6D00
+#define SE05X_SIM_SW_CLA_NOT_SUPPORTED 0x6E00
+
+/* ********************** Data types ********************** */
+
+/* Secure object */
+typedef struct se05x_sim_object
+{
+    uint32_t id;      /* 0 for a free slot */
+    uint8_t type;     /* SE05x_SecObjTyp_t */
+    uint8_t curve;    /* SE05x_ECCurve_t of EC keys */
+    uint8_t transient;
+    EVP_PKEY *pEcKey; /* EC keys */
+    uint8_t *pData;   /* Symmetric keys and binary files */
+    size_t dataLen;
+} se05x_sim_object_t;
+
+/* Keys and chaining state of a secure channel (SCP03 or ECKey) */
+typedef struct se05x_sim_channel
+{
+    uint8_t active;
+    uint8_t encKey[SE05X_SIM_SCP_KEY_LEN];
+    uint8_t macKey[SE05X_SIM_SCP_KEY_LEN];
+    uint8_t rmacKey[SE05X_SIM_SCP_KEY_LEN];
+    uint8_t mcv[SE05X_SIM_SCP_KEY_LEN];
+    uint8_t counter[SE05X_SIM_SCP_KEY_LEN];
+} se05x_sim_channel_t;
+
+typedef enum
+{
+    kSe05xSimLink_Idle,       /* Waiting for a command */
+    kSe05xSimLink_Processing, /* Command received, response not yet released */
+    kSe05xSimLink_Responding, /* Response being sent */
+} se05x_sim_link_state_t;
+
+struct se05x_sim
+{
+    se05x_sim_config_t config;
+    se05x_sim_stats_t stats;
+    uint64_t prng; /* xorshift64 state of the injections */
+
+    /* T=1oI2C link */
+    se05x_sim_link_state_t linkState;
+    uint8_t seqTx;     /* N(S) of the next I-frame of the SE */
+    uint8_t seqRx;     /* N(S) of the next I-frame expected from the host */
+    uint16_t ifsd;     /* Information field size of the host */
+    uint8_t out[SE05X_SIM_MAX_FRAME_LEN];    /* Frame pending for the host */
+    uint32_t outLen;   /* 0 when nothing is pending */
+    uint32_t outPos;
+    uint8_t lastTx[SE05X_SIM_MAX_FRAME_LEN]; /* Last I- or R-frame, sent again on request */
+    uint32_t lastTxLen;
+    uint8_t lastTxIsIBlock;
+    uint64_t readyAtUs; /* Time at which the next WTX / response is released */
+    uint32_t sliceUs;   /* Processing time between two WTX requests */
+    uint8_t wtxLeft;
+    uint8_t wtxPending; /* S(WTX) sent, response of the host awaited */
+
+    /* APDU */
+    uint8_t cmd[SE05X_SIM_MAX_APDU_LEN];
+    size_t cmdLen;
+    uint8_t cmdOverflow;
+    uint8_t rsp[SE05X_SIM_MAX_APDU_LEN];
+    size_t rspLen;
+    size_t rspSent;
+    uint8_t latencyIns; /* Instruction of the innermost command, selects the latency */
+
+    /* Applet */
+    uint8_t selected;
+    se05x_sim_object_t objects[SE05X_SIM_MAX_OBJECTS];
+
+    /* Platform SCP03 */
+    uint8_t scp03HostChallenge[8];
+    uint8_t scp03CardChallenge[8];
+    uint8_t scp03Initialized; /* INITIALIZE UPDATE done, EXTERNAL AUTHENTICATE awaited */
+    se05x_sim_channel_t scp03;
+
+    /* ECKey session */
+    uint8_t eckeySessionId[SE05X_SIM_SESSION_ID_LEN];
+    uint8_t eckeySessionCreated;
+    uint8_t eckeyClosing; /* SessionClose answered, session dropped after the response */
+    se05x_sim_channel_t eckey;
+};
+
+/* ********************** Function Prototypes ********************** */
+
+/* Applet (se05x_sim_applet.c) */
+int se05x_sim_applet_init(se05x_sim_t *pSim);
+void se05x_sim_applet_free(se05x_sim_t *pSim);
+void se05x_sim_applet_deselect(se05x_sim_t *pSim);
+uint16_t se05x_sim_applet_process(se05x_sim_t *pSim, uint8_t *pCmd, size_t cmdLen, uint8_t *pRsp, size_t *pRspLen);
+se05x_sim_object_t *se05x_sim_object_find(se05x_sim_t *pSim, uint32_t id);
+int se05x_sim_ec_public_key(const EVP_PKEY *pEcKey, uint8_t *pKey, size_t *pKeyLen);
+EVP_PKEY *se05x_sim_ec_key_new(const uint8_t *pPriv, size_t privLen, const uint8_t *pPub, size_t pubLen);
+int se05x_sim_ec_sign(EVP_PKEY *pEcKey, const uint8_t *pHash, size_t hashLen, uint8_t *pSig, size_t *pSigLen);
+int se05x_sim_ec_verify(EVP_PKEY *pEcKey, const uint8_t *pHash, size_t hashLen, const uint8_t *pSig, size_t sigLen);
+int se05x_sim_ec_derive(EVP_PKEY *pEcKey, const uint8_t *pPub, size_t pubLen, uint8_t *pSecret, size_t secretLen);
+
+/* Secure channels (se05x_sim_scp.c) */
+void se05x_sim_scp_reset(se05x_sim_t *pSim);
+uint16_t se05x_sim_scp_process(se05x_sim_t *pSim, uint8_t *pCmd, size_t cmdLen, uint8_t *pRsp, size_t *pRspLen);
+uint16_t se05x_sim_scp_create_session(se05x_sim_t *pSim, uint32_t authId, uint8_t *pSessionId);
+uint16_t se05x_sim_scp_close_session(se05x_sim_t *pSim);
+
+/* Helpers shared by the applet and the secure channels */
+int se05x_sim_apdu_parse(uint8_t *pCmd, size_t cmdLen, uint8_t **ppData, size_t *pDataLen);
+int se05x_sim_tlv_put(uint8_t *pBuf, size_t bufSize, size_t *pBufLen, uint8_t tag, const uint8_t *pValue, size_t len);
+size_t se05x_sim_put_sw(uint8_t *pRsp, size_t rspLen, uint16_t sw);
+
+#endif //#ifndef SE05X_SIM_INTERNAL_H_INC
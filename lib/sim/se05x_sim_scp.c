@@ -0,0 +1,681 @@
+/** @file se05x_sim_scp.c
+ *  @brief Software SE05x simulator, card side of Platform SCP03 and ECKey sessions.
+ *
+ * Copyright 2024 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* ********************** Include files ********************** */
+#include <string.h>
+#include <openssl/core_names.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <openssl/sha.h>
+#include "se05x_sim_internal.h"
+#include "sm_port.h"
+
+/* ********************** Defines ********************** */
+
+#define SE05X_SIM_CLA_GP 0x80
+#define SE05X_SIM_CLA_SECURE 0x04
+#define SE05X_SIM_INS_INITIALIZE_UPDATE 0x50
+#define SE05X_SIM_INS_EXTERNAL_AUTHENTICATE 0x82
+#define SE05X_SIM_INS_INTERNAL_AUTHENTICATE 0x88
+
+#define SE05X_SIM_SCP_CHALLENGE_LEN 8
+#define SE05X_SIM_SCP_PAD_BYTE 0x80
+#define SE05X_SIM_SCP_SW_LEN 2
+/* Room a wrapped response needs besides the plain one: padding and MAC */
+#define SE05X_SIM_SCP_WRAP_OVERHEAD (SE05X_SIM_SCP_KEY_LEN + SE05X_SIM_SCP_MAC_LEN)
+
+/* Derivation constants (GP SCP03 6.2.2) */
+#define SE05X_SIM_DD_CARD_CRYPTOGRAM 0x00
+#define SE05X_SIM_DD_HOST_CRYPTOGRAM 0x01
+#define SE05X_SIM_DD_SENC 0x04
+#define SE05X_SIM_DD_SMAC 0x06
+#define SE05X_SIM_DD_SRMAC 0x07
+#define SE05X_SIM_DD_INITIAL_MCV 0x08
+#define SE05X_SIM_DD_RECEIPT 0x09
+#define SE05X_SIM_DD_L_64BIT 0x0040
+#define SE05X_SIM_DD_L_128BIT 0x0080
+#define SE05X_SIM_DD_LABEL_LEN 12
+
+/* Key parameters of ECKey sessions, bound into the master key */
+#define SE05X_SIM_ECKEY_SCP_CONFIG 0x01
+#define SE05X_SIM_ECKEY_SECURITY_LEVEL 0x33
+#define SE05X_SIM_ECKEY_KEY_TYPE_AES 0x88
+#define SE05X_SIM_ECKEY_KEY_LEN_AES 0x10
+#define SE05X_SIM_ECKEY_DR_SE_LEN 16
+
+/* Tags of INTERNAL AUTHENTICATE */
+#define SE05X_SIM_TAG_CRT 0xA6
+#define SE05X_SIM_TAG_EPK_HI 0x7F
+#define SE05X_SIM_TAG_EPK_LO 0x49
+#define SE05X_SIM_TAG_SIG_HI 0x5F
+#define SE05X_SIM_TAG_SIG_LO 0x37
+#define SE05X_SIM_TAG_ECC_PUB_KEY 0xB0
+#define SE05X_SIM_TAG_DR_SE 0x85
+#define SE05X_SIM_TAG_RECEIPT 0x86
+
+/* ********************** Global variables ********************** */
+
+/* Key diversification data and key information of INITIALIZE UPDATE */
+static const uint8_t gSe05xSim_keyDivData[10] = {0};
+static const uint8_t gSe05xSim_keyInfo[3]     = {0x0B, 0x03, 0x00};
+
+/* ********************** Functions ********************** */
+
+/**
+* AES-CMAC over up to three concatenated parts
+*/
+static int se05x_sim_cmac(const uint8_t *pKey,
+    const uint8_t *pData1,
+    size_t data1Len,
+    const uint8_t *pData2,
+    size_t data2Len,
+    const uint8_t *pData3,
+    size_t data3Len,
+    uint8_t *pMac)
+{
+    int ret               = 1;
+    size_t macLen         = 0;
+    char cipher[]         = "AES-128-CBC";
+    EVP_MAC *pMacAlg      = EVP_MAC_fetch(NULL, OSSL_MAC_NAME_CMAC, NULL);
+    EVP_MAC_CTX *pCmacCtx = NULL;
+    OSSL_PARAM params[2];
+
+    params[0] = OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_CIPHER, cipher, 0);
+    params[1] = OSSL_PARAM_construct_end();
+
+    ENSURE_OR_GO_EXIT(pMacAlg != NULL);
+    pCmacCtx = EVP_MAC_CTX_new(pMacAlg);
+    ENSURE_OR_GO_EXIT(pCmacCtx != NULL);
+    ENSURE_OR_GO_EXIT(EVP_MAC_init(pCmacCtx, pKey, SE05X_SIM_SCP_KEY_LEN, params) == 1);
+    ENSURE_OR_GO_EXIT(EVP_MAC_update(pCmacCtx, pData1, data1Len) == 1);
+    if (data2Len > 0) {
+        ENSURE_OR_GO_EXIT(EVP_MAC_update(pCmacCtx, pData2, data2Len) == 1);
+    }
+    if (data3Len > 0) {
+        ENSURE_OR_GO_EXIT(EVP_MAC_update(pCmacCtx, pData3, data3Len) == 1);
+    }
+    ENSURE_OR_GO_EXIT(EVP_MAC_final(pCmacCtx, pMac, &macLen, SE05X_SIM_SCP_KEY_LEN) == 1);
+    ret = 0;
+exit:
+    EVP_MAC_CTX_free(pCmacCtx);
+    EVP_MAC_free(pMacAlg);
+    return ret;
+}
+
+/**
+* AES-128-CBC without padding, in place allowed
+*/
+static int se05x_sim_aes_cbc(
+    const uint8_t *pKey, const uint8_t *pIv, const uint8_t *pIn, uint8_t *pOut, size_t len, int encrypt)
+{
+    int ret              = 1;
+    int outLen           = 0;
+    EVP_CIPHER_CTX *pCtx = EVP_CIPHER_CTX_new();
+
+    ENSURE_OR_GO_EXIT(pCtx != NULL);
+    ENSURE_OR_GO_EXIT(EVP_CipherInit_ex(pCtx, EVP_aes_128_cbc(), NULL, pKey, pIv, encrypt) == 1);
+    EVP_CIPHER_CTX_set_padding(pCtx, 0);
+    ENSURE_OR_GO_EXIT(EVP_CipherUpdate(pCtx, pOut, &outLen, pIn, (int)len) == 1);
+    ret = 0;
+exit:
+    if (pCtx != NULL) {
+        EVP_CIPHER_CTX_free(pCtx);
+    }
+    return ret;
+}
+
+/**
+* Key / cryptogram derivation of SCP03 (KDF in counter mode, one block)
+*/
+static int se05x_sim_derive(
+    const uint8_t *pKey, uint8_t constant, uint16_t lBits, const uint8_t *pContext, size_t contextLen, uint8_t *pOut)
+{
+    uint8_t dd[SE05X_SIM_DD_LABEL_LEN + 4] = {0};
+
+    dd[SE05X_SIM_DD_LABEL_LEN - 1] = constant;
+    dd[SE05X_SIM_DD_LABEL_LEN]     = 0x00; /* Separation indicator */
+    dd[SE05X_SIM_DD_LABEL_LEN + 1] = (uint8_t)(lBits >> 8);
+    dd[SE05X_SIM_DD_LABEL_LEN + 2] = (uint8_t)lBits;
+    dd[SE05X_SIM_DD_LABEL_LEN + 3] = 0x01; /* Counter */
+    return se05x_sim_cmac(pKey, dd, sizeof(dd), pContext, contextLen, NULL, 0, pOut);
+}
+
+static void se05x_sim_counter_inc(uint8_t *pCounter)
+{
+    int i = SE05X_SIM_SCP_KEY_LEN - 1;
+
+    while (i > 0) {
+        if (pCounter[i] < 0xFF) {
+            pCounter[i]++;
+            break;
+        }
+        pCounter[i] = 0;
+        i--;
+    }
+}
+
+/**
+* Starts a channel with the initial command counter
+*/
+static void se05x_sim_channel_start(se05x_sim_channel_t *pChannel)
+{
+    memset(pChannel->counter, 0, sizeof(pChannel->counter));
+    pChannel->counter[SE05X_SIM_SCP_KEY_LEN - 1] = 0x01;
+    pChannel->active                             = 1;
+}
+
+static void se05x_sim_channel_stop(se05x_sim_channel_t *pChannel)
+{
+    OPENSSL_cleanse(pChannel, sizeof(*pChannel));
+}
+
+/**
+* Checks C-MAC and removes C-DECRYPTION of a wrapped command, the plain command is
+* rebuilt without Le. The channel is closed on a wrong MAC.
+*/
+static uint16_t se05x_sim_channel_unwrap(
+    se05x_sim_channel_t *pChannel, uint8_t *pCmd, size_t cmdLen, uint8_t *pPlain, size_t *pPlainLen)
+{
+    uint8_t *pData                    = NULL;
+    size_t dataLen                    = 0;
+    size_t encLen                     = 0;
+    size_t macOffset                  = 0;
+    size_t plainDataLen               = 0;
+    size_t i                          = 0;
+    uint8_t mac[SE05X_SIM_SCP_KEY_LEN];
+    uint8_t iv[SE05X_SIM_SCP_KEY_LEN];
+    uint8_t ivZero[SE05X_SIM_SCP_KEY_LEN] = {0};
+
+    if ((se05x_sim_apdu_parse(pCmd, cmdLen, &pData, &dataLen) != 0) || (dataLen < SE05X_SIM_SCP_MAC_LEN)) {
+        return SE05X_SIM_SW_WRONG_LENGTH;
+    }
+    encLen    = dataLen - SE05X_SIM_SCP_MAC_LEN;
+    macOffset = (size_t)(pData - pCmd) + encLen;
+    if (((encLen % SE05X_SIM_SCP_KEY_LEN) != 0) || (*pPlainLen < (7 + encLen))) {
+        return SE05X_SIM_SW_WRONG_LENGTH;
+    }
+
+    /* MAC over MCV, header, Lc and the encrypted data */
+    if ((se05x_sim_cmac(pChannel->macKey, pChannel->mcv, sizeof(pChannel->mcv), pCmd, macOffset, NULL, 0, mac) != 0) ||
+        (CRYPTO_memcmp(mac, &pCmd[macOffset], SE05X_SIM_SCP_MAC_LEN) != 0)) {
+        se05x_sim_channel_stop(pChannel);
+        return SE05X_SIM_SW_SECURITY_STATUS;
+    }
+    memcpy(pChannel->mcv, mac, sizeof(pChannel->mcv));
+
+    pPlain[0] = pCmd[0] & (uint8_t)~SE05X_SIM_CLA_SECURE;
+    memcpy(&pPlain[1], &pCmd[1], 3);
+    if (encLen == 0) {
+        *pPlainLen = 4;
+        return SE05X_SIM_SW_OK;
+    }
+
+    if ((se05x_sim_aes_cbc(pChannel->encKey, ivZero, pChannel->counter, iv, sizeof(iv), 1) != 0) ||
+        (se05x_sim_aes_cbc(pChannel->encKey, iv, pData, &pPlain[7], encLen, 0) != 0)) {
+        return SE05X_SIM_SW_WRONG_DATA;
+    }
+    /* Remove the 80 00.. padding */
+    for (i = encLen; i > 0; i--) {
+        if (pPlain[7 + i - 1] != 0x00) {
+            break;
+        }
+    }
+    if ((i == 0) || (pPlain[7 + i - 1] != SE05X_SIM_SCP_PAD_BYTE)) {
+        return SE05X_SIM_SW_WRONG_DATA;
+    }
+    plainDataLen = i - 1;
+
+    if ((plainDataLen <= 0xFF) && (pCmd[4] != 0x00)) {
+        pPlain[4] = (uint8_t)plainDataLen;
+        memmove(&pPlain[5], &pPlain[7], plainDataLen);
+        *pPlainLen = 5 + plainDataLen;
+    }
+    else {
+        pPlain[4]  = 0x00;
+        pPlain[5]  = (uint8_t)(plainDataLen >> 8);
+        pPlain[6]  = (uint8_t)plainDataLen;
+        *pPlainLen = 7 + plainDataLen;
+    }
+    return SE05X_SIM_SW_OK;
+}
+
+/**
+* Applies R-ENCRYPTION and R-MAC to the response body of status word sw, in place.
+* Responses with an error are sent without MAC. The command counter moves on in any case.
+*/
+static int se05x_sim_channel_wrap(
+    se05x_sim_channel_t *pChannel, uint16_t sw, uint8_t *pRsp, size_t rspSize, size_t *pRspLen)
+{
+    int ret                               = 1;
+    size_t len                            = *pRspLen;
+    uint8_t swBuf[SE05X_SIM_SCP_SW_LEN]   = {(uint8_t)(sw >> 8), (uint8_t)sw};
+    uint8_t mac[SE05X_SIM_SCP_KEY_LEN];
+    uint8_t iv[SE05X_SIM_SCP_KEY_LEN];
+    uint8_t counter[SE05X_SIM_SCP_KEY_LEN];
+    uint8_t ivZero[SE05X_SIM_SCP_KEY_LEN] = {0};
+
+    if (sw != SE05X_SIM_SW_OK) {
+        *pRspLen = 0;
+        ret      = 0;
+        goto exit;
+    }
+    if (len > 0) {
+        ENSURE_OR_GO_EXIT((len + SE05X_SIM_SCP_WRAP_OVERHEAD) <= rspSize);
+        pRsp[len++] = SE05X_SIM_SCP_PAD_BYTE;
+        while ((len % SE05X_SIM_SCP_KEY_LEN) != 0) {
+            pRsp[len++] = 0x00;
+        }
+        memcpy(counter, pChannel->counter, sizeof(counter));
+        counter[0] = SE05X_SIM_SCP_PAD_BYTE;
+        ENSURE_OR_GO_EXIT(se05x_sim_aes_cbc(pChannel->encKey, ivZero, counter, iv, sizeof(iv), 1) == 0);
+        ENSURE_OR_GO_EXIT(se05x_sim_aes_cbc(pChannel->encKey, iv, pRsp, pRsp, len, 1) == 0);
+    }
+    ENSURE_OR_GO_EXIT((len + SE05X_SIM_SCP_MAC_LEN) <= rspSize);
+    ENSURE_OR_GO_EXIT(se05x_sim_cmac(pChannel->rmacKey,
+                          pChannel->mcv,
+                          sizeof(pChannel->mcv),
+                          pRsp,
+                          len,
+                          swBuf,
+                          sizeof(swBuf),
+                          mac) == 0);
+    memcpy(&pRsp[len], mac, SE05X_SIM_SCP_MAC_LEN);
+    *pRspLen = len + SE05X_SIM_SCP_MAC_LEN;
+    ret      = 0;
+exit:
+    se05x_sim_counter_inc(pChannel->counter);
+    return ret;
+}
+
+/**
+* INITIALIZE UPDATE: derives the session keys and returns the card cryptogram
+*/
+static uint16_t se05x_sim_scp03_initialize_update(
+    se05x_sim_t *pSim, uint8_t *pCmd, size_t cmdLen, uint8_t *pRsp, size_t rspSize, size_t *pRspLen)
+{
+    uint8_t *pData  = NULL;
+    size_t dataLen  = 0;
+    size_t len      = 0;
+    uint8_t context[2 * SE05X_SIM_SCP_CHALLENGE_LEN];
+    uint8_t cryptogram[SE05X_SIM_SCP_KEY_LEN];
+    se05x_sim_channel_t *pChannel = &pSim->scp03;
+
+    se05x_sim_channel_stop(pChannel);
+    pSim->scp03Initialized = 0;
+    if ((se05x_sim_apdu_parse(pCmd, cmdLen, &pData, &dataLen) != 0) || (dataLen != SE05X_SIM_SCP_CHALLENGE_LEN)) {
+        return SE05X_SIM_SW_WRONG_LENGTH;
+    }
+    if (rspSize < (sizeof(gSe05xSim_keyDivData) + sizeof(gSe05xSim_keyInfo) + 2 * SE05X_SIM_SCP_CHALLENGE_LEN)) {
+        return SE05X_SIM_SW_WRONG_LENGTH;
+    }
+    memcpy(pSim->scp03HostChallenge, pData, SE05X_SIM_SCP_CHALLENGE_LEN);
+    if (RAND_bytes(pSim->scp03CardChallenge, SE05X_SIM_SCP_CHALLENGE_LEN) != 1) {
+        return SE05X_SIM_SW_CONDITIONS_NOT_SATISFIED;
+    }
+    memcpy(context, pSim->scp03HostChallenge, SE05X_SIM_SCP_CHALLENGE_LEN);
+    memcpy(&context[SE05X_SIM_SCP_CHALLENGE_LEN], pSim->scp03CardChallenge, SE05X_SIM_SCP_CHALLENGE_LEN);
+
+    if ((se05x_sim_derive(pSim->config.scp03EncKey,
+             SE05X_SIM_DD_SENC,
+             SE05X_SIM_DD_L_128BIT,
+             context,
+             sizeof(context),
+             pChannel->encKey) != 0) ||
+        (se05x_sim_derive(pSim->config.scp03MacKey,
+             SE05X_SIM_DD_SMAC,
+             SE05X_SIM_DD_L_128BIT,
+             context,
+             sizeof(context),
+             pChannel->macKey) != 0) ||
+        (se05x_sim_derive(pSim->config.scp03MacKey,
+             SE05X_SIM_DD_SRMAC,
+             SE05X_SIM_DD_L_128BIT,
+             context,
+             sizeof(context),
+             pChannel->rmacKey) != 0) ||
+        (se05x_sim_derive(pChannel->macKey,
+             SE05X_SIM_DD_CARD_CRYPTOGRAM,
+             SE05X_SIM_DD_L_64BIT,
+             context,
+             sizeof(context),
+             cryptogram) != 0)) {
+        return SE05X_SIM_SW_CONDITIONS_NOT_SATISFIED;
+    }
+
+    memcpy(&pRsp[len], gSe05xSim_keyDivData, sizeof(gSe05xSim_keyDivData));
+    len += sizeof(gSe05xSim_keyDivData);
+    memcpy(&pRsp[len], gSe05xSim_keyInfo, sizeof(gSe05xSim_keyInfo));
+    len += sizeof(gSe05xSim_keyInfo);
+    memcpy(&pRsp[len], pSim->scp03CardChallenge, SE05X_SIM_SCP_CHALLENGE_LEN);
+    len += SE05X_SIM_SCP_CHALLENGE_LEN;
+    memcpy(&pRsp[len], cryptogram, SE05X_SIM_SCP_CHALLENGE_LEN);
+    len += SE05X_SIM_SCP_CHALLENGE_LEN;
+    *pRspLen = len;
+
+    pSim->scp03Initialized = 1;
+    return SE05X_SIM_SW_OK;
+}
+
+/**
+* EXTERNAL AUTHENTICATE: checks host cryptogram and C-MAC, opens the channel
+*/
+static uint16_t se05x_sim_scp03_external_authenticate(se05x_sim_t *pSim, uint8_t *pCmd, size_t cmdLen)
+{
+    uint8_t *pData  = NULL;
+    size_t dataLen  = 0;
+    uint8_t context[2 * SE05X_SIM_SCP_CHALLENGE_LEN];
+    uint8_t cryptogram[SE05X_SIM_SCP_KEY_LEN];
+    uint8_t mac[SE05X_SIM_SCP_KEY_LEN];
+    uint8_t mcvZero[SE05X_SIM_SCP_KEY_LEN] = {0};
+    se05x_sim_channel_t *pChannel          = &pSim->scp03;
+
+    if (!pSim->scp03Initialized) {
+        return SE05X_SIM_SW_CONDITIONS_NOT_SATISFIED;
+    }
+    pSim->scp03Initialized = 0;
+    if ((se05x_sim_apdu_parse(pCmd, cmdLen, &pData, &dataLen) != 0) ||
+        (dataLen != (SE05X_SIM_SCP_CHALLENGE_LEN + SE05X_SIM_SCP_MAC_LEN))) {
+        return SE05X_SIM_SW_WRONG_LENGTH;
+    }
+    memcpy(context, pSim->scp03HostChallenge, SE05X_SIM_SCP_CHALLENGE_LEN);
+    memcpy(&context[SE05X_SIM_SCP_CHALLENGE_LEN], pSim->scp03CardChallenge, SE05X_SIM_SCP_CHALLENGE_LEN);
+    if ((se05x_sim_derive(pChannel->macKey,
+             SE05X_SIM_DD_HOST_CRYPTOGRAM,
+             SE05X_SIM_DD_L_64BIT,
+             context,
+             sizeof(context),
+             cryptogram) != 0) ||
+        (CRYPTO_memcmp(cryptogram, pData, SE05X_SIM_SCP_CHALLENGE_LEN) != 0)) {
+        se05x_sim_channel_stop(pChannel);
+        return SE05X_SIM_SW_SECURITY_STATUS;
+    }
+    /* The MAC chains from zero, header and Lc and cryptogram are MACed */
+    if ((se05x_sim_cmac(pChannel->macKey, mcvZero, sizeof(mcvZero), pCmd, 5 + SE05X_SIM_SCP_CHALLENGE_LEN, NULL, 0, mac) !=
+            0) ||
+        (CRYPTO_memcmp(mac, &pData[SE05X_SIM_SCP_CHALLENGE_LEN], SE05X_SIM_SCP_MAC_LEN) != 0)) {
+        se05x_sim_channel_stop(pChannel);
+        return SE05X_SIM_SW_SECURITY_STATUS;
+    }
+    memcpy(pChannel->mcv, mac, sizeof(pChannel->mcv));
+    se05x_sim_channel_start(pChannel);
+    return SE05X_SIM_SW_OK;
+}
+
+/**
+* INTERNAL AUTHENTICATE of an ECKey session: checks the host signature with the auth key,
+* agrees the master key with the ephemeral key of the host and opens the channel
+*/
+static uint16_t se05x_sim_eckey_internal_authenticate(
+    se05x_sim_t *pSim, uint8_t *pCmd, size_t cmdLen, uint8_t *pRsp, size_t rspSize, size_t *pRspLen)
+{
+    uint8_t *pData                         = NULL;
+    size_t dataLen                         = 0;
+    size_t signedLen                       = 0;
+    size_t i                               = 0;
+    uint8_t *pEpk                          = NULL;
+    size_t epkLen                          = 0;
+    uint8_t *pSig                          = NULL;
+    size_t sigLen                          = 0;
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+    uint8_t shared[32];
+    uint8_t drSe[SE05X_SIM_ECKEY_DR_SE_LEN];
+    uint8_t derivation[4 + sizeof(shared) + sizeof(drSe) + 4];
+    size_t derivationLen                   = 0;
+    uint8_t master[SHA256_DIGEST_LENGTH];
+    uint8_t receipt[SE05X_SIM_SCP_KEY_LEN];
+    se05x_sim_object_t *pAuth              = se05x_sim_object_find(pSim, SE05X_SIM_OBJID_ECKEY_AUTH);
+    se05x_sim_object_t *pKeyAgreement      = se05x_sim_object_find(pSim, SE05X_SIM_OBJID_ECKEY_SESSION);
+    se05x_sim_channel_t *pChannel          = &pSim->eckey;
+    uint16_t sw                            = SE05X_SIM_SW_WRONG_DATA;
+
+    se05x_sim_channel_stop(pChannel);
+    if ((pAuth == NULL) || (pKeyAgreement == NULL)) {
+        return SE05X_SIM_SW_CONDITIONS_NOT_SATISFIED;
+    }
+    if ((se05x_sim_apdu_parse(pCmd, cmdLen, &pData, &dataLen) != 0) || (dataLen < 2)) {
+        return SE05X_SIM_SW_WRONG_LENGTH;
+    }
+
+    /* A6 control reference template, 7F49 ephemeral key, 5F37 signature over both */
+    ENSURE_OR_GO_CLEANUP(pData[0] == SE05X_SIM_TAG_CRT);
+    i = 2 + (size_t)pData[1];
+    ENSURE_OR_GO_CLEANUP((i + 3) <= dataLen);
+    ENSURE_OR_GO_CLEANUP((pData[i] == SE05X_SIM_TAG_EPK_HI) && (pData[i + 1] == SE05X_SIM_TAG_EPK_LO));
+    epkLen = pData[i + 2];
+    pEpk   = &pData[i + 3];
+    i += 3 + epkLen;
+    ENSURE_OR_GO_CLEANUP((i + 3) <= dataLen);
+    signedLen = i;
+    ENSURE_OR_GO_CLEANUP((pData[i] == SE05X_SIM_TAG_SIG_HI) && (pData[i + 1] == SE05X_SIM_TAG_SIG_LO));
+    sigLen = pData[i + 2];
+    pSig   = &pData[i + 3];
+    ENSURE_OR_GO_CLEANUP((i + 3 + sigLen) == dataLen);
+
+    /* B0 public key inside 7F49 */
+    ENSURE_OR_GO_CLEANUP((epkLen >= 2) && (pEpk[0] == SE05X_SIM_TAG_ECC_PUB_KEY) && ((size_t)pEpk[1] + 2 <= epkLen));
+
+    sw = SE05X_SIM_SW_SECURITY_STATUS;
+    SHA256(pData, signedLen, digest);
+    ENSURE_OR_GO_CLEANUP(se05x_sim_ec_verify(pAuth->pEcKey, digest, sizeof(digest), pSig, sigLen) == 0);
+
+    sw = SE05X_SIM_SW_WRONG_DATA;
+    ENSURE_OR_GO_CLEANUP(
+        se05x_sim_ec_derive(pKeyAgreement->pEcKey, &pEpk[2], pEpk[1], shared, sizeof(shared)) == 0);
+    ENSURE_OR_GO_CLEANUP(RAND_bytes(drSe, sizeof(drSe)) == 1);
+
+    /* Master key: SHA256(counter | shared secret | DR.SE | key parameters), 16 bytes used */
+    derivation[derivationLen++] = 0x00;
+    derivation[derivationLen++] = 0x00;
+    derivation[derivationLen++] = 0x00;
+    derivation[derivationLen++] = 0x01;
+    memcpy(&derivation[derivationLen], shared, sizeof(shared));
+    derivationLen += sizeof(shared);
+    memcpy(&derivation[derivationLen], drSe, sizeof(drSe));
+    derivationLen += sizeof(drSe);
+    derivation[derivationLen++] = SE05X_SIM_ECKEY_SCP_CONFIG;
+    derivation[derivationLen++] = SE05X_SIM_ECKEY_SECURITY_LEVEL;
+    derivation[derivationLen++] = SE05X_SIM_ECKEY_KEY_TYPE_AES;
+    derivation[derivationLen++] = SE05X_SIM_ECKEY_KEY_LEN_AES;
+    SHA256(derivation, derivationLen, master);
+
+    ENSURE_OR_GO_CLEANUP(
+        se05x_sim_derive(master, SE05X_SIM_DD_SENC, SE05X_SIM_DD_L_128BIT, NULL, 0, pChannel->encKey) == 0);
+    ENSURE_OR_GO_CLEANUP(
+        se05x_sim_derive(master, SE05X_SIM_DD_SMAC, SE05X_SIM_DD_L_128BIT, NULL, 0, pChannel->macKey) == 0);
+    ENSURE_OR_GO_CLEANUP(
+        se05x_sim_derive(master, SE05X_SIM_DD_SRMAC, SE05X_SIM_DD_L_128BIT, NULL, 0, pChannel->rmacKey) == 0);
+    ENSURE_OR_GO_CLEANUP(
+        se05x_sim_derive(master, SE05X_SIM_DD_INITIAL_MCV, SE05X_SIM_DD_L_128BIT, NULL, 0, pChannel->mcv) == 0);
+    /* Receipt binds the key agreement data, the host does not check it */
+    ENSURE_OR_GO_CLEANUP(
+        se05x_sim_derive(master, SE05X_SIM_DD_RECEIPT, SE05X_SIM_DD_L_128BIT, pData, signedLen, receipt) == 0);
+
+    sw = SE05X_SIM_SW_WRONG_LENGTH;
+    ENSURE_OR_GO_CLEANUP(se05x_sim_tlv_put(pRsp, rspSize, pRspLen, SE05X_SIM_TAG_DR_SE, drSe, sizeof(drSe)) == 0);
+    ENSURE_OR_GO_CLEANUP(
+        se05x_sim_tlv_put(pRsp, rspSize, pRspLen, SE05X_SIM_TAG_RECEIPT, receipt, sizeof(receipt)) == 0);
+    se05x_sim_channel_start(pChannel);
+    sw = SE05X_SIM_SW_OK;
+cleanup:
+    OPENSSL_cleanse(shared, sizeof(shared));
+    OPENSSL_cleanse(master, sizeof(master));
+    OPENSSL_cleanse(derivation, sizeof(derivation));
+    return sw;
+}
+
+static void se05x_sim_eckey_session_drop(se05x_sim_t *pSim)
+{
+    se05x_sim_channel_stop(&pSim->eckey);
+    memset(pSim->eckeySessionId, 0, sizeof(pSim->eckeySessionId));
+    pSim->eckeySessionCreated = 0;
+    pSim->eckeyClosing        = 0;
+}
+
+/**
+* PROCESS SESSION CMD of the ECKey session: 10 session ID, 41 wrapped command
+*/
+static uint16_t se05x_sim_eckey_process(
+    se05x_sim_t *pSim, uint8_t *pCmd, size_t cmdLen, uint8_t *pRsp, size_t *pRspLen)
+{
+    uint8_t *pData    = NULL;
+    size_t dataLen    = 0;
+    size_t index      = 0;
+    size_t offset     = 0;
+    size_t sidLen     = 0;
+    uint8_t *pInner   = NULL;
+    size_t innerLen   = 0;
+    size_t rspSize    = *pRspLen;
+    uint8_t plain[SE05X_SIM_MAX_APDU_LEN];
+    size_t plainLen   = sizeof(plain);
+    uint16_t sw       = SE05X_SIM_SW_OK;
+
+    *pRspLen = 0;
+    if ((se05x_sim_apdu_parse(pCmd, cmdLen, &pData, &dataLen) != 0) ||
+        (tlvGet_u8bufView(pData, &index, dataLen, kSE05x_TAG_SESSION_ID, &offset, &sidLen) != 0)) {
+        return SE05X_SIM_SW_WRONG_DATA;
+    }
+    if (!pSim->eckeySessionCreated || (sidLen != SE05X_SIM_SESSION_ID_LEN) ||
+        (CRYPTO_memcmp(&pData[offset], pSim->eckeySessionId, sidLen) != 0)) {
+        return SE05X_SIM_SW_CONDITIONS_NOT_SATISFIED;
+    }
+    if ((tlvGet_u8bufView(pData, &index, dataLen, kSE05x_TAG_1, &offset, &innerLen) != 0) || (index != dataLen) ||
+        (innerLen < 4)) {
+        return SE05X_SIM_SW_WRONG_DATA;
+    }
+    pInner = &pData[offset];
+    pSim->latencyIns = pInner[1];
+
+    if (pInner[1] == SE05X_SIM_INS_INTERNAL_AUTHENTICATE) {
+        return se05x_sim_eckey_internal_authenticate(pSim, pInner, innerLen, pRsp, rspSize, pRspLen);
+    }
+    if (!pSim->eckey.active || !(pInner[0] & SE05X_SIM_CLA_SECURE)) {
+        return SE05X_SIM_SW_SECURITY_STATUS;
+    }
+
+    sw = se05x_sim_channel_unwrap(&pSim->eckey, pInner, innerLen, plain, &plainLen);
+    if (sw == SE05X_SIM_SW_OK) {
+        *pRspLen = rspSize - SE05X_SIM_SCP_WRAP_OVERHEAD;
+        sw       = se05x_sim_applet_process(pSim, plain, plainLen, pRsp, pRspLen);
+    }
+    if (!pSim->eckey.active) {
+        /* MAC failure ends the session */
+        se05x_sim_eckey_session_drop(pSim);
+        *pRspLen = 0;
+        return sw;
+    }
+    if (se05x_sim_channel_wrap(&pSim->eckey, sw, pRsp, rspSize, pRspLen) != 0) {
+        *pRspLen = 0;
+        sw       = SE05X_SIM_SW_WRONG_LENGTH;
+    }
+    if (pSim->eckeyClosing) {
+        se05x_sim_eckey_session_drop(pSim);
+    }
+    return sw;
+}
+
+/**
+* Commands below Platform SCP03: ECKey session or plain applet command
+*/
+static uint16_t se05x_sim_session_process(
+    se05x_sim_t *pSim, uint8_t *pCmd, size_t cmdLen, uint8_t *pRsp, size_t *pRspLen)
+{
+    uint8_t *pData = NULL;
+    size_t dataLen = 0;
+
+    if ((pCmd[0] == SE05X_SIM_CLA_APPLET) && (pCmd[1] == kSE05x_INS_PROCESS) &&
+        (se05x_sim_apdu_parse(pCmd, cmdLen, &pData, &dataLen) == 0) && (dataLen > 0) &&
+        (pData[0] == kSE05x_TAG_SESSION_ID)) {
+        return se05x_sim_eckey_process(pSim, pCmd, cmdLen, pRsp, pRspLen);
+    }
+    return se05x_sim_applet_process(pSim, pCmd, cmdLen, pRsp, pRspLen);
+}
+
+void se05x_sim_scp_reset(se05x_sim_t *pSim)
+{
+    se05x_sim_channel_stop(&pSim->scp03);
+    OPENSSL_cleanse(pSim->scp03HostChallenge, sizeof(pSim->scp03HostChallenge));
+    OPENSSL_cleanse(pSim->scp03CardChallenge, sizeof(pSim->scp03CardChallenge));
+    pSim->scp03Initialized = 0;
+    se05x_sim_eckey_session_drop(pSim);
+}
+
+uint16_t se05x_sim_scp_create_session(se05x_sim_t *pSim, uint32_t authId, uint8_t *pSessionId)
+{
+    se05x_sim_object_t *pAuth = se05x_sim_object_find(pSim, authId);
+
+    /* Only the ECKey auth object opens a session */
+    if (pAuth == NULL) {
+        return SE05X_SIM_SW_NOT_FOUND;
+    }
+    if ((authId != SE05X_SIM_OBJID_ECKEY_AUTH) || pSim->eckeySessionCreated) {
+        return SE05X_SIM_SW_CONDITIONS_NOT_SATISFIED;
+    }
+    if (RAND_bytes(pSim->eckeySessionId, sizeof(pSim->eckeySessionId)) != 1) {
+        return SE05X_SIM_SW_CONDITIONS_NOT_SATISFIED;
+    }
+    se05x_sim_channel_stop(&pSim->eckey);
+    pSim->eckeySessionCreated = 1;
+    memcpy(pSessionId, pSim->eckeySessionId, sizeof(pSim->eckeySessionId));
+    return SE05X_SIM_SW_OK;
+}
+
+uint16_t se05x_sim_scp_close_session(se05x_sim_t *pSim)
+{
+    if (pSim->eckey.active) {
+        /* The response is still wrapped with the session keys */
+        pSim->eckeyClosing = 1;
+    }
+    else {
+        se05x_sim_eckey_session_drop(pSim);
+    }
+    return SE05X_SIM_SW_OK;
+}
+
+uint16_t se05x_sim_scp_process(se05x_sim_t *pSim, uint8_t *pCmd, size_t cmdLen, uint8_t *pRsp, size_t *pRspLen)
+{
+    size_t rspSize  = *pRspLen;
+    uint8_t plain[SE05X_SIM_MAX_APDU_LEN];
+    size_t plainLen = sizeof(plain);
+    uint16_t sw     = SE05X_SIM_SW_OK;
+
+    *pRspLen = 0;
+    if (cmdLen < 4) {
+        return SE05X_SIM_SW_WRONG_LENGTH;
+    }
+    pSim->latencyIns = pCmd[1];
+
+    if ((pCmd[0] == SE05X_SIM_CLA_GP) && (pCmd[1] == SE05X_SIM_INS_INITIALIZE_UPDATE)) {
+        return se05x_sim_scp03_initialize_update(pSim, pCmd, cmdLen, pRsp, rspSize, pRspLen);
+    }
+    if ((pCmd[0] == (SE05X_SIM_CLA_GP | SE05X_SIM_CLA_SECURE)) && (pCmd[1] == SE05X_SIM_INS_EXTERNAL_AUTHENTICATE)) {
+        return se05x_sim_scp03_external_authenticate(pSim, pCmd, cmdLen);
+    }
+    if (!pSim->scp03.active || ((pCmd[0] == SE05X_SIM_CLA_ISO7816) && (pCmd[1] == SE05X_SIM_INS_SELECT))) {
+        *pRspLen = rspSize;
+        return se05x_sim_session_process(pSim, pCmd, cmdLen, pRsp, pRspLen);
+    }
+
+    /* Platform SCP03 channel open, all other commands have to be wrapped */
+    if (!(pCmd[0] & SE05X_SIM_CLA_SECURE)) {
+        return SE05X_SIM_SW_SECURITY_STATUS;
+    }
+    sw = se05x_sim_channel_unwrap(&pSim->scp03, pCmd, cmdLen, plain, &plainLen);
+    if (sw != SE05X_SIM_SW_OK) {
+        return sw;
+    }
+    *pRspLen = rspSize - SE05X_SIM_SCP_WRAP_OVERHEAD;
+    sw       = se05x_sim_session_process(pSim, plain, plainLen, pRsp, pRspLen);
+    if (!pSim->scp03.active) {
+        /* Channel closed by the command (SELECT) */
+        return sw;
+    }
+    if (se05x_sim_channel_wrap(&pSim->scp03, sw, pRsp, rspSize, pRspLen) != 0) {
+        *pRspLen = 0;
+        sw       = SE05X_SIM_SW_WRONG_LENGTH;
+    }
+    return sw;
+}
@@ -0,0 +1,290 @@
+/** @file se05x_sim_server.c
+ *  @brief Software SE05x simulator served on a UNIX socket (sm_socket transport).
+ *
+ * Copyright 2024 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* ********************** Include files ********************** */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "se05x_sim.h"
+#include "se05x_types.h"
+#include "sm_socket.h"
+#include "sm_port.h"
+
+/* ********************** Defines ********************** */
+
+#define SE05X_SIM_SERVER_DEFAULT_PATH "/tmp/se05x.sock"
+#define SE05X_SIM_SERVER_MAX_XFER 0xFFFF
+
+/* ********************** Global variables ********************** */
+
+static volatile sig_atomic_t gSe05xSimServer_stop = 0;
+
+/* ********************** Functions ********************** */
+
+static void se05x_sim_server_on_signal(int signum)
+{
+    (void)signum;
+    gSe05xSimServer_stop = 1;
+}
+
+static void se05x_sim_server_usage(const char *pName)
+{
+    printf("Usage: %s [options]\n", pName);
+    printf("  -s <path>    Socket path (default " SE05X_SIM_SERVER_DEFAULT_PATH "),\n");
+    printf("               host connects with \"" SM_SOCKET_SCHEME "<path>\"\n");
+    printf("  -l <us>      Default processing time of an APDU\n");
+    printf("  -i <ins=us>  Processing time of one instruction (hex INS), repeatable\n");
+    printf("  -b <ns>      Added processing time per APDU byte\n");
+    printf("  -w <n>       S(WTX) requests sent before a delayed response\n");
+    printf("  -W <rate>    APDUs answered after S(WTX), per mille\n");
+    printf("  -c <rate>    I-frames of the SE sent with a wrong CRC, per mille\n");
+    printf("  -n <rate>    Frames of the host NACKed, per mille\n");
+    printf("  -d <rate>    I-frames of the SE dropped, per mille\n");
+    printf("  -S <seed>    Seed of the injections\n");
+    printf("  -f <ifsc>    Information field size of the SE\n");
+}
+
+static int se05x_sim_server_parse_args(int argc, char **argv, se05x_sim_config_t *pConfig, const char **ppPath)
+{
+    int opt              = 0;
+    unsigned long ins    = 0;
+    unsigned long value  = 0;
+    char *pEnd           = NULL;
+
+    while ((opt = getopt(argc, argv, "s:l:i:b:w:W:c:n:d:S:f:h")) != -1) {
+        if ((opt == 'h') || (opt == '?')) {
+            return 1;
+        }
+        if (opt == 's') {
+            *ppPath = optarg;
+            continue;
+        }
+        if (opt == 'i') {
+            ins = strtoul(optarg, &pEnd, 16);
+            if ((*pEnd != '=') || (ins >= SE05X_SIM_INS_COUNT)) {
+                return 1;
+            }
+            pConfig->latencyUs[ins] = (uint32_t)strtoul(pEnd + 1, NULL, 0);
+            continue;
+        }
+        value = strtoul(optarg, &pEnd, 0);
+        if (*pEnd != '\0') {
+            return 1;
+        }
+        switch (opt) {
+        case 'l':
+            pConfig->defaultLatencyUs = (uint32_t)value;
+            break;
+        case 'b':
+            pConfig->byteLatencyNs = (uint32_t)value;
+            break;
+        case 'w':
+            pConfig->wtxCount = (uint8_t)value;
+            break;
+        case 'W':
+            pConfig->wtxRate = (uint16_t)value;
+            break;
+        case 'c':
+            pConfig->crcErrorRate = (uint16_t)value;
+            break;
+        case 'n':
+            pConfig->nackRate = (uint16_t)value;
+            break;
+        case 'd':
+            pConfig->dropRate = (uint16_t)value;
+            break;
+        case 'S':
+            pConfig->seed = (uint32_t)value;
+            break;
+        case 'f':
+            pConfig->ifsc = (uint16_t)value;
+            break;
+        default:
+            return 1;
+        }
+    }
+    return (optind == argc) ? 0 : 1;
+}
+
+/**
+* Receives exactly len bytes, 1 when the host is gone
+*/
+static int se05x_sim_server_recv(int fd, uint8_t *pBuffer, size_t len)
+{
+    ssize_t nrRead = 0;
+
+    while (len > 0) {
+        nrRead = recv(fd, pBuffer, len, 0);
+        if (nrRead < 0) {
+            if ((errno == EINTR) && !gSe05xSimServer_stop) {
+                continue;
+            }
+            return 1;
+        }
+        if (nrRead == 0) {
+            return 1;
+        }
+        pBuffer += nrRead;
+        len -= (size_t)nrRead;
+    }
+    return 0;
+}
+
+static int se05x_sim_server_send(int fd, const uint8_t *pBuffer, size_t len)
+{
+    ssize_t nrSent = 0;
+
+    while (len > 0) {
+        nrSent = send(fd, pBuffer, len, MSG_NOSIGNAL);
+        if (nrSent < 0) {
+            if ((errno == EINTR) && !gSe05xSimServer_stop) {
+                continue;
+            }
+            return 1;
+        }
+        pBuffer += nrSent;
+        len -= (size_t)nrSent;
+    }
+    return 0;
+}
+
+/**
+* Serves the requests of one connected host
+*/
+static void se05x_sim_server_serve(se05x_sim_t *pSim, int fd)
+{
+    uint8_t header[SM_SOCKET_REQ_HEADER_LEN];
+    uint8_t *pBuffer  = NULL;
+    uint16_t len      = 0;
+    ESESTATUS status  = ESESTATUS_FAILED;
+
+    pBuffer = (uint8_t *)sm_malloc(1 + SE05X_SIM_SERVER_MAX_XFER);
+    ENSURE_OR_GO_CLEANUP(pBuffer != NULL);
+
+    se05x_sim_link_reset(pSim);
+    while (!gSe05xSimServer_stop) {
+        if (se05x_sim_server_recv(fd, header, sizeof(header)) != 0) {
+            break;
+        }
+        len = (uint16_t)((header[1] << 8) | header[2]);
+        if (header[0] == SM_SOCKET_OP_WRITE) {
+            ENSURE_OR_GO_CLEANUP(se05x_sim_server_recv(fd, &pBuffer[1], len) == 0);
+            status = se05x_sim_receive(pSim, &pBuffer[1], len);
+            len    = 0;
+        }
+        else if (header[0] == SM_SOCKET_OP_READ) {
+            status = se05x_sim_send(pSim, &pBuffer[1], len);
+            if (status != ESESTATUS_SUCCESS) {
+                len = 0;
+            }
+        }
+        else {
+            SMLOG_E("SIM: unknown operation 0x%02X \n", header[0]);
+            break;
+        }
+        pBuffer[0] = (status == ESESTATUS_SUCCESS) ? SM_SOCKET_STATUS_OK :
+                     (status == ESESTATUS_BUSY)    ? SM_SOCKET_STATUS_NACK :
+                                                     SM_SOCKET_STATUS_FAILED;
+        ENSURE_OR_GO_CLEANUP(se05x_sim_server_send(fd, pBuffer, 1 + (size_t)len) == 0);
+    }
+
+cleanup:
+    if (pBuffer != NULL) {
+        sm_free(pBuffer);
+    }
+}
+
+static void se05x_sim_server_print_stats(const se05x_sim_t *pSim)
+{
+    se05x_sim_stats_t stats;
+
+    se05x_sim_get_stats(pSim, &stats);
+    printf("Frames received:       %u\n", (unsigned int)stats.framesRx);
+    printf("Frames sent:           %u\n", (unsigned int)stats.framesTx);
+    printf("APDUs:                 %u\n", (unsigned int)stats.apdus);
+    printf("S(WTX) sent:           %u\n", (unsigned int)stats.wtxSent);
+    printf("Resends:               %u\n", (unsigned int)stats.resends);
+    printf("CRC errors received:   %u\n", (unsigned int)stats.crcErrorsRx);
+    printf("CRC errors injected:   %u\n", (unsigned int)stats.crcErrorsInjected);
+    printf("NACKs injected:        %u\n", (unsigned int)stats.nacksInjected);
+    printf("Frames dropped:        %u\n", (unsigned int)stats.framesDropped);
+}
+
+int main(int argc, char **argv)
+{
+    int ret                  = 1;
+    int listenFd             = -1;
+    int fd                   = -1;
+    const char *pPath        = SE05X_SIM_SERVER_DEFAULT_PATH;
+    struct sockaddr_un addr  = {0};
+    struct sigaction action  = {0};
+    se05x_sim_config_t config;
+    se05x_sim_t *pSim        = NULL;
+
+    se05x_sim_config_init(&config);
+    if (se05x_sim_server_parse_args(argc, argv, &config, &pPath) != 0) {
+        se05x_sim_server_usage(argv[0]);
+        return 1;
+    }
+    if (strlen(pPath) >= sizeof(addr.sun_path)) {
+        SMLOG_E("SIM: socket path too long \n");
+        return 1;
+    }
+
+    /* No SA_RESTART, so accept() / recv() return on a signal */
+    action.sa_handler = se05x_sim_server_on_signal;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    pSim = se05x_sim_create(&config);
+    ENSURE_OR_GO_CLEANUP(pSim != NULL);
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    ENSURE_OR_GO_CLEANUP(listenFd >= 0);
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, pPath, sizeof(addr.sun_path) - 1);
+    unlink(pPath);
+    if (bind(listenFd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        SMLOG_E("SIM: Error in binding %s (errno=%d) \n", pPath, errno);
+        goto cleanup;
+    }
+    ENSURE_OR_GO_CLEANUP(listen(listenFd, 1) == 0);
+    printf("SE05x simulator listening on %s%s\n", SM_SOCKET_SCHEME, pPath);
+    fflush(stdout);
+
+    /* One host at a time, the objects persist across connections */
+    while (!gSe05xSimServer_stop) {
+        fd = accept(listenFd, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            SMLOG_E("SIM: accept failed (errno=%d) \n", errno);
+            goto cleanup;
+        }
+        se05x_sim_server_serve(pSim, fd);
+        close(fd);
+        fd = -1;
+    }
+    ret = 0;
+
+cleanup:
+    if (pSim != NULL) {
+        se05x_sim_server_print_stats(pSim);
+        se05x_sim_destroy(pSim);
+    }
+    if (listenFd >= 0) {
+        close(listenFd);
+        unlink(pPath);
+    }
+    return ret;
+}
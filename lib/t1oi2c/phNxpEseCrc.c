@@ -0,0 +1,688 @@
+/*
+ * Copyright 2024 NXP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <phNxpEseCrc.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define PH_NXP_ESE_CRC_CLMUL_X86 1
+#elif defined(PH_NXP_ESE_CRC_WITH_PMULL) && defined(__GNUC__) && defined(__aarch64__) && defined(__linux__)
+/* Opt-in, this variant has not been built and checked on AArch64 hardware yet */
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#define PH_NXP_ESE_CRC_PMULL_ARM64 1
+#endif
+
+/******************************************************************************
+\section Introduction Introduction
+
+ * CRC-16/X.25 of the T=1oI2C frames. The bitwise variant is the reference,
+ * the slicing-by-8 variant is portable and the carry-less multiply variant
+ * is used when the CPU provides it. The AArch64 PMULL variant is only built
+ * with PH_NXP_ESE_CRC_WITH_PMULL, without it slicing-by-8 is used there.
+ *
+ ******************************************************************************/
+
+/* T[0][n] is the CRC of byte n, T[k][n] is T[0][n] followed by k zero bytes */
+static const uint16_t phNxpEseCrc_Table[8][256] = {
+    {
+        0x0000, 0x1189, 0x2312, 0x329B, 0x4624, 0x57AD, 0x6536, 0x74BF,
+        0x8C48, 0x9DC1, 0xAF5A, 0xBED3, 0xCA6C, 0xDBE5, 0xE97E, 0xF8F7,
+        0x1081, 0x0108, 0x3393, 0x221A, 0x56A5, 0x472C, 0x75B7, 0x643E,
+        0x9CC9, 0x8D40, 0xBFDB, 0xAE52, 0xDAED, 0xCB64, 0xF9FF, 0xE876,
+        0x2102, 0x308B, 0x0210, 0x1399, 0x6726, 0x76AF, 0x4434, 0x55BD,
+        0xAD4A, 0xBCC3, 0x8E58, 0x9FD1, 0xEB6E, 0xFAE7, 0xC87C, 0xD9F5,
+        0x3183, 0x200A, 0x1291, 0x0318, 0x77A7, 0x662E, 0x54B5, 0x453C,
+        0xBDCB, 0xAC42, 0x9ED9, 0x8F50, 0xFBEF, 0xEA66, 0xD8FD, 0xC974,
+        0x4204, 0x538D, 0x6116, 0x709F, 0x0420, 0x15A9, 0x2732, 0x36BB,
+        0xCE4C, 0xDFC5, 0xED5E, 0xFCD7, 0x8868, 0x99E1, 0xAB7A, 0xBAF3,
+        0x5285, 0x430C, 0x7197, 0x601E, 0x14A1, 0x0528, 0x37B3, 0x263A,
+        0xDECD, 0xCF44, 0xFDDF, 0xEC56, 0x98E9, 0x8960, 0xBBFB, 0xAA72,
+        0x6306, 0x728F, 0x4014, 0x519D, 0x2522, 0x34AB, 0x0630, 0x17B9,
+        0xEF4E, 0xFEC7, 0xCC5C, 0xDDD5, 0xA96A, 0xB8E3, 0x8A78, 0x9BF1,
+        0x7387, 0x620E, 0x5095, 0x411C, 0x35A3, 0x242A, 0x16B1, 0x0738,
+        0xFFCF, 0xEE46, 0xDCDD, 0xCD54, 0xB9EB, 0xA862, 0x9AF9, 0x8B70,
+        0x8408, 0x9581, 0xA71A, 0xB693, 0xC22C, 0xD3A5, 0xE13E, 0xF0B7,
+        0x0840, 0x19C9, 0x2B52, 0x3ADB, 0x4E64, 0x5FED, 0x6D76, 0x7CFF,
+        0x9489, 0x8500, 0xB79B, 0xA612, 0xD2AD, 0xC324, 0xF1BF, 0xE036,
+        0x18C1, 0x0948, 0x3BD3, 0x2A5A, 0x5EE5, 0x4F6C, 0x7DF7, 0x6C7E,
+        0xA50A, 0xB483, 0x8618, 0x9791, 0xE32E, 0xF2A7, 0xC03C, 0xD1B5,
+        0x2942, 0x38CB, 0x0A50, 0x1BD9, 0x6F66, 0x7EEF, 0x4C74, 0x5DFD,
+        0xB58B, 0xA402, 0x9699, 0x8710, 0xF3AF, 0xE226, 0xD0BD, 0xC134,
+        0x39C3, 0x284A, 0x1AD1, 0x0B58, 0x7FE7, 0x6E6E, 0x5CF5, 0x4D7C,
+        0xC60C, 0xD785, 0xE51E, 0xF497, 0x8028, 0x91A1, 0xA33A, 0xB2B3,
+        0x4A44, 0x5BCD, 0x6956, 0x78DF, 0x0C60, 0x1DE9, 0x2F72, 0x3EFB,
+        0xD68D, 0xC704, 0xF59F, 0xE416, 0x90A9, 0x8120, 0xB3BB, 0xA232,
+        0x5AC5, 0x4B4C, 0x79D7, 0x685E, 0x1CE1, 0x0D68, 0x3FF3, 0x2E7A,
+        0xE70E, 0xF687, 0xC41C, 0xD595, 0xA12A, 0xB0A3, 0x8238, 0x93B1,
+        0x6B46, 0x7ACF, 0x4854, 0x59DD, 0x2D62, 0x3CEB, 0x0E70, 0x1FF9,
+        0xF78F, 0xE606, 0xD49D, 0xC514, 0xB1AB, 0xA022, 0x92B9, 0x8330,
+        0x7BC7, 0x6A4E, 0x58D5, 0x495C, 0x3DE3, 0x2C6A, 0x1EF1, 0x0F78,
+    },
+    {
+        0x0000, 0x19D8, 0x33B0, 0x2A68, 0x6760, 0x7EB8, 0x54D0, 0x4D08,
+        0xCEC0, 0xD718, 0xFD70, 0xE4A8, 0xA9A0, 0xB078, 0x9A10, 0x83C8,
+        0x9591, 0x8C49, 0xA621, 0xBFF9, 0xF2F1, 0xEB29, 0xC141, 0xD899,
+        0x5B51, 0x4289, 0x68E1, 0x7139, 0x3C31, 0x25E9, 0x0F81, 0x1659,
+        0x2333, 0x3AEB, 0x1083, 0x095B, 0x4453, 0x5D8B, 0x77E3, 0x6E3B,
+        0xEDF3, 0xF42B, 0xDE43, 0xC79B, 0x8A93, 0x934B, 0xB923, 0xA0FB,
+        0xB6A2, 0xAF7A, 0x8512, 0x9CCA, 0xD1C2, 0xC81A, 0xE272, 0xFBAA,
+        0x7862, 0x61BA, 0x4BD2, 0x520A, 0x1F02, 0x06DA, 0x2CB2, 0x356A,
+        0x4666, 0x5FBE, 0x75D6, 0x6C0E, 0x2106, 0x38DE, 0x12B6, 0x0B6E,
+        0x88A6, 0x917E, 0xBB16, 0xA2CE, 0xEFC6, 0xF61E, 0xDC76, 0xC5AE,
+        0xD3F7, 0xCA2F, 0xE047, 0xF99F, 0xB497, 0xAD4F, 0x8727, 0x9EFF,
+        0x1D37, 0x04EF, 0x2E87, 0x375F, 0x7A57, 0x638F, 0x49E7, 0x503F,
+        0x6555, 0x7C8D, 0x56E5, 0x4F3D, 0x0235, 0x1BED, 0x3185, 0x285D,
+        0xAB95, 0xB24D, 0x9825, 0x81FD, 0xCCF5, 0xD52D, 0xFF45, 0xE69D,
+        0xF0C4, 0xE91C, 0xC374, 0xDAAC, 0x97A4, 0x8E7C, 0xA414, 0xBDCC,
+        0x3E04, 0x27DC, 0x0DB4, 0x146C, 0x5964, 0x40BC, 0x6AD4, 0x730C,
+        0x8CCC, 0x9514, 0xBF7C, 0xA6A4, 0xEBAC, 0xF274, 0xD81C, 0xC1C4,
+        0x420C, 0x5BD4, 0x71BC, 0x6864, 0x256C, 0x3CB4, 0x16DC, 0x0F04,
+        0x195D, 0x0085, 0x2AED, 0x3335, 0x7E3D, 0x67E5, 0x4D8D, 0x5455,
+        0xD79D, 0xCE45, 0xE42D, 0xFDF5, 0xB0FD, 0xA925, 0x834D, 0x9A95,
+        0xAFFF, 0xB627, 0x9C4F, 0x8597, 0xC89F, 0xD147, 0xFB2F, 0xE2F7,
+        0x613F, 0x78E7, 0x528F, 0x4B57, 0x065F, 0x1F87, 0x35EF, 0x2C37,
+        0x3A6E, 0x23B6, 0x09DE, 0x1006, 0x5D0E, 0x44D6, 0x6EBE, 0x7766,
+        0xF4AE, 0xED76, 0xC71E, 0xDEC6, 0x93CE, 0x8A16, 0xA07E, 0xB9A6,
+        0xCAAA, 0xD372, 0xF91A, 0xE0C2, 0xADCA, 0xB412, 0x9E7A, 0x87A2,
+        0x046A, 0x1DB2, 0x37DA, 0x2E02, 0x630A, 0x7AD2, 0x50BA, 0x4962,
+        0x5F3B, 0x46E3, 0x6C8B, 0x7553, 0x385B, 0x2183, 0x0BEB, 0x1233,
+        0x91FB, 0x8823, 0xA24B, 0xBB93, 0xF69B, 0xEF43, 0xC52B, 0xDCF3,
+        0xE999, 0xF041, 0xDA29, 0xC3F1, 0x8EF9, 0x9721, 0xBD49, 0xA491,
+        0x2759, 0x3E81, 0x14E9, 0x0D31, 0x4039, 0x59E1, 0x7389, 0x6A51,
+        0x7C08, 0x65D0, 0x4FB8, 0x5660, 0x1B68, 0x02B0, 0x28D8, 0x3100,
+        0xB2C8, 0xAB10, 0x8178, 0x98A0, 0xD5A8, 0xCC70, 0xE618, 0xFFC0,
+    },
+    {
+        0x0000, 0x5ADC, 0xB5B8, 0xEF64, 0x6361, 0x39BD, 0xD6D9, 0x8C05,
+        0xC6C2, 0x9C1E, 0x737A, 0x29A6, 0xA5A3, 0xFF7F, 0x101B, 0x4AC7,
+        0x8595, 0xDF49, 0x302D, 0x6AF1, 0xE6F4, 0xBC28, 0x534C, 0x0990,
+        0x4357, 0x198B, 0xF6EF, 0xAC33, 0x2036, 0x7AEA, 0x958E, 0xCF52,
+        0x033B, 0x59E7, 0xB683, 0xEC5F, 0x605A, 0x3A86, 0xD5E2, 0x8F3E,
+        0xC5F9, 0x9F25, 0x7041, 0x2A9D, 0xA698, 0xFC44, 0x1320, 0x49FC,
+        0x86AE, 0xDC72, 0x3316, 0x69CA, 0xE5CF, 0xBF13, 0x5077, 0x0AAB,
+        0x406C, 0x1AB0, 0xF5D4, 0xAF08, 0x230D, 0x79D1, 0x96B5, 0xCC69,
+        0x0676, 0x5CAA, 0xB3CE, 0xE912, 0x6517, 0x3FCB, 0xD0AF, 0x8A73,
+        0xC0B4, 0x9A68, 0x750C, 0x2FD0, 0xA3D5, 0xF909, 0x166D, 0x4CB1,
+        0x83E3, 0xD93F, 0x365B, 0x6C87, 0xE082, 0xBA5E, 0x553A, 0x0FE6,
+        0x4521, 0x1FFD, 0xF099, 0xAA45, 0x2640, 0x7C9C, 0x93F8, 0xC924,
+        0x054D, 0x5F91, 0xB0F5, 0xEA29, 0x662C, 0x3CF0, 0xD394, 0x8948,
+        0xC38F, 0x9953, 0x7637, 0x2CEB, 0xA0EE, 0xFA32, 0x1556, 0x4F8A,
+        0x80D8, 0xDA04, 0x3560, 0x6FBC, 0xE3B9, 0xB965, 0x5601, 0x0CDD,
+        0x461A, 0x1CC6, 0xF3A2, 0xA97E, 0x257B, 0x7FA7, 0x90C3, 0xCA1F,
+        0x0CEC, 0x5630, 0xB954, 0xE388, 0x6F8D, 0x3551, 0xDA35, 0x80E9,
+        0xCA2E, 0x90F2, 0x7F96, 0x254A, 0xA94F, 0xF393, 0x1CF7, 0x462B,
+        0x8979, 0xD3A5, 0x3CC1, 0x661D, 0xEA18, 0xB0C4, 0x5FA0, 0x057C,
+        0x4FBB, 0x1567, 0xFA03, 0xA0DF, 0x2CDA, 0x7606, 0x9962, 0xC3BE,
+        0x0FD7, 0x550B, 0xBA6F, 0xE0B3, 0x6CB6, 0x366A, 0xD90E, 0x83D2,
+        0xC915, 0x93C9, 0x7CAD, 0x2671, 0xAA74, 0xF0A8, 0x1FCC, 0x4510,
+        0x8A42, 0xD09E, 0x3FFA, 0x6526, 0xE923, 0xB3FF, 0x5C9B, 0x0647,
+        0x4C80, 0x165C, 0xF938, 0xA3E4, 0x2FE1, 0x753D, 0x9A59, 0xC085,
+        0x0A9A, 0x5046, 0xBF22, 0xE5FE, 0x69FB, 0x3327, 0xDC43, 0x869F,
+        0xCC58, 0x9684, 0x79E0, 0x233C, 0xAF39, 0xF5E5, 0x1A81, 0x405D,
+        0x8F0F, 0xD5D3, 0x3AB7, 0x606B, 0xEC6E, 0xB6B2, 0x59D6, 0x030A,
+        0x49CD, 0x1311, 0xFC75, 0xA6A9, 0x2AAC, 0x7070, 0x9F14, 0xC5C8,
+        0x09A1, 0x537D, 0xBC19, 0xE6C5, 0x6AC0, 0x301C, 0xDF78, 0x85A4,
+        0xCF63, 0x95BF, 0x7ADB, 0x2007, 0xAC02, 0xF6DE, 0x19BA, 0x4366,
+        0x8C34, 0xD6E8, 0x398C, 0x6350, 0xEF55, 0xB589, 0x5AED, 0x0031,
+        0x4AF6, 0x102A, 0xFF4E, 0xA592, 0x2997, 0x734B, 0x9C2F, 0xC6F3,
+    },
+    {
+        0x0000, 0x1CBB, 0x3976, 0x25CD, 0x72EC, 0x6E57, 0x4B9A, 0x5721,
+        0xE5D8, 0xF963, 0xDCAE, 0xC015, 0x9734, 0x8B8F, 0xAE42, 0xB2F9,
+        0xC3A1, 0xDF1A, 0xFAD7, 0xE66C, 0xB14D, 0xADF6, 0x883B, 0x9480,
+        0x2679, 0x3AC2, 0x1F0F, 0x03B4, 0x5495, 0x482E, 0x6DE3, 0x7158,
+        0x8F53, 0x93E8, 0xB625, 0xAA9E, 0xFDBF, 0xE104, 0xC4C9, 0xD872,
+        0x6A8B, 0x7630, 0x53FD, 0x4F46, 0x1867, 0x04DC, 0x2111, 0x3DAA,
+        0x4CF2, 0x5049, 0x7584, 0x693F, 0x3E1E, 0x22A5, 0x0768, 0x1BD3,
+        0xA92A, 0xB591, 0x905C, 0x8CE7, 0xDBC6, 0xC77D, 0xE2B0, 0xFE0B,
+        0x16B7, 0x0A0C, 0x2FC1, 0x337A, 0x645B, 0x78E0, 0x5D2D, 0x4196,
+        0xF36F, 0xEFD4, 0xCA19, 0xD6A2, 0x8183, 0x9D38, 0xB8F5, 0xA44E,
+        0xD516, 0xC9AD, 0xEC60, 0xF0DB, 0xA7FA, 0xBB41, 0x9E8C, 0x8237,
+        0x30CE, 0x2C75, 0x09B8, 0x1503, 0x4222, 0x5E99, 0x7B54, 0x67EF,
+        0x99E4, 0x855F, 0xA092, 0xBC29, 0xEB08, 0xF7B3, 0xD27E, 0xCEC5,
+        0x7C3C, 0x6087, 0x454A, 0x59F1, 0x0ED0, 0x126B, 0x37A6, 0x2B1D,
+        0x5A45, 0x46FE, 0x6333, 0x7F88, 0x28A9, 0x3412, 0x11DF, 0x0D64,
+        0xBF9D, 0xA326, 0x86EB, 0x9A50, 0xCD71, 0xD1CA, 0xF407, 0xE8BC,
+        0x2D6E, 0x31D5, 0x1418, 0x08A3, 0x5F82, 0x4339, 0x66F4, 0x7A4F,
+        0xC8B6, 0xD40D, 0xF1C0, 0xED7B, 0xBA5A, 0xA6E1, 0x832C, 0x9F97,
+        0xEECF, 0xF274, 0xD7B9, 0xCB02, 0x9C23, 0x8098, 0xA555, 0xB9EE,
+        0x0B17, 0x17AC, 0x3261, 0x2EDA, 0x79FB, 0x6540, 0x408D, 0x5C36,
+        0xA23D, 0xBE86, 0x9B4B, 0x87F0, 0xD0D1, 0xCC6A, 0xE9A7, 0xF51C,
+        0x47E5, 0x5B5E, 0x7E93, 0x6228, 0x3509, 0x29B2, 0x0C7F, 0x10C4,
+        0x619C, 0x7D27, 0x58EA, 0x4451, 0x1370, 0x0FCB, 0x2A06, 0x36BD,
+        0x8444, 0x98FF, 0xBD32, 0xA189, 0xF6A8, 0xEA13, 0xCFDE, 0xD365,
+        0x3BD9, 0x2762, 0x02AF, 0x1E14, 0x4935, 0x558E, 0x7043, 0x6CF8,
+        0xDE01, 0xC2BA, 0xE777, 0xFBCC, 0xACED, 0xB056, 0x959B, 0x8920,
+        0xF878, 0xE4C3, 0xC10E, 0xDDB5, 0x8A94, 0x962F, 0xB3E2, 0xAF59,
+        0x1DA0, 0x011B, 0x24D6, 0x386D, 0x6F4C, 0x73F7, 0x563A, 0x4A81,
+        0xB48A, 0xA831, 0x8DFC, 0x9147, 0xC666, 0xDADD, 0xFF10, 0xE3AB,
+        0x5152, 0x4DE9, 0x6824, 0x749F, 0x23BE, 0x3F05, 0x1AC8, 0x0673,
+        0x772B, 0x6B90, 0x4E5D, 0x52E6, 0x05C7, 0x197C, 0x3CB1, 0x200A,
+        0x92F3, 0x8E48, 0xAB85, 0xB73E, 0xE01F, 0xFCA4, 0xD969, 0xC5D2,
+    },
+    {
+        0x0000, 0x0B44, 0x1688, 0x1DCC, 0x2D10, 0x2654, 0x3B98, 0x30DC,
+        0x5A20, 0x5164, 0x4CA8, 0x47EC, 0x7730, 0x7C74, 0x61B8, 0x6AFC,
+        0xB440, 0xBF04, 0xA2C8, 0xA98C, 0x9950, 0x9214, 0x8FD8, 0x849C,
+        0xEE60, 0xE524, 0xF8E8, 0xF3AC, 0xC370, 0xC834, 0xD5F8, 0xDEBC,
+        0x6091, 0x6BD5, 0x7619, 0x7D5D, 0x4D81, 0x46C5, 0x5B09, 0x504D,
+        0x3AB1, 0x31F5, 0x2C39, 0x277D, 0x17A1, 0x1CE5, 0x0129, 0x0A6D,
+        0xD4D1, 0xDF95, 0xC259, 0xC91D, 0xF9C1, 0xF285, 0xEF49, 0xE40D,
+        0x8EF1, 0x85B5, 0x9879, 0x933D, 0xA3E1, 0xA8A5, 0xB569, 0xBE2D,
+        0xC122, 0xCA66, 0xD7AA, 0xDCEE, 0xEC32, 0xE776, 0xFABA, 0xF1FE,
+        0x9B02, 0x9046, 0x8D8A, 0x86CE, 0xB612, 0xBD56, 0xA09A, 0xABDE,
+        0x7562, 0x7E26, 0x63EA, 0x68AE, 0x5872, 0x5336, 0x4EFA, 0x45BE,
+        0x2F42, 0x2406, 0x39CA, 0x328E, 0x0252, 0x0916, 0x14DA, 0x1F9E,
+        0xA1B3, 0xAAF7, 0xB73B, 0xBC7F, 0x8CA3, 0x87E7, 0x9A2B, 0x916F,
+        0xFB93, 0xF0D7, 0xED1B, 0xE65F, 0xD683, 0xDDC7, 0xC00B, 0xCB4F,
+        0x15F3, 0x1EB7, 0x037B, 0x083F, 0x38E3, 0x33A7, 0x2E6B, 0x252F,
+        0x4FD3, 0x4497, 0x595B, 0x521F, 0x62C3, 0x6987, 0x744B, 0x7F0F,
+        0x8A55, 0x8111, 0x9CDD, 0x9799, 0xA745, 0xAC01, 0xB1CD, 0xBA89,
+        0xD075, 0xDB31, 0xC6FD, 0xCDB9, 0xFD65, 0xF621, 0xEBED, 0xE0A9,
+        0x3E15, 0x3551, 0x289D, 0x23D9, 0x1305, 0x1841, 0x058D, 0x0EC9,
+        0x6435, 0x6F71, 0x72BD, 0x79F9, 0x4925, 0x4261, 0x5FAD, 0x54E9,
+        0xEAC4, 0xE180, 0xFC4C, 0xF708, 0xC7D4, 0xCC90, 0xD15C, 0xDA18,
+        0xB0E4, 0xBBA0, 0xA66C, 0xAD28, 0x9DF4, 0x96B0, 0x8B7C, 0x8038,
+        0x5E84, 0x55C0, 0x480C, 0x4348, 0x7394, 0x78D0, 0x651C, 0x6E58,
+        0x04A4, 0x0FE0, 0x122C, 0x1968, 0x29B4, 0x22F0, 0x3F3C, 0x3478,
+        0x4B77, 0x4033, 0x5DFF, 0x56BB, 0x6667, 0x6D23, 0x70EF, 0x7BAB,
+        0x1157, 0x1A13, 0x07DF, 0x0C9B, 0x3C47, 0x3703, 0x2ACF, 0x218B,
+        0xFF37, 0xF473, 0xE9BF, 0xE2FB, 0xD227, 0xD963, 0xC4AF, 0xCFEB,
+        0xA517, 0xAE53, 0xB39F, 0xB8DB, 0x8807, 0x8343, 0x9E8F, 0x95CB,
+        0x2BE6, 0x20A2, 0x3D6E, 0x362A, 0x06F6, 0x0DB2, 0x107E, 0x1B3A,
+        0x71C6, 0x7A82, 0x674E, 0x6C0A, 0x5CD6, 0x5792, 0x4A5E, 0x411A,
+        0x9FA6, 0x94E2, 0x892E, 0x826A, 0xB2B6, 0xB9F2, 0xA43E, 0xAF7A,
+        0xC586, 0xCEC2, 0xD30E, 0xD84A, 0xE896, 0xE3D2, 0xFE1E, 0xF55A,
+    },
+    {
+        0x0000, 0x042B, 0x0856, 0x0C7D, 0x10AC, 0x1487, 0x18FA, 0x1CD1,
+        0x2158, 0x2573, 0x290E, 0x2D25, 0x31F4, 0x35DF, 0x39A2, 0x3D89,
+        0x42B0, 0x469B, 0x4AE6, 0x4ECD, 0x521C, 0x5637, 0x5A4A, 0x5E61,
+        0x63E8, 0x67C3, 0x6BBE, 0x6F95, 0x7344, 0x776F, 0x7B12, 0x7F39,
+        0x8560, 0x814B, 0x8D36, 0x891D, 0x95CC, 0x91E7, 0x9D9A, 0x99B1,
+        0xA438, 0xA013, 0xAC6E, 0xA845, 0xB494, 0xB0BF, 0xBCC2, 0xB8E9,
+        0xC7D0, 0xC3FB, 0xCF86, 0xCBAD, 0xD77C, 0xD357, 0xDF2A, 0xDB01,
+        0xE688, 0xE2A3, 0xEEDE, 0xEAF5, 0xF624, 0xF20F, 0xFE72, 0xFA59,
+        0x02D1, 0x06FA, 0x0A87, 0x0EAC, 0x127D, 0x1656, 0x1A2B, 0x1E00,
+        0x2389, 0x27A2, 0x2BDF, 0x2FF4, 0x3325, 0x370E, 0x3B73, 0x3F58,
+        0x4061, 0x444A, 0x4837, 0x4C1C, 0x50CD, 0x54E6, 0x589B, 0x5CB0,
+        0x6139, 0x6512, 0x696F, 0x6D44, 0x7195, 0x75BE, 0x79C3, 0x7DE8,
+        0x87B1, 0x839A, 0x8FE7, 0x8BCC, 0x971D, 0x9336, 0x9F4B, 0x9B60,
+        0xA6E9, 0xA2C2, 0xAEBF, 0xAA94, 0xB645, 0xB26E, 0xBE13, 0xBA38,
+        0xC501, 0xC12A, 0xCD57, 0xC97C, 0xD5AD, 0xD186, 0xDDFB, 0xD9D0,
+        0xE459, 0xE072, 0xEC0F, 0xE824, 0xF4F5, 0xF0DE, 0xFCA3, 0xF888,
+        0x05A2, 0x0189, 0x0DF4, 0x09DF, 0x150E, 0x1125, 0x1D58, 0x1973,
+        0x24FA, 0x20D1, 0x2CAC, 0x2887, 0x3456, 0x307D, 0x3C00, 0x382B,
+        0x4712, 0x4339, 0x4F44, 0x4B6F, 0x57BE, 0x5395, 0x5FE8, 0x5BC3,
+        0x664A, 0x6261, 0x6E1C, 0x6A37, 0x76E6, 0x72CD, 0x7EB0, 0x7A9B,
+        0x80C2, 0x84E9, 0x8894, 0x8CBF, 0x906E, 0x9445, 0x9838, 0x9C13,
+        0xA19A, 0xA5B1, 0xA9CC, 0xADE7, 0xB136, 0xB51D, 0xB960, 0xBD4B,
+        0xC272, 0xC659, 0xCA24, 0xCE0F, 0xD2DE, 0xD6F5, 0xDA88, 0xDEA3,
+        0xE32A, 0xE701, 0xEB7C, 0xEF57, 0xF386, 0xF7AD, 0xFBD0, 0xFFFB,
+        0x0773, 0x0358, 0x0F25, 0x0B0E, 0x17DF, 0x13F4, 0x1F89, 0x1BA2,
+        0x262B, 0x2200, 0x2E7D, 0x2A56, 0x3687, 0x32AC, 0x3ED1, 0x3AFA,
+        0x45C3, 0x41E8, 0x4D95, 0x49BE, 0x556F, 0x5144, 0x5D39, 0x5912,
+        0x649B, 0x60B0, 0x6CCD, 0x68E6, 0x7437, 0x701C, 0x7C61, 0x784A,
+        0x8213, 0x8638, 0x8A45, 0x8E6E, 0x92BF, 0x9694, 0x9AE9, 0x9EC2,
+        0xA34B, 0xA760, 0xAB1D, 0xAF36, 0xB3E7, 0xB7CC, 0xBBB1, 0xBF9A,
+        0xC0A3, 0xC488, 0xC8F5, 0xCCDE, 0xD00F, 0xD424, 0xD859, 0xDC72,
+        0xE1FB, 0xE5D0, 0xE9AD, 0xED86, 0xF157, 0xF57C, 0xF901, 0xFD2A,
+    },
+    {
+        0x0000, 0x9FD5, 0x37BB, 0xA86E, 0x6F76, 0xF0A3, 0x58CD, 0xC718,
+        0xDEEC, 0x4139, 0xE957, 0x7682, 0xB19A, 0x2E4F, 0x8621, 0x19F4,
+        0xB5C9, 0x2A1C, 0x8272, 0x1DA7, 0xDABF, 0x456A, 0xED04, 0x72D1,
+        0x6B25, 0xF4F0, 0x5C9E, 0xC34B, 0x0453, 0x9B86, 0x33E8, 0xAC3D,
+        0x6383, 0xFC56, 0x5438, 0xCBED, 0x0CF5, 0x9320, 0x3B4E, 0xA49B,
+        0xBD6F, 0x22BA, 0x8AD4, 0x1501, 0xD219, 0x4DCC, 0xE5A2, 0x7A77,
+        0xD64A, 0x499F, 0xE1F1, 0x7E24, 0xB93C, 0x26E9, 0x8E87, 0x1152,
+        0x08A6, 0x9773, 0x3F1D, 0xA0C8, 0x67D0, 0xF805, 0x506B, 0xCFBE,
+        0xC706, 0x58D3, 0xF0BD, 0x6F68, 0xA870, 0x37A5, 0x9FCB, 0x001E,
+        0x19EA, 0x863F, 0x2E51, 0xB184, 0x769C, 0xE949, 0x4127, 0xDEF2,
+        0x72CF, 0xED1A, 0x4574, 0xDAA1, 0x1DB9, 0x826C, 0x2A02, 0xB5D7,
+        0xAC23, 0x33F6, 0x9B98, 0x044D, 0xC355, 0x5C80, 0xF4EE, 0x6B3B,
+        0xA485, 0x3B50, 0x933E, 0x0CEB, 0xCBF3, 0x5426, 0xFC48, 0x639D,
+        0x7A69, 0xE5BC, 0x4DD2, 0xD207, 0x151F, 0x8ACA, 0x22A4, 0xBD71,
+        0x114C, 0x8E99, 0x26F7, 0xB922, 0x7E3A, 0xE1EF, 0x4981, 0xD654,
+        0xCFA0, 0x5075, 0xF81B, 0x67CE, 0xA0D6, 0x3F03, 0x976D, 0x08B8,
+        0x861D, 0x19C8, 0xB1A6, 0x2E73, 0xE96B, 0x76BE, 0xDED0, 0x4105,
+        0x58F1, 0xC724, 0x6F4A, 0xF09F, 0x3787, 0xA852, 0x003C, 0x9FE9,
+        0x33D4, 0xAC01, 0x046F, 0x9BBA, 0x5CA2, 0xC377, 0x6B19, 0xF4CC,
+        0xED38, 0x72ED, 0xDA83, 0x4556, 0x824E, 0x1D9B, 0xB5F5, 0x2A20,
+        0xE59E, 0x7A4B, 0xD225, 0x4DF0, 0x8AE8, 0x153D, 0xBD53, 0x2286,
+        0x3B72, 0xA4A7, 0x0CC9, 0x931C, 0x5404, 0xCBD1, 0x63BF, 0xFC6A,
+        0x5057, 0xCF82, 0x67EC, 0xF839, 0x3F21, 0xA0F4, 0x089A, 0x974F,
+        0x8EBB, 0x116E, 0xB900, 0x26D5, 0xE1CD, 0x7E18, 0xD676, 0x49A3,
+        0x411B, 0xDECE, 0x76A0, 0xE975, 0x2E6D, 0xB1B8, 0x19D6, 0x8603,
+        0x9FF7, 0x0022, 0xA84C, 0x3799, 0xF081, 0x6F54, 0xC73A, 0x58EF,
+        0xF4D2, 0x6B07, 0xC369, 0x5CBC, 0x9BA4, 0x0471, 0xAC1F, 0x33CA,
+        0x2A3E, 0xB5EB, 0x1D85, 0x8250, 0x4548, 0xDA9D, 0x72F3, 0xED26,
+        0x2298, 0xBD4D, 0x1523, 0x8AF6, 0x4DEE, 0xD23B, 0x7A55, 0xE580,
+        0xFC74, 0x63A1, 0xCBCF, 0x541A, 0x9302, 0x0CD7, 0xA4B9, 0x3B6C,
+        0x9751, 0x0884, 0xA0EA, 0x3F3F, 0xF827, 0x67F2, 0xCF9C, 0x5049,
+        0x49BD, 0xD668, 0x7E06, 0xE1D3, 0x26CB, 0xB91E, 0x1170, 0x8EA5,
+    },
+    {
+        0x0000, 0x81BF, 0x0B6F, 0x8AD0, 0x16DE, 0x9761, 0x1DB1, 0x9C0E,
+        0x2DBC, 0xAC03, 0x26D3, 0xA76C, 0x3B62, 0xBADD, 0x300D, 0xB1B2,
+        0x5B78, 0xDAC7, 0x5017, 0xD1A8, 0x4DA6, 0xCC19, 0x46C9, 0xC776,
+        0x76C4, 0xF77B, 0x7DAB, 0xFC14, 0x601A, 0xE1A5, 0x6B75, 0xEACA,
+        0xB6F0, 0x374F, 0xBD9F, 0x3C20, 0xA02E, 0x2191, 0xAB41, 0x2AFE,
+        0x9B4C, 0x1AF3, 0x9023, 0x119C, 0x8D92, 0x0C2D, 0x86FD, 0x0742,
+        0xED88, 0x6C37, 0xE6E7, 0x6758, 0xFB56, 0x7AE9, 0xF039, 0x7186,
+        0xC034, 0x418B, 0xCB5B, 0x4AE4, 0xD6EA, 0x5755, 0xDD85, 0x5C3A,
+        0x65F1, 0xE44E, 0x6E9E, 0xEF21, 0x732F, 0xF290, 0x7840, 0xF9FF,
+        0x484D, 0xC9F2, 0x4322, 0xC29D, 0x5E93, 0xDF2C, 0x55FC, 0xD443,
+        0x3E89, 0xBF36, 0x35E6, 0xB459, 0x2857, 0xA9E8, 0x2338, 0xA287,
+        0x1335, 0x928A, 0x185A, 0x99E5, 0x05EB, 0x8454, 0x0E84, 0x8F3B,
+        0xD301, 0x52BE, 0xD86E, 0x59D1, 0xC5DF, 0x4460, 0xCEB0, 0x4F0F,
+        0xFEBD, 0x7F02, 0xF5D2, 0x746D, 0xE863, 0x69DC, 0xE30C, 0x62B3,
+        0x8879, 0x09C6, 0x8316, 0x02A9, 0x9EA7, 0x1F18, 0x95C8, 0x1477,
+        0xA5C5, 0x247A, 0xAEAA, 0x2F15, 0xB31B, 0x32A4, 0xB874, 0x39CB,
+        0xCBE2, 0x4A5D, 0xC08D, 0x4132, 0xDD3C, 0x5C83, 0xD653, 0x57EC,
+        0xE65E, 0x67E1, 0xED31, 0x6C8E, 0xF080, 0x713F, 0xFBEF, 0x7A50,
+        0x909A, 0x1125, 0x9BF5, 0x1A4A, 0x8644, 0x07FB, 0x8D2B, 0x0C94,
+        0xBD26, 0x3C99, 0xB649, 0x37F6, 0xABF8, 0x2A47, 0xA097, 0x2128,
+        0x7D12, 0xFCAD, 0x767D, 0xF7C2, 0x6BCC, 0xEA73, 0x60A3, 0xE11C,
+        0x50AE, 0xD111, 0x5BC1, 0xDA7E, 0x4670, 0xC7CF, 0x4D1F, 0xCCA0,
+        0x266A, 0xA7D5, 0x2D05, 0xACBA, 0x30B4, 0xB10B, 0x3BDB, 0xBA64,
+        0x0BD6, 0x8A69, 0x00B9, 0x8106, 0x1D08, 0x9CB7, 0x1667, 0x97D8,
+        0xAE13, 0x2FAC, 0xA57C, 0x24C3, 0xB8CD, 0x3972, 0xB3A2, 0x321D,
+        0x83AF, 0x0210, 0x88C0, 0x097F, 0x9571, 0x14CE, 0x9E1E, 0x1FA1,
+        0xF56B, 0x74D4, 0xFE04, 0x7FBB, 0xE3B5, 0x620A, 0xE8DA, 0x6965,
+        0xD8D7, 0x5968, 0xD3B8, 0x5207, 0xCE09, 0x4FB6, 0xC566, 0x44D9,
+        0x18E3, 0x995C, 0x138C, 0x9233, 0x0E3D, 0x8F82, 0x0552, 0x84ED,
+        0x355F, 0xB4E0, 0x3E30, 0xBF8F, 0x2381, 0xA23E, 0x28EE, 0xA951,
+        0x439B, 0xC224, 0x48F4, 0xC94B, 0x5545, 0xD4FA, 0x5E2A, 0xDF95,
+        0x6E27, 0xEF98, 0x6548, 0xE4F7, 0x78F9, 0xF946, 0x7396, 0xF229,
+    },
+};
+
+/*
+ * Folding constants for the carry-less multiply variant. Folding a 128 bit
+ * block forward by D bits multiplies its first half by x^(D+64) and its
+ * second half by x^D. The constants hold x^(D+63) mod P and x^(D-1) mod P,
+ * bit reflected in the upper 16 bits of a 64 bit lane; the missing factor x
+ * comes from the 127 bit product landing one bit off in reflected order.
+ */
+#define PH_NXP_ESE_CRC_K(r) ((uint64_t)(r) << 48)
+#define PH_NXP_ESE_CRC_K512_HI PH_NXP_ESE_CRC_K(0x9822) /* x^575 */
+#define PH_NXP_ESE_CRC_K512_LO PH_NXP_ESE_CRC_K(0x7F90) /* x^511 */
+#define PH_NXP_ESE_CRC_K384_HI PH_NXP_ESE_CRC_K(0x5159) /* x^447 */
+#define PH_NXP_ESE_CRC_K384_LO PH_NXP_ESE_CRC_K(0x8F66) /* x^383 */
+#define PH_NXP_ESE_CRC_K256_HI PH_NXP_ESE_CRC_K(0xAAC8) /* x^319 */
+#define PH_NXP_ESE_CRC_K256_LO PH_NXP_ESE_CRC_K(0x20F3) /* x^255 */
+#define PH_NXP_ESE_CRC_K128_HI PH_NXP_ESE_CRC_K(0xA95D) /* x^191 */
+#define PH_NXP_ESE_CRC_K128_LO PH_NXP_ESE_CRC_K(0x7EEA) /* x^127 */
+
+static phNxpEseCrc_UpdateFn_t gphNxpEseCrc_UpdateFn = NULL;
+static phNxpEseCrc_Impl_t gphNxpEseCrc_Impl         = kPhNxpEseCrc_Bitwise;
+
+/******************************************************************************
+ * Function         phNxpEseCrc_UpdateBitwise
+ *
+ * Description      Reference CRC update, one bit at a time.
+ *
+ * param[in]        uint16_t : CRC register
+ * param[in]        const uint8_t* : data buffer
+ * param[in]        size_t : number of bytes
+ *
+ * Returns          Updated CRC register.
+ *
+ ******************************************************************************/
+uint16_t phNxpEseCrc_UpdateBitwise(uint16_t crc, const uint8_t *p_buff, size_t length)
+{
+    size_t i = 0;
+
+    if (p_buff == NULL) {
+        return crc;
+    }
+
+    for (i = 0; i < length; i++) {
+        crc ^= p_buff[i];
+        for (int bit = 8; bit > 0; --bit) {
+            if ((crc & 0x0001) == 0x0001) {
+                crc = (uint16_t)((crc >> 1) ^ 0x8408);
+            }
+            else {
+                crc >>= 1;
+            }
+        }
+    }
+    return crc;
+}
+
+/******************************************************************************
+ * Function         phNxpEseCrc_UpdateSlice8
+ *
+ * Description      Table driven CRC update, eight bytes per lookup round.
+ *
+ * param[in]        uint16_t : CRC register
+ * param[in]        const uint8_t* : data buffer
+ * param[in]        size_t : number of bytes
+ *
+ * Returns          Updated CRC register.
+ *
+ ******************************************************************************/
+uint16_t phNxpEseCrc_UpdateSlice8(uint16_t crc, const uint8_t *p_buff, size_t length)
+{
+    if (p_buff == NULL) {
+        return crc;
+    }
+
+    while (length >= 8) {
+        crc ^= (uint16_t)(p_buff[0] | (p_buff[1] << 8));
+        crc = phNxpEseCrc_Table[7][crc & 0xFF] ^ phNxpEseCrc_Table[6][crc >> 8] ^ phNxpEseCrc_Table[5][p_buff[2]] ^
+              phNxpEseCrc_Table[4][p_buff[3]] ^ phNxpEseCrc_Table[3][p_buff[4]] ^ phNxpEseCrc_Table[2][p_buff[5]] ^
+              phNxpEseCrc_Table[1][p_buff[6]] ^ phNxpEseCrc_Table[0][p_buff[7]];
+        p_buff += 8;
+        length -= 8;
+    }
+    while (length > 0) {
+        crc = (crc >> 8) ^ phNxpEseCrc_Table[0][(crc ^ *p_buff) & 0xFF];
+        p_buff++;
+        length--;
+    }
+    return crc;
+}
+
+#if defined(PH_NXP_ESE_CRC_CLMUL_X86)
+
+#define PH_NXP_ESE_CRC_TARGET __attribute__((target("pclmul,sse2")))
+
+PH_NXP_ESE_CRC_TARGET static inline __m128i phNxpEseCrc_Fold(__m128i block, __m128i k)
+{
+    return _mm_xor_si128(_mm_clmulepi64_si128(block, k, 0x00), _mm_clmulepi64_si128(block, k, 0x11));
+}
+
+/******************************************************************************
+ * Function         phNxpEseCrc_UpdateClmul
+ *
+ * Description      CRC update folding 16 byte blocks with PCLMULQDQ. The
+ *                  folded remainder and the tail go through the tables.
+ *
+ * param[in]        uint16_t : CRC register
+ * param[in]        const uint8_t* : data buffer
+ * param[in]        size_t : number of bytes
+ *
+ * Returns          Updated CRC register.
+ *
+ ******************************************************************************/
+PH_NXP_ESE_CRC_TARGET static uint16_t phNxpEseCrc_UpdateClmul(uint16_t crc, const uint8_t *p_buff, size_t length)
+{
+    const __m128i k512 = _mm_set_epi64x((long long)PH_NXP_ESE_CRC_K512_LO, (long long)PH_NXP_ESE_CRC_K512_HI);
+    const __m128i k384 = _mm_set_epi64x((long long)PH_NXP_ESE_CRC_K384_LO, (long long)PH_NXP_ESE_CRC_K384_HI);
+    const __m128i k256 = _mm_set_epi64x((long long)PH_NXP_ESE_CRC_K256_LO, (long long)PH_NXP_ESE_CRC_K256_HI);
+    const __m128i k128 = _mm_set_epi64x((long long)PH_NXP_ESE_CRC_K128_LO, (long long)PH_NXP_ESE_CRC_K128_HI);
+    __m128i x0, x1, x2, x3;
+    uint8_t folded[16];
+
+    if (p_buff == NULL || length < PH_NXP_ESE_CRC_CLMUL_MIN_LEN) {
+        return phNxpEseCrc_UpdateSlice8(crc, p_buff, length);
+    }
+
+    /* The CRC register is the xor of the first two message bytes */
+    x0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)p_buff), _mm_cvtsi32_si128(crc));
+
+    if (length >= 64) {
+        x1 = _mm_loadu_si128((const __m128i *)(p_buff + 16));
+        x2 = _mm_loadu_si128((const __m128i *)(p_buff + 32));
+        x3 = _mm_loadu_si128((const __m128i *)(p_buff + 48));
+        p_buff += 64;
+        length -= 64;
+        while (length >= 64) {
+            x0 = _mm_xor_si128(phNxpEseCrc_Fold(x0, k512), _mm_loadu_si128((const __m128i *)p_buff));
+            x1 = _mm_xor_si128(phNxpEseCrc_Fold(x1, k512), _mm_loadu_si128((const __m128i *)(p_buff + 16)));
+            x2 = _mm_xor_si128(phNxpEseCrc_Fold(x2, k512), _mm_loadu_si128((const __m128i *)(p_buff + 32)));
+            x3 = _mm_xor_si128(phNxpEseCrc_Fold(x3, k512), _mm_loadu_si128((const __m128i *)(p_buff + 48)));
+            p_buff += 64;
+            length -= 64;
+        }
+        x0 = _mm_xor_si128(_mm_xor_si128(phNxpEseCrc_Fold(x0, k384), phNxpEseCrc_Fold(x1, k256)),
+            _mm_xor_si128(phNxpEseCrc_Fold(x2, k128), x3));
+    }
+    else {
+        p_buff += 16;
+        length -= 16;
+    }
+
+    while (length >= 16) {
+        x0 = _mm_xor_si128(phNxpEseCrc_Fold(x0, k128), _mm_loadu_si128((const __m128i *)p_buff));
+        p_buff += 16;
+        length -= 16;
+    }
+
+    _mm_storeu_si128((__m128i *)folded, x0);
+    crc = phNxpEseCrc_UpdateSlice8(0, folded, sizeof(folded));
+    return phNxpEseCrc_UpdateSlice8(crc, p_buff, length);
+}
+
+static int phNxpEseCrc_HaveClmul(void)
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("pclmul");
+}
+
+#elif defined(PH_NXP_ESE_CRC_PMULL_ARM64)
+
+#if defined(__clang__)
+#define PH_NXP_ESE_CRC_TARGET __attribute__((target("aes")))
+#else
+#define PH_NXP_ESE_CRC_TARGET __attribute__((target("+crypto")))
+#endif
+
+PH_NXP_ESE_CRC_TARGET static inline uint8x16_t phNxpEseCrc_Fold(uint8x16_t block, uint64_t k_hi, uint64_t k_lo)
+{
+    uint64x2_t lanes = vreinterpretq_u64_u8(block);
+    poly128_t hi     = vmull_p64((poly64_t)vgetq_lane_u64(lanes, 0), (poly64_t)k_hi);
+    poly128_t lo     = vmull_p64((poly64_t)vgetq_lane_u64(lanes, 1), (poly64_t)k_lo);
+    return veorq_u8(vreinterpretq_u8_p128(hi), vreinterpretq_u8_p128(lo));
+}
+
+/******************************************************************************
+ * Function         phNxpEseCrc_UpdateClmul
+ *
+ * Description      CRC update folding 16 byte blocks with PMULL. The
+ *                  folded remainder and the tail go through the tables.
+ *
+ * param[in]        uint16_t : CRC register
+ * param[in]        const uint8_t* : data buffer
+ * param[in]        size_t : number of bytes
+ *
+ * Returns          Updated CRC register.
+ *
+ ******************************************************************************/
+PH_NXP_ESE_CRC_TARGET static uint16_t phNxpEseCrc_UpdateClmul(uint16_t crc, const uint8_t *p_buff, size_t length)
+{
+    uint8x16_t x0, x1, x2, x3;
+    uint8_t folded[16] = {0};
+
+    if (p_buff == NULL || length < PH_NXP_ESE_CRC_CLMUL_MIN_LEN) {
+        return phNxpEseCrc_UpdateSlice8(crc, p_buff, length);
+    }
+
+    /* The CRC register is the xor of the first two message bytes */
+    folded[0] = (uint8_t)(crc & 0xFF);
+    folded[1] = (uint8_t)(crc >> 8);
+    x0        = veorq_u8(vld1q_u8(p_buff), vld1q_u8(folded));
+
+    if (length >= 64) {
+        x1 = vld1q_u8(p_buff + 16);
+        x2 = vld1q_u8(p_buff + 32);
+        x3 = vld1q_u8(p_buff + 48);
+        p_buff += 64;
+        length -= 64;
+        while (length >= 64) {
+            x0 = veorq_u8(phNxpEseCrc_Fold(x0, PH_NXP_ESE_CRC_K512_HI, PH_NXP_ESE_CRC_K512_LO), vld1q_u8(p_buff));
+            x1 = veorq_u8(phNxpEseCrc_Fold(x1, PH_NXP_ESE_CRC_K512_HI, PH_NXP_ESE_CRC_K512_LO), vld1q_u8(p_buff + 16));
+            x2 = veorq_u8(phNxpEseCrc_Fold(x2, PH_NXP_ESE_CRC_K512_HI, PH_NXP_ESE_CRC_K512_LO), vld1q_u8(p_buff + 32));
+            x3 = veorq_u8(phNxpEseCrc_Fold(x3, PH_NXP_ESE_CRC_K512_HI, PH_NXP_ESE_CRC_K512_LO), vld1q_u8(p_buff + 48));
+            p_buff += 64;
+            length -= 64;
+        }
+        x0 = veorq_u8(veorq_u8(phNxpEseCrc_Fold(x0, PH_NXP_ESE_CRC_K384_HI, PH_NXP_ESE_CRC_K384_LO),
+                          phNxpEseCrc_Fold(x1, PH_NXP_ESE_CRC_K256_HI, PH_NXP_ESE_CRC_K256_LO)),
+            veorq_u8(phNxpEseCrc_Fold(x2, PH_NXP_ESE_CRC_K128_HI, PH_NXP_ESE_CRC_K128_LO), x3));
+    }
+    else {
+        p_buff += 16;
+        length -= 16;
+    }
+
+    while (length >= 16) {
+        x0 = veorq_u8(phNxpEseCrc_Fold(x0, PH_NXP_ESE_CRC_K128_HI, PH_NXP_ESE_CRC_K128_LO), vld1q_u8(p_buff));
+        p_buff += 16;
+        length -= 16;
+    }
+
+    vst1q_u8(folded, x0);
+    crc = phNxpEseCrc_UpdateSlice8(0, folded, sizeof(folded));
+    return phNxpEseCrc_UpdateSlice8(crc, p_buff, length);
+}
+
+static int phNxpEseCrc_HaveClmul(void)
+{
+    return (getauxval(AT_HWCAP) & HWCAP_PMULL) != 0;
+}
+
+#endif
+
+/******************************************************************************
+ * Function         phNxpEseCrc_GetUpdateFn
+ *
+ * Description      Get the update function of a CRC variant.
+ *
+ * param[in]        phNxpEseCrc_Impl_t : requested variant
+ *
+ * Returns          Update function, or NULL when the variant is not built
+ *                  in or not supported by this CPU.
+ *
+ ******************************************************************************/
+phNxpEseCrc_UpdateFn_t phNxpEseCrc_GetUpdateFn(phNxpEseCrc_Impl_t impl)
+{
+    switch (impl) {
+    case kPhNxpEseCrc_Bitwise:
+        return phNxpEseCrc_UpdateBitwise;
+    case kPhNxpEseCrc_Slice8:
+        return phNxpEseCrc_UpdateSlice8;
+    case kPhNxpEseCrc_Clmul:
+#if defined(PH_NXP_ESE_CRC_CLMUL_X86) || defined(PH_NXP_ESE_CRC_PMULL_ARM64)
+        if (phNxpEseCrc_HaveClmul()) {
+            return phNxpEseCrc_UpdateClmul;
+        }
+#endif
+        return NULL;
+    default:
+        return NULL;
+    }
+}
+
+/******************************************************************************
+ * Function         phNxpEseCrc_GetActiveImpl
+ *
+ * Description      Select the fastest variant supported by this CPU. The
+ *                  selection is done once; a concurrent first call selects
+ *                  the same variant, so the race is harmless.
+ *
+ * Returns          Variant used by phNxpEseCrc_Compute.
+ *
+ ******************************************************************************/
+phNxpEseCrc_Impl_t phNxpEseCrc_GetActiveImpl(void)
+{
+    phNxpEseCrc_Impl_t impl   = kPhNxpEseCrc_Clmul;
+    phNxpEseCrc_UpdateFn_t fn = NULL;
+
+    if (gphNxpEseCrc_UpdateFn != NULL) {
+        return gphNxpEseCrc_Impl;
+    }
+
+    fn = phNxpEseCrc_GetUpdateFn(impl);
+    if (fn == NULL) {
+        impl = kPhNxpEseCrc_Slice8;
+        fn   = phNxpEseCrc_GetUpdateFn(impl);
+    }
+    gphNxpEseCrc_Impl     = impl;
+    gphNxpEseCrc_UpdateFn = fn;
+    return impl;
+}
+
+/******************************************************************************
+ * Function         phNxpEseCrc_GetImplName
+ *
+ * Description      Printable name of a CRC variant.
+ *
+ * param[in]        phNxpEseCrc_Impl_t : variant
+ *
+ * Returns          Name of the variant.
+ *
+ ******************************************************************************/
+const char *phNxpEseCrc_GetImplName(phNxpEseCrc_Impl_t impl)
+{
+    switch (impl) {
+    case kPhNxpEseCrc_Bitwise:
+        return "bitwise";
+    case kPhNxpEseCrc_Slice8:
+        return "slice8";
+    case kPhNxpEseCrc_Clmul:
+#if defined(PH_NXP_ESE_CRC_PMULL_ARM64)
+        return "pmull";
+#else
+        return "pclmul";
+#endif
+    default:
+        return "unknown";
+    }
+}
+
+/******************************************************************************
+ * Function         phNxpEseCrc_Update
+ *
+ * Description      CRC update with the active variant. Start with
+ *                  PH_NXP_ESE_CRC_INIT and xor the final register with
+ *                  PH_NXP_ESE_CRC_XOROUT.
+ *
+ * param[in]        uint16_t : CRC register
+ * param[in]        const uint8_t* : data buffer
+ * param[in]        size_t : number of bytes
+ *
+ * Returns          Updated CRC register.
+ *
+ ******************************************************************************/
+uint16_t phNxpEseCrc_Update(uint16_t crc, const uint8_t *p_buff, size_t length)
+{
+    if (gphNxpEseCrc_UpdateFn == NULL) {
+        phNxpEseCrc_GetActiveImpl();
+    }
+    return gphNxpEseCrc_UpdateFn(crc, p_buff, length);
+}
+
+/******************************************************************************
+ * Function         phNxpEseCrc_Compute
+ *
+ * Description      CRC-16/X.25 of a buffer with the active variant.
+ *
+ * param[in]        const uint8_t* : data buffer
+ * param[in]        size_t : number of bytes
+ *
+ * Returns          CRC value, initial value and final xor applied.
+ *
+ ******************************************************************************/
+uint16_t phNxpEseCrc_Compute(const uint8_t *p_buff, size_t length)
+{
+    return (uint16_t)(phNxpEseCrc_Update(PH_NXP_ESE_CRC_INIT, p_buff, length) ^ PH_NXP_ESE_CRC_XOROUT);
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2024 NXP
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _PHNXPESE_CRC_H_
+#define _PHNXPESE_CRC_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/********************* Definitions and structures *****************************/
+
+/* CRC-16/X.25 (reflected polynomial 0x8408) used by the T=1oI2C frames */
+#define PH_NXP_ESE_CRC_INIT 0xFFFF
+#define PH_NXP_ESE_CRC_XOROUT 0xFFFF
+
+/* Below this length the carry-less multiply variant defers to the tables */
+#define PH_NXP_ESE_CRC_CLMUL_MIN_LEN 32
+
+typedef enum
+{
+    kPhNxpEseCrc_Bitwise = 0, /* One bit at a time, reference */
+    kPhNxpEseCrc_Slice8,      /* Slicing-by-8 tables */
+    kPhNxpEseCrc_Clmul,       /* PCLMULQDQ (x86) / PMULL (ARMv8, opt-in) folding */
+    kPhNxpEseCrc_Max,
+} phNxpEseCrc_Impl_t;
+
+/* Update a CRC register with length bytes. No initial value or final xor. */
+typedef uint16_t (*phNxpEseCrc_UpdateFn_t)(uint16_t crc, const uint8_t *p_buff, size_t length);
+
+/********************* Function prototypes ************************************/
+
+/* Reference update, one bit at a time */
+uint16_t phNxpEseCrc_UpdateBitwise(uint16_t crc, const uint8_t *p_buff, size_t length);
+/* Table driven update, eight bytes per step */
+uint16_t phNxpEseCrc_UpdateSlice8(uint16_t crc, const uint8_t *p_buff, size_t length);
+/* NULL when the variant is not built in or not supported by this CPU */
+phNxpEseCrc_UpdateFn_t phNxpEseCrc_GetUpdateFn(phNxpEseCrc_Impl_t impl);
+/* Variant used by phNxpEseCrc_Compute, selected once from the CPU features */
+phNxpEseCrc_Impl_t phNxpEseCrc_GetActiveImpl(void);
+const char *phNxpEseCrc_GetImplName(phNxpEseCrc_Impl_t impl);
+/* Update with the active variant, for frames held in several pieces */
+uint16_t phNxpEseCrc_Update(uint16_t crc, const uint8_t *p_buff, size_t length);
+/* CRC-16/X.25 of a buffer (initial value and final xor applied) */
+uint16_t phNxpEseCrc_Compute(const uint8_t *p_buff, size_t length);
+
+#endif /* _PHNXPESE_CRC_H_ */
@@ -1,5 +1,5 @@
 /*
- * Copyright 2010-2014,2018-2020,2022 NXP
+ * Copyright 2010-2014,2018-2020,2022,2024 NXP
  *
  * Licensed under the Apache License, Version 2.0 (the "License");
  * you may not use this file except in compliance with the License.
@@ -22,12 +22,217 @@
  */
 #include <phNxpEsePal_i2c.h>
 #include <phEseStatus.h>
+#include <string.h>
 #include "sm_i2c.h"
 #include "sm_timer.h"
 #include "sm_port.h"
+#if defined(SM_HAVE_SOCKET_TRANSPORT)
+#include "sm_socket.h"
+#endif
 
 #define MAX_RETRY_CNT 10
 
+/* Device handle of a connection: the selected transport and its context */
+typedef struct
+{
+    const phPalEse_Transport_t *pTransport;
+    void *pTransportCtx;
+    bool_t isBusyPoll; /* Delays spin on the clock instead of sleeping */
+} phPalEse_Handle_t;
+
+/* Peer of the next loopback connection */
+static phPalEse_LoopbackPeer_t gPalEse_loopbackPeer;
+
+/*******************************************************************************
+**
+** Function         phPalEse_i2c_status
+**
+** Description      Maps an I2C status to the status of a transport
+**
+*******************************************************************************/
+static ESESTATUS phPalEse_i2c_status(unsigned int i2cStatus)
+{
+    if (i2cStatus == I2C_OK) {
+        return ESESTATUS_SUCCESS;
+    }
+    else if (i2cStatus == I2C_NACK_ON_ADDRESS) {
+        return ESESTATUS_BUSY;
+    }
+#if defined(SM_I2C_HAVE_READ_FRAME) || defined(SM_I2C_HAVE_WRITEV)
+    else if (i2cStatus == I2C_NOT_SUPPORTED) {
+        return ESESTATUS_FEATURE_NOT_SUPPORTED;
+    }
+#endif
+    else if (i2cStatus == I2C_FAILED) {
+        return ESESTATUS_FAILED;
+    }
+    return ESESTATUS_BOARD_COMMUNICATION_ERROR;
+}
+
+/*******************************************************************************
+**
+** Function         phPalEse_i2c_transport_*
+**
+** Description      I2C transport, the default transport of a connection
+**
+*******************************************************************************/
+static ESESTATUS phPalEse_i2c_transport_open(void **ppTransportCtx, const char *pConnString)
+{
+    unsigned int i2c_ret = axI2CInit(ppTransportCtx, pConnString);
+    if (i2c_ret == I2C_BUSY) {
+        return ESESTATUS_BUSY;
+    }
+    return (i2c_ret == I2C_OK) ? ESESTATUS_SUCCESS : ESESTATUS_INVALID_DEVICE;
+}
+
+static void phPalEse_i2c_transport_close(void *pTransportCtx)
+{
+    axI2CTerm(pTransportCtx, 0);
+}
+
+static ESESTATUS phPalEse_i2c_transport_read(void *pTransportCtx, uint8_t *pBuffer, uint32_t len)
+{
+    return phPalEse_i2c_status(
+        axI2CRead(pTransportCtx, I2C_BUS_0, SMCOM_I2C_ADDRESS, pBuffer, (unsigned short)len));
+}
+
+static ESESTATUS phPalEse_i2c_transport_write(void *pTransportCtx, const uint8_t *pBuffer, uint32_t len)
+{
+    return phPalEse_i2c_status(
+        axI2CWrite(pTransportCtx, I2C_BUS_0, SMCOM_I2C_ADDRESS, (unsigned char *)pBuffer, (unsigned short)len));
+}
+
+#if defined(SM_I2C_HAVE_READ_FRAME)
+static ESESTATUS phPalEse_i2c_transport_readFrame(
+    void *pTransportCtx, uint8_t *pHeader, uint32_t headerLen, uint8_t *pBody, uint32_t bodyLen)
+{
+    return phPalEse_i2c_status(axI2CReadFrame(pTransportCtx,
+        I2C_BUS_0,
+        SMCOM_I2C_ADDRESS,
+        pHeader,
+        (unsigned short)headerLen,
+        pBody,
+        (unsigned short)bodyLen));
+}
+#endif
+
+#if defined(SM_I2C_HAVE_WRITEV)
+static ESESTATUS phPalEse_i2c_transport_writev(void *pTransportCtx, const phPalEse_IoVec_t *pIov, uint8_t iovCnt)
+{
+    sm_i2c_iovec_t iov[SM_I2C_MAX_IOV];
+
+    if (iovCnt > SM_I2C_MAX_IOV) {
+        return ESESTATUS_FEATURE_NOT_SUPPORTED;
+    }
+    for (int i = 0; i < iovCnt; i++) {
+        iov[i].pData = pIov[i].pData;
+        iov[i].len   = (unsigned short)pIov[i].len;
+    }
+    return phPalEse_i2c_status(axI2CWriteV(pTransportCtx, I2C_BUS_0, SMCOM_I2C_ADDRESS, iov, iovCnt));
+}
+#endif
+
+static const phPalEse_Transport_t gPalEse_i2cTransport = {
+    "i2c:",
+    &phPalEse_i2c_transport_open,
+    &phPalEse_i2c_transport_close,
+    &phPalEse_i2c_transport_read,
+    &phPalEse_i2c_transport_write,
+#if defined(SM_I2C_HAVE_READ_FRAME)
+    &phPalEse_i2c_transport_readFrame,
+#else
+    NULL,
+#endif
+#if defined(SM_I2C_HAVE_WRITEV)
+    &phPalEse_i2c_transport_writev,
+#else
+    NULL,
+#endif
+};
+
+/*******************************************************************************
+**
+** Function         phPalEse_loopback_transport_*
+**
+** Description      Loopback transport, exchanges the frames with an in-process peer
+**
+*******************************************************************************/
+static ESESTATUS phPalEse_loopback_transport_open(void **ppTransportCtx, const char *pConnString)
+{
+    phPalEse_LoopbackPeer_t *pPeer = NULL;
+    (void)pConnString;
+
+    if ((gPalEse_loopbackPeer.receive == NULL) || (gPalEse_loopbackPeer.send == NULL)) {
+        T_SMLOG_E("%s No loopback peer set", __FUNCTION__);
+        return ESESTATUS_INVALID_DEVICE;
+    }
+    pPeer = (phPalEse_LoopbackPeer_t *)sm_malloc(sizeof(phPalEse_LoopbackPeer_t));
+    if (pPeer == NULL) {
+        return ESESTATUS_INSUFFICIENT_RESOURCES;
+    }
+    memcpy(pPeer, &gPalEse_loopbackPeer, sizeof(*pPeer));
+    *ppTransportCtx = pPeer;
+    return ESESTATUS_SUCCESS;
+}
+
+static void phPalEse_loopback_transport_close(void *pTransportCtx)
+{
+    if (pTransportCtx != NULL) {
+        sm_free(pTransportCtx);
+    }
+}
+
+static ESESTATUS phPalEse_loopback_transport_read(void *pTransportCtx, uint8_t *pBuffer, uint32_t len)
+{
+    phPalEse_LoopbackPeer_t *pPeer = (phPalEse_LoopbackPeer_t *)pTransportCtx;
+    return pPeer->send(pPeer->pPeerCtx, pBuffer, len);
+}
+
+static ESESTATUS phPalEse_loopback_transport_write(void *pTransportCtx, const uint8_t *pBuffer, uint32_t len)
+{
+    phPalEse_LoopbackPeer_t *pPeer = (phPalEse_LoopbackPeer_t *)pTransportCtx;
+    return pPeer->receive(pPeer->pPeerCtx, pBuffer, len);
+}
+
+static const phPalEse_Transport_t gPalEse_loopbackTransport = {
+    "loop:",
+    &phPalEse_loopback_transport_open,
+    &phPalEse_loopback_transport_close,
+    &phPalEse_loopback_transport_read,
+    &phPalEse_loopback_transport_write,
+    NULL,
+    NULL,
+};
+
+/* Transports selectable with the scheme of the connection string, I2C is the default */
+static const phPalEse_Transport_t *const gPalEse_transports[] = {
+    &gPalEse_i2cTransport,
+    &gPalEse_loopbackTransport,
+#if defined(SM_HAVE_SOCKET_TRANSPORT)
+    &sm_socket_transport,
+#endif
+};
+
+/*******************************************************************************
+**
+** Function         phPalEse_i2c_write_delay
+**
+** Description      Delay before a write attempt. The I2C transport gives the ESE
+**                  ESE_POLL_DELAY_MS before every write. With busy polling the
+**                  first attempt is made at once and only retries are delayed.
+**
+*******************************************************************************/
+static void phPalEse_i2c_write_delay(phPalEse_Handle_t *pHandle, unsigned int retryCount)
+{
+    if (pHandle->pTransport != &gPalEse_i2cTransport) {
+        return;
+    }
+    if ((!pHandle->isBusyPoll) || (retryCount > 0)) {
+        /* 1ms delay to give ESE polling delay */
+        phPalEse_i2c_delay(pHandle, ESE_POLL_DELAY_MS * 1000);
+    }
+}
+
 /*******************************************************************************
 **
 ** Function         phPalEse_i2c_close
@@ -41,12 +246,16 @@
 *******************************************************************************/
 void phPalEse_i2c_close(void *pDevHandle)
 {
-#ifdef Android
-    if (NULL != pDevHandle) {
-        close((intptr_t)pDevHandle);
+    phPalEse_Handle_t *pHandle = (phPalEse_Handle_t *)pDevHandle;
+
+    if (NULL == pHandle) {
+        return;
     }
+#ifdef Android
+    close((intptr_t)pHandle->pTransportCtx);
 #endif
-    axI2CTerm(pDevHandle, 0);
+    pHandle->pTransport->close(pHandle->pTransportCtx);
+    sm_free(pHandle);
     pDevHandle = NULL;
 
     return;
@@ -56,7 +265,8 @@ void phPalEse_i2c_close(void *pDevHandle)
 **
 ** Function         phPalEse_i2c_open_and_configure
 **
-** Description      Open and configure pn547 device
+** Description      Open and configure pn547 device over the transport selected
+**                  by the connection string
 **
 ** param[in]        pConfig     - hardware information
 **
@@ -67,19 +277,41 @@ void phPalEse_i2c_close(void *pDevHandle)
 *******************************************************************************/
 ESESTATUS phPalEse_i2c_open_and_configure(pphPalEse_Config_t pConfig)
 {
-    void *conn_ctx       = NULL;
-    int retryCnt         = 0;
-    unsigned int i2c_ret = 0;
+    int retryCnt               = 0;
+    ESESTATUS status           = ESESTATUS_FAILED;
+    const char *pConnString    = (const char *)pConfig->pDevName;
+    phPalEse_Handle_t *pHandle = NULL;
+    size_t schemeLen           = 0;
+    size_t i                   = 0;
 
     T_SMLOG_D("%s Opening port", __FUNCTION__);
+    pConfig->pDevHandle = NULL;
+    pHandle             = (phPalEse_Handle_t *)sm_malloc(sizeof(phPalEse_Handle_t));
+    if (pHandle == NULL) {
+        return ESESTATUS_INSUFFICIENT_RESOURCES;
+    }
+    pHandle->pTransport    = &gPalEse_i2cTransport;
+    pHandle->pTransportCtx = NULL;
+    pHandle->isBusyPoll    = FALSE;
+    if (pConnString != NULL) {
+        for (i = 0; i < (sizeof(gPalEse_transports) / sizeof(gPalEse_transports[0])); i++) {
+            schemeLen = strlen(gPalEse_transports[i]->pScheme);
+            if (strncmp(pConnString, gPalEse_transports[i]->pScheme, schemeLen) == 0) {
+                pHandle->pTransport = gPalEse_transports[i];
+                pConnString += schemeLen;
+                break;
+            }
+        }
+    }
+
     /* open port */
     /*Disable as interface reset happens on every session open*/
     //se05x_ic_reset();
 retry:
-    i2c_ret = axI2CInit(&conn_ctx, (const char *)pConfig->pDevName);
-    if (i2c_ret != I2C_OK) {
+    status = pHandle->pTransport->open(&pHandle->pTransportCtx, pConnString);
+    if (status != ESESTATUS_SUCCESS) {
         T_SMLOG_E("%s Failed retry ", __FUNCTION__);
-        if (i2c_ret == I2C_BUSY) {
+        if (status == ESESTATUS_BUSY) {
             retryCnt++;
             T_SMLOG_E("Retry open eSE driver, retry cnt : %d ", retryCnt);
             if (retryCnt < MAX_RETRY_CNT) {
@@ -87,12 +319,12 @@ retry:
                 goto retry;
             }
         }
-        T_SMLOG_E("I2C init Failed: retval %x ", i2c_ret);
-        pConfig->pDevHandle = NULL;
+        T_SMLOG_E("%s transport open Failed: retval %x ", pHandle->pTransport->pScheme, status);
+        sm_free(pHandle);
         return ESESTATUS_INVALID_DEVICE;
     }
-    T_SMLOG_D("I2C driver Initialized :: fd = [%d] ", i2c_ret);
-    pConfig->pDevHandle = conn_ctx;
+    T_SMLOG_D("%s transport opened", pHandle->pTransport->pScheme);
+    pConfig->pDevHandle = pHandle;
     return ESESTATUS_SUCCESS;
 }
 
@@ -112,27 +344,28 @@ retry:
 *******************************************************************************/
 int phPalEse_i2c_read(void *pDevHandle, uint8_t *pBuffer, int nNbBytesToRead)
 {
-    unsigned int ret = 0;
-    int retryCount   = 0;
-    int numRead      = 0;
+    ESESTATUS ret              = ESESTATUS_SUCCESS;
+    int retryCount             = 0;
+    int numRead                = 0;
+    phPalEse_Handle_t *pHandle = (phPalEse_Handle_t *)pDevHandle;
     T_SMLOG_D("%s Read Requested %d bytes ", __FUNCTION__, nNbBytesToRead);
     //sm_sleep(ESE_POLL_DELAY_MS);
     while (numRead != nNbBytesToRead) {
-        ret = axI2CRead(pDevHandle, I2C_BUS_0, SMCOM_I2C_ADDRESS, pBuffer, nNbBytesToRead);
-        if (ret != I2C_OK) {
+        ret = pHandle->pTransport->read(pHandle->pTransportCtx, pBuffer, (uint32_t)nNbBytesToRead);
+        if (ret != ESESTATUS_SUCCESS) {
             T_SMLOG_D("_i2c_read() error : %d ", ret);
             /* if platform returns different error codes, modify the check below.*/
             /* Also adjust the retry count based on the platform */
 #ifdef T1OI2C_RETRY_ON_I2C_FAILED
-            if (((ret == I2C_FAILED) || (ret == I2C_NACK_ON_ADDRESS)) && (retryCount < MAX_RETRY_COUNT)) {
+            if (((ret == ESESTATUS_FAILED) || (ret == ESESTATUS_BUSY)) && (retryCount < MAX_RETRY_COUNT)) {
 #else
-            if ((ret == I2C_NACK_ON_ADDRESS) && (retryCount < MAX_RETRY_COUNT)) {
+            if ((ret == ESESTATUS_BUSY) && (retryCount < MAX_RETRY_COUNT)) {
 #endif
                 retryCount++;
                 /* 1ms delay to give ESE polling delay */
                 /*i2c driver back off delay is providing 1ms wait time so ignoring waiting time at this level*/
 #ifdef T1OI2C_RETRY_ON_I2C_FAILED
-                sm_sleep(ESE_POLL_DELAY_MS);
+                phPalEse_i2c_delay(pHandle, ESE_POLL_DELAY_MS * 1000);
 #endif
                 T_SMLOG_D("_i2c_read() failed. Going to retry, counter:%d  !", retryCount);
                 continue;
@@ -147,6 +380,82 @@ int phPalEse_i2c_read(void *pDevHandle, uint8_t *pBuffer, int nNbBytesToRead)
     return numRead;
 }
 
+/*******************************************************************************
+**
+** Function         phPalEse_i2c_poll
+**
+** Description      Single read attempt without retries, used to poll the device
+**                  with short delays. A busy device (NACK) fails immediately.
+**
+** param[in]       pDevHandle       - valid device handle
+** param[in]       pBuffer          - buffer for read data
+** param[in]       nNbBytesToRead   - number of bytes requested to be read
+**
+** Returns          numRead   - number of successfully read bytes
+**                  -1        - read operation failure
+**
+*******************************************************************************/
+int phPalEse_i2c_poll(void *pDevHandle, uint8_t *pBuffer, int nNbBytesToRead)
+{
+    ESESTATUS ret              = ESESTATUS_SUCCESS;
+    phPalEse_Handle_t *pHandle = (phPalEse_Handle_t *)pDevHandle;
+    T_SMLOG_D("%s Poll Requested %d bytes ", __FUNCTION__, nNbBytesToRead);
+    ret = pHandle->pTransport->read(pHandle->pTransportCtx, pBuffer, (uint32_t)nNbBytesToRead);
+    if (ret != ESESTATUS_SUCCESS) {
+        T_SMLOG_D("_i2c_poll() error : %d ", ret);
+        return -1;
+    }
+    return nNbBytesToRead;
+}
+
+/*******************************************************************************
+**
+** Function         phPalEse_i2c_read_frame
+**
+** Description      Reads up to a complete frame in a single transfer, if the platform
+**                  and adapter support it. Retries while the device is busy (NACK).
+**
+** param[in]       pDevHandle       - valid device handle
+** param[in]       pHeader          - buffer for the header of the frame
+** param[in]       headerLen        - number of header bytes of the frame
+** param[in]       pBody            - buffer for the remainder of the frame
+** param[in]       bodyLen          - number of remainder bytes requested to be read
+** param[in]       maxRetry         - max number of retries while the device is busy
+**
+** Returns          numRead   - number of successfully read bytes
+**                  -1        - read operation failure
+**                  -2        - not supported, phPalEse_i2c_read has to be used
+**
+*******************************************************************************/
+int phPalEse_i2c_read_frame(
+    void *pDevHandle, uint8_t *pHeader, int headerLen, uint8_t *pBody, int bodyLen, int maxRetry)
+{
+    ESESTATUS ret              = ESESTATUS_SUCCESS;
+    int retryCount             = 0;
+    phPalEse_Handle_t *pHandle = (phPalEse_Handle_t *)pDevHandle;
+
+    if (pHandle->pTransport->readFrame == NULL) {
+        return -2;
+    }
+    T_SMLOG_D("%s Read Requested %d bytes ", __FUNCTION__, (headerLen + bodyLen));
+    while (1) {
+        ret = pHandle->pTransport->readFrame(
+            pHandle->pTransportCtx, pHeader, (uint32_t)headerLen, pBody, (uint32_t)bodyLen);
+        if (ret == ESESTATUS_SUCCESS) {
+            return (headerLen + bodyLen);
+        }
+        else if (ret == ESESTATUS_FEATURE_NOT_SUPPORTED) {
+            return -2;
+        }
+        T_SMLOG_D("_i2c_read_frame() error : %d ", ret);
+        if (retryCount >= maxRetry) {
+            return -1;
+        }
+        retryCount++;
+        phPalEse_i2c_delay(pHandle, ESE_POLL_DELAY_MS * 1000);
+    }
+}
+
 /*******************************************************************************
 **
 ** Function         phPalEse_i2c_write
@@ -163,16 +472,17 @@ int phPalEse_i2c_read(void *pDevHandle, uint8_t *pBuffer, int nNbBytesToRead)
 *******************************************************************************/
 int phPalEse_i2c_write(void *pDevHandle, uint8_t *pBuffer, int nNbBytesToWrite)
 {
-    unsigned int ret = I2C_OK, retryCount = 0;
-    int numWrote = 0;
-    pBuffer[0]   = 0x5A; //Recovery if stack forgot to add NAD byte.
+    ESESTATUS ret              = ESESTATUS_SUCCESS;
+    unsigned int retryCount    = 0;
+    int numWrote               = 0;
+    phPalEse_Handle_t *pHandle = (phPalEse_Handle_t *)pDevHandle;
+    pBuffer[0]                 = 0x5A; //Recovery if stack forgot to add NAD byte.
     do {
-        /* 1ms delay to give ESE polling delay */
-        sm_sleep(ESE_POLL_DELAY_MS);
-        ret = axI2CWrite(pDevHandle, I2C_BUS_0, SMCOM_I2C_ADDRESS, pBuffer, nNbBytesToWrite);
-        if (ret != I2C_OK) {
+        phPalEse_i2c_write_delay(pHandle, retryCount);
+        ret = pHandle->pTransport->write(pHandle->pTransportCtx, pBuffer, (uint32_t)nNbBytesToWrite);
+        if (ret != ESESTATUS_SUCCESS) {
             T_SMLOG_D("_i2c_write() error : %d ", ret);
-            if ((ret == I2C_NACK_ON_ADDRESS) && (retryCount < MAX_RETRY_COUNT)) {
+            if ((ret == ESESTATUS_BUSY) && (retryCount < MAX_RETRY_COUNT)) {
                 retryCount++;
                 /* 1ms delay to give ESE polling delay */
                 /*i2c driver back off delay is providing 1ms wait time so ignoring waiting time at this level*/
@@ -187,6 +497,132 @@ int phPalEse_i2c_write(void *pDevHandle, uint8_t *pBuffer, int nNbBytesToWrite)
             //sm_sleep(ESE_POLL_DELAY_MS);
             break;
         }
-    } while (ret != I2C_OK);
+    } while (ret != ESESTATUS_SUCCESS);
     return numWrote;
 }
+
+/*******************************************************************************
+**
+** Function         phPalEse_i2c_writev
+**
+** Description      Writes a frame held in several pieces (e.g. header, data in the
+**                  caller's buffer, CRC) as one I2C write, without copying the pieces,
+**                  if the platform and adapter support it.
+**
+** param[in]       pDevHandle       - valid device handle
+** param[in]       pIov             - pieces of the frame, the first one starts with the NAD
+** param[in]       iovCnt           - number of pieces
+**
+** Returns          numWrote   - number of successfully written bytes
+**                  -1         - write operation failure
+**                  -2         - not supported, the pieces have to be written with phPalEse_i2c_write
+**
+*******************************************************************************/
+int phPalEse_i2c_writev(void *pDevHandle, const phPalEse_IoVec_t *pIov, int iovCnt)
+{
+    ESESTATUS ret              = ESESTATUS_SUCCESS;
+    unsigned int retryCount    = 0;
+    int numToWrite             = 0;
+    phPalEse_Handle_t *pHandle = (phPalEse_Handle_t *)pDevHandle;
+
+    if (pHandle->pTransport->writev == NULL) {
+        return -2;
+    }
+    if ((pIov == NULL) || (iovCnt <= 0) || (iovCnt > UINT8_MAX)) {
+        return -1;
+    }
+    for (int i = 0; i < iovCnt; i++) {
+        if ((pIov[i].len == 0) || (pIov[i].len > MAX_APDU_BUFFER)) {
+            return -1;
+        }
+        numToWrite += (int)pIov[i].len;
+    }
+    do {
+        phPalEse_i2c_write_delay(pHandle, retryCount);
+        ret = pHandle->pTransport->writev(pHandle->pTransportCtx, pIov, (uint8_t)iovCnt);
+        if (ret == ESESTATUS_FEATURE_NOT_SUPPORTED) {
+            return -2;
+        }
+        if (ret != ESESTATUS_SUCCESS) {
+            T_SMLOG_D("_i2c_writev() error : %d ", ret);
+            if ((ret == ESESTATUS_BUSY) && (retryCount < MAX_RETRY_COUNT)) {
+                retryCount++;
+                T_SMLOG_D("_i2c_writev() failed. Going to retry, counter:%d  !", retryCount);
+                continue;
+            }
+            return -1;
+        }
+    } while (ret != ESESTATUS_SUCCESS);
+    return numToWrite;
+}
+
+/*******************************************************************************
+**
+** Function         phPalEse_i2c_set_busy_poll
+**
+** Description      Selects how the connection waits for the ESE. With busy polling
+**                  the delays spin on the monotonic clock instead of sleeping, which
+**                  avoids the wake-up latency of the scheduler but occupies the CPU.
+**
+** param[in]       pDevHandle       - valid device handle
+** param[in]       isBusyPoll       - TRUE to spin, FALSE to sleep (default)
+**
+** Returns          None
+**
+*******************************************************************************/
+void phPalEse_i2c_set_busy_poll(void *pDevHandle, bool_t isBusyPoll)
+{
+    phPalEse_Handle_t *pHandle = (phPalEse_Handle_t *)pDevHandle;
+
+    if (pHandle != NULL) {
+        pHandle->isBusyPoll = isBusyPoll;
+    }
+}
+
+/*******************************************************************************
+**
+** Function         phPalEse_i2c_delay
+**
+** Description      Waits before the next access to the ESE, sleeping or spinning
+**                  as selected with phPalEse_i2c_set_busy_poll
+**
+** param[in]       pDevHandle       - valid device handle, NULL to sleep
+** param[in]       microsec         - time to wait
+**
+** Returns          None
+**
+*******************************************************************************/
+void phPalEse_i2c_delay(void *pDevHandle, uint32_t microsec)
+{
+    phPalEse_Handle_t *pHandle = (phPalEse_Handle_t *)pDevHandle;
+    uint64_t endUs             = 0;
+
+    if ((pHandle == NULL) || (!pHandle->isBusyPoll)) {
+        sm_usleep(microsec);
+        return;
+    }
+    endUs = sm_get_time_us() + microsec;
+    while (sm_get_time_us() < endUs) {
+    }
+}
+
+/*******************************************************************************
+**
+** Function         phPalEse_loopback_setPeer
+**
+** Description      Sets the peer of the connections opened next with the
+**                  loopback transport (connection string "loop:")
+**
+** param[in]       pPeer            - peer, copied. NULL to remove the peer
+**
+** Returns          None
+**
+*******************************************************************************/
+void phPalEse_loopback_setPeer(const phPalEse_LoopbackPeer_t *pPeer)
+{
+    if (pPeer == NULL) {
+        memset(&gPalEse_loopbackPeer, 0, sizeof(gPalEse_loopbackPeer));
+        return;
+    }
+    memcpy(&gPalEse_loopbackPeer, pPeer, sizeof(gPalEse_loopbackPeer));
+}
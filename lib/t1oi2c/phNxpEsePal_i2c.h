@@ -1,5 +1,5 @@
 /*
- * Copyright 2010-2014,2018-2020,2022 NXP
+ * Copyright 2010-2014,2018-2020,2022,2024 NXP
  *
  * Licensed under the Apache License, Version 2.0 (the "License");
  * you may not use this file except in compliance with the License.
@@ -23,6 +23,7 @@
 
 /* Basic type definitions */
 #include <phEseTypes.h>
+#include <phEseStatus.h>
 
 /*!
  * \brief ESE Poll timeout (min 1 miliseconds)
@@ -43,6 +44,28 @@
 #else
 #define ESE_NAD_POLLING_MAX (30) // With backoff delay implementation, this will have the read duration of ~20 seconds.
 #endif
+/*!
+ * \brief Max. number of single polls for a frame, each after ESE_POLL_DELAY_MS.
+ * Same budget as ESE_NAD_POLLING_MAX rounds of reads retried MAX_RETRY_COUNT times.
+ */
+#define ESE_POLL_COUNT_MAX (ESE_NAD_POLLING_MAX * (MAX_RETRY_COUNT + 1))
+/*!
+ * \brief Max time to wait for one readiness notification of the SE.
+ * Used instead of ESE_POLL_DELAY_MS for each polling round when a readiness notifier is configured.
+ */
+#define ESE_READY_WAIT_TIMEOUT_MS (500)
+
+/*!
+ * \brief First poll delay of the microsecond backoff, applied after the expected processing time of a command.
+ * The delay doubles each round until ESE_POLL_DELAY_MS is reached, then regular polling continues.
+ */
+#define ESE_POLL_BACKOFF_MIN_US (100)
+
+/*!
+ * \brief Number of microsecond backoff rounds (100, 200, 400, 800 us) before regular polling
+ */
+#define ESE_POLL_BACKOFF_ROUNDS (4)
+
 /*!
  * \brief Max retry count for Write
  */
@@ -99,9 +122,161 @@ typedef struct phPalEse_Config
     /*!< Device handle output */
 } phPalEse_Config_t, *pphPalEse_Config_t; /* pointer to phPalEse_Config_t */
 
+/*!
+ * \ingroup eSe_PAL_I2C
+ *
+ * \brief Notifier signalling that the SE has a frame ready to be read
+ * (e.g. an interrupt / data ready line of the SE).
+ *
+ * When configured for a connection, the reception waits on the notifier
+ * instead of polling the SE with fixed delays.
+ */
+typedef struct phPalEse_ReadyNotifier
+{
+    ESESTATUS (*wait)(void *pNotifierCtx, uint32_t timeoutMs);
+    /*!< Block until the SE signals data ready.
+      *
+      * Returns ESESTATUS_SUCCESS when data is ready, ESESTATUS_PENDING when
+      * the timeout expired and any other value on error.
+      */
+
+    void (*release)(void *pNotifierCtx);
+    /*!< Release the resources of the notifier. Optional, can be NULL */
+
+    void *pNotifierCtx;
+    /*!< Context passed to the notifier functions */
+} phPalEse_ReadyNotifier_t;
+
+/*!
+ * \ingroup eSe_PAL_I2C
+ *
+ * \brief One piece of a frame written with phPalEse_i2c_writev
+ */
+typedef struct phPalEse_IoVec
+{
+    const uint8_t *pData; /*!< Data of the piece */
+    uint32_t len;         /*!< Length of the piece */
+} phPalEse_IoVec_t;
+
+/*!
+ * \ingroup eSe_PAL_I2C
+ *
+ * \brief Transport carrying the T=1oI2C frames between host and SE.
+ *
+ * The transport of a connection is selected by the scheme prefix of the
+ * connection string, e.g. "loop:" or "unix:/tmp/se05x.sock". Connection
+ * strings without a known scheme (e.g. "/dev/i2c-1:0x48") and NULL select
+ * the I2C transport.
+ *
+ * Transport functions return ESESTATUS_SUCCESS, ESESTATUS_BUSY when the SE
+ * did not acknowledge (I2C NACK, the PAL retries) and any other value on error.
+ */
+typedef struct phPalEse_Transport
+{
+    const char *pScheme;
+    /*!< Prefix of the connection string selecting the transport, removed before open */
+
+    ESESTATUS (*open)(void **ppTransportCtx, const char *pConnString);
+    /*!< Open the transport, ESESTATUS_BUSY to retry later */
+
+    void (*close)(void *pTransportCtx);
+    /*!< Close the transport and release its context */
+
+    ESESTATUS (*read)(void *pTransportCtx, uint8_t *pBuffer, uint32_t len);
+    /*!< Read len bytes from the SE */
+
+    ESESTATUS (*write)(void *pTransportCtx, const uint8_t *pBuffer, uint32_t len);
+    /*!< Write len bytes to the SE */
+
+    ESESTATUS (*readFrame)(
+        void *pTransportCtx, uint8_t *pHeader, uint32_t headerLen, uint8_t *pBody, uint32_t bodyLen);
+    /*!< Read header and body of a frame in one transfer. Optional, can be NULL.
+      * ESESTATUS_FEATURE_NOT_SUPPORTED when not possible, the frame is then read in parts */
+
+    ESESTATUS (*writev)(void *pTransportCtx, const phPalEse_IoVec_t *pIov, uint8_t iovCnt);
+    /*!< Write a frame held in pieces in one transfer. Optional, can be NULL.
+      * ESESTATUS_FEATURE_NOT_SUPPORTED when not possible, the pieces are then copied */
+} phPalEse_Transport_t;
+
+/*!
+ * \ingroup eSe_PAL_I2C
+ *
+ * \brief In-process peer of the loopback transport ("loop:"), e.g. a simulated SE.
+ * The frames written by the host are passed to the peer, the bytes read by the
+ * host are taken from the peer. No bus is involved, which allows to measure the
+ * host side cost of the stack.
+ */
+typedef struct phPalEse_LoopbackPeer
+{
+    ESESTATUS (*receive)(void *pPeerCtx, const uint8_t *pData, uint32_t len);
+    /*!< Bytes written by the host. ESESTATUS_BUSY to not acknowledge them */
+
+    ESESTATUS (*send)(void *pPeerCtx, uint8_t *pBuffer, uint32_t len);
+    /*!< Bytes read by the host. ESESTATUS_BUSY when the peer has nothing to send */
+
+    void *pPeerCtx;
+    /*!< Context passed to the peer functions */
+} phPalEse_LoopbackPeer_t;
+
+/*!
+ * \ingroup eSe_PAL_I2C
+ *
+ * \brief Direction of a frame passed to a frame tap
+ */
+typedef enum
+{
+    PH_PAL_ESE_TAP_DIR_TX = 0, /*!< Frame written to the SE */
+    PH_PAL_ESE_TAP_DIR_RX = 1, /*!< Frame read from the SE */
+} phPalEse_TapDirection;
+
+/*!
+ * \ingroup eSe_PAL_I2C
+ *
+ * \brief Timing of a frame passed to a frame tap. Time stamps are taken
+ * with sm_get_time_ns.
+ */
+typedef struct phPalEse_TapInfo
+{
+    phPalEse_TapDirection direction; /*!< Direction of the frame */
+    uint32_t pollCount;              /*!< Polls of the SE until the frame was read, 0 for a written frame */
+    uint64_t readStartNs;            /*!< Start of the read of the frame (before the first poll), 0 for a written frame */
+    uint64_t startNs;                /*!< Start of the I2C transfer(s) of the frame */
+    uint64_t endNs;                  /*!< End of the I2C transfer(s) of the frame */
+} phPalEse_TapInfo_t;
+
+/*!
+ * \ingroup eSe_PAL_I2C
+ *
+ * \brief Frame tap, receives every raw T=1 frame written to and read from the SE.
+ *
+ * Used to capture the frames of a connection for offline analysis
+ * (e.g. sm_pcapng_tap_open on Linux).
+ */
+typedef struct phPalEse_FrameTap
+{
+    void (*record)(void *pTapCtx, const phPalEse_TapInfo_t *pInfo, const phPalEse_IoVec_t *pIov, uint8_t iovCnt);
+    /*!< Record one complete frame, held in iovCnt pieces.
+      *
+      * Called in the context of the transceive, should not block.
+      */
+
+    void (*release)(void *pTapCtx);
+    /*!< Release the resources of the tap. Optional, can be NULL */
+
+    void *pTapCtx;
+    /*!< Context passed to the tap functions */
+} phPalEse_FrameTap_t;
+
 void phPalEse_i2c_close(void *pDevHandle);
 ESESTATUS phPalEse_i2c_open_and_configure(pphPalEse_Config_t pConfig);
 int phPalEse_i2c_read(void *pDevHandle, uint8_t *pBuffer, int nNbBytesToRead);
+int phPalEse_i2c_poll(void *pDevHandle, uint8_t *pBuffer, int nNbBytesToRead);
+int phPalEse_i2c_read_frame(
+    void *pDevHandle, uint8_t *pHeader, int headerLen, uint8_t *pBody, int bodyLen, int maxRetry);
 int phPalEse_i2c_write(void *pDevHandle, uint8_t *pBuffer, int nNbBytesToWrite);
+int phPalEse_i2c_writev(void *pDevHandle, const phPalEse_IoVec_t *pIov, int iovCnt);
+void phPalEse_i2c_set_busy_poll(void *pDevHandle, bool_t isBusyPoll);
+void phPalEse_i2c_delay(void *pDevHandle, uint32_t microsec);
+void phPalEse_loopback_setPeer(const phPalEse_LoopbackPeer_t *pPeer);
 /** @} */
 #endif /*  _PHNXPESE_PAL_I2C_H    */
@@ -16,6 +16,8 @@
 
 #include <stdbool.h>
 #include <phNxpEseProto7816_3.h>
+#include <phNxpEseCrc.h>
+#include <phNxpEse_Internal.h>
 #include <phNxpEsePal_i2c.h>
 #include <phEseTypes.h>
 #include "sm_timer.h"
@@ -28,8 +30,6 @@
  *
  * @{ */
 
-phNxpEseProto7816_t phNxpEseProto7816_3_Var;
-
 /******************************************************************************
 \section Introduction Introduction
 
@@ -37,21 +37,53 @@ phNxpEseProto7816_t phNxpEseProto7816_3_Var;
  *
  ******************************************************************************/
 static bool_t phNxpEseProto7816_SendRawFrame(void *conn_ctx, uint32_t data_len, uint8_t *p_data);
-static bool_t phNxpEseProto7816_GetRawFrame(void *conn_ctx, uint32_t *data_len, uint8_t **pp_data);
+static void phNxpEseProto7816_StartRawFrame(void *conn_ctx, uint32_t *pWaitUs);
+static ESESTATUS phNxpEseProto7816_TryRawFrame(
+    void *conn_ctx, uint32_t *data_len, uint8_t **pp_data, uint8_t **pp_inf, uint32_t *pWaitUs);
 static uint16_t phNxpEseProto7816_ComputeCRC(unsigned char *p_buff, uint32_t offset, uint32_t length);
-static bool_t phNxpEseProto7816_CheckCRC(uint32_t data_len, uint8_t *p_data);
+static uint16_t phNxpEseProto7816_ComputeFrameCRC(const uint8_t *p_header, const uint8_t *p_inf, uint32_t inf_len);
+static bool_t phNxpEseProto7816_CheckCRC(uint32_t data_len, uint8_t *p_data, uint8_t *p_inf);
 static bool_t phNxpEseProto7816_SendSFrame(void *conn_ctx, sFrameInfo_t sFrameData);
 static bool_t phNxpEseProto7816_SendIframe(void *conn_ctx, iFrameInfo_t iFrameData);
 static bool_t phNxpEseProto7816_sendRframe(void *conn_ctx, rFrameTypes_t rFrameType);
-static bool_t phNxpEseProto7816_SetFirstIframeContxt(void);
-static bool_t phNxpEseProto7816_SetNextIframeContxt(void);
-static bool_t phNxpEseProro7816_SaveRxframeData(uint8_t *p_data, uint32_t data_len);
-static bool_t phNxpEseProto7816_ResetRecovery(void);
-static bool_t phNxpEseProto7816_RecoverySteps(void);
-static bool_t phNxpEseProto7816_DecodeFrame(uint8_t *p_data, uint32_t data_len);
-static bool_t phNxpEseProto7816_ProcessResponse(void *conn_ctx);
+static bool_t phNxpEseProto7816_SetFirstIframeContxt(void *conn_ctx);
+static bool_t phNxpEseProto7816_SetNextIframeContxt(void *conn_ctx);
+static bool_t phNxpEseProro7816_SaveRxframeData(void *conn_ctx, uint8_t *p_data, uint32_t data_len);
+static bool_t phNxpEseProto7816_ResetRecovery(void *conn_ctx);
+static bool_t phNxpEseProto7816_RecoverySteps(void *conn_ctx);
+static bool_t phNxpEseProto7816_DecodeFrame(void *conn_ctx, uint8_t *p_data, uint8_t *p_inf, uint32_t data_len);
+static bool_t phNxpEseProto7816_ProcessResponse(
+    void *conn_ctx, bool_t isFrameRead, uint32_t data_len, uint8_t *p_data, uint8_t *p_inf);
+static bool_t phNxpEseProto7816_SendNextFrame(void *conn_ctx);
+static void phNxpEseProto7816_RecordWtx(void *conn_ctx);
+static void phNxpEseProto7816_StartSteps(void *conn_ctx);
+static void phNxpEseProto7816_ChargePhaseTime(void *conn_ctx, uint64_t *pNextPhaseTimeUs);
+static void phNxpEseProto7816_SetPhase(void *conn_ctx, phNxpEseProto7816_StepPhase_t phase);
+static uint64_t phNxpEseProto7816_GetTimeLeft(void *conn_ctx);
+static uint32_t phNxpEseProto7816_GetRecoveryCost(phNxpEseProto7816_TransceiveStates_t state);
+static phNxpEse_StepResult phNxpEseProto7816_StepWait(void *conn_ctx, phNxpEse_StepResult result, uint32_t *pWaitUs);
+static phNxpEse_StepResult phNxpEseProto7816_Abandon(void *conn_ctx);
 static bool_t TransceiveProcess(void *conn_ctx);
 static bool_t phNxpEseProto7816_RSync(void *conn_ctx);
+static bool_t phNxpEseProto7816_DecodeIfsc(const phNxpEse_data *pAtrRsp, uint16_t *pIfsc);
+static void phNxpEseProto7816_NegotiateIfs(void *conn_ctx, phNxpEse_data *AtrRsp);
+
+/******************************************************************************
+ * Function         phNxpEseProto7816_GetCntx
+ *
+ * Description      This internal function returns the 7816-3 protocol stack
+ *                  instance of the connection
+ *
+ * param[in]        void* conn_ctx
+ *
+ * Returns          Pointer to protocol stack instance.
+ *
+ ******************************************************************************/
+static phNxpEseProto7816_t *phNxpEseProto7816_GetCntx(void *conn_ctx)
+{
+    phNxpEse_Context_t *nxpese_ctxt = (conn_ctx == NULL) ? &gnxpese_ctxt : (phNxpEse_Context_t *)conn_ctx;
+    return &nxpese_ctxt->protoCntx;
+}
 
 /******************************************************************************
  * Function         phNxpEseProto7816_SendRawFrame
@@ -71,34 +103,83 @@ static bool_t phNxpEseProto7816_SendRawFrame(void *conn_ctx, uint32_t data_len,
     if (ESESTATUS_SUCCESS != status) {
         T_SMLOG_E("%s Error phNxpEse_WriteFrame ", __FUNCTION__);
     }
+    else {
+        phNxpEse_getStatsCntx(conn_ctx)->framesSent++;
+    }
 
     return (status == ESESTATUS_SUCCESS) ? TRUE : FALSE;
 }
 
 /******************************************************************************
- * Function         phNxpEseProto7816_GetRawFrame
+ * Function         phNxpEseProto7816_StartRawFrame
+ *
+ * Description      This internal function is called to prepare reading the next
+ *                  frame from the ESE. During a transceive the INF field of an
+ *                  I-frame is read straight to the next free byte of the response buffer.
+ *
+ * param[in]        void* conn_ctx
+ * param[out]       uint32_t* : time to wait before the first read attempt
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void phNxpEseProto7816_StartRawFrame(void *conn_ctx, uint32_t *pWaitUs)
+{
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+    phNxpEseRx_Cntx_t *pRx_EseCntx       = &pProto7816_Cntx->phNxpEseRx_Cntx;
+    phNxpEse_data *pRsp                  = pRx_EseCntx->pRsp;
+
+    if ((pProto7816_Cntx->phNxpEseProto7816_CurrentState == PH_NXP_ESE_PROTO_7816_TRANSCEIVE) && (pRsp != NULL) &&
+        (pRsp->p_data != NULL) && (pRx_EseCntx->responseBytesRcvd < pRsp->len)) {
+        /* Bytes beyond the INF field are only written if they do not hold the C-APDU */
+        phNxpEse_setRxTarget(conn_ctx,
+            (pRsp->p_data + pRx_EseCntx->responseBytesRcvd),
+            (uint32_t)(pRsp->len - pRx_EseCntx->responseBytesRcvd),
+            (pRx_EseCntx->isRspOverlappingCmd ? FALSE : TRUE));
+    }
+    if (ESESTATUS_SUCCESS != phNxpEse_startRead(conn_ctx, pWaitUs)) {
+        T_SMLOG_E("%s phNxpEse_startRead failed", __FUNCTION__);
+    }
+}
+
+/******************************************************************************
+ * Function         phNxpEseProto7816_TryRawFrame
  *
- * Description      This internal function is called read the data from the ESE
+ * Description      This internal function is called to poll the ESE once for
+ *                  the frame prepared with phNxpEseProto7816_StartRawFrame.
  *
+ * param[in]        void* conn_ctx
  * param[out]        uint32_t: number of bytes read
  * param[out]        uint8_t : Read data from ESE
+ * param[out]        uint8_t : INF field of the frame, follows the header or in
+ *                             the response buffer
+ * param[out]       uint32_t* : with ESESTATUS_PENDING, time to wait before polling again
  *
- * Returns          On success return TRUE or else FALSE.
+ * Returns          ESESTATUS_SUCCESS, ESESTATUS_PENDING if no frame is available yet,
+ *                  ESESTATUS_FAILED if the frame could not be read.
  *
  ******************************************************************************/
-static bool_t phNxpEseProto7816_GetRawFrame(void *conn_ctx, uint32_t *data_len, uint8_t **pp_data)
+static ESESTATUS phNxpEseProto7816_TryRawFrame(
+    void *conn_ctx, uint32_t *data_len, uint8_t **pp_data, uint8_t **pp_inf, uint32_t *pWaitUs)
 {
-    bool_t bStatus   = FALSE;
-    ESESTATUS status = ESESTATUS_FAILED;
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+    phNxpEseRx_Cntx_t *pRx_EseCntx       = &pProto7816_Cntx->phNxpEseRx_Cntx;
+    ESESTATUS status                     = ESESTATUS_FAILED;
 
-    status = phNxpEse_read(conn_ctx, data_len, pp_data);
+    status = phNxpEse_tryRead(conn_ctx, data_len, pp_data, pWaitUs);
+    if (ESESTATUS_PENDING == status) {
+        return status;
+    }
     if (ESESTATUS_SUCCESS != status) {
-        T_SMLOG_E("%s phNxpEse_read failed , status : 0x%x ", __FUNCTION__, status);
+        T_SMLOG_E("%s phNxpEse_tryRead failed , status : 0x%x ", __FUNCTION__, status);
     }
     else {
-        bStatus = TRUE;
+        *pp_inf = phNxpEse_getRxInf(conn_ctx);
+        if ((pRx_EseCntx->isRspOverlappingCmd) && (*pp_inf != &(*pp_data)[PH_PROPTO_7816_INF_BYTE_OFFSET])) {
+            pRx_EseCntx->isCmdOverwritten = TRUE;
+        }
     }
-    return bStatus;
+    return status;
 }
 
 /******************************************************************************
@@ -116,22 +197,11 @@ static bool_t phNxpEseProto7816_GetRawFrame(void *conn_ctx, uint32_t *data_len,
 static uint16_t phNxpEseProto7816_ComputeCRC(unsigned char *p_buff, uint32_t offset, uint32_t length)
 {
     uint16_t CAL_CRC = 0xFFFF, CRC = 0x0000;
-    uint32_t i = 0;
 
     ENSURE_OR_GO_EXIT(p_buff != NULL);
 
-    for (i = offset; i < length; i++) {
-        CAL_CRC ^= p_buff[i];
-        for (int bit = 8; bit > 0; --bit) {
-            if ((CAL_CRC & 0x0001) == 0x0001) {
-                CAL_CRC = (unsigned short)((CAL_CRC >> 1) ^ 0x8408);
-            }
-            else {
-                CAL_CRC >>= 1;
-            }
-        }
-    }
-    CAL_CRC ^= 0xFFFF;
+    /* Variant (bitwise, slicing-by-8, carry-less multiply) chosen at runtime */
+    CAL_CRC = (offset < length) ? phNxpEseCrc_Compute(&p_buff[offset], (length - offset)) : 0x0000;
 #if defined(T1oI2C_UM11225)
     CRC = ((CAL_CRC & 0xFF) << 8) | ((CAL_CRC >> 8) & 0xFF);
 #elif defined(T1oI2C_GP1_0)
@@ -141,6 +211,34 @@ exit:
     return (uint16_t)CRC;
 }
 
+/******************************************************************************
+ * Function         phNxpEseProto7816_ComputeFrameCRC
+ *
+ * Description      This internal function is called compute the CRC of a
+ *                  frame whose header and INF field are held separately
+ *
+ * param[in]        const uint8_t: frame header (NAD, PCB, LEN)
+ * param[in]        const uint8_t: INF field
+ * param[in]        uint32_t : length of the INF field
+ *
+ * Returns          CRC in the byte order of ComputeCRC.
+ *
+ ******************************************************************************/
+static uint16_t phNxpEseProto7816_ComputeFrameCRC(const uint8_t *p_header, const uint8_t *p_inf, uint32_t inf_len)
+{
+    uint16_t CAL_CRC = PH_NXP_ESE_CRC_INIT, CRC = 0x0000;
+
+    CAL_CRC = phNxpEseCrc_Update(CAL_CRC, p_header, PH_PROTO_7816_HEADER_LEN);
+    CAL_CRC = phNxpEseCrc_Update(CAL_CRC, p_inf, inf_len);
+    CAL_CRC ^= PH_NXP_ESE_CRC_XOROUT;
+#if defined(T1oI2C_UM11225)
+    CRC = ((CAL_CRC & 0xFF) << 8) | ((CAL_CRC >> 8) & 0xFF);
+#elif defined(T1oI2C_GP1_0)
+    CRC = CAL_CRC;
+#endif
+    return (uint16_t)CRC;
+}
+
 /******************************************************************************
  * Function         phNxpEseProto7816_CheckCRC
  *
@@ -149,27 +247,39 @@ exit:
  *
  * param[in]        uint32_t : frame length
  * param[in]        uint8_t: data buffer
+ * param[in]        uint8_t: INF field, followed by the CRC
  *
  * Returns          On success return TRUE or else FALSE.
  *
  ******************************************************************************/
-static bool_t phNxpEseProto7816_CheckCRC(uint32_t data_len, uint8_t *p_data)
+static bool_t phNxpEseProto7816_CheckCRC(uint32_t data_len, uint8_t *p_data, uint8_t *p_inf)
 {
     bool_t status     = FALSE;
     uint16_t calc_crc = 0;
     uint16_t recv_crc = 0;
+    uint32_t inf_len  = 0;
 
     ENSURE_OR_GO_EXIT(p_data != NULL);
+    ENSURE_OR_GO_EXIT(p_inf != NULL);
     ENSURE_OR_GO_EXIT(data_len < MAX_APDU_BUFFER);
     ENSURE_OR_GO_EXIT(data_len >= 2);
+    /* INF field and CRC may have been read to the response buffer */
+    ENSURE_OR_GO_EXIT((p_inf == &p_data[PH_PROPTO_7816_INF_BYTE_OFFSET]) || (data_len >= PH_PROTO_7816_INF_FILED));
 
     status = TRUE;
 
-    recv_crc = p_data[data_len - 2] << 8 | p_data[data_len - 1]; //combine 2 byte CRC
+    if (p_inf == &p_data[PH_PROPTO_7816_INF_BYTE_OFFSET]) {
+        recv_crc = p_data[data_len - 2] << 8 | p_data[data_len - 1]; //combine 2 byte CRC
 
-    /* calculate the CRC after excluding Recieved CRC  */
-    /* CRC calculation includes NAD byte, so offset is set to 0 */
-    calc_crc = phNxpEseProto7816_ComputeCRC(p_data, 0, (data_len - 2));
+        /* calculate the CRC after excluding Recieved CRC  */
+        /* CRC calculation includes NAD byte, so offset is set to 0 */
+        calc_crc = phNxpEseProto7816_ComputeCRC(p_data, 0, (data_len - 2));
+    }
+    else {
+        inf_len  = data_len - PH_PROTO_7816_INF_FILED;
+        recv_crc = p_inf[inf_len] << 8 | p_inf[inf_len + 1];
+        calc_crc = phNxpEseProto7816_ComputeFrameCRC(p_data, p_inf, inf_len);
+    }
     T_SMLOG_D("Received CRC:0x%x Calculated CRC:0x%x ", recv_crc, calc_crc);
     if (recv_crc != calc_crc) {
         status = FALSE;
@@ -208,14 +318,15 @@ uint8_t getMaxSupportedSendIFrameSize(void)
  ******************************************************************************/
 static bool_t phNxpEseProto7816_SendSFrame(void *conn_ctx, sFrameInfo_t sFrameData)
 {
-    bool_t status           = ESESTATUS_FAILED;
-    uint32_t frame_len      = 0;
-    uint8_t p_framebuff[7]  = {0};
-    uint8_t pcb_byte        = 0;
-    sFrameInfo_t sframeData = sFrameData;
-    uint16_t calc_crc       = 0;
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+    bool_t status                        = ESESTATUS_FAILED;
+    uint32_t frame_len                   = 0;
+    uint8_t p_framebuff[8]               = {0};
+    uint8_t pcb_byte                     = 0;
+    sFrameInfo_t sframeData              = sFrameData;
+    uint16_t calc_crc                    = 0;
     /* This update is helpful in-case a R-NACK is transmitted from the MW */
-    phNxpEseProto7816_3_Var.lastSentNonErrorframeType = SFRAME;
+    pProto7816_Cntx->lastSentNonErrorframeType = SFRAME;
     switch (sframeData.sFrameType) {
     case RESYNCH_REQ:
         frame_len                                    = (PH_PROTO_7816_HEADER_LEN + PH_PROTO_7816_CRC_LEN);
@@ -229,6 +340,22 @@ static bool_t phNxpEseProto7816_SendSFrame(void *conn_ctx, sFrameInfo_t sFrameDa
         pcb_byte |= PH_PROTO_7816_S_BLOCK_REQ; /* PCB */
         pcb_byte |= PH_PROTO_7816_S_RESYNCH;
         break;
+    case IFSC_REQ:
+        /* The host announces the largest INF field it can receive (IFSD) */
+        frame_len = (PH_PROTO_7816_HEADER_LEN + PH_PROTO_7816_IFS_LEN + PH_PROTO_7816_CRC_LEN);
+#if defined(T1oI2C_UM11225)
+        p_framebuff[PH_PROPTO_7816_LEN_UPPER_OFFSET] = PH_PROTO_7816_IFS_LEN;
+        p_framebuff[PH_PROPTO_7816_INF_BYTE_OFFSET]  = (uint8_t)PH_PROTO_7816_IFS_MAX;
+#elif defined(T1oI2C_GP1_0)
+        p_framebuff[PH_PROPTO_7816_LEN_UPPER_OFFSET]    = 0x00;
+        p_framebuff[PH_PROPTO_7816_LEN_LOWER_OFFSET]    = PH_PROTO_7816_IFS_LEN;
+        p_framebuff[PH_PROPTO_7816_INF_BYTE_OFFSET]     = (uint8_t)(PH_PROTO_7816_IFS_MAX >> 8);
+        p_framebuff[PH_PROPTO_7816_INF_BYTE_OFFSET + 1] = (uint8_t)(PH_PROTO_7816_IFS_MAX & 0xFF);
+#endif
+
+        pcb_byte |= PH_PROTO_7816_S_BLOCK_REQ; /* PCB */
+        pcb_byte |= PH_PROTO_7816_S_IFS;
+        break;
 #if defined(T1oI2C_UM11225)
     case INTF_RESET_REQ:
         frame_len                                    = (PH_PROTO_7816_HEADER_LEN + PH_PROTO_7816_CRC_LEN);
@@ -340,6 +467,30 @@ static bool_t phNxpEseProto7816_SendSFrame(void *conn_ctx, sFrameInfo_t sFrameDa
     p_framebuff[frame_len - 1] = calc_crc & 0xFF;
     T_SMLOG_D("S-Frame PCB: %x ", p_framebuff[PH_PROPTO_7816_PCB_OFFSET]);
     status = phNxpEseProto7816_SendRawFrame(conn_ctx, frame_len, p_framebuff);
+    if (TRUE == status) {
+        switch (sFrameData.sFrameType) {
+        case RESYNCH_REQ:
+            phNxpEse_getStatsCntx(conn_ctx)->resyncs++;
+            break;
+#if defined(T1oI2C_UM11225)
+        case INTF_RESET_REQ:
+            phNxpEse_getStatsCntx(conn_ctx)->intfResets++;
+            break;
+        case CHIP_RESET_REQ:
+            phNxpEse_getStatsCntx(conn_ctx)->chipResets++;
+            break;
+#elif defined(T1oI2C_GP1_0)
+        case SWR_REQ:
+            phNxpEse_getStatsCntx(conn_ctx)->intfResets++;
+            break;
+        case COLD_RESET_REQ:
+            phNxpEse_getStatsCntx(conn_ctx)->chipResets++;
+            break;
+#endif
+        default:
+            break;
+        }
+    }
     return status;
 }
 
@@ -356,15 +507,16 @@ static bool_t phNxpEseProto7816_SendSFrame(void *conn_ctx, sFrameInfo_t sFrameDa
  ******************************************************************************/
 static bool_t phNxpEseProto7816_sendRframe(void *conn_ctx, rFrameTypes_t rFrameType)
 {
-    bool_t status = FALSE;
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+    bool_t status                        = FALSE;
 #if defined(T1oI2C_UM11225)
     uint8_t recv_ack[5] = {0x5A, 0x80, 0x00, 0x00, 0x00};
 #elif defined(T1oI2C_GP1_0)
     uint8_t recv_ack[6] = {0x5A, 0x80, 0x00, 0x00, 0x00, 0x00};
 #endif
     uint16_t calc_crc                    = 0;
-    iFrameInfo_t *pRx_lastRcvdIframeInfo = &phNxpEseProto7816_3_Var.phNxpEseRx_Cntx.lastRcvdIframeInfo;
-    rFrameInfo_t *pNextTx_RframeInfo     = &phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.RframeInfo;
+    iFrameInfo_t *pRx_lastRcvdIframeInfo = &pProto7816_Cntx->phNxpEseRx_Cntx.lastRcvdIframeInfo;
+    rFrameInfo_t *pNextTx_RframeInfo     = &pProto7816_Cntx->phNxpEseNextTx_Cntx.RframeInfo;
     if (RNACK == rFrameType) /* R-NACK */
     {
         switch (pNextTx_RframeInfo->errCode) {
@@ -388,7 +540,7 @@ static bool_t phNxpEseProto7816_sendRframe(void *conn_ctx, rFrameTypes_t rFrameT
     else /* R-ACK*/
     {
         /* This update is helpful in-case a R-NACK is transmitted from the MW */
-        phNxpEseProto7816_3_Var.lastSentNonErrorframeType = RFRAME;
+        pProto7816_Cntx->lastSentNonErrorframeType = RFRAME;
     }
 
     recv_ack[PH_PROPTO_7816_PCB_OFFSET] |= ((pRx_lastRcvdIframeInfo->seqNo ^ 1) << 4);
@@ -398,6 +550,9 @@ static bool_t phNxpEseProto7816_sendRframe(void *conn_ctx, rFrameTypes_t rFrameT
     recv_ack[(sizeof(recv_ack) - 2)] = (calc_crc >> 8) & 0xFF;
     recv_ack[(sizeof(recv_ack) - 1)] = calc_crc & 0xFF;
     status                           = phNxpEseProto7816_SendRawFrame(conn_ctx, sizeof(recv_ack), recv_ack);
+    if ((TRUE == status) && (RNACK == rFrameType)) {
+        phNxpEse_getStatsCntx(conn_ctx)->rnacksSent++;
+    }
     return status;
 }
 
@@ -405,7 +560,11 @@ static bool_t phNxpEseProto7816_sendRframe(void *conn_ctx, rFrameTypes_t rFrameT
  * Function         phNxpEseProto7816_SendIframe
  *
  * Description      This internal function is called to send I-frame with all
- *                   updated 7816-3 headers
+ *                   updated 7816-3 headers. The INF field is not copied: the
+ *                   frame is built in place around it when the bytes before
+ *                   and after it can be borrowed (earlier / later data of the
+ *                   C-APDU or room reserved by the caller), else it is sent
+ *                   as header, INF and CRC pieces.
  *
  * param[in]        sFrameInfo_t: Info about I frame
  *
@@ -414,24 +573,37 @@ static bool_t phNxpEseProto7816_sendRframe(void *conn_ctx, rFrameTypes_t rFrameT
  ******************************************************************************/
 static bool_t phNxpEseProto7816_SendIframe(void *conn_ctx, iFrameInfo_t iFrameData)
 {
-    bool_t status      = FALSE;
-    uint32_t frame_len = 0;
-    uint8_t p_framebuff[MAX_APDU_BUFFER];
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+    phNxpEse_Context_t *nxpese_ctxt      = (conn_ctx == NULL) ? &gnxpese_ctxt : (phNxpEse_Context_t *)conn_ctx;
+    bool_t status                        = FALSE;
+    uint8_t header[PH_PROTO_7816_HEADER_LEN];
+    uint8_t crc[PH_PROTO_7816_CRC_LEN];
+    uint8_t savedHeader[PH_PROTO_7816_HEADER_LEN];
+    uint8_t savedCrc[PH_PROTO_7816_CRC_LEN];
+    phPalEse_IoVec_t iov[3];
+    uint8_t *p_inf                   = NULL;
+    uint32_t roomBefore              = 0;
+    uint32_t roomAfter               = 0;
     uint8_t pcb_byte                 = 0;
     uint16_t calc_crc                = 0;
-    iFrameInfo_t *pNextTx_IframeInfo = &phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.IframeInfo;
+    iFrameInfo_t *pNextTx_IframeInfo = &pProto7816_Cntx->phNxpEseNextTx_Cntx.IframeInfo;
 
     if (0 == iFrameData.sendDataLen) {
         T_SMLOG_E("%s Line: [%d] I frame Len is 0, INVALID ", __FUNCTION__, __LINE__);
         return FALSE;
     }
     /* This update is helpful in-case a R-NACK is transmitted from the MW */
-    phNxpEseProto7816_3_Var.lastSentNonErrorframeType = IFRAME;
-    ENSURE_OR_GO_EXIT(iFrameData.sendDataLen <= (UINT_MAX - (PH_PROTO_7816_HEADER_LEN + PH_PROTO_7816_CRC_LEN)))
-    frame_len = (iFrameData.sendDataLen + PH_PROTO_7816_HEADER_LEN + PH_PROTO_7816_CRC_LEN);
+    pProto7816_Cntx->lastSentNonErrorframeType = IFRAME;
+    ENSURE_OR_GO_EXIT(iFrameData.p_data != NULL)
+    if (pProto7816_Cntx->phNxpEseRx_Cntx.isCmdOverwritten) {
+        /* An invalid I-frame was received over the C-APDU, it cannot be retransmitted */
+        T_SMLOG_E("%s C-APDU overwritten by the response ", __FUNCTION__);
+        goto exit;
+    }
+    ENSURE_OR_GO_EXIT(iFrameData.sendDataLen <= (MAX_APDU_BUFFER - (PH_PROTO_7816_HEADER_LEN + PH_PROTO_7816_CRC_LEN)))
 
     /* frame the packet */
-    p_framebuff[PH_PROPTO_7816_NAD_OFFSET] = SEND_PACKET_SOF; /* NAD Byte */
+    header[PH_PROPTO_7816_NAD_OFFSET] = SEND_PACKET_SOF; /* NAD Byte */
 
     if (iFrameData.isChained) {
         /* make B6 (M) bit high */
@@ -442,29 +614,57 @@ static bool_t phNxpEseProto7816_SendIframe(void *conn_ctx, iFrameInfo_t iFrameDa
     pcb_byte |= (pNextTx_IframeInfo->seqNo << 6);
 
     /* store the pcb byte */
-    p_framebuff[PH_PROPTO_7816_PCB_OFFSET] = pcb_byte;
+    header[PH_PROPTO_7816_PCB_OFFSET] = pcb_byte;
 #if defined(T1oI2C_UM11225)
     /* store I frame length */
     /* for T1oI2C_UM11225 LEN field is of 1 byte*/
-    p_framebuff[PH_PROPTO_7816_LEN_UPPER_OFFSET] = iFrameData.sendDataLen;
+    header[PH_PROPTO_7816_LEN_UPPER_OFFSET] = iFrameData.sendDataLen;
 #elif defined(T1oI2C_GP1_0)
     /* store I frame length */
     /* for T1oI2C_GP1_0 LEN field is of 2 byte*/
-    p_framebuff[PH_PROPTO_7816_LEN_UPPER_OFFSET] = (((uint16_t)iFrameData.sendDataLen) >> 8 & 0xff);
-    p_framebuff[PH_PROPTO_7816_LEN_LOWER_OFFSET] = (((uint16_t)iFrameData.sendDataLen) & 0xff);
+    header[PH_PROPTO_7816_LEN_UPPER_OFFSET] = (((uint16_t)iFrameData.sendDataLen) >> 8 & 0xff);
+    header[PH_PROPTO_7816_LEN_LOWER_OFFSET] = (((uint16_t)iFrameData.sendDataLen) & 0xff);
 #endif
-    /* store I frame */
-    ENSURE_OR_GO_EXIT(iFrameData.sendDataLen <= (MAX_APDU_BUFFER - PH_PROPTO_7816_INF_BYTE_OFFSET))
-    ENSURE_OR_GO_EXIT(frame_len - 1 < MAX_APDU_BUFFER)
-
-    phNxpEse_memcpy(&(p_framebuff[PH_PROPTO_7816_INF_BYTE_OFFSET]),
-        iFrameData.p_data + iFrameData.dataOffset,
-        iFrameData.sendDataLen);
-    calc_crc = phNxpEseProto7816_ComputeCRC(p_framebuff, 0, (frame_len - 2));
-
-    p_framebuff[frame_len - 2] = (calc_crc >> 8) & 0xff;
-    p_framebuff[frame_len - 1] = calc_crc & 0xff;
-    status                     = phNxpEseProto7816_SendRawFrame(conn_ctx, frame_len, p_framebuff);
+    p_inf    = iFrameData.p_data + iFrameData.dataOffset;
+    calc_crc = phNxpEseProto7816_ComputeFrameCRC(header, p_inf, iFrameData.sendDataLen);
+    crc[0]   = (calc_crc >> 8) & 0xff;
+    crc[1]   = calc_crc & 0xff;
+
+    /* Earlier data of the C-APDU is already sent, later data is not sent yet */
+    roomBefore = iFrameData.dataOffset + nxpese_ctxt->txHeadroom;
+    roomAfter  = (iFrameData.isChained ? iFrameData.totalDataLen : 0) + nxpese_ctxt->txTailroom;
+
+    if ((roomBefore >= PH_PROTO_7816_HEADER_LEN) && (roomAfter >= PH_PROTO_7816_CRC_LEN)) {
+        phNxpEse_memcpy(savedHeader, p_inf - PH_PROTO_7816_HEADER_LEN, sizeof(savedHeader));
+        phNxpEse_memcpy(savedCrc, p_inf + iFrameData.sendDataLen, sizeof(savedCrc));
+        phNxpEse_memcpy(p_inf - PH_PROTO_7816_HEADER_LEN, header, sizeof(header));
+        phNxpEse_memcpy(p_inf + iFrameData.sendDataLen, crc, sizeof(crc));
+        status = phNxpEseProto7816_SendRawFrame(conn_ctx,
+            (iFrameData.sendDataLen + PH_PROTO_7816_HEADER_LEN + PH_PROTO_7816_CRC_LEN),
+            p_inf - PH_PROTO_7816_HEADER_LEN);
+        /* The C-APDU is left unchanged, it is needed for retransmission */
+        phNxpEse_memcpy(p_inf - PH_PROTO_7816_HEADER_LEN, savedHeader, sizeof(savedHeader));
+        phNxpEse_memcpy(p_inf + iFrameData.sendDataLen, savedCrc, sizeof(savedCrc));
+    }
+    else {
+        iov[0].pData = header;
+        iov[0].len   = sizeof(header);
+        iov[1].pData = p_inf;
+        iov[1].len   = iFrameData.sendDataLen;
+        iov[2].pData = crc;
+        iov[2].len   = sizeof(crc);
+        status       = (phNxpEse_WriteFrameV(conn_ctx, iov, 3) == ESESTATUS_SUCCESS) ? TRUE : FALSE;
+        if (FALSE == status) {
+            T_SMLOG_E("%s Error phNxpEse_WriteFrameV ", __FUNCTION__);
+        }
+        else {
+            phNxpEse_getStatsCntx(conn_ctx)->framesSent++;
+        }
+    }
+    if ((TRUE == status) && (!iFrameData.isChained)) {
+        /* Command complete, SE starts processing */
+        phNxpEse_startRspTimer(conn_ctx);
+    }
 
 exit:
     return status;
@@ -476,22 +676,24 @@ exit:
  * Description      This internal function is called to set the context for next I-frame.
  *                  Not applicable for the first I-frame of the transceive
  *
- * param[in]        void
+ * param[in]        void* conn_ctx
  *
  * Returns          Always return TRUE.
  *
  ******************************************************************************/
-static bool_t phNxpEseProto7816_SetFirstIframeContxt(void)
+static bool_t phNxpEseProto7816_SetFirstIframeContxt(void *conn_ctx)
 {
-    phNxpEseRx_Cntx_t *pRx_EseCntx   = &phNxpEseProto7816_3_Var.phNxpEseRx_Cntx;
-    iFrameInfo_t *pNextTx_IframeInfo = &phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.IframeInfo;
-    iFrameInfo_t *pLastTx_IframeInfo = &phNxpEseProto7816_3_Var.phNxpEseLastTx_Cntx.IframeInfo;
-
-    pNextTx_IframeInfo->dataOffset                                = 0;
-    phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = IFRAME;
-    pNextTx_IframeInfo->seqNo                                     = (uint8_t)(pLastTx_IframeInfo->seqNo ^ 1);
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = SEND_IFRAME;
-    pRx_EseCntx->responseBytesRcvd                                = 0;
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+    phNxpEseRx_Cntx_t *pRx_EseCntx       = &pProto7816_Cntx->phNxpEseRx_Cntx;
+    iFrameInfo_t *pNextTx_IframeInfo     = &pProto7816_Cntx->phNxpEseNextTx_Cntx.IframeInfo;
+    iFrameInfo_t *pLastTx_IframeInfo     = &pProto7816_Cntx->phNxpEseLastTx_Cntx.IframeInfo;
+
+    pNextTx_IframeInfo->dataOffset                         = 0;
+    pNextTx_IframeInfo->maxDataLen                         = pProto7816_Cntx->ifsc;
+    pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = IFRAME;
+    pNextTx_IframeInfo->seqNo                              = (uint8_t)(pLastTx_IframeInfo->seqNo ^ 1);
+    pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = SEND_IFRAME;
+    pRx_EseCntx->responseBytesRcvd                         = 0;
     if (pNextTx_IframeInfo->totalDataLen > pNextTx_IframeInfo->maxDataLen) {
         pNextTx_IframeInfo->isChained    = TRUE;
         pNextTx_IframeInfo->sendDataLen  = pNextTx_IframeInfo->maxDataLen;
@@ -511,19 +713,20 @@ static bool_t phNxpEseProto7816_SetFirstIframeContxt(void)
  * Description      This internal function is called to set the context for next I-frame.
  *                  Not applicable for the first I-frame of the transceive
  *
- * param[in]        void
+ * param[in]        void* conn_ctx
  *
  * Returns          Always return TRUE.
  *
  ******************************************************************************/
-static bool_t phNxpEseProto7816_SetNextIframeContxt(void)
+static bool_t phNxpEseProto7816_SetNextIframeContxt(void *conn_ctx)
 {
-    iFrameInfo_t *pNextTx_IframeInfo = &phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.IframeInfo;
-    iFrameInfo_t *pLastTx_IframeInfo = &phNxpEseProto7816_3_Var.phNxpEseLastTx_Cntx.IframeInfo;
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+    iFrameInfo_t *pNextTx_IframeInfo     = &pProto7816_Cntx->phNxpEseNextTx_Cntx.IframeInfo;
+    iFrameInfo_t *pLastTx_IframeInfo     = &pProto7816_Cntx->phNxpEseLastTx_Cntx.IframeInfo;
 
     /* Expecting to reach here only after first of chained I-frame is sent and before the last chained is sent */
-    phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = IFRAME;
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = SEND_IFRAME;
+    pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = IFRAME;
+    pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = SEND_IFRAME;
 
     pNextTx_IframeInfo->seqNo = (uint8_t)(pLastTx_IframeInfo->seqNo ^ 1);
     if ((UINT_MAX - pLastTx_IframeInfo->dataOffset) < pLastTx_IframeInfo->maxDataLen) {
@@ -553,15 +756,17 @@ static bool_t phNxpEseProto7816_SetNextIframeContxt(void)
  *
  * Description      This internal function is called to save recv frame data
  *
+ * param[in]        void* conn_ctx
  * param[in]        uint8_t: data buffer
  * param[in]        uint32_t: buffer length
  *
  * Returns          Always return TRUE.
  *
  ******************************************************************************/
-static bool_t phNxpEseProro7816_SaveRxframeData(uint8_t *p_data, uint32_t data_len)
+static bool_t phNxpEseProro7816_SaveRxframeData(void *conn_ctx, uint8_t *p_data, uint32_t data_len)
 {
-    phNxpEseRx_Cntx_t *pRx_EseCntx = &phNxpEseProto7816_3_Var.phNxpEseRx_Cntx;
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+    phNxpEseRx_Cntx_t *pRx_EseCntx       = &pProto7816_Cntx->phNxpEseRx_Cntx;
 
     if (p_data == NULL) {
         return FALSE;
@@ -584,7 +789,10 @@ static bool_t phNxpEseProro7816_SaveRxframeData(uint8_t *p_data, uint32_t data_l
             // LOG_W("Need '%ld' bytes. Got '%ld' to copy.", (size_t)(pRx_EseCntx->responseBytesRcvd + data_len), pRx_EseCntx->pRsp->len);
             return FALSE;
         }
-        phNxpEse_memcpy((pRx_EseCntx->pRsp->p_data + pRx_EseCntx->responseBytesRcvd), p_data, data_len);
+        /* Nothing to copy if the INF field was read straight to its position */
+        if (p_data != (pRx_EseCntx->pRsp->p_data + pRx_EseCntx->responseBytesRcvd)) {
+            phNxpEse_memcpy((pRx_EseCntx->pRsp->p_data + pRx_EseCntx->responseBytesRcvd), p_data, data_len);
+        }
         pRx_EseCntx->responseBytesRcvd += data_len;
         return TRUE;
     }
@@ -599,14 +807,15 @@ static bool_t phNxpEseProro7816_SaveRxframeData(uint8_t *p_data, uint32_t data_l
  *
  * Description      This internal function is called to do reset the recovery pareameters
  *
- * param[in]        void
+ * param[in]        void* conn_ctx
  *
  * Returns          Always return TRUE.
  *
  ******************************************************************************/
-static bool_t phNxpEseProto7816_ResetRecovery(void)
+static bool_t phNxpEseProto7816_ResetRecovery(void *conn_ctx)
 {
-    phNxpEseProto7816_3_Var.recoveryCounter = 0;
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+    pProto7816_Cntx->recoveryCounter     = 0;
     return TRUE;
 }
 
@@ -617,31 +826,32 @@ static bool_t phNxpEseProto7816_ResetRecovery(void)
  *                  after PH_PROTO_7816_FRAME_RETRY_COUNT, and the interface has to be
  *                  recovered
  *
- * param[in]        void
+ * param[in]        void* conn_ctx
  *
  * Returns          Always return TRUE.
  *
  ******************************************************************************/
-static bool_t phNxpEseProto7816_RecoverySteps(void)
+static bool_t phNxpEseProto7816_RecoverySteps(void *conn_ctx)
 {
-    sFrameInfo_t *pRx_lastRcvdSframeInfo = &phNxpEseProto7816_3_Var.phNxpEseRx_Cntx.lastRcvdSframeInfo;
-    sFrameInfo_t *pNextTx_SframeInfo     = &phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.SframeInfo;
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+    sFrameInfo_t *pRx_lastRcvdSframeInfo = &pProto7816_Cntx->phNxpEseRx_Cntx.lastRcvdSframeInfo;
+    sFrameInfo_t *pNextTx_SframeInfo     = &pProto7816_Cntx->phNxpEseNextTx_Cntx.SframeInfo;
 
-    if (phNxpEseProto7816_3_Var.recoveryCounter <= PH_PROTO_7816_FRAME_RETRY_COUNT) {
+    if (pProto7816_Cntx->recoveryCounter <= PH_PROTO_7816_FRAME_RETRY_COUNT) {
 #if defined(T1oI2C_UM11225)
-        pRx_lastRcvdSframeInfo->sFrameType                            = INTF_RESET_REQ;
-        phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = SFRAME;
-        pNextTx_SframeInfo->sFrameType                                = INTF_RESET_REQ;
-        phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = SEND_S_INTF_RST;
+        pRx_lastRcvdSframeInfo->sFrameType                     = INTF_RESET_REQ;
+        pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = SFRAME;
+        pNextTx_SframeInfo->sFrameType                         = INTF_RESET_REQ;
+        pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = SEND_S_INTF_RST;
 #elif defined(T1oI2C_GP1_0)
-        pRx_lastRcvdSframeInfo->sFrameType                            = SWR_REQ;
-        phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = SFRAME;
-        pNextTx_SframeInfo->sFrameType                                = SWR_REQ;
-        phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = SEND_S_SWR;
+        pRx_lastRcvdSframeInfo->sFrameType                     = SWR_REQ;
+        pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = SFRAME;
+        pNextTx_SframeInfo->sFrameType                         = SWR_REQ;
+        pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = SEND_S_SWR;
 #endif
     }
     else { /* If recovery fails */
-        phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
+        pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
     }
     return TRUE;
 }
@@ -677,6 +887,43 @@ exit:
     return;
 }
 
+/******************************************************************************
+ * Function         phNxpEseProto7816_RecordWtx
+ *
+ * Description      This internal function records an S(WTX) request of the ESE
+ *                  and derives the poll interval while the ESE works on it from
+ *                  the time the ESE took to send the request.
+ *
+ * param[in]        void* conn_ctx
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void phNxpEseProto7816_RecordWtx(void *conn_ctx)
+{
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+    uint64_t nowUs                       = sm_get_time_us();
+    uint64_t pollUs                      = 0;
+
+    if (pProto7816_Cntx->wtxCount == 0) {
+        pProto7816_Cntx->wtxFirstUs = nowUs;
+    }
+    if (pProto7816_Cntx->wtxCount < UINT32_MAX) {
+        pProto7816_Cntx->wtxCount++;
+    }
+    phNxpEse_getStatsCntx(conn_ctx)->wtxRequests++;
+    if (nowUs > pProto7816_Cntx->stepTxUs) {
+        pollUs = (nowUs - pProto7816_Cntx->stepTxUs) / PH_PROTO_7816_WTX_POLL_DIVIDER;
+    }
+    if (pollUs < PH_PROTO_7816_WTX_POLL_MIN_US) {
+        pollUs = PH_PROTO_7816_WTX_POLL_MIN_US;
+    }
+    if (pollUs > PH_PROTO_7816_WTX_POLL_MAX_US) {
+        pollUs = PH_PROTO_7816_WTX_POLL_MAX_US;
+    }
+    pProto7816_Cntx->wtxPollUs = (uint32_t)pollUs;
+}
+
 /******************************************************************************
  * Function         phNxpEseProto7816_DecodeFrame
  *
@@ -689,27 +936,32 @@ exit:
                        3.3 R-NACK: Re-send the last frame
                     4. If the received frame is S-frame, send back the correct S-frame response.
  *
+ * param[in]        void* conn_ctx
  * param[in]        uint8_t : data buffer
+ * param[in]        uint8_t : INF field of the frame
  * param[in]        uint32_t : buffer length
  *
  * Returns          On success return TRUE or else FALSE.
  *
  ******************************************************************************/
-static bool_t phNxpEseProto7816_DecodeFrame(uint8_t *p_data, uint32_t data_len)
+static bool_t phNxpEseProto7816_DecodeFrame(void *conn_ctx, uint8_t *p_data, uint8_t *p_inf, uint32_t data_len)
 {
-    bool_t status = TRUE;
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+    bool_t status                        = TRUE;
     uint8_t pcb;
-    iFrameInfo_t *pRx_lastRcvdIframeInfo = &phNxpEseProto7816_3_Var.phNxpEseRx_Cntx.lastRcvdIframeInfo;
-    rFrameInfo_t *pNextTx_RframeInfo     = &phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.RframeInfo;
-    sFrameInfo_t *pNextTx_SframeInfo     = &phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.SframeInfo;
-    iFrameInfo_t *pLastTx_IframeInfo     = &phNxpEseProto7816_3_Var.phNxpEseLastTx_Cntx.IframeInfo;
-    sFrameInfo_t *pLastTx_SframeInfo     = &phNxpEseProto7816_3_Var.phNxpEseLastTx_Cntx.SframeInfo;
-    rFrameInfo_t *pRx_lastRcvdRframeInfo = &phNxpEseProto7816_3_Var.phNxpEseRx_Cntx.lastRcvdRframeInfo;
-    sFrameInfo_t *pRx_lastRcvdSframeInfo = &phNxpEseProto7816_3_Var.phNxpEseRx_Cntx.lastRcvdSframeInfo;
+    iFrameInfo_t *pRx_lastRcvdIframeInfo = &pProto7816_Cntx->phNxpEseRx_Cntx.lastRcvdIframeInfo;
+    rFrameInfo_t *pNextTx_RframeInfo     = &pProto7816_Cntx->phNxpEseNextTx_Cntx.RframeInfo;
+    sFrameInfo_t *pNextTx_SframeInfo     = &pProto7816_Cntx->phNxpEseNextTx_Cntx.SframeInfo;
+    iFrameInfo_t *pLastTx_IframeInfo     = &pProto7816_Cntx->phNxpEseLastTx_Cntx.IframeInfo;
+    sFrameInfo_t *pLastTx_SframeInfo     = &pProto7816_Cntx->phNxpEseLastTx_Cntx.SframeInfo;
+    rFrameInfo_t *pRx_lastRcvdRframeInfo = &pProto7816_Cntx->phNxpEseRx_Cntx.lastRcvdRframeInfo;
+    sFrameInfo_t *pRx_lastRcvdSframeInfo = &pProto7816_Cntx->phNxpEseRx_Cntx.lastRcvdSframeInfo;
+    uint16_t ifsd                        = 0;
 
-    T_SMLOG_D("Retry Counter = %d ", phNxpEseProto7816_3_Var.recoveryCounter);
+    T_SMLOG_D("Retry Counter = %d ", pProto7816_Cntx->recoveryCounter);
 
     ENSURE_OR_GO_EXIT(p_data != NULL);
+    ENSURE_OR_GO_EXIT(p_inf != NULL);
     ENSURE_OR_GO_EXIT(data_len < MAX_APDU_BUFFER);
     ENSURE_OR_GO_EXIT(data_len >= PH_PROTO_7816_HEADER_LEN);
 
@@ -721,204 +973,221 @@ static bool_t phNxpEseProto7816_DecodeFrame(uint8_t *p_data, uint32_t data_len)
     if (!(pcb & 0x80)) /* I-FRAME decoded should come here */
     {
         T_SMLOG_D("%s I-Frame Received ", __FUNCTION__);
-        phNxpEseProto7816_3_Var.wtx_counter                       = 0;
-        phNxpEseProto7816_3_Var.phNxpEseRx_Cntx.lastRcvdFrameType = IFRAME;
+        pProto7816_Cntx->wtx_counter                       = 0;
+        pProto7816_Cntx->phNxpEseRx_Cntx.lastRcvdFrameType = IFRAME;
         if (pRx_lastRcvdIframeInfo->seqNo != ((pcb & 0x40) >> 6)) {
             T_SMLOG_D("%s I-Frame lastRcvdIframeInfo.seqNo:0x%x ", __FUNCTION__, ((pcb & 0x40) >> 6));
-            phNxpEseProto7816_ResetRecovery();
+            phNxpEseProto7816_ResetRecovery(conn_ctx);
             pRx_lastRcvdIframeInfo->seqNo = 0x00;
             pRx_lastRcvdIframeInfo->seqNo |= ((pcb & 0x40) >> 6);
 
             if (pcb & 0x20) {
-                pRx_lastRcvdIframeInfo->isChained                     = TRUE;
-                phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType = RFRAME;
-                pNextTx_RframeInfo->errCode                           = NO_ERROR;
-                if (FALSE == phNxpEseProro7816_SaveRxframeData(
-                                 &p_data[PH_PROPTO_7816_INF_BYTE_OFFSET], data_len - PH_PROTO_7816_INF_FILED)) {
-                    phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
+                pRx_lastRcvdIframeInfo->isChained              = TRUE;
+                pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType = RFRAME;
+                pNextTx_RframeInfo->errCode                    = NO_ERROR;
+                if (FALSE == phNxpEseProro7816_SaveRxframeData(conn_ctx, p_inf, data_len - PH_PROTO_7816_INF_FILED)) {
+                    pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
                     T_SMLOG_E("phNxpEseProro7816_SaveRxframeData Failed");
                     return FALSE;
                 }
-                phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = SEND_R_ACK;
+                pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = SEND_R_ACK;
             }
             else {
-                pRx_lastRcvdIframeInfo->isChained                             = FALSE;
-                phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
-                if (FALSE == phNxpEseProro7816_SaveRxframeData(
-                                 &p_data[PH_PROPTO_7816_INF_BYTE_OFFSET], data_len - PH_PROTO_7816_INF_FILED)) {
+                pRx_lastRcvdIframeInfo->isChained                      = FALSE;
+                pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
+                if (FALSE == phNxpEseProro7816_SaveRxframeData(conn_ctx, p_inf, data_len - PH_PROTO_7816_INF_FILED)) {
                     T_SMLOG_E("phNxpEseProro7816_SaveRxframeData Failed");
                     return FALSE;
                 }
             }
         }
         else {
-            sm_sleep(DELAY_ERROR_RECOVERY / 1000);
-            if (phNxpEseProto7816_3_Var.recoveryCounter < PH_PROTO_7816_FRAME_RETRY_COUNT) {
-                phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = RFRAME;
-                pNextTx_RframeInfo->errCode                                   = OTHER_ERROR;
-                phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = SEND_R_NACK;
-                phNxpEseProto7816_3_Var.recoveryCounter++;
+            pProto7816_Cntx->stepDelayUs = DELAY_ERROR_RECOVERY;
+            if (pProto7816_Cntx->recoveryCounter < PH_PROTO_7816_FRAME_RETRY_COUNT) {
+                pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = RFRAME;
+                pNextTx_RframeInfo->errCode                            = OTHER_ERROR;
+                pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = SEND_R_NACK;
+                pProto7816_Cntx->recoveryCounter++;
             }
             else {
-                phNxpEseProto7816_RecoverySteps();
-                phNxpEseProto7816_3_Var.recoveryCounter++;
+                phNxpEseProto7816_RecoverySteps(conn_ctx);
+                pProto7816_Cntx->recoveryCounter++;
             }
         }
     }
     else if ((pcb & 0x80) && (!(0x40 & pcb))) /* R-FRAME decoded should come here */
     {
         T_SMLOG_D("%s R-Frame Received", __FUNCTION__);
-        phNxpEseProto7816_3_Var.wtx_counter                       = 0;
-        phNxpEseProto7816_3_Var.phNxpEseRx_Cntx.lastRcvdFrameType = RFRAME;
-        pRx_lastRcvdRframeInfo->seqNo                             = 0; // = 0;
+        pProto7816_Cntx->wtx_counter                       = 0;
+        pProto7816_Cntx->phNxpEseRx_Cntx.lastRcvdFrameType = RFRAME;
+        pRx_lastRcvdRframeInfo->seqNo                      = 0; // = 0;
         pRx_lastRcvdRframeInfo->seqNo |= ((pcb & 0x10) >> 4);
 
         if ((!(pcb & 0x01)) && (!(pcb & 0x02))) {
             pRx_lastRcvdRframeInfo->errCode = NO_ERROR;
-            phNxpEseProto7816_ResetRecovery();
+            phNxpEseProto7816_ResetRecovery(conn_ctx);
             if (pRx_lastRcvdRframeInfo->seqNo != pLastTx_IframeInfo->seqNo) {
-                phNxpEseProto7816_SetNextIframeContxt();
-                phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = SEND_IFRAME;
+                phNxpEseProto7816_SetNextIframeContxt(conn_ctx);
+                pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = SEND_IFRAME;
             }
 
         } /* Error handling 1 : Parity error */
         else if (((pcb & 0x01) && (!(pcb & 0x02))) ||
                  /* Error handling 2: Other indicated error */
                  ((!(pcb & 0x01)) && (pcb & 0x02))) {
-            sm_sleep(DELAY_ERROR_RECOVERY / 1000);
+            pProto7816_Cntx->stepDelayUs = DELAY_ERROR_RECOVERY;
+            phNxpEse_getStatsCntx(conn_ctx)->rnacksReceived++;
             if ((!(pcb & 0x01)) && (pcb & 0x02)) {
                 pRx_lastRcvdRframeInfo->errCode = OTHER_ERROR;
             }
             else {
                 pRx_lastRcvdRframeInfo->errCode = PARITY_ERROR;
             }
-            if (phNxpEseProto7816_3_Var.recoveryCounter < PH_PROTO_7816_FRAME_RETRY_COUNT) {
-                if (phNxpEseProto7816_3_Var.phNxpEseLastTx_Cntx.FrameType == IFRAME) {
-                    phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx = phNxpEseProto7816_3_Var.phNxpEseLastTx_Cntx;
-                    phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = SEND_IFRAME;
-                    phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = IFRAME;
+            if (pProto7816_Cntx->recoveryCounter < PH_PROTO_7816_FRAME_RETRY_COUNT) {
+                if (pProto7816_Cntx->phNxpEseLastTx_Cntx.FrameType == IFRAME) {
+                    pProto7816_Cntx->phNxpEseNextTx_Cntx                   = pProto7816_Cntx->phNxpEseLastTx_Cntx;
+                    pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = SEND_IFRAME;
+                    pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = IFRAME;
+                    phNxpEse_getStatsCntx(conn_ctx)->retransmits++;
                 }
-                else if (phNxpEseProto7816_3_Var.phNxpEseLastTx_Cntx.FrameType == RFRAME) {
+                else if (pProto7816_Cntx->phNxpEseLastTx_Cntx.FrameType == RFRAME) {
                     /* Usecase to reach the below case:
                     I-frame sent first, followed by R-NACK and we receive a R-NACK with
                     last sent I-frame sequence number*/
                     if ((pRx_lastRcvdRframeInfo->seqNo == pLastTx_IframeInfo->seqNo) &&
-                        (phNxpEseProto7816_3_Var.lastSentNonErrorframeType == IFRAME)) {
-                        phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx = phNxpEseProto7816_3_Var.phNxpEseLastTx_Cntx;
-                        phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = SEND_IFRAME;
-                        phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = IFRAME;
+                        (pProto7816_Cntx->lastSentNonErrorframeType == IFRAME)) {
+                        pProto7816_Cntx->phNxpEseNextTx_Cntx                   = pProto7816_Cntx->phNxpEseLastTx_Cntx;
+                        pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = SEND_IFRAME;
+                        pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = IFRAME;
+                        phNxpEse_getStatsCntx(conn_ctx)->retransmits++;
                     }
                     /* Usecase to reach the below case:
                     R-frame sent first, followed by R-NACK and we receive a R-NACK with
                     next expected I-frame sequence number*/
                     else if ((pRx_lastRcvdRframeInfo->seqNo != pLastTx_IframeInfo->seqNo) &&
-                             (phNxpEseProto7816_3_Var.lastSentNonErrorframeType == RFRAME)) {
-                        phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = RFRAME;
-                        pNextTx_RframeInfo->errCode                                   = NO_ERROR;
-                        phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = SEND_R_ACK;
+                             (pProto7816_Cntx->lastSentNonErrorframeType == RFRAME)) {
+                        pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = RFRAME;
+                        pNextTx_RframeInfo->errCode                            = NO_ERROR;
+                        pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = SEND_R_ACK;
                     }
                     /* Usecase to reach the below case:
                     I-frame sent first, followed by R-NACK and we receive a R-NACK with
                     next expected I-frame sequence number + all the other unexpected scenarios */
                     else {
-                        phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = RFRAME;
-                        pNextTx_RframeInfo->errCode                                   = OTHER_ERROR;
-                        phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = SEND_R_NACK;
+                        pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = RFRAME;
+                        pNextTx_RframeInfo->errCode                            = OTHER_ERROR;
+                        pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = SEND_R_NACK;
                     }
                 }
-                else if (phNxpEseProto7816_3_Var.phNxpEseLastTx_Cntx.FrameType == SFRAME) {
+                else if (pProto7816_Cntx->phNxpEseLastTx_Cntx.FrameType == SFRAME) {
                     /* Copy the last S frame sent */
-                    phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx = phNxpEseProto7816_3_Var.phNxpEseLastTx_Cntx;
+                    pProto7816_Cntx->phNxpEseNextTx_Cntx = pProto7816_Cntx->phNxpEseLastTx_Cntx;
+                    phNxpEse_getStatsCntx(conn_ctx)->retransmits++;
                 }
-                phNxpEseProto7816_3_Var.recoveryCounter++;
+                pProto7816_Cntx->recoveryCounter++;
             }
             else {
-                phNxpEseProto7816_RecoverySteps();
-                phNxpEseProto7816_3_Var.recoveryCounter++;
+                phNxpEseProto7816_RecoverySteps(conn_ctx);
+                pProto7816_Cntx->recoveryCounter++;
             }
             //resend previously send I frame
         }
         /* Error handling 3 */
         else if ((pcb & 0x01) && (pcb & 0x02)) {
-            sm_sleep(DELAY_ERROR_RECOVERY / 1000);
-            if (phNxpEseProto7816_3_Var.recoveryCounter < PH_PROTO_7816_FRAME_RETRY_COUNT) {
-                pRx_lastRcvdRframeInfo->errCode             = SOF_MISSED_ERROR;
-                phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx = phNxpEseProto7816_3_Var.phNxpEseLastTx_Cntx;
-                phNxpEseProto7816_3_Var.recoveryCounter++;
+            pProto7816_Cntx->stepDelayUs = DELAY_ERROR_RECOVERY;
+            phNxpEse_getStatsCntx(conn_ctx)->rnacksReceived++;
+            if (pProto7816_Cntx->recoveryCounter < PH_PROTO_7816_FRAME_RETRY_COUNT) {
+                pRx_lastRcvdRframeInfo->errCode      = SOF_MISSED_ERROR;
+                pProto7816_Cntx->phNxpEseNextTx_Cntx = pProto7816_Cntx->phNxpEseLastTx_Cntx;
+                phNxpEse_getStatsCntx(conn_ctx)->retransmits++;
+                pProto7816_Cntx->recoveryCounter++;
             }
             else {
-                phNxpEseProto7816_RecoverySteps();
-                phNxpEseProto7816_3_Var.recoveryCounter++;
+                phNxpEseProto7816_RecoverySteps(conn_ctx);
+                pProto7816_Cntx->recoveryCounter++;
             }
         }
     }
     else if ((0x80 & pcb) && (0x40 & pcb)) /* S-FRAME decoded should come here */
     {
         T_SMLOG_D("%s S-Frame Received ", __FUNCTION__);
-        int32_t frameType                                         = (int32_t)(pcb & 0x3F); /*discard upper 2 bits */
-        phNxpEseProto7816_3_Var.phNxpEseRx_Cntx.lastRcvdFrameType = SFRAME;
+        int32_t frameType                                  = (int32_t)(pcb & 0x3F); /*discard upper 2 bits */
+        pProto7816_Cntx->phNxpEseRx_Cntx.lastRcvdFrameType = SFRAME;
         if (frameType != WTX_REQ) {
-            phNxpEseProto7816_3_Var.wtx_counter = 0;
+            pProto7816_Cntx->wtx_counter = 0;
         }
         switch (frameType) {
         case RESYNCH_RSP:
-            pRx_lastRcvdSframeInfo->sFrameType                            = RESYNCH_RSP;
-            phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = UNKNOWN;
-            phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
+            pRx_lastRcvdSframeInfo->sFrameType                     = RESYNCH_RSP;
+            pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = UNKNOWN;
+            pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
             break;
         case IFSC_RES:
-            pRx_lastRcvdSframeInfo->sFrameType                            = IFSC_RES;
-            phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = UNKNOWN;
-            phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
+            /* The ESE echoes the IFSD it accepts */
+            if (data_len >= (PH_PROTO_7816_INF_FILED + PH_PROTO_7816_IFS_LEN)) {
+#if defined(T1oI2C_UM11225)
+                ifsd = p_inf[0];
+#elif defined(T1oI2C_GP1_0)
+                ifsd = (uint16_t)((p_inf[0] << 8) | p_inf[1]);
+#endif
+            }
+            if ((ifsd > 0) && (ifsd <= PH_PROTO_7816_IFS_MAX)) {
+                pProto7816_Cntx->ifsd = ifsd;
+            }
+            pRx_lastRcvdSframeInfo->sFrameType                     = IFSC_RES;
+            pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = UNKNOWN;
+            pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
             break;
         case ABORT_RES:
-            pRx_lastRcvdSframeInfo->sFrameType                            = ABORT_RES;
-            phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = UNKNOWN;
-            phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
+            pRx_lastRcvdSframeInfo->sFrameType                     = ABORT_RES;
+            pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = UNKNOWN;
+            pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
             break;
         case WTX_REQ:
-            phNxpEseProto7816_3_Var.wtx_counter++;
-            T_SMLOG_D("%s Wtx_counter value - %lu ", __FUNCTION__, phNxpEseProto7816_3_Var.wtx_counter);
+            pProto7816_Cntx->wtx_counter++;
+            phNxpEseProto7816_RecordWtx(conn_ctx);
+            T_SMLOG_D("%s Wtx_counter value - %lu ", __FUNCTION__, pProto7816_Cntx->wtx_counter);
             T_SMLOG_D(
-                "%s Wtx_counter wtx_counter_limit - %lu ", __FUNCTION__, phNxpEseProto7816_3_Var.wtx_counter_limit);
+                "%s Wtx_counter wtx_counter_limit - %lu ", __FUNCTION__, pProto7816_Cntx->wtx_counter_limit);
             /* Previous sent frame is some S-frame but not WTX response S-frame */
             if (pLastTx_SframeInfo->sFrameType != WTX_RSP &&
-                phNxpEseProto7816_3_Var.phNxpEseLastTx_Cntx.FrameType ==
+                pProto7816_Cntx->phNxpEseLastTx_Cntx.FrameType ==
                     SFRAME) { /* Goto recovery if it keep coming here for more than recovery counter max. value */
-                if (phNxpEseProto7816_3_Var.recoveryCounter <
+                if (pProto7816_Cntx->recoveryCounter <
                     PH_PROTO_7816_FRAME_RETRY_COUNT) { /* Re-transmitting the previous sent S-frame */
-                    phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx = phNxpEseProto7816_3_Var.phNxpEseLastTx_Cntx;
-                    phNxpEseProto7816_3_Var.recoveryCounter++;
+                    pProto7816_Cntx->phNxpEseNextTx_Cntx = pProto7816_Cntx->phNxpEseLastTx_Cntx;
+                    phNxpEse_getStatsCntx(conn_ctx)->retransmits++;
+                    pProto7816_Cntx->recoveryCounter++;
                 }
                 else {
-                    phNxpEseProto7816_RecoverySteps();
-                    phNxpEseProto7816_3_Var.recoveryCounter++;
+                    phNxpEseProto7816_RecoverySteps(conn_ctx);
+                    pProto7816_Cntx->recoveryCounter++;
                 }
             }
             else { /* Checking for WTX counter with max. allowed WTX count */
-                if (phNxpEseProto7816_3_Var.wtx_counter == phNxpEseProto7816_3_Var.wtx_counter_limit) {
+                if (pProto7816_Cntx->wtx_counter == pProto7816_Cntx->wtx_counter_limit) {
 #if defined(T1oI2C_UM11225)
-                    phNxpEseProto7816_3_Var.wtx_counter                           = 0;
-                    pRx_lastRcvdSframeInfo->sFrameType                            = INTF_RESET_REQ;
-                    phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = SFRAME;
-                    pNextTx_SframeInfo->sFrameType                                = INTF_RESET_REQ;
-                    phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = SEND_S_INTF_RST;
+                    pProto7816_Cntx->wtx_counter                           = 0;
+                    pRx_lastRcvdSframeInfo->sFrameType                     = INTF_RESET_REQ;
+                    pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = SFRAME;
+                    pNextTx_SframeInfo->sFrameType                         = INTF_RESET_REQ;
+                    pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = SEND_S_INTF_RST;
                     T_SMLOG_E("%s Interface Reset to eSE wtx count reached!!! ", __FUNCTION__);
 #elif defined(T1oI2C_GP1_0)
-                    phNxpEseProto7816_3_Var.wtx_counter                           = 0;
-                    pRx_lastRcvdSframeInfo->sFrameType                            = SWR_REQ;
-                    phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = SFRAME;
-                    pNextTx_SframeInfo->sFrameType                                = SWR_REQ;
-                    phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = SEND_S_SWR;
+                    pProto7816_Cntx->wtx_counter                           = 0;
+                    pRx_lastRcvdSframeInfo->sFrameType                     = SWR_REQ;
+                    pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = SFRAME;
+                    pNextTx_SframeInfo->sFrameType                         = SWR_REQ;
+                    pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = SEND_S_SWR;
                     T_SMLOG_E("%s Software Reset to eSE wtx count reached!!! ", __FUNCTION__);
 #endif
                 }
                 else {
-                    sm_sleep(DELAY_ERROR_RECOVERY / 1000);
-                    pRx_lastRcvdSframeInfo->sFrameType                            = WTX_REQ;
-                    phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = SFRAME;
-                    pNextTx_SframeInfo->sFrameType                                = WTX_RSP;
-                    phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = SEND_S_WTX_RSP;
+                    pProto7816_Cntx->stepDelayUs                           = DELAY_ERROR_RECOVERY;
+                    pRx_lastRcvdSframeInfo->sFrameType                     = WTX_REQ;
+                    pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = SFRAME;
+                    pNextTx_SframeInfo->sFrameType                         = WTX_RSP;
+                    pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = SEND_S_WTX_RSP;
                 }
             }
             break;
@@ -930,23 +1199,23 @@ static bool_t phNxpEseProto7816_DecodeFrame(uint8_t *p_data, uint32_t data_len)
             if (data_len < PH_PROTO_7816_INF_FILED) {
                 return FALSE;
             }
-            if (FALSE == phNxpEseProro7816_SaveRxframeData(
+            if (FALSE == phNxpEseProro7816_SaveRxframeData(conn_ctx,
                              &p_data[PH_PROPTO_7816_INF_BYTE_OFFSET], data_len - PH_PROTO_7816_INF_FILED)) {
-                phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
+                pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
                 T_SMLOG_E("phNxpEseProro7816_SaveRxframeData Failed");
                 return FALSE;
             }
-            if (phNxpEseProto7816_3_Var.recoveryCounter > PH_PROTO_7816_FRAME_RETRY_COUNT) {
+            if (pProto7816_Cntx->recoveryCounter > PH_PROTO_7816_FRAME_RETRY_COUNT) {
                 /*Max recovery counter reached, send failure to APDU layer  */
                 T_SMLOG_E("%s Max retry count reached!!! ", __FUNCTION__);
-                phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
-                status                                                        = FALSE;
+                pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
+                status                                                 = FALSE;
             }
             else {
-                phNxpEseProto7816_ResetProtoParams();
-                pRx_lastRcvdSframeInfo->sFrameType                            = INTF_RESET_RSP;
-                phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = UNKNOWN;
-                phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
+                phNxpEseProto7816_ResetProtoParams(conn_ctx);
+                pRx_lastRcvdSframeInfo->sFrameType                     = INTF_RESET_RSP;
+                pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = UNKNOWN;
+                pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
             }
             break;
         case PROP_END_APDU_RSP:
@@ -954,30 +1223,30 @@ static bool_t phNxpEseProto7816_DecodeFrame(uint8_t *p_data, uint32_t data_len)
             if (p_data[PH_PROPTO_7816_FRAME_LENGTH_OFFSET] > 0) {
                 phNxpEseProto7816_DecodeSFrameData(p_data);
             }
-            phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = UNKNOWN;
-            phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
+            pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = UNKNOWN;
+            pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
             break;
         case ATR_RES:
             pRx_lastRcvdSframeInfo->sFrameType = ATR_RES;
             if (p_data[PH_PROPTO_7816_FRAME_LENGTH_OFFSET] > 0) {
                 phNxpEseProto7816_DecodeSFrameData(p_data);
             }
-            if (FALSE == phNxpEseProro7816_SaveRxframeData(
+            if (FALSE == phNxpEseProro7816_SaveRxframeData(conn_ctx,
                              &p_data[PH_PROPTO_7816_INF_BYTE_OFFSET], data_len - PH_PROTO_7816_INF_FILED)) {
-                phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
+                pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
                 T_SMLOG_E("phNxpEseProro7816_SaveRxframeData Failed");
                 return FALSE;
             }
-            phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = UNKNOWN;
-            phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
+            pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = UNKNOWN;
+            pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
             break;
         case CHIP_RESET_RES:
             pRx_lastRcvdSframeInfo->sFrameType = CHIP_RESET_RES;
             if (p_data[PH_PROPTO_7816_FRAME_LENGTH_OFFSET] > 0) {
                 phNxpEseProto7816_DecodeSFrameData(p_data);
             }
-            phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = UNKNOWN;
-            phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
+            pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = UNKNOWN;
+            pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
             break;
 #endif
 #if defined(T1oI2C_GP1_0)
@@ -985,17 +1254,17 @@ static bool_t phNxpEseProto7816_DecodeFrame(uint8_t *p_data, uint32_t data_len)
             if (p_data[PH_PROPTO_7816_FRAME_LENGTH_OFFSET] > 0) {
                 phNxpEseProto7816_DecodeSFrameData(p_data);
             }
-            if (phNxpEseProto7816_3_Var.recoveryCounter > PH_PROTO_7816_FRAME_RETRY_COUNT) {
+            if (pProto7816_Cntx->recoveryCounter > PH_PROTO_7816_FRAME_RETRY_COUNT) {
                 /*Max recovery counter reached, send failure to APDU layer  */
                 T_SMLOG_E("%s Max retry count reached!!! ", __FUNCTION__);
-                phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
-                status                                                        = FALSE;
+                pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
+                status                                                 = FALSE;
             }
             else {
-                phNxpEseProto7816_ResetProtoParams();
-                pRx_lastRcvdSframeInfo->sFrameType                            = SWR_RSP;
-                phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = UNKNOWN;
-                phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
+                phNxpEseProto7816_ResetProtoParams(conn_ctx);
+                pRx_lastRcvdSframeInfo->sFrameType                     = SWR_RSP;
+                pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = UNKNOWN;
+                pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
             }
             break;
         case RELEASE_RES:
@@ -1003,30 +1272,30 @@ static bool_t phNxpEseProto7816_DecodeFrame(uint8_t *p_data, uint32_t data_len)
             if (p_data[PH_PROPTO_7816_FRAME_LENGTH_OFFSET] > 0) {
                 phNxpEseProto7816_DecodeSFrameData(p_data);
             }
-            phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = UNKNOWN;
-            phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
+            pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = UNKNOWN;
+            pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
             break;
         case CIP_RES:
             pRx_lastRcvdSframeInfo->sFrameType = CIP_RES;
             if (p_data[PH_PROPTO_7816_FRAME_LENGTH_OFFSET] > 0) {
                 phNxpEseProto7816_DecodeSFrameData(p_data);
             }
-            if (FALSE == phNxpEseProro7816_SaveRxframeData(
+            if (FALSE == phNxpEseProro7816_SaveRxframeData(conn_ctx,
                              &p_data[PH_PROPTO_7816_INF_BYTE_OFFSET], data_len - PH_PROTO_7816_INF_FILED)) {
-                phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
+                pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
                 T_SMLOG_E("phNxpEseProro7816_SaveRxframeData Failed");
                 return FALSE;
             }
-            phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = UNKNOWN;
-            phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
+            pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = UNKNOWN;
+            pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
             break;
         case COLD_RESET_RES:
             pRx_lastRcvdSframeInfo->sFrameType = COLD_RESET_RES;
             if (p_data[PH_PROPTO_7816_FRAME_LENGTH_OFFSET] > 0) {
                 phNxpEseProto7816_DecodeSFrameData(p_data);
             }
-            phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = UNKNOWN;
-            phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
+            pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = UNKNOWN;
+            pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
             break;
 #endif
         case DEEP_PWR_DOWN_RES:
@@ -1034,8 +1303,8 @@ static bool_t phNxpEseProto7816_DecodeFrame(uint8_t *p_data, uint32_t data_len)
             if (p_data[PH_PROPTO_7816_FRAME_LENGTH_OFFSET] > 0) {
                 phNxpEseProto7816_DecodeSFrameData(p_data);
             }
-            phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = UNKNOWN;
-            phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
+            pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = UNKNOWN;
+            pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
             break;
         default:
             T_SMLOG_E("%s Wrong S-Frame Received ", __FUNCTION__);
@@ -1055,105 +1324,112 @@ exit:
  * Description      This internal function is used to
  *                  1. Check the CRC
  *                  2. Initiate decoding of received frame of data.
+ *                  3. Start the recovery if no frame could be read.
  *
- * param[in]        void
+ * param[in]        void* conn_ctx
+ * param[in]        bool_t : TRUE if a frame was read
+ * param[in]        uint32_t : length of the frame
+ * param[in]        uint8_t : frame read
+ * param[in]        uint8_t : INF field of the frame
  *
  * Returns          On success return TRUE or else FALSE.
  *
  ******************************************************************************/
-static bool_t phNxpEseProto7816_ProcessResponse(void *conn_ctx)
+static bool_t phNxpEseProto7816_ProcessResponse(
+    void *conn_ctx, bool_t isFrameRead, uint32_t data_len, uint8_t *p_data, uint8_t *p_inf)
 {
-    uint32_t data_len                    = 0;
-    uint8_t *p_data                      = NULL;
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
     bool_t status                        = FALSE;
     bool_t checkCrcPass                  = TRUE;
-    iFrameInfo_t *pRx_lastRcvdIframeInfo = &phNxpEseProto7816_3_Var.phNxpEseRx_Cntx.lastRcvdIframeInfo;
-    rFrameInfo_t *pNextTx_RframeInfo     = &phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.RframeInfo;
-    sFrameInfo_t *pLastTx_SframeInfo     = &phNxpEseProto7816_3_Var.phNxpEseLastTx_Cntx.SframeInfo;
+    iFrameInfo_t *pRx_lastRcvdIframeInfo = &pProto7816_Cntx->phNxpEseRx_Cntx.lastRcvdIframeInfo;
+    rFrameInfo_t *pNextTx_RframeInfo     = &pProto7816_Cntx->phNxpEseNextTx_Cntx.RframeInfo;
+    sFrameInfo_t *pLastTx_SframeInfo     = &pProto7816_Cntx->phNxpEseLastTx_Cntx.SframeInfo;
 
-    status = phNxpEseProto7816_GetRawFrame(conn_ctx, &data_len, &p_data);
+    status = isFrameRead;
     if (TRUE == status) {
         /* Resetting the timeout counter */
-        phNxpEseProto7816_3_Var.timeoutCounter = PH_PROTO_7816_VALUE_ZERO;
+        pProto7816_Cntx->timeoutCounter = PH_PROTO_7816_VALUE_ZERO;
         /* CRC check followed */
-        checkCrcPass = phNxpEseProto7816_CheckCRC(data_len, p_data);
+        checkCrcPass = phNxpEseProto7816_CheckCRC(data_len, p_data, p_inf);
         if (checkCrcPass == TRUE) {
             /* Resetting the RNACK retry counter */
-            phNxpEseProto7816_3_Var.rnack_retry_counter = PH_PROTO_7816_VALUE_ZERO;
-            status                                      = phNxpEseProto7816_DecodeFrame(p_data, data_len);
+            pProto7816_Cntx->rnack_retry_counter = PH_PROTO_7816_VALUE_ZERO;
+            status                               = phNxpEseProto7816_DecodeFrame(conn_ctx, p_data, p_inf, data_len);
         }
         else {
             T_SMLOG_E("%s CRC Check failed ", __FUNCTION__);
-            if (phNxpEseProto7816_3_Var.rnack_retry_counter < phNxpEseProto7816_3_Var.rnack_retry_limit) {
-                phNxpEseProto7816_3_Var.phNxpEseRx_Cntx.lastRcvdFrameType     = INVALID;
-                phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = RFRAME;
-                pNextTx_RframeInfo->errCode                                   = PARITY_ERROR;
-                pNextTx_RframeInfo->seqNo                                     = (!pRx_lastRcvdIframeInfo->seqNo) << 4;
-                phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = SEND_R_NACK;
-                phNxpEseProto7816_3_Var.rnack_retry_counter++;
+            phNxpEse_getStatsCntx(conn_ctx)->crcErrors++;
+            if (pProto7816_Cntx->rnack_retry_counter < pProto7816_Cntx->rnack_retry_limit) {
+                pProto7816_Cntx->phNxpEseRx_Cntx.lastRcvdFrameType     = INVALID;
+                pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = RFRAME;
+                pNextTx_RframeInfo->errCode                            = PARITY_ERROR;
+                pNextTx_RframeInfo->seqNo                              = (!pRx_lastRcvdIframeInfo->seqNo) << 4;
+                pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = SEND_R_NACK;
+                pProto7816_Cntx->rnack_retry_counter++;
             }
             else {
-                phNxpEseProto7816_3_Var.rnack_retry_counter = PH_PROTO_7816_VALUE_ZERO;
+                pProto7816_Cntx->rnack_retry_counter = PH_PROTO_7816_VALUE_ZERO;
                 /* Re-transmission failed completely, Going to exit */
-                phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
-                phNxpEseProto7816_3_Var.timeoutCounter                        = PH_PROTO_7816_VALUE_ZERO;
-                status                                                        = FALSE;
+                pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
+                pProto7816_Cntx->timeoutCounter                        = PH_PROTO_7816_VALUE_ZERO;
+                status                                                 = FALSE;
             }
         }
     }
     else {
         T_SMLOG_E("%s phNxpEseProto7816_GetRawFrame failed starting recovery", __FUNCTION__);
-        if ((SFRAME == phNxpEseProto7816_3_Var.phNxpEseLastTx_Cntx.FrameType) &&
+        if ((SFRAME == pProto7816_Cntx->phNxpEseLastTx_Cntx.FrameType) &&
             ((WTX_RSP == pLastTx_SframeInfo->sFrameType) || (RESYNCH_RSP == pLastTx_SframeInfo->sFrameType))) {
-            if (phNxpEseProto7816_3_Var.rnack_retry_counter < phNxpEseProto7816_3_Var.rnack_retry_limit) {
+            if (pProto7816_Cntx->rnack_retry_counter < pProto7816_Cntx->rnack_retry_limit) {
                 phNxpEse_clearReadBuffer(conn_ctx);
-                phNxpEseProto7816_3_Var.phNxpEseRx_Cntx.lastRcvdFrameType     = INVALID;
-                phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = RFRAME;
-                pNextTx_RframeInfo->errCode                                   = OTHER_ERROR;
-                pNextTx_RframeInfo->seqNo                                     = (!pRx_lastRcvdIframeInfo->seqNo) << 4;
-                phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = SEND_R_NACK;
-                phNxpEseProto7816_3_Var.rnack_retry_counter++;
+                pProto7816_Cntx->phNxpEseRx_Cntx.lastRcvdFrameType     = INVALID;
+                pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = RFRAME;
+                pNextTx_RframeInfo->errCode                            = OTHER_ERROR;
+                pNextTx_RframeInfo->seqNo                              = (!pRx_lastRcvdIframeInfo->seqNo) << 4;
+                pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = SEND_R_NACK;
+                pProto7816_Cntx->rnack_retry_counter++;
             }
             else {
                 T_SMLOG_E("%s Recovery failed completely, Going to exit ", __FUNCTION__);
-                phNxpEseProto7816_3_Var.rnack_retry_counter = PH_PROTO_7816_VALUE_ZERO;
+                pProto7816_Cntx->rnack_retry_counter = PH_PROTO_7816_VALUE_ZERO;
                 /* Recovery failed completely, Going to exit */
-                phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
-                phNxpEseProto7816_3_Var.timeoutCounter                        = PH_PROTO_7816_VALUE_ZERO;
+                pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
+                pProto7816_Cntx->timeoutCounter                        = PH_PROTO_7816_VALUE_ZERO;
             }
         }
         /*ISO7816-3 Rule 7.1 Implementation*/
-        else if (IFRAME == phNxpEseProto7816_3_Var.phNxpEseLastTx_Cntx.FrameType) {
-            if (phNxpEseProto7816_3_Var.rnack_retry_counter < phNxpEseProto7816_3_Var.rnack_retry_limit) {
+        else if (IFRAME == pProto7816_Cntx->phNxpEseLastTx_Cntx.FrameType) {
+            if (pProto7816_Cntx->rnack_retry_counter < pProto7816_Cntx->rnack_retry_limit) {
                 phNxpEse_clearReadBuffer(conn_ctx);
-                phNxpEseProto7816_3_Var.phNxpEseRx_Cntx.lastRcvdFrameType     = INVALID;
-                phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = RFRAME;
-                pNextTx_RframeInfo->errCode                                   = PARITY_ERROR;
-                pNextTx_RframeInfo->seqNo                                     = (!pRx_lastRcvdIframeInfo->seqNo) << 4;
-                phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = SEND_R_NACK;
-                phNxpEseProto7816_3_Var.rnack_retry_counter++;
+                pProto7816_Cntx->phNxpEseRx_Cntx.lastRcvdFrameType     = INVALID;
+                pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = RFRAME;
+                pNextTx_RframeInfo->errCode                            = PARITY_ERROR;
+                pNextTx_RframeInfo->seqNo                              = (!pRx_lastRcvdIframeInfo->seqNo) << 4;
+                pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = SEND_R_NACK;
+                pProto7816_Cntx->rnack_retry_counter++;
             }
             else {
                 T_SMLOG_E("%s Recovery failed completely, Going to exit ", __FUNCTION__);
-                phNxpEseProto7816_3_Var.rnack_retry_counter = PH_PROTO_7816_VALUE_ZERO;
+                pProto7816_Cntx->rnack_retry_counter = PH_PROTO_7816_VALUE_ZERO;
                 /* Recovery failed completely, Going to exit */
-                phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
-                phNxpEseProto7816_3_Var.timeoutCounter                        = PH_PROTO_7816_VALUE_ZERO;
+                pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
+                pProto7816_Cntx->timeoutCounter                        = PH_PROTO_7816_VALUE_ZERO;
             }
         }
         else {
-            sm_sleep(DELAY_ERROR_RECOVERY / 1000);
+            pProto7816_Cntx->stepDelayUs = DELAY_ERROR_RECOVERY;
             /* re transmit the frame */
-            if (phNxpEseProto7816_3_Var.timeoutCounter < PH_PROTO_7816_TIMEOUT_RETRY_COUNT) {
-                phNxpEseProto7816_3_Var.timeoutCounter++;
+            if (pProto7816_Cntx->timeoutCounter < PH_PROTO_7816_TIMEOUT_RETRY_COUNT) {
+                pProto7816_Cntx->timeoutCounter++;
                 T_SMLOG_E("%s re-transmitting the previous frame ", __FUNCTION__);
-                phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx = phNxpEseProto7816_3_Var.phNxpEseLastTx_Cntx;
+                pProto7816_Cntx->phNxpEseNextTx_Cntx = pProto7816_Cntx->phNxpEseLastTx_Cntx;
+                phNxpEse_getStatsCntx(conn_ctx)->retransmits++;
             }
             else {
                 /* Recovery failed completely, Going to exit */
                 T_SMLOG_E("%s Recovery failed completely, Going to exit ", __FUNCTION__);
-                phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
-                phNxpEseProto7816_3_Var.timeoutCounter                        = PH_PROTO_7816_VALUE_ZERO;
+                pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
+                pProto7816_Cntx->timeoutCounter                        = PH_PROTO_7816_VALUE_ZERO;
             }
         }
     }
@@ -1161,102 +1437,544 @@ static bool_t phNxpEseProto7816_ProcessResponse(void *conn_ctx)
 }
 
 /******************************************************************************
- * Function         TransceiveProcess
+ * Function         phNxpEseProto7816_SendNextFrame
  *
- * Description      This internal function is used to
- *                  1. Send the raw data received from application after computing CRC
- *                  2. Receive the the response data from ESE, decode, process and
- *                     store the data.
+ * Description      This internal function is used to send the frame selected
+ *                  by the next transceive state.
  *
- * param[in]        void
+ * param[in]        void* conn_ctx
  *
  * Returns          On success return TRUE or else FALSE.
  *
  ******************************************************************************/
-static bool_t TransceiveProcess(void *conn_ctx)
+static bool_t phNxpEseProto7816_SendNextFrame(void *conn_ctx)
 {
-    bool_t status = FALSE;
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+    bool_t status                        = FALSE;
     sFrameInfo_t sFrameInfo;
     sFrameInfo.sFrameType = INVALID_REQ_RES;
 
-    sFrameInfo.sFrameType = INVALID_REQ_RES;
-
-    while (phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState != IDLE_STATE) {
-        T_SMLOG_D(
-            "%s nextTransceiveState %x ", __FUNCTION__, phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState);
-        switch (phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState) {
-        case SEND_IFRAME:
-            status = phNxpEseProto7816_SendIframe(conn_ctx, phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.IframeInfo);
-            break;
-        case SEND_R_ACK:
-            status = phNxpEseProto7816_sendRframe(conn_ctx, RACK);
-            break;
-        case SEND_R_NACK:
-            status = phNxpEseProto7816_sendRframe(conn_ctx, RNACK);
-            break;
-        case SEND_S_RSYNC:
-            sFrameInfo.sFrameType = RESYNCH_REQ;
-            status                = phNxpEseProto7816_SendSFrame(conn_ctx, sFrameInfo);
-            break;
-        case SEND_S_WTX_RSP:
-            sFrameInfo.sFrameType = WTX_RSP;
-            status                = phNxpEseProto7816_SendSFrame(conn_ctx, sFrameInfo);
-            break;
-        case SEND_DEEP_PWR_DOWN:
-            sFrameInfo.sFrameType = DEEP_PWR_DOWN_REQ;
-            status                = phNxpEseProto7816_SendSFrame(conn_ctx, sFrameInfo);
-            break;
+    T_SMLOG_D("%s nextTransceiveState %x ", __FUNCTION__, pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState);
+    switch (pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState) {
+    case SEND_IFRAME:
+        status = phNxpEseProto7816_SendIframe(conn_ctx, pProto7816_Cntx->phNxpEseNextTx_Cntx.IframeInfo);
+        break;
+    case SEND_R_ACK:
+        status = phNxpEseProto7816_sendRframe(conn_ctx, RACK);
+        break;
+    case SEND_R_NACK:
+        status = phNxpEseProto7816_sendRframe(conn_ctx, RNACK);
+        break;
+    case SEND_S_RSYNC:
+        sFrameInfo.sFrameType = RESYNCH_REQ;
+        status                = phNxpEseProto7816_SendSFrame(conn_ctx, sFrameInfo);
+        break;
+    case SEND_S_IFS:
+        sFrameInfo.sFrameType = IFSC_REQ;
+        status                = phNxpEseProto7816_SendSFrame(conn_ctx, sFrameInfo);
+        break;
+    case SEND_S_WTX_RSP:
+        sFrameInfo.sFrameType = WTX_RSP;
+        status                = phNxpEseProto7816_SendSFrame(conn_ctx, sFrameInfo);
+        break;
+    case SEND_DEEP_PWR_DOWN:
+        sFrameInfo.sFrameType = DEEP_PWR_DOWN_REQ;
+        status                = phNxpEseProto7816_SendSFrame(conn_ctx, sFrameInfo);
+        break;
 #if defined(T1oI2C_UM11225)
-        case SEND_S_CHIP_RST:
-            sFrameInfo.sFrameType = CHIP_RESET_REQ;
-            status                = phNxpEseProto7816_SendSFrame(conn_ctx, sFrameInfo);
-            break;
-        case SEND_S_INTF_RST:
-            sFrameInfo.sFrameType = INTF_RESET_REQ;
-            status                = phNxpEseProto7816_SendSFrame(conn_ctx, sFrameInfo);
-            break;
-        case SEND_S_EOS:
-            sFrameInfo.sFrameType = PROP_END_APDU_REQ;
-            status                = phNxpEseProto7816_SendSFrame(conn_ctx, sFrameInfo);
-            break;
-        case SEND_S_ATR:
-            sFrameInfo.sFrameType = ATR_REQ;
-            status                = phNxpEseProto7816_SendSFrame(conn_ctx, sFrameInfo);
-            break;
+    case SEND_S_CHIP_RST:
+        sFrameInfo.sFrameType = CHIP_RESET_REQ;
+        status                = phNxpEseProto7816_SendSFrame(conn_ctx, sFrameInfo);
+        break;
+    case SEND_S_INTF_RST:
+        sFrameInfo.sFrameType = INTF_RESET_REQ;
+        status                = phNxpEseProto7816_SendSFrame(conn_ctx, sFrameInfo);
+        break;
+    case SEND_S_EOS:
+        sFrameInfo.sFrameType = PROP_END_APDU_REQ;
+        status                = phNxpEseProto7816_SendSFrame(conn_ctx, sFrameInfo);
+        break;
+    case SEND_S_ATR:
+        sFrameInfo.sFrameType = ATR_REQ;
+        status                = phNxpEseProto7816_SendSFrame(conn_ctx, sFrameInfo);
+        break;
 #elif defined(T1oI2C_GP1_0)
-        case SEND_S_CIP:
-            sFrameInfo.sFrameType = CIP_REQ;
-            status                = phNxpEseProto7816_SendSFrame(conn_ctx, sFrameInfo);
-            break;
-        case SEND_S_SWR:
-            sFrameInfo.sFrameType = SWR_REQ;
-            status                = phNxpEseProto7816_SendSFrame(conn_ctx, sFrameInfo);
-            break;
-        case SEND_S_RELEASE:
-            sFrameInfo.sFrameType = RELEASE_REQ;
-            status                = phNxpEseProto7816_SendSFrame(conn_ctx, sFrameInfo);
-            break;
-        case SEND_S_COLD_RST:
-            sFrameInfo.sFrameType = COLD_RESET_REQ;
-            status                = phNxpEseProto7816_SendSFrame(conn_ctx, sFrameInfo);
-            break;
+    case SEND_S_CIP:
+        sFrameInfo.sFrameType = CIP_REQ;
+        status                = phNxpEseProto7816_SendSFrame(conn_ctx, sFrameInfo);
+        break;
+    case SEND_S_SWR:
+        sFrameInfo.sFrameType = SWR_REQ;
+        status                = phNxpEseProto7816_SendSFrame(conn_ctx, sFrameInfo);
+        break;
+    case SEND_S_RELEASE:
+        sFrameInfo.sFrameType = RELEASE_REQ;
+        status                = phNxpEseProto7816_SendSFrame(conn_ctx, sFrameInfo);
+        break;
+    case SEND_S_COLD_RST:
+        sFrameInfo.sFrameType = COLD_RESET_REQ;
+        status                = phNxpEseProto7816_SendSFrame(conn_ctx, sFrameInfo);
+        break;
 #else
 #error Either T1oI2C_UM11225 or T1oI2C_GP1_0 must be defined.
 #endif
-        default:
-            phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
+    default:
+        pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
+        break;
+    }
+    return status;
+}
+
+/******************************************************************************
+ * Function         phNxpEseProto7816_StartSteps
+ *
+ * Description      This internal function prepares the step state for a new
+ *                  exchange.
+ *
+ * param[in]        void* conn_ctx
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void phNxpEseProto7816_StartSteps(void *conn_ctx)
+{
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+
+    phNxpEseProto7816_SetPhase(conn_ctx, PH_NXP_ESE_PROTO_7816_PHASE_SEND);
+    pProto7816_Cntx->stepStatus    = FALSE;
+    pProto7816_Cntx->stepTxUs      = sm_get_time_us();
+    pProto7816_Cntx->wtxCount      = 0;
+    pProto7816_Cntx->wtxDurationUs = 0;
+    pProto7816_Cntx->wtxPollUs     = PH_PROTO_7816_WTX_POLL_MIN_US;
+    pProto7816_Cntx->isTimedOut    = FALSE;
+}
+
+/******************************************************************************
+ * Function         phNxpEseProto7816_ChargePhaseTime
+ *
+ * Description      This internal function adds the time since the start of the
+ *                  current step phase to the time counter of the phase and
+ *                  starts timing the next one.
+ *
+ * param[in]        void* conn_ctx
+ * param[in]        uint64_t*: time counter of the next phase, NULL at the end of the exchange
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void phNxpEseProto7816_ChargePhaseTime(void *conn_ctx, uint64_t *pNextPhaseTimeUs)
+{
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+    uint64_t nowUs                       = sm_get_time_us();
+
+    if ((pProto7816_Cntx->pPhaseTimeUs != NULL) && (nowUs > pProto7816_Cntx->phaseStartUs)) {
+        *pProto7816_Cntx->pPhaseTimeUs += nowUs - pProto7816_Cntx->phaseStartUs;
+    }
+    pProto7816_Cntx->phaseStartUs = nowUs;
+    pProto7816_Cntx->pPhaseTimeUs = pNextPhaseTimeUs;
+}
+
+/******************************************************************************
+ * Function         phNxpEseProto7816_SetPhase
+ *
+ * Description      This internal function moves the exchange to the next step
+ *                  phase. The time of a phase is counted in phNxpEse_Stats_t,
+ *                  waits on an S(WTX) extension apart from other waits.
+ *
+ * param[in]        void* conn_ctx
+ * param[in]        phNxpEseProto7816_StepPhase_t: next phase
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void phNxpEseProto7816_SetPhase(void *conn_ctx, phNxpEseProto7816_StepPhase_t phase)
+{
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+    phNxpEse_Stats_t *pStats             = phNxpEse_getStatsCntx(conn_ctx);
+    uint64_t *pPhaseTimeUs               = &pStats->sendUs;
+
+    if ((phase != PH_NXP_ESE_PROTO_7816_PHASE_SEND) &&
+        (pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState == SEND_S_WTX_RSP)) {
+        pPhaseTimeUs = &pStats->wtxUs;
+    }
+    else if (phase == PH_NXP_ESE_PROTO_7816_PHASE_RECEIVE) {
+        pPhaseTimeUs = &pStats->rspWaitUs;
+    }
+    else if (phase == PH_NXP_ESE_PROTO_7816_PHASE_DELAY) {
+        pPhaseTimeUs = &pStats->delayUs;
+    }
+    phNxpEseProto7816_ChargePhaseTime(conn_ctx, pPhaseTimeUs);
+    pProto7816_Cntx->stepPhase = phase;
+}
+
+/******************************************************************************
+ * Function         phNxpEseProto7816_GetTimeLeft
+ *
+ * Description      This internal function returns the time left until the
+ *                  deadline of the exchange.
+ *
+ * param[in]        void* conn_ctx
+ *
+ * Returns          Time left in microseconds, UINT64_MAX if there is no deadline.
+ *
+ ******************************************************************************/
+static uint64_t phNxpEseProto7816_GetTimeLeft(void *conn_ctx)
+{
+    uint64_t deadlineUs = phNxpEse_getDeadline(conn_ctx);
+    uint64_t nowUs      = 0;
+
+    if (deadlineUs == 0) {
+        return UINT64_MAX;
+    }
+    nowUs = sm_get_time_us();
+    return (nowUs < deadlineUs) ? (deadlineUs - nowUs) : 0;
+}
+
+/******************************************************************************
+ * Function         phNxpEseProto7816_GetRecoveryCost
+ *
+ * Description      This internal function returns the time budget needed by
+ *                  the recovery step of a transceive state. Recovery escalates
+ *                  from the cheapest step: R-NACK, S(RESYNCH), interface reset,
+ *                  chip reset.
+ *
+ * param[in]        phNxpEseProto7816_TransceiveStates_t: next transceive state
+ *
+ * Returns          Time in microseconds, 0 if the state is no recovery step.
+ *
+ ******************************************************************************/
+static uint32_t phNxpEseProto7816_GetRecoveryCost(phNxpEseProto7816_TransceiveStates_t state)
+{
+    switch (state) {
+    case SEND_R_NACK:
+        return PH_PROTO_7816_RNACK_COST_US;
+    case SEND_S_RSYNC:
+        return PH_PROTO_7816_RESYNC_COST_US;
+#if defined(T1oI2C_UM11225)
+    case SEND_S_INTF_RST:
+        return PH_PROTO_7816_INTF_RESET_COST_US;
+    case SEND_S_CHIP_RST:
+        return PH_PROTO_7816_CHIP_RESET_COST_US;
+#elif defined(T1oI2C_GP1_0)
+    case SEND_S_SWR:
+        return PH_PROTO_7816_INTF_RESET_COST_US;
+    case SEND_S_COLD_RST:
+        return PH_PROTO_7816_CHIP_RESET_COST_US;
+#endif
+    default:
+        return 0;
+    }
+}
+
+/******************************************************************************
+ * Function         phNxpEseProto7816_StepWait
+ *
+ * Description      This internal function limits the wait of a step to the
+ *                  deadline of the exchange.
+ *
+ * param[in]        void* conn_ctx
+ * param[in]        phNxpEse_StepResult: ESE_STEP_WAIT_* result of the step
+ * param[in,out]    uint32_t*: time to wait in microseconds
+ *
+ * Returns          The result of the step.
+ *
+ ******************************************************************************/
+static phNxpEse_StepResult phNxpEseProto7816_StepWait(void *conn_ctx, phNxpEse_StepResult result, uint32_t *pWaitUs)
+{
+    uint64_t timeLeftUs = phNxpEseProto7816_GetTimeLeft(conn_ctx);
+
+    if (*pWaitUs > timeLeftUs) {
+        *pWaitUs = (uint32_t)timeLeftUs;
+    }
+    return result;
+}
+
+/******************************************************************************
+ * Function         phNxpEseProto7816_Abandon
+ *
+ * Description      This internal function ends the exchange at its deadline.
+ *                  The ESE may still answer the abandoned frame, so the next
+ *                  exchange starts with S(RESYNCH).
+ *
+ * param[in]        void* conn_ctx
+ *
+ * Returns          ESE_STEP_TIMEOUT
+ *
+ ******************************************************************************/
+static phNxpEse_StepResult phNxpEseProto7816_Abandon(void *conn_ctx)
+{
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+
+    T_SMLOG_E("%s Deadline reached in state %x, exchange abandoned ",
+        __FUNCTION__,
+        pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState);
+    phNxpEse_stopRead(conn_ctx);
+    phNxpEseProto7816_SetPhase(conn_ctx, PH_NXP_ESE_PROTO_7816_PHASE_SEND);
+    phNxpEseProto7816_ChargePhaseTime(conn_ctx, NULL);
+    pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
+    pProto7816_Cntx->stepStatus                            = FALSE;
+    pProto7816_Cntx->isTimedOut                            = TRUE;
+    pProto7816_Cntx->isResyncRequired                      = TRUE;
+    pProto7816_Cntx->isResyncFirst                         = FALSE;
+    return ESE_STEP_TIMEOUT;
+}
+
+/******************************************************************************
+ * Function         phNxpEseProto7816_Step
+ *
+ * Description      This function advances the exchange set up in the protocol
+ *                  context (e.g. by phNxpEseProto7816_TransceiveStart) as far
+ *                  as possible without waiting for the ESE:
+ *                  1. Send the next frame
+ *                  2. Poll once for the frame of the ESE, decode and process it
+ *                  Frames are transferred within the call, all waits (ESE
+ *                  processing time, error recovery delay) are returned to the
+ *                  caller, who steps again once the wait is over.
+ *                  With a deadline (phNxpEse_setDeadline), waits end at the
+ *                  deadline and recovery steps are only started when they fit
+ *                  in the time left.
+ *
+ * param[in]        void* conn_ctx
+ * param[in]        phNxpEse_StepEvent: reason of the step
+ * param[out]       uint32_t*: with ESE_STEP_WAIT_*, time to wait in microseconds
+ *
+ * Returns          ESE_STEP_DONE, ESE_STEP_FAILED or ESE_STEP_TIMEOUT once the exchange
+ *                  is complete, ESE_STEP_WAIT_* otherwise.
+ *
+ ******************************************************************************/
+phNxpEse_StepResult phNxpEseProto7816_Step(void *conn_ctx, phNxpEse_StepEvent event, uint32_t *pWaitUs)
+{
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+    phNxpEse_StepResult result           = ESE_STEP_FAILED;
+    ESESTATUS readStatus                 = ESESTATUS_FAILED;
+    uint32_t data_len                    = 0;
+    uint8_t *p_data                      = NULL;
+    uint8_t *p_inf                       = NULL;
+    uint64_t nowUs                       = 0;
+    uint64_t timeLeftUs                  = 0;
+    bool_t status                        = FALSE;
+
+    /* The ESE is polled on every event, a readiness event only saves the wait */
+    (void)event;
+    if (pWaitUs == NULL) {
+        return ESE_STEP_FAILED;
+    }
+    *pWaitUs = 0;
+
+    while (1) {
+        switch (pProto7816_Cntx->stepPhase) {
+        case PH_NXP_ESE_PROTO_7816_PHASE_DELAY:
+            nowUs = sm_get_time_us();
+            if (nowUs < pProto7816_Cntx->stepDeadlineUs) {
+                *pWaitUs   = (uint32_t)(pProto7816_Cntx->stepDeadlineUs - nowUs);
+                timeLeftUs = phNxpEseProto7816_GetTimeLeft(conn_ctx);
+                if ((*pWaitUs + (uint64_t)phNxpEseProto7816_GetRecoveryCost(
+                                    pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState)) > timeLeftUs) {
+                    return phNxpEseProto7816_Abandon(conn_ctx);
+                }
+                return (pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState == SEND_S_WTX_RSP) ?
+                           ESE_STEP_WAIT_WTX :
+                           ESE_STEP_WAIT_TIME;
+            }
+            phNxpEseProto7816_SetPhase(conn_ctx, PH_NXP_ESE_PROTO_7816_PHASE_SEND);
+            break;
+        case PH_NXP_ESE_PROTO_7816_PHASE_RECEIVE:
+            readStatus = phNxpEseProto7816_TryRawFrame(conn_ctx, &data_len, &p_data, &p_inf, pWaitUs);
+            if (readStatus == ESESTATUS_PENDING) {
+                if (phNxpEseProto7816_GetTimeLeft(conn_ctx) == 0) {
+                    return phNxpEseProto7816_Abandon(conn_ctx);
+                }
+                if (pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState == SEND_S_WTX_RSP) {
+                    /* The ESE got more time, no need to poll at the regular interval */
+                    *pWaitUs = pProto7816_Cntx->wtxPollUs;
+                    return phNxpEseProto7816_StepWait(conn_ctx, ESE_STEP_WAIT_WTX, pWaitUs);
+                }
+                return phNxpEseProto7816_StepWait(conn_ctx, ESE_STEP_WAIT_READABLE, pWaitUs);
+            }
+            if (readStatus == ESESTATUS_SUCCESS) {
+                phNxpEse_getStatsCntx(conn_ctx)->framesReceived++;
+            }
+            else {
+                phNxpEse_getStatsCntx(conn_ctx)->rxFailures++;
+            }
+            pProto7816_Cntx->stepDelayUs = 0;
+            status                       = phNxpEseProto7816_ProcessResponse(
+                conn_ctx, ((readStatus == ESESTATUS_SUCCESS) ? TRUE : FALSE), data_len, p_data, p_inf);
+            /* Set after processing, a protocol reset clears the context */
+            pProto7816_Cntx->stepStatus = status;
+            if (pProto7816_Cntx->stepDelayUs > 0) {
+                pProto7816_Cntx->stepDeadlineUs = sm_get_time_us() + pProto7816_Cntx->stepDelayUs;
+                phNxpEseProto7816_SetPhase(conn_ctx, PH_NXP_ESE_PROTO_7816_PHASE_DELAY);
+            }
+            else {
+                phNxpEseProto7816_SetPhase(conn_ctx, PH_NXP_ESE_PROTO_7816_PHASE_SEND);
+            }
+            break;
+        default: /* PH_NXP_ESE_PROTO_7816_PHASE_SEND */
+            if ((pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState == IDLE_STATE) &&
+                (pProto7816_Cntx->isResyncFirst == TRUE)) {
+                pProto7816_Cntx->isResyncFirst = FALSE;
+                if ((pProto7816_Cntx->stepStatus == TRUE) &&
+                    (pProto7816_Cntx->phNxpEseRx_Cntx.lastRcvdSframeInfo.sFrameType == RESYNCH_RSP)) {
+                    /* Both sides restart with sequence number 0, now send the C-APDU */
+                    pProto7816_Cntx->isResyncRequired                         = FALSE;
+                    pProto7816_Cntx->phNxpEseLastTx_Cntx.IframeInfo.seqNo     = PH_PROTO_7816_VALUE_ONE;
+                    pProto7816_Cntx->phNxpEseRx_Cntx.lastRcvdIframeInfo.seqNo = PH_PROTO_7816_VALUE_ONE;
+                    pProto7816_Cntx->stepStatus                               = FALSE;
+                    phNxpEseProto7816_SetFirstIframeContxt(conn_ctx);
+                }
+                else {
+                    pProto7816_Cntx->stepStatus = FALSE;
+                }
+            }
+            if (pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState == IDLE_STATE) {
+                result                      = (pProto7816_Cntx->stepStatus == TRUE) ? ESE_STEP_DONE : ESE_STEP_FAILED;
+                pProto7816_Cntx->stepStatus = FALSE;
+                phNxpEseProto7816_ChargePhaseTime(conn_ctx, NULL);
+                return result;
+            }
+            timeLeftUs = phNxpEseProto7816_GetTimeLeft(conn_ctx);
+            if ((timeLeftUs == 0) ||
+                (phNxpEseProto7816_GetRecoveryCost(pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState) >
+                    timeLeftUs)) {
+                return phNxpEseProto7816_Abandon(conn_ctx);
+            }
+            if (TRUE == phNxpEseProto7816_SendNextFrame(conn_ctx)) {
+                pProto7816_Cntx->phNxpEseLastTx_Cntx = pProto7816_Cntx->phNxpEseNextTx_Cntx;
+                pProto7816_Cntx->stepTxUs            = sm_get_time_us();
+                phNxpEseProto7816_SetPhase(conn_ctx, PH_NXP_ESE_PROTO_7816_PHASE_RECEIVE);
+                phNxpEseProto7816_StartRawFrame(conn_ctx, pWaitUs);
+                if (pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState == SEND_S_WTX_RSP) {
+                    *pWaitUs = pProto7816_Cntx->wtxPollUs;
+                    return phNxpEseProto7816_StepWait(conn_ctx, ESE_STEP_WAIT_WTX, pWaitUs);
+                }
+                return phNxpEseProto7816_StepWait(conn_ctx, ESE_STEP_WAIT_READABLE, pWaitUs);
+            }
+            T_SMLOG_E("%s Transceive send failed, going to recovery! ", __FUNCTION__);
+            pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
+            pProto7816_Cntx->stepStatus                            = FALSE;
             break;
         }
-        if (TRUE == status) {
-            phNxpEseProto7816_3_Var.phNxpEseLastTx_Cntx = phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx;
-            status                                      = phNxpEseProto7816_ProcessResponse(conn_ctx);
+    }
+}
+
+/******************************************************************************
+ * Function         TransceiveProcess
+ *
+ * Description      This internal function is used to
+ *                  1. Send the raw data received from application after computing CRC
+ *                  2. Receive the the response data from ESE, decode, process and
+ *                     store the data.
+ *                  It steps the exchange until it is complete and does the waits.
+ *
+ * param[in]        void* conn_ctx
+ *
+ * Returns          On success return TRUE or else FALSE.
+ *
+ ******************************************************************************/
+static bool_t TransceiveProcess(void *conn_ctx)
+{
+    phNxpEse_StepResult result = ESE_STEP_FAILED;
+    uint32_t waitUs            = 0;
+
+    phNxpEseProto7816_StartSteps(conn_ctx);
+    result = phNxpEseProto7816_Step(conn_ctx, ESE_STEP_EVT_TIMER, &waitUs);
+    while ((result == ESE_STEP_WAIT_TIME) || (result == ESE_STEP_WAIT_READABLE) || (result == ESE_STEP_WAIT_WTX)) {
+        if (result != ESE_STEP_WAIT_TIME) {
+            phNxpEse_waitForData(conn_ctx, waitUs);
         }
         else {
-            T_SMLOG_E("%s Transceive send failed, going to recovery! ", __FUNCTION__);
-            phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
+            phNxpEse_delay(conn_ctx, waitUs);
         }
-    };
-    return status;
+        result = phNxpEseProto7816_Step(conn_ctx, ESE_STEP_EVT_TIMER, &waitUs);
+    }
+    return (result == ESE_STEP_DONE) ? TRUE : FALSE;
+}
+
+/******************************************************************************
+ * Function         phNxpEseProto7816_TransceiveStart
+ *
+ * Description      This function is used to set up the exchange of a C-APDU,
+ *                  which is then driven by phNxpEseProto7816_Step and completed
+ *                  with phNxpEseProto7816_TransceiveEnd.
+ *
+ * param[in]        void* conn_ctx
+ * param[in]        phNxpEse_data: Command to ESE C-APDU
+ * param[out]       phNxpEse_data: Response from ESE R-APDU
+ *
+ * Returns          On success return TRUE or else FALSE.
+ *
+ ******************************************************************************/
+bool_t phNxpEseProto7816_TransceiveStart(void *conn_ctx, phNxpEse_data *pCmd, phNxpEse_data *pRsp)
+{
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+    phNxpEseRx_Cntx_t *pRx_EseCntx       = &pProto7816_Cntx->phNxpEseRx_Cntx;
+    iFrameInfo_t *pNextTx_IframeInfo     = &pProto7816_Cntx->phNxpEseNextTx_Cntx.IframeInfo;
+    sFrameInfo_t *pNextTx_SframeInfo     = &pProto7816_Cntx->phNxpEseNextTx_Cntx.SframeInfo;
+    uintptr_t cmdStart                   = 0;
+    uintptr_t rspStart                   = 0;
+
+    T_SMLOG_D("Enter %s  ", __FUNCTION__);
+    if ((NULL == pCmd) || (NULL == pRsp) ||
+        (pProto7816_Cntx->phNxpEseProto7816_CurrentState != PH_NXP_ESE_PROTO_7816_IDLE))
+        return FALSE;
+    /* Updating the transceive information to the protocol stack */
+    pProto7816_Cntx->phNxpEseProto7816_CurrentState = PH_NXP_ESE_PROTO_7816_TRANSCEIVE;
+    pNextTx_IframeInfo->p_data                      = pCmd->p_data;
+    pNextTx_IframeInfo->totalDataLen                = pCmd->len;
+    pRx_EseCntx->pRsp                               = pRsp;
+    /* The response is received in place, the C-APDU must stay intact for retransmission */
+    cmdStart                         = (uintptr_t)pCmd->p_data;
+    rspStart                         = (uintptr_t)pRsp->p_data;
+    pRx_EseCntx->isRspOverlappingCmd = ((rspStart < (cmdStart + pCmd->len)) && (cmdStart < (rspStart + pRsp->len)));
+    pRx_EseCntx->isCmdOverwritten    = FALSE;
+    T_SMLOG_D("Transceive data ptr 0x%p len:%d ", pCmd->p_data, pCmd->len);
+    phNxpEseProto7816_StartSteps(conn_ctx);
+    if (pProto7816_Cntx->isResyncRequired == TRUE) {
+        /* The last exchange was abandoned, its late reply must not be taken for this one */
+        pProto7816_Cntx->isResyncFirst                         = TRUE;
+        pRx_EseCntx->responseBytesRcvd                         = 0;
+        pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = SFRAME;
+        pNextTx_SframeInfo->sFrameType                         = RESYNCH_REQ;
+        pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = SEND_S_RSYNC;
+    }
+    else {
+        pProto7816_Cntx->isResyncFirst = FALSE;
+        phNxpEseProto7816_SetFirstIframeContxt(conn_ctx);
+    }
+    return TRUE;
+}
+
+/******************************************************************************
+ * Function         phNxpEseProto7816_TransceiveEnd
+ *
+ * Description      This function is used to complete the exchange started with
+ *                  phNxpEseProto7816_TransceiveStart, once phNxpEseProto7816_Step
+ *                  returned ESE_STEP_DONE or ESE_STEP_FAILED.
+ *
+ * param[in]        void* conn_ctx
+ * param[out]       phNxpEse_data: Response from ESE R-APDU
+ *
+ * Returns          On success return TRUE or else FALSE.
+ *
+ ******************************************************************************/
+bool_t phNxpEseProto7816_TransceiveEnd(void *conn_ctx, phNxpEse_data *pRsp)
+{
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+    phNxpEseRx_Cntx_t *pRx_EseCntx       = &pProto7816_Cntx->phNxpEseRx_Cntx;
+
+    uint64_t wtxDurationUs               = 0;
+
+    if (pProto7816_Cntx->wtxCount > 0) {
+        wtxDurationUs                  = sm_get_time_us() - pProto7816_Cntx->wtxFirstUs;
+        pProto7816_Cntx->wtxDurationUs = (wtxDurationUs > UINT32_MAX) ? UINT32_MAX : (uint32_t)wtxDurationUs;
+    }
+    if ((NULL == pRsp) || (pRx_EseCntx->responseBytesRcvd > UINT32_MAX)) {
+        return FALSE;
+    }
+    pRsp->len                                       = pRx_EseCntx->responseBytesRcvd;
+    pProto7816_Cntx->phNxpEseProto7816_CurrentState = PH_NXP_ESE_PROTO_7816_IDLE;
+    return TRUE;
 }
 
 /******************************************************************************
@@ -1276,31 +1994,19 @@ static bool_t TransceiveProcess(void *conn_ctx)
  ******************************************************************************/
 bool_t phNxpEseProto7816_Transceive(void *conn_ctx, phNxpEse_data *pCmd, phNxpEse_data *pRsp)
 {
-    bool_t status                    = FALSE;
-    phNxpEseRx_Cntx_t *pRx_EseCntx   = &phNxpEseProto7816_3_Var.phNxpEseRx_Cntx;
-    iFrameInfo_t *pNextTx_IframeInfo = &phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.IframeInfo;
+    bool_t status = FALSE;
 
-    T_SMLOG_D("Enter %s  ", __FUNCTION__);
-    if ((NULL == pCmd) || (NULL == pRsp) ||
-        (phNxpEseProto7816_3_Var.phNxpEseProto7816_CurrentState != PH_NXP_ESE_PROTO_7816_IDLE))
+    if (FALSE == phNxpEseProto7816_TransceiveStart(conn_ctx, pCmd, pRsp)) {
         return status;
-    /* Updating the transceive information to the protocol stack */
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_CurrentState = PH_NXP_ESE_PROTO_7816_TRANSCEIVE;
-    pNextTx_IframeInfo->p_data                             = pCmd->p_data;
-    pNextTx_IframeInfo->totalDataLen                       = pCmd->len;
-    pRx_EseCntx->pRsp                                      = pRsp;
-    T_SMLOG_D("Transceive data ptr 0x%p len:%d ", pCmd->p_data, pCmd->len);
-    phNxpEseProto7816_SetFirstIframeContxt();
+    }
     status = TransceiveProcess(conn_ctx);
     if (FALSE == status) {
         /* ESE hard reset to be done */
         T_SMLOG_E("%s Transceive failed, hard reset to proceed ", __FUNCTION__);
     }
-    if (pRx_EseCntx->responseBytesRcvd > UINT32_MAX) {
+    if (FALSE == phNxpEseProto7816_TransceiveEnd(conn_ctx, pRsp)) {
         return FALSE;
     }
-    pRsp->len                                              = pRx_EseCntx->responseBytesRcvd;
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_CurrentState = PH_NXP_ESE_PROTO_7816_IDLE;
     return status;
 }
 
@@ -1316,64 +2022,168 @@ bool_t phNxpEseProto7816_Transceive(void *conn_ctx, phNxpEse_data *pCmd, phNxpEs
  ******************************************************************************/
 static bool_t phNxpEseProto7816_RSync(void *conn_ctx)
 {
-    bool_t status                    = FALSE;
-    sFrameInfo_t *pNextTx_SframeInfo = &phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.SframeInfo;
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+    bool_t status                        = FALSE;
+    sFrameInfo_t *pNextTx_SframeInfo     = &pProto7816_Cntx->phNxpEseNextTx_Cntx.SframeInfo;
 
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_CurrentState = PH_NXP_ESE_PROTO_7816_TRANSCEIVE;
+    pProto7816_Cntx->phNxpEseProto7816_CurrentState = PH_NXP_ESE_PROTO_7816_TRANSCEIVE;
     /* send the end of session s-frame */
-    phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = SFRAME;
-    pNextTx_SframeInfo->sFrameType                                = RESYNCH_REQ;
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = SEND_S_RSYNC;
-    status                                                        = TransceiveProcess(conn_ctx);
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_CurrentState        = PH_NXP_ESE_PROTO_7816_IDLE;
+    pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = SFRAME;
+    pNextTx_SframeInfo->sFrameType                         = RESYNCH_REQ;
+    pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = SEND_S_RSYNC;
+    status                                                 = TransceiveProcess(conn_ctx);
+    pProto7816_Cntx->phNxpEseProto7816_CurrentState        = PH_NXP_ESE_PROTO_7816_IDLE;
+    return status;
+}
+
+/******************************************************************************
+ * Function         phNxpEseProto7816_DecodeIfsc
+ *
+ * Description      This internal function is used to get the IFSC advertised
+ *                  in the data link layer parameters (DLLP) of the ATR (UM11225)
+ *                  or CIP (GP). DLLP holds BWT (2 bytes) followed by IFSC (2 bytes).
+ *
+ * param[in]        phNxpEse_data : ATR/CIP response from ESE
+ * param[out]       uint16_t* : IFSC of the ESE
+ *
+ * Returns          On success return TRUE or else FALSE.
+ *
+ ******************************************************************************/
+static bool_t phNxpEseProto7816_DecodeIfsc(const phNxpEse_data *pAtrRsp, uint16_t *pIfsc)
+{
+    bool_t status    = FALSE;
+    uint32_t offset  = 0;
+    uint32_t dllpLen = 0;
+
+    ENSURE_OR_GO_EXIT(pAtrRsp != NULL);
+    ENSURE_OR_GO_EXIT(pAtrRsp->p_data != NULL);
+    ENSURE_OR_GO_EXIT(pIfsc != NULL);
+#if defined(T1oI2C_UM11225)
+    /* PVER (1) | VID (5) | DLLP length (1) | DLLP */
+    offset = 1 + 5;
+#elif defined(T1oI2C_GP1_0)
+    /* PVER (1) | IIN length (1) | IIN | PLID (1) | PLP length (1) | PLP | DLLP length (1) | DLLP */
+    offset = 1;
+    ENSURE_OR_GO_EXIT(pAtrRsp->len > offset);
+    offset += 1 + pAtrRsp->p_data[offset] + 1;
+    ENSURE_OR_GO_EXIT(pAtrRsp->len > offset);
+    offset += 1 + pAtrRsp->p_data[offset];
+#endif
+    ENSURE_OR_GO_EXIT(pAtrRsp->len > offset);
+    dllpLen = pAtrRsp->p_data[offset];
+    offset += 1;
+    ENSURE_OR_GO_EXIT(dllpLen >= 4);
+    ENSURE_OR_GO_EXIT((pAtrRsp->len - offset) >= dllpLen);
+    *pIfsc = (uint16_t)((pAtrRsp->p_data[offset + 2] << 8) | pAtrRsp->p_data[offset + 3]);
+    ENSURE_OR_GO_EXIT(*pIfsc > 0);
+    status = TRUE;
+exit:
     return status;
 }
 
+/******************************************************************************
+ * Function         phNxpEseProto7816_NegotiateIfs
+ *
+ * Description      This internal function is used to agree the information field
+ *                  sizes once the ATR/CIP is received.
+ *                  1. I-frames are sent with the IFSC advertised by the ESE
+ *                  2. When the ESE takes more than IFSC_SIZE_SEND, the IFSD of the
+ *                     host is announced with S(IFS request)
+ *                  On failure the default sizes are kept.
+ *
+ * param[in]        void* conn_ctx
+ * param[in]        phNxpEse_data : ATR/CIP response from ESE
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void phNxpEseProto7816_NegotiateIfs(void *conn_ctx, phNxpEse_data *AtrRsp)
+{
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+    sFrameInfo_t *pNextTx_SframeInfo     = &pProto7816_Cntx->phNxpEseNextTx_Cntx.SframeInfo;
+    sFrameInfo_t *pRx_lastRcvdSframeInfo = &pProto7816_Cntx->phNxpEseRx_Cntx.lastRcvdSframeInfo;
+    bool_t status                        = FALSE;
+    uint16_t ifsc                        = 0;
+
+    if (FALSE == phNxpEseProto7816_DecodeIfsc(AtrRsp, &ifsc)) {
+        T_SMLOG_W("%s No IFSC in the ATR, using %d", __FUNCTION__, pProto7816_Cntx->ifsc);
+        return;
+    }
+    phNxpEseProto7816_SetIfscSize(conn_ctx, ifsc);
+    T_SMLOG_D("%s IFSC of the ESE %d, using %d", __FUNCTION__, ifsc, pProto7816_Cntx->ifsc);
+    if (pProto7816_Cntx->ifsc <= IFSC_SIZE_SEND) {
+        return;
+    }
+
+    pProto7816_Cntx->phNxpEseProto7816_CurrentState        = PH_NXP_ESE_PROTO_7816_TRANSCEIVE;
+    pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = SFRAME;
+    pNextTx_SframeInfo->sFrameType                         = IFSC_REQ;
+    pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = SEND_S_IFS;
+    status                                                 = TransceiveProcess(conn_ctx);
+    pProto7816_Cntx->phNxpEseProto7816_CurrentState        = PH_NXP_ESE_PROTO_7816_IDLE;
+    if ((FALSE == status) || (pRx_lastRcvdSframeInfo->sFrameType != IFSC_RES)) {
+        T_SMLOG_W("%s S(IFS) not answered, IFSD stays %d", __FUNCTION__, pProto7816_Cntx->ifsd);
+        return;
+    }
+    T_SMLOG_D("%s IFSD %d", __FUNCTION__, pProto7816_Cntx->ifsd);
+}
+
 /******************************************************************************
  * Function         phNxpEseProto7816_ResetProtoParams
  *
  * Description      This function is used to reset the 7816 protocol stack instance
  *
- * param[in]        void
+ * param[in]        void* conn_ctx
  *
  * Returns          Always return TRUE.
  *
  ******************************************************************************/
-bool_t phNxpEseProto7816_ResetProtoParams(void)
+bool_t phNxpEseProto7816_ResetProtoParams(void *conn_ctx)
 {
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
     unsigned long int tmpWTXCountlimit   = PH_PROTO_7816_VALUE_ZERO;
     unsigned long int tmpRNACKCountlimit = PH_PROTO_7816_VALUE_ZERO;
-    phNxpEseRx_Cntx_t *pRx_EseCntx       = &phNxpEseProto7816_3_Var.phNxpEseRx_Cntx;
-    iFrameInfo_t *pNextTx_IframeInfo     = &phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.IframeInfo;
-    iFrameInfo_t *pLastTx_IframeInfo     = &phNxpEseProto7816_3_Var.phNxpEseLastTx_Cntx.IframeInfo;
-
-    tmpWTXCountlimit   = phNxpEseProto7816_3_Var.wtx_counter_limit;
-    tmpRNACKCountlimit = phNxpEseProto7816_3_Var.rnack_retry_limit;
-    phNxpEse_memset(&phNxpEseProto7816_3_Var, PH_PROTO_7816_VALUE_ZERO, sizeof(phNxpEseProto7816_t));
-    phNxpEseProto7816_3_Var.wtx_counter_limit                     = tmpWTXCountlimit;
-    phNxpEseProto7816_3_Var.rnack_retry_limit                     = tmpRNACKCountlimit;
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_CurrentState        = PH_NXP_ESE_PROTO_7816_IDLE;
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
-    pRx_EseCntx->lastRcvdFrameType                                = INVALID;
-    phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = INVALID;
-    pNextTx_IframeInfo->maxDataLen                                = IFSC_SIZE_SEND;
-    pNextTx_IframeInfo->p_data                                    = NULL;
-    phNxpEseProto7816_3_Var.phNxpEseLastTx_Cntx.FrameType         = INVALID;
-    pLastTx_IframeInfo->maxDataLen                                = IFSC_SIZE_SEND;
-    pLastTx_IframeInfo->p_data                                    = NULL;
+    uint16_t tmpIfsc                     = PH_PROTO_7816_VALUE_ZERO;
+    uint64_t tmpPhaseStartUs             = pProto7816_Cntx->phaseStartUs;
+    uint64_t *pTmpPhaseTimeUs            = pProto7816_Cntx->pPhaseTimeUs;
+    phNxpEseRx_Cntx_t *pRx_EseCntx       = &pProto7816_Cntx->phNxpEseRx_Cntx;
+    iFrameInfo_t *pNextTx_IframeInfo     = &pProto7816_Cntx->phNxpEseNextTx_Cntx.IframeInfo;
+    iFrameInfo_t *pLastTx_IframeInfo     = &pProto7816_Cntx->phNxpEseLastTx_Cntx.IframeInfo;
+
+    tmpWTXCountlimit   = pProto7816_Cntx->wtx_counter_limit;
+    tmpRNACKCountlimit = pProto7816_Cntx->rnack_retry_limit;
+    /* The IFSC is a property of the ESE and survives a reset, the IFSD falls back to its default */
+    tmpIfsc = (pProto7816_Cntx->ifsc != PH_PROTO_7816_VALUE_ZERO) ? pProto7816_Cntx->ifsc : IFSC_SIZE_SEND;
+    phNxpEse_memset(pProto7816_Cntx, PH_PROTO_7816_VALUE_ZERO, sizeof(phNxpEseProto7816_t));
+    pProto7816_Cntx->wtx_counter_limit                     = tmpWTXCountlimit;
+    pProto7816_Cntx->rnack_retry_limit                     = tmpRNACKCountlimit;
+    pProto7816_Cntx->ifsc                                  = tmpIfsc;
+    pProto7816_Cntx->ifsd                                  = IFSC_SIZE_SEND;
+    /* A reset within an exchange does not interrupt the timing of its phase */
+    pProto7816_Cntx->phaseStartUs                          = tmpPhaseStartUs;
+    pProto7816_Cntx->pPhaseTimeUs                          = pTmpPhaseTimeUs;
+    pProto7816_Cntx->phNxpEseProto7816_CurrentState        = PH_NXP_ESE_PROTO_7816_IDLE;
+    pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = IDLE_STATE;
+    pRx_EseCntx->lastRcvdFrameType                         = INVALID;
+    pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = INVALID;
+    pNextTx_IframeInfo->maxDataLen                         = tmpIfsc;
+    pNextTx_IframeInfo->p_data                             = NULL;
+    pProto7816_Cntx->phNxpEseLastTx_Cntx.FrameType         = INVALID;
+    pLastTx_IframeInfo->maxDataLen                         = tmpIfsc;
+    pLastTx_IframeInfo->p_data                             = NULL;
     /* Initialized with sequence number of the last I-frame sent */
     pNextTx_IframeInfo->seqNo = PH_PROTO_7816_VALUE_ONE;
     /* Initialized with sequence number of the last I-frame received */
     pRx_EseCntx->lastRcvdIframeInfo.seqNo = PH_PROTO_7816_VALUE_ONE;
     /* Initialized with sequence number of the last I-frame received */
-    pLastTx_IframeInfo->seqNo               = PH_PROTO_7816_VALUE_ONE;
-    phNxpEseProto7816_3_Var.recoveryCounter = PH_PROTO_7816_VALUE_ZERO;
-    phNxpEseProto7816_3_Var.timeoutCounter  = PH_PROTO_7816_VALUE_ZERO;
-    phNxpEseProto7816_3_Var.wtx_counter     = PH_PROTO_7816_VALUE_ZERO;
+    pLastTx_IframeInfo->seqNo        = PH_PROTO_7816_VALUE_ONE;
+    pProto7816_Cntx->recoveryCounter = PH_PROTO_7816_VALUE_ZERO;
+    pProto7816_Cntx->timeoutCounter  = PH_PROTO_7816_VALUE_ZERO;
+    pProto7816_Cntx->wtx_counter     = PH_PROTO_7816_VALUE_ZERO;
     /* This update is helpful in-case a R-NACK is transmitted from the MW */
-    phNxpEseProto7816_3_Var.lastSentNonErrorframeType = UNKNOWN;
-    phNxpEseProto7816_3_Var.rnack_retry_counter       = PH_PROTO_7816_VALUE_ZERO;
-    pRx_EseCntx->pRsp                                 = NULL;
+    pProto7816_Cntx->lastSentNonErrorframeType = UNKNOWN;
+    pProto7816_Cntx->rnack_retry_counter       = PH_PROTO_7816_VALUE_ZERO;
+    pRx_EseCntx->pRsp                          = NULL;
     return TRUE;
 }
 
@@ -1382,16 +2192,16 @@ bool_t phNxpEseProto7816_ResetProtoParams(void)
  *
  * Description      This function is used to reset the 7816 protocol stack instance
  *
- * param[in]        void
+ * param[in]        void* conn_ctx
  *
  * Returns          On success return TRUE or else FALSE.
  *
  ******************************************************************************/
-bool_t phNxpEseProto7816_Reset(void)
+bool_t phNxpEseProto7816_Reset(void *conn_ctx)
 {
     bool_t status = FALSE;
     /* Resetting host protocol instance */
-    status = phNxpEseProto7816_ResetProtoParams();
+    status = phNxpEseProto7816_ResetProtoParams(conn_ctx);
     /* Resynchronising ESE protocol instance */
     //status = phNxpEseProto7816_RSync();
     return status;
@@ -1410,13 +2220,14 @@ bool_t phNxpEseProto7816_Reset(void)
  ******************************************************************************/
 bool_t phNxpEseProto7816_Open(void *conn_ctx, phNxpEseProto7816InitParam_t initParam, phNxpEse_data *AtrRsp)
 {
-    bool_t status                  = FALSE;
-    phNxpEseRx_Cntx_t *pRx_EseCntx = &phNxpEseProto7816_3_Var.phNxpEseRx_Cntx;
-    status                         = phNxpEseProto7816_ResetProtoParams();
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+    bool_t status                        = FALSE;
+    phNxpEseRx_Cntx_t *pRx_EseCntx       = &pProto7816_Cntx->phNxpEseRx_Cntx;
+    status                               = phNxpEseProto7816_ResetProtoParams(conn_ctx);
     T_SMLOG_D("%s: First open completed", __FUNCTION__);
     /* Update WTX max. limit */
-    phNxpEseProto7816_3_Var.wtx_counter_limit = initParam.wtx_counter_limit;
-    phNxpEseProto7816_3_Var.rnack_retry_limit = initParam.rnack_retry_limit;
+    pProto7816_Cntx->wtx_counter_limit = initParam.wtx_counter_limit;
+    pProto7816_Cntx->rnack_retry_limit = initParam.rnack_retry_limit;
     /*Intialise the buffers before hand so that we are able to receive data
     if RSync goes to recovery handling*/
     pRx_EseCntx->pRsp              = AtrRsp;
@@ -1435,6 +2246,9 @@ bool_t phNxpEseProto7816_Open(void *conn_ctx, phNxpEseProto7816InitParam_t initP
         if (status == TRUE) {
             status = phNxpEseProto7816_GetAtr(conn_ctx, AtrRsp);
         }
+        if (status == TRUE) {
+            phNxpEseProto7816_NegotiateIfs(conn_ctx, AtrRsp);
+        }
 
 #elif defined(T1oI2C_GP1_0)
         /* For GP soft reset does not respond with CIP so master should send CIP req. seperatly  */
@@ -1442,6 +2256,9 @@ bool_t phNxpEseProto7816_Open(void *conn_ctx, phNxpEseProto7816InitParam_t initP
         if (status == TRUE) {
             status = phNxpEseProto7816_GetCip(conn_ctx, AtrRsp);
         }
+        if (status == TRUE) {
+            phNxpEseProto7816_NegotiateIfs(conn_ctx, AtrRsp);
+        }
 #endif
     }
     else /* Do R-Sync */
@@ -1464,35 +2281,36 @@ bool_t phNxpEseProto7816_Open(void *conn_ctx, phNxpEseProto7816InitParam_t initP
  ******************************************************************************/
 bool_t phNxpEseProto7816_Close(void *conn_ctx)
 {
-    sFrameInfo_t *pNextTx_SframeInfo = &phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.SframeInfo;
-    bool_t status                    = FALSE;
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+    sFrameInfo_t *pNextTx_SframeInfo     = &pProto7816_Cntx->phNxpEseNextTx_Cntx.SframeInfo;
+    bool_t status                        = FALSE;
     /*Explicitly Initilising to NULL as the Application layer does not intend to receive a response*/
-    phNxpEseRx_Cntx_t *pRx_EseCntx = &phNxpEseProto7816_3_Var.phNxpEseRx_Cntx;
+    phNxpEseRx_Cntx_t *pRx_EseCntx = &pProto7816_Cntx->phNxpEseRx_Cntx;
     pRx_EseCntx->pRsp              = NULL;
 
-    if (phNxpEseProto7816_3_Var.phNxpEseProto7816_CurrentState != PH_NXP_ESE_PROTO_7816_IDLE) {
+    if (pProto7816_Cntx->phNxpEseProto7816_CurrentState != PH_NXP_ESE_PROTO_7816_IDLE) {
         return status;
     }
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_CurrentState = PH_NXP_ESE_PROTO_7816_DEINIT;
-    phNxpEseProto7816_3_Var.recoveryCounter                = 0;
-    phNxpEseProto7816_3_Var.wtx_counter                    = 0;
+    pProto7816_Cntx->phNxpEseProto7816_CurrentState = PH_NXP_ESE_PROTO_7816_DEINIT;
+    pProto7816_Cntx->recoveryCounter                = 0;
+    pProto7816_Cntx->wtx_counter                    = 0;
 #if defined(T1oI2C_UM11225)
     /* send the end of session s-frame */
-    phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = SFRAME;
-    pNextTx_SframeInfo->sFrameType                                = PROP_END_APDU_REQ;
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = SEND_S_EOS;
+    pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = SFRAME;
+    pNextTx_SframeInfo->sFrameType                         = PROP_END_APDU_REQ;
+    pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = SEND_S_EOS;
 #elif defined(T1oI2C_GP1_0)
     /* send the release request s-frame */
-    phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = SFRAME;
-    pNextTx_SframeInfo->sFrameType                                = RELEASE_REQ;
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = SEND_S_RELEASE;
+    pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = SFRAME;
+    pNextTx_SframeInfo->sFrameType                         = RELEASE_REQ;
+    pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = SEND_S_RELEASE;
 #endif
     status = TransceiveProcess(conn_ctx);
     if (FALSE == status) {
         /* reset all the structures */
         T_SMLOG_E("%s TransceiveProcess failed  ", __FUNCTION__);
     }
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_CurrentState = PH_NXP_ESE_PROTO_7816_IDLE;
+    pProto7816_Cntx->phNxpEseProto7816_CurrentState = PH_NXP_ESE_PROTO_7816_IDLE;
     return status;
 }
 
@@ -1510,18 +2328,19 @@ bool_t phNxpEseProto7816_Close(void *conn_ctx)
  ******************************************************************************/
 bool_t phNxpEseProto7816_IntfReset(void *conn_ctx, phNxpEse_data *AtrRsp)
 {
-    bool_t status                    = FALSE;
-    sFrameInfo_t *pNextTx_SframeInfo = &phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.SframeInfo;
-    phNxpEseRx_Cntx_t *pRx_EseCntx   = &phNxpEseProto7816_3_Var.phNxpEseRx_Cntx;
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+    bool_t status                        = FALSE;
+    sFrameInfo_t *pNextTx_SframeInfo     = &pProto7816_Cntx->phNxpEseNextTx_Cntx.SframeInfo;
+    phNxpEseRx_Cntx_t *pRx_EseCntx       = &pProto7816_Cntx->phNxpEseRx_Cntx;
 
     ENSURE_OR_GO_EXIT(AtrRsp != NULL);
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_CurrentState        = PH_NXP_ESE_PROTO_7816_TRANSCEIVE;
-    phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = SFRAME;
-    pNextTx_SframeInfo->sFrameType                                = INTF_RESET_REQ;
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = SEND_S_INTF_RST;
-    pRx_EseCntx->pRsp                                             = AtrRsp;
-    pRx_EseCntx->pRsp->len                                        = AtrRsp->len;
-    pRx_EseCntx->responseBytesRcvd                                = 0;
+    pProto7816_Cntx->phNxpEseProto7816_CurrentState        = PH_NXP_ESE_PROTO_7816_TRANSCEIVE;
+    pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = SFRAME;
+    pNextTx_SframeInfo->sFrameType                         = INTF_RESET_REQ;
+    pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = SEND_S_INTF_RST;
+    pRx_EseCntx->pRsp                                      = AtrRsp;
+    pRx_EseCntx->pRsp->len                                 = AtrRsp->len;
+    pRx_EseCntx->responseBytesRcvd                         = 0;
     phNxpEse_clearReadBuffer(conn_ctx);
     status      = TransceiveProcess(conn_ctx);
     AtrRsp->len = pRx_EseCntx->responseBytesRcvd;
@@ -1530,7 +2349,7 @@ bool_t phNxpEseProto7816_IntfReset(void *conn_ctx, phNxpEse_data *AtrRsp)
         T_SMLOG_E("%s TransceiveProcess failed  ", __FUNCTION__);
     }
 
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_CurrentState = PH_NXP_ESE_PROTO_7816_IDLE;
+    pProto7816_Cntx->phNxpEseProto7816_CurrentState = PH_NXP_ESE_PROTO_7816_IDLE;
 exit:
     return status;
 }
@@ -1547,21 +2366,22 @@ exit:
  ******************************************************************************/
 bool_t phNxpEseProto7816_ChipReset(void *conn_ctx)
 {
-    bool_t status                    = FALSE;
-    sFrameInfo_t *pNextTx_SframeInfo = &phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.SframeInfo;
-    phNxpEseRx_Cntx_t *pRx_EseCntx   = &phNxpEseProto7816_3_Var.phNxpEseRx_Cntx;
-
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_CurrentState        = PH_NXP_ESE_PROTO_7816_TRANSCEIVE;
-    phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = SFRAME;
-    pNextTx_SframeInfo->sFrameType                                = CHIP_RESET_REQ;
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = SEND_S_CHIP_RST;
-    pRx_EseCntx->pRsp                                             = NULL;
-    status                                                        = TransceiveProcess(conn_ctx);
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+    bool_t status                        = FALSE;
+    sFrameInfo_t *pNextTx_SframeInfo     = &pProto7816_Cntx->phNxpEseNextTx_Cntx.SframeInfo;
+    phNxpEseRx_Cntx_t *pRx_EseCntx       = &pProto7816_Cntx->phNxpEseRx_Cntx;
+
+    pProto7816_Cntx->phNxpEseProto7816_CurrentState        = PH_NXP_ESE_PROTO_7816_TRANSCEIVE;
+    pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = SFRAME;
+    pNextTx_SframeInfo->sFrameType                         = CHIP_RESET_REQ;
+    pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = SEND_S_CHIP_RST;
+    pRx_EseCntx->pRsp                                      = NULL;
+    status                                                 = TransceiveProcess(conn_ctx);
     if (FALSE == status) {
         /* reset all the structures */
         T_SMLOG_E("%s TransceiveProcess failed  ", __FUNCTION__);
     }
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_CurrentState = PH_NXP_ESE_PROTO_7816_IDLE;
+    pProto7816_Cntx->phNxpEseProto7816_CurrentState = PH_NXP_ESE_PROTO_7816_IDLE;
     return status;
 }
 #endif
@@ -1579,15 +2399,16 @@ bool_t phNxpEseProto7816_ChipReset(void *conn_ctx)
  ******************************************************************************/
 bool_t phNxpEseProto7816_SoftReset(void *conn_ctx)
 {
-    bool_t status                    = FALSE;
-    sFrameInfo_t *pNextTx_SframeInfo = &phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.SframeInfo;
-    phNxpEseRx_Cntx_t *pRx_EseCntx   = &phNxpEseProto7816_3_Var.phNxpEseRx_Cntx;
-
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_CurrentState        = PH_NXP_ESE_PROTO_7816_TRANSCEIVE;
-    phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = SFRAME;
-    pNextTx_SframeInfo->sFrameType                                = SWR_REQ;
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = SEND_S_SWR;
-    pRx_EseCntx->pRsp                                             = NULL;
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+    bool_t status                        = FALSE;
+    sFrameInfo_t *pNextTx_SframeInfo     = &pProto7816_Cntx->phNxpEseNextTx_Cntx.SframeInfo;
+    phNxpEseRx_Cntx_t *pRx_EseCntx       = &pProto7816_Cntx->phNxpEseRx_Cntx;
+
+    pProto7816_Cntx->phNxpEseProto7816_CurrentState        = PH_NXP_ESE_PROTO_7816_TRANSCEIVE;
+    pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = SFRAME;
+    pNextTx_SframeInfo->sFrameType                         = SWR_REQ;
+    pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = SEND_S_SWR;
+    pRx_EseCntx->pRsp                                      = NULL;
     phNxpEse_clearReadBuffer(conn_ctx);
     status = TransceiveProcess(conn_ctx);
     if (FALSE == status) {
@@ -1595,7 +2416,7 @@ bool_t phNxpEseProto7816_SoftReset(void *conn_ctx)
         T_SMLOG_E("%s TransceiveProcess failed  ", __FUNCTION__);
     }
 
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_CurrentState = PH_NXP_ESE_PROTO_7816_IDLE;
+    pProto7816_Cntx->phNxpEseProto7816_CurrentState = PH_NXP_ESE_PROTO_7816_IDLE;
     return status;
 }
 
@@ -1611,21 +2432,22 @@ bool_t phNxpEseProto7816_SoftReset(void *conn_ctx)
  ******************************************************************************/
 bool_t phNxpEseProto7816_ColdReset(void *conn_ctx)
 {
-    bool_t status                    = FALSE;
-    sFrameInfo_t *pNextTx_SframeInfo = &phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.SframeInfo;
-    phNxpEseRx_Cntx_t *pRx_EseCntx   = &phNxpEseProto7816_3_Var.phNxpEseRx_Cntx;
-
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_CurrentState        = PH_NXP_ESE_PROTO_7816_TRANSCEIVE;
-    phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = SFRAME;
-    pNextTx_SframeInfo->sFrameType                                = COLD_RESET_REQ;
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = SEND_S_COLD_RST;
-    pRx_EseCntx->pRsp                                             = NULL;
-    status                                                        = TransceiveProcess(conn_ctx);
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+    bool_t status                        = FALSE;
+    sFrameInfo_t *pNextTx_SframeInfo     = &pProto7816_Cntx->phNxpEseNextTx_Cntx.SframeInfo;
+    phNxpEseRx_Cntx_t *pRx_EseCntx       = &pProto7816_Cntx->phNxpEseRx_Cntx;
+
+    pProto7816_Cntx->phNxpEseProto7816_CurrentState        = PH_NXP_ESE_PROTO_7816_TRANSCEIVE;
+    pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = SFRAME;
+    pNextTx_SframeInfo->sFrameType                         = COLD_RESET_REQ;
+    pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = SEND_S_COLD_RST;
+    pRx_EseCntx->pRsp                                      = NULL;
+    status                                                 = TransceiveProcess(conn_ctx);
     if (FALSE == status) {
         /* reset all the structures */
         T_SMLOG_E("%s TransceiveProcess failed  ", __FUNCTION__);
     }
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_CurrentState = PH_NXP_ESE_PROTO_7816_IDLE;
+    pProto7816_Cntx->phNxpEseProto7816_CurrentState = PH_NXP_ESE_PROTO_7816_IDLE;
     return status;
 }
 #endif
@@ -1634,18 +2456,94 @@ bool_t phNxpEseProto7816_ColdReset(void *conn_ctx)
  *
  * Description      This function is used to set the max T=1 data send size
  *
+ * param[in]        void* conn_ctx
  * param[in]        uint16_t IFSC_Size
  *
  * Returns          Always return TRUE (1).
  *
  ******************************************************************************/
-bool_t phNxpEseProto7816_SetIfscSize(uint16_t IFSC_Size)
+bool_t phNxpEseProto7816_SetIfscSize(void *conn_ctx, uint16_t IFSC_Size)
+{
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+    iFrameInfo_t *pNextTx_IframeInfo     = &pProto7816_Cntx->phNxpEseNextTx_Cntx.IframeInfo;
+    if (IFSC_Size == 0) {
+        IFSC_Size = 1;
+    }
+    if (IFSC_Size > PH_PROTO_7816_IFS_MAX) {
+        IFSC_Size = PH_PROTO_7816_IFS_MAX;
+    }
+    pProto7816_Cntx->ifsc          = IFSC_Size;
+    pNextTx_IframeInfo->maxDataLen = IFSC_Size;
+    return TRUE;
+}
+
+/******************************************************************************
+ * Function         phNxpEseProto7816_GetIfs
+ *
+ * Description      This function is used to get the information field sizes
+ *                  in use on the connection
+ *
+ * param[in]        void* conn_ctx
+ * param[out]       uint16_t*: max. INF size sent to the ESE (IFSC)
+ * param[out]       uint16_t*: max. INF size received from the ESE (IFSD)
+ *
+ * Returns          On success return TRUE or else FALSE.
+ *
+ ******************************************************************************/
+bool_t phNxpEseProto7816_GetIfs(void *conn_ctx, uint16_t *pIfsc, uint16_t *pIfsd)
+{
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+
+    if ((pIfsc == NULL) || (pIfsd == NULL)) {
+        return FALSE;
+    }
+    *pIfsc = pProto7816_Cntx->ifsc;
+    *pIfsd = pProto7816_Cntx->ifsd;
+    return TRUE;
+}
+
+/******************************************************************************
+ * Function         phNxpEseProto7816_GetWtxInfo
+ *
+ * Description      This function is used to get the waiting time extensions
+ *                  requested by the ESE during the last transceive
+ *
+ * param[in]        void* conn_ctx
+ * param[out]       uint32_t*: number of S(WTX) requests
+ * param[out]       uint32_t*: time from the first S(WTX) request to the end of the transceive
+ *
+ * Returns          On success return TRUE or else FALSE.
+ *
+ ******************************************************************************/
+bool_t phNxpEseProto7816_GetWtxInfo(void *conn_ctx, uint32_t *pWtxCount, uint32_t *pWtxDurationUs)
 {
-    iFrameInfo_t *pNextTx_IframeInfo = &phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.IframeInfo;
-    pNextTx_IframeInfo->maxDataLen   = IFSC_Size;
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+
+    if ((pWtxCount == NULL) || (pWtxDurationUs == NULL)) {
+        return FALSE;
+    }
+    *pWtxCount      = pProto7816_Cntx->wtxCount;
+    *pWtxDurationUs = pProto7816_Cntx->wtxDurationUs;
     return TRUE;
 }
 
+/******************************************************************************
+ * Function         phNxpEseProto7816_IsTimedOut
+ *
+ * Description      This function tells if the last transceive was abandoned
+ *                  at its deadline
+ *
+ * param[in]        void* conn_ctx
+ *
+ * Returns          TRUE if the deadline was reached, else FALSE.
+ *
+ ******************************************************************************/
+bool_t phNxpEseProto7816_IsTimedOut(void *conn_ctx)
+{
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+    return pProto7816_Cntx->isTimedOut;
+}
+
 /******************************************************************************
  * Function         phNxpEseProto7816_WTXRsp
  *
@@ -1695,25 +2593,26 @@ bool_t phNxpEseProto7816_SendRSync(void *conn_ctx)
  ******************************************************************************/
 bool_t phNxpEseProto7816_GetAtr(void *conn_ctx, phNxpEse_data *pRsp)
 {
-    bool_t status                    = FALSE;
-    sFrameInfo_t *pNextTx_SframeInfo = &phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.SframeInfo;
-    phNxpEseRx_Cntx_t *pRx_EseCntx   = &phNxpEseProto7816_3_Var.phNxpEseRx_Cntx;
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+    bool_t status                        = FALSE;
+    sFrameInfo_t *pNextTx_SframeInfo     = &pProto7816_Cntx->phNxpEseNextTx_Cntx.SframeInfo;
+    phNxpEseRx_Cntx_t *pRx_EseCntx       = &pProto7816_Cntx->phNxpEseRx_Cntx;
 
     ENSURE_OR_GO_EXIT(pRsp != NULL);
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_CurrentState        = PH_NXP_ESE_PROTO_7816_TRANSCEIVE;
-    phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = SFRAME;
-    pNextTx_SframeInfo->sFrameType                                = ATR_REQ;
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = SEND_S_ATR;
-    pRx_EseCntx->pRsp                                             = pRsp;
-    pRx_EseCntx->pRsp->len                                        = pRsp->len;
-    pRx_EseCntx->responseBytesRcvd                                = 0;
-    status                                                        = TransceiveProcess(conn_ctx);
-    pRsp->len                                                     = pRx_EseCntx->responseBytesRcvd;
+    pProto7816_Cntx->phNxpEseProto7816_CurrentState        = PH_NXP_ESE_PROTO_7816_TRANSCEIVE;
+    pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = SFRAME;
+    pNextTx_SframeInfo->sFrameType                         = ATR_REQ;
+    pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = SEND_S_ATR;
+    pRx_EseCntx->pRsp                                      = pRsp;
+    pRx_EseCntx->pRsp->len                                 = pRsp->len;
+    pRx_EseCntx->responseBytesRcvd                         = 0;
+    status                                                 = TransceiveProcess(conn_ctx);
+    pRsp->len                                              = pRx_EseCntx->responseBytesRcvd;
     if (FALSE == status) {
         /* reset all the structures */
         T_SMLOG_E("%s TransceiveProcess failed  ", __FUNCTION__);
     }
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_CurrentState = PH_NXP_ESE_PROTO_7816_IDLE;
+    pProto7816_Cntx->phNxpEseProto7816_CurrentState = PH_NXP_ESE_PROTO_7816_IDLE;
 exit:
     return status;
 }
@@ -1732,26 +2631,27 @@ exit:
  ******************************************************************************/
 bool_t phNxpEseProto7816_GetCip(void *conn_ctx, phNxpEse_data *pRsp)
 {
-    bool_t status                    = FALSE;
-    phNxpEseRx_Cntx_t *pRx_EseCntx   = &phNxpEseProto7816_3_Var.phNxpEseRx_Cntx;
-    sFrameInfo_t *pNextTx_SframeInfo = &phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.SframeInfo;
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+    bool_t status                        = FALSE;
+    phNxpEseRx_Cntx_t *pRx_EseCntx       = &pProto7816_Cntx->phNxpEseRx_Cntx;
+    sFrameInfo_t *pNextTx_SframeInfo     = &pProto7816_Cntx->phNxpEseNextTx_Cntx.SframeInfo;
 
     ENSURE_OR_GO_EXIT(pRsp != NULL);
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_CurrentState        = PH_NXP_ESE_PROTO_7816_TRANSCEIVE;
-    phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = SFRAME;
-    pNextTx_SframeInfo->sFrameType                                = CIP_REQ;
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = SEND_S_CIP;
-    pRx_EseCntx->pRsp                                             = pRsp;
-    pRx_EseCntx->pRsp->len                                        = pRsp->len;
-    pRx_EseCntx->responseBytesRcvd                                = 0;
-    status                                                        = TransceiveProcess(conn_ctx);
-    pRsp->len                                                     = pRx_EseCntx->responseBytesRcvd;
+    pProto7816_Cntx->phNxpEseProto7816_CurrentState        = PH_NXP_ESE_PROTO_7816_TRANSCEIVE;
+    pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = SFRAME;
+    pNextTx_SframeInfo->sFrameType                         = CIP_REQ;
+    pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = SEND_S_CIP;
+    pRx_EseCntx->pRsp                                      = pRsp;
+    pRx_EseCntx->pRsp->len                                 = pRsp->len;
+    pRx_EseCntx->responseBytesRcvd                         = 0;
+    status                                                 = TransceiveProcess(conn_ctx);
+    pRsp->len                                              = pRx_EseCntx->responseBytesRcvd;
     if (FALSE == status) {
         /* reset all the structures */
         T_SMLOG_E("%s TransceiveProcess failed  ", __FUNCTION__);
     }
 
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_CurrentState = PH_NXP_ESE_PROTO_7816_IDLE;
+    pProto7816_Cntx->phNxpEseProto7816_CurrentState = PH_NXP_ESE_PROTO_7816_IDLE;
 exit:
     return status;
 }
@@ -1769,16 +2669,17 @@ exit:
  ******************************************************************************/
 bool_t phNxpEseProto7816_Deep_Pwr_Down(void *conn_ctx)
 {
-    bool_t status                    = FALSE;
-    sFrameInfo_t *pNextTx_SframeInfo = &phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.SframeInfo;
+    phNxpEseProto7816_t *pProto7816_Cntx = phNxpEseProto7816_GetCntx(conn_ctx);
+    bool_t status                        = FALSE;
+    sFrameInfo_t *pNextTx_SframeInfo     = &pProto7816_Cntx->phNxpEseNextTx_Cntx.SframeInfo;
 
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_CurrentState = PH_NXP_ESE_PROTO_7816_TRANSCEIVE;
+    pProto7816_Cntx->phNxpEseProto7816_CurrentState = PH_NXP_ESE_PROTO_7816_TRANSCEIVE;
     /* send the end of session s-frame */
-    phNxpEseProto7816_3_Var.phNxpEseNextTx_Cntx.FrameType         = SFRAME;
-    pNextTx_SframeInfo->sFrameType                                = DEEP_PWR_DOWN_REQ;
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_nextTransceiveState = SEND_DEEP_PWR_DOWN;
-    status                                                        = TransceiveProcess(conn_ctx);
-    phNxpEseProto7816_3_Var.phNxpEseProto7816_CurrentState        = PH_NXP_ESE_PROTO_7816_IDLE;
+    pProto7816_Cntx->phNxpEseNextTx_Cntx.FrameType         = SFRAME;
+    pNextTx_SframeInfo->sFrameType                         = DEEP_PWR_DOWN_REQ;
+    pProto7816_Cntx->phNxpEseProto7816_nextTransceiveState = SEND_DEEP_PWR_DOWN;
+    status                                                 = TransceiveProcess(conn_ctx);
+    pProto7816_Cntx->phNxpEseProto7816_CurrentState        = PH_NXP_ESE_PROTO_7816_IDLE;
     return status;
 }
 
@@ -15,7 +15,7 @@
  */
 #ifndef _PHNXPESEPROTO7816_3_H_
 #define _PHNXPESEPROTO7816_3_H_
-#include <phNxpEse_Internal.h>
+#include <phNxpEse_Api.h>
 
 /**
  * \addtogroup ISO7816-3_protocol_lib
@@ -104,6 +104,16 @@ typedef enum phNxpEseProto7816_State
     PH_NXP_ESE_PROTO_7816_DEINIT      /*!< 7816-3 protocol state: DeInit going on */
 } phNxpEseProto7816_State_t;
 
+/*!
+ * \brief Phases of an exchange driven by phNxpEseProto7816_Step
+ */
+typedef enum phNxpEseProto7816_StepPhase
+{
+    PH_NXP_ESE_PROTO_7816_PHASE_SEND,    /*!< Next frame to be sent, the exchange ends in IDLE_STATE */
+    PH_NXP_ESE_PROTO_7816_PHASE_RECEIVE, /*!< Waiting for the frame of the ESE */
+    PH_NXP_ESE_PROTO_7816_PHASE_DELAY    /*!< Waiting before the next frame, e.g. for error recovery */
+} phNxpEseProto7816_StepPhase_t;
+
 /*!
  * \brief 7816-3 protocol transceive states
  */
@@ -114,6 +124,7 @@ typedef enum phNxpEseProto7816_TransceiveStates
     SEND_R_NACK,  /*!< 7816-3 protocol transceive state: R-NACK frame to be sent */
     SEND_R_ACK,   /*!< 7816-3 protocol transceive state: R-ACK frame to be sent */
     SEND_S_RSYNC, /*!< 7816-3 protocol transceive state: S-frame re-synchronisation command to be sent */
+    SEND_S_IFS,   /*!< 7816-3 protocol transceive state: S-frame IFS request to be sent */
 #if defined(T1oI2C_UM11225)
     SEND_S_INTF_RST, /*!< 7816-3 protocol transceive state: S-frame interface reset command to be sent */
     SEND_S_EOS,      /*!< 7816-3 protocol transceive state: S-frame end of session command to be sent */
@@ -218,6 +229,8 @@ typedef struct phNxpEseRx_Cntx
     phNxpEseProto7816_FrameTypes_t lastRcvdFrameType; /*!< Last received frame type */
     phNxpEse_data *pRsp;
     size_t responseBytesRcvd;
+    bool_t isRspOverlappingCmd; /*!< Response buffer shares bytes with the C-APDU of the transceive */
+    bool_t isCmdOverwritten;    /*!< Response data was received over the C-APDU, it cannot be sent again */
 } phNxpEseRx_Cntx_t;
 
 /*!
@@ -245,6 +258,22 @@ typedef struct phNxpEseProto7816
         lastSentNonErrorframeType; /*!< Copy of the last sent non-error frame type: R-ACK, S-frame, I-frame */
     unsigned long int rnack_retry_limit;
     unsigned long int rnack_retry_counter;
+    uint16_t ifsc; /*!< Max. INF size of I-frames sent to the ESE (IFSC), from the ATR/CIP */
+    uint16_t ifsd; /*!< Max. INF size of I-frames received from the ESE (IFSD), agreed with S(IFS) */
+    phNxpEseProto7816_StepPhase_t stepPhase; /*!< Phase of the exchange driven by phNxpEseProto7816_Step */
+    bool_t stepStatus;                       /*!< Result of the last frame processed in the exchange */
+    uint32_t stepDelayUs;                    /*!< Delay requested before the next frame is sent */
+    uint64_t stepDeadlineUs;                 /*!< End of PH_NXP_ESE_PROTO_7816_PHASE_DELAY */
+    uint64_t stepTxUs;                       /*!< Time the last frame of the exchange was sent */
+    uint32_t wtxCount;                       /*!< S(WTX) requests received in the exchange */
+    uint64_t wtxFirstUs;                     /*!< Time of the first S(WTX) request of the exchange */
+    uint32_t wtxDurationUs;                  /*!< Time from the first S(WTX) request to the end of the exchange */
+    uint32_t wtxPollUs;                      /*!< Poll interval while the ESE works on an S(WTX) extension */
+    bool_t isTimedOut;                       /*!< The exchange was abandoned at its deadline */
+    bool_t isResyncRequired;                 /*!< An exchange was abandoned, S(RESYNCH) before the next one */
+    bool_t isResyncFirst;                    /*!< The exchange starts with S(RESYNCH), then sends the C-APDU */
+    uint64_t phaseStartUs;                   /*!< Start of the current step phase */
+    uint64_t *pPhaseTimeUs;                  /*!< Time counter (phNxpEse_Stats_t) of the current step phase, or NULL */
 } phNxpEseProto7816_t;
 
 /*!
@@ -260,19 +289,46 @@ typedef struct phNxpEseProto7816InitParam
     unsigned long int rnack_retry_limit;
 } phNxpEseProto7816InitParam_t;
 
-/*!
- * \brief 7816_3 protocol stack instance
- */
-//phNxpEseProto7816_t phNxpEseProto7816_3_Var;
-
 /*!
  * \brief Max. size of the frame that can be sent
  */
 #define IFSC_SIZE_SEND 254
+/*!
+ * \brief Max. INF size supported by the host in both directions. Bound by the LEN field
+ * and the frame buffers, one spare byte for a frame read with a leading byte.
+ */
+#if defined(T1oI2C_UM11225)
+#define PH_PROTO_7816_IFS_MAX IFSC_SIZE_SEND
+#elif defined(T1oI2C_GP1_0)
+#define PH_PROTO_7816_IFS_MAX (MAX_APDU_BUFFER - PH_PROTO_7816_HEADER_LEN - PH_PROTO_7816_CRC_LEN - 1)
+#endif
+/*!
+ * \brief Size of the IFS value in the INF field of S(IFS), same as the LEN field
+ */
+#if defined(T1oI2C_UM11225)
+#define PH_PROTO_7816_IFS_LEN 1
+#elif defined(T1oI2C_GP1_0)
+#define PH_PROTO_7816_IFS_LEN 2
+#endif
 /*!
  * \brief Delay to be used before sending the next frame, after error reported by ESE
  */
 #define DELAY_ERROR_RECOVERY 3500
+/*!
+ * \brief Poll interval while the ESE works on an S(WTX) extension, in microseconds:
+ * the time the ESE took to request it divided by PH_PROTO_7816_WTX_POLL_DIVIDER, within the limits
+ */
+#define PH_PROTO_7816_WTX_POLL_DIVIDER 4
+#define PH_PROTO_7816_WTX_POLL_MIN_US 1000
+#define PH_PROTO_7816_WTX_POLL_MAX_US 50000
+/*!
+ * \brief Time budget in microseconds a recovery step is expected to need, including the delay
+ * before it. A step is not started when less time is left until the deadline of the exchange.
+ */
+#define PH_PROTO_7816_RNACK_COST_US (DELAY_ERROR_RECOVERY + 5000)
+#define PH_PROTO_7816_RESYNC_COST_US (DELAY_ERROR_RECOVERY + 5000)
+#define PH_PROTO_7816_INTF_RESET_COST_US (100000)
+#define PH_PROTO_7816_CHIP_RESET_COST_US (500000)
 /*!
  * \brief 7816-3 protocol frame header length
  */
@@ -369,6 +425,10 @@ typedef struct phNxpEseProto7816InitParam
  * \brief 7816-3 S-block get CIP cmd mask
  */
 #define PH_PROTO_7816_S_GET_CIP 0x04
+/*!
+ * \brief 7816-3 S-block IFS cmd mask
+ */
+#define PH_PROTO_7816_S_IFS 0x01
 
 /* T=1 protocol Block format for T1oI2C UM11225_SE050
  ___________________________________________________________________________________________________
@@ -421,9 +481,15 @@ bool_t phNxpEseProto7816_ChipReset(void *conn_ctx);
 bool_t phNxpEseProto7816_Close(void *conn_ctx);
 bool_t phNxpEseProto7816_Open(void *conn_ctx, phNxpEseProto7816InitParam_t initParam, phNxpEse_data *AtrRsp);
 bool_t phNxpEseProto7816_Transceive(void *conn_ctx, phNxpEse_data *pCmd, phNxpEse_data *pRsp);
-bool_t phNxpEseProto7816_Reset(void);
-bool_t phNxpEseProto7816_SetIfscSize(uint16_t IFSC_Size);
-bool_t phNxpEseProto7816_ResetProtoParams(void);
+bool_t phNxpEseProto7816_TransceiveStart(void *conn_ctx, phNxpEse_data *pCmd, phNxpEse_data *pRsp);
+phNxpEse_StepResult phNxpEseProto7816_Step(void *conn_ctx, phNxpEse_StepEvent event, uint32_t *pWaitUs);
+bool_t phNxpEseProto7816_TransceiveEnd(void *conn_ctx, phNxpEse_data *pRsp);
+bool_t phNxpEseProto7816_Reset(void *conn_ctx);
+bool_t phNxpEseProto7816_SetIfscSize(void *conn_ctx, uint16_t IFSC_Size);
+bool_t phNxpEseProto7816_GetIfs(void *conn_ctx, uint16_t *pIfsc, uint16_t *pIfsd);
+bool_t phNxpEseProto7816_GetWtxInfo(void *conn_ctx, uint32_t *pWtxCount, uint32_t *pWtxDurationUs);
+bool_t phNxpEseProto7816_IsTimedOut(void *conn_ctx);
+bool_t phNxpEseProto7816_ResetProtoParams(void *conn_ctx);
 #if defined(T1oI2C_GP1_0)
 bool_t phNxpEseProto7816_SoftReset(void *conn_ctx);
 bool_t phNxpEseProto7816_GetCip(void *conn_ctx, phNxpEse_data *pRsp);
@@ -15,6 +15,7 @@
  */
 #include <phEseTypes.h>
 #include <phNxpEseProto7816_3.h>
+#include <phNxpEse_Internal.h>
 #include <phNxpEsePal_i2c.h>
 #include "sm_timer.h"
 #include "se05x_tlv.h"
@@ -25,8 +26,25 @@
 #define CHAINED_PACKET_WITHSEQN 0x60
 #define CHAINED_PACKET_WITHOUTSEQN 0x20
 #define WTX_REQ_ID 0xC3
-static int phNxpEse_readPacket(void *conn_ctx, void *pDevHandle, uint8_t *pBuffer, int nNbBytesToRead);
-static int poll_sof_chained_delay = 0;
+/* Speculative read of a complete frame: optional leading byte, header, max information field and CRC */
+#define ESE_FRAME_READ_MAX_LEN (1 + PH_PROTO_7816_HEADER_LEN + IFSC_SIZE_SEND + PH_PROTO_7816_CRC_LEN)
+
+static int phNxpEse_pollPacket(
+    phNxpEse_Context_t *nxpese_ctxt, void *pDevHandle, uint8_t *pBuffer, int nNbBytesToRead, uint32_t *pWaitUs);
+static int phNxpEse_readFrame(
+    phNxpEse_Context_t *nxpese_ctxt, void *pDevHandle, uint8_t *pBuffer, int nNbBytesToRead);
+static uint32_t phNxpEse_getExpectedLatency(phNxpEse_Context_t *nxpese_ctxt);
+static void phNxpEse_updateLatencyModel(phNxpEse_Context_t *nxpese_ctxt);
+static ESESTATUS phNxpEse_claimStaticContext(bool_t *pClaimed);
+static ESESTATUS phNxpEse_clearStaticContext(void);
+static void phNxpEse_releaseContext(phNxpEse_Context_t *nxpese_ctxt);
+static ESESTATUS phNxpEse_checkTransceive(phNxpEse_Context_t *nxpese_ctxt, phNxpEse_data *pCmd, phNxpEse_data *pRsp);
+static ESESTATUS phNxpEse_endTransceive(phNxpEse_Context_t *nxpese_ctxt, bool_t bStatus);
+static void phNxpEse_tapFrame(phNxpEse_Context_t *nxpese_ctxt,
+    phPalEse_TapDirection direction,
+    uint64_t startNs,
+    const phPalEse_IoVec_t *pIov,
+    uint8_t iovCnt);
 
 /* Duration for which session open should wait for previous transaction to complete */
 #define T1OI2C_WAIT_FOR_PREV_TXN 40
@@ -35,6 +53,8 @@ static int poll_sof_chained_delay = 0;
 
 /* ESE Context structure */
 phNxpEse_Context_t gnxpese_ctxt;
+/* Guards the claim and release of gnxpese_ctxt */
+SM_MUTEX_DEFINE(gnxpese_ctxt_lock);
 
 /******************************************************************************
  * Function         phNxpEse_init
@@ -101,23 +121,34 @@ ESESTATUS phNxpEse_open(void **conn_ctx, phNxpEse_initParams initParams, const c
     phPalEse_Config_t tPalConfig;
     phNxpEse_Context_t *pnxpese_ctxt = NULL;
     ESESTATUS wConfigStatus          = ESESTATUS_SUCCESS;
+    bool_t isStaticCtx               = FALSE;
 
-    pnxpese_ctxt = &gnxpese_ctxt;
-    phNxpEse_memset(pnxpese_ctxt, 0, sizeof(phNxpEse_Context_t));
-    if (conn_ctx != NULL) {
-        *conn_ctx = pnxpese_ctxt;
+    /* The first connection uses the static context (also used when NULL context is passed to the other APIs).
+     * Every further parallel connection gets its own context. */
+    if (phNxpEse_claimStaticContext(&isStaticCtx) != ESESTATUS_SUCCESS) {
+        T_SMLOG_E(" Failed to claim connection context");
+        return ESESTATUS_FAILED;
     }
-
-    /*When I2C channel is already opened return status as FAILED*/
-    if (pnxpese_ctxt->EseLibStatus != ESE_STATUS_CLOSE) {
-        T_SMLOG_E(" Session already opened");
-        return ESESTATUS_BUSY;
+    if (isStaticCtx) {
+        pnxpese_ctxt = &gnxpese_ctxt;
+    }
+    else {
+        if (conn_ctx == NULL) {
+            T_SMLOG_E(" Session already opened");
+            return ESESTATUS_BUSY;
+        }
+        pnxpese_ctxt = (phNxpEse_Context_t *)phNxpEse_memalloc(sizeof(phNxpEse_Context_t));
+        if (pnxpese_ctxt == NULL) {
+            T_SMLOG_E(" Failed to allocate connection context");
+            return ESESTATUS_INSUFFICIENT_RESOURCES;
+        }
+        phNxpEse_memset(pnxpese_ctxt, 0x00, sizeof(phNxpEse_Context_t));
+        pnxpese_ctxt->isDynamicCtx = TRUE;
     }
 
-    phNxpEse_memset(pnxpese_ctxt, 0x00, sizeof(phNxpEse_Context_t));
     phNxpEse_memset(&tPalConfig, 0x00, sizeof(tPalConfig));
 
-    tPalConfig.pDevName = (int8_t *)pConnString; //"/dev/p73"; /*RFU*/
+    tPalConfig.pDevName = (int8_t *)pConnString; //"/dev/i2c-1[:0x48]"
     /* Initialize PAL layer */
     wConfigStatus = phPalEse_i2c_open_and_configure(&tPalConfig);
     if (wConfigStatus != ESESTATUS_SUCCESS) {
@@ -126,39 +157,41 @@ ESESTATUS phNxpEse_open(void **conn_ctx, phNxpEse_initParams initParams, const c
     }
     /* Copying device handle to ESE Lib context*/
     pnxpese_ctxt->pDevHandle = tPalConfig.pDevHandle;
+    phPalEse_i2c_set_busy_poll(pnxpese_ctxt->pDevHandle, (initParams.pollMode == ESE_POLL_BUSY) ? TRUE : FALSE);
     /* STATUS_OPEN */
     pnxpese_ctxt->EseLibStatus = ESE_STATUS_OPEN;
     phNxpEse_memcpy(&pnxpese_ctxt->initParams, &initParams, sizeof(phNxpEse_initParams));
+    if (conn_ctx != NULL) {
+        *conn_ctx = pnxpese_ctxt;
+    }
     return wConfigStatus;
 
 clean_and_return:
     if (NULL != pnxpese_ctxt->pDevHandle) {
         phPalEse_i2c_close(pnxpese_ctxt->pDevHandle);
-        phNxpEse_memset(pnxpese_ctxt, 0x00, sizeof(phNxpEse_Context_t));
     }
-    pnxpese_ctxt->EseLibStatus = ESE_STATUS_CLOSE;
+    phNxpEse_releaseContext(pnxpese_ctxt);
+    if (conn_ctx != NULL) {
+        *conn_ctx = NULL;
+    }
     return ESESTATUS_FAILED;
 }
 
 /******************************************************************************
- * Function         phNxpEse_Transceive
+ * Function         phNxpEse_checkTransceive
  *
  * Description      This function validate ESE state & C-APDU data before sending
  *                  it to 7816 protocol
  *
  * param[in]       connection context
  * param[in]       phNxpEse_data: Command to ESE C-APDU
- * param[out]      phNxpEse_data: Response from ESE R-APDU
+ * param[in]       phNxpEse_data: Response from ESE R-APDU
  *
  * Returns          On Success ESESTATUS_SUCCESS else proper error code
  *
  ******************************************************************************/
-ESESTATUS phNxpEse_Transceive(void *conn_ctx, phNxpEse_data *pCmd, phNxpEse_data *pRsp)
+static ESESTATUS phNxpEse_checkTransceive(phNxpEse_Context_t *nxpese_ctxt, phNxpEse_data *pCmd, phNxpEse_data *pRsp)
 {
-    ESESTATUS status                = ESESTATUS_FAILED;
-    bool_t bStatus                  = FALSE;
-    phNxpEse_Context_t *nxpese_ctxt = (conn_ctx == NULL) ? &gnxpese_ctxt : (phNxpEse_Context_t *)conn_ctx;
-
     if ((NULL == pCmd) || (NULL == pRsp)) {
         return ESESTATUS_INVALID_PARAMETER;
     }
@@ -175,26 +208,174 @@ ESESTATUS phNxpEse_Transceive(void *conn_ctx, phNxpEse_data *pCmd, phNxpEse_data
         T_SMLOG_E(" %s ESE - BUSY ", __FUNCTION__);
         return ESESTATUS_BUSY;
     }
-    else {
-        nxpese_ctxt->EseLibStatus = ESE_STATUS_BUSY;
-        bStatus                   = phNxpEseProto7816_Transceive((void *)nxpese_ctxt, pCmd, pRsp);
-        if (TRUE == bStatus) {
-            status = ESESTATUS_SUCCESS;
-        }
-        else {
-            status = ESESTATUS_FAILED;
-        }
+    return ESESTATUS_SUCCESS;
+}
 
-        if (ESESTATUS_SUCCESS != status) {
-            T_SMLOG_E(" %s phNxpEseProto7816_Transceive- Failed ", __FUNCTION__);
-        }
-        if (nxpese_ctxt->EseLibStatus != ESE_STATUS_CLOSE) {
-            nxpese_ctxt->EseLibStatus = ESE_STATUS_IDLE;
-        }
+/******************************************************************************
+ * Function         phNxpEse_endTransceive
+ *
+ * Description      This function releases the ESE after a transceive
+ *
+ * param[in]       connection context
+ * param[in]       bool_t: Result of the 7816 protocol
+ *
+ * Returns          On Success ESESTATUS_SUCCESS, ESESTATUS_RESPONSE_TIMEOUT if the
+ *                  deadline was reached, else ESESTATUS_FAILED
+ *
+ ******************************************************************************/
+static ESESTATUS phNxpEse_endTransceive(phNxpEse_Context_t *nxpese_ctxt, bool_t bStatus)
+{
+    ESESTATUS status = (TRUE == bStatus) ? ESESTATUS_SUCCESS : ESESTATUS_FAILED;
+
+    if ((FALSE == bStatus) && (TRUE == phNxpEseProto7816_IsTimedOut((void *)nxpese_ctxt))) {
+        status = ESESTATUS_RESPONSE_TIMEOUT;
+    }
+    nxpese_ctxt->stats.transceives++;
+    if (ESESTATUS_SUCCESS != status) {
+        nxpese_ctxt->stats.failures++;
+    }
+    if (ESESTATUS_RESPONSE_TIMEOUT == status) {
+        nxpese_ctxt->stats.timeouts++;
+    }
+    nxpese_ctxt->lastWtx.cmdKey = nxpese_ctxt->latencyModel.cmdKey;
+    if (FALSE == phNxpEseProto7816_GetWtxInfo(
+                     (void *)nxpese_ctxt, &nxpese_ctxt->lastWtx.count, &nxpese_ctxt->lastWtx.durationUs)) {
+        nxpese_ctxt->lastWtx.count      = 0;
+        nxpese_ctxt->lastWtx.durationUs = 0;
+    }
+    if (nxpese_ctxt->lastWtx.count > 0) {
+        T_SMLOG_D(" %s %u S(WTX) requests, %u us ",
+            __FUNCTION__,
+            nxpese_ctxt->lastWtx.count,
+            nxpese_ctxt->lastWtx.durationUs);
+    }
+    /* The command key, room and deadline set by phNxpEse_setCmdKey / phNxpEse_setTxRoom /
+     * phNxpEse_setDeadline apply to this transceive only */
+    nxpese_ctxt->latencyModel.cmdKey = PH_NXP_ESE_CMD_KEY_NONE;
+    nxpese_ctxt->txHeadroom          = 0;
+    nxpese_ctxt->txTailroom          = 0;
+    nxpese_ctxt->pStepRsp            = NULL;
+    nxpese_ctxt->deadlineUs          = 0;
+
+    if (ESESTATUS_SUCCESS != status) {
+        T_SMLOG_E(" %s phNxpEseProto7816_Transceive- Failed ", __FUNCTION__);
+    }
+    if (nxpese_ctxt->EseLibStatus != ESE_STATUS_CLOSE) {
+        nxpese_ctxt->EseLibStatus = ESE_STATUS_IDLE;
+    }
+
+    T_SMLOG_D(" %s Exit status 0x%x ", __FUNCTION__, status);
+    return status;
+}
+
+/******************************************************************************
+ * Function         phNxpEse_Transceive
+ *
+ * Description      This function validate ESE state & C-APDU data before sending
+ *                  it to 7816 protocol
+ *
+ * param[in]       connection context
+ * param[in]       phNxpEse_data: Command to ESE C-APDU
+ * param[out]      phNxpEse_data: Response from ESE R-APDU
+ *
+ * Returns          On Success ESESTATUS_SUCCESS else proper error code
+ *
+ ******************************************************************************/
+ESESTATUS phNxpEse_Transceive(void *conn_ctx, phNxpEse_data *pCmd, phNxpEse_data *pRsp)
+{
+    ESESTATUS status                = ESESTATUS_FAILED;
+    bool_t bStatus                  = FALSE;
+    phNxpEse_Context_t *nxpese_ctxt = (conn_ctx == NULL) ? &gnxpese_ctxt : (phNxpEse_Context_t *)conn_ctx;
+
+    status = phNxpEse_checkTransceive(nxpese_ctxt, pCmd, pRsp);
+    if (ESESTATUS_SUCCESS != status) {
+        return status;
+    }
+    nxpese_ctxt->EseLibStatus = ESE_STATUS_BUSY;
+    bStatus                   = phNxpEseProto7816_Transceive((void *)nxpese_ctxt, pCmd, pRsp);
+    return phNxpEse_endTransceive(nxpese_ctxt, bStatus);
+}
+
+/******************************************************************************
+ * Function         phNxpEse_TransceiveStart
+ *
+ * Description      This function starts a non-blocking transceive. The exchange
+ *                  is driven by calling phNxpEse_TransceiveStep until it returns
+ *                  ESE_STEP_DONE or ESE_STEP_FAILED; the ESE stays busy until then.
+ *                  pCmd and pRsp must stay valid until the exchange is complete.
+ *
+ * param[in]       connection context
+ * param[in]       phNxpEse_data: Command to ESE C-APDU
+ * param[out]      phNxpEse_data: Response from ESE R-APDU
+ *
+ * Returns          On Success ESESTATUS_SUCCESS else proper error code
+ *
+ ******************************************************************************/
+ESESTATUS phNxpEse_TransceiveStart(void *conn_ctx, phNxpEse_data *pCmd, phNxpEse_data *pRsp)
+{
+    ESESTATUS status                = ESESTATUS_FAILED;
+    phNxpEse_Context_t *nxpese_ctxt = (conn_ctx == NULL) ? &gnxpese_ctxt : (phNxpEse_Context_t *)conn_ctx;
 
-        T_SMLOG_D(" %s Exit status 0x%x ", __FUNCTION__, status);
+    status = phNxpEse_checkTransceive(nxpese_ctxt, pCmd, pRsp);
+    if (ESESTATUS_SUCCESS != status) {
         return status;
     }
+    nxpese_ctxt->EseLibStatus = ESE_STATUS_BUSY;
+    if (FALSE == phNxpEseProto7816_TransceiveStart((void *)nxpese_ctxt, pCmd, pRsp)) {
+        return phNxpEse_endTransceive(nxpese_ctxt, FALSE);
+    }
+    nxpese_ctxt->pStepRsp = pRsp;
+    return ESESTATUS_SUCCESS;
+}
+
+/******************************************************************************
+ * Function         phNxpEse_TransceiveStep
+ *
+ * Description      This function advances the transceive started with
+ *                  phNxpEse_TransceiveStart without waiting for the ESE. Frames
+ *                  are written and read within the call. When the exchange has
+ *                  to wait, the caller steps again after *pWaitUs microseconds,
+ *                  or earlier with ESE_STEP_EVT_READABLE once the ESE signals
+ *                  data for ESE_STEP_WAIT_READABLE. ESE_STEP_WAIT_WTX tells that
+ *                  the ESE asked for more time (S(WTX)); the wait is longer and
+ *                  other work can be scheduled meanwhile.
+ *
+ * param[in]       connection context
+ * param[in]       phNxpEse_StepEvent: Reason of the step
+ * param[out]      uint32_t*: Time to wait in microseconds
+ *
+ * Returns          ESE_STEP_DONE / ESE_STEP_FAILED / ESE_STEP_TIMEOUT when the transceive
+ *                  is complete (pRsp holds the R-APDU on ESE_STEP_DONE), else
+ *                  ESE_STEP_WAIT_TIME, ESE_STEP_WAIT_READABLE or ESE_STEP_WAIT_WTX
+ *
+ ******************************************************************************/
+phNxpEse_StepResult phNxpEse_TransceiveStep(void *conn_ctx, phNxpEse_StepEvent event, uint32_t *pWaitUs)
+{
+    phNxpEse_StepResult result      = ESE_STEP_FAILED;
+    ESESTATUS status                = ESESTATUS_FAILED;
+    bool_t bStatus                  = FALSE;
+    phNxpEse_Context_t *nxpese_ctxt = (conn_ctx == NULL) ? &gnxpese_ctxt : (phNxpEse_Context_t *)conn_ctx;
+
+    if ((pWaitUs == NULL) || (nxpese_ctxt->pStepRsp == NULL)) {
+        T_SMLOG_E(" %s No transceive started ", __FUNCTION__);
+        return ESE_STEP_FAILED;
+    }
+    result = phNxpEseProto7816_Step((void *)nxpese_ctxt, event, pWaitUs);
+    if ((result == ESE_STEP_WAIT_TIME) || (result == ESE_STEP_WAIT_READABLE) || (result == ESE_STEP_WAIT_WTX)) {
+        return result;
+    }
+    bStatus = (result == ESE_STEP_DONE) ? TRUE : FALSE;
+    if (FALSE == phNxpEseProto7816_TransceiveEnd((void *)nxpese_ctxt, nxpese_ctxt->pStepRsp)) {
+        bStatus = FALSE;
+    }
+    status = phNxpEse_endTransceive(nxpese_ctxt, bStatus);
+    if (ESESTATUS_RESPONSE_TIMEOUT == status) {
+        return ESE_STEP_TIMEOUT;
+    }
+    if (ESESTATUS_SUCCESS != status) {
+        return ESE_STEP_FAILED;
+    }
+    return ESE_STEP_DONE;
 }
 
 /******************************************************************************
@@ -256,7 +437,7 @@ ESESTATUS phNxpEse_chipReset(void *conn_ctx)
     ESESTATUS status                = ESESTATUS_SUCCESS;
     bool_t bStatus                  = FALSE;
     phNxpEse_Context_t *nxpese_ctxt = (conn_ctx == NULL) ? &gnxpese_ctxt : (phNxpEse_Context_t *)conn_ctx;
-    bStatus                         = phNxpEseProto7816_Reset();
+    bStatus                         = phNxpEseProto7816_Reset((void *)nxpese_ctxt);
     if (!bStatus) {
         status = ESESTATUS_FAILED;
         T_SMLOG_E("phNxpEseProto7816_Reset Failed");
@@ -293,7 +474,7 @@ ESESTATUS phNxpEse_deInit(void *conn_ctx)
         status = ESESTATUS_FAILED;
     }*/
     phPalEse_i2c_close(nxpese_ctxt->pDevHandle);
-    phNxpEse_memset(nxpese_ctxt, 0x00, sizeof(*nxpese_ctxt));
+    phNxpEse_releaseContext(nxpese_ctxt);
     //status= phNxpEse_close();
     return status;
 }
@@ -320,12 +501,85 @@ ESESTATUS phNxpEse_close(void *conn_ctx)
     }
 
     phPalEse_i2c_close(nxpese_ctxt->pDevHandle);
-    phNxpEse_memset(nxpese_ctxt, 0x00, sizeof(*nxpese_ctxt));
+    phNxpEse_releaseContext(nxpese_ctxt);
     T_SMLOG_D("phNxpEse_close - ESE Context deinit completed");
     /* Return success always */
     return status;
 }
 
+/******************************************************************************
+ * Function         phNxpEse_claimStaticContext
+ *
+ * Description      This function claims the static context if no connection
+ *                  uses it. The claim is made before the PAL is opened, so
+ *                  concurrent opens never share the static context.
+ *
+ * param[out]       bool_t*: TRUE if the static context was claimed
+ *
+ * Returns          On Success ESESTATUS_SUCCESS else proper error code.
+ *
+ ******************************************************************************/
+static ESESTATUS phNxpEse_claimStaticContext(bool_t *pClaimed)
+{
+    SM_MUTEX_LOCK(gnxpese_ctxt_lock);
+    *pClaimed = FALSE;
+    if (gnxpese_ctxt.EseLibStatus == ESE_STATUS_CLOSE) {
+        phNxpEse_memset(&gnxpese_ctxt, 0x00, sizeof(gnxpese_ctxt));
+        /* Marks the context as claimed until the PAL is opened or the open fails */
+        gnxpese_ctxt.EseLibStatus = ESE_STATUS_OPEN;
+        *pClaimed                 = TRUE;
+    }
+    SM_MUTEX_UNLOCK(gnxpese_ctxt_lock);
+    return ESESTATUS_SUCCESS;
+}
+
+/******************************************************************************
+ * Function         phNxpEse_clearStaticContext
+ *
+ * Description      This function clears the static context, making it free
+ *                  for the next phNxpEse_open.
+ *
+ * Returns          On Success ESESTATUS_SUCCESS else proper error code.
+ *
+ ******************************************************************************/
+static ESESTATUS phNxpEse_clearStaticContext(void)
+{
+    SM_MUTEX_LOCK(gnxpese_ctxt_lock);
+    phNxpEse_memset(&gnxpese_ctxt, 0x00, sizeof(gnxpese_ctxt));
+    SM_MUTEX_UNLOCK(gnxpese_ctxt_lock);
+    return ESESTATUS_SUCCESS;
+}
+
+/******************************************************************************
+ * Function         phNxpEse_releaseContext
+ *
+ * Description      This function clears the connection context. Context allocated
+ *                  by phNxpEse_open for additional connections is freed.
+ *
+ * param[in]        phNxpEse_Context_t*: connection context
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void phNxpEse_releaseContext(phNxpEse_Context_t *nxpese_ctxt)
+{
+    bool_t isDynamicCtx = nxpese_ctxt->isDynamicCtx;
+    if (nxpese_ctxt->readyNotifier.release != NULL) {
+        nxpese_ctxt->readyNotifier.release(nxpese_ctxt->readyNotifier.pNotifierCtx);
+    }
+    if (nxpese_ctxt->frameTap.release != NULL) {
+        nxpese_ctxt->frameTap.release(nxpese_ctxt->frameTap.pTapCtx);
+    }
+    if (isDynamicCtx) {
+        phNxpEse_memset(nxpese_ctxt, 0x00, sizeof(*nxpese_ctxt));
+        phNxpEse_free(nxpese_ctxt);
+    }
+    else if (phNxpEse_clearStaticContext() != ESESTATUS_SUCCESS) {
+        T_SMLOG_E(" Failed to release connection context");
+    }
+    return;
+}
+
 /******************************************************************************
  * Function         phNxpEse_waitWTX
  *
@@ -446,8 +700,8 @@ void phNxpEse_clearReadBuffer(void *conn_ctx)
 /******************************************************************************
  * Function         phNxpEse_read
  *
- * Description      This function read the data from ESE through physical
- *                  interface (e.g. I2C) using the  driver interface.
+ * Description      This function reads a frame from the ESE. Polls until the
+ *                  frame is available, waiting between the polls.
  *
  * param[in]        void*: connection context
  * param[out]       uint32_t: number of bytes read
@@ -460,198 +714,601 @@ void phNxpEse_clearReadBuffer(void *conn_ctx)
 ESESTATUS phNxpEse_read(void *conn_ctx, uint32_t *data_len, uint8_t **pp_data)
 {
     ESESTATUS status                = ESESTATUS_FAILED;
-    int ret                         = -1;
+    uint32_t waitUs                 = 0;
     phNxpEse_Context_t *nxpese_ctxt = (conn_ctx == NULL) ? &gnxpese_ctxt : (phNxpEse_Context_t *)conn_ctx;
 
     T_SMLOG_D("%s Enter ..", __FUNCTION__);
 
-    ENSURE_OR_GO_EXIT(data_len != NULL);
-    ENSURE_OR_GO_EXIT(pp_data != NULL);
-
-    ret = phNxpEse_readPacket((void *)nxpese_ctxt, nxpese_ctxt->pDevHandle, nxpese_ctxt->p_read_buff, MAX_APDU_BUFFER);
-    if (ret < 0) {
-        T_SMLOG_E("PAL Read status error status = %x", status);
-        status = ESESTATUS_FAILED;
-    }
-    else {
-        T_SMLOG_MAU8_D("RAW Rx<", nxpese_ctxt->p_read_buff, ret);
-        *data_len = ret;
-        *pp_data  = nxpese_ctxt->p_read_buff;
-        status    = ESESTATUS_SUCCESS;
+    status = phNxpEse_startRead((void *)nxpese_ctxt, &waitUs);
+    if (status != ESESTATUS_SUCCESS) {
+        return ESESTATUS_FAILED;
     }
-exit:
+    do {
+        phNxpEse_waitForData((void *)nxpese_ctxt, waitUs);
+        status = phNxpEse_tryRead((void *)nxpese_ctxt, data_len, pp_data, &waitUs);
+    } while (status == ESESTATUS_PENDING);
     return status;
 }
 
 /******************************************************************************
- * Function         phNxpEse_readPacket
+ * Function         phNxpEse_startRead
  *
- * Description      This function Reads requested number of bytes from
- *                  ESE device into given buffer.
+ * Description      This function prepares reading the next frame from the ESE
+ *                  with phNxpEse_tryRead, without blocking.
  *
  * param[in]        void*: connection context
- * param[in]        void: ESE Context
- * param[in]        uint8_t: pointer to read buffer
- * param[in]        int : MAX bytes to read
+ * param[out]       uint32_t*: time to wait before the first phNxpEse_tryRead, in microseconds
  *
- * Returns          ret - number of successfully read bytes
- *                  -1  - read operation failure
+ * Returns          On Success ESESTATUS_SUCCESS else proper error code.
  *
  ******************************************************************************/
-static int phNxpEse_readPacket(void *conn_ctx, void *pDevHandle, uint8_t *pBuffer, int nNbBytesToRead)
+ESESTATUS phNxpEse_startRead(void *conn_ctx, uint32_t *pWaitUs)
 {
-    int ret         = -1;
-    int sof_counter = 0; /* one read may take 1 ms*/
-    int total_count = 0, numBytesToRead = 0, headerIndex = 0;
     phNxpEse_Context_t *nxpese_ctxt = (conn_ctx == NULL) ? &gnxpese_ctxt : (phNxpEse_Context_t *)conn_ctx;
 
-    ENSURE_OR_GO_EXIT(pBuffer != NULL);
-    memset(pBuffer, 0, nNbBytesToRead);
-    do {
-        sof_counter++;
-        ret = -1;
-        sm_sleep(ESE_POLL_DELAY_MS);                     /* 1ms delay to give ESE polling delay */
-        ret = phPalEse_i2c_read(pDevHandle, pBuffer, 2); /*read NAD PCB byte first*/
-        if (ret < 0) {
-            /*Polling for read on i2c, hence Debug log*/
-            T_SMLOG_D("_i2c_read() ret : %X", ret);
-        }
-        if (pBuffer[0] == RECIEVE_PACKET_SOF) {
-            /* Read the HEADR of Two bytes*/
-            T_SMLOG_D("%s Read HDR", __FUNCTION__);
-            pBuffer[0] = RECIEVE_PACKET_SOF;
-#if defined(T1oI2C_UM11225)
-            numBytesToRead = 1;
-#elif defined(T1oI2C_GP1_0)
-            numBytesToRead = 2;
-#endif
-            headerIndex = 1;
-            break;
-        }
-        if (pBuffer[1] == RECIEVE_PACKET_SOF) {
-            /* Read the HEADR of Two bytes*/
-            T_SMLOG_D("%s Read HDR", __FUNCTION__);
-            pBuffer[0] = RECIEVE_PACKET_SOF;
-#if defined(T1oI2C_UM11225)
-            numBytesToRead = 2;
-#elif defined(T1oI2C_GP1_0)
-            numBytesToRead = 3;
-#endif
-            headerIndex = 0;
-            break;
-        }
-        /*if host writes invalid frame and host and SE are out of sync*/
-        if ((pBuffer[0] == 0x00) && ((pBuffer[1] == 0x82) || (pBuffer[1] == 0x92))) {
-            T_SMLOG_W("%s Recieved NAD byte 0x%x ", __FUNCTION__, pBuffer[0]);
-            T_SMLOG_W("%s NAD error, clearing the read buffer ", __FUNCTION__);
-            /*retry to get all data*/
-#if defined(T1oI2C_UM11225)
-            numBytesToRead = 1;
-#elif defined(T1oI2C_GP1_0)
-            numBytesToRead = 2;
-#endif
-            headerIndex = 1;
-            ret         = phPalEse_i2c_read(pDevHandle, &pBuffer[1 + headerIndex], numBytesToRead);
-#if defined(T1oI2C_UM11225)
-            total_count    = 3;
-            nNbBytesToRead = pBuffer[2];
-#elif defined(T1oI2C_GP1_0)
-            total_count    = 4;
-            nNbBytesToRead = (pBuffer[2] << 8 & 0xFF) | (pBuffer[3] & 0xFF);
-#endif
-            /* Read the Complete data + two byte CRC*/
-            ret = phPalEse_i2c_read(
-                pDevHandle, &pBuffer[PH_PROTO_7816_HEADER_LEN], (nNbBytesToRead + PH_PROTO_7816_CRC_LEN));
-            if (ret < 0) {
-                T_SMLOG_D("_i2c_read() ret : %X", ret);
-                ret = -1;
-            }
-            else {
-                ret = (total_count + (nNbBytesToRead + PH_PROTO_7816_CRC_LEN));
-            }
-            break;
-        }
-        /*If it is Chained packet wait for 1 ms*/
-        if (poll_sof_chained_delay == 1) {
-            T_SMLOG_D("%s Chained Pkt, delay read %dms", __FUNCTION__, ESE_POLL_DELAY_MS * CHAINED_PKT_SCALER);
-            sm_sleep(ESE_POLL_DELAY_MS);
-        }
-        else {
-            T_SMLOG_D("%s Normal Pkt, delay read %dms", __FUNCTION__, ESE_POLL_DELAY_MS * NAD_POLLING_SCALER);
-            sm_sleep(ESE_POLL_DELAY_MS);
-        }
-    } while ((sof_counter < ESE_NAD_POLLING_MAX) && (nxpese_ctxt->EseLibStatus != ESE_STATUS_CLOSE));
-    if ((pBuffer[0] == RECIEVE_PACKET_SOF) && (ret > 0)) {
-        T_SMLOG_D("%s SOF FOUND", __FUNCTION__);
-        /* Read the HEADR of one/Two bytes based on how two bytes read A5 PCB or 00 A5*/
-        ret = phPalEse_i2c_read(pDevHandle, &pBuffer[1 + headerIndex], numBytesToRead);
-        if (ret < 0) {
-            T_SMLOG_D("_i2c_read() ret: %X", ret);
-        }
-        if ((pBuffer[1] == CHAINED_PACKET_WITHOUTSEQN) || (pBuffer[1] == CHAINED_PACKET_WITHSEQN)) {
-            poll_sof_chained_delay = 1;
-            T_SMLOG_D("poll_sof_chained_delay value is %d ", poll_sof_chained_delay);
-        }
-        else {
-            poll_sof_chained_delay = 0;
-            T_SMLOG_D("poll_sof_chained_delay value is %d ", poll_sof_chained_delay);
-        }
-#if defined(T1oI2C_UM11225)
-        total_count    = 3;
-        nNbBytesToRead = pBuffer[2];
-#elif defined(T1oI2C_GP1_0)
-        total_count    = 4;
-        nNbBytesToRead = (pBuffer[2] << 8 & 0xFF00) | (pBuffer[3] & 0xFF);
-#endif
-        /* Read the Complete data + two byte CRC*/
-        ret =
-            phPalEse_i2c_read(pDevHandle, &pBuffer[PH_PROTO_7816_HEADER_LEN], (nNbBytesToRead + PH_PROTO_7816_CRC_LEN));
-        if (ret < 0) {
-            T_SMLOG_D("_i2c_read() ret : %X", ret);
-            ret = -1;
-        }
-        else {
-            ret = (total_count + (nNbBytesToRead + PH_PROTO_7816_CRC_LEN));
-        }
+    ENSURE_OR_RETURN_ON_ERROR(pWaitUs != NULL, ESESTATUS_INVALID_PARAMETER);
+    memset(nxpese_ctxt->p_read_buff, 0, MAX_APDU_BUFFER);
+    nxpese_ctxt->pRxInf    = &nxpese_ctxt->p_read_buff[PH_PROTO_7816_HEADER_LEN];
+    nxpese_ctxt->pollCount = 0;
+    if (nxpese_ctxt->frameTap.record != NULL) {
+        nxpese_ctxt->tapReadStartNs = sm_get_time_ns();
+    }
+    /* With a readiness notifier each poll may wait for ESE_READY_WAIT_TIMEOUT_MS */
+    nxpese_ctxt->pollCountMax = (nxpese_ctxt->readyNotifier.wait != NULL) ? ESE_NAD_POLLING_MAX : ESE_POLL_COUNT_MAX;
+    /* Sleep for the expected processing time of the command, then back off in microsecond steps */
+    nxpese_ctxt->pollDelayUs = phNxpEse_getExpectedLatency(nxpese_ctxt);
+    if (nxpese_ctxt->pollDelayUs > 0) {
+        nxpese_ctxt->pollCountMax += ESE_POLL_BACKOFF_ROUNDS + 1;
+        *pWaitUs = nxpese_ctxt->pollDelayUs;
     }
     else {
-        ret = -1;
+        *pWaitUs = ESE_POLL_DELAY_MS * 1000;
     }
-exit:
-    return ret;
+    return ESESTATUS_SUCCESS;
 }
+
 /******************************************************************************
- * Function         phNxpEse_WriteFrame
+ * Function         phNxpEse_tryRead
  *
- * Description      This function writes the data to ESE.
- *                  It waits till write callback provide the result of write
- *                  process.
+ * Description      This function polls the ESE once for the frame prepared with
+ *                  phNxpEse_startRead. A frame that has started is read completely.
  *
  * param[in]        void*: connection context
- * param[in]        uint32_t: number of bytes to be written
- * param[in]        uint8_t : data buffer
+ * param[out]       uint32_t: number of bytes read
+ * param[out]       uint8_t : Read data from ESE
+ * param[out]       uint32_t*: with ESESTATUS_PENDING, time to wait before polling again,
+ *                  in microseconds
  *
- * Returns          It returns ESESTATUS_SUCCESS (0) if write successful else
- *                  ESESTATUS_FAILED(1)
+ * Returns          ESESTATUS_SUCCESS - frame read
+ *                  ESESTATUS_PENDING - no frame yet, poll again after the wait time
+ *                  ESESTATUS_FAILED  - read failure or no frame within the polling budget
  *
  ******************************************************************************/
-ESESTATUS phNxpEse_WriteFrame(void *conn_ctx, uint32_t data_len, const uint8_t *p_data)
+ESESTATUS phNxpEse_tryRead(void *conn_ctx, uint32_t *data_len, uint8_t **pp_data, uint32_t *pWaitUs)
 {
-    ESESTATUS status                = ESESTATUS_INVALID_PARAMETER;
-    int32_t dwNoBytesWrRd           = 0;
+    ESESTATUS status                = ESESTATUS_FAILED;
+    int ret                         = -1;
+    uint64_t tapStartNs             = 0;
+    phPalEse_IoVec_t tapIov[2]      = {{NULL, 0}};
     phNxpEse_Context_t *nxpese_ctxt = (conn_ctx == NULL) ? &gnxpese_ctxt : (phNxpEse_Context_t *)conn_ctx;
 
-    /* Create local copy of cmd_data */
-    T_SMLOG_D("%s Enter ..", __FUNCTION__);
+    ENSURE_OR_GO_EXIT(data_len != NULL);
+    ENSURE_OR_GO_EXIT(pp_data != NULL);
+    ENSURE_OR_GO_EXIT(pWaitUs != NULL);
 
-    if (data_len > MAX_APDU_BUFFER) {
-        return ESESTATUS_FAILED;
+    if (nxpese_ctxt->frameTap.record != NULL) {
+        tapStartNs = sm_get_time_ns();
     }
-
-    //phNxpEse_memcpy(nxpese_ctxt->p_cmd_data, p_data, data_len);
-    //nxpese_ctxt->cmd_len = data_len;
-
-    if (nxpese_ctxt->EseLibStatus != ESE_STATUS_CLOSE) {
+    ret = phNxpEse_pollPacket(
+        nxpese_ctxt, nxpese_ctxt->pDevHandle, nxpese_ctxt->p_read_buff, MAX_APDU_BUFFER, pWaitUs);
+    if (ret == 0) {
+        return ESESTATUS_PENDING;
+    }
+    else if (ret < 0) {
+        T_SMLOG_E("PAL Read status error status = %x", status);
+        status = ESESTATUS_FAILED;
+    }
+    else {
+        if (nxpese_ctxt->pRxInf == &nxpese_ctxt->p_read_buff[PH_PROTO_7816_HEADER_LEN]) {
+            T_SMLOG_MAU8_D("RAW Rx<", nxpese_ctxt->p_read_buff, ret);
+        }
+        else {
+            T_SMLOG_MAU8_D("RAW Rx<", nxpese_ctxt->p_read_buff, PH_PROTO_7816_HEADER_LEN);
+            T_SMLOG_MAU8_D("RAW Rx INF<", nxpese_ctxt->pRxInf, (ret - PH_PROTO_7816_HEADER_LEN));
+        }
+        if (nxpese_ctxt->frameTap.record != NULL) {
+            tapIov[0].pData = nxpese_ctxt->p_read_buff;
+            tapIov[0].len   = PH_PROTO_7816_HEADER_LEN;
+            tapIov[1].pData = nxpese_ctxt->pRxInf;
+            tapIov[1].len   = (uint32_t)(ret - PH_PROTO_7816_HEADER_LEN);
+            phNxpEse_tapFrame(nxpese_ctxt, PH_PAL_ESE_TAP_DIR_RX, tapStartNs, tapIov, 2);
+        }
+        *data_len = ret;
+        *pp_data  = nxpese_ctxt->p_read_buff;
+        status    = ESESTATUS_SUCCESS;
+    }
+exit:
+    /* The target applies to one read only */
+    nxpese_ctxt->pRxTarget         = NULL;
+    nxpese_ctxt->rxTargetLen       = 0;
+    nxpese_ctxt->isRxTargetScratch = FALSE;
+    return status;
+}
+
+/******************************************************************************
+ * Function         phNxpEse_setRxTarget
+ *
+ * Description      This function sets the final position of the INF field of
+ *                  the next I-frame, e.g. the next free byte of the response
+ *                  buffer. The INF field is then read straight to the target
+ *                  instead of being copied out of the read buffer.
+ *                  Applies to the next phNxpEse_read only.
+ *
+ * param[in]        void*: connection context
+ * param[in]        uint8_t*: target of the INF field, NULL to read into the read buffer
+ * param[in]        uint32_t: number of bytes available at the target
+ * param[in]        bool_t: TRUE if all bytes at the target may be overwritten,
+ *                  allows to read speculatively into it. With FALSE only the
+ *                  INF field of an I-frame is written to the target.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void phNxpEse_setRxTarget(void *conn_ctx, uint8_t *pTarget, uint32_t targetLen, bool_t isScratch)
+{
+    phNxpEse_Context_t *nxpese_ctxt = (conn_ctx == NULL) ? &gnxpese_ctxt : (phNxpEse_Context_t *)conn_ctx;
+
+    nxpese_ctxt->pRxTarget         = (targetLen > 0) ? pTarget : NULL;
+    nxpese_ctxt->rxTargetLen       = (pTarget != NULL) ? targetLen : 0;
+    nxpese_ctxt->isRxTargetScratch = isScratch;
+}
+
+/******************************************************************************
+ * Function         phNxpEse_getRxInf
+ *
+ * Description      This function returns the INF field of the last frame read.
+ *                  The header is at the start of the read buffer, the INF field
+ *                  and the CRC follow it or are at the target of the read.
+ *
+ * param[in]        void*: connection context
+ *
+ * Returns          INF field of the last frame read.
+ *
+ ******************************************************************************/
+uint8_t *phNxpEse_getRxInf(void *conn_ctx)
+{
+    phNxpEse_Context_t *nxpese_ctxt = (conn_ctx == NULL) ? &gnxpese_ctxt : (phNxpEse_Context_t *)conn_ctx;
+
+    return nxpese_ctxt->pRxInf;
+}
+
+/******************************************************************************
+ * Function         phNxpEse_waitForData
+ *
+ * Description      This function waits before polling the ESE for a frame.
+ *                  Waits on the readiness notifier of the connection when set,
+ *                  otherwise sleeps or spins (ESE_POLL_BUSY) for the given time.
+ *
+ * param[in]        void*: connection context
+ * param[in]        uint32_t: time to wait without notifier, in microseconds
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void phNxpEse_waitForData(void *conn_ctx, uint32_t waitUs)
+{
+    ESESTATUS status                = ESESTATUS_FAILED;
+    phNxpEse_Context_t *nxpese_ctxt = (conn_ctx == NULL) ? &gnxpese_ctxt : (phNxpEse_Context_t *)conn_ctx;
+    uint32_t timeoutMs              = ESE_READY_WAIT_TIMEOUT_MS;
+
+    if (nxpese_ctxt->readyNotifier.wait != NULL) {
+        /* Do not wait beyond the deadline of the transceive */
+        if ((nxpese_ctxt->deadlineUs != 0) && (((waitUs + 999) / 1000) < timeoutMs)) {
+            timeoutMs = (waitUs + 999) / 1000;
+        }
+        status = nxpese_ctxt->readyNotifier.wait(nxpese_ctxt->readyNotifier.pNotifierCtx, timeoutMs);
+        if (status == ESESTATUS_PENDING) {
+            /* Read anyway, the notification may have been missed */
+            T_SMLOG_D("%s No data ready notification within %ums", __FUNCTION__, timeoutMs);
+            return;
+        }
+        if (status == ESESTATUS_SUCCESS) {
+            return;
+        }
+        T_SMLOG_W("%s Data ready notifier failed, polling", __FUNCTION__);
+    }
+    phPalEse_i2c_delay(nxpese_ctxt->pDevHandle, waitUs);
+}
+
+/******************************************************************************
+ * Function         phNxpEse_delay
+ *
+ * Description      This function waits the given time before the next access to
+ *                  the ESE, sleeping or spinning (ESE_POLL_BUSY).
+ *
+ * param[in]        void*: connection context
+ * param[in]        uint32_t: time to wait, in microseconds
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void phNxpEse_delay(void *conn_ctx, uint32_t waitUs)
+{
+    phNxpEse_Context_t *nxpese_ctxt = (conn_ctx == NULL) ? &gnxpese_ctxt : (phNxpEse_Context_t *)conn_ctx;
+
+    phPalEse_i2c_delay(nxpese_ctxt->pDevHandle, waitUs);
+}
+
+/******************************************************************************
+ * Function         phNxpEse_stopRead
+ *
+ * Description      This function abandons the frame being read with
+ *                  phNxpEse_startRead / phNxpEse_tryRead.
+ *
+ * param[in]        void*: connection context
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void phNxpEse_stopRead(void *conn_ctx)
+{
+    phNxpEse_Context_t *nxpese_ctxt = (conn_ctx == NULL) ? &gnxpese_ctxt : (phNxpEse_Context_t *)conn_ctx;
+
+    nxpese_ctxt->pRxTarget                = NULL;
+    nxpese_ctxt->rxTargetLen              = 0;
+    nxpese_ctxt->isRxTargetScratch        = FALSE;
+    nxpese_ctxt->latencyModel.awaitingRsp = FALSE;
+}
+
+/******************************************************************************
+ * Function         phNxpEse_getDeadline
+ *
+ * Description      This function returns the deadline of the current transceive.
+ *
+ * param[in]        void*: connection context
+ *
+ * Returns          Deadline (sm_get_time_us), 0 if there is none.
+ *
+ ******************************************************************************/
+uint64_t phNxpEse_getDeadline(void *conn_ctx)
+{
+    phNxpEse_Context_t *nxpese_ctxt = (conn_ctx == NULL) ? &gnxpese_ctxt : (phNxpEse_Context_t *)conn_ctx;
+    return nxpese_ctxt->deadlineUs;
+}
+
+/******************************************************************************
+ * Function         phNxpEse_readFrame
+ *
+ * Description      This function speculatively reads a frame of the max size in
+ *                  one transfer. Only the bytes of the received frame are used,
+ *                  a frame longer than the speculative read is completed with a
+ *                  second read. The INF field of an I-frame is read to the
+ *                  receive target, if one is set that may be overwritten.
+ *
+ * param[in]        phNxpEse_Context_t*: connection context
+ * param[in]        void*: device handle
+ * param[out]       uint8_t*: buffer for the frame, frame starts at offset 0
+ * param[in]        int: size of the buffer
+ *
+ * Returns          >0 - length of the frame read
+ *                   0 - no frame available
+ *                  -1 - read operation failure
+ *                  -2 - not supported, frame has to be read in parts
+ *
+ ******************************************************************************/
+static int phNxpEse_readFrame(
+    phNxpEse_Context_t *nxpese_ctxt, void *pDevHandle, uint8_t *pBuffer, int nNbBytesToRead)
+{
+    int ret            = -1;
+    int readLen        = ESE_FRAME_READ_MAX_LEN;
+    int frameStart     = 0;
+    int frameLen       = 0;
+    int bodyLen        = 0;
+    uint8_t *pBody     = &pBuffer[PH_PROTO_7816_HEADER_LEN];
+    uint8_t *pRestBuff = NULL;
+    bool_t isToTarget  = FALSE;
+
+    if (nxpese_ctxt->isFrameReadDisabled) {
+        return -2;
+    }
+    if (readLen > nNbBytesToRead) {
+        readLen = nNbBytesToRead;
+    }
+    bodyLen = readLen - PH_PROTO_7816_HEADER_LEN;
+    /* The remainder is read speculatively, straight to the target only if it may be overwritten */
+    if ((nxpese_ctxt->pRxTarget != NULL) && (nxpese_ctxt->isRxTargetScratch) &&
+        (nxpese_ctxt->rxTargetLen >= (uint32_t)bodyLen)) {
+        pBody      = nxpese_ctxt->pRxTarget;
+        isToTarget = TRUE;
+    }
+
+    ret = phPalEse_i2c_read_frame(
+        pDevHandle, pBuffer, PH_PROTO_7816_HEADER_LEN, pBody, bodyLen, 0);
+    if (ret == -2) {
+        T_SMLOG_D("%s Frame read not supported, reading in parts", __FUNCTION__);
+        nxpese_ctxt->isFrameReadDisabled = TRUE;
+        return -2;
+    }
+    else if (ret < 0) {
+        /*Polling for read on i2c, hence Debug log*/
+        T_SMLOG_D("_i2c_read_frame() ret : %X", ret);
+        pBuffer[0] = 0x00;
+        pBuffer[1] = 0x00;
+        return 0;
+    }
+
+    if (pBuffer[0] == RECIEVE_PACKET_SOF) {
+        frameStart = 0;
+    }
+    else if (pBuffer[1] == RECIEVE_PACKET_SOF) {
+        frameStart = 1;
+    }
+    else if ((pBuffer[0] == 0x00) && ((pBuffer[1] == 0x82) || (pBuffer[1] == 0x92))) {
+        /*if host writes invalid frame and host and SE are out of sync*/
+        T_SMLOG_W("%s NAD error, Recieved NAD byte 0x%x ", __FUNCTION__, pBuffer[0]);
+        frameStart = 0;
+    }
+    else {
+        pBuffer[0] = 0x00;
+        pBuffer[1] = 0x00;
+        return 0;
+    }
+    if ((isToTarget) && ((frameStart != 0) || (pBuffer[PH_PROPTO_7816_PCB_OFFSET] & 0x80))) {
+        /* Only the INF field of an I-frame is kept at the target, others are decoded from the read buffer */
+        phNxpEse_memcpy(&pBuffer[PH_PROTO_7816_HEADER_LEN], pBody, bodyLen);
+        pBody      = &pBuffer[PH_PROTO_7816_HEADER_LEN];
+        isToTarget = FALSE;
+    }
+
+#if defined(T1oI2C_UM11225)
+    frameLen = PH_PROTO_7816_HEADER_LEN + pBuffer[frameStart + 2] + PH_PROTO_7816_CRC_LEN;
+#elif defined(T1oI2C_GP1_0)
+    frameLen = PH_PROTO_7816_HEADER_LEN + ((pBuffer[frameStart + 2] << 8) | pBuffer[frameStart + 3]) +
+               PH_PROTO_7816_CRC_LEN;
+#endif
+    if ((frameStart + frameLen) > nNbBytesToRead) {
+        T_SMLOG_E("%s Frame length %d exceeds buffer", __FUNCTION__, frameLen);
+        return -1;
+    }
+    if ((isToTarget) && ((uint32_t)(frameLen - PH_PROTO_7816_HEADER_LEN) > nxpese_ctxt->rxTargetLen)) {
+        T_SMLOG_E("%s Frame length %d exceeds target", __FUNCTION__, frameLen);
+        return -1;
+    }
+    if ((frameStart + frameLen) > readLen) {
+        /* Read the remainder of a frame longer than the speculative read */
+        pRestBuff = (isToTarget) ? &pBody[bodyLen] : &pBuffer[readLen];
+        ret       = phPalEse_i2c_read(pDevHandle, pRestBuff, (frameStart + frameLen - readLen));
+        if (ret < 0) {
+            T_SMLOG_D("_i2c_read() ret : %X", ret);
+            return -1;
+        }
+    }
+    if (frameStart > 0) {
+        memmove(pBuffer, &pBuffer[frameStart], frameLen);
+    }
+    if (isToTarget) {
+        nxpese_ctxt->pRxInf = pBody;
+    }
+    return frameLen;
+}
+
+/******************************************************************************
+ * Function         phNxpEse_pollPacket
+ *
+ * Description      This function polls the ESE once for a frame and reads the
+ *                  frame completely once it has started.
+ *
+ * param[in]        phNxpEse_Context_t*: connection context
+ * param[in]        void: ESE Context
+ * param[in]        uint8_t: pointer to read buffer
+ * param[in]        int : MAX bytes to read
+ * param[out]       uint32_t*: time to wait before the next poll, when no frame is available
+ *
+ * Returns          ret - number of successfully read bytes
+ *                   0  - no frame available yet, poll again
+ *                  -1  - read operation failure or polling budget exhausted
+ *
+ ******************************************************************************/
+static int phNxpEse_pollPacket(
+    phNxpEse_Context_t *nxpese_ctxt, void *pDevHandle, uint8_t *pBuffer, int nNbBytesToRead, uint32_t *pWaitUs)
+{
+    int ret               = -1;
+    int total_count       = 0, numBytesToRead = 0, headerIndex = 0;
+    bool_t isBackoffRound = FALSE;
+    bool_t isSofFound     = FALSE;
+    int frameLen          = 0; /* Result of phNxpEse_readFrame */
+
+    ENSURE_OR_GO_EXIT(pBuffer != NULL);
+    nxpese_ctxt->pollCount++;
+    isBackoffRound = (nxpese_ctxt->pollDelayUs > 0) ? TRUE : FALSE;
+    if (isBackoffRound) {
+        nxpese_ctxt->pollDelayUs =
+            (nxpese_ctxt->pollCount == 1) ? ESE_POLL_BACKOFF_MIN_US : (nxpese_ctxt->pollDelayUs * 2);
+        if (nxpese_ctxt->pollDelayUs >= (ESE_POLL_DELAY_MS * 1000)) {
+            nxpese_ctxt->pollDelayUs = 0;
+        }
+    }
+    /* Read the complete frame in one transfer when supported */
+    frameLen = phNxpEse_readFrame(nxpese_ctxt, pDevHandle, pBuffer, nNbBytesToRead);
+    if (frameLen > 0) {
+        T_SMLOG_D("%s Frame read in one transfer", __FUNCTION__);
+        phNxpEse_updateLatencyModel(nxpese_ctxt);
+        if ((pBuffer[1] == CHAINED_PACKET_WITHOUTSEQN) || (pBuffer[1] == CHAINED_PACKET_WITHSEQN)) {
+            nxpese_ctxt->poll_sof_chained_delay = 1;
+        }
+        else {
+            nxpese_ctxt->poll_sof_chained_delay = 0;
+        }
+        ret = frameLen;
+        goto exit;
+    }
+    else if (frameLen == -1) {
+        ret = -1;
+        goto exit;
+    }
+    else if (frameLen == -2) {
+        ret = phPalEse_i2c_poll(pDevHandle, pBuffer, 2); /*read NAD PCB byte first*/
+    }
+    if (ret < 0) {
+        /*Polling for read on i2c, hence Debug log*/
+        T_SMLOG_D("_i2c_read() ret : %X", ret);
+    }
+    else if (pBuffer[0] == RECIEVE_PACKET_SOF) {
+        /* Read the HEADR of Two bytes*/
+        T_SMLOG_D("%s Read HDR", __FUNCTION__);
+        pBuffer[0] = RECIEVE_PACKET_SOF;
+#if defined(T1oI2C_UM11225)
+        numBytesToRead = 1;
+#elif defined(T1oI2C_GP1_0)
+        numBytesToRead = 2;
+#endif
+        headerIndex = 1;
+        isSofFound  = TRUE;
+    }
+    else if (pBuffer[1] == RECIEVE_PACKET_SOF) {
+        /* Read the HEADR of Two bytes*/
+        T_SMLOG_D("%s Read HDR", __FUNCTION__);
+        pBuffer[0] = RECIEVE_PACKET_SOF;
+#if defined(T1oI2C_UM11225)
+        numBytesToRead = 2;
+#elif defined(T1oI2C_GP1_0)
+        numBytesToRead = 3;
+#endif
+        headerIndex = 0;
+        isSofFound  = TRUE;
+    }
+    /*if host writes invalid frame and host and SE are out of sync*/
+    else if ((pBuffer[0] == 0x00) && ((pBuffer[1] == 0x82) || (pBuffer[1] == 0x92))) {
+        T_SMLOG_W("%s Recieved NAD byte 0x%x ", __FUNCTION__, pBuffer[0]);
+        T_SMLOG_W("%s NAD error, clearing the read buffer ", __FUNCTION__);
+        /*retry to get all data*/
+#if defined(T1oI2C_UM11225)
+        numBytesToRead = 1;
+#elif defined(T1oI2C_GP1_0)
+        numBytesToRead = 2;
+#endif
+        headerIndex = 1;
+        ret         = phPalEse_i2c_read(pDevHandle, &pBuffer[1 + headerIndex], numBytesToRead);
+#if defined(T1oI2C_UM11225)
+        total_count    = 3;
+        nNbBytesToRead = pBuffer[2];
+#elif defined(T1oI2C_GP1_0)
+        total_count    = 4;
+        nNbBytesToRead = (pBuffer[2] << 8 & 0xFF) | (pBuffer[3] & 0xFF);
+#endif
+        /* Read the Complete data + two byte CRC*/
+        ret = phPalEse_i2c_read(
+            pDevHandle, &pBuffer[PH_PROTO_7816_HEADER_LEN], (nNbBytesToRead + PH_PROTO_7816_CRC_LEN));
+        if (ret < 0) {
+            T_SMLOG_D("_i2c_read() ret : %X", ret);
+            ret = -1;
+        }
+        else {
+            ret = (total_count + (nNbBytesToRead + PH_PROTO_7816_CRC_LEN));
+        }
+        goto exit;
+    }
+
+    if (!isSofFound) {
+        if ((nxpese_ctxt->pollCount >= nxpese_ctxt->pollCountMax) ||
+            (nxpese_ctxt->EseLibStatus == ESE_STATUS_CLOSE)) {
+            ret = -1;
+            goto exit;
+        }
+        if (nxpese_ctxt->pollDelayUs > 0) {
+            *pWaitUs = nxpese_ctxt->pollDelayUs;
+        }
+        /*If it is Chained packet wait for 1 ms*/
+        else if (nxpese_ctxt->poll_sof_chained_delay == 1) {
+            T_SMLOG_D("%s Chained Pkt, delay read %dms", __FUNCTION__, ESE_POLL_DELAY_MS * CHAINED_PKT_SCALER);
+            *pWaitUs = ESE_POLL_DELAY_MS * CHAINED_PKT_SCALER * 1000;
+        }
+        else {
+            T_SMLOG_D("%s Normal Pkt, delay read %dms", __FUNCTION__, ESE_POLL_DELAY_MS * NAD_POLLING_SCALER);
+            *pWaitUs = ESE_POLL_DELAY_MS * NAD_POLLING_SCALER * 1000;
+        }
+        return 0;
+    }
+
+    T_SMLOG_D("%s SOF FOUND", __FUNCTION__);
+    phNxpEse_updateLatencyModel(nxpese_ctxt);
+    /* Read the HEADR of one/Two bytes based on how two bytes read A5 PCB or 00 A5*/
+    ret = phPalEse_i2c_read(pDevHandle, &pBuffer[1 + headerIndex], numBytesToRead);
+    if (ret < 0) {
+        T_SMLOG_D("_i2c_read() ret: %X", ret);
+    }
+    if ((pBuffer[1] == CHAINED_PACKET_WITHOUTSEQN) || (pBuffer[1] == CHAINED_PACKET_WITHSEQN)) {
+        nxpese_ctxt->poll_sof_chained_delay = 1;
+        T_SMLOG_D("poll_sof_chained_delay value is %d ", nxpese_ctxt->poll_sof_chained_delay);
+    }
+    else {
+        nxpese_ctxt->poll_sof_chained_delay = 0;
+        T_SMLOG_D("poll_sof_chained_delay value is %d ", nxpese_ctxt->poll_sof_chained_delay);
+    }
+#if defined(T1oI2C_UM11225)
+    total_count    = 3;
+    nNbBytesToRead = pBuffer[2];
+#elif defined(T1oI2C_GP1_0)
+    total_count    = 4;
+    nNbBytesToRead = (pBuffer[2] << 8 & 0xFF00) | (pBuffer[3] & 0xFF);
+#endif
+    /* The INF field of an I-frame is read straight to its target */
+    if ((nxpese_ctxt->pRxTarget != NULL) && (!(pBuffer[PH_PROPTO_7816_PCB_OFFSET] & 0x80)) &&
+        ((uint32_t)(nNbBytesToRead + PH_PROTO_7816_CRC_LEN) <= nxpese_ctxt->rxTargetLen)) {
+        nxpese_ctxt->pRxInf = nxpese_ctxt->pRxTarget;
+    }
+    /* Read the Complete data + two byte CRC*/
+    ret = phPalEse_i2c_read(pDevHandle, nxpese_ctxt->pRxInf, (nNbBytesToRead + PH_PROTO_7816_CRC_LEN));
+    if (ret < 0) {
+        T_SMLOG_D("_i2c_read() ret : %X", ret);
+        ret = -1;
+    }
+    else {
+        ret = (total_count + (nNbBytesToRead + PH_PROTO_7816_CRC_LEN));
+    }
+exit:
+    /* Only the first frame after the command is measured */
+    nxpese_ctxt->latencyModel.awaitingRsp = FALSE;
+    return ret;
+}
+
+/******************************************************************************
+ * Function         phNxpEse_WriteFrame
+ *
+ * Description      This function writes the data to ESE.
+ *                  It waits till write callback provide the result of write
+ *                  process.
+ *
+ * param[in]        void*: connection context
+ * param[in]        uint32_t: number of bytes to be written
+ * param[in]        uint8_t : data buffer
+ *
+ * Returns          It returns ESESTATUS_SUCCESS (0) if write successful else
+ *                  ESESTATUS_FAILED(1)
+ *
+ ******************************************************************************/
+ESESTATUS phNxpEse_WriteFrame(void *conn_ctx, uint32_t data_len, const uint8_t *p_data)
+{
+    ESESTATUS status                = ESESTATUS_INVALID_PARAMETER;
+    int32_t dwNoBytesWrRd           = 0;
+    uint64_t tapStartNs             = 0;
+    phPalEse_IoVec_t tapIov         = {NULL, 0};
+    phNxpEse_Context_t *nxpese_ctxt = (conn_ctx == NULL) ? &gnxpese_ctxt : (phNxpEse_Context_t *)conn_ctx;
+
+    /* Create local copy of cmd_data */
+    T_SMLOG_D("%s Enter ..", __FUNCTION__);
+
+    if (data_len > MAX_APDU_BUFFER) {
+        return ESESTATUS_FAILED;
+    }
+
+    //phNxpEse_memcpy(nxpese_ctxt->p_cmd_data, p_data, data_len);
+    //nxpese_ctxt->cmd_len = data_len;
+
+    if (nxpese_ctxt->EseLibStatus != ESE_STATUS_CLOSE) {
+        if (nxpese_ctxt->frameTap.record != NULL) {
+            tapStartNs = sm_get_time_ns();
+        }
         dwNoBytesWrRd = phPalEse_i2c_write(nxpese_ctxt->pDevHandle,
             /*nxpese_ctxt->p_cmd_data*/ (uint8_t *)p_data,
             /*nxpese_ctxt->cmd_len*/ data_len);
@@ -666,6 +1323,11 @@ ESESTATUS phNxpEse_WriteFrame(void *conn_ctx, uint32_t data_len, const uint8_t *
             status = ESESTATUS_SUCCESS;
             //T_SMLOG_MAU8_D("RAW Tx>", nxpese_ctxt->p_cmd_data, nxpese_ctxt->cmd_len);
             T_SMLOG_MAU8_D("RAW Tx>", p_data, data_len);
+            if (nxpese_ctxt->frameTap.record != NULL) {
+                tapIov.pData = p_data;
+                tapIov.len   = data_len;
+                phNxpEse_tapFrame(nxpese_ctxt, PH_PAL_ESE_TAP_DIR_TX, tapStartNs, &tapIov, 1);
+            }
         }
     }
     else
@@ -674,22 +1336,558 @@ ESESTATUS phNxpEse_WriteFrame(void *conn_ctx, uint32_t data_len, const uint8_t *
 }
 
 /******************************************************************************
- * Function         phNxpEse_setIfsc
- *
- * Description      This function sets the IFSC size to 240/254 support JCOP OS Update.
+ * Function         phNxpEse_WriteFrameV
  *
- * param[in]        uint16_t IFSC_Size
+ * Description      This function writes a frame held in several pieces to ESE,
+ *                  without copying when the PAL supports scatter/gather writes.
+ *                  Otherwise the pieces are gathered in the read buffer, which
+ *                  is idle while a frame is written.
  *
- * Returns          Always return ESESTATUS_SUCCESS (0).
+ * param[in]        void*: connection context
+ * param[in]        phPalEse_IoVec_t*: pieces of the frame
+ * param[in]        uint8_t: number of pieces
+ *
+ * Returns          It returns ESESTATUS_SUCCESS (0) if write successful else
+ *                  ESESTATUS_FAILED(1)
  *
  ******************************************************************************/
-ESESTATUS phNxpEse_setIfsc(uint16_t IFSC_Size)
+ESESTATUS phNxpEse_WriteFrameV(void *conn_ctx, const phPalEse_IoVec_t *pIov, uint8_t iovCnt)
 {
+    int32_t dwNoBytesWrRd           = -2;
+    uint32_t data_len               = 0;
+    uint8_t i                       = 0;
+    uint64_t tapStartNs             = 0;
+    phNxpEse_Context_t *nxpese_ctxt = (conn_ctx == NULL) ? &gnxpese_ctxt : (phNxpEse_Context_t *)conn_ctx;
+
+    ENSURE_OR_RETURN_ON_ERROR(pIov != NULL, ESESTATUS_INVALID_PARAMETER);
+    for (i = 0; i < iovCnt; i++) {
+        ENSURE_OR_RETURN_ON_ERROR(pIov[i].pData != NULL, ESESTATUS_INVALID_PARAMETER);
+        ENSURE_OR_RETURN_ON_ERROR(pIov[i].len <= (MAX_APDU_BUFFER - data_len), ESESTATUS_FAILED);
+        data_len += pIov[i].len;
+    }
+    if (nxpese_ctxt->EseLibStatus == ESE_STATUS_CLOSE) {
+        return ESESTATUS_INVALID_STATE;
+    }
+
+    if (!nxpese_ctxt->isWriteVDisabled) {
+        if (nxpese_ctxt->frameTap.record != NULL) {
+            tapStartNs = sm_get_time_ns();
+        }
+        dwNoBytesWrRd = phPalEse_i2c_writev(nxpese_ctxt->pDevHandle, pIov, iovCnt);
+        if (-2 == dwNoBytesWrRd) {
+            nxpese_ctxt->isWriteVDisabled = TRUE;
+        }
+    }
+    if (-2 == dwNoBytesWrRd) {
+        data_len = 0;
+        for (i = 0; i < iovCnt; i++) {
+            phNxpEse_memcpy(&nxpese_ctxt->p_read_buff[data_len], pIov[i].pData, pIov[i].len);
+            data_len += pIov[i].len;
+        }
+        return phNxpEse_WriteFrame(conn_ctx, data_len, nxpese_ctxt->p_read_buff);
+    }
+    if (-1 == dwNoBytesWrRd) {
+        T_SMLOG_E(" - Error in I2C Write.....");
+        return ESESTATUS_FAILED;
+    }
+    for (i = 0; i < iovCnt; i++) {
+        T_SMLOG_MAU8_D("RAW Tx>", pIov[i].pData, pIov[i].len);
+    }
+    if (nxpese_ctxt->frameTap.record != NULL) {
+        phNxpEse_tapFrame(nxpese_ctxt, PH_PAL_ESE_TAP_DIR_TX, tapStartNs, pIov, iovCnt);
+    }
+    return ESESTATUS_SUCCESS;
+}
+
+/******************************************************************************
+ * Function         phNxpEse_setIfsc
+ *
+ * Description      This function sets the IFSC size to 240/254 support JCOP OS Update.
+ *
+ * param[in]        connection context
+ * param[in]        uint16_t IFSC_Size
+ *
+ * Returns          Always return ESESTATUS_SUCCESS (0).
+ *
+ ******************************************************************************/
+ESESTATUS phNxpEse_setIfsc(void *conn_ctx, uint16_t IFSC_Size)
+{
+    phNxpEse_Context_t *nxpese_ctxt = (conn_ctx == NULL) ? &gnxpese_ctxt : (phNxpEse_Context_t *)conn_ctx;
     /*SET the IFSC size to 240 bytes*/
-    phNxpEseProto7816_SetIfscSize(IFSC_Size);
+    phNxpEseProto7816_SetIfscSize((void *)nxpese_ctxt, IFSC_Size);
+    return ESESTATUS_SUCCESS;
+}
+
+/******************************************************************************
+ * Function         phNxpEse_getIfs
+ *
+ * Description      This function gets the information field sizes of the connection,
+ *                  as agreed from the ATR/CIP and S(IFS) when the connection was opened.
+ *
+ * param[in]        connection context
+ * param[out]       uint16_t*: max. INF size of I-frames sent to the ESE (IFSC)
+ * param[out]       uint16_t*: max. INF size of I-frames received from the ESE (IFSD)
+ *
+ * Returns          On Success ESESTATUS_SUCCESS else proper error code.
+ *
+ ******************************************************************************/
+ESESTATUS phNxpEse_getIfs(void *conn_ctx, uint16_t *pIfsc, uint16_t *pIfsd)
+{
+    phNxpEse_Context_t *nxpese_ctxt = (conn_ctx == NULL) ? &gnxpese_ctxt : (phNxpEse_Context_t *)conn_ctx;
+    if (FALSE == phNxpEseProto7816_GetIfs((void *)nxpese_ctxt, pIfsc, pIfsd)) {
+        return ESESTATUS_INVALID_PARAMETER;
+    }
+    return ESESTATUS_SUCCESS;
+}
+
+/******************************************************************************
+ * Function         phNxpEse_setReadyNotifier
+ *
+ * Description      This function sets the data ready notifier of the connection.
+ *                  Frame reception waits on the notifier instead of polling with
+ *                  fixed delays. The notifier is released when the connection is closed.
+ *
+ * param[in]        connection context
+ * param[in]        phPalEse_ReadyNotifier_t*: notifier, NULL to fall back to polling
+ *
+ * Returns          On Success ESESTATUS_SUCCESS else proper error code.
+ *
+ ******************************************************************************/
+ESESTATUS phNxpEse_setReadyNotifier(void *conn_ctx, const phPalEse_ReadyNotifier_t *pNotifier)
+{
+    phNxpEse_Context_t *nxpese_ctxt = (conn_ctx == NULL) ? &gnxpese_ctxt : (phNxpEse_Context_t *)conn_ctx;
+
+    if (ESE_STATUS_CLOSE == nxpese_ctxt->EseLibStatus) {
+        return ESESTATUS_NOT_INITIALISED;
+    }
+    if ((pNotifier != NULL) && (pNotifier->wait == NULL)) {
+        return ESESTATUS_INVALID_PARAMETER;
+    }
+
+    if ((nxpese_ctxt->readyNotifier.release != NULL) &&
+        ((pNotifier == NULL) || (pNotifier->pNotifierCtx != nxpese_ctxt->readyNotifier.pNotifierCtx))) {
+        nxpese_ctxt->readyNotifier.release(nxpese_ctxt->readyNotifier.pNotifierCtx);
+    }
+    if (pNotifier == NULL) {
+        phNxpEse_memset(&nxpese_ctxt->readyNotifier, 0x00, sizeof(nxpese_ctxt->readyNotifier));
+    }
+    else {
+        phNxpEse_memcpy(&nxpese_ctxt->readyNotifier, pNotifier, sizeof(nxpese_ctxt->readyNotifier));
+    }
+    return ESESTATUS_SUCCESS;
+}
+
+/******************************************************************************
+ * Function         phNxpEse_setFrameTap
+ *
+ * Description      This function sets the frame tap of the connection. Every
+ *                  raw frame written to and read from the ESE is passed to the
+ *                  tap with its timing. The tap is released when the
+ *                  connection is closed.
+ *
+ * param[in]        connection context
+ * param[in]        phPalEse_FrameTap_t*: tap, NULL to stop capturing
+ *
+ * Returns          On Success ESESTATUS_SUCCESS else proper error code.
+ *
+ ******************************************************************************/
+ESESTATUS phNxpEse_setFrameTap(void *conn_ctx, const phPalEse_FrameTap_t *pTap)
+{
+    phNxpEse_Context_t *nxpese_ctxt = (conn_ctx == NULL) ? &gnxpese_ctxt : (phNxpEse_Context_t *)conn_ctx;
+
+    if (ESE_STATUS_CLOSE == nxpese_ctxt->EseLibStatus) {
+        return ESESTATUS_NOT_INITIALISED;
+    }
+    if ((pTap != NULL) && (pTap->record == NULL)) {
+        return ESESTATUS_INVALID_PARAMETER;
+    }
+
+    if ((nxpese_ctxt->frameTap.release != NULL) &&
+        ((pTap == NULL) || (pTap->pTapCtx != nxpese_ctxt->frameTap.pTapCtx))) {
+        nxpese_ctxt->frameTap.release(nxpese_ctxt->frameTap.pTapCtx);
+    }
+    if (pTap == NULL) {
+        phNxpEse_memset(&nxpese_ctxt->frameTap, 0x00, sizeof(nxpese_ctxt->frameTap));
+    }
+    else {
+        phNxpEse_memcpy(&nxpese_ctxt->frameTap, pTap, sizeof(nxpese_ctxt->frameTap));
+    }
+    return ESESTATUS_SUCCESS;
+}
+
+/******************************************************************************
+ * Function         phNxpEse_setTxRoom
+ *
+ * Description      This function declares the bytes the caller reserved before
+ *                  and after the C-APDU of the next transceive. The I-frames
+ *                  are then framed in place in the caller's buffer. The
+ *                  reserved bytes are restored once each frame is written.
+ *
+ * param[in]        connection context
+ * param[in]        uint32_t: writable bytes before the C-APDU
+ * param[in]        uint32_t: writable bytes after the C-APDU
+ *
+ * Returns          On Success ESESTATUS_SUCCESS else proper error code.
+ *
+ ******************************************************************************/
+ESESTATUS phNxpEse_setTxRoom(void *conn_ctx, uint32_t headroom, uint32_t tailroom)
+{
+    phNxpEse_Context_t *nxpese_ctxt = (conn_ctx == NULL) ? &gnxpese_ctxt : (phNxpEse_Context_t *)conn_ctx;
+
+    if (ESE_STATUS_CLOSE == nxpese_ctxt->EseLibStatus) {
+        return ESESTATUS_NOT_INITIALISED;
+    }
+    nxpese_ctxt->txHeadroom = headroom;
+    nxpese_ctxt->txTailroom = tailroom;
+    return ESESTATUS_SUCCESS;
+}
+
+/******************************************************************************
+ * Function         phNxpEse_setCmdKey
+ *
+ * Description      This function sets the command (INS, P1, P2) of the next
+ *                  transceive. The processing time of the command is learned
+ *                  and used to schedule polling for the response.
+ *
+ * param[in]        connection context
+ * param[in]        uint32_t: PH_NXP_ESE_CMD_KEY of the command, PH_NXP_ESE_CMD_KEY_NONE if unknown
+ *
+ * Returns          On Success ESESTATUS_SUCCESS else proper error code.
+ *
+ ******************************************************************************/
+ESESTATUS phNxpEse_setCmdKey(void *conn_ctx, uint32_t cmdKey)
+{
+    phNxpEse_Context_t *nxpese_ctxt = (conn_ctx == NULL) ? &gnxpese_ctxt : (phNxpEse_Context_t *)conn_ctx;
+
+    if (ESE_STATUS_CLOSE == nxpese_ctxt->EseLibStatus) {
+        return ESESTATUS_NOT_INITIALISED;
+    }
+    nxpese_ctxt->latencyModel.cmdKey = cmdKey;
     return ESESTATUS_SUCCESS;
 }
 
+/******************************************************************************
+ * Function         phNxpEse_setDeadline
+ *
+ * Description      This function sets the deadline of the next transceive,
+ *                  error recovery included. Waits end at the deadline and a
+ *                  recovery step is only started when it fits in the time left.
+ *                  When the deadline is reached the transceive returns
+ *                  ESESTATUS_RESPONSE_TIMEOUT and the next one starts by
+ *                  resynchronising with the ESE.
+ *
+ * param[in]        connection context
+ * param[in]        uint64_t: deadline (sm_get_time_us), 0 for none
+ *
+ * Returns          On Success ESESTATUS_SUCCESS else proper error code.
+ *
+ ******************************************************************************/
+ESESTATUS phNxpEse_setDeadline(void *conn_ctx, uint64_t deadlineUs)
+{
+    phNxpEse_Context_t *nxpese_ctxt = (conn_ctx == NULL) ? &gnxpese_ctxt : (phNxpEse_Context_t *)conn_ctx;
+
+    if (ESE_STATUS_CLOSE == nxpese_ctxt->EseLibStatus) {
+        return ESESTATUS_NOT_INITIALISED;
+    }
+    nxpese_ctxt->deadlineUs = deadlineUs;
+    return ESESTATUS_SUCCESS;
+}
+
+/******************************************************************************
+ * Function         phNxpEse_getLatencyModel
+ *
+ * Description      This function returns the learned processing times of the
+ *                  commands exchanged on the connection.
+ *
+ * param[in]        connection context
+ * param[out]       phNxpEse_LatencyEntry_t*: buffer for the entries
+ * param[in,out]    size_t*: in: number of entries of the buffer, out: number of entries returned
+ *
+ * Returns          On Success ESESTATUS_SUCCESS else proper error code.
+ *
+ ******************************************************************************/
+ESESTATUS phNxpEse_getLatencyModel(void *conn_ctx, phNxpEse_LatencyEntry_t *pEntries, size_t *pNumEntries)
+{
+    phNxpEse_Context_t *nxpese_ctxt = (conn_ctx == NULL) ? &gnxpese_ctxt : (phNxpEse_Context_t *)conn_ctx;
+    size_t i                        = 0;
+    size_t numEntries               = 0;
+
+    if ((pEntries == NULL) || (pNumEntries == NULL)) {
+        return ESESTATUS_INVALID_PARAMETER;
+    }
+
+    for (i = 0; i < PH_NXP_ESE_LATENCY_TABLE_SIZE; i++) {
+        if (nxpese_ctxt->latencyModel.entries[i].samples == 0) {
+            continue;
+        }
+        if (numEntries >= *pNumEntries) {
+            return ESESTATUS_BUFFER_TOO_SMALL;
+        }
+        pEntries[numEntries++] = nxpese_ctxt->latencyModel.entries[i];
+    }
+    *pNumEntries = numEntries;
+    return ESESTATUS_SUCCESS;
+}
+
+/******************************************************************************
+ * Function         phNxpEse_resetLatencyModel
+ *
+ * Description      This function discards the learned processing times of the
+ *                  connection. Polling falls back to the fixed delays until
+ *                  new measurements are available.
+ *
+ * param[in]        connection context
+ *
+ * Returns          Always return ESESTATUS_SUCCESS (0).
+ *
+ ******************************************************************************/
+ESESTATUS phNxpEse_resetLatencyModel(void *conn_ctx)
+{
+    phNxpEse_Context_t *nxpese_ctxt = (conn_ctx == NULL) ? &gnxpese_ctxt : (phNxpEse_Context_t *)conn_ctx;
+    uint32_t cmdKey                 = nxpese_ctxt->latencyModel.cmdKey;
+
+    phNxpEse_memset(&nxpese_ctxt->latencyModel, 0x00, sizeof(nxpese_ctxt->latencyModel));
+    nxpese_ctxt->latencyModel.cmdKey = cmdKey;
+    return ESESTATUS_SUCCESS;
+}
+
+/******************************************************************************
+ * Function         phNxpEse_getWtxInfo
+ *
+ * Description      This function returns the waiting time extensions (S(WTX))
+ *                  the ESE requested during the last transceive.
+ *
+ * param[in]        connection context
+ * param[out]       phNxpEse_WtxInfo_t*: command, number and duration of the extensions
+ *
+ * Returns          On Success ESESTATUS_SUCCESS else proper error code.
+ *
+ ******************************************************************************/
+ESESTATUS phNxpEse_getWtxInfo(void *conn_ctx, phNxpEse_WtxInfo_t *pWtxInfo)
+{
+    phNxpEse_Context_t *nxpese_ctxt = (conn_ctx == NULL) ? &gnxpese_ctxt : (phNxpEse_Context_t *)conn_ctx;
+
+    if (pWtxInfo == NULL) {
+        return ESESTATUS_INVALID_PARAMETER;
+    }
+    *pWtxInfo = nxpese_ctxt->lastWtx;
+    return ESESTATUS_SUCCESS;
+}
+
+/******************************************************************************
+ * Function         phNxpEse_getStats
+ *
+ * Description      This function returns the protocol counters of the
+ *                  connection. The copy is taken without stopping a transceive
+ *                  in progress.
+ *
+ * param[in]        connection context
+ * param[out]       phNxpEse_Stats_t*: counters since the connection was opened
+ *
+ * Returns          On Success ESESTATUS_SUCCESS else proper error code.
+ *
+ ******************************************************************************/
+ESESTATUS phNxpEse_getStats(void *conn_ctx, phNxpEse_Stats_t *pStats)
+{
+    phNxpEse_Context_t *nxpese_ctxt = (conn_ctx == NULL) ? &gnxpese_ctxt : (phNxpEse_Context_t *)conn_ctx;
+
+    if (pStats == NULL) {
+        return ESESTATUS_INVALID_PARAMETER;
+    }
+    *pStats = nxpese_ctxt->stats;
+    return ESESTATUS_SUCCESS;
+}
+
+/******************************************************************************
+ * Function         phNxpEse_getStatsCntx
+ *
+ * Description      This function returns the protocol counters the protocol
+ *                  layer updates.
+ *
+ * param[in]        void*: connection context
+ *
+ * Returns          Pointer to the counters of the connection.
+ *
+ ******************************************************************************/
+phNxpEse_Stats_t *phNxpEse_getStatsCntx(void *conn_ctx)
+{
+    phNxpEse_Context_t *nxpese_ctxt = (conn_ctx == NULL) ? &gnxpese_ctxt : (phNxpEse_Context_t *)conn_ctx;
+    return &nxpese_ctxt->stats;
+}
+
+/******************************************************************************
+ * Function         phNxpEse_startRspTimer
+ *
+ * Description      This function is called by the protocol layer after the last
+ *                  frame of a command is sent. Starts measuring the processing
+ *                  time of the command.
+ *
+ * param[in]        void*: connection context
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void phNxpEse_startRspTimer(void *conn_ctx)
+{
+    phNxpEse_Context_t *nxpese_ctxt = (conn_ctx == NULL) ? &gnxpese_ctxt : (phNxpEse_Context_t *)conn_ctx;
+
+    if (nxpese_ctxt->latencyModel.cmdKey == PH_NXP_ESE_CMD_KEY_NONE) {
+        return;
+    }
+    nxpese_ctxt->latencyModel.awaitingRsp = TRUE;
+    nxpese_ctxt->latencyModel.cmdSentUs   = sm_get_time_us();
+}
+
+/******************************************************************************
+ * Function         phNxpEse_findLatencyEntry
+ *
+ * Description      This function looks up the latency model entry of a command.
+ *
+ * param[in]        phNxpEse_LatencyModel_t*: latency model
+ * param[in]        uint32_t: command key
+ *
+ * Returns          Index of the entry, -1 if the command is not known.
+ *
+ ******************************************************************************/
+static int phNxpEse_findLatencyEntry(phNxpEse_LatencyModel_t *pModel, uint32_t cmdKey)
+{
+    int i = 0;
+    for (i = 0; i < PH_NXP_ESE_LATENCY_TABLE_SIZE; i++) {
+        if ((pModel->entries[i].samples > 0) && (pModel->entries[i].cmdKey == cmdKey)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/******************************************************************************
+ * Function         phNxpEse_getExpectedLatency
+ *
+ * Description      This function returns the delay before the first poll for
+ *                  the response of the current command. Slightly below the
+ *                  learned processing time, so that the response is not missed.
+ *
+ * param[in]        phNxpEse_Context_t*: connection context
+ *
+ * Returns          Delay in microseconds, 0 if regular polling is to be used.
+ *
+ ******************************************************************************/
+static uint32_t phNxpEse_getExpectedLatency(phNxpEse_Context_t *nxpese_ctxt)
+{
+    phNxpEse_LatencyModel_t *pModel = &nxpese_ctxt->latencyModel;
+    int index                       = -1;
+
+    if ((!pModel->awaitingRsp) || (nxpese_ctxt->readyNotifier.wait != NULL)) {
+        return 0;
+    }
+    index = phNxpEse_findLatencyEntry(pModel, pModel->cmdKey);
+    if (index < 0) {
+        return 0;
+    }
+    /* 7/8 of the smoothed time, measurements then converge down when the SE gets faster */
+    return (pModel->entries[index].avgUs / 8) * 7;
+}
+
+/******************************************************************************
+ * Function         phNxpEse_updateLatencyModel
+ *
+ * Description      This function records the processing time of the current
+ *                  command when the first frame of the response is received.
+ *
+ * param[in]        phNxpEse_Context_t*: connection context
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void phNxpEse_updateLatencyModel(phNxpEse_Context_t *nxpese_ctxt)
+{
+    phNxpEse_LatencyModel_t *pModel = &nxpese_ctxt->latencyModel;
+    phNxpEse_LatencyEntry_t *pEntry = NULL;
+    uint64_t elapsedUs              = 0;
+    int index                       = -1;
+    int i                           = 0;
+
+    if (!pModel->awaitingRsp) {
+        return;
+    }
+    pModel->awaitingRsp = FALSE;
+    elapsedUs           = sm_get_time_us() - pModel->cmdSentUs;
+    if (elapsedUs > UINT32_MAX) {
+        elapsedUs = UINT32_MAX;
+    }
+
+    index = phNxpEse_findLatencyEntry(pModel, pModel->cmdKey);
+    if (index < 0) {
+        /* Take a free entry or replace the least recently used one */
+        index = 0;
+        for (i = 0; i < PH_NXP_ESE_LATENCY_TABLE_SIZE; i++) {
+            if (pModel->entries[i].samples == 0) {
+                index = i;
+                break;
+            }
+            if (pModel->lastUse[i] < pModel->lastUse[index]) {
+                index = i;
+            }
+        }
+        phNxpEse_memset(&pModel->entries[index], 0x00, sizeof(pModel->entries[index]));
+        pModel->entries[index].cmdKey = pModel->cmdKey;
+    }
+
+    pEntry = &pModel->entries[index];
+    if (pEntry->samples == 0) {
+        pEntry->avgUs = (uint32_t)elapsedUs;
+        pEntry->minUs = (uint32_t)elapsedUs;
+        pEntry->maxUs = (uint32_t)elapsedUs;
+    }
+    else {
+        /* Exponential moving average, weight 1/8 for the new sample */
+        pEntry->avgUs = (uint32_t)(((uint64_t)pEntry->avgUs * 7 + elapsedUs) / 8);
+        if (elapsedUs < pEntry->minUs) {
+            pEntry->minUs = (uint32_t)elapsedUs;
+        }
+        if (elapsedUs > pEntry->maxUs) {
+            pEntry->maxUs = (uint32_t)elapsedUs;
+        }
+    }
+    if (pEntry->samples < UINT32_MAX) {
+        pEntry->samples++;
+    }
+    pModel->lastUse[index] = ++pModel->useCounter;
+}
+
+/******************************************************************************
+ * Function         phNxpEse_tapFrame
+ *
+ * Description      This function passes a frame written to or read from the
+ *                  ESE to the frame tap of the connection.
+ *
+ * param[in]        phNxpEse_Context_t*: connection context
+ * param[in]        phPalEse_TapDirection: direction of the frame
+ * param[in]        uint64_t: start of the transfer (sm_get_time_ns)
+ * param[in]        phPalEse_IoVec_t*: pieces of the frame
+ * param[in]        uint8_t: number of pieces
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void phNxpEse_tapFrame(phNxpEse_Context_t *nxpese_ctxt,
+    phPalEse_TapDirection direction,
+    uint64_t startNs,
+    const phPalEse_IoVec_t *pIov,
+    uint8_t iovCnt)
+{
+    phPalEse_TapInfo_t info = {0};
+
+    info.endNs     = sm_get_time_ns();
+    info.direction = direction;
+    info.startNs   = startNs;
+    if (direction == PH_PAL_ESE_TAP_DIR_RX) {
+        info.pollCount   = (nxpese_ctxt->pollCount > 0) ? (uint32_t)nxpese_ctxt->pollCount : 0;
+        info.readStartNs = nxpese_ctxt->tapReadStartNs;
+    }
+    nxpese_ctxt->frameTap.record(nxpese_ctxt->frameTap.pTapCtx, &info, pIov, iovCnt);
+}
+
 /******************************************************************************
  * Function         phNxpEse_memset
  *
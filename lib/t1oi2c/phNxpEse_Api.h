@@ -23,6 +23,7 @@
 #define _PHNXPESE_API_H_
 
 #include "phEseStatus.h"
+#include "phNxpEsePal_i2c.h"
 
 typedef enum
 {
@@ -31,6 +32,17 @@ typedef enum
     ESE_MODE_RESUME      /*!< Session Resume mode */
 } phNxpEse_initMode;
 
+/**
+ *
+ * \brief How a connection waits for the ESE between polls and before writes
+ *
+ */
+typedef enum
+{
+    ESE_POLL_SLEEP = 0, /*!< Sleep, the CPU is free while the ESE processes (default) */
+    ESE_POLL_BUSY,      /*!< Spin on the clock without sleeping, lowest latency but occupies a CPU */
+} phNxpEse_pollMode;
+
 /**
  *
  * \brief Ese data buffer
@@ -50,16 +62,133 @@ typedef struct phNxpEse_data
 typedef struct phNxpEse_initParams
 {
     phNxpEse_initMode initMode; /*!< Ese communication mode */
+    phNxpEse_pollMode pollMode; /*!< Waiting of the connection, used by phNxpEse_open */
 } phNxpEse_initParams;
 
+/**
+ *
+ * \brief Command identification used by the latency model (INS, P1, P2 of the C-APDU)
+ *
+ */
+#define PH_NXP_ESE_CMD_KEY(INS, P1, P2) ((((uint32_t)(INS)) << 16) | (((uint32_t)(P1)) << 8) | ((uint32_t)(P2)))
+
+/** No command identification, the latency model is not used */
+#define PH_NXP_ESE_CMD_KEY_NONE (0)
+
+/**
+ *
+ * \brief Bytes a caller reserves before / after a C-APDU so that its
+ * I-frames can be framed in place (NAD, PCB, LEN before, CRC after).
+ * See phNxpEse_setTxRoom.
+ *
+ */
+#define PH_NXP_ESE_TX_HEADROOM (4)
+#define PH_NXP_ESE_TX_TAILROOM (2)
+
+/**
+ *
+ * \brief Events passed to phNxpEse_TransceiveStep
+ *
+ */
+typedef enum
+{
+    ESE_STEP_EVT_TIMER = 0, /*!< First step, or the wait time of the last step expired */
+    ESE_STEP_EVT_READABLE,  /*!< The SE signalled data ready (e.g. interrupt line) */
+} phNxpEse_StepEvent;
+
+/**
+ *
+ * \brief Result of one step of a non-blocking exchange
+ *
+ */
+typedef enum
+{
+    ESE_STEP_DONE = 0,      /*!< Exchange completed successfully */
+    ESE_STEP_FAILED,        /*!< Exchange failed */
+    ESE_STEP_WAIT_TIME,     /*!< Step again after the wait time */
+    ESE_STEP_WAIT_READABLE, /*!< Step again when the SE is readable, at the latest after the wait time */
+    ESE_STEP_WAIT_WTX,      /*!< SE asked for more time (S(WTX)), other work can be done until the wait time */
+    ESE_STEP_TIMEOUT,       /*!< Deadline of the exchange reached, the exchange is abandoned */
+} phNxpEse_StepResult;
+
+/**
+ *
+ * \brief Waiting time extensions requested by the SE during the last transceive
+ *
+ */
+typedef struct phNxpEse_WtxInfo
+{
+    uint32_t cmdKey;     /*!< PH_NXP_ESE_CMD_KEY of the command, PH_NXP_ESE_CMD_KEY_NONE if not set */
+    uint32_t count;      /*!< Number of S(WTX) requests */
+    uint32_t durationUs; /*!< Time from the first S(WTX) request to the end of the transceive */
+} phNxpEse_WtxInfo_t;
+
+/**
+ *
+ * \brief Protocol counters of a connection. The counters only grow from the
+ * open of the connection, the times are in microseconds.
+ *
+ */
+typedef struct phNxpEse_Stats
+{
+    uint32_t transceives;    /*!< Transceives done */
+    uint32_t failures;       /*!< Transceives that failed, timeouts included */
+    uint32_t timeouts;       /*!< Transceives abandoned at their deadline */
+    uint32_t framesSent;     /*!< Frames written, all types */
+    uint32_t framesReceived; /*!< Frames read, with a wrong CRC included */
+    uint32_t retransmits;    /*!< Frames sent again because the ESE reported an error or did not answer */
+    uint32_t rnacksSent;     /*!< R-NACK frames sent */
+    uint32_t rnacksReceived; /*!< R-NACK frames received */
+    uint32_t crcErrors;      /*!< Frames received with a wrong CRC */
+    uint32_t rxFailures;     /*!< Frames expected but not received */
+    uint32_t wtxRequests;    /*!< S(WTX) requests received */
+    uint32_t resyncs;        /*!< S(RESYNCH) requests sent */
+    uint32_t intfResets;     /*!< Interface (software) resets sent */
+    uint32_t chipResets;     /*!< Chip (cold) resets sent */
+    uint64_t sendUs;         /*!< Time spent writing frames */
+    uint64_t rspWaitUs;      /*!< Time spent waiting for and reading the frames of the ESE */
+    uint64_t wtxUs;          /*!< Time spent waiting while the ESE worked on an S(WTX) extension */
+    uint64_t delayUs;        /*!< Time spent in error recovery delays before sending a frame */
+} phNxpEse_Stats_t;
+
+/** Number of commands tracked by the latency model of a connection */
+#define PH_NXP_ESE_LATENCY_TABLE_SIZE (16)
+
+/**
+ *
+ * \brief Learned processing time of a command: time from sending the
+ * last frame of the C-APDU until the first SOF of the SE reply
+ *
+ */
+typedef struct phNxpEse_LatencyEntry
+{
+    uint32_t cmdKey;  /*!< PH_NXP_ESE_CMD_KEY of the command */
+    uint32_t avgUs;   /*!< Smoothed processing time in microseconds */
+    uint32_t minUs;   /*!< Shortest processing time in microseconds */
+    uint32_t maxUs;   /*!< Longest processing time in microseconds */
+    uint32_t samples; /*!< Number of measurements */
+} phNxpEse_LatencyEntry_t;
+
 ESESTATUS phNxpEse_init(void *conn_ctx, phNxpEse_initParams initParams, phNxpEse_data *AtrRsp);
 ESESTATUS phNxpEse_open(void **conn_ctx, phNxpEse_initParams initParams, const char *pConnString);
 ESESTATUS phNxpEse_Transceive(void *conn_ctx, phNxpEse_data *pCmd, phNxpEse_data *pRsp);
+ESESTATUS phNxpEse_TransceiveStart(void *conn_ctx, phNxpEse_data *pCmd, phNxpEse_data *pRsp);
+phNxpEse_StepResult phNxpEse_TransceiveStep(void *conn_ctx, phNxpEse_StepEvent event, uint32_t *pWaitUs);
 ESESTATUS phNxpEse_deInit(void *conn_ctx);
 ESESTATUS phNxpEse_close(void *conn_ctx);
 ESESTATUS phNxpEse_reset(void *conn_ctx);
 ESESTATUS phNxpEse_chipReset(void *conn_ctx);
-ESESTATUS phNxpEse_setIfsc(uint16_t IFSC_Size);
+ESESTATUS phNxpEse_setIfsc(void *conn_ctx, uint16_t IFSC_Size);
+ESESTATUS phNxpEse_getIfs(void *conn_ctx, uint16_t *pIfsc, uint16_t *pIfsd);
+ESESTATUS phNxpEse_setReadyNotifier(void *conn_ctx, const phPalEse_ReadyNotifier_t *pNotifier);
+ESESTATUS phNxpEse_setFrameTap(void *conn_ctx, const phPalEse_FrameTap_t *pTap);
+ESESTATUS phNxpEse_setTxRoom(void *conn_ctx, uint32_t headroom, uint32_t tailroom);
+ESESTATUS phNxpEse_setCmdKey(void *conn_ctx, uint32_t cmdKey);
+ESESTATUS phNxpEse_setDeadline(void *conn_ctx, uint64_t deadlineUs);
+ESESTATUS phNxpEse_getLatencyModel(void *conn_ctx, phNxpEse_LatencyEntry_t *pEntries, size_t *pNumEntries);
+ESESTATUS phNxpEse_resetLatencyModel(void *conn_ctx);
+ESESTATUS phNxpEse_getWtxInfo(void *conn_ctx, phNxpEse_WtxInfo_t *pWtxInfo);
+ESESTATUS phNxpEse_getStats(void *conn_ctx, phNxpEse_Stats_t *pStats);
 ESESTATUS phNxpEse_EndOfApdu(void *conn_ctx);
 void *phNxpEse_memset(void *buff, int val, size_t len);
 void *phNxpEse_memcpy(void *dest, const void *src, size_t len);
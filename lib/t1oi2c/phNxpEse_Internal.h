@@ -17,6 +17,7 @@
 #define _PHNXPESE_INTERNAL_H_
 
 #include <phNxpEse_Api.h>
+#include <phNxpEseProto7816_3.h>
 #include "sm_i2c.h"
 
 #ifdef T1oI2C_UM1225_SE050
@@ -35,6 +36,17 @@ typedef enum
     ESE_STATUS_OPEN,
 } phNxpEse_LibStatus;
 
+/* Learned command processing times of a connection */
+typedef struct phNxpEse_LatencyModel
+{
+    phNxpEse_LatencyEntry_t entries[PH_NXP_ESE_LATENCY_TABLE_SIZE];
+    uint32_t lastUse[PH_NXP_ESE_LATENCY_TABLE_SIZE]; /* Use stamp of the entry, the oldest entry is replaced */
+    uint32_t useCounter;
+    uint32_t cmdKey;    /* Command currently exchanged, PH_NXP_ESE_CMD_KEY_NONE if unknown */
+    bool_t awaitingRsp; /* Last frame of the command is sent, processing time is being measured */
+    uint64_t cmdSentUs; /* Time stamp of sending the last frame of the command */
+} phNxpEse_LatencyModel_t;
+
 /* I2C Control structure */
 typedef struct phNxpEse_Context
 {
@@ -45,11 +57,47 @@ typedef struct phNxpEse_Context
     //uint16_t cmd_len;
     //uint8_t p_cmd_data[MAX_APDU_BUFFER];
     phNxpEse_initParams initParams;
+    bool_t isDynamicCtx;                    /* Context is heap allocated by phNxpEse_open and released on close */
+    phNxpEseProto7816_t protoCntx;          /* T=1oI2C protocol state of this connection */
+    int poll_sof_chained_delay;             /* Last received frame was chained, poll with chained packet delay */
+    phPalEse_ReadyNotifier_t readyNotifier; /* Data ready notifier, polling is used when not set */
+    phNxpEse_LatencyModel_t latencyModel;   /* Processing time per command, used to schedule polling */
+    bool_t isFrameReadDisabled;             /* Frames cannot be read in one transfer, read in parts */
+    bool_t isWriteVDisabled;                /* Frame pieces cannot be written in one transfer, copy them */
+    uint32_t txHeadroom;                    /* Writable bytes before the C-APDU of the transceive */
+    uint32_t txTailroom;                    /* Writable bytes after the C-APDU of the transceive */
+    uint8_t *pRxTarget;                     /* Final position of the INF field of the next I-frame, NULL if none */
+    uint32_t rxTargetLen;                   /* Bytes available at pRxTarget */
+    bool_t isRxTargetScratch;               /* All bytes at pRxTarget may be overwritten, not only the INF field */
+    uint8_t *pRxInf;                        /* INF field of the last frame read, in p_read_buff or at pRxTarget */
+    int pollCount;                          /* Polls done for the frame being read */
+    int pollCountMax;                       /* Max. polls for the frame being read */
+    uint32_t pollDelayUs;                   /* Delay of the next backoff round, 0 for regular polling */
+    phNxpEse_data *pStepRsp;                /* Response of the transceive driven by phNxpEse_TransceiveStep */
+    phNxpEse_WtxInfo_t lastWtx;             /* S(WTX) requests of the last transceive */
+    uint64_t deadlineUs;                    /* End of the time budget of the transceive (sm_get_time_us), 0 if none */
+    phNxpEse_Stats_t stats;                 /* Protocol counters since the connection was opened */
+    phPalEse_FrameTap_t frameTap;           /* Receives every raw frame, not used when not set */
+    uint64_t tapReadStartNs;                /* Start of the read of the frame being read, for the frame tap */
 } phNxpEse_Context_t;
 
+/* ESE Context used when no connection context is passed */
+extern phNxpEse_Context_t gnxpese_ctxt;
+
 ESESTATUS phNxpEse_WriteFrame(void *conn_ctx, uint32_t data_len, const uint8_t *p_data);
+ESESTATUS phNxpEse_WriteFrameV(void *conn_ctx, const phPalEse_IoVec_t *pIov, uint8_t iovCnt);
 ESESTATUS phNxpEse_read(void *conn_ctx, uint32_t *data_len, uint8_t **pp_data);
+ESESTATUS phNxpEse_startRead(void *conn_ctx, uint32_t *pWaitUs);
+ESESTATUS phNxpEse_tryRead(void *conn_ctx, uint32_t *data_len, uint8_t **pp_data, uint32_t *pWaitUs);
+void phNxpEse_waitForData(void *conn_ctx, uint32_t waitUs);
+void phNxpEse_delay(void *conn_ctx, uint32_t waitUs);
+void phNxpEse_stopRead(void *conn_ctx);
+uint64_t phNxpEse_getDeadline(void *conn_ctx);
+phNxpEse_Stats_t *phNxpEse_getStatsCntx(void *conn_ctx);
+void phNxpEse_setRxTarget(void *conn_ctx, uint8_t *pTarget, uint32_t targetLen, bool_t isScratch);
+uint8_t *phNxpEse_getRxInf(void *conn_ctx);
 void phNxpEse_clearReadBuffer(void *conn_ctx);
 void phNxpEse_waitForWTX(void *conn_ctx);
+void phNxpEse_startRspTimer(void *conn_ctx);
 
 #endif /* _PHNXPESE_INTERNAL_H_ */
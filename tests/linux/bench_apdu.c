@@ -0,0 +1,356 @@
+/** @file bench_apdu.c
+ *  @brief Host side cost per APDU: TLV building, secure messaging and T=1 framing.
+ *
+ * The SE is simulated in-process (se05x_sim) behind the loopback transport, so no
+ * bus or socket is involved. The time spent in the simulator is taken off every
+ * exchange, what remains is the cost of the host stack for the APDU.
+ *
+ * Copyright 2024 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* ********************** Include files ********************** */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "se05x_APDU_apis.h"
+#include "se05x_sim.h"
+#include "phNxpEsePal_i2c.h"
+#include "smCom.h"
+#include "sm_timer.h"
+#include "sm_port.h"
+#include "test_se05x.h"
+
+/* ********************** Defines ********************** */
+#define BENCH_APDU_KEY_ID 0x7B000191
+#define BENCH_APDU_BIN_ID 0x7B000192
+#define BENCH_APDU_BIN_LEN 200
+#define BENCH_APDU_CHAIN_ID 0x7B000193
+#define BENCH_APDU_CHAIN_LEN 2048
+/* Chunk of the former application level chunking (Qi example) */
+#define BENCH_APDU_CHAIN_CHUNK 128
+#define BENCH_APDU_DEFAULT_COUNT 2000
+#define BENCH_APDU_WARMUP 20
+
+/* ********************** Data types ********************** */
+
+/* Loopback peer measuring the time spent in the simulator */
+typedef struct
+{
+    phPalEse_LoopbackPeer_t sim;
+    uint64_t peerNs;
+} bench_apdu_peer_t;
+
+/* ********************** Global variables ********************** */
+static int gSessionFailed = 0;
+static bench_apdu_peer_t gPeer;
+static Se05xPreparedCmd_t gSignCmd;
+static uint8_t gBinData[BENCH_APDU_BIN_LEN];
+static uint8_t gChainData[BENCH_APDU_CHAIN_LEN];
+
+/* ********************** Functions ********************** */
+
+/* Called by test_setup / test_teardown */
+void test_fail(void)
+{
+    gSessionFailed = 1;
+}
+
+static void bench_apdu_usage(const char *pName)
+{
+    printf("Usage: %s [options]\n", pName);
+    printf("  -n <count>   APDUs per command, default %d\n", BENCH_APDU_DEFAULT_COUNT);
+}
+
+static ESESTATUS bench_apdu_peer_receive(void *pPeerCtx, const uint8_t *pData, uint32_t len)
+{
+    bench_apdu_peer_t *pPeer = (bench_apdu_peer_t *)pPeerCtx;
+    uint64_t startNs         = sm_get_time_ns();
+    ESESTATUS status         = pPeer->sim.receive(pPeer->sim.pPeerCtx, pData, len);
+
+    pPeer->peerNs += sm_get_time_ns() - startNs;
+    return status;
+}
+
+static ESESTATUS bench_apdu_peer_send(void *pPeerCtx, uint8_t *pBuffer, uint32_t len)
+{
+    bench_apdu_peer_t *pPeer = (bench_apdu_peer_t *)pPeerCtx;
+    uint64_t startNs         = sm_get_time_ns();
+    ESESTATUS status         = pPeer->sim.send(pPeer->sim.pPeerCtx, pBuffer, len);
+
+    pPeer->peerNs += sm_get_time_ns() - startNs;
+    return status;
+}
+
+static int bench_apdu_compare(const void *pA, const void *pB)
+{
+    uint64_t a = *(const uint64_t *)pA;
+    uint64_t b = *(const uint64_t *)pB;
+    return (a > b) - (a < b);
+}
+
+static void bench_apdu_print(const char *pName, uint64_t *pNs, size_t n)
+{
+    uint64_t totalNs = 0;
+    size_t i         = 0;
+
+    qsort(pNs, n, sizeof(uint64_t), &bench_apdu_compare);
+    for (i = 0; i < n; i++) {
+        totalNs += pNs[i];
+    }
+    printf("%-13s %10.2f %10.2f %10.2f %10.2f\n",
+        pName,
+        (double)totalNs / (double)n / 1000.0,
+        (double)pNs[0] / 1000.0,
+        (double)pNs[n / 2] / 1000.0,
+        (double)pNs[(n * 99) / 100] / 1000.0);
+}
+
+static smStatus_t bench_apdu_get_version(void)
+{
+    uint8_t version[32] = {0};
+    size_t versionLen   = sizeof(version);
+
+    return Se05x_API_GetVersion(&se05x_session, version, &versionLen);
+}
+
+static smStatus_t bench_apdu_read_object(void)
+{
+    uint8_t data[BENCH_APDU_BIN_LEN] = {0};
+    size_t dataLen                   = sizeof(data);
+
+    return Se05x_API_ReadObject(&se05x_session, BENCH_APDU_BIN_ID, 0, 0, data, &dataLen);
+}
+
+static smStatus_t bench_apdu_read_object_view(void)
+{
+    const uint8_t *pData = NULL;
+    size_t dataLen       = 0;
+
+    return Se05x_API_ReadObjectView(&se05x_session, BENCH_APDU_BIN_ID, 0, 0, &pData, &dataLen);
+}
+
+static smStatus_t bench_apdu_read_chain_chunk(void)
+{
+    smStatus_t status = SM_NOT_OK;
+    size_t dataLen    = 0;
+    uint16_t offset   = 0;
+
+    for (offset = 0; offset < BENCH_APDU_CHAIN_LEN; offset += BENCH_APDU_CHAIN_CHUNK) {
+        dataLen = BENCH_APDU_CHAIN_CHUNK;
+        status  = Se05x_API_ReadObject(
+            &se05x_session, BENCH_APDU_CHAIN_ID, offset, BENCH_APDU_CHAIN_CHUNK, &gChainData[offset], &dataLen);
+        if (status != SM_OK) {
+            break;
+        }
+    }
+    return status;
+}
+
+static smStatus_t bench_apdu_read_chain_stream(void)
+{
+    size_t dataLen = sizeof(gChainData);
+
+    return Se05x_API_ReadObjectChunked(&se05x_session, BENCH_APDU_CHAIN_ID, 0, 0, gChainData, &dataLen);
+}
+
+static smStatus_t bench_apdu_write_binary(void)
+{
+    return Se05x_API_WriteBinary(&se05x_session, NULL, BENCH_APDU_BIN_ID, 0, 0, gBinData, sizeof(gBinData));
+}
+
+static smStatus_t bench_apdu_write_chain_chunk(void)
+{
+    smStatus_t status = SM_NOT_OK;
+    uint16_t offset   = 0;
+
+    for (offset = 0; offset < BENCH_APDU_CHAIN_LEN; offset += BENCH_APDU_CHAIN_CHUNK) {
+        status = Se05x_API_WriteBinary(
+            &se05x_session, NULL, BENCH_APDU_CHAIN_ID, offset, 0, &gChainData[offset], BENCH_APDU_CHAIN_CHUNK);
+        if (status != SM_OK) {
+            break;
+        }
+    }
+    return status;
+}
+
+static smStatus_t bench_apdu_write_chain_stream(void)
+{
+    /* Object exists, overwrite its content */
+    Se05xWriteProgress_t progress = {0, 1};
+
+    return Se05x_API_WriteBinaryChunked(
+        &se05x_session, NULL, BENCH_APDU_CHAIN_ID, gChainData, sizeof(gChainData), &progress);
+}
+
+static smStatus_t bench_apdu_sign(void)
+{
+    uint8_t digest[32]     = {0};
+    uint8_t signature[128] = {0};
+    size_t signatureLen    = sizeof(signature);
+
+    return Se05x_API_ECDSASign(&se05x_session,
+        BENCH_APDU_KEY_ID,
+        kSE05x_ECSignatureAlgo_SHA_256,
+        digest,
+        sizeof(digest),
+        signature,
+        &signatureLen);
+}
+
+static smStatus_t bench_apdu_sign_view(void)
+{
+    uint8_t digest[32]        = {0};
+    const uint8_t *pSignature = NULL;
+    size_t signatureLen       = 0;
+
+    return Se05x_API_ECDSASignView(&se05x_session,
+        BENCH_APDU_KEY_ID,
+        kSE05x_ECSignatureAlgo_SHA_256,
+        digest,
+        sizeof(digest),
+        &pSignature,
+        &signatureLen);
+}
+
+static smStatus_t bench_apdu_sign_prepared(void)
+{
+    uint8_t digest[32]     = {0};
+    uint8_t signature[128] = {0};
+    size_t signatureLen    = sizeof(signature);
+
+    return Se05x_API_PreparedECDSASign(&gSignCmd, digest, sizeof(digest), signature, &signatureLen);
+}
+
+/**
+* Issues the command count times, the host side cost of each is stored in pNs
+*/
+static smStatus_t bench_apdu_run(const char *pName, smStatus_t (*pCommand)(void), uint64_t *pNs, size_t count)
+{
+    smStatus_t status = SM_NOT_OK;
+    uint64_t startNs  = 0;
+    uint64_t peerNs   = 0;
+    size_t i          = 0;
+
+    for (i = 0; i < (BENCH_APDU_WARMUP + count); i++) {
+        peerNs  = gPeer.peerNs;
+        startNs = sm_get_time_ns();
+        status  = pCommand();
+        if (status != SM_OK) {
+            SMLOG_E("Bench: Error in %s \n", pName);
+            return status;
+        }
+        if (i >= BENCH_APDU_WARMUP) {
+            pNs[i - BENCH_APDU_WARMUP] = (sm_get_time_ns() - startNs) - (gPeer.peerNs - peerNs);
+        }
+    }
+    bench_apdu_print(pName, pNs, count);
+    return SM_OK;
+}
+
+int main(int argc, char **argv)
+{
+    int ret                            = 1;
+    int opt                            = 0;
+    size_t count                       = BENCH_APDU_DEFAULT_COUNT;
+    se05x_sim_config_t simConfig       = {0};
+    se05x_sim_t *pSim                  = NULL;
+    phPalEse_LoopbackPeer_t peer       = {0};
+    phPalEse_ReadyNotifier_t ready     = {0};
+    test_se05x_sim_notifier_t simReady = {0};
+    Se05xWriteProgress_t chainProgress = {0};
+    uint64_t *pNs                      = NULL;
+    smStatus_t status                  = SM_NOT_OK;
+
+    while ((opt = getopt(argc, argv, "n:h")) != -1) {
+        switch (opt) {
+        case 'n':
+            count = (size_t)strtoul(optarg, NULL, 0);
+            break;
+        default:
+            bench_apdu_usage(argv[0]);
+            return 1;
+        }
+    }
+    if ((optind != argc) || (count == 0)) {
+        bench_apdu_usage(argv[0]);
+        return 1;
+    }
+
+    pNs = (uint64_t *)malloc(count * sizeof(uint64_t));
+    ENSURE_OR_GO_CLEANUP(pNs != NULL);
+
+    se05x_sim_config_init(&simConfig);
+    pSim = se05x_sim_create(&simConfig);
+    ENSURE_OR_GO_CLEANUP(pSim != NULL);
+    se05x_sim_loopback_peer(pSim, &gPeer.sim);
+    peer.receive  = &bench_apdu_peer_receive;
+    peer.send     = &bench_apdu_peer_send;
+    peer.pPeerCtx = &gPeer;
+    phPalEse_loopback_setPeer(&peer);
+
+    se05x_session.pConnString = "loop:";
+    test_setup();
+    if (gSessionFailed) {
+        SMLOG_E("Bench: Error in opening the session \n");
+        goto cleanup;
+    }
+    /* The simulator has answered by the time the host reads, data is ready without delay.
+     * Keeps the poll delays out of the numbers. */
+    test_se05x_sim_notifier_init(&ready, &simReady);
+    status = smComT1oI2C_SetReadyNotifier(se05x_session.conn_context, &ready);
+    ENSURE_OR_GO_CLEANUP(status == SM_OK);
+
+    memset(gBinData, 0xA5, sizeof(gBinData));
+    status = Se05x_API_WriteECKey(&se05x_session,
+        NULL,
+        0,
+        BENCH_APDU_KEY_ID,
+        kSE05x_ECCurve_NIST_P256,
+        NULL,
+        0,
+        NULL,
+        0,
+        kSE05x_INS_NA,
+        kSE05x_KeyPart_Pair);
+    ENSURE_OR_GO_CLEANUP(status == SM_OK);
+    status = Se05x_API_WriteBinary(
+        &se05x_session, NULL, BENCH_APDU_BIN_ID, 0, sizeof(gBinData), gBinData, sizeof(gBinData));
+    ENSURE_OR_GO_CLEANUP(status == SM_OK);
+    status = Se05x_API_WriteBinaryChunked(
+        &se05x_session, NULL, BENCH_APDU_CHAIN_ID, gChainData, sizeof(gChainData), &chainProgress);
+    ENSURE_OR_GO_CLEANUP(status == SM_OK);
+    status = Se05x_API_PrepareECDSASign(&se05x_session, BENCH_APDU_KEY_ID, kSE05x_ECSignatureAlgo_SHA_256, &gSignCmd);
+    ENSURE_OR_GO_CLEANUP(status == SM_OK);
+
+    printf("Host side cost per APDU, %lu APDUs per command\n", (unsigned long)count);
+    printf("%-13s %10s %10s %10s %10s\n", "us", "mean", "min", "p50", "p99");
+    ENSURE_OR_GO_CLEANUP(bench_apdu_run("GetVersion", &bench_apdu_get_version, pNs, count) == SM_OK);
+    ENSURE_OR_GO_CLEANUP(bench_apdu_run("ReadObject", &bench_apdu_read_object, pNs, count) == SM_OK);
+    ENSURE_OR_GO_CLEANUP(bench_apdu_run("ReadObjView", &bench_apdu_read_object_view, pNs, count) == SM_OK);
+    ENSURE_OR_GO_CLEANUP(bench_apdu_run("Read2K/128", &bench_apdu_read_chain_chunk, pNs, count) == SM_OK);
+    ENSURE_OR_GO_CLEANUP(bench_apdu_run("Read2KStream", &bench_apdu_read_chain_stream, pNs, count) == SM_OK);
+    ENSURE_OR_GO_CLEANUP(bench_apdu_run("WriteBinary", &bench_apdu_write_binary, pNs, count) == SM_OK);
+    ENSURE_OR_GO_CLEANUP(bench_apdu_run("Write2K/128", &bench_apdu_write_chain_chunk, pNs, count) == SM_OK);
+    ENSURE_OR_GO_CLEANUP(bench_apdu_run("Write2KStream", &bench_apdu_write_chain_stream, pNs, count) == SM_OK);
+    ENSURE_OR_GO_CLEANUP(bench_apdu_run("ECDSASign", &bench_apdu_sign, pNs, count) == SM_OK);
+    ENSURE_OR_GO_CLEANUP(bench_apdu_run("SignView", &bench_apdu_sign_view, pNs, count) == SM_OK);
+    ENSURE_OR_GO_CLEANUP(bench_apdu_run("SignPrepared", &bench_apdu_sign_prepared, pNs, count) == SM_OK);
+    printf("Data ready waits: %lu\n", (unsigned long)simReady.waitCount);
+    ret = 0;
+
+cleanup:
+    if (se05x_session.conn_context != NULL) {
+        Se05x_API_DeleteSecureObject(&se05x_session, BENCH_APDU_KEY_ID);
+        Se05x_API_DeleteSecureObject(&se05x_session, BENCH_APDU_BIN_ID);
+        Se05x_API_DeleteSecureObject(&se05x_session, BENCH_APDU_CHAIN_ID);
+        test_teardown(NULL);
+    }
+    if (pSim != NULL) {
+        se05x_sim_destroy(pSim);
+    }
+    free(pNs);
+    return ret;
+}
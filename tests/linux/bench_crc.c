@@ -0,0 +1,59 @@
+/** @file bench_crc.c
+ *  @brief Throughput of the T=1oI2C CRC variants.
+ *
+ * Copyright 2024 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* ********************** Include files ********************** */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "phNxpEseCrc.h"
+#include "sm_timer.h"
+
+/* ********************** Defines ********************** */
+/* Frame sizes: S-block, short APDU, IFSC 254 frame, chained data */
+static const size_t gLengths[] = {5, 32, 64, 258, 1024, 4096};
+#define BENCH_CRC_TOTAL_BYTES (64u * 1024u * 1024u)
+
+/* ********************** Functions ********************** */
+
+int main(int argc, char **argv)
+{
+    static uint8_t buffer[4096];
+    volatile uint16_t sink = 0;
+    uint32_t total         = BENCH_CRC_TOTAL_BYTES;
+
+    if (argc > 1) {
+        total = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+    for (size_t i = 0; i < sizeof(buffer); i++) {
+        buffer[i] = (uint8_t)(i * 31 + 7);
+    }
+
+    printf("%-8s %8s %12s\n", "variant", "length", "bytes/ns");
+    for (int impl = 0; impl < kPhNxpEseCrc_Max; impl++) {
+        phNxpEseCrc_UpdateFn_t fn = phNxpEseCrc_GetUpdateFn((phNxpEseCrc_Impl_t)impl);
+        if (fn == NULL) {
+            printf("%-8s %8s %12s\n", phNxpEseCrc_GetImplName((phNxpEseCrc_Impl_t)impl), "-", "unsupported");
+            continue;
+        }
+        for (size_t l = 0; l < sizeof(gLengths) / sizeof(gLengths[0]); l++) {
+            /* The reference is slow, run it on a sixteenth of the data */
+            uint32_t bytes   = (impl == kPhNxpEseCrc_Bitwise) ? (total / 16) : total;
+            uint32_t rounds  = (bytes / gLengths[l]) + 1;
+            uint64_t startUs = sm_get_time_us();
+            for (uint32_t r = 0; r < rounds; r++) {
+                sink ^= fn((uint16_t)r, buffer, gLengths[l]);
+            }
+            uint64_t elapsedUs = sm_get_time_us() - startUs;
+            printf("%-8s %8zu %12.3f\n",
+                phNxpEseCrc_GetImplName((phNxpEseCrc_Impl_t)impl),
+                gLengths[l],
+                (elapsedUs == 0) ? 0.0 : ((double)rounds * gLengths[l]) / ((double)elapsedUs * 1000.0));
+        }
+    }
+    printf("Active variant: %s\n", phNxpEseCrc_GetImplName(phNxpEseCrc_GetActiveImpl()));
+    return (sink == 0x1234) ? 1 : 0;
+}
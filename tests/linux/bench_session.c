@@ -0,0 +1,184 @@
+/** @file bench_session.c
+ *  @brief Time to the first APDU with a new link and on an open link.
+ *
+ * The full path opens the link and the applet session (Se05x_API_SessionOpen),
+ * the reconnect path only reopens the applet session on a link that stays
+ * open (Se05x_API_AppletSessionOpen). In both cases the time until the
+ * response of the first APDU (GetVersion) is measured.
+ *
+ * Copyright 2024 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* ********************** Include files ********************** */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "se05x_APDU_apis.h"
+#include "sm_timer.h"
+#include "sm_port.h"
+#include "test_se05x.h"
+
+/* ********************** Defines ********************** */
+#define BENCH_SESSION_DEFAULT_COUNT 50
+
+/* ********************** Global variables ********************** */
+static int gSessionFailed = 0;
+
+/* ********************** Functions ********************** */
+
+/* Called by test_setup / test_teardown */
+void test_fail(void)
+{
+    gSessionFailed = 1;
+}
+
+static void bench_session_usage(const char *pName)
+{
+    printf("Usage: %s [options]\n", pName);
+    printf("  -n <count>   Session opens per path, default %d\n", BENCH_SESSION_DEFAULT_COUNT);
+    printf("  -p <port>    Connection string of the SE, default EX_SSS_BOOT_SSS_PORT\n");
+}
+
+static int bench_session_compare(const void *pA, const void *pB)
+{
+    uint64_t a = *(const uint64_t *)pA;
+    uint64_t b = *(const uint64_t *)pB;
+    return (a > b) - (a < b);
+}
+
+static void bench_session_print(const char *pName, uint64_t *pNs, size_t n)
+{
+    uint64_t totalNs = 0;
+    size_t i         = 0;
+
+    qsort(pNs, n, sizeof(uint64_t), &bench_session_compare);
+    for (i = 0; i < n; i++) {
+        totalNs += pNs[i];
+    }
+    printf("%-10s %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+        pName,
+        (double)totalNs / (double)n / 1000.0,
+        (double)pNs[0] / 1000.0,
+        (double)pNs[n / 2] / 1000.0,
+        (double)pNs[(n * 99) / 100] / 1000.0,
+        (double)pNs[n - 1] / 1000.0);
+}
+
+static smStatus_t bench_session_first_apdu(void)
+{
+    uint8_t version[32] = {0};
+    size_t versionLen   = sizeof(version);
+
+    return Se05x_API_GetVersion(&se05x_session, version, &versionLen);
+}
+
+/**
+* Opens link and applet session count times
+*/
+static smStatus_t bench_session_full(const char *pPort, uint64_t *pNs, size_t count)
+{
+    smStatus_t status = SM_NOT_OK;
+    uint64_t startNs  = 0;
+    size_t i          = 0;
+
+    for (i = 0; i < count; i++) {
+        se05x_session.pConnString = pPort;
+        startNs                   = sm_get_time_ns();
+        test_setup();
+        if (gSessionFailed) {
+            return SM_NOT_OK;
+        }
+        status = bench_session_first_apdu();
+        pNs[i] = sm_get_time_ns() - startNs;
+        test_teardown(NULL);
+        ENSURE_OR_RETURN_ON_ERROR((status == SM_OK) && (!gSessionFailed), SM_NOT_OK);
+    }
+    return SM_OK;
+}
+
+/**
+* Opens the link once and the applet session count times on it
+*/
+static smStatus_t bench_session_reconnect(const char *pPort, uint64_t *pNs, size_t count)
+{
+    smStatus_t status = SM_NOT_OK;
+    uint64_t startNs  = 0;
+    size_t i          = 0;
+
+    se05x_session.pConnString = pPort;
+    test_setup();
+    if (gSessionFailed) {
+        return SM_NOT_OK;
+    }
+    for (i = 0; i < count; i++) {
+        status = Se05x_API_AppletSessionClose(&se05x_session);
+        ENSURE_OR_GO_CLEANUP(status == SM_OK);
+        startNs = sm_get_time_ns();
+        status  = Se05x_API_AppletSessionOpen(&se05x_session);
+        ENSURE_OR_GO_CLEANUP(status == SM_OK);
+        status = bench_session_first_apdu();
+        pNs[i] = sm_get_time_ns() - startNs;
+        ENSURE_OR_GO_CLEANUP(status == SM_OK);
+    }
+
+cleanup:
+    test_teardown(NULL);
+    if (gSessionFailed) {
+        status = SM_NOT_OK;
+    }
+    return status;
+}
+
+int main(int argc, char **argv)
+{
+    int ret            = 1;
+    int opt            = 0;
+    size_t count       = BENCH_SESSION_DEFAULT_COUNT;
+    const char *pPort  = getenv("EX_SSS_BOOT_SSS_PORT");
+    uint64_t *pFullNs  = NULL;
+    uint64_t *pReconNs = NULL;
+
+    while ((opt = getopt(argc, argv, "n:p:h")) != -1) {
+        switch (opt) {
+        case 'n':
+            count = (size_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'p':
+            pPort = optarg;
+            break;
+        default:
+            bench_session_usage(argv[0]);
+            return 1;
+        }
+    }
+    if ((optind != argc) || (count == 0)) {
+        bench_session_usage(argv[0]);
+        return 1;
+    }
+
+    pFullNs  = (uint64_t *)malloc(count * sizeof(uint64_t));
+    pReconNs = (uint64_t *)malloc(count * sizeof(uint64_t));
+    ENSURE_OR_GO_CLEANUP((pFullNs != NULL) && (pReconNs != NULL));
+
+    if (bench_session_full(pPort, pFullNs, count) != SM_OK) {
+        SMLOG_E("Bench: Error in the full session open \n");
+        goto cleanup;
+    }
+    if (bench_session_reconnect(pPort, pReconNs, count) != SM_OK) {
+        SMLOG_E("Bench: Error in the applet session open \n");
+        goto cleanup;
+    }
+
+    printf("Time to first APDU, %lu session opens per path\n", (unsigned long)count);
+    printf("%-10s %10s %10s %10s %10s %10s\n", "us", "mean", "min", "p50", "p99", "max");
+    bench_session_print("full", pFullNs, count);
+    bench_session_print("reconnect", pReconNs, count);
+    ret = 0;
+
+cleanup:
+    free(pFullNs);
+    free(pReconNs);
+    return ret;
+}
@@ -0,0 +1,208 @@
+/** @file bench_sign.c
+ *  @brief ECDSA sign latency with sleep based and busy polling of the SE.
+ *
+ * Opens a session with the default sleep based polling and one with busy
+ * polling (Se05xIoConfig_t), signs the same digest count times in each and
+ * prints the latency distribution. The busy polling session can pin the
+ * thread to a CPU and run it with SCHED_FIFO.
+ *
+ * Copyright 2024 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* ********************** Include files ********************** */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "se05x_APDU_apis.h"
+#include "sm_timer.h"
+#include "sm_port.h"
+#include "test_se05x.h"
+
+/* ********************** Defines ********************** */
+#define BENCH_SIGN_KEY_ID 0x7B000190
+#define BENCH_SIGN_DEFAULT_COUNT 200
+#define BENCH_SIGN_WARMUP 5
+
+/* ********************** Global variables ********************** */
+static int gSessionFailed = 0;
+
+/* ********************** Functions ********************** */
+
+/* Called by test_setup / test_teardown */
+void test_fail(void)
+{
+    gSessionFailed = 1;
+}
+
+static void bench_sign_usage(const char *pName)
+{
+    printf("Usage: %s [options]\n", pName);
+    printf("  -n <count>   Signatures per polling mode, default %d\n", BENCH_SIGN_DEFAULT_COUNT);
+    printf("  -c <cpu>     Pin the thread to cpu for busy polling\n");
+    printf("  -f <prio>    Run the thread with SCHED_FIFO priority prio for busy polling\n");
+    printf("  -p <port>    Connection string of the SE, default EX_SSS_BOOT_SSS_PORT\n");
+}
+
+static int bench_sign_compare(const void *pA, const void *pB)
+{
+    uint64_t a = *(const uint64_t *)pA;
+    uint64_t b = *(const uint64_t *)pB;
+    return (a > b) - (a < b);
+}
+
+static void bench_sign_print(const char *pName, uint64_t *pNs, size_t n)
+{
+    uint64_t totalNs = 0;
+    size_t i         = 0;
+
+    qsort(pNs, n, sizeof(uint64_t), &bench_sign_compare);
+    for (i = 0; i < n; i++) {
+        totalNs += pNs[i];
+    }
+    printf("%-6s %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+        pName,
+        (double)totalNs / (double)n / 1000.0,
+        (double)pNs[0] / 1000.0,
+        (double)pNs[n / 2] / 1000.0,
+        (double)pNs[(n * 99) / 100] / 1000.0,
+        (double)pNs[n - 1] / 1000.0);
+}
+
+/**
+* Signs count times in a new session, the durations are stored in pNs
+*/
+static smStatus_t bench_sign_run(const char *pPort, const Se05xIoConfig_t *pIoConfig, uint64_t *pNs, size_t count)
+{
+    smStatus_t status       = SM_NOT_OK;
+    uint8_t digest[32]      = {0};
+    uint8_t signature[128]  = {0};
+    size_t signatureLen     = 0;
+    SE05x_ECCurve_t curveID = kSE05x_ECCurve_NIST_P256;
+    uint64_t startNs        = 0;
+    size_t i                = 0;
+
+    for (i = 0; i < sizeof(digest); i++) {
+        digest[i] = (uint8_t)i;
+    }
+
+    se05x_session.pConnString = pPort;
+    se05x_session.pIoConfig   = pIoConfig;
+    test_setup();
+    if (gSessionFailed) {
+        SMLOG_E("Bench: Error in opening the session \n");
+        return SM_NOT_OK;
+    }
+
+    if (se05x_object_exists(&se05x_session, BENCH_SIGN_KEY_ID)) {
+        curveID = kSE05x_ECCurve_NA;
+    }
+    status = Se05x_API_WriteECKey(&se05x_session,
+        NULL,
+        0,
+        BENCH_SIGN_KEY_ID,
+        curveID,
+        NULL,
+        0,
+        NULL,
+        0,
+        kSE05x_INS_NA,
+        kSE05x_KeyPart_Pair);
+    ENSURE_OR_GO_CLEANUP(status == SM_OK);
+
+    /* Let the latency model of the connection learn the sign command */
+    for (i = 0; i < (BENCH_SIGN_WARMUP + count); i++) {
+        signatureLen = sizeof(signature);
+        startNs      = sm_get_time_ns();
+        status       = Se05x_API_ECDSASign(&se05x_session,
+            BENCH_SIGN_KEY_ID,
+            kSE05x_ECSignatureAlgo_SHA_256,
+            digest,
+            sizeof(digest),
+            signature,
+            &signatureLen);
+        ENSURE_OR_GO_CLEANUP(status == SM_OK);
+        if (i >= BENCH_SIGN_WARMUP) {
+            pNs[i - BENCH_SIGN_WARMUP] = sm_get_time_ns() - startNs;
+        }
+    }
+
+cleanup:
+    test_teardown(NULL);
+    if (gSessionFailed) {
+        status = SM_NOT_OK;
+    }
+    return status;
+}
+
+int main(int argc, char **argv)
+{
+    int ret                  = 1;
+    int opt                  = 0;
+    size_t count             = BENCH_SIGN_DEFAULT_COUNT;
+    const char *pPort        = getenv("EX_SSS_BOOT_SSS_PORT");
+    Se05xIoConfig_t busyPoll = {0};
+    uint64_t *pSleepNs       = NULL;
+    uint64_t *pBusyNs        = NULL;
+
+    busyPoll.busyPoll = 1;
+    busyPoll.cpu      = -1;
+    while ((opt = getopt(argc, argv, "n:c:f:p:h")) != -1) {
+        switch (opt) {
+        case 'n':
+            count = (size_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'c':
+            busyPoll.cpu = (int)strtol(optarg, NULL, 0);
+            break;
+        case 'f':
+            busyPoll.fifoPriority = (int)strtol(optarg, NULL, 0);
+            break;
+        case 'p':
+            pPort = optarg;
+            break;
+        default:
+            bench_sign_usage(argv[0]);
+            return 1;
+        }
+    }
+    if ((optind != argc) || (count == 0)) {
+        bench_sign_usage(argv[0]);
+        return 1;
+    }
+
+    pSleepNs = (uint64_t *)malloc(count * sizeof(uint64_t));
+    pBusyNs  = (uint64_t *)malloc(count * sizeof(uint64_t));
+    ENSURE_OR_GO_CLEANUP((pSleepNs != NULL) && (pBusyNs != NULL));
+
+    /* Sleep based polling first, the busy polling session may pin the thread */
+    ENSURE_OR_GO_CLEANUP(bench_sign_run(pPort, NULL, pSleepNs, count) == SM_OK);
+    ENSURE_OR_GO_CLEANUP(bench_sign_run(pPort, &busyPoll, pBusyNs, count) == SM_OK);
+
+    /* Erase the key */
+    se05x_session.pConnString = pPort;
+    test_setup();
+    if (!gSessionFailed) {
+        Se05x_API_DeleteSecureObject(&se05x_session, BENCH_SIGN_KEY_ID);
+        test_teardown(NULL);
+    }
+
+    printf("ECDSA NIST P-256 sign, %lu signatures per mode", (unsigned long)count);
+    if (busyPoll.cpu >= 0) {
+        printf(", busy on CPU %d", busyPoll.cpu);
+    }
+    if (busyPoll.fifoPriority != 0) {
+        printf(", SCHED_FIFO %d", busyPoll.fifoPriority);
+    }
+    printf("\n%-6s %10s %10s %10s %10s %10s\n", "us", "mean", "min", "p50", "p99", "max");
+    bench_sign_print("sleep", pSleepNs, count);
+    bench_sign_print("busy", pBusyNs, count);
+    ret = 0;
+
+cleanup:
+    free(pSleepNs);
+    free(pBusyNs);
+    return ret;
+}
@@ -1,14 +1,16 @@
 /** @file main.c
  *  @brief Unit tests.
  *
- * Copyright 2021,2022 NXP
+ * Copyright 2021,2022,2024 NXP
  * SPDX-License-Identifier: Apache-2.0
  */
 
 /* ********************** Include files ********************** */
 #include <stdio.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include "test_se05x.h"
+#include "sm_apdu_trace.h"
 #include "sm_port.h"
 
 #define LOG_I(...)        \
@@ -33,6 +35,8 @@ uint8_t gPass   = 0;
 uint8_t gFail   = 0;
 uint8_t gIgnore = 0;
 
+Se05xApduTrace_t gApduTrace = {0};
+
 void test_fail(void)
 {
     // Do nothing
@@ -134,19 +138,56 @@ void test_run_se05x_nist256_ecdh(void)
         LOG_W(" IGNORE - test_se05x_nist256_ecdh");
     }
 }
+void test_run_se05x_tlv(void)
+{
+    uint8_t pass   = gPass;
+    uint8_t fail   = gFail;
+    uint8_t ignore = gIgnore;
+    test_se05x_tlv(&se05x_session, &gPass, &gFail, &gIgnore);
+    if (gFail > fail) {
+        LOG_E(" FAIL - test_se05x_tlv");
+    }
+    else if (gPass > pass) {
+        LOG_W(" PASS - test_se05x_tlv");
+    }
+    else {
+        LOG_W(" IGNORE - test_se05x_tlv");
+    }
+}
+
+/* Connection string of the SE (e.g. "unix:/tmp/se05x.sock" of se05x_sim_server),
+ * taken from EX_SSS_BOOT_SSS_PORT. The default I2C device is used when not set.
+ * With EX_SSS_APDU_TRACE set, the APDUs of all tests are recorded to that file
+ * (see se05x_replay). */
+void *test_setup_port(void)
+{
+    const char *pTraceFile = getenv("EX_SSS_APDU_TRACE");
+
+    if ((pTraceFile != NULL) && (gApduTrace.record == NULL)) {
+        if (sm_apdu_trace_open(&gApduTrace, pTraceFile) != SM_OK) {
+            LOG_E("Error in creating APDU trace %s", pTraceFile);
+        }
+    }
+    se05x_session.pConnString = getenv("EX_SSS_BOOT_SSS_PORT");
+    se05x_session.pApduTrace  = (gApduTrace.record != NULL) ? &gApduTrace : NULL;
+    return test_setup();
+}
 
 void test_main(void)
 {
     LOG_W("Running test suite framework_tests");
     LOG_W("===================================================================");
 
-    unit_test_setup_teardown(test_run_se05x_nist256, test_setup, test_teardown);
-    unit_test_setup_teardown(test_run_se05x_nist256, test_setup, test_teardown);
-    unit_test_setup_teardown(test_run_se05x_nist256_ecdsa, test_setup, test_teardown);
-    unit_test_setup_teardown(test_run_se05x_bin_objects, test_setup, test_teardown);
-    unit_test_setup_teardown(test_run_se05x_aes, test_setup, test_teardown);
-    unit_test_setup_teardown(test_run_se05x_misc, test_setup, test_teardown);
-    unit_test_setup_teardown(test_run_se05x_nist256_ecdh, test_setup, test_teardown);
+    unit_test_setup_teardown(test_run_se05x_nist256, test_setup_port, test_teardown);
+    unit_test_setup_teardown(test_run_se05x_nist256, test_setup_port, test_teardown);
+    unit_test_setup_teardown(test_run_se05x_nist256_ecdsa, test_setup_port, test_teardown);
+    unit_test_setup_teardown(test_run_se05x_bin_objects, test_setup_port, test_teardown);
+    unit_test_setup_teardown(test_run_se05x_aes, test_setup_port, test_teardown);
+    unit_test_setup_teardown(test_run_se05x_misc, test_setup_port, test_teardown);
+    unit_test_setup_teardown(test_run_se05x_nist256_ecdh, test_setup_port, test_teardown);
+    unit_test_setup_teardown(test_run_se05x_tlv, test_setup_port, test_teardown);
+
+    sm_apdu_trace_close(&gApduTrace);
 
     LOG_W("Test suite framework_tests completed");
     LOG_W("===================================================================");
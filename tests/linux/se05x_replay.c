@@ -0,0 +1,286 @@
+/** @file se05x_replay.c
+ *  @brief Replays an APDU trace (sm_apdu_trace) against the SE or se05x_sim_server.
+ *
+ * Every recorded exchange is issued again with the same header, command length,
+ * response handling and timeout, either with the original inter-arrival timing or
+ * as fast as possible. The trace holds no command data, so the commands carry zero
+ * filled data: the transport and secure messaging load match the original, the
+ * processing of the SE does not. The session is opened with the keys of the unit
+ * tests, the session management commands of the trace are skipped.
+ *
+ * Copyright 2024 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* ********************** Include files ********************** */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "se05x_APDU_apis.h"
+#include "sm_apdu_trace.h"
+#include "sm_timer.h"
+#include "sm_port.h"
+#include "test_se05x.h"
+
+/* ********************** Data types ********************** */
+
+/* Durations of the replayed exchanges */
+typedef struct
+{
+    uint64_t *pNs;
+    size_t count;
+    size_t size;
+} se05x_replay_durations_t;
+
+/* ********************** Global variables ********************** */
+static int gSessionFailed = 0;
+
+/* ********************** Functions ********************** */
+
+/* Called by test_setup / test_teardown */
+void test_fail(void)
+{
+    gSessionFailed = 1;
+}
+
+static void se05x_replay_usage(const char *pName)
+{
+    printf("Usage: %s [options] <trace>\n", pName);
+    printf("  -a           Issue the exchanges as fast as possible\n");
+    printf("  -x <factor>  Speed up the original timing, e.g. 2.0\n");
+    printf("  -n <count>   Replay at most count exchanges\n");
+    printf("  -o <trace>   Record the replayed exchanges to a new trace\n");
+    printf("  -p <port>    Connection string of the SE, default EX_SSS_BOOT_SSS_PORT\n");
+}
+
+/**
+* Session management is done by the replay itself
+*/
+static int se05x_replay_is_session_cmd(const tlvHeader_t *hdr)
+{
+    if (hdr->hdr[1] == kSE05x_INS_PROCESS) {
+        return 1;
+    }
+    return (hdr->hdr[1] == kSE05x_INS_MGMT) &&
+           ((hdr->hdr[3] == kSE05x_P2_SESSION_CREATE) || (hdr->hdr[3] == kSE05x_P2_SESSION_CLOSE));
+}
+
+static int se05x_replay_add(se05x_replay_durations_t *pDurations, uint64_t durationNs)
+{
+    uint64_t *pNew = NULL;
+
+    if (pDurations->count == pDurations->size) {
+        pDurations->size = (pDurations->size == 0) ? 1024 : (2 * pDurations->size);
+        pNew             = (uint64_t *)realloc(pDurations->pNs, pDurations->size * sizeof(uint64_t));
+        if (pNew == NULL) {
+            return -1;
+        }
+        pDurations->pNs = pNew;
+    }
+    pDurations->pNs[pDurations->count++] = durationNs;
+    return 0;
+}
+
+static int se05x_replay_compare(const void *pA, const void *pB)
+{
+    uint64_t a = *(const uint64_t *)pA;
+    uint64_t b = *(const uint64_t *)pB;
+    return (a > b) - (a < b);
+}
+
+static void se05x_replay_print(const char *pName, se05x_replay_durations_t *pDurations)
+{
+    uint64_t totalNs = 0;
+    size_t i         = 0;
+    size_t n         = pDurations->count;
+
+    if (n == 0) {
+        printf("%-9s %8s\n", pName, "-");
+        return;
+    }
+    qsort(pDurations->pNs, n, sizeof(uint64_t), &se05x_replay_compare);
+    for (i = 0; i < n; i++) {
+        totalNs += pDurations->pNs[i];
+    }
+    printf("%-9s %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+        pName,
+        (double)totalNs / (double)n / 1000.0,
+        (double)pDurations->pNs[0] / 1000.0,
+        (double)pDurations->pNs[n / 2] / 1000.0,
+        (double)pDurations->pNs[(n * 90) / 100] / 1000.0,
+        (double)pDurations->pNs[(n * 99) / 100] / 1000.0,
+        (double)pDurations->pNs[n - 1] / 1000.0);
+}
+
+/**
+* Waits until the absolute monotonic time in ns
+*/
+static void se05x_replay_wait_until(uint64_t targetNs)
+{
+    struct timespec ts = {0};
+
+    ts.tv_sec  = (time_t)(targetNs / 1000000000u);
+    ts.tv_nsec = (long)(targetNs % 1000000000u);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0) {
+    }
+}
+
+int main(int argc, char **argv)
+{
+    static uint8_t rspBuf[MAX_APDU_BUFFER];
+    int ret                           = 1;
+    int opt                           = 0;
+    int asFastAsPossible              = 0;
+    double speed                      = 1.0;
+    unsigned long maxCount            = 0;
+    const char *pOutName              = NULL;
+    const char *pPort                 = getenv("EX_SSS_BOOT_SSS_PORT");
+    sm_apdu_trace_reader_t reader     = {0};
+    Se05xApduTrace_t outTrace         = {0};
+    Se05xApduTraceRecord_t record     = {0};
+    se05x_replay_durations_t original = {0};
+    se05x_replay_durations_t replayed = {0};
+    size_t rspBufLen                  = 0;
+    smStatus_t status                 = SM_NOT_OK;
+    uint64_t firstNs                  = 0;
+    uint64_t replayStartNs            = 0;
+    uint64_t targetNs                 = 0;
+    uint64_t startNs                  = 0;
+    uint64_t lateNs                   = 0;
+    unsigned long skipped             = 0;
+    unsigned long late                = 0;
+    unsigned long statusMismatch      = 0;
+    unsigned long rspLenMismatch      = 0;
+    int readRet                       = 0;
+
+    while ((opt = getopt(argc, argv, "ax:n:o:p:h")) != -1) {
+        switch (opt) {
+        case 'a':
+            asFastAsPossible = 1;
+            break;
+        case 'x':
+            speed = strtod(optarg, NULL);
+            break;
+        case 'n':
+            maxCount = strtoul(optarg, NULL, 0);
+            break;
+        case 'o':
+            pOutName = optarg;
+            break;
+        case 'p':
+            pPort = optarg;
+            break;
+        default:
+            se05x_replay_usage(argv[0]);
+            return 1;
+        }
+    }
+    if ((optind != (argc - 1)) || (speed <= 0.0)) {
+        se05x_replay_usage(argv[0]);
+        return 1;
+    }
+
+    ENSURE_OR_GO_CLEANUP(sm_apdu_trace_reader_open(&reader, argv[optind]) == SM_OK);
+    if (pOutName != NULL) {
+        ENSURE_OR_GO_CLEANUP(sm_apdu_trace_open(&outTrace, pOutName) == SM_OK);
+    }
+
+    se05x_session.pConnString = pPort;
+    se05x_session.pApduTrace  = (pOutName != NULL) ? &outTrace : NULL;
+    test_setup();
+    if (gSessionFailed) {
+        SMLOG_E("Replay: Error in opening the session \n");
+        goto cleanup;
+    }
+
+    while ((maxCount == 0) || (replayed.count < maxCount)) {
+        readRet = sm_apdu_trace_read(&reader, &record);
+        if (readRet != 0) {
+            break;
+        }
+        if (se05x_replay_is_session_cmd(&record.hdr) || (record.cmdLen > MAX_APDU_BUFFER)) {
+            skipped++;
+            continue;
+        }
+
+        if (replayed.count == 0) {
+            firstNs       = record.startNs;
+            replayStartNs = sm_get_time_ns();
+        }
+        else if (!asFastAsPossible) {
+            targetNs = replayStartNs + (uint64_t)((double)(record.startNs - firstNs) / speed);
+            startNs  = sm_get_time_ns();
+            if (startNs < targetNs) {
+                se05x_replay_wait_until(targetNs);
+            }
+            else {
+                /* Previous exchanges took longer than in the trace */
+                late++;
+                if ((startNs - targetNs) > lateNs) {
+                    lateNs = startNs - targetNs;
+                }
+            }
+        }
+
+        memset(se05x_session.apdu_buffer, 0, record.cmdLen);
+        startNs = sm_get_time_ns();
+        if (record.flags & SE05X_APDU_TRACE_FLAG_RSP) {
+            rspBufLen = sizeof(rspBuf);
+            status    = DoAPDUTxRxTimeout(&se05x_session,
+                &record.hdr,
+                se05x_session.apdu_buffer,
+                record.cmdLen,
+                rspBuf,
+                &rspBufLen,
+                (record.flags & SE05X_APDU_TRACE_FLAG_EXTENDED) ? 1 : 0,
+                record.timeoutUs);
+            if (status != SM_OK) {
+                rspBufLen = 0;
+            }
+        }
+        else {
+            rspBufLen = 0;
+            status    = DoAPDUTx(&se05x_session,
+                &record.hdr,
+                se05x_session.apdu_buffer,
+                record.cmdLen,
+                (record.flags & SE05X_APDU_TRACE_FLAG_EXTENDED) ? 1 : 0);
+        }
+        ENSURE_OR_GO_CLEANUP(se05x_replay_add(&replayed, sm_get_time_ns() - startNs) == 0);
+        ENSURE_OR_GO_CLEANUP(se05x_replay_add(&original, record.durationNs) == 0);
+        if (status != record.status) {
+            statusMismatch++;
+        }
+        if (rspBufLen != record.rspLen) {
+            rspLenMismatch++;
+        }
+    }
+    if (readRet < 0) {
+        SMLOG_E("Replay: Trace file is damaged, replay stopped \n");
+    }
+
+    printf("Exchanges replayed:     %lu\n", (unsigned long)replayed.count);
+    printf("Exchanges skipped:      %lu\n", skipped);
+    printf("Status different:       %lu\n", statusMismatch);
+    printf("Response len different: %lu\n", rspLenMismatch);
+    if (!asFastAsPossible) {
+        printf("Issued late:            %lu (max %.1f us)\n", late, (double)lateNs / 1000.0);
+    }
+    printf("%-9s %10s %10s %10s %10s %10s %10s\n", "us", "mean", "min", "p50", "p90", "p99", "max");
+    se05x_replay_print("original", &original);
+    se05x_replay_print("replayed", &replayed);
+    ret = 0;
+
+cleanup:
+    if (se05x_session.conn_context != NULL) {
+        test_teardown(NULL);
+    }
+    sm_apdu_trace_close(&outTrace);
+    sm_apdu_trace_reader_close(&reader);
+    free(original.pNs);
+    free(replayed.pNs);
+    return ret;
+}
@@ -0,0 +1,113 @@
+/** @file test_crc.c
+ *  @brief Equivalence test of the T=1oI2C CRC variants.
+ *
+ * Copyright 2024 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* ********************** Include files ********************** */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "phNxpEseCrc.h"
+
+/* ********************** Defines ********************** */
+#define TEST_CRC_MAX_LEN 1100
+#define TEST_CRC_MAX_ALIGN 16
+
+/* ********************** Global variables ********************** */
+static uint8_t gBuffer[TEST_CRC_MAX_LEN + TEST_CRC_MAX_ALIGN];
+
+/* ********************** Functions ********************** */
+
+/* Copy of the original phNxpEseProto7816_ComputeCRC loop, before byte ordering */
+static uint16_t test_crc_reference(const uint8_t *p_buff, uint32_t offset, uint32_t length)
+{
+    uint16_t CAL_CRC = 0xFFFF;
+    uint32_t i       = 0;
+
+    for (i = offset; i < length; i++) {
+        CAL_CRC ^= p_buff[i];
+        for (int bit = 8; bit > 0; --bit) {
+            if ((CAL_CRC & 0x0001) == 0x0001) {
+                CAL_CRC = (unsigned short)((CAL_CRC >> 1) ^ 0x8408);
+            }
+            else {
+                CAL_CRC >>= 1;
+            }
+        }
+    }
+    CAL_CRC ^= 0xFFFF;
+    return CAL_CRC;
+}
+
+/* Every register value with every byte value, one byte update */
+static int test_crc_all_registers(phNxpEseCrc_Impl_t impl, phNxpEseCrc_UpdateFn_t fn)
+{
+    uint8_t data = 0;
+
+    for (uint32_t crc = 0; crc <= 0xFFFF; crc++) {
+        for (uint32_t val = 0; val <= 0xFF; val++) {
+            data = (uint8_t)val;
+            if (fn((uint16_t)crc, &data, 1) != phNxpEseCrc_UpdateBitwise((uint16_t)crc, &data, 1)) {
+                printf("FAIL - %s register 0x%04X byte 0x%02X\n", phNxpEseCrc_GetImplName(impl), crc, val);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/* Every length and alignment, with random data and random register */
+static int test_crc_all_lengths(phNxpEseCrc_Impl_t impl, phNxpEseCrc_UpdateFn_t fn)
+{
+    for (size_t align = 0; align < TEST_CRC_MAX_ALIGN; align++) {
+        for (size_t len = 0; len <= TEST_CRC_MAX_LEN; len++) {
+            uint16_t crc = (uint16_t)rand();
+            for (size_t i = 0; i < len; i++) {
+                gBuffer[align + i] = (uint8_t)rand();
+            }
+            if (fn(crc, &gBuffer[align], len) != phNxpEseCrc_UpdateBitwise(crc, &gBuffer[align], len)) {
+                printf("FAIL - %s length %zu alignment %zu\n", phNxpEseCrc_GetImplName(impl), len, align);
+                return 1;
+            }
+            /* xor with 0xFFFF is a complement, kept as uint16_t to compare without promotion */
+            uint16_t final = (uint16_t)(fn(PH_NXP_ESE_CRC_INIT, &gBuffer[align], len) ^ PH_NXP_ESE_CRC_XOROUT);
+            if (final != test_crc_reference(gBuffer, (uint32_t)align, (uint32_t)(align + len))) {
+                printf("FAIL - %s reference length %zu alignment %zu\n", phNxpEseCrc_GetImplName(impl), len, align);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+int main(void)
+{
+    int fail = 0;
+
+    srand(0x5E05);
+
+    for (int impl = 0; impl < kPhNxpEseCrc_Max; impl++) {
+        phNxpEseCrc_UpdateFn_t fn = phNxpEseCrc_GetUpdateFn((phNxpEseCrc_Impl_t)impl);
+        if (fn == NULL) {
+            printf("IGNORE - %s not supported\n", phNxpEseCrc_GetImplName((phNxpEseCrc_Impl_t)impl));
+            continue;
+        }
+        if (test_crc_all_registers((phNxpEseCrc_Impl_t)impl, fn) || test_crc_all_lengths((phNxpEseCrc_Impl_t)impl, fn)) {
+            fail = 1;
+            continue;
+        }
+        printf("PASS - %s\n", phNxpEseCrc_GetImplName((phNxpEseCrc_Impl_t)impl));
+    }
+
+    /* Known check value of CRC-16/X.25 */
+    if (phNxpEseCrc_Compute((const uint8_t *)"123456789", 9) != 0x906E) {
+        printf("FAIL - check value with %s\n", phNxpEseCrc_GetImplName(phNxpEseCrc_GetActiveImpl()));
+        fail = 1;
+    }
+
+    printf("Active variant: %s\n", phNxpEseCrc_GetImplName(phNxpEseCrc_GetActiveImpl()));
+    return fail;
+}
@@ -8,6 +8,7 @@
 /* ********************** Include files ********************** */
 #include "se05x_APDU_apis.h"
 #include "sm_port.h"
+#include "sm_timer.h"
 #include "test_se05x.h"
 
 /* ********************** Global variables ********************** */
@@ -71,6 +72,39 @@ bool se05x_object_exists(pSe05xSession_t session_ctx, uint32_t keyID)
     return TRUE;
 }
 
+static ESESTATUS test_se05x_sim_notifier_wait(void *pNotifierCtx, uint32_t timeoutMs)
+{
+    test_se05x_sim_notifier_t *pSimNotifier = (test_se05x_sim_notifier_t *)pNotifierCtx;
+
+    if (pSimNotifier == NULL) {
+        return ESESTATUS_INVALID_PARAMETER;
+    }
+    pSimNotifier->waitCount++;
+    if (pSimNotifier->readyDelayUs > (timeoutMs * 1000)) {
+        /* No notification within the timeout */
+        pSimNotifier->timeoutCount++;
+        sm_sleep(timeoutMs);
+        return ESESTATUS_PENDING;
+    }
+    if (pSimNotifier->readyDelayUs > 0) {
+        sm_usleep(pSimNotifier->readyDelayUs);
+    }
+    return ESESTATUS_SUCCESS;
+}
+
+/* Sets up pNotifier for smComT1oI2C_SetReadyNotifier, pSimNotifier must outlive its use */
+void test_se05x_sim_notifier_init(phPalEse_ReadyNotifier_t *pNotifier, test_se05x_sim_notifier_t *pSimNotifier)
+{
+    if ((pNotifier == NULL) || (pSimNotifier == NULL)) {
+        return;
+    }
+    pSimNotifier->waitCount    = 0;
+    pSimNotifier->timeoutCount = 0;
+    pNotifier->wait            = &test_se05x_sim_notifier_wait;
+    pNotifier->release         = NULL;
+    pNotifier->pNotifierCtx    = pSimNotifier;
+}
+
 static void ex_set_scp03_keys(pSe05xSession_t session_ctx)
 {
     session_ctx->pScp03_enc_key    = &scp03_enc_key[0];
@@ -1,7 +1,7 @@
 /** @file test_se05x.h
  *  @brief Unit tests.
  *
- * Copyright 2021,2022 NXP
+ * Copyright 2021,2022,2024 NXP
  * SPDX-License-Identifier: Apache-2.0
  */
 
@@ -10,6 +10,16 @@
 
 #include <stdbool.h>
 #include <se05x_types.h>
+#include <phNxpEsePal_i2c.h>
+
+/* Simulated data ready notifier, signals data ready after a fixed delay.
+ * Exercises the notifier driven reception without a data ready line. */
+typedef struct
+{
+    uint32_t readyDelayUs; /* Delay after which data ready is signalled */
+    uint32_t waitCount;    /* Number of wait requests */
+    uint32_t timeoutCount; /* Number of waits that timed out */
+} test_se05x_sim_notifier_t;
 
 /* Global SE05x context */
 extern Se05xSession_t se05x_session;
@@ -23,8 +33,10 @@ void test_se05x_bin_objects(pSe05xSession_t session_ctx, uint8_t *pass, uint8_t
 void test_se05x_aes(pSe05xSession_t session_ctx, uint8_t *pass, uint8_t *fail, uint8_t *ignore);
 void test_se05x_misc(pSe05xSession_t session_ctx, uint8_t *pass, uint8_t *fail, uint8_t *ignore);
 void test_se05x_nist256_ecdh(pSe05xSession_t session_ctx, uint8_t *pass, uint8_t *fail, uint8_t *ignore);
+void test_se05x_tlv(pSe05xSession_t session_ctx, uint8_t *pass, uint8_t *fail, uint8_t *ignore);
 
 /* Helper functions */
 bool se05x_object_exists(pSe05xSession_t session_ctx, uint32_t keyID);
+void test_se05x_sim_notifier_init(phPalEse_ReadyNotifier_t *pNotifier, test_se05x_sim_notifier_t *pSimNotifier);
 
 #endif // __TEST_SE05x_H__
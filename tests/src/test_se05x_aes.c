@@ -1,7 +1,7 @@
 /** @file test_se05x_aes.c
  *  @brief AES Unit tests.
  *
- * Copyright 2021,2022 NXP
+ * Copyright 2021,2022,2024 NXP
  * SPDX-License-Identifier: Apache-2.0
  */
 
@@ -12,6 +12,8 @@
 
 #define TEST_SE05X_AES_OBJ_ID_BASE 0x7B000100
 #define MAX_DATA_LEN 112
+/* Operations made with one prepared command */
+#define TEST_SE05X_PREPARED_CIPHER_COUNT 4
 
 uint8_t test_write_encrypt_decrypt_aes_key(
     Se05xSession_t *pSession, SE05x_CipherMode_t cipherMode, size_t keyLenBits, size_t data_len, const char *test_name)
@@ -239,6 +241,100 @@ uint8_t test_aescorrupt_CTR(Se05xSession_t *pSession)
     return test_write_encrypt_decrypt_aes_corrupt_enc_data(pSession, kSE05x_CipherMode_AES_CTR, __FUNCTION__);
 }
 
+uint8_t test_write_prepared_cipher_aes_key(Se05xSession_t *pSession, SE05x_CipherMode_t cipherMode, const char *test_name)
+{
+    smStatus_t status;
+    uint32_t keyID  = TEST_SE05X_AES_OBJ_ID_BASE + __LINE__ + cipherMode;
+    uint8_t key[16] = {
+        0,
+    };
+    uint8_t data[32];
+    uint8_t enc[32];
+    size_t enc_len = sizeof(enc);
+    uint8_t enc_ref[32];
+    size_t enc_ref_len  = sizeof(enc_ref);
+    const uint8_t *pDec = NULL;
+    size_t dec_len      = 0;
+    uint8_t iv[16];
+    Se05xPreparedCmd_t encCmd;
+    Se05xPreparedCmd_t decCmd;
+    size_t i = 0;
+    size_t j = 0;
+
+    for (i = 0; i < sizeof(key); i++) {
+        key[i] = (uint8_t)(0xA0 + i);
+    }
+
+    /*create AES KEY*/
+    status = Se05x_API_WriteSymmKey(
+        pSession, NULL, 0, keyID, SE05x_KeyID_KEK_NONE, key, sizeof(key), kSE05x_INS_NA, kSE05x_SymmKeyType_AES);
+    TEST_ENSURE_OR_GOTO_EXIT(status == SM_OK);
+
+    status = Se05x_API_PrepareCipherOneShot(pSession, keyID, cipherMode, kSE05x_Cipher_Oper_OneShot_Encrypt, &encCmd);
+    TEST_ENSURE_OR_GOTO_EXIT(status == SM_OK);
+    status = Se05x_API_PrepareCipherOneShot(pSession, keyID, cipherMode, kSE05x_Cipher_Oper_OneShot_Decrypt, &decCmd);
+    TEST_ENSURE_OR_GOTO_EXIT(status == SM_OK);
+
+    /* The same prepared commands for new data and IV each time */
+    for (i = 0; i < TEST_SE05X_PREPARED_CIPHER_COUNT; i++) {
+        for (j = 0; j < sizeof(data); j++) {
+            data[j] = (uint8_t)(i * 0x20 + j);
+        }
+        for (j = 0; j < sizeof(iv); j++) {
+            iv[j] = (uint8_t)(i + j);
+        }
+
+        enc_len = sizeof(enc);
+        status  = Se05x_API_PreparedCipherOneShot(&encCmd, data, sizeof(data), iv, sizeof(iv), enc, &enc_len);
+        TEST_ENSURE_OR_GOTO_EXIT(status == SM_OK);
+
+        /* Same as the command encoded in full */
+        enc_ref_len = sizeof(enc_ref);
+        status      = Se05x_API_CipherOneShot(pSession,
+            keyID,
+            cipherMode,
+            data,
+            sizeof(data),
+            iv,
+            sizeof(iv),
+            enc_ref,
+            &enc_ref_len,
+            kSE05x_Cipher_Oper_OneShot_Encrypt);
+        TEST_ENSURE_OR_GOTO_EXIT(status == SM_OK);
+        status = SM_NOT_OK;
+        TEST_ENSURE_OR_GOTO_EXIT((enc_len == enc_ref_len) && (memcmp(enc, enc_ref, enc_len) == 0));
+
+        status = Se05x_API_PreparedCipherOneShotView(&decCmd, enc, enc_len, iv, sizeof(iv), &pDec, &dec_len);
+        TEST_ENSURE_OR_GOTO_EXIT(status == SM_OK);
+        status = SM_NOT_OK;
+        TEST_ENSURE_OR_GOTO_EXIT((dec_len == sizeof(data)) && (memcmp(pDec, data, dec_len) == 0));
+    }
+
+    status = SM_OK;
+exit:
+    /* Erase key */
+    Se05x_API_DeleteSecureObject(pSession, keyID);
+
+    if (status == SM_OK) {
+        SMLOG_I("%s, PASSED \n", test_name);
+        return SE05X_TEST_PASS;
+    }
+    else {
+        SMLOG_I("%s, FAILED \n", test_name);
+        return SE05X_TEST_FAIL;
+    }
+}
+
+uint8_t test_aes_prepared_CBC_NOPAD(Se05xSession_t *pSession)
+{
+    return test_write_prepared_cipher_aes_key(pSession, kSE05x_CipherMode_AES_CBC_NOPAD, __FUNCTION__);
+}
+
+uint8_t test_aes_prepared_CTR(Se05xSession_t *pSession)
+{
+    return test_write_prepared_cipher_aes_key(pSession, kSE05x_CipherMode_AES_CTR, __FUNCTION__);
+}
+
 void test_se05x_aes(pSe05xSession_t session_ctx, uint8_t *pass, uint8_t *fail, uint8_t *ignore)
 {
     /* key size = 128 bits, Data len = 32 */
@@ -272,5 +368,8 @@ void test_se05x_aes(pSe05xSession_t session_ctx, uint8_t *pass, uint8_t *fail, u
     UPDATE_RESULT(test_aescorrupt_ECB_NOPAD(session_ctx), pass, fail, ignore);
     UPDATE_RESULT(test_aescorrupt_CBC_NOPAD(session_ctx), pass, fail, ignore);
     UPDATE_RESULT(test_aescorrupt_CTR(session_ctx), pass, fail, ignore);
+
+    UPDATE_RESULT(test_aes_prepared_CBC_NOPAD(session_ctx), pass, fail, ignore);
+    UPDATE_RESULT(test_aes_prepared_CTR(session_ctx), pass, fail, ignore);
     return;
 }
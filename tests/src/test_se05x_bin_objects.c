@@ -1,7 +1,7 @@
 /** @file test_se05x_bin_objects.c
  *  @brief Binary Objects Unit tests.
  *
- * Copyright 2021,2022 NXP
+ * Copyright 2021,2022,2024 NXP
  * SPDX-License-Identifier: Apache-2.0
  */
 
@@ -13,6 +13,27 @@
 /* ********************** Defines ********************** */
 #define TEST_SE05X_BIN_OBJ_ID_BASE (0x7B000200)
 #define TEST_SE05X_SET_CERT_BLK_SIZE (128)
+/* Status word of the SE for data that does not fit the file */
+#define TEST_SE05X_SW_WRONG_DATA (0x6A80)
+#define TEST_SE05X_CHUNKED_MAX_SIZE (1000)
+#define TEST_SE05X_CHUNKED_RESUME_AT (100)
+#define TEST_SE05X_STREAM_STOP_AT (2)
+
+/* ********************** Data types ********************** */
+
+/* Context of test_se05x_read_stream_cb */
+typedef struct
+{
+    size_t calls;
+    size_t nextOffset;
+    size_t stopAt; /* Call that returns an error, 0 for none */
+} test_se05x_stream_ctx_t;
+
+/* ********************** Global variables ********************** */
+
+/* Object content and read back, too large for the stack of small targets */
+static uint8_t gchunked_data[TEST_SE05X_CHUNKED_MAX_SIZE];
+static uint8_t gchunked_read[TEST_SE05X_CHUNKED_MAX_SIZE];
 
 /* ********************** Functions ********************** */
 
@@ -87,23 +108,25 @@ uint8_t test_se05x_set_cert_invalid_len(pSe05xSession_t session_ctx)
     };
     size_t certificate_len = sizeof(certificate);
     uint32_t keyID         = TEST_SE05X_BIN_OBJ_ID_BASE + __LINE__;
-    size_t file_size       = sizeof(certificate);
+    size_t file_size       = TEST_SE05X_SET_CERT_BLK_SIZE;
     size_t offset          = 0;
-    size_t blk_size        = 2 * TEST_SE05X_SET_CERT_BLK_SIZE;
+    size_t blk_size        = sizeof(certificate);
     size_t i               = 0;
 
     if (se05x_object_exists(session_ctx, keyID)) {
-        /* Binary file already exsists. So set file size = 0 */
-        file_size = 0;
+        /* Left over from an earlier run, the file has to be created */
+        Se05x_API_DeleteSecureObject(session_ctx, keyID);
     }
 
     for (i = 0; i < certificate_len; i++) {
         certificate[i] = i;
     }
 
-    /* Set certificate */
+    /* Set certificate, longer than the file */
     status = Se05x_API_WriteBinary(session_ctx, NULL, keyID, offset, file_size, certificate + offset, blk_size);
-    TEST_ENSURE_OR_GOTO_EXIT(status == SM_NOT_OK);
+    TEST_ENSURE_OR_GOTO_EXIT(status == TEST_SE05X_SW_WRONG_DATA);
+    /* The rejected create leaves no object */
+    TEST_ENSURE_OR_GOTO_EXIT(!se05x_object_exists(session_ctx, keyID));
 
     test_status = SM_OK;
 exit:
@@ -120,9 +143,228 @@ exit:
     }
 }
 
+/* Reads the object back in blocks and compares it with gchunked_data */
+static uint8_t test_se05x_chunked_read_back(pSe05xSession_t session_ctx, uint32_t keyID, size_t size)
+{
+    smStatus_t status = SM_NOT_OK;
+    size_t offset     = 0;
+    size_t blk_size   = 0;
+    size_t read_len   = 0;
+
+    memset(gchunked_read, 0, sizeof(gchunked_read));
+    for (offset = 0; offset < size; offset = offset + blk_size) {
+        blk_size = size - offset;
+        blk_size = (blk_size > TEST_SE05X_SET_CERT_BLK_SIZE) ? TEST_SE05X_SET_CERT_BLK_SIZE : blk_size;
+        read_len = sizeof(gchunked_read) - offset;
+        status   = Se05x_API_ReadObject(session_ctx, keyID, offset, blk_size, gchunked_read + offset, &read_len);
+        TEST_ENSURE_OR_RETURN_ON_ERROR((status == SM_OK) && (read_len == blk_size), 1);
+    }
+    TEST_ENSURE_OR_RETURN_ON_ERROR(memcmp(gchunked_data, gchunked_read, size) == 0, 1);
+    return 0;
+}
+
+uint8_t test_se05x_write_chunked_round_trip(pSe05xSession_t session_ctx)
+{
+    smStatus_t status             = SM_NOT_OK;
+    uint32_t keyID                = TEST_SE05X_BIN_OBJ_ID_BASE + __LINE__;
+    const size_t sizes[]          = {1, TEST_SE05X_SET_CERT_BLK_SIZE, 300, TEST_SE05X_CHUNKED_MAX_SIZE};
+    Se05xWriteProgress_t progress = {0};
+    size_t i                      = 0;
+    size_t j                      = 0;
+
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        for (j = 0; j < sizes[i]; j++) {
+            gchunked_data[j] = (uint8_t)(i + j * 7);
+        }
+        Se05x_API_DeleteSecureObject(session_ctx, keyID);
+        memset(&progress, 0, sizeof(progress));
+        status = Se05x_API_WriteBinaryChunked(session_ctx, NULL, keyID, gchunked_data, sizes[i], &progress);
+        TEST_ENSURE_OR_GOTO_EXIT(status == SM_OK);
+        TEST_ENSURE_OR_GOTO_EXIT((progress.isCreated == 1) && (progress.written == sizes[i]));
+        TEST_ENSURE_OR_GOTO_EXIT(test_se05x_chunked_read_back(session_ctx, keyID, sizes[i]) == 0);
+    }
+
+    Se05x_API_DeleteSecureObject(session_ctx, keyID);
+    PASS_SE05X_TEST();
+exit:
+    Se05x_API_DeleteSecureObject(session_ctx, keyID);
+    SMLOG_I("%s, FAILED \n", __FUNCTION__);
+    return SE05X_TEST_FAIL;
+}
+
+uint8_t test_se05x_write_chunked_resume(pSe05xSession_t session_ctx)
+{
+    smStatus_t status             = SM_NOT_OK;
+    uint32_t keyID                = TEST_SE05X_BIN_OBJ_ID_BASE + __LINE__;
+    size_t size                   = TEST_SE05X_CHUNKED_MAX_SIZE;
+    Se05xWriteProgress_t progress = {0};
+    size_t i                      = 0;
+
+    for (i = 0; i < size; i++) {
+        gchunked_data[i] = (uint8_t)(0xFF - i);
+    }
+    Se05x_API_DeleteSecureObject(session_ctx, keyID);
+
+    /* Interrupted after the create, the rest is written on resume */
+    status = Se05x_API_WriteBinary(
+        session_ctx, NULL, keyID, 0, (uint16_t)size, gchunked_data, TEST_SE05X_CHUNKED_RESUME_AT);
+    TEST_ENSURE_OR_GOTO_EXIT(status == SM_OK);
+    progress.isCreated = 1;
+    progress.written   = TEST_SE05X_CHUNKED_RESUME_AT;
+    status             = Se05x_API_WriteBinaryChunked(session_ctx, NULL, keyID, gchunked_data, size, &progress);
+    TEST_ENSURE_OR_GOTO_EXIT((status == SM_OK) && (progress.written == size));
+    TEST_ENSURE_OR_GOTO_EXIT(test_se05x_chunked_read_back(session_ctx, keyID, size) == 0);
+
+    /* Create reached the SE with its response lost, the other data is rewritten from offset 0 */
+    memset(&progress, 0, sizeof(progress));
+    for (i = 0; i < size; i++) {
+        gchunked_data[i] = (uint8_t)i;
+    }
+    status = Se05x_API_WriteBinaryChunked(session_ctx, NULL, keyID, gchunked_data, size, &progress);
+    TEST_ENSURE_OR_GOTO_EXIT(status == SM_OK);
+    TEST_ENSURE_OR_GOTO_EXIT((progress.isCreated == 1) && (progress.written == size));
+    TEST_ENSURE_OR_GOTO_EXIT(test_se05x_chunked_read_back(session_ctx, keyID, size) == 0);
+
+    /* An existing object of another length is not taken over */
+    memset(&progress, 0, sizeof(progress));
+    status = Se05x_API_WriteBinaryChunked(session_ctx, NULL, keyID, gchunked_data, size - 1, &progress);
+    TEST_ENSURE_OR_GOTO_EXIT(status == SM_ERR_CONDITIONS_OF_USE_NOT_SATISFIED);
+    TEST_ENSURE_OR_GOTO_EXIT((progress.isCreated == 0) && (progress.written == 0));
+    TEST_ENSURE_OR_GOTO_EXIT(test_se05x_chunked_read_back(session_ctx, keyID, size) == 0);
+
+    Se05x_API_DeleteSecureObject(session_ctx, keyID);
+    PASS_SE05X_TEST();
+exit:
+    Se05x_API_DeleteSecureObject(session_ctx, keyID);
+    SMLOG_I("%s, FAILED \n", __FUNCTION__);
+    return SE05X_TEST_FAIL;
+}
+
+/* Checks that the chunks are contiguous and match gchunked_data */
+static smStatus_t test_se05x_read_stream_cb(void *pCbCtx, uint16_t offset, const uint8_t *pChunk, size_t chunkLen)
+{
+    test_se05x_stream_ctx_t *pCtx = (test_se05x_stream_ctx_t *)pCbCtx;
+
+    pCtx->calls++;
+    if ((offset != pCtx->nextOffset) || (chunkLen == 0) || (memcmp(pChunk, &gchunked_data[offset], chunkLen) != 0)) {
+        return SM_NOT_OK;
+    }
+    pCtx->nextOffset += chunkLen;
+    /* An error of its own, distinct from the errors of the read */
+    return (pCtx->calls == pCtx->stopAt) ? SM_ERR_TIMEOUT : SM_OK;
+}
+
+uint8_t test_se05x_read_chunked(pSe05xSession_t session_ctx)
+{
+    smStatus_t status             = SM_NOT_OK;
+    uint32_t keyID                = TEST_SE05X_BIN_OBJ_ID_BASE + __LINE__;
+    size_t size                   = TEST_SE05X_CHUNKED_MAX_SIZE;
+    Se05xWriteProgress_t progress = {0};
+    size_t read_len               = 0;
+    size_t i                      = 0;
+
+    for (i = 0; i < size; i++) {
+        gchunked_data[i] = (uint8_t)(i * 3 + 1);
+    }
+    Se05x_API_DeleteSecureObject(session_ctx, keyID);
+    status = Se05x_API_WriteBinaryChunked(session_ctx, NULL, keyID, gchunked_data, size, &progress);
+    TEST_ENSURE_OR_GOTO_EXIT(status == SM_OK);
+
+    /* Length 0, the size is read with ReadSize */
+    memset(gchunked_read, 0, sizeof(gchunked_read));
+    read_len = sizeof(gchunked_read);
+    status   = Se05x_API_ReadObjectChunked(session_ctx, keyID, 0, 0, gchunked_read, &read_len);
+    TEST_ENSURE_OR_GOTO_EXIT((status == SM_OK) && (read_len == size));
+    TEST_ENSURE_OR_GOTO_EXIT(memcmp(gchunked_data, gchunked_read, size) == 0);
+
+    /* Length 0 from an offset, up to the end */
+    memset(gchunked_read, 0, sizeof(gchunked_read));
+    read_len = sizeof(gchunked_read);
+    status   = Se05x_API_ReadObjectChunked(session_ctx, keyID, 300, 0, gchunked_read, &read_len);
+    TEST_ENSURE_OR_GOTO_EXIT((status == SM_OK) && (read_len == (size - 300)));
+    TEST_ENSURE_OR_GOTO_EXIT(memcmp(&gchunked_data[300], gchunked_read, size - 300) == 0);
+
+    /* Offset and length */
+    memset(gchunked_read, 0, sizeof(gchunked_read));
+    read_len = sizeof(gchunked_read);
+    status   = Se05x_API_ReadObjectChunked(session_ctx, keyID, 123, 700, gchunked_read, &read_len);
+    TEST_ENSURE_OR_GOTO_EXIT((status == SM_OK) && (read_len == 700));
+    TEST_ENSURE_OR_GOTO_EXIT(memcmp(&gchunked_data[123], gchunked_read, 700) == 0);
+
+    /* Past the end of the object */
+    read_len = sizeof(gchunked_read);
+    status   = Se05x_API_ReadObjectChunked(session_ctx, keyID, (uint16_t)(size + 1), 0, gchunked_read, &read_len);
+    TEST_ENSURE_OR_GOTO_EXIT((status != SM_OK) && (read_len == 0));
+    read_len = sizeof(gchunked_read);
+    status   = Se05x_API_ReadObjectChunked(session_ctx, keyID, 1, (uint16_t)size, gchunked_read, &read_len);
+    TEST_ENSURE_OR_GOTO_EXIT(status != SM_OK);
+
+    /* Output buffer one byte short, the bytes read so far are kept */
+    memset(gchunked_read, 0, sizeof(gchunked_read));
+    read_len = size - 1;
+    status   = Se05x_API_ReadObjectChunked(session_ctx, keyID, 0, 0, gchunked_read, &read_len);
+    TEST_ENSURE_OR_GOTO_EXIT((status != SM_OK) && (read_len < size));
+    TEST_ENSURE_OR_GOTO_EXIT(memcmp(gchunked_data, gchunked_read, read_len) == 0);
+
+    Se05x_API_DeleteSecureObject(session_ctx, keyID);
+    PASS_SE05X_TEST();
+exit:
+    Se05x_API_DeleteSecureObject(session_ctx, keyID);
+    SMLOG_I("%s, FAILED \n", __FUNCTION__);
+    return SE05X_TEST_FAIL;
+}
+
+uint8_t test_se05x_read_stream(pSe05xSession_t session_ctx)
+{
+    smStatus_t status             = SM_NOT_OK;
+    uint32_t keyID                = TEST_SE05X_BIN_OBJ_ID_BASE + __LINE__;
+    size_t size                   = TEST_SE05X_CHUNKED_MAX_SIZE;
+    Se05xWriteProgress_t progress = {0};
+    test_se05x_stream_ctx_t ctx   = {0};
+    size_t i                      = 0;
+
+    for (i = 0; i < size; i++) {
+        gchunked_data[i] = (uint8_t)(i ^ 0x5A);
+    }
+    Se05x_API_DeleteSecureObject(session_ctx, keyID);
+    status = Se05x_API_WriteBinaryChunked(session_ctx, NULL, keyID, gchunked_data, size, &progress);
+    TEST_ENSURE_OR_GOTO_EXIT(status == SM_OK);
+
+    /* Every chunk in order, the object does not fit one response */
+    status = Se05x_API_ReadObjectStream(session_ctx, keyID, 0, 0, &test_se05x_read_stream_cb, &ctx);
+    TEST_ENSURE_OR_GOTO_EXIT((status == SM_OK) && (ctx.nextOffset == size) && (ctx.calls > 1));
+
+    /* Offset and length */
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.nextOffset = 10;
+    status         = Se05x_API_ReadObjectStream(session_ctx, keyID, 10, 900, &test_se05x_read_stream_cb, &ctx);
+    TEST_ENSURE_OR_GOTO_EXIT((status == SM_OK) && (ctx.nextOffset == 910));
+
+    /* An error of the callback stops the read and is returned */
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.stopAt = TEST_SE05X_STREAM_STOP_AT;
+    status     = Se05x_API_ReadObjectStream(session_ctx, keyID, 0, 0, &test_se05x_read_stream_cb, &ctx);
+    TEST_ENSURE_OR_GOTO_EXIT((status == SM_ERR_TIMEOUT) && (ctx.calls == TEST_SE05X_STREAM_STOP_AT));
+
+    /* No callback */
+    status = Se05x_API_ReadObjectStream(session_ctx, keyID, 0, 0, NULL, &ctx);
+    TEST_ENSURE_OR_GOTO_EXIT(status != SM_OK);
+
+    Se05x_API_DeleteSecureObject(session_ctx, keyID);
+    PASS_SE05X_TEST();
+exit:
+    Se05x_API_DeleteSecureObject(session_ctx, keyID);
+    SMLOG_I("%s, FAILED \n", __FUNCTION__);
+    return SE05X_TEST_FAIL;
+}
+
 void test_se05x_bin_objects(pSe05xSession_t session_ctx, uint8_t *pass, uint8_t *fail, uint8_t *ignore)
 {
     UPDATE_RESULT(test_se05x_set_get_cert(session_ctx), pass, fail, ignore);
     UPDATE_RESULT(test_se05x_set_cert_invalid_len(session_ctx), pass, fail, ignore);
+    UPDATE_RESULT(test_se05x_write_chunked_round_trip(session_ctx), pass, fail, ignore);
+    UPDATE_RESULT(test_se05x_write_chunked_resume(session_ctx), pass, fail, ignore);
+    UPDATE_RESULT(test_se05x_read_chunked(session_ctx), pass, fail, ignore);
+    UPDATE_RESULT(test_se05x_read_stream(session_ctx), pass, fail, ignore);
     return;
 }
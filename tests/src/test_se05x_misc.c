@@ -1,17 +1,21 @@
 /** @file test_se05x_misc.c
  *  @brief Unit tests.
  *
- * Copyright 2021,2022 NXP
+ * Copyright 2021,2022,2024 NXP
  * SPDX-License-Identifier: Apache-2.0
  */
 
 /* ********************** Include files ********************** */
 #include "se05x_APDU_apis.h"
+#include "smCom.h"
 #include "test_se05x.h"
 #include "test_se05x_utils.h"
 
 /* ********************** Defines ********************** */
 #define TEST_SE05X_MISC_OBJ_ID_BASE (0x7B000300)
+/* Data ready delay of the simulated notifier, within and beyond the wait timeout */
+#define TEST_SE05X_NOTIFIER_DELAY_US (1000)
+#define TEST_SE05X_NOTIFIER_LATE_US ((ESE_READY_WAIT_TIMEOUT_MS + 1) * 1000)
 
 uint8_t test_get_version(pSe05xSession_t session_ctx)
 {
@@ -31,10 +35,70 @@ exit:
     return SE05X_TEST_FAIL;
 }
 
+uint8_t test_ready_notifier(pSe05xSession_t session_ctx)
+{
+    uint8_t expected[64];
+    size_t expected_len                    = sizeof(expected);
+    uint8_t version[64];
+    size_t version_len                     = sizeof(version);
+    smStatus_t status                      = SM_NOT_OK;
+    phPalEse_ReadyNotifier_t notifier      = {0};
+    test_se05x_sim_notifier_t sim_notifier = {0};
+
+    /* Reference response, received by polling */
+    status = Se05x_API_GetVersion(session_ctx, expected, &expected_len);
+    TEST_ENSURE_OR_GOTO_EXIT(status == SM_OK);
+
+    /* Frames are received after the notifier signals data ready */
+    sim_notifier.readyDelayUs = TEST_SE05X_NOTIFIER_DELAY_US;
+    test_se05x_sim_notifier_init(&notifier, &sim_notifier);
+    status = smComT1oI2C_SetReadyNotifier(session_ctx->conn_context, &notifier);
+    TEST_ENSURE_OR_GOTO_EXIT(status == SM_OK);
+    status = Se05x_API_GetVersion(session_ctx, version, &version_len);
+    TEST_ENSURE_OR_GOTO_EXIT(status == SM_OK);
+    TEST_ENSURE_OR_GOTO_EXIT(version_len == expected_len);
+    TEST_ENSURE_OR_GOTO_EXIT(memcmp(version, expected, expected_len) == 0);
+    TEST_ENSURE_OR_GOTO_EXIT(sim_notifier.waitCount > 0);
+    TEST_ENSURE_OR_GOTO_EXIT(sim_notifier.timeoutCount == 0);
+
+    /* No notification within the timeout, every wait times out and the frame is read anyway */
+    memset(version, 0, sizeof(version));
+    version_len               = sizeof(version);
+    sim_notifier.readyDelayUs = TEST_SE05X_NOTIFIER_LATE_US;
+    sim_notifier.waitCount    = 0;
+    sim_notifier.timeoutCount = 0;
+    status                    = Se05x_API_GetVersion(session_ctx, version, &version_len);
+    TEST_ENSURE_OR_GOTO_EXIT(status == SM_OK);
+    TEST_ENSURE_OR_GOTO_EXIT(version_len == expected_len);
+    TEST_ENSURE_OR_GOTO_EXIT(memcmp(version, expected, expected_len) == 0);
+    TEST_ENSURE_OR_GOTO_EXIT(sim_notifier.waitCount > 0);
+    TEST_ENSURE_OR_GOTO_EXIT(sim_notifier.timeoutCount == sim_notifier.waitCount);
+
+    /* Back to polling, the notifier is not used anymore */
+    status = smComT1oI2C_SetReadyNotifier(session_ctx->conn_context, NULL);
+    TEST_ENSURE_OR_GOTO_EXIT(status == SM_OK);
+    memset(version, 0, sizeof(version));
+    version_len            = sizeof(version);
+    sim_notifier.waitCount = 0;
+    status                 = Se05x_API_GetVersion(session_ctx, version, &version_len);
+    TEST_ENSURE_OR_GOTO_EXIT(status == SM_OK);
+    TEST_ENSURE_OR_GOTO_EXIT(version_len == expected_len);
+    TEST_ENSURE_OR_GOTO_EXIT(memcmp(version, expected, expected_len) == 0);
+    TEST_ENSURE_OR_GOTO_EXIT(sim_notifier.waitCount == 0);
+    PASS_SE05X_TEST();
+
+exit:
+    /* Back to polling for the other tests */
+    smComT1oI2C_SetReadyNotifier(session_ctx->conn_context, NULL);
+    SMLOG_I("%s, FAILED \n", __FUNCTION__);
+    return SE05X_TEST_FAIL;
+}
+
 /* ********************** Functions ********************** */
 
 void test_se05x_misc(pSe05xSession_t session_ctx, uint8_t *pass, uint8_t *fail, uint8_t *ignore)
 {
     UPDATE_RESULT(test_get_version(session_ctx), pass, fail, ignore);
+    UPDATE_RESULT(test_ready_notifier(session_ctx), pass, fail, ignore);
     return;
 }
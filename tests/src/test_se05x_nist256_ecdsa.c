@@ -1,7 +1,7 @@
 /** @file test_se05x_nist256_ecdsa.c
  *  @brief Nist256 ECDSA Unit tests.
  *
- * Copyright 2021,2022 NXP
+ * Copyright 2021,2022,2024 NXP
  * SPDX-License-Identifier: Apache-2.0
  */
 
@@ -12,6 +12,8 @@
 
 /* ********************** Defines ********************** */
 #define TEST_SE05X_NIST256_SIGN_VER_ID_BASE (0x7B000600)
+/* Signatures made with one prepared command */
+#define TEST_SE05X_PREPARED_SIGN_COUNT (4)
 
 /* ********************** Functions ********************** */
 
@@ -339,6 +341,92 @@ exit:
     }
 }
 
+uint8_t test_se05x_nist256_ecdsa_prepared_sign(pSe05xSession_t session_ctx)
+{
+    smStatus_t status;
+    SE05x_ECCurve_t curveID = kSE05x_ECCurve_NIST_P256;
+    uint32_t keyID          = TEST_SE05X_NIST256_SIGN_VER_ID_BASE + __LINE__;
+    Se05xPreparedCmd_t cmd;
+    uint8_t input[32];
+    uint8_t signature[128] = {
+        0,
+    };
+    size_t signature_len      = 0;
+    const uint8_t *pSignature = NULL;
+    SE05x_Result_t sign_result;
+    size_t i = 0;
+    size_t j = 0;
+
+    if (se05x_object_exists(session_ctx, keyID)) {
+        curveID = kSE05x_ECCurve_NA;
+    }
+
+    status = Se05x_API_WriteECKey(
+        session_ctx, NULL, 0, keyID, curveID, NULL, 0, NULL, 0, kSE05x_INS_NA, kSE05x_KeyPart_Pair);
+    TEST_ENSURE_OR_GOTO_EXIT(status == SM_OK);
+
+    status = Se05x_API_PrepareECDSASign(session_ctx, keyID, kSE05x_ECSignatureAlgo_SHA_256, &cmd);
+    TEST_ENSURE_OR_GOTO_EXIT(status == SM_OK);
+
+    /* The same prepared command for each input, copied and viewed in turn */
+    for (i = 0; i < TEST_SE05X_PREPARED_SIGN_COUNT; i++) {
+        for (j = 0; j < sizeof(input); j++) {
+            input[j] = (uint8_t)(i * 0x10 + j);
+        }
+        if ((i % 2) == 0) {
+            signature_len = sizeof(signature);
+            status        = Se05x_API_PreparedECDSASign(&cmd, input, sizeof(input), signature, &signature_len);
+            TEST_ENSURE_OR_GOTO_EXIT(status == SM_OK);
+        }
+        else {
+            status = Se05x_API_PreparedECDSASignView(&cmd, input, sizeof(input), &pSignature, &signature_len);
+            TEST_ENSURE_OR_GOTO_EXIT((status == SM_OK) && (signature_len <= sizeof(signature)));
+            /* The view points into the APDU buffer, the verify below overwrites it */
+            memcpy(signature, pSignature, signature_len);
+        }
+
+        status = Se05x_API_ECDSAVerify(session_ctx,
+            keyID,
+            kSE05x_ECSignatureAlgo_SHA_256,
+            input,
+            sizeof(input),
+            signature,
+            signature_len,
+            &sign_result);
+        TEST_ENSURE_OR_GOTO_EXIT(status == SM_OK);
+        status = SM_NOT_OK;
+        TEST_ENSURE_OR_GOTO_EXIT(sign_result == kSE05x_Result_SUCCESS);
+
+        /* Not valid for other data */
+        input[0] ^= 0x01;
+        status = Se05x_API_ECDSAVerify(session_ctx,
+            keyID,
+            kSE05x_ECSignatureAlgo_SHA_256,
+            input,
+            sizeof(input),
+            signature,
+            signature_len,
+            &sign_result);
+        TEST_ENSURE_OR_GOTO_EXIT(status == SM_OK);
+        status = SM_NOT_OK;
+        TEST_ENSURE_OR_GOTO_EXIT(sign_result != kSE05x_Result_SUCCESS);
+    }
+
+    status = SM_OK;
+exit:
+    /* Erase key */
+    Se05x_API_DeleteSecureObject(session_ctx, keyID);
+
+    if (status == SM_OK) {
+        SMLOG_I("%s, PASSED \n", __FUNCTION__);
+        return SE05X_TEST_PASS;
+    }
+    else {
+        SMLOG_I("%s, FAILED \n", __FUNCTION__);
+        return SE05X_TEST_FAIL;
+    }
+}
+
 void test_se05x_nist256_ecdsa(pSe05xSession_t session_ctx, uint8_t *pass, uint8_t *fail, uint8_t *ignore)
 {
     UPDATE_RESULT(test_se05x_nist256_ecdsa_sign_verify_sha1(session_ctx), pass, fail, ignore);
@@ -358,5 +446,7 @@ void test_se05x_nist256_ecdsa(pSe05xSession_t session_ctx, uint8_t *pass, uint8_
 
     UPDATE_RESULT(test_se05x_nist256_ecdsa_sign_verify_invalid_data(session_ctx), pass, fail, ignore);
 
+    UPDATE_RESULT(test_se05x_nist256_ecdsa_prepared_sign(session_ctx), pass, fail, ignore);
+
     return;
 }
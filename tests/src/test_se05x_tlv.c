@@ -0,0 +1,160 @@
+/** @file test_se05x_tlv.c
+ *  @brief TLV parser Unit tests.
+ *
+ * The TLV views are parsed on the host only, no secure element is needed.
+ *
+ * Copyright 2024 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* ********************** Include files ********************** */
+#include "se05x_APDU_apis.h"
+#include "se05x_tlv.h"
+#include "test_se05x.h"
+#include "test_se05x_utils.h"
+
+/* ********************** Defines ********************** */
+#define TEST_SE05X_TLV_BUF_MAX (300)
+
+/* ********************** Data types ********************** */
+
+/* Input of tlvGet_Views and the expected result */
+typedef struct
+{
+    const char *pName;
+    uint8_t buf[TEST_SE05X_TLV_BUF_MAX];
+    size_t bufLen;
+    int retVal;
+    size_t count;
+    /* Tag and value length of the last view, checked on success with count > 0 */
+    uint8_t lastTag;
+    size_t lastLen;
+} test_se05x_tlv_case_t;
+
+/* ********************** Global variables ********************** */
+
+/* clang-format off */
+static const test_se05x_tlv_case_t gTlvCases[] = {
+    {"empty buffer", {0}, 0, 0, 0, 0, 0},
+    {"one short TLV", {0x41, 0x02, 0xAA, 0xBB}, 4, 0, 1, 0x41, 2},
+    {"zero length TLV", {0x41, 0x00}, 2, 0, 1, 0x41, 0},
+    {"unknown tag", {0xEE, 0x01, 0x55}, 3, 0, 1, 0xEE, 1},
+    {"short and 0x81 TLVs", {0x41, 0x01, 0x00, 0x42, 0x81, 0x01, 0x99}, 7, 0, 2, 0x42, 1},
+    {"0x82 TLV", {0x41, 0x82, 0x00, 0x03, 0x01, 0x02, 0x03}, 7, 0, 1, 0x41, 3},
+    {"TLV_VIEWS_MAX TLVs", {0x41, 0x00, 0x42, 0x00, 0x43, 0x00, 0x44, 0x01, 0x07}, 9, 0, TLV_VIEWS_MAX, 0x44, 1},
+    {"tag only", {0x41}, 1, 1, 0, 0, 0},
+    {"truncated 0x81 length", {0x41, 0x81}, 2, 1, 0, 0, 0},
+    {"truncated 0x82 length", {0x41, 0x82, 0x00}, 3, 1, 0, 0, 0},
+    {"0x82 length without value", {0x41, 0x82}, 2, 1, 0, 0, 0},
+    {"unsupported 0x83 length", {0x41, 0x83, 0x00, 0x00, 0x01, 0x00}, 6, 1, 0, 0, 0},
+    {"short value longer than buffer", {0x41, 0x03, 0x01, 0x02}, 4, 1, 0, 0, 0},
+    {"0x81 value longer than buffer", {0x41, 0x81, 0x80, 0x01}, 4, 1, 0, 0, 0},
+    {"0x82 value longer than buffer", {0x41, 0x82, 0x01, 0x00, 0x01}, 5, 1, 0, 0, 0},
+    {"valid TLV then truncated TLV", {0x41, 0x01, 0x00, 0x42, 0x02, 0x00}, 6, 1, 0, 0, 0},
+    {"more than TLV_VIEWS_MAX TLVs", {0x41, 0x00, 0x42, 0x00, 0x43, 0x00, 0x44, 0x00, 0x45, 0x00}, 10, 1, 0, 0, 0},
+};
+/* clang-format on */
+
+/* ********************** Functions ********************** */
+
+uint8_t test_se05x_tlv_views(void)
+{
+    size_t i = 0;
+    tlvViews_t views;
+    const test_se05x_tlv_case_t *pCase;
+
+    for (i = 0; i < sizeof(gTlvCases) / sizeof(gTlvCases[0]); i++) {
+        pCase = &gTlvCases[i];
+        memset(&views, 0xA5, sizeof(views));
+        if ((tlvGet_Views(pCase->buf, pCase->bufLen, &views) != pCase->retVal) || (views.count != pCase->count)) {
+            SMLOG_E("tlvGet_Views: case '%s' \n", pCase->pName);
+            goto exit;
+        }
+        if ((pCase->retVal != 0) || (pCase->count == 0)) {
+            continue;
+        }
+        if ((views.view[views.count - 1].tag != pCase->lastTag) ||
+            (views.view[views.count - 1].valueLen != pCase->lastLen) ||
+            (views.view[views.count - 1].pValue != &pCase->buf[pCase->bufLen - pCase->lastLen])) {
+            SMLOG_E("tlvGet_Views: case '%s', last view \n", pCase->pName);
+            goto exit;
+        }
+    }
+
+    TEST_ENSURE_OR_GOTO_EXIT(tlvGet_Views(NULL, 0, &views) != 0);
+    TEST_ENSURE_OR_GOTO_EXIT(tlvGet_Views(gTlvCases[1].buf, gTlvCases[1].bufLen, NULL) != 0);
+
+    PASS_SE05X_TEST();
+exit:
+    SMLOG_I("%s, FAILED \n", __FUNCTION__);
+    return SE05X_TEST_FAIL;
+}
+
+uint8_t test_se05x_tlv_long_value(void)
+{
+    uint8_t buf[4 + 256 + 2] = {0};
+    tlvViews_t views;
+    const tlvView_t *pView = NULL;
+
+    /* 0x82 encoded value of 256 bytes followed by a short TLV */
+    buf[0]   = kSE05x_TAG_1;
+    buf[1]   = 0x82;
+    buf[2]   = 0x01;
+    buf[3]   = 0x00;
+    buf[260] = kSE05x_TAG_2;
+    buf[261] = 0x00;
+    TEST_ENSURE_OR_GOTO_EXIT(tlvGet_Views(buf, 262, &views) == 0);
+    TEST_ENSURE_OR_GOTO_EXIT(views.count == 2);
+
+    pView = tlvGet_FindView(&views, kSE05x_TAG_1);
+    TEST_ENSURE_OR_GOTO_EXIT((pView != NULL) && (pView->pValue == &buf[4]) && (pView->valueLen == 256));
+    pView = tlvGet_FindView(&views, kSE05x_TAG_2);
+    TEST_ENSURE_OR_GOTO_EXIT((pView != NULL) && (pView->pValue == &buf[262]) && (pView->valueLen == 0));
+
+    /* One byte short of the value */
+    TEST_ENSURE_OR_GOTO_EXIT(tlvGet_Views(buf, 259, &views) != 0);
+    TEST_ENSURE_OR_GOTO_EXIT(views.count == 0);
+
+    PASS_SE05X_TEST();
+exit:
+    SMLOG_I("%s, FAILED \n", __FUNCTION__);
+    return SE05X_TEST_FAIL;
+}
+
+uint8_t test_se05x_tlv_find_view(void)
+{
+    const uint8_t buf[] = {kSE05x_TAG_1, 0x01, 0x11, kSE05x_TAG_2, 0x01, 0x22, kSE05x_TAG_1, 0x01, 0x33};
+    tlvViews_t views;
+    const tlvView_t *pView = NULL;
+
+    TEST_ENSURE_OR_GOTO_EXIT(tlvGet_Views(buf, sizeof(buf), &views) == 0);
+    TEST_ENSURE_OR_GOTO_EXIT(views.count == 3);
+
+    /* First match in the order received */
+    pView = tlvGet_FindView(&views, kSE05x_TAG_1);
+    TEST_ENSURE_OR_GOTO_EXIT((pView != NULL) && (pView->valueLen == 1) && (pView->pValue[0] == 0x11));
+    pView = tlvGet_FindView(&views, kSE05x_TAG_2);
+    TEST_ENSURE_OR_GOTO_EXIT((pView != NULL) && (pView->valueLen == 1) && (pView->pValue[0] == 0x22));
+
+    /* Tag not in the response */
+    TEST_ENSURE_OR_GOTO_EXIT(tlvGet_FindView(&views, kSE05x_TAG_3) == NULL);
+    TEST_ENSURE_OR_GOTO_EXIT(tlvGet_FindView(NULL, kSE05x_TAG_1) == NULL);
+
+    /* Nothing found after a failed parse */
+    TEST_ENSURE_OR_GOTO_EXIT(tlvGet_Views(buf, sizeof(buf) - 1, &views) != 0);
+    TEST_ENSURE_OR_GOTO_EXIT(tlvGet_FindView(&views, kSE05x_TAG_1) == NULL);
+
+    PASS_SE05X_TEST();
+exit:
+    SMLOG_I("%s, FAILED \n", __FUNCTION__);
+    return SE05X_TEST_FAIL;
+}
+
+void test_se05x_tlv(pSe05xSession_t session_ctx, uint8_t *pass, uint8_t *fail, uint8_t *ignore)
+{
+    (void)session_ctx;
+    UPDATE_RESULT(test_se05x_tlv_views(), pass, fail, ignore);
+    UPDATE_RESULT(test_se05x_tlv_long_value(), pass, fail, ignore);
+    UPDATE_RESULT(test_se05x_tlv_find_view(), pass, fail, ignore);
+    return;
+}
@@ -68,3 +68,12 @@ ZTEST(se05x_tests, test_run_se05x_nist256)
     test_se05x_nist256(&se05x_session, &pass, &fail, &ignore);
     zassert_equal(fail, 0, "test_run_se05x_nist256 failed");
 }
+
+ZTEST(se05x_tests, test_run_se05x_tlv)
+{
+    uint8_t pass   = 0;
+    uint8_t fail   = 0;
+    uint8_t ignore = 0;
+    test_se05x_tlv(&se05x_session, &pass, &fail, &ignore);
+    zassert_equal(fail, 0, "test_run_se05x_tlv failed");
+}